@@ -0,0 +1,20 @@
+// swift-tools-version:5.3
+// The swift-tools-version declares the minimum version of Swift required to build this package.
+
+import PackageDescription
+
+let package = Package(
+    name: "BenchmarkSupport",
+    products: [
+        .library(
+            name: "BenchmarkSupport",
+            targets: ["BenchmarkSupport"]),
+    ],
+    dependencies: [
+    ],
+    targets: [
+        .target(
+            name: "BenchmarkSupport",
+            dependencies: []),
+    ]
+)
@@ -0,0 +1,70 @@
+//
+//  BenchmarkSupport.swift
+//  BenchmarkSupport
+//
+//  Created by Fedor Artemenkov on 18.10.2026.
+//
+//  Map loading and statistics shared by the headless benchmarks of SwiftBullet and SwiftRecast.
+//
+
+import Foundation
+
+// Only the part of WorldCollisionAsset the benchmarks read: the brushes and their planes
+public struct CollisionAsset: Decodable
+{
+    public struct Plane: Decodable
+    {
+        public let normal: SIMD3<Float>
+        public let distance: Float
+    }
+
+    public struct Brush: Decodable
+    {
+        public let brushside: Int
+        public let numBrushsides: Int
+        public let contentFlags: Int
+    }
+
+    public struct BrushSide: Decodable
+    {
+        public let plane: Int
+    }
+
+    public let planes: [Plane]
+    public let brushes: [Brush]
+    public let brushSides: [BrushSide]
+}
+
+// Reads one entry of a .wld archive, nil if the map has no such entry
+public func readEntry(_ name: String, from archive: URL) -> Data?
+{
+    let process = Process()
+    process.executableURL = URL(fileURLWithPath: "/usr/bin/unzip")
+    process.arguments = ["-p", archive.path, name]
+
+    let pipe = Pipe()
+    process.standardOutput = pipe
+    process.standardError = FileHandle.nullDevice
+
+    do
+    {
+        try process.run()
+    }
+    catch
+    {
+        return nil
+    }
+
+    let data = pipe.fileHandleForReading.readDataToEndOfFile()
+    process.waitUntilExit()
+
+    return process.terminationStatus == 0 && !data.isEmpty ? data : nil
+}
+
+public func percentile(_ values: [Double], _ p: Int) -> Double
+{
+    guard !values.isEmpty else { return 0 }
+
+    let sorted = values.sorted()
+    return sorted[(sorted.count - 1) * p / 100]
+}
@@ -17,7 +17,8 @@ public class GoldSrcMDL
             meshes: self.meshes,
             textures: self.textures,
             sequences: self.sequences,
-            bones: mdlBones.map({ Int($0.parent) })
+            bones: mdlBones.map({ Int($0.parent) }),
+            hitboxes: self.hitboxes
         )
     }
     
@@ -25,6 +26,7 @@ public class GoldSrcMDL
     var meshes: [Mesh] = []
     var textures: [Texture] = []
     var sequences: [Sequence] = []
+    var hitboxes: [Hitbox] = []
     
     var buffer: BinaryReader
     
@@ -61,6 +63,7 @@ public class GoldSrcMDL
         
         seContext = SequencesEncoder.createContext(bytes)
         setupBones()
+        readHitboxes()
         
         readBodyparts()
         
@@ -126,6 +126,24 @@ extension GoldSrcMDL
             sequences.append(sequence)
         }
     }
+    
+    func readHitboxes()
+    {
+        let count = SequencesEncoder.getNumHitboxes(seContext)
+        
+        for index in 0 ..< count
+        {
+            var hitbox = SequencesEncoder.Hitbox()
+            SequencesEncoder.getHitbox(index, &hitbox, seContext)
+            
+            hitboxes.append(Hitbox(
+                bone: Int(hitbox.bone),
+                group: Int(hitbox.group),
+                mins: float3(hitbox.mins.x, hitbox.mins.y, hitbox.mins.z),
+                maxs: float3(hitbox.maxs.x, hitbox.maxs.y, hitbox.maxs.z)
+            ))
+        }
+    }
 }
 
 private extension GoldSrcMDL
@@ -44,6 +44,14 @@ public struct Sequence
     public let groundSpeed: Float
 }
 
+public struct Hitbox
+{
+    public let bone: Int    // -1 для боксов самой модели
+    public let group: Int   // 1 голова, 2 грудь, 3 живот, 4-7 руки и ноги
+    public let mins: SIMD3<Float>
+    public let maxs: SIMD3<Float>
+}
+
 public struct ValveModel
 {
     public var modelName = ""
@@ -51,4 +59,5 @@ public struct ValveModel
     public var textures: [Texture] = []
     public var sequences: [Sequence] = []
     public var bones: [Int] = []
+    public var hitboxes: [Hitbox] = []
 }
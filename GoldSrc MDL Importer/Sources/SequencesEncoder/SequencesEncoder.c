@@ -90,6 +90,31 @@ void getBoneRotation(int bone, t_vector3f* rotation, void* context)
     rotation->z =  ctx->frame_rot_euler[bone][2];
 }
 
+int getNumHitboxes(void* context)
+{
+    t_context *ctx = (t_context *)context;
+    
+    return ctx->m_studiohdr->numhitboxes;
+}
+
+void getHitbox(int index, t_hitbox* hitbox, void* context)
+{
+    t_context *ctx = (t_context *)context;
+    
+    mstudiobbox_t *pbbox = (mstudiobbox_t *)((byte *)ctx->m_studiohdr + ctx->m_studiohdr->hitboxindex) + index;
+    
+    hitbox->bone = pbbox->bone;
+    hitbox->group = pbbox->group;
+    
+    hitbox->mins.x = pbbox->bbmin[0];
+    hitbox->mins.y = pbbox->bbmin[1];
+    hitbox->mins.z = pbbox->bbmin[2];
+    
+    hitbox->maxs.x = pbbox->bbmax[0];
+    hitbox->maxs.y = pbbox->bbmax[1];
+    hitbox->maxs.z = pbbox->bbmax[2];
+}
+
 void calcBoneQuaternion(int frame, mstudiobone_t *pbone, mstudioanim_t *panim, float *q)
 {
     int                    j, k;
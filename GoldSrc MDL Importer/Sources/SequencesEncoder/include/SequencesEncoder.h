@@ -23,6 +23,13 @@ typedef struct Quaternion
     float x, y, z, w;
 } t_quaternion;
 
+typedef struct Hitbox
+{
+    int bone;       // -1 for boxes of the model itself
+    int group;      // 1 head, 2 chest, 3 stomach, 4-7 limbs, 0 generic
+    t_vector3f mins, maxs;
+} t_hitbox;
+
 void* createContext(const void* data);
 void clearContext(void* context);
 
@@ -31,4 +38,8 @@ void calcRotations(int sequence, int frame, void* context);
 void getBoneRotation(int bone, t_vector3f* position, void* context);
 void getBonePosition(int bone, t_vector3f* rotation, void* context);
 
+// Боксы попаданий из mstudiobbox_t, в пространстве своей кости
+int getNumHitboxes(void* context);
+void getHitbox(int index, t_hitbox* hitbox, void* context);
+
 #endif /* SequencesEncoder_h */
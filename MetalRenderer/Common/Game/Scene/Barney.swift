@@ -16,6 +16,9 @@ class Barney
     let minBounds = float3( -15, -15, -32 )
     let maxBounds = float3( 15, 15, 32 )
     
+    /// Index in the hitbox world of the scene, set once it was drawn
+    var hitboxEntity: Int?
+    
     private var movementSpeed: Float = 90.0
     
     private weak var scene: Q3MapScene?
@@ -13,6 +13,9 @@ final class BrushCollision
     struct BrushSet
     {
         var vertices: [float3] = []
+        
+        // normal and distance of every side, inside where dot(normal, p) <= distance
+        var planes: [float4] = []
     }
     
     private (set) var brushes: [BrushSet] = []
@@ -36,7 +39,8 @@ final class BrushCollision
                 continue
             }
             
-            let set = BrushSet(vertices: brushVertices)
+            let set = BrushSet(vertices: brushVertices,
+                               planes: planes.map { float4($0.normal, $0.distance) })
             brushes.append(set)
         }
     }
@@ -149,7 +153,7 @@ private extension BrushCollision
     }
 }
 
-private enum CONTENTS: Int, CaseIterable
+enum CONTENTS: Int, CaseIterable
 {
     case AREAPORTAL = 0x8000
     case BODY = 0x2000000
@@ -191,7 +195,7 @@ private enum CONTENTS: Int, CaseIterable
     }
 }
 
-private extension Int
+extension Int
 {
     func contains(_ value: CONTENTS) -> Bool
     {
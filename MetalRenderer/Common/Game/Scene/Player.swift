@@ -48,6 +48,7 @@ class Player
     private var isGrounded = false
     
     private var pickConstraint: BulletPoint2PointConstraint?
+    private var isWishGrab = false
     
     init(scene: Q3MapScene)
     {
@@ -129,8 +130,9 @@ class Player
         }
         
         Keyboard.onKeyDown = { [weak self] key in
+            // the world may be stepping right now, the grab waits for the next update
             if key == .e {
-                self?.grab()
+                self?.isWishGrab = true
             }
         }
     }
@@ -145,6 +147,12 @@ class Player
         camera.transform.position = transform.position + float3(0, 0, 40)
         camera.transform.rotation = transform.rotation
         
+        if isWishGrab
+        {
+            isWishGrab = false
+            grab()
+        }
+        
         if let constraint = self.pickConstraint
         {
             let start = camera.transform.position
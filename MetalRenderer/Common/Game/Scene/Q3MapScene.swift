@@ -19,7 +19,10 @@ class Q3MapScene
     private var worldMesh: WorldStaticMesh?
     
     private var collision: Q3MapCollision!
-    private var brushesCollision: BrushCollision!
+    
+    // kept until the static collision is made, the brushes are only built from it when there is no bake
+    private var collisionAsset: WorldCollisionAsset?
+    private var collisionHash: UInt64 = 0
     
     private var lightGrid: Q3MapLightGrid?
     
@@ -42,8 +45,14 @@ class Q3MapScene
     
     let world = BulletWorld()
     
+    // posed hitboxes of the entities, for shots
+    private let hitboxWorld = BulletHitboxWorld(margin: 4)
+    private var hitboxModel: Int?
+    private var hitboxOwners: [Int: Barney] = [:]
+    
     private var pinkCubeTransform = Transform()
     private (set) var pinkCubeMotion: BulletMotionState?
+    private var pinkCubeSlot: Int?
     
     private var rampTransform: Transform?
     private var rampMotion: BulletMotionState?
@@ -89,8 +98,8 @@ class Q3MapScene
                     {
                         collision = Q3MapCollision(asset: asset)
                         
-                        brushesCollision = BrushCollision()
-                        brushesCollision.loadFromAsset(asset)
+                        collisionAsset = asset
+                        collisionHash = Q3MapScene.collisionHash(of: data)
                         
                         brushes = BrushRenderer()
                         brushes?.loadFromAsset(asset)
@@ -152,6 +161,14 @@ class Q3MapScene
 
         world.gravity = vector3(0, 0, -800 * q2b)
         
+        // the next step runs while this frame renders, update() waits for it before touching the world
+        world.enableAsyncStepping()
+        
+        // props far from the camera step every second or fourth tick, past 4096 units they stand still
+        world.enableSimulationLod(withReducedRateDistance: 1024 * q2b,
+                                  lowRateDistance: 2048 * q2b,
+                                  frozenDistance: 4096 * q2b)
+        
         createWorldStaticCollision()
         createPinkCube()
 //        createRamp()
@@ -161,10 +178,13 @@ class Q3MapScene
     {
         guard !isPlaying else { return }
         
+        world.waitForStep()
         isPlaying = true
         
         AudioEngine.play(file: "Half-Life13.mp3")
         
+        removeBarneys()
+        
         DispatchQueue.global().async {
             self.spawnBarneys()
         }
@@ -181,6 +201,7 @@ class Q3MapScene
     {
         guard isPlaying else { return }
         
+        world.waitForStep()
         isPlaying = false
         
         AudioEngine.stopAllSounds()
@@ -192,6 +213,8 @@ class Q3MapScene
     {
         guard isReady else { return }
         
+        world.waitForStep()
+        
         if isPlaying
         {
             player?.update()
@@ -199,9 +222,21 @@ class Q3MapScene
         
         Particles.shared.update()
         
-        if let transform = pinkCubeMotion?.getWorldTransform()
+        if let camera = player?.camera
         {
-            pinkCubeTransform.position = transform.origin * b2q
+            // a 120 degree cone, islands outside of it count twice as far
+            world.setLodViewerPosition(camera.transform.position * q2b,
+                                       direction: camera.transform.rotation.forward,
+                                       cosHalfAngle: 0.5)
+        }
+        
+        let transforms = world.transforms
+        
+        if let slot = pinkCubeSlot, slot < transforms.count
+        {
+            let transform = transforms[slot]
+            
+            pinkCubeTransform.position = transform.position * b2q
             
             let quat = simd_quatf(vector: transform.rotation)
             
@@ -229,7 +264,7 @@ class Q3MapScene
             rampTransform?.rotation.roll = rotation.y.degrees
         }
         
-        world.stepSimulation(timeStep: GameTime.deltaTime, maxSubSteps: 10)
+        world.beginStep(timeStep: GameTime.deltaTime, maxSubSteps: 10)
     }
     
     private func moveBarneyToPlayer()
@@ -274,10 +309,23 @@ class Q3MapScene
         player?.spawn(with: transform)
     }
     
-    private func spawnBarneys()
+    private func removeBarneys()
     {
-        entities.removeAll()
+        // the hitboxes of the old ones would still catch shots and keep them alive
+        for entity in entities
+        {
+            if let handle = entity.hitboxEntity
+            {
+                hitboxWorld.remove(entity: handle)
+                hitboxOwners[handle] = nil
+            }
+        }
         
+        entities.removeAll()
+    }
+    
+    private func spawnBarneys()
+    {
         for point in spawnPoints.dropFirst()
         {
             let barney = Barney(scene: self)
@@ -289,6 +337,7 @@ class Q3MapScene
     }
     
     deinit {
+        world.waitForStep()
         world.removeAllConstraints()
     }
 }
@@ -341,6 +390,8 @@ extension Q3MapScene
             encoder?.setVertexBytes(&modelConstants, length: ModelConstants.stride, index: 2)
             
             entity.mesh?.renderWithEncoder(encoder!)
+            
+            updateHitboxes(of: entity, modelMatrix: modelMatrix)
         }
         
         if isPlaying
@@ -434,19 +485,13 @@ extension Q3MapScene
         var hitResult = HitResult()
         collision.traceRay(result: &hitResult, start: start, end: end)
         
-        let line = Intersection.Line(start: start, end: hitResult.endpos)
-        
-        let aabbs = entities.map {
-            Intersection.AABB(
-                mins: $0.minBounds + $0.transform.position,
-                maxs: $0.maxBounds + $0.transform.position
-            )
-        }
-        
-        if let result = Intersection.findIntersection(line: line, aabbs: aabbs)
+        if let hit = hitboxWorld.rayTest(from: start, to: hitResult.endpos), let entity = hitboxOwners[hit.entity]
         {
-            Particles.shared.addParticles(origin: result.point, dir: result.normal, count: 5)
-            entities[result.index].takeDamage()
+            // group 1 is the head in GoldSrc models
+            let count = hit.group == 1 ? 15 : 5
+            
+            Particles.shared.addParticles(origin: hit.point, dir: hit.normal, count: count)
+            entity.takeDamage()
         }
         else if hitResult.fraction > 0, let normal = hitResult.plane?.normal
         {
@@ -455,10 +500,116 @@ extension Q3MapScene
         }
     }
     
+    private func updateHitboxes(of entity: Barney, modelMatrix: float4x4)
+    {
+        guard let mesh = entity.mesh else { return }
+        
+        if entity.hitboxEntity == nil
+        {
+            let model = hitboxModel ?? makeHitboxModel(for: entity)
+            hitboxModel = model
+            
+            let handle = hitboxWorld.addEntity(model: model)
+            entity.hitboxEntity = handle
+            hitboxOwners[handle] = entity
+        }
+        
+        if let handle = entity.hitboxEntity
+        {
+            hitboxWorld.setPose(entity: handle, transform: modelMatrix, bones: mesh.boneMatrices)
+        }
+    }
+    
+    private func makeHitboxModel(for entity: Barney) -> Int
+    {
+        var hitboxes = (entity.mesh?.hitboxes ?? []).map {
+            BulletHitbox(bone: Int32($0.bone), group: Int32($0.group), mins: $0.mins, maxs: $0.maxs)
+        }
+        
+        // meshes saved without hitboxes get the old bounds, the model is drawn 25 units lower
+        if hitboxes.isEmpty
+        {
+            let offset = float3(0, 0, 25)
+            hitboxes = [BulletHitbox(bone: -1, group: 0, mins: entity.minBounds + offset, maxs: entity.maxBounds + offset)]
+        }
+        
+        return hitboxWorld.addModel(hitboxes: hitboxes)
+    }
+    
     private func createWorldStaticCollision()
     {
+        // One body for the whole map: the broadphase sees a single static proxy
+        // and brushes are found through the shape's own BVH
+        let brushSet = loadBakedBrushSet() ?? makeBrushSet()
+        collisionAsset = nil
+        
+        let transform = BulletTransform()
+        transform.setIdentity()
+        
+        let motionState = BulletMotionState(transform: transform)
+        let body = BulletRigidBody(mass: 0,
+                                   motionState: motionState,
+                                   collisionShape: brushSet)
+        body.friction = 0.5
+        world.add(rigidBody: body)
+    }
+    
+    // bump when makeBrushSet builds the brushes differently, older bakes are then ignored
+    private static let collisionBakeVersion: UInt64 = 1
+    
+    private static func collisionHash(of data: Data) -> UInt64
+    {
+        // FNV-1a, seeded with the bake version
+        var hash: UInt64 = 0xcbf29ce484222325 ^ collisionBakeVersion
+        
+        data.withUnsafeBytes { bytes in
+            for byte in bytes
+            {
+                hash = (hash ^ UInt64(byte)) &* 0x100000001b3
+            }
+        }
+        
+        return hash
+    }
+    
+    private var bakedCollisionURL: URL?
+    {
+        guard let caches = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first else { return nil }
+        
+        return caches
+            .appendingPathComponent("collision")
+            .appendingPathComponent(String(format: "%016llx.brushes", collisionHash))
+    }
+    
+    // The brush set baked by an earlier load of the same collision.json:
+    // no plane intersection, hull adjacency or BVH build
+    private func loadBakedBrushSet() -> BulletStaticBrushSetShape?
+    {
+        guard let url = bakedCollisionURL else { return nil }
+        
+        return BulletStaticBrushSetShape(bakedFile: url.path, sourceHash: collisionHash)
+    }
+    
+    private func makeBrushSet() -> BulletStaticBrushSetShape
+    {
+        let brushSet = BulletStaticBrushSetShape()
+        
+        guard let asset = collisionAsset else { return brushSet }
+        
+        let brushesCollision = BrushCollision()
+        brushesCollision.loadFromAsset(asset)
+        
         for brush in brushesCollision.brushes
         {
+            // the planes give exact faces for contact clipping and rays
+            let brushShape = BulletBrushShape(planes: brush.planes.map { float4($0.x, $0.y, $0.z, $0.w * q2b) })
+            
+            if brushShape.isValid
+            {
+                brushSet.addBrush(brushShape)
+                continue
+            }
+            
             let shape = BulletConvexHullShape()
             
             for point in brush.vertices
@@ -466,21 +617,31 @@ extension Q3MapScene
                 shape.addPoint(point * q2b)
             }
             
-            let transform = BulletTransform()
-            transform.setIdentity()
+            // walking the hull only beats the linear scan on big brushes (BulletBenchmark gjk)
+            if brush.vertices.count >= 64
+            {
+                shape.buildVertexAdjacency()
+            }
             
-            let motionState = BulletMotionState(transform: transform)
-            let body = BulletRigidBody(mass: 0,
-                                       motionState: motionState,
-                                       collisionShape: shape)
-            body.friction = 0.5
-            world.add(rigidBody: body)
+            brushSet.addBrush(shape)
         }
+        
+        brushSet.buildBvh()
+        
+        // the next load of this map maps the bake instead
+        if let url = bakedCollisionURL, let data = brushSet.bake(withSourceHash: collisionHash)
+        {
+            try? FileManager.default.createDirectory(at: url.deletingLastPathComponent(), withIntermediateDirectories: true)
+            try? data.write(to: url, options: .atomic)
+        }
+        
+        return brushSet
     }
     
     private func createPinkCube()
     {
         let colShape = BulletBoxShape(halfExtents: vector3(15, 15, 15) * q2b)
+        colShape.initializePolyhedralFeatures()
 
         let startTransform = BulletTransform()
         startTransform.setIdentity()
@@ -498,8 +659,10 @@ extension Q3MapScene
                                       localInertia: localInertia)
 
         world.add(rigidBody: colBody)
+        world.addLod(for: colBody)
 
         pinkCubeMotion = colMotionState
+        pinkCubeSlot = world.addTransformSlot(for: colBody)
         
         pinkCubeTransform.scale = float3(30, 30, 30)
         Debug.shared.addCube(transform: pinkCubeTransform, color: float4(1, 0, 0, 1))
@@ -511,6 +674,7 @@ extension Q3MapScene
         let scale = float3(340, 96, 8)
         
         let shape = BulletBoxShape(halfExtents: scale * 0.5 * q2b)
+        shape.initializePolyhedralFeatures()
         
         let startTransform = BulletTransform()
         startTransform.setIdentity()
@@ -528,6 +692,7 @@ extension Q3MapScene
                                    localInertia: localInertia)
         
         world.add(rigidBody: body)
+        world.addLod(for: body)
         
         let transform = Transform()
         transform.position = position
@@ -27,6 +27,16 @@ final class SkeletalMesh
     
     private (set) var groundSpeed: Float = 0
     
+    private (set) var hitboxes: [SkeletalMeshAsset.Hitbox] = []
+    
+    /// Model space bone matrices the mesh was last drawn with
+    var boneMatrices: UnsafeBufferPointer<float4x4> {
+        guard let buffer = animBuffer else { return UnsafeBufferPointer(start: nil, count: 0) }
+        
+        let pointer = buffer.contents().bindMemory(to: float4x4.self, capacity: bones.count)
+        return UnsafeBufferPointer(start: pointer, count: bones.count)
+    }
+    
     var sequenceName: String? {
         didSet {
             framesCount = 0
@@ -113,6 +123,7 @@ final class SkeletalMesh
         
         sequences = Dictionary(uniqueKeysWithValues: asset.sequences.map{ ($0.name, $0) })
         bones = asset.bones.map { Int($0) }
+        hitboxes = asset.hitboxes
     }
     
     private func initSequence(named: String)
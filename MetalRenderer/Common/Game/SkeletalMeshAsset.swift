@@ -17,6 +17,7 @@ struct SkeletalMeshAsset
     var vertices: [Vertex] = []
     var indices: [UInt32] = []
     var bones: [Int32] = []
+    var hitboxes: [Hitbox] = []
 
     struct Surface
     {
@@ -45,4 +46,12 @@ struct SkeletalMeshAsset
         let rotationPerBone: [SIMD3<Float>]
         let positionPerBone: [SIMD3<Float>]
     }
+    
+    struct Hitbox
+    {
+        let bone: Int   // -1 for boxes in model space
+        let group: Int
+        let mins: SIMD3<Float>
+        let maxs: SIMD3<Float>
+    }
 }
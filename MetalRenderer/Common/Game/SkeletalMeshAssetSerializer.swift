@@ -26,6 +26,10 @@ extension SkeletalMeshAsset
         let positions: [float3] = readChanks(for: header.bonepositions, in: bytes)
         let bones: [Int32] = readChanks(for: header.bones, in: bytes)
         
+        // files saved before hitboxes end the header at bones, textures follow right after it
+        let hasHitboxes = Int(header.textures.offset) >= MemoryLayout<FileHeader>.stride
+        let hitboxes: [FileHitbox] = hasHitboxes ? readChanks(for: header.hitboxes, in: bytes) : []
+        
         var asset = SkeletalMeshAsset()
         
         asset.name = charsToString(header.name)
@@ -44,6 +48,10 @@ extension SkeletalMeshAsset
         
         asset.bones = bones
         
+        asset.hitboxes = hitboxes.map {
+            Hitbox(bone: Int($0.bone), group: Int($0.group), mins: $0.mins, maxs: $0.maxs)
+        }
+        
         let numBones = bones.count
         let bonesRotations = rotations.chunked(into: numBones)
         let bonesPositions = positions.chunked(into: numBones)
@@ -91,6 +99,7 @@ extension SkeletalMeshAsset
         let rotationsData = rotationsData()
         let positionsData = positionsData()
         let bonesData = bonesData()
+        let hitboxesData = hitboxesData()
         
         
         var offset = Int32(MemoryLayout<FileHeader>.stride)
@@ -119,6 +128,9 @@ extension SkeletalMeshAsset
         let bonesEntry = EntryInfo(offset: offset, length: Int32(bonesData.count))
         offset += bonesEntry.length
         
+        let hitboxesEntry = EntryInfo(offset: offset, length: Int32(hitboxesData.count))
+        offset += hitboxesEntry.length
+        
         var header = FileHeader(
             name: name.asTuple64CChars,
             textures: texturesEntry,
@@ -128,7 +140,8 @@ extension SkeletalMeshAsset
             sequences: sequencesEntry,
             bonerotations: rotationsEntry,
             bonepositions: positionsEntry,
-            bones: bonesEntry
+            bones: bonesEntry,
+            hitboxes: hitboxesEntry
         )
         
         var data = Data(bytes: &header, count: MemoryLayout<FileHeader>.stride)
@@ -141,6 +154,7 @@ extension SkeletalMeshAsset
         data.append(rotationsData)
         data.append(positionsData)
         data.append(bonesData)
+        data.append(hitboxesData)
         
         return data
     }
@@ -293,6 +307,26 @@ extension SkeletalMeshAsset
         
         return bonesData
     }
+    
+    private func hitboxesData() -> Data
+    {
+        var hitboxesData = Data()
+        
+        for hitbox in hitboxes
+        {
+            var fileHitbox = FileHitbox(
+                bone: Int32(hitbox.bone),
+                group: Int32(hitbox.group),
+                mins: hitbox.mins,
+                maxs: hitbox.maxs
+            )
+            
+            let data = Data(bytes: &fileHitbox, count: MemoryLayout<FileHitbox>.stride)
+            hitboxesData.append(data)
+        }
+        
+        return hitboxesData
+    }
 }
 
 private extension UnsafeRawPointer
@@ -360,6 +394,7 @@ private struct FileHeader
     let bonerotations: EntryInfo
     let bonepositions: EntryInfo
     let bones: EntryInfo
+    let hitboxes: EntryInfo
 }
 
 private struct EntryInfo
@@ -383,3 +418,11 @@ private struct FileSequence
     let fps: Float
     let groundSpeed: Float
 }
+
+private struct FileHitbox
+{
+    let bone: Int32
+    let group: Int32
+    let mins: float3
+    let maxs: float3
+}
@@ -8,6 +8,8 @@
 import Foundation
 import MetalKit
 import Carbon
+import SwiftBullet
+import DetourPathfinder
 
 final class GameApplication: NSObject
 {
@@ -22,6 +24,10 @@ final class GameApplication: NSObject
         self.view = view
         super.init()
         
+        BulletMemoryTracker.installTracking(libraries: [
+            ("detour", { DetourPathfinder.setAllocator($0, free: $1, permanentTag: $2, temporaryTag: $3) })
+        ])
+        
         view.clearColor = .init(red: 0.02, green: 0.02, blue: 0.03, alpha: 1.0)
         view.colorPixelFormat = Preferences.colorPixelFormat
         view.depthStencilPixelFormat = Preferences.depthStencilPixelFormat
@@ -52,6 +58,7 @@ final class GameApplication: NSObject
     private func update()
     {
         GameTime.update()
+        BulletMemoryTracker.nextFrame()
         
         guard let viewport = self.viewport else { return }
         guard let scene = self.scene else { return }
@@ -64,6 +64,10 @@ extension SkeletalMeshAsset
         
         asset.bones = model.bones.map { Int32($0) }
         
+        asset.hitboxes = model.hitboxes.map {
+            Hitbox(bone: $0.bone, group: $0.group, mins: $0.mins, maxs: $0.maxs)
+        }
+        
         return asset
     }
 }
@@ -215,28 +215,28 @@ final class AssetsPanel
         let entities = WorldEntitiesAsset.make(from: bsp)
         let collision = WorldCollisionAsset.make(from: bsp)
         
-        var verts = bsp.vertices.flatMap({ [$0.position.x, $0.position.z, -$0.position.y] })
-        let nverts = Int32(bsp.vertices.count)
+        // Navigation is built from the same solid brushes that make up the collision world,
+        // converted to the Y-up space expected by Recast
+        var planes: [Float] = []
+        var planeCounts: [Int32] = []
         
-        var tris: [Int32] = []
-        var ntris: Int32 = 0
-        
-        for face in bsp.faces
+        for brush in collision.brushes
         {
-            if face.textureName == "noshader" { continue }
-            if face.textureName.contains("sky") { continue }
+            if !(brush.contentFlags.contains(.SOLID) || brush.contentFlags.contains(.PLAYERCLIP)) {
+                continue
+            }
             
-            for poly in face.vertexIndices.chunked(into: 3)
+            for side in collision.brushSides[brush.brushside ..< brush.brushside + brush.numBrushsides]
             {
-                let indices: [Int32] = [ Int32(poly[0]), Int32(poly[2]), Int32(poly[1]) ]
-                tris.append(contentsOf: indices)
-                
-                ntris += 1
+                let plane = collision.planes[side.plane]
+                planes.append(contentsOf: [plane.normal.x, plane.normal.z, -plane.normal.y, plane.distance])
             }
+            
+            planeCounts.append(Int32(brush.numBrushsides))
         }
         
         let navmesh = NavmeshBulder()
-        navmesh.calculateVerts(&verts, nverts: nverts, tris: &tris, ntris: ntris)
+        navmesh.calculateBrushPlanes(&planes, planeCounts: &planeCounts, nbrushes: Int32(planeCounts.count))
         
         do
         {
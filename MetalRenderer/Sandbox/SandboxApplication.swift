@@ -9,6 +9,9 @@ import Foundation
 import ApplicationServices
 import MetalKit
 import ImGui
+import SwiftBullet
+import DetourPathfinder
+import RecastObjC
 
 final class SandboxApplication: NSObject
 {
@@ -25,6 +28,11 @@ final class SandboxApplication: NSObject
         self.view = view
         super.init()
         
+        BulletMemoryTracker.installTracking(libraries: [
+            ("detour", { DetourPathfinder.setAllocator($0, free: $1, permanentTag: $2, temporaryTag: $3) }),
+            ("recast", { NavmeshBulder.setAllocFunction($0, freeFunction: $1, permanentTag: $2, temporaryTag: $3) })
+        ])
+        
         view.clearColor = .init(red: 0.02, green: 0.02, blue: 0.03, alpha: 1.0)
         view.colorPixelFormat = Preferences.colorPixelFormat
         view.depthStencilPixelFormat = Preferences.depthStencilPixelFormat
@@ -110,6 +118,7 @@ final class SandboxApplication: NSObject
     private func update()
     {
         GameTime.update()
+        BulletMemoryTracker.nextFrame()
         
         guard let viewport = self.viewport else { return }
         
@@ -8,7 +8,9 @@ let package = Package(
     products: [
         .library(name: "SwiftBullet", targets: ["SwiftBullet"])
     ],
-    dependencies: [],
+    dependencies: [
+        .package(path: "../BenchmarkSupport")
+    ],
     targets: [
         .target(
             name: "SwiftBullet",
@@ -22,6 +24,9 @@ let package = Package(
             publicHeadersPath: ".",
             cSettings: [
                 .headerSearchPath(".")
+            ],
+            cxxSettings: [
+                .define("BT_THREADSAFE", to: "1")
             ]
         ),
         .target(
@@ -30,7 +35,8 @@ let package = Package(
             path: "Sources/bullet-2.87",
             publicHeadersPath: ".",
             cxxSettings: [
-                .headerSearchPath(".")
+                .headerSearchPath("."),
+                .define("BT_THREADSAFE", to: "1")
             ]
         ),
         .target(
@@ -39,8 +45,22 @@ let package = Package(
             path: "Sources/DynamicCharacter",
             publicHeadersPath: ".",
             cxxSettings: [
-                .headerSearchPath(".")
+                .headerSearchPath("."),
+                .define("BT_THREADSAFE", to: "1")
             ]
+        ),
+        .target(
+            name: "BulletBenchmark",
+            dependencies: ["bullet", "DynamicCharacter"],
+            path: "Sources/BulletBenchmark",
+            cxxSettings: [
+                .define("BT_THREADSAFE", to: "1")
+            ]
+        ),
+        .target(
+            name: "PhysicsBenchmark",
+            dependencies: ["SwiftBullet", "BenchmarkSupport"],
+            path: "Sources/PhysicsBenchmark"
         )
     ],
     cxxLanguageStandard: .cxx11
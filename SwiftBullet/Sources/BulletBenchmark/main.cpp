@@ -0,0 +1,4885 @@
+//
+//  main.cpp
+//  BulletBenchmark
+//
+//  Created by Fedor Artemenkov on 18.10.2026.
+//
+//  Headless checks and benchmarks for the parts of Bullet changed in this package.
+//  Usage: swift run -c release BulletBenchmark [stress|scaling|gjk|rays|packets|bulk|events|triggers|async|export|snapshot|solver|islands|trace|memory|hitboxes|characters|crowd|bake|lod|broadphase] [--seed N] [--iterations N] [--out file.json]
+//
+
+#include <LinearMath/btThreads.h>
+#include <LinearMath/btTaskSchedulerNative.h>
+#include <LinearMath/btTraceProfiler.h>
+#include <LinearMath/btMemoryTracker.h>
+#include <LinearMath/btAlignedObjectArray.h>
+#include <LinearMath/btDefaultMotionState.h>
+#include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
+#include <BulletCollision/BroadphaseCollision/btHashGridBroadphase.h>
+#include <BulletCollision/BroadphaseCollision/btRayPacket.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionDispatch/btContactEventQueue.h>
+#include <BulletCollision/CollisionDispatch/btGhostObject.h>
+#include <BulletCollision/CollisionDispatch/btHitboxWorld.h>
+#include <BulletCollision/CollisionDispatch/btTriggerManager.h>
+#include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
+#include <BulletCollision/CollisionShapes/btBakedBrushSet.h>
+#include <BulletCollision/CollisionShapes/btBoxShape.h>
+#include <BulletCollision/CollisionShapes/btBrushShape.h>
+#include <BulletCollision/CollisionShapes/btCapsuleShape.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
+#include <BulletCollision/CollisionShapes/btSphereShape.h>
+#include <BulletCollision/CollisionShapes/btStaticBrushSetShape.h>
+#include <BulletCollision/CollisionShapes/btHillClimbingConvexHullShape.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
+#include <BulletCollision/NarrowPhaseCollision/btPointCollector.h>
+#include <BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h>
+#include <BulletDynamics/ConstraintSolver/btBatchedConstraintSolver.h>
+#include <BulletDynamics/ConstraintSolver/btPoint2PointConstraint.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h>
+#include <BulletDynamics/Dynamics/btAsyncStepper.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/Dynamics/btIncrementalIslandManager.h>
+#include <BulletDynamics/Dynamics/btRigidBody.h>
+#include <BulletDynamics/Dynamics/btSimulationLod.h>
+#include <BulletDynamics/Dynamics/btTransformExport.h>
+#include <BulletDynamics/Dynamics/btWorldSnapshot.h>
+#include <DynamicCharacterController.h>
+#include <DynamicCharacterGroup.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Options
+{
+    std::string mode = "all";
+    unsigned int seed = 1337;
+    int iterations = 200;
+    const char* output = nullptr;
+
+    Options(int argc, const char* argv[])
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = (unsigned int) atoi(argv[++i]);
+            else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) iterations = atoi(argv[++i]);
+            else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) output = argv[++i];
+            else mode = argv[i];
+        }
+    }
+};
+
+static unsigned int seededRand(unsigned int& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double percentile(std::vector<double> values, int p)
+{
+    if (values.empty()) return 0;
+
+    std::sort(values.begin(), values.end());
+    return values[(values.size() - 1) * p / 100];
+}
+
+// MARK: - Stress
+
+// Every index must be visited exactly once
+struct CoverageBody : public btIParallelForBody
+{
+    std::atomic<int>* visits;
+
+    void forLoop(int iBegin, int iEnd) const override
+    {
+        for (int i = iBegin; i < iEnd; ++i)
+        {
+            visits[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
+
+struct ValuesSumBody : public btIParallelSumBody
+{
+    const btScalar* values;
+
+    btScalar sumLoop(int iBegin, int iEnd) const override
+    {
+        btScalar sum = 0;
+
+        for (int i = iBegin; i < iEnd; ++i)
+        {
+            sum += values[i];
+        }
+
+        return sum;
+    }
+};
+
+// Nested calls must run in place and still cover their range
+struct NestedBody : public btIParallelForBody
+{
+    std::atomic<int>* visits;
+    int innerCount;
+
+    void forLoop(int iBegin, int iEnd) const override
+    {
+        CoverageBody inner;
+        inner.visits = visits;
+
+        for (int i = iBegin; i < iEnd; ++i)
+        {
+            btParallelFor(i * innerCount, (i + 1) * innerCount, 1, inner);
+        }
+    }
+};
+
+static int runStress(btTaskSchedulerNative* scheduler, const Options& options, FILE* out)
+{
+    unsigned int state = options.seed;
+    int failures = 0;
+    int runs = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int iteration = 0; iteration < options.iterations; ++iteration)
+    {
+        int numThreads = 1 + seededRand(state) % 16;
+        int count = seededRand(state) % 20000;
+        int grainSize = 1 + seededRand(state) % 512;
+
+        scheduler->setNumThreads(numThreads);
+        scheduler->setSpinCount(seededRand(state) % 2 ? 0 : 10000);
+
+        std::vector<std::atomic<int>> visits(count);
+        for (auto& visit : visits) visit = 0;
+
+        CoverageBody coverage;
+        coverage.visits = visits.data();
+        btParallelFor(0, count, grainSize, coverage);
+
+        for (int i = 0; i < count; ++i)
+        {
+            if (visits[i] != 1) { ++failures; break; }
+        }
+
+        // Small integers are summed exactly, so any lost or doubled chunk shows up
+        btAlignedObjectArray<btScalar> values;
+        values.resize(count);
+        btScalar serial = 0;
+
+        for (int i = 0; i < count; ++i)
+        {
+            values[i] = btScalar(seededRand(state) % 64);
+            serial += values[i];
+        }
+
+        ValuesSumBody sum;
+        sum.values = count ? &values[0] : nullptr;
+
+        if (btParallelSum(0, count, grainSize, sum) != serial) ++failures;
+
+        int outer = 1 + count / 1000;
+        int inner = 16;
+        std::vector<std::atomic<int>> nested(outer * inner);
+        for (auto& visit : nested) visit = 0;
+
+        NestedBody nestedBody;
+        nestedBody.visits = nested.data();
+        nestedBody.innerCount = inner;
+        btParallelFor(0, outer, 1, nestedBody);
+
+        for (auto& visit : nested)
+        {
+            if (visit != 1) { ++failures; break; }
+        }
+
+        runs += 3;
+    }
+
+    fprintf(out, "  \"stress\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"runs\": %d,\n", runs);
+    fprintf(out, "    \"failures\": %d,\n", failures);
+    fprintf(out, "    \"total_ms\": %.3f\n", elapsedMs(start));
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Scaling
+
+// Roughly the cost of a narrowphase pair per item
+struct WorkBody : public btIParallelForBody
+{
+    btScalar* results;
+
+    void forLoop(int iBegin, int iEnd) const override
+    {
+        for (int i = iBegin; i < iEnd; ++i)
+        {
+            btScalar x = btScalar(i);
+
+            for (int k = 0; k < 64; ++k)
+            {
+                x = btSqrt(x * x + btScalar(k)) * btScalar(0.5) + btSin(x);
+            }
+
+            results[i] = x;
+        }
+    }
+};
+
+struct WorkSumBody : public btIParallelSumBody
+{
+    const btScalar* results;
+
+    btScalar sumLoop(int iBegin, int iEnd) const override
+    {
+        btScalar sum = 0;
+
+        for (int i = iBegin; i < iEnd; ++i)
+        {
+            sum += btSqrt(btFabs(results[i]));
+        }
+
+        return sum;
+    }
+};
+
+static void runScaling(btTaskSchedulerNative* scheduler, const Options& options, FILE* out)
+{
+    const int count = 1 << 16;
+    const int grainSize = 256;
+    const int threadCounts[] = { 1, 2, 4, 8, 16 };
+    const int runs = std::max(options.iterations / 10, 5);
+
+    btAlignedObjectArray<btScalar> results;
+    results.resize(count);
+
+    WorkBody work;
+    work.results = &results[0];
+
+    WorkSumBody sum;
+    sum.results = &results[0];
+
+    double baseFor = 0;
+    double baseSum = 0;
+
+    fprintf(out, "  \"scaling\": {\n");
+    fprintf(out, "    \"items\": %d,\n", count);
+    fprintf(out, "    \"grain_size\": %d,\n", grainSize);
+    fprintf(out, "    \"max_threads\": %d,\n", scheduler->getMaxNumThreads());
+    fprintf(out, "    \"runs\": [\n");
+
+    for (int t = 0; t < 5; ++t)
+    {
+        scheduler->setNumThreads(threadCounts[t]);
+        scheduler->setSpinCount(10000);
+
+        std::vector<double> forTimes;
+        std::vector<double> sumTimes;
+
+        for (int r = 0; r < runs; ++r)
+        {
+            auto start = std::chrono::steady_clock::now();
+            btParallelFor(0, count, grainSize, work);
+            forTimes.push_back(elapsedMs(start));
+
+            start = std::chrono::steady_clock::now();
+            btParallelSum(0, count, grainSize, sum);
+            sumTimes.push_back(elapsedMs(start));
+        }
+
+        double forP50 = percentile(forTimes, 50);
+        double sumP50 = percentile(sumTimes, 50);
+
+        if (t == 0)
+        {
+            baseFor = forP50;
+            baseSum = sumP50;
+        }
+
+        fprintf(out, "      {\n");
+        fprintf(out, "        \"threads\": %d,\n", scheduler->getNumThreads());
+        fprintf(out, "        \"parallel_for_p50_ms\": %.3f,\n", forP50);
+        fprintf(out, "        \"parallel_for_p99_ms\": %.3f,\n", percentile(forTimes, 99));
+        fprintf(out, "        \"parallel_for_speedup\": %.2f,\n", forP50 > 0 ? baseFor / forP50 : 0.0);
+        fprintf(out, "        \"parallel_sum_p50_ms\": %.3f,\n", sumP50);
+        fprintf(out, "        \"parallel_sum_p99_ms\": %.3f,\n", percentile(sumTimes, 99));
+        fprintf(out, "        \"parallel_sum_speedup\": %.2f\n", sumP50 > 0 ? baseSum / sumP50 : 0.0);
+        fprintf(out, "      }%s\n", t < 4 ? "," : "");
+    }
+
+    fprintf(out, "    ]\n");
+    fprintf(out, "  }");
+}
+
+// MARK: - GJK
+
+static btScalar randomUnit(unsigned int& state)
+{
+    return btScalar(seededRand(state) % 20001) / btScalar(10000) - btScalar(1);
+}
+
+// Brush-sized hull: points on a flattened ellipsoid, like the corners of a cut brush
+static btAlignedObjectArray<btVector3> brushPoints(unsigned int& state, int count)
+{
+    btAlignedObjectArray<btVector3> points;
+
+    while (points.size() < count)
+    {
+        btVector3 dir(randomUnit(state), randomUnit(state), randomUnit(state));
+        if (dir.length2() < btScalar(0.01) || dir.length2() > 1) continue;
+
+        points.push_back(dir.normalized() * btVector3(2, 1.5, 0.75));
+    }
+
+    return points;
+}
+
+// A box moving in small steps around the hull, so consecutive queries are coherent like frames are
+static double timeQueries(const btConvexShape* hull, const btConvexShape* box, const std::vector<btTransform>& path, std::vector<btScalar>& distances)
+{
+    btVoronoiSimplexSolver simplex;
+    btGjkEpaPenetrationDepthSolver epa;
+
+    distances.resize(path.size());
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        btGjkPairDetector detector(hull, box, &simplex, &epa);
+
+        btGjkPairDetector::ClosestPointInput input;
+        input.m_transformA.setIdentity();
+        input.m_transformB = path[i];
+
+        btPointCollector result;
+        detector.getClosestPoints(input, result, nullptr);
+
+        distances[i] = result.m_hasResult ? result.m_distance : BT_LARGE_FLOAT;
+    }
+
+    return elapsedMs(start);
+}
+
+// Support mapping alone, with directions turning slowly like GJK's between iterations
+static double timeSupport(const btConvexShape* hull, int count, btScalar& checksum)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < count; ++i)
+    {
+        btScalar angle = btScalar(i) * btScalar(0.02);
+        btVector3 dir(btCos(angle), btSin(angle), btSin(angle * btScalar(0.7)));
+        checksum += hull->localGetSupportVertexWithoutMarginNonVirtual(dir).dot(dir);
+    }
+
+    return elapsedMs(start);
+}
+
+static int runGjk(const Options& options, FILE* out)
+{
+    const int pointCounts[] = { 8, 16, 32, 64, 128 };
+    const int frames = std::max(options.iterations, 1) * 50;
+
+    unsigned int state = options.seed;
+    int failures = 0;
+
+    btBoxShape box(btVector3(btScalar(0.4), btScalar(0.4), btScalar(0.4)));
+
+    fprintf(out, "  \"gjk\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"queries\": %d,\n", frames);
+    fprintf(out, "    \"hulls\": [\n");
+
+    for (int c = 0; c < 5; ++c)
+    {
+        btAlignedObjectArray<btVector3> points = brushPoints(state, pointCounts[c]);
+
+        btConvexHullShape linear(&points[0].getX(), points.size(), sizeof(btVector3));
+        btHillClimbingConvexHullShape climbing(&points[0].getX(), points.size(), sizeof(btVector3));
+
+        std::vector<btTransform> path(frames);
+        btVector3 axis = btVector3(randomUnit(state), randomUnit(state), 1).normalized();
+
+        for (int i = 0; i < frames; ++i)
+        {
+            // in and out of contact while circling the hull
+            btScalar angle = btScalar(i) * btScalar(0.01);
+            btScalar radius = btScalar(2.2) + btScalar(0.6) * btSin(angle * btScalar(3.7));
+
+            path[i].setRotation(btQuaternion(axis, angle * btScalar(0.5)));
+            path[i].setOrigin(btVector3(btCos(angle) * radius, btSin(angle) * radius * btScalar(0.8), btSin(angle * btScalar(1.3)) * btScalar(0.6)));
+        }
+
+        std::vector<btScalar> linearDistances;
+        std::vector<btScalar> climbingDistances;
+
+        double linearMs = timeQueries(&linear, &box, path, linearDistances);
+        double climbingMs = timeQueries(&climbing, &box, path, climbingDistances);
+
+        btScalar linearChecksum = 0;
+        btScalar climbingChecksum = 0;
+        double linearSupportMs = timeSupport(&linear, frames * 10, linearChecksum);
+        double climbingSupportMs = timeSupport(&climbing, frames * 10, climbingChecksum);
+
+        if (btFabs(linearChecksum - climbingChecksum) > btScalar(1e-3) * btFabs(linearChecksum)) ++failures;
+
+        // Both walk to the same support vertices, so GJK and EPA see the same simplex
+        btScalar maxError = 0;
+        for (int i = 0; i < frames; ++i)
+        {
+            maxError = std::max(maxError, btFabs(linearDistances[i] - climbingDistances[i]));
+        }
+
+        if (maxError > btScalar(1e-3)) ++failures;
+
+        fprintf(out, "      {\n");
+        fprintf(out, "        \"points\": %d,\n", pointCounts[c]);
+        fprintf(out, "        \"adjacency\": %s,\n", climbing.hasVertexAdjacency() ? "true" : "false");
+        fprintf(out, "        \"linear_ns_per_query\": %.1f,\n", linearMs * 1e6 / frames);
+        fprintf(out, "        \"climbing_ns_per_query\": %.1f,\n", climbingMs * 1e6 / frames);
+        fprintf(out, "        \"speedup\": %.2f,\n", climbingMs > 0 ? linearMs / climbingMs : 0.0);
+        fprintf(out, "        \"linear_ns_per_support\": %.1f,\n", linearSupportMs * 1e6 / (frames * 10));
+        fprintf(out, "        \"climbing_ns_per_support\": %.1f,\n", climbingSupportMs * 1e6 / (frames * 10));
+        fprintf(out, "        \"max_distance_error\": %g\n", double(maxError));
+        fprintf(out, "      }%s\n", c < 4 ? "," : "");
+    }
+
+    fprintf(out, "    ],\n");
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Rays
+
+// One serial query per ray, the way callers did before rayTestBatch
+static double timeSingleRays(const btCollisionWorld& world, const btAlignedObjectArray<btVector3>& from, const btAlignedObjectArray<btVector3>& to, int count, btCollisionWorld::BatchedQueryResults& results)
+{
+    results.resize(count);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < count; ++i)
+    {
+        btCollisionWorld::ClosestRayResultCallback callback(from[i], to[i]);
+        world.rayTest(from[i], to[i], callback);
+
+        results.m_hitFraction[i] = callback.m_closestHitFraction;
+        results.m_hitCollisionObject[i] = callback.m_collisionObject;
+    }
+
+    return elapsedMs(start);
+}
+
+static double timeSingleSweeps(const btCollisionWorld& world, const btConvexShape* shape, const btAlignedObjectArray<btTransform>& from, const btAlignedObjectArray<btTransform>& to, int count, btCollisionWorld::BatchedQueryResults& results)
+{
+    results.resize(count);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < count; ++i)
+    {
+        btCollisionWorld::ClosestConvexResultCallback callback(from[i].getOrigin(), to[i].getOrigin());
+        world.convexSweepTest(shape, from[i], to[i], callback);
+
+        results.m_hitFraction[i] = callback.m_closestHitFraction;
+        results.m_hitCollisionObject[i] = callback.m_hitCollisionObject;
+    }
+
+    return elapsedMs(start);
+}
+
+// Batched answers must be the serial ones, only computed in another order and on other threads
+static int countMismatches(const btCollisionWorld::BatchedQueryResults& expected, const btCollisionWorld::BatchedQueryResults& actual, int count)
+{
+    int mismatches = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (expected.m_hitCollisionObject[i] != actual.m_hitCollisionObject[i] ||
+            btFabs(expected.m_hitFraction[i] - actual.m_hitFraction[i]) > btScalar(1e-5))
+        {
+            ++mismatches;
+        }
+    }
+
+    return mismatches;
+}
+
+static int runRays(btTaskSchedulerNative* scheduler, const Options& options, FILE* out)
+{
+    const int rayCounts[] = { 1000, 10000 };
+    const int threadCounts[] = { 1, 2, 4, 8 };
+    const int sweepCount = 1000;
+    const int runs = std::max(options.iterations / 20, 5);
+
+    unsigned int state = options.seed;
+    int failures = 0;
+
+    // An arena of brush-sized boxes and loose spheres, in game units of the Q3 maps
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher(&configuration);
+    btDbvtBroadphase broadphase;
+    btCollisionWorld world(&dispatcher, &broadphase, &configuration);
+
+    btBoxShape wall(btVector3(2, 2, 2));
+    btBoxShape floor(btVector3(40, 40, 1));
+    btSphereShape ball(btScalar(0.5));
+    btSphereShape probe(btScalar(0.25));
+
+    btAlignedObjectArray<btCollisionObject*> objects;
+
+    btCollisionObject* ground = new btCollisionObject();
+    ground->setCollisionShape(&floor);
+    ground->getWorldTransform().setOrigin(btVector3(0, 0, -1));
+    objects.push_back(ground);
+
+    for (int i = 0; i < 400; ++i)
+    {
+        btCollisionObject* object = new btCollisionObject();
+        object->setCollisionShape(i % 4 == 0 ? static_cast<btCollisionShape*>(&ball) : &wall);
+        object->getWorldTransform().setOrigin(btVector3(randomUnit(state) * 38, randomUnit(state) * 38, btScalar(seededRand(state) % 8)));
+        objects.push_back(object);
+    }
+
+    for (int i = 0; i < objects.size(); ++i)
+    {
+        world.addCollisionObject(objects[i]);
+    }
+
+    world.updateAabbs();
+
+    // Hitscan-like rays: short bursts from a few shooters, plus long random ones
+    btAlignedObjectArray<btVector3> from;
+    btAlignedObjectArray<btVector3> to;
+    btAlignedObjectArray<btTransform> sweepFrom;
+    btAlignedObjectArray<btTransform> sweepTo;
+
+    for (int i = 0; i < rayCounts[1]; ++i)
+    {
+        btVector3 origin(randomUnit(state) * 36, randomUnit(state) * 36, btScalar(1) + btScalar(seededRand(state) % 6));
+        btVector3 dir(randomUnit(state), randomUnit(state), randomUnit(state) * btScalar(0.3));
+        if (dir.length2() < btScalar(0.01)) dir.setValue(1, 0, 0);
+
+        from.push_back(origin);
+        to.push_back(origin + dir.normalized() * btScalar(i % 2 ? 80 : 20));
+
+        sweepFrom.push_back(btTransform(btQuaternion::getIdentity(), from[i]));
+        sweepTo.push_back(btTransform(btQuaternion::getIdentity(), to[i]));
+    }
+
+    btCollisionWorld::BatchedQueryResults expected;
+    btCollisionWorld::BatchedQueryResults batched;
+
+    fprintf(out, "  \"rays\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"objects\": %d,\n", objects.size());
+    fprintf(out, "    \"runs\": [\n");
+
+    for (int c = 0; c < 2; ++c)
+    {
+        int count = rayCounts[c];
+
+        std::vector<double> singleTimes;
+        for (int r = 0; r < runs; ++r)
+        {
+            singleTimes.push_back(timeSingleRays(world, from, to, count, expected));
+        }
+
+        double singleP50 = percentile(singleTimes, 50);
+        int hits = 0;
+        for (int i = 0; i < count; ++i) hits += expected.hasHit(i) ? 1 : 0;
+
+        for (int t = 0; t < 4; ++t)
+        {
+            scheduler->setNumThreads(threadCounts[t]);
+            scheduler->setSpinCount(10000);
+
+            std::vector<double> batchTimes;
+            int mismatches = 0;
+
+            for (int r = 0; r < runs; ++r)
+            {
+                auto start = std::chrono::steady_clock::now();
+                world.rayTestBatch(&from[0], &to[0], nullptr, nullptr, count, batched);
+                batchTimes.push_back(elapsedMs(start));
+
+                mismatches = std::max(mismatches, countMismatches(expected, batched, count));
+            }
+
+            if (mismatches > 0) ++failures;
+
+            double batchP50 = percentile(batchTimes, 50);
+
+            fprintf(out, "      {\n");
+            fprintf(out, "        \"rays\": %d,\n", count);
+            fprintf(out, "        \"hits\": %d,\n", hits);
+            fprintf(out, "        \"threads\": %d,\n", scheduler->getNumThreads());
+            fprintf(out, "        \"single_p50_ms\": %.3f,\n", singleP50);
+            fprintf(out, "        \"batch_p50_ms\": %.3f,\n", batchP50);
+            fprintf(out, "        \"batch_p99_ms\": %.3f,\n", percentile(batchTimes, 99));
+            fprintf(out, "        \"mrays_per_s\": %.2f,\n", batchP50 > 0 ? count / (batchP50 * 1e3) : 0.0);
+            fprintf(out, "        \"speedup\": %.2f,\n", batchP50 > 0 ? singleP50 / batchP50 : 0.0);
+            fprintf(out, "        \"mismatches\": %d\n", mismatches);
+            fprintf(out, "      },\n");
+        }
+    }
+
+    // Sweeps are an order of magnitude dearer per query, so fewer of them
+    std::vector<double> singleTimes;
+    std::vector<double> batchTimes;
+    int sweepMismatches = 0;
+
+    scheduler->setNumThreads(scheduler->getMaxNumThreads());
+
+    for (int r = 0; r < runs; ++r)
+    {
+        singleTimes.push_back(timeSingleSweeps(world, &probe, sweepFrom, sweepTo, sweepCount, expected));
+
+        auto start = std::chrono::steady_clock::now();
+        world.convexSweepTestBatch(&probe, &sweepFrom[0], &sweepTo[0], nullptr, nullptr, sweepCount, batched);
+        batchTimes.push_back(elapsedMs(start));
+
+        sweepMismatches = std::max(sweepMismatches, countMismatches(expected, batched, sweepCount));
+    }
+
+    if (sweepMismatches > 0) ++failures;
+
+    double singleP50 = percentile(singleTimes, 50);
+    double batchP50 = percentile(batchTimes, 50);
+
+    fprintf(out, "      {\n");
+    fprintf(out, "        \"sweeps\": %d,\n", sweepCount);
+    fprintf(out, "        \"threads\": %d,\n", scheduler->getNumThreads());
+    fprintf(out, "        \"single_p50_ms\": %.3f,\n", singleP50);
+    fprintf(out, "        \"batch_p50_ms\": %.3f,\n", batchP50);
+    fprintf(out, "        \"speedup\": %.2f,\n", batchP50 > 0 ? singleP50 / batchP50 : 0.0);
+    fprintf(out, "        \"mismatches\": %d\n", sweepMismatches);
+    fprintf(out, "      }\n");
+
+    fprintf(out, "    ],\n");
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    for (int i = 0; i < objects.size(); ++i)
+    {
+        world.removeCollisionObject(objects[i]);
+        delete objects[i];
+    }
+
+    return failures;
+}
+
+// MARK: - Packets
+
+// Leaves reached by each ray, as (ray, leaf) pairs
+typedef std::set<std::pair<int, long long>> LeafHits;
+
+struct DbvtRayLeaves : public btDbvt::ICollide
+{
+    LeafHits* hits;
+    int ray;
+
+    void Process(const btDbvtNode* leaf) override
+    {
+        hits->insert(std::make_pair(ray, (long long) (size_t) leaf->data));
+    }
+};
+
+struct DbvtPacketLeaves : public btDbvt::ICollide
+{
+    LeafHits* hits;
+    int firstRay;
+
+    void ProcessRays(const btDbvtNode* leaf, unsigned int rayMask) override
+    {
+        for (int i = 0; i < BT_RAY_PACKET_SIZE; ++i)
+        {
+            if (rayMask & (1u << i)) hits->insert(std::make_pair(firstRay + i, (long long) (size_t) leaf->data));
+        }
+    }
+};
+
+struct BvhRayLeaves : public btNodeOverlapCallback
+{
+    LeafHits* hits;
+    int ray;
+
+    void processNode(int subPart, int triangleIndex) override
+    {
+        hits->insert(std::make_pair(ray, ((long long) subPart << 32) | triangleIndex));
+    }
+};
+
+struct BvhPacketLeaves : public btNodeOverlapPacketCallback
+{
+    LeafHits* hits;
+    int firstRay;
+
+    void processNode(int subPart, int triangleIndex, unsigned int rayMask) override
+    {
+        for (int i = 0; i < BT_RAY_PACKET_SIZE; ++i)
+        {
+            if (rayMask & (1u << i)) hits->insert(std::make_pair(firstRay + i, ((long long) subPart << 32) | triangleIndex));
+        }
+    }
+};
+
+// Counting callbacks for timing, so the set inserts don't dominate
+struct DbvtCount : public btDbvt::ICollide
+{
+    int count = 0;
+
+    void Process(const btDbvtNode*) override { ++count; }
+    void ProcessRays(const btDbvtNode*, unsigned int rayMask) override { count += __builtin_popcount(rayMask); }
+};
+
+struct BvhCount : public btNodeOverlapCallback, public btNodeOverlapPacketCallback
+{
+    int count = 0;
+
+    void processNode(int, int) override { ++count; }
+    void processNode(int, int, unsigned int rayMask) override { count += __builtin_popcount(rayMask); }
+};
+
+// Shotgun-like packets: BT_RAY_PACKET_SIZE rays from one muzzle, spread by `spread` radians around one aim.
+// A wide spread gives incoherent packets that diverge right under the root.
+static void makePackets(unsigned int& state, int numPackets, btScalar spread, btScalar length, btScalar extent,
+                        btAlignedObjectArray<btVector3>& from, btAlignedObjectArray<btVector3>& to)
+{
+    from.resize(0);
+    to.resize(0);
+
+    for (int p = 0; p < numPackets; ++p)
+    {
+        btVector3 muzzle(randomUnit(state) * extent, randomUnit(state) * extent, btScalar(2) + btFabs(randomUnit(state)) * 6);
+        btVector3 aim(randomUnit(state), randomUnit(state), randomUnit(state) * btScalar(0.5) - btScalar(0.4));
+        if (aim.length2() < btScalar(0.01)) aim.setValue(1, 0, -1);
+        aim.normalize();
+
+        for (int i = 0; i < BT_RAY_PACKET_SIZE; ++i)
+        {
+            btVector3 dir = aim + btVector3(randomUnit(state), randomUnit(state), randomUnit(state)) * spread;
+            from.push_back(muzzle);
+            to.push_back(muzzle + dir.normalized() * length);
+        }
+    }
+}
+
+static int countLeafMismatches(const LeafHits& expected, const LeafHits& actual)
+{
+    int mismatches = 0;
+
+    for (const auto& hit : expected) if (!actual.count(hit)) ++mismatches;
+    for (const auto& hit : actual) if (!expected.count(hit)) ++mismatches;
+
+    return mismatches;
+}
+
+static int runPackets(const Options& options, FILE* out)
+{
+    const int numPackets = std::max(options.iterations, 1) * 20;
+    const btScalar spreads[] = { btScalar(0.02), btScalar(0.1), btScalar(1.0) };
+    const int runs = 5;
+
+    unsigned int state = options.seed;
+    int failures = 0;
+
+    // Dbvt of brush-sized boxes, like the broadphase of a map
+    btDbvt dbvt;
+    for (int i = 0; i < 8000; ++i)
+    {
+        btVector3 center(randomUnit(state) * 60, randomUnit(state) * 60, btFabs(randomUnit(state)) * 10);
+        btVector3 half(btScalar(0.5) + btFabs(randomUnit(state)) * 2, btScalar(0.5) + btFabs(randomUnit(state)) * 2, btScalar(0.5) + btFabs(randomUnit(state)));
+        dbvt.insert(btDbvtVolume::FromCE(center, half), (void*) (size_t) (i + 1));
+    }
+    dbvt.optimizeTopDown();
+
+    // Quantized bvh of a bumpy terrain, like btBvhTriangleMeshShape builds it
+    const int grid = 128;
+    btTriangleMesh mesh;
+    for (int y = 0; y < grid; ++y)
+    {
+        for (int x = 0; x < grid; ++x)
+        {
+            auto vertex = [&](int vx, int vy)
+            {
+                return btVector3(btScalar(vx - grid / 2), btScalar(vy - grid / 2), btSin(vx * btScalar(0.3)) * btCos(vy * btScalar(0.2)) * 2);
+            };
+            mesh.addTriangle(vertex(x, y), vertex(x + 1, y), vertex(x + 1, y + 1));
+            mesh.addTriangle(vertex(x, y), vertex(x + 1, y + 1), vertex(x, y + 1));
+        }
+    }
+
+    btVector3 meshMin(-grid / 2 - 1, -grid / 2 - 1, -3);
+    btVector3 meshMax(grid / 2 + 1, grid / 2 + 1, 3);
+    btOptimizedBvh* bvh = new (btAlignedAlloc(sizeof(btOptimizedBvh), 16)) btOptimizedBvh();
+    bvh->build(&mesh, true, meshMin, meshMax);
+
+    fprintf(out, "  \"packets\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"packet_size\": %d,\n", BT_RAY_PACKET_SIZE);
+#if defined(BT_RAY_PACKET_SSE)
+    fprintf(out, "    \"simd\": \"sse\",\n");
+#elif defined(BT_RAY_PACKET_NEON)
+    fprintf(out, "    \"simd\": \"neon\",\n");
+#else
+    fprintf(out, "    \"simd\": \"none\",\n");
+#endif
+    fprintf(out, "    \"packets\": %d,\n", numPackets);
+    fprintf(out, "    \"runs\": [\n");
+
+    btAlignedObjectArray<btVector3> from;
+    btAlignedObjectArray<btVector3> to;
+
+    for (int t = 0; t < 2; ++t)
+    {
+        for (int s = 0; s < 3; ++s)
+        {
+            makePackets(state, numPackets, spreads[s], btScalar(t == 0 ? 40 : 60), btScalar(t == 0 ? 50 : 60), from, to);
+            int numRays = from.size();
+
+            // Same leaves, ray for ray
+            LeafHits single;
+            LeafHits packed;
+
+            if (t == 0)
+            {
+                DbvtRayLeaves rayLeaves;
+                rayLeaves.hits = &single;
+                DbvtPacketLeaves packetLeaves;
+                packetLeaves.hits = &packed;
+
+                for (int i = 0; i < numRays; ++i)
+                {
+                    rayLeaves.ray = i;
+                    btDbvt::rayTest(dbvt.m_root, from[i], to[i], rayLeaves);
+                }
+
+                for (int i = 0; i < numRays; i += BT_RAY_PACKET_SIZE)
+                {
+                    packetLeaves.firstRay = i;
+                    btDbvt::rayTestPacket(dbvt.m_root, &from[i], &to[i], BT_RAY_PACKET_SIZE, packetLeaves);
+                }
+            }
+            else
+            {
+                BvhRayLeaves rayLeaves;
+                rayLeaves.hits = &single;
+                BvhPacketLeaves packetLeaves;
+                packetLeaves.hits = &packed;
+
+                for (int i = 0; i < numRays; ++i)
+                {
+                    rayLeaves.ray = i;
+                    bvh->reportRayOverlappingNodex(&rayLeaves, from[i], to[i]);
+                }
+
+                for (int i = 0; i < numRays; i += BT_RAY_PACKET_SIZE)
+                {
+                    packetLeaves.firstRay = i;
+                    bvh->reportRayPacketOverlappingNodex(&packetLeaves, &from[i], &to[i], BT_RAY_PACKET_SIZE);
+                }
+            }
+
+            int mismatches = countLeafMismatches(single, packed);
+            if (mismatches > 0) ++failures;
+
+            std::vector<double> singleTimes;
+            std::vector<double> packetTimes;
+            int checksum = 0;
+
+            for (int r = 0; r < runs; ++r)
+            {
+                DbvtCount dbvtSingle, dbvtPacket;
+                BvhCount bvhSingle, bvhPacket;
+
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < numRays; ++i)
+                {
+                    if (t == 0) btDbvt::rayTest(dbvt.m_root, from[i], to[i], dbvtSingle);
+                    else bvh->reportRayOverlappingNodex(static_cast<btNodeOverlapCallback*>(&bvhSingle), from[i], to[i]);
+                }
+                singleTimes.push_back(elapsedMs(start));
+
+                start = std::chrono::steady_clock::now();
+                for (int i = 0; i < numRays; i += BT_RAY_PACKET_SIZE)
+                {
+                    if (t == 0) btDbvt::rayTestPacket(dbvt.m_root, &from[i], &to[i], BT_RAY_PACKET_SIZE, dbvtPacket);
+                    else bvh->reportRayPacketOverlappingNodex(&bvhPacket, &from[i], &to[i], BT_RAY_PACKET_SIZE);
+                }
+                packetTimes.push_back(elapsedMs(start));
+
+                checksum = t == 0 ? dbvtSingle.count - dbvtPacket.count : bvhSingle.count - bvhPacket.count;
+            }
+
+            if (checksum != 0) ++failures;
+
+            double singleP50 = percentile(singleTimes, 50);
+            double packetP50 = percentile(packetTimes, 50);
+
+            fprintf(out, "      {\n");
+            fprintf(out, "        \"tree\": \"%s\",\n", t == 0 ? "dbvt" : "quantized_bvh");
+            fprintf(out, "        \"spread\": %.2f,\n", double(spreads[s]));
+            fprintf(out, "        \"rays\": %d,\n", numRays);
+            fprintf(out, "        \"leaf_hits\": %d,\n", int(single.size()));
+            fprintf(out, "        \"single_ns_per_ray\": %.1f,\n", singleP50 * 1e6 / numRays);
+            fprintf(out, "        \"packet_ns_per_ray\": %.1f,\n", packetP50 * 1e6 / numRays);
+            fprintf(out, "        \"speedup\": %.2f,\n", packetP50 > 0 ? singleP50 / packetP50 : 0.0);
+            fprintf(out, "        \"mismatches\": %d\n", mismatches);
+            fprintf(out, "      }%s\n", t == 1 && s == 2 ? "" : ",");
+        }
+    }
+
+    fprintf(out, "    ],\n");
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    bvh->~btOptimizedBvh();
+    btAlignedFree(bvh);
+
+    return failures;
+}
+
+// MARK: - Bulk
+
+// SAH cost of a tree: surface area of every internal node, relative to the root
+static double treeCost(const btDbvtNode* node, double rootArea)
+{
+    if (node == nullptr || node->isleaf()) return 0;
+
+    btVector3 edges = node->volume.Lengths();
+    double area = edges.x() * edges.y() + edges.y() * edges.z() + edges.z() * edges.x();
+
+    return area / rootArea + treeCost(node->childs[0], rootArea) + treeCost(node->childs[1], rootArea);
+}
+
+struct StaticWorld
+{
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher;
+    btDbvtBroadphase broadphase;
+    btCollisionWorld world;
+
+    StaticWorld() : dispatcher(&configuration), world(&dispatcher, &broadphase, &configuration) {}
+};
+
+static int runBulk(const Options& options, FILE* out)
+{
+    const int brushCounts[] = { 1000, 5000, 20000 };
+    const int queries = 10000;
+
+    int failures = 0;
+
+    fprintf(out, "  \"bulk\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"runs\": [\n");
+
+    for (int c = 0; c < 3; ++c)
+    {
+        unsigned int state = options.seed;
+        int count = brushCounts[c];
+        btScalar extent = btSqrt(btScalar(count)) * 4;
+
+        // Brushes come out of the map file roughly in the order they were built in the editor, so keep them spatially sorted
+        btBoxShape brush(btVector3(2, 2, 2));
+        std::vector<btCollisionObject> incrementalObjects(count);
+        std::vector<btCollisionObject> bulkObjects(count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            btVector3 origin(-extent + 2 * extent * i / count, randomUnit(state) * extent, btFabs(randomUnit(state)) * 20);
+
+            for (auto* objects : { &incrementalObjects, &bulkObjects })
+            {
+                (*objects)[i].setCollisionShape(&brush);
+                (*objects)[i].getWorldTransform().setOrigin(origin);
+                (*objects)[i].setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT);
+            }
+        }
+
+        // A few dynamic bodies already in the world, so both paths have pairs to find
+        btSphereShape ball(1);
+        std::vector<btCollisionObject> incrementalBalls(64);
+        std::vector<btCollisionObject> bulkBalls(64);
+
+        for (int i = 0; i < 64; ++i)
+        {
+            btVector3 origin(randomUnit(state) * extent, randomUnit(state) * extent, btFabs(randomUnit(state)) * 20);
+
+            for (auto* balls : { &incrementalBalls, &bulkBalls })
+            {
+                (*balls)[i].setCollisionShape(&ball);
+                (*balls)[i].getWorldTransform().setOrigin(origin);
+            }
+        }
+
+        StaticWorld incremental;
+        StaticWorld bulk;
+
+        for (int i = 0; i < 64; ++i)
+        {
+            incremental.world.addCollisionObject(&incrementalBalls[i]);
+            bulk.world.addCollisionObject(&bulkBalls[i]);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i)
+        {
+            incremental.world.addCollisionObject(&incrementalObjects[i], btBroadphaseProxy::StaticFilter, btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter);
+        }
+        // proxies move into the fixed set over the first collides, which is part of loading too
+        for (int stage = 0; stage <= btDbvtBroadphase::STAGECOUNT; ++stage)
+        {
+            incremental.broadphase.calculateOverlappingPairs(&incremental.dispatcher);
+        }
+        double incrementalMs = elapsedMs(start);
+
+        std::vector<btCollisionObject*> pointers(count);
+        for (int i = 0; i < count; ++i) pointers[i] = &bulkObjects[i];
+
+        start = std::chrono::steady_clock::now();
+        bulk.world.addStaticCollisionObjects(pointers.data(), count);
+        for (int stage = 0; stage <= btDbvtBroadphase::STAGECOUNT; ++stage)
+        {
+            bulk.broadphase.calculateOverlappingPairs(&bulk.dispatcher);
+        }
+        double bulkMs = elapsedMs(start);
+
+        int incrementalPairs = incremental.broadphase.getOverlappingPairCache()->getNumOverlappingPairs();
+        int bulkPairs = bulk.broadphase.getOverlappingPairCache()->getNumOverlappingPairs();
+
+        if (incrementalPairs != bulkPairs) ++failures;
+
+        // Box queries the size of a player against the static tree only
+        double queryMs[2];
+        int found[2] = { 0, 0 };
+
+        struct CountCallback : public btBroadphaseAabbCallback
+        {
+            int* found;
+            bool process(const btBroadphaseProxy*) override { ++*found; return true; }
+        };
+
+        for (int w = 0; w < 2; ++w)
+        {
+            btDbvtBroadphase& broadphase = w == 0 ? incremental.broadphase : bulk.broadphase;
+            unsigned int queryState = options.seed + 1;
+
+            CountCallback callback;
+            callback.found = &found[w];
+
+            start = std::chrono::steady_clock::now();
+            for (int q = 0; q < queries; ++q)
+            {
+                btVector3 center(randomUnit(queryState) * extent, randomUnit(queryState) * extent, btFabs(randomUnit(queryState)) * 20);
+                broadphase.aabbTest(center - btVector3(1, 1, 2), center + btVector3(1, 1, 2), callback);
+            }
+            queryMs[w] = elapsedMs(start);
+        }
+
+        if (found[0] != found[1]) ++failures;
+
+        const btDbvt& incrementalTree = incremental.broadphase.m_sets[1];
+        const btDbvt& bulkTree = bulk.broadphase.m_sets[1];
+        btVector3 rootEdges = bulkTree.m_root->volume.Lengths();
+        double rootArea = rootEdges.x() * rootEdges.y() + rootEdges.y() * rootEdges.z() + rootEdges.z() * rootEdges.x();
+
+        fprintf(out, "      {\n");
+        fprintf(out, "        \"brushes\": %d,\n", count);
+        fprintf(out, "        \"incremental_ms\": %.3f,\n", incrementalMs);
+        fprintf(out, "        \"bulk_ms\": %.3f,\n", bulkMs);
+        fprintf(out, "        \"load_speedup\": %.2f,\n", bulkMs > 0 ? incrementalMs / bulkMs : 0.0);
+        fprintf(out, "        \"incremental_depth\": %d,\n", btDbvt::maxdepth(incrementalTree.m_root));
+        fprintf(out, "        \"bulk_depth\": %d,\n", btDbvt::maxdepth(bulkTree.m_root));
+        fprintf(out, "        \"incremental_sah_cost\": %.1f,\n", treeCost(incrementalTree.m_root, rootArea));
+        fprintf(out, "        \"bulk_sah_cost\": %.1f,\n", treeCost(bulkTree.m_root, rootArea));
+        fprintf(out, "        \"incremental_query_us\": %.3f,\n", queryMs[0] * 1e3 / queries);
+        fprintf(out, "        \"bulk_query_us\": %.3f,\n", queryMs[1] * 1e3 / queries);
+        fprintf(out, "        \"pairs\": [%d, %d],\n", incrementalPairs, bulkPairs);
+        fprintf(out, "        \"query_hits\": [%d, %d]\n", found[0], found[1]);
+        fprintf(out, "      }%s\n", c < 2 ? "," : "");
+
+        for (int i = 0; i < count; ++i)
+        {
+            incremental.world.removeCollisionObject(&incrementalObjects[i]);
+            bulk.world.removeCollisionObject(&bulkObjects[i]);
+        }
+
+        for (int i = 0; i < 64; ++i)
+        {
+            incremental.world.removeCollisionObject(&incrementalBalls[i]);
+            bulk.world.removeCollisionObject(&bulkBalls[i]);
+        }
+    }
+
+    fprintf(out, "    ],\n");
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Events
+
+typedef std::pair<const btCollisionObject*, const btCollisionObject*> ObjectPair;
+
+static ObjectPair orderedPair(const btCollisionObject* a, const btCollisionObject* b)
+{
+    return a < b ? ObjectPair(a, b) : ObjectPair(b, a);
+}
+
+struct EventTick
+{
+    btContactEventQueue* queue;
+    std::vector<double> samples;
+};
+
+static void eventsTickCallback(btDynamicsWorld* world, btScalar)
+{
+    EventTick* tick = static_cast<EventTick*>(world->getWorldUserInfo());
+
+    auto start = std::chrono::steady_clock::now();
+    tick->queue->processManifolds(world->getDispatcher());
+    tick->samples.push_back(elapsedMs(start));
+}
+
+// Touching pairs straight from the manifolds, what the events have to add up to
+static std::set<ObjectPair> touchingPairs(btDispatcher* dispatcher, btScalar threshold)
+{
+    std::set<ObjectPair> pairs;
+
+    for (int i = 0; i < dispatcher->getNumManifolds(); ++i)
+    {
+        const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+
+        for (int p = 0; p < manifold->getNumContacts(); ++p)
+        {
+            if (manifold->getContactPoint(p).getDistance() <= threshold)
+            {
+                pairs.insert(orderedPair(manifold->getBody0(), manifold->getBody1()));
+                break;
+            }
+        }
+    }
+
+    return pairs;
+}
+
+struct CountContacts : public btCollisionWorld::ContactResultCallback
+{
+    int count = 0;
+
+    btScalar addSingleResult(btManifoldPoint&, const btCollisionObjectWrapper*, int, int, const btCollisionObjectWrapper*, int, int) override
+    {
+        ++count;
+        return 0;
+    }
+};
+
+static int runEvents(const Options& options, FILE* out)
+{
+    const int numBalls = 400;
+    const int ticks = std::max(options.iterations, 2);
+
+    unsigned int state = options.seed;
+
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher(&configuration);
+    btDbvtBroadphase broadphase;
+    btSequentialImpulseConstraintSolver solver;
+    btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &configuration);
+
+    btBoxShape groundShape(btVector3(50, 1, 50));
+    btRigidBody ground(0, nullptr, &groundShape);
+    ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+    world.addRigidBody(&ground);
+
+    // Balls rain down on the ground and on each other, so pairs begin, persist and end
+    btSphereShape ballShape(0.5);
+    btVector3 inertia;
+    ballShape.calculateLocalInertia(1, inertia);
+
+    std::vector<btRigidBody*> balls;
+    for (int i = 0; i < numBalls; ++i)
+    {
+        btRigidBody::btRigidBodyConstructionInfo info(1, nullptr, &ballShape, inertia);
+        info.m_restitution = 0.5;
+        info.m_startWorldTransform.setOrigin(btVector3(randomUnit(state) * 10, 1 + btFabs(randomUnit(state)) * 20, randomUnit(state) * 10));
+
+        btRigidBody* ball = new btRigidBody(info);
+        balls.push_back(ball);
+        world.addRigidBody(ball);
+    }
+
+    btContactEventQueue queue(8192);
+    EventTick tick;
+    tick.queue = &queue;
+    world.setInternalTickCallback(eventsTickCallback, &tick);
+
+    std::vector<btContactEvent> drained(queue.capacity());
+    std::set<ObjectPair> tracked;
+
+    int failures = 0;
+    long long counts[3] = { 0, 0, 0 };
+    double contactTestMs = 0;
+    int contactTestContacts = 0;
+    int peakPairs = 0;
+
+    for (int t = 0; t < ticks; ++t)
+    {
+        // Half way through, take some balls out while they touch things
+        if (t == ticks / 2)
+        {
+            for (int i = 0; i < numBalls; i += 10)
+            {
+                queue.removeCollisionObject(balls[i]);
+                world.removeRigidBody(balls[i]);
+            }
+        }
+
+        world.stepSimulation(btScalar(1) / 60, 1, btScalar(1) / 60);
+
+        int numEvents = queue.drain(drained.data(), int(drained.size()));
+        failures += queue.takeNumDropped();
+
+        for (int e = 0; e < numEvents; ++e)
+        {
+            const btContactEvent& event = drained[e];
+            ObjectPair pair = orderedPair(event.m_objectA, event.m_objectB);
+            bool known = tracked.count(pair) != 0;
+
+            ++counts[event.m_type];
+
+            switch (event.m_type)
+            {
+                case btContactEvent::BEGIN: if (known) ++failures; tracked.insert(pair); break;
+                case btContactEvent::PERSIST: if (!known) ++failures; break;
+                case btContactEvent::END: if (!known) ++failures; tracked.erase(pair); break;
+            }
+
+            if (event.m_objectA->getBroadphaseHandle() && event.m_objectB->getBroadphaseHandle() &&
+                event.m_objectA->getBroadphaseHandle()->m_uniqueId > event.m_objectB->getBroadphaseHandle()->m_uniqueId) ++failures;
+        }
+
+        if (tracked != touchingPairs(&dispatcher, queue.getContactThreshold())) ++failures;
+        peakPairs = std::max(peakPairs, int(tracked.size()));
+
+        // What gameplay did before: a contact query per body, every tick
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numBalls; ++i)
+        {
+            if (balls[i]->getBroadphaseHandle() == nullptr) continue;
+
+            CountContacts callback;
+            world.contactTest(balls[i], callback);
+            contactTestContacts += callback.count;
+        }
+        contactTestMs += elapsedMs(start);
+    }
+
+    double eventsMs = 0;
+    for (double sample : tick.samples) eventsMs += sample;
+
+    fprintf(out, "  \"events\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"bodies\": %d,\n", numBalls + 1);
+    fprintf(out, "    \"ticks\": %d,\n", ticks);
+    fprintf(out, "    \"peak_touching_pairs\": %d,\n", peakPairs);
+    fprintf(out, "    \"begin\": %lld,\n", counts[btContactEvent::BEGIN]);
+    fprintf(out, "    \"persist\": %lld,\n", counts[btContactEvent::PERSIST]);
+    fprintf(out, "    \"end\": %lld,\n", counts[btContactEvent::END]);
+    fprintf(out, "    \"events_us_per_tick\": %.2f,\n", eventsMs * 1e3 / ticks);
+    fprintf(out, "    \"events_p99_us\": %.2f,\n", percentile(tick.samples, 99) * 1e3);
+    fprintf(out, "    \"contact_test_us_per_tick\": %.2f,\n", contactTestMs * 1e3 / ticks);
+    fprintf(out, "    \"contact_test_contacts\": %d,\n", contactTestContacts);
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    for (btRigidBody* ball : balls)
+    {
+        if (ball->getBroadphaseHandle()) world.removeRigidBody(ball);
+        delete ball;
+    }
+    world.removeRigidBody(&ground);
+
+    return failures;
+}
+
+// MARK: - Triggers
+
+struct TriggerTick
+{
+    btTriggerManager* triggers;
+    std::vector<double> samples;
+};
+
+static void triggersTickCallback(btDynamicsWorld* world, btScalar)
+{
+    TriggerTick* tick = static_cast<TriggerTick*>(world->getWorldUserInfo());
+
+    auto start = std::chrono::steady_clock::now();
+    tick->triggers->processTriggers();
+    tick->samples.push_back(elapsedMs(start));
+}
+
+static int runTriggers(const Options& options, FILE* out)
+{
+    const int numTriggers = 100;
+    const int numBalls = 400;
+    const int ticks = std::max(options.iterations, 2);
+
+    unsigned int state = options.seed;
+
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher(&configuration);
+    btDbvtBroadphase broadphase;
+    btSequentialImpulseConstraintSolver solver;
+    btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &configuration);
+
+    // Same wiring as BulletWorld: the manager sees the pairs first, then the ghost objects
+    btGhostPairCallback ghostPairCallback;
+    btTriggerManager triggers(broadphase.getOverlappingPairCache(), &ghostPairCallback);
+    broadphase.getOverlappingPairCache()->setInternalGhostPairCallback(&triggers);
+
+    TriggerTick tick;
+    tick.triggers = &triggers;
+    world.setInternalTickCallback(triggersTickCallback, &tick);
+
+    btBoxShape groundShape(btVector3(60, 1, 60));
+    btRigidBody ground(0, nullptr, &groundShape);
+    ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+    world.addRigidBody(&ground);
+
+    // Doors, pickups and hurt zones: boxes on the floor, every other one exact
+    btBoxShape triggerShape(btVector3(2, 2, 2));
+    std::vector<btPairCachingGhostObject*> ghosts;
+
+    int group = btBroadphaseProxy::SensorTrigger;
+    int mask = btBroadphaseProxy::AllFilter & ~btBroadphaseProxy::StaticFilter & ~btBroadphaseProxy::SensorTrigger;
+
+    for (int i = 0; i < numTriggers; ++i)
+    {
+        btPairCachingGhostObject* ghost = new btPairCachingGhostObject();
+        ghost->setCollisionShape(&triggerShape);
+        ghost->setCollisionFlags(btCollisionObject::CF_NO_CONTACT_RESPONSE);
+        ghost->getWorldTransform().setOrigin(btVector3(randomUnit(state) * 40, 2, randomUnit(state) * 40));
+
+        triggers.addTrigger(ghost, (i & 1) != 0);
+        world.addCollisionObject(ghost, group, mask);
+        ghosts.push_back(ghost);
+    }
+
+    // Balls fall and roll through them, then come to rest and fall asleep, some inside
+    btSphereShape ballShape(0.5);
+    btVector3 inertia;
+    ballShape.calculateLocalInertia(1, inertia);
+
+    std::vector<btRigidBody*> balls;
+    for (int i = 0; i < numBalls; ++i)
+    {
+        btRigidBody::btRigidBodyConstructionInfo info(1, nullptr, &ballShape, inertia);
+        info.m_startWorldTransform.setOrigin(btVector3(randomUnit(state) * 40, 1 + btFabs(randomUnit(state)) * 10, randomUnit(state) * 40));
+        info.m_friction = 0.2;
+        info.m_linearDamping = 0.6;
+        info.m_angularDamping = 0.6;
+
+        btRigidBody* ball = new btRigidBody(info);
+        ball->setLinearVelocity(btVector3(randomUnit(state) * 8, 0, randomUnit(state) * 8));
+        balls.push_back(ball);
+        world.addRigidBody(ball);
+    }
+
+    std::set<ObjectPair> inside;
+    std::vector<std::vector<const btCollisionObject*>> polled(numTriggers);
+    std::vector<const btCollisionObject*> current;
+
+    int failures = 0;
+    long long counts[2] = { 0, 0 };
+    long long polledEvents = 0;
+    double pollMs = 0;
+    int peakInside = 0;
+
+    for (int t = 0; t < ticks; ++t)
+    {
+        // Half way through, take some balls out and move a trigger, as gameplay does
+        if (t == ticks / 2)
+        {
+            for (int i = 0; i < numBalls; i += 10)
+            {
+                world.removeRigidBody(balls[i]);
+            }
+            ghosts[0]->getWorldTransform().setOrigin(btVector3(0, 2, 0));
+        }
+
+        world.stepSimulation(btScalar(1) / 60, 1, btScalar(1) / 60);
+
+        const btAlignedObjectArray<btTriggerEvent>& events = triggers.getEvents();
+        for (int e = 0; e < events.size(); ++e)
+        {
+            ObjectPair pair(events[e].m_trigger, events[e].m_other);
+            bool known = inside.count(pair) != 0;
+
+            ++counts[events[e].m_type];
+
+            if (events[e].m_type == btTriggerEvent::ENTER)
+            {
+                if (known) ++failures;
+                inside.insert(pair);
+            }
+            else
+            {
+                if (!known) ++failures;
+                inside.erase(pair);
+            }
+        }
+        triggers.clearEvents();
+
+        // Brute force: boxes for broadphase triggers, touching manifolds for exact ones
+        std::set<ObjectPair> expected;
+        for (int i = 0; i < numTriggers; ++i)
+        {
+            if (i & 1) continue;
+
+            const btBroadphaseProxy* a = ghosts[i]->getBroadphaseHandle();
+            for (btRigidBody* ball : balls)
+            {
+                const btBroadphaseProxy* b = ball->getBroadphaseHandle();
+                if (b && TestAabbAgainstAabb2(a->m_aabbMin, a->m_aabbMax, b->m_aabbMin, b->m_aabbMax))
+                {
+                    expected.insert(ObjectPair(ghosts[i], ball));
+                }
+            }
+        }
+        for (int m = 0; m < dispatcher.getNumManifolds(); ++m)
+        {
+            const btPersistentManifold* manifold = dispatcher.getManifoldByIndexInternal(m);
+            const btCollisionObject* trigger = triggers.isTrigger(manifold->getBody0()) ? manifold->getBody0() : manifold->getBody1();
+            const btCollisionObject* other = trigger == manifold->getBody0() ? manifold->getBody1() : manifold->getBody0();
+
+            int index = int(std::find(ghosts.begin(), ghosts.end(), trigger) - ghosts.begin());
+            if (index == numTriggers || (index & 1) == 0) continue;
+
+            for (int p = 0; p < manifold->getNumContacts(); ++p)
+            {
+                if (manifold->getContactPoint(p).getDistance() <= 0)
+                {
+                    expected.insert(ObjectPair(trigger, other));
+                    break;
+                }
+            }
+        }
+
+        if (inside != expected) ++failures;
+        peakInside = std::max(peakInside, int(inside.size()));
+
+        // What gameplay did before: walk every ghost's pair array and diff it against the last tick
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numTriggers; ++i)
+        {
+            current.clear();
+            for (int o = 0; o < ghosts[i]->getNumOverlappingObjects(); ++o)
+            {
+                current.push_back(ghosts[i]->getOverlappingObject(o));
+            }
+            std::sort(current.begin(), current.end());
+
+            std::vector<const btCollisionObject*>& last = polled[i];
+            size_t a = 0, b = 0;
+            while (a < last.size() || b < current.size())
+            {
+                if (b == current.size() || (a < last.size() && last[a] < current[b])) { ++polledEvents; ++a; }
+                else if (a == last.size() || current[b] < last[a]) { ++polledEvents; ++b; }
+                else { ++a; ++b; }
+            }
+            last.swap(current);
+        }
+        pollMs += elapsedMs(start);
+    }
+
+    for (int i = 0; i < numTriggers; ++i)
+    {
+        int count = 0;
+        for (const ObjectPair& pair : inside) count += pair.first == ghosts[i];
+        if (count != triggers.getNumInside(ghosts[i])) ++failures;
+    }
+
+    double triggersMs = 0;
+    for (double sample : tick.samples) triggersMs += sample;
+
+    int sleeping = 0;
+    for (btRigidBody* ball : balls) sleeping += ball->getBroadphaseHandle() && !ball->isActive();
+
+    fprintf(out, "  \"triggers\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"triggers\": %d,\n", numTriggers);
+    fprintf(out, "    \"bodies\": %d,\n", numBalls);
+    fprintf(out, "    \"ticks\": %d,\n", ticks);
+    fprintf(out, "    \"peak_inside\": %d,\n", peakInside);
+    fprintf(out, "    \"overlaps\": %d,\n", triggers.getNumOverlaps());
+    fprintf(out, "    \"sleeping_bodies\": %d,\n", sleeping);
+    fprintf(out, "    \"enter\": %lld,\n", counts[btTriggerEvent::ENTER]);
+    fprintf(out, "    \"exit\": %lld,\n", counts[btTriggerEvent::EXIT]);
+    fprintf(out, "    \"process_us_per_tick\": %.2f,\n", triggersMs * 1e3 / ticks);
+    fprintf(out, "    \"process_last_tick_us\": %.2f,\n", tick.samples.back() * 1e3);
+    fprintf(out, "    \"poll_us_per_tick\": %.2f,\n", pollMs * 1e3 / ticks);
+    fprintf(out, "    \"polled_pair_changes\": %lld,\n", polledEvents);
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    for (btRigidBody* ball : balls)
+    {
+        if (ball->getBroadphaseHandle()) world.removeRigidBody(ball);
+        delete ball;
+    }
+    for (btPairCachingGhostObject* ghost : ghosts)
+    {
+        world.removeCollisionObject(ghost);
+        triggers.removeTrigger(ghost);
+        delete ghost;
+    }
+    world.removeRigidBody(&ground);
+
+    return failures;
+}
+
+// MARK: - Async
+
+// Boxes dropped on a floor, built the same way for the plain and the pipelined run
+struct AsyncScene
+{
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher;
+    btDbvtBroadphase broadphase;
+    btSequentialImpulseConstraintSolver solver;
+    btDiscreteDynamicsWorld world;
+    btBoxShape groundShape;
+    btBoxShape boxShape;
+    btRigidBody ground;
+    std::vector<btRigidBody*> boxes;
+
+    AsyncScene(unsigned int seed, int numBoxes)
+    : dispatcher(&configuration),
+      world(&dispatcher, &broadphase, &solver, &configuration),
+      groundShape(btVector3(50, 1, 50)),
+      boxShape(btVector3(0.5, 0.5, 0.5)),
+      ground(0, nullptr, &groundShape)
+    {
+        ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+        world.addRigidBody(&ground);
+
+        btVector3 inertia;
+        boxShape.calculateLocalInertia(1, inertia);
+
+        for (int i = 0; i < numBoxes; ++i)
+        {
+            btTransform start = btTransform::getIdentity();
+            start.setOrigin(btVector3(randomUnit(seed) * 20, 1 + btFabs(randomUnit(seed)) * 20, randomUnit(seed) * 20));
+
+            // motion states, so the frames carry the interpolated transforms the renderer would use
+            btRigidBody::btRigidBodyConstructionInfo info(1, new btDefaultMotionState(start), &boxShape, inertia);
+            btRigidBody* box = new btRigidBody(info);
+            boxes.push_back(box);
+            world.addRigidBody(box);
+        }
+    }
+
+    ~AsyncScene()
+    {
+        for (btRigidBody* box : boxes)
+        {
+            world.removeRigidBody(box);
+            delete box->getMotionState();
+            delete box;
+        }
+        world.removeRigidBody(&ground);
+    }
+};
+
+static void simulateRenderWork(double ms)
+{
+    auto start = std::chrono::steady_clock::now();
+    while (elapsedMs(start) < ms) {}
+}
+
+static btAsyncStepper::BodyTransform bodyTransform(const btTransform& transform)
+{
+    btAsyncStepper::BodyTransform out;
+    const btQuaternion rotation = transform.getRotation();
+
+    for (int i = 0; i < 3; ++i) out.m_position[i] = transform.getOrigin()[i];
+    out.m_position[3] = 0;
+    out.m_rotation[0] = rotation.x();
+    out.m_rotation[1] = rotation.y();
+    out.m_rotation[2] = rotation.z();
+    out.m_rotation[3] = rotation.w();
+    return out;
+}
+
+static int runAsync(const Options& options, FILE* out)
+{
+    const int numBoxes = 400;
+    const int frames = std::max(options.iterations, 2);
+    const double renderMs = 2;
+    const btScalar dt = btScalar(1) / 60;
+
+    int failures = 0;
+
+    // Plain loop: step, then render what it produced
+    std::vector<std::vector<btAsyncStepper::BodyTransform>> reference(frames);
+    double syncMs = 0;
+    {
+        AsyncScene scene(options.seed, numBoxes);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; ++f)
+        {
+            if (f % 20 == 10)
+            {
+                btRigidBody* box = scene.boxes[f % numBoxes];
+                box->applyCentralImpulse(btVector3(0, 8, 0));
+                box->activate(true);
+            }
+
+            scene.world.stepSimulation(dt, 1, dt);
+
+            for (btRigidBody* box : scene.boxes)
+            {
+                btTransform transform;
+                box->getMotionState()->getWorldTransform(transform);
+                reference[f].push_back(bodyTransform(transform));
+            }
+
+            simulateRenderWork(renderMs);
+        }
+        syncMs = elapsedMs(start);
+    }
+
+    // Pipelined loop: render the last finished step while the next one runs
+    double asyncMs = 0;
+    double waitMs = 0;
+    int mismatches = 0;
+    {
+        AsyncScene scene(options.seed, numBoxes);
+        btAsyncStepper stepper(&scene.world);
+
+        for (btRigidBody* box : scene.boxes)
+        {
+            stepper.addSlot(box);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int f = 0; f <= frames; ++f)
+        {
+            auto waitStart = std::chrono::steady_clock::now();
+            stepper.waitForStep();
+            waitMs += elapsedMs(waitStart);
+
+            const btAsyncStepper::Frame& frame = stepper.getFrame();
+
+            if (f > 0)
+            {
+                if (int(frame.m_stepIndex) != f || frame.m_transforms.size() != numBoxes)
+                {
+                    ++failures;
+                }
+                else if (memcmp(&frame.m_transforms[0], &reference[f - 1][0], sizeof(btAsyncStepper::BodyTransform) * numBoxes) != 0)
+                {
+                    ++mismatches;
+                }
+            }
+
+            if (f == frames) break;
+
+            simulateRenderWork(renderMs);
+
+            if (f % 20 == 10)
+            {
+                stepper.applyCentralImpulse(scene.boxes[f % numBoxes], btVector3(0, 8, 0));
+            }
+
+            stepper.beginStep(dt, 1, dt);
+        }
+        asyncMs = elapsedMs(start);
+    }
+
+    failures += mismatches;
+
+    fprintf(out, "  \"async\": {\n");
+    fprintf(out, "    \"boxes\": %d,\n", numBoxes);
+    fprintf(out, "    \"frames\": %d,\n", frames);
+    fprintf(out, "    \"cores\": %u,\n", std::thread::hardware_concurrency());
+    fprintf(out, "    \"render_ms_per_frame\": %.2f,\n", renderMs);
+    fprintf(out, "    \"sync_ms_per_frame\": %.3f,\n", syncMs / frames);
+    fprintf(out, "    \"async_ms_per_frame\": %.3f,\n", asyncMs / frames);
+    fprintf(out, "    \"async_wait_ms_per_frame\": %.3f,\n", waitMs / frames);
+    fprintf(out, "    \"transform_mismatches\": %d,\n", mismatches);
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Export
+
+static int runExport(const Options& options, FILE* out)
+{
+    const int numBoxes = 2000;
+    const int frames = std::max(options.iterations, 2);
+    const btScalar dt = btScalar(1) / 60;
+
+    int failures = 0;
+    double stepMs[2] = { 0, 0 };
+    double gatherMs = 0;
+    double copyMs = 0;
+    long long dirtyCount = 0;
+    int numAwake = 0;
+
+    // Run 0 reads every motion state after the step like the game does, run 1 exports and copies the dirty ones
+    for (int run = 0; run < 2; ++run)
+    {
+        unsigned int state = options.seed;
+
+        btDefaultCollisionConfiguration configuration;
+        btCollisionDispatcher dispatcher(&configuration);
+        btDbvtBroadphase broadphase;
+        btSequentialImpulseConstraintSolver solver;
+        btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &configuration);
+
+        btBoxShape groundShape(btVector3(200, 1, 200));
+        btRigidBody ground(0, nullptr, &groundShape);
+        ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+        world.addRigidBody(&ground);
+
+        // Spread out and dropped from low, so most of them settle and fall asleep during the run
+        btBoxShape boxShape(btVector3(0.5, 0.5, 0.5));
+        btVector3 inertia;
+        boxShape.calculateLocalInertia(1, inertia);
+
+        std::vector<btRigidBody*> boxes;
+        for (int i = 0; i < numBoxes; ++i)
+        {
+            btTransform start = btTransform::getIdentity();
+            start.setOrigin(btVector3(randomUnit(state) * 150, 0.5 + btFabs(randomUnit(state)) * 2, randomUnit(state) * 150));
+
+            btRigidBody::btRigidBodyConstructionInfo info(1, new btDefaultMotionState(start), &boxShape, inertia);
+            btRigidBody* box = new btRigidBody(info);
+            boxes.push_back(box);
+            world.addRigidBody(box);
+        }
+
+        std::vector<btAsyncStepper::BodyTransform> gathered(numBoxes);
+        std::vector<btScalar> positions(numBoxes * 4), rotations(numBoxes * 4);
+        std::vector<btScalar> uploadPositions(numBoxes * 4), uploadRotations(numBoxes * 4);
+
+        btTransformExport transformExport;
+        if (run == 1)
+        {
+            transformExport.setBuffers(&positions[0], &rotations[0], nullptr, numBoxes);
+            for (btRigidBody* box : boxes)
+            {
+                transformExport.addBody(box);
+            }
+            world.setTransformExport(&transformExport);
+        }
+
+        for (int f = 0; f < frames; ++f)
+        {
+            auto start = std::chrono::steady_clock::now();
+            world.stepSimulation(dt, 1, dt);
+            stepMs[run] += elapsedMs(start);
+
+            if (run == 0)
+            {
+                start = std::chrono::steady_clock::now();
+                for (int i = 0; i < numBoxes; ++i)
+                {
+                    btTransform transform;
+                    boxes[i]->getMotionState()->getWorldTransform(transform);
+                    gathered[i] = bodyTransform(transform);
+                }
+                gatherMs += elapsedMs(start);
+                continue;
+            }
+
+            // What an instance buffer upload does with the dirty list
+            start = std::chrono::steady_clock::now();
+            const btAlignedObjectArray<int>& dirty = transformExport.getDirtyIndices();
+            for (int i = 0; i < dirty.size(); ++i)
+            {
+                memcpy(&uploadPositions[dirty[i] * 4], &positions[dirty[i] * 4], sizeof(btScalar) * 4);
+                memcpy(&uploadRotations[dirty[i] * 4], &rotations[dirty[i] * 4], sizeof(btScalar) * 4);
+            }
+            dirtyCount += dirty.size();
+            transformExport.clearDirtyIndices();
+            copyMs += elapsedMs(start);
+
+            // The uploaded copy has to match the motion states, sleeping bodies included
+            for (int i = 0; i < numBoxes; ++i)
+            {
+                btTransform transform;
+                boxes[i]->getMotionState()->getWorldTransform(transform);
+                btAsyncStepper::BodyTransform expected = bodyTransform(transform);
+                int index = boxes[i]->getTransformExportIndex();
+
+                if (memcmp(expected.m_position, &uploadPositions[index * 4], sizeof(btScalar) * 3) != 0 ||
+                    memcmp(expected.m_rotation, &uploadRotations[index * 4], sizeof(btScalar) * 4) != 0)
+                {
+                    ++failures;
+                }
+            }
+        }
+
+        if (run == 1)
+        {
+            for (btRigidBody* box : boxes)
+            {
+                if (box->isActive()) ++numAwake;
+            }
+        }
+
+        for (btRigidBody* box : boxes)
+        {
+            world.removeRigidBody(box);
+            delete box->getMotionState();
+            delete box;
+        }
+        world.removeRigidBody(&ground);
+    }
+
+    fprintf(out, "  \"export\": {\n");
+    fprintf(out, "    \"boxes\": %d,\n", numBoxes);
+    fprintf(out, "    \"frames\": %d,\n", frames);
+    fprintf(out, "    \"awake_at_end\": %d,\n", numAwake);
+    fprintf(out, "    \"step_ms_per_frame\": %.3f,\n", stepMs[0] / frames);
+    fprintf(out, "    \"step_with_export_ms_per_frame\": %.3f,\n", stepMs[1] / frames);
+    fprintf(out, "    \"motion_state_gather_us_per_frame\": %.2f,\n", gatherMs * 1e3 / frames);
+    fprintf(out, "    \"dirty_copy_us_per_frame\": %.2f,\n", copyMs * 1e3 / frames);
+    fprintf(out, "    \"dirty_per_frame\": %.1f,\n", double(dirtyCount) / frames);
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Snapshot
+
+// Transform and velocities of every body after each tick, compared bit for bit between runs
+static void recordTick(const std::vector<btRigidBody*>& bodies, std::vector<btScalar>& trajectory)
+{
+    for (btRigidBody* body : bodies)
+    {
+        const btTransform& transform = body->getWorldTransform();
+        for (int i = 0; i < 3; ++i)
+        {
+            trajectory.push_back(transform.getOrigin()[i]);
+            trajectory.push_back(transform.getBasis()[i][0]);
+            trajectory.push_back(transform.getBasis()[i][1]);
+            trajectory.push_back(transform.getBasis()[i][2]);
+            trajectory.push_back(body->getLinearVelocity()[i]);
+            trajectory.push_back(body->getAngularVelocity()[i]);
+        }
+    }
+}
+
+static int firstDivergentTick(const std::vector<btScalar>& expected, const std::vector<btScalar>& actual, int ticks)
+{
+    if (expected.size() != actual.size()) return 0;
+    const size_t perTick = expected.size() / ticks;
+
+    for (int t = 0; t < ticks; ++t)
+    {
+        if (memcmp(&expected[t * perTick], &actual[t * perTick], perTick * sizeof(btScalar)) != 0) return t;
+    }
+    return -1;
+}
+
+static int runSnapshot(const Options& options, FILE* out)
+{
+    const int numBoxes = 240;
+    const int numChains = 6;
+    const int chainLength = 10;
+    const int warmupTicks = 90;
+    const int ticks = 120;
+    const int iterations = std::max(options.iterations, 1);
+    const btScalar dt = btScalar(1) / 60;
+
+    unsigned int state = options.seed;
+    int failures = 0;
+
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher(&configuration);
+    btDbvtBroadphase broadphase;
+    btSequentialImpulseConstraintSolver solver;
+    btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &solver, &configuration);
+    btWorldSnapshot::enableDeterministicStepping(&world);
+
+    btBoxShape groundShape(btVector3(30, 1, 30));
+    btRigidBody ground(0, nullptr, &groundShape);
+    ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+    world.addRigidBody(&ground);
+
+    // A pile dropped into a small area, so most boxes end up touching several others
+    btBoxShape boxShape(btVector3(0.5, 0.5, 0.5));
+    btSphereShape sphereShape(0.3);
+    btVector3 boxInertia, sphereInertia;
+    boxShape.calculateLocalInertia(1, boxInertia);
+    sphereShape.calculateLocalInertia(1, sphereInertia);
+
+    std::vector<btRigidBody*> bodies;
+    for (int i = 0; i < numBoxes; ++i)
+    {
+        btTransform start = btTransform::getIdentity();
+        start.setOrigin(btVector3(randomUnit(state) * 5, 1 + btFabs(randomUnit(state)) * 15, randomUnit(state) * 5));
+        start.setRotation(btQuaternion(randomUnit(state), randomUnit(state), randomUnit(state)));
+
+        btRigidBody* body = new btRigidBody(1, new btDefaultMotionState(start), &boxShape, boxInertia);
+        bodies.push_back(body);
+        world.addRigidBody(body);
+    }
+
+    // Hanging chains of spheres, for the applied impulses of constraints
+    std::vector<btTypedConstraint*> constraints;
+    for (int c = 0; c < numChains; ++c)
+    {
+        btRigidBody* previous = nullptr;
+        const btVector3 anchor(-12 + c * 4, 12, 10);
+
+        for (int i = 0; i < chainLength; ++i)
+        {
+            btTransform start = btTransform::getIdentity();
+            start.setOrigin(anchor + btVector3(btScalar(0.7) * (i + 1), 0, 0));
+
+            btRigidBody* link = new btRigidBody(1, new btDefaultMotionState(start), &sphereShape, sphereInertia);
+            bodies.push_back(link);
+            world.addRigidBody(link);
+
+            btTypedConstraint* joint = previous
+                ? new btPoint2PointConstraint(*previous, *link, btVector3(btScalar(0.35), 0, 0), btVector3(btScalar(-0.35), 0, 0))
+                : new btPoint2PointConstraint(*link, btVector3(btScalar(-0.7), 0, 0));
+            constraints.push_back(joint);
+            world.addConstraint(joint, true);
+            previous = link;
+        }
+    }
+
+    // The same kicks in every run, so pairs appear and disappear after the capture
+    auto stepRecorded = [&](std::vector<btScalar>& trajectory)
+    {
+        trajectory.clear();
+        for (int t = 0; t < ticks; ++t)
+        {
+            if (t % 15 == 5)
+            {
+                btRigidBody* body = bodies[(t * 7) % numBoxes];
+                body->activate(true);
+                body->applyCentralImpulse(btVector3(0, 6, 2));
+            }
+            world.stepSimulation(dt, 1, dt);
+            recordTick(bodies, trajectory);
+        }
+    };
+
+    for (int t = 0; t < warmupTicks; ++t)
+    {
+        world.stepSimulation(dt, 1, dt);
+    }
+
+    btWorldSnapshot snapshot;
+    snapshot.capture(&world);
+
+    // Run on from the capture, then twice more from the restored snapshot
+    std::vector<btScalar> reference, replay;
+    stepRecorded(reference);
+
+    int divergentTick[2] = { -1, -1 };
+    int lostManifolds = 0;
+    for (int run = 0; run < 2; ++run)
+    {
+        if (!snapshot.restore(&world)) ++failures;
+        lostManifolds += snapshot.getNumLostManifolds();
+
+        stepRecorded(replay);
+        divergentTick[run] = firstDivergentTick(reference, replay, ticks);
+        if (divergentTick[run] >= 0) ++failures;
+    }
+
+    // Restore after a single tick, what a rollback does every frame; it steps again right away,
+    // so every other restore leaves the motion states to the step
+    std::vector<double> captureUs, restoreUs, rollbackUs;
+    for (int i = 0; i < iterations * 2; ++i)
+    {
+        world.stepSimulation(dt, 1, dt);
+
+        const bool synchronize = i % 2 == 0;
+        auto start = std::chrono::steady_clock::now();
+        if (!snapshot.restore(&world, synchronize)) ++failures;
+        (synchronize ? restoreUs : rollbackUs).push_back(elapsedMs(start) * 1e3);
+        lostManifolds += snapshot.getNumLostManifolds();
+
+        start = std::chrono::steady_clock::now();
+        snapshot.capture(&world);
+        captureUs.push_back(elapsedMs(start) * 1e3);
+    }
+
+    int numAwake = 0;
+    for (btRigidBody* body : bodies)
+    {
+        if (body->isActive()) ++numAwake;
+    }
+
+    int numPairs = broadphase.getOverlappingPairCache()->getNumOverlappingPairs();
+    int numManifolds = dispatcher.getNumManifolds();
+
+    // A world that doesn't hold the same objects anymore is refused
+    world.removeRigidBody(bodies[0]);
+    if (snapshot.restore(&world)) ++failures;
+    world.addRigidBody(bodies[0]);
+
+    for (btTypedConstraint* joint : constraints)
+    {
+        world.removeConstraint(joint);
+        delete joint;
+    }
+    for (btRigidBody* body : bodies)
+    {
+        world.removeRigidBody(body);
+        delete body->getMotionState();
+        delete body;
+    }
+    world.removeRigidBody(&ground);
+
+    fprintf(out, "  \"snapshot\": {\n");
+    fprintf(out, "    \"bodies\": %d,\n", int(bodies.size()));
+    fprintf(out, "    \"awake\": %d,\n", numAwake);
+    fprintf(out, "    \"constraints\": %d,\n", int(constraints.size()));
+    fprintf(out, "    \"pairs\": %d,\n", numPairs);
+    fprintf(out, "    \"manifolds\": %d,\n", numManifolds);
+    fprintf(out, "    \"bytes\": %d,\n", snapshot.getBufferSize());
+    fprintf(out, "    \"ticks_compared\": %d,\n", ticks);
+    fprintf(out, "    \"divergent_tick\": [%d, %d],\n", divergentTick[0], divergentTick[1]);
+    fprintf(out, "    \"lost_manifolds\": %d,\n", lostManifolds);
+    fprintf(out, "    \"capture_us_p50\": %.2f,\n", percentile(captureUs, 50));
+    fprintf(out, "    \"restore_us_p50\": %.2f,\n", percentile(restoreUs, 50));
+    fprintf(out, "    \"restore_us_p99\": %.2f,\n", percentile(restoreUs, 99));
+    fprintf(out, "    \"restore_without_motion_states_us_p50\": %.2f,\n", percentile(rollbackUs, 50));
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Solver
+
+struct SolverTiming
+{
+    double solveMs = 0;
+    double iterateMs = 0;
+    long long iterations = 0;
+    double residualSum = 0;
+    long long batches = 0;
+    long long scalarRows = 0;
+};
+
+static void countBatches(const btSequentialImpulseConstraintSolver&, SolverTiming&)
+{
+}
+
+static void countBatches(const btBatchedConstraintSolver& solver, SolverTiming& timing)
+{
+    timing.batches += solver.getNumContactBatches() + solver.getNumFrictionBatches();
+    timing.scalarRows += solver.getNumScalarRows();
+}
+
+// Times solveGroup and its iterations, without the setup both solvers share, and keeps the residual of the last
+// iteration, for either solver
+template <class Solver>
+struct MeasuredSolver : public Solver, public SolverTiming
+{
+    virtual btScalar solveGroupCacheFriendlyIterations(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds, int numManifolds,
+                                                       btTypedConstraint** constraints, int numConstraints, const btContactSolverInfo& info,
+                                                       btIDebugDraw* debugDrawer)
+    {
+        auto start = std::chrono::steady_clock::now();
+        btScalar result = Solver::solveGroupCacheFriendlyIterations(bodies, numBodies, manifolds, numManifolds, constraints, numConstraints, info, debugDrawer);
+        iterateMs += elapsedMs(start);
+        return result;
+    }
+
+    virtual btScalar solveGroup(btCollisionObject** bodies, int numBodies, btPersistentManifold** manifolds, int numManifolds,
+                                btTypedConstraint** constraints, int numConstraints, const btContactSolverInfo& info,
+                                btIDebugDraw* debugDrawer, btDispatcher* dispatcher)
+    {
+        auto start = std::chrono::steady_clock::now();
+        btScalar result = Solver::solveGroup(bodies, numBodies, manifolds, numManifolds, constraints, numConstraints, info, debugDrawer, dispatcher);
+        solveMs += elapsedMs(start);
+        iterations += info.m_numIterations;
+        residualSum += Solver::m_leastSquaresResidual;
+        countBatches(*this, *this);
+        return result;
+    }
+};
+
+struct SolverRun
+{
+    double iterationsPerMs = 0;
+    double solveMsPerTick = 0;
+    double meanResidual = 0;
+    btScalar maxPenetration = 0;
+    btScalar maxDrift = 0;
+    btScalar maxSpeed = 0;
+    int contacts = 0;
+};
+
+static btScalar deepestPenetration(btDispatcher* dispatcher)
+{
+    btScalar deepest = 0;
+    for (int i = 0; i < dispatcher->getNumManifolds(); ++i)
+    {
+        const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+        for (int p = 0; p < manifold->getNumContacts(); ++p)
+        {
+            deepest = btMin(deepest, manifold->getContactPoint(p).getDistance());
+        }
+    }
+    return -deepest;
+}
+
+static int countContacts(btDispatcher* dispatcher)
+{
+    int contacts = 0;
+    for (int i = 0; i < dispatcher->getNumManifolds(); ++i)
+    {
+        contacts += dispatcher->getManifoldByIndexInternal(i)->getNumContacts();
+    }
+    return contacts;
+}
+
+// A settled stack of towers or a pile, stepped on from the same snapshot by either solver
+static int runSolverScene(const char* name, bool towers, const Options& options, FILE* out)
+{
+    const int settleTicks = towers ? 30 : 240;
+    const int ticks = std::max(options.iterations, 30);
+    const btScalar dt = btScalar(1) / 60;
+
+    unsigned int state = options.seed;
+    int failures = 0;
+
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher(&configuration);
+    btDbvtBroadphase broadphase;
+    MeasuredSolver<btSequentialImpulseConstraintSolver> scalarSolver;
+    MeasuredSolver<btBatchedConstraintSolver> batchedSolver;
+    btDiscreteDynamicsWorld world(&dispatcher, &broadphase, &scalarSolver, &configuration);
+    // every run steps on from the same snapshot, and has to step alike for the same solver
+    btWorldSnapshot::enableDeterministicStepping(&world);
+
+    btBoxShape groundShape(btVector3(40, 1, 40));
+    btRigidBody ground(0, nullptr, &groundShape);
+    ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+    world.addRigidBody(&ground);
+
+    btBoxShape boxShape(btVector3(0.5, 0.5, 0.5));
+    btVector3 boxInertia;
+    boxShape.calculateLocalInertia(1, boxInertia);
+
+    std::vector<btRigidBody*> bodies;
+    if (towers)
+    {
+        // 10 by 10 towers of 12 boxes, resting on each other from the start
+        for (int x = 0; x < 10; ++x)
+        {
+            for (int z = 0; z < 10; ++z)
+            {
+                for (int y = 0; y < 12; ++y)
+                {
+                    btTransform start = btTransform::getIdentity();
+                    start.setOrigin(btVector3(x * 3 - 13.5, btScalar(0.5) + y, z * 3 - 13.5));
+                    bodies.push_back(new btRigidBody(1, new btDefaultMotionState(start), &boxShape, boxInertia));
+                }
+            }
+        }
+    }
+    else
+    {
+        // 1200 boxes dropped onto a small area, most of them end up touching several others
+        for (int i = 0; i < 1200; ++i)
+        {
+            btTransform start = btTransform::getIdentity();
+            start.setOrigin(btVector3(randomUnit(state) * 8, 1 + btFabs(randomUnit(state)) * 12, randomUnit(state) * 8));
+            start.setRotation(btQuaternion(randomUnit(state), randomUnit(state), randomUnit(state)));
+            bodies.push_back(new btRigidBody(1, new btDefaultMotionState(start), &boxShape, boxInertia));
+        }
+    }
+
+    for (btRigidBody* body : bodies)
+    {
+        // keep everything awake, a sleeping pile has nothing to solve
+        body->setActivationState(DISABLE_DEACTIVATION);
+        world.addRigidBody(body);
+    }
+
+    for (int t = 0; t < settleTicks; ++t)
+    {
+        world.stepSimulation(dt, 1, dt);
+    }
+
+    btWorldSnapshot snapshot;
+    snapshot.capture(&world);
+
+    std::vector<btVector3> startOrigins;
+    for (btRigidBody* body : bodies)
+    {
+        startOrigins.push_back(body->getWorldTransform().getOrigin());
+    }
+
+    auto run = [&](btConstraintSolver* solver, SolverTiming& timing)
+    {
+        SolverRun result;
+        if (!snapshot.restore(&world)) ++failures;
+        world.setConstraintSolver(solver);
+        timing = SolverTiming();
+
+        long long contacts = 0;
+        for (int t = 0; t < ticks; ++t)
+        {
+            world.stepSimulation(dt, 1, dt);
+            result.maxPenetration = btMax(result.maxPenetration, deepestPenetration(&dispatcher));
+            contacts += countContacts(&dispatcher);
+        }
+
+        for (size_t i = 0; i < bodies.size(); ++i)
+        {
+            btVector3 drift = bodies[i]->getWorldTransform().getOrigin() - startOrigins[i];
+            drift.setY(0);
+            result.maxDrift = btMax(result.maxDrift, drift.length());
+            result.maxSpeed = btMax(result.maxSpeed, bodies[i]->getLinearVelocity().length());
+        }
+
+        result.iterationsPerMs = timing.iterateMs > 0 ? timing.iterations / timing.iterateMs : 0;
+        result.solveMsPerTick = timing.solveMs / ticks;
+        // per tick rather than per solveGroup, how islands are batched into solveGroup calls changes with the pairs of
+        // bodies that merely overlap
+        result.meanResidual = timing.residualSum / ticks;
+        result.contacts = int(contacts / ticks);
+        return result;
+    };
+
+    // Alternate the solvers and keep the faster run of each, the results only differ in timing
+    SolverRun scalar, batched;
+    for (int repeat = 0; repeat < 3; ++repeat)
+    {
+        SolverRun s = run(&scalarSolver, scalarSolver);
+        SolverRun b = run(&batchedSolver, batchedSolver);
+
+        if (repeat == 0 || s.iterationsPerMs > scalar.iterationsPerMs) scalar = s;
+        if (repeat == 0 || b.iterationsPerMs > batched.iterationsPerMs) batched = b;
+    }
+
+    // Parity: the batched solver orders rows differently, but has to converge and hold the scene as well as the scalar
+    // one. A pile keeps sliding either way, so only the towers are held to their drift
+    const bool penetrationParity = batched.maxPenetration <= scalar.maxPenetration * btScalar(1.25) + btScalar(0.005);
+    const bool driftParity = !towers || batched.maxDrift <= scalar.maxDrift + btScalar(0.05);
+    const bool residualParity = batched.meanResidual <= scalar.meanResidual * 2 + 1e-6;
+    if (!penetrationParity) ++failures;
+    if (!driftParity) ++failures;
+    if (!residualParity) ++failures;
+
+    world.setConstraintSolver(&scalarSolver);
+    for (btRigidBody* body : bodies)
+    {
+        world.removeRigidBody(body);
+        delete body->getMotionState();
+        delete body;
+    }
+    world.removeRigidBody(&ground);
+
+    fprintf(out, "    \"%s\": {\n", name);
+    fprintf(out, "      \"bodies\": %d,\n", int(bodies.size()));
+    fprintf(out, "      \"contacts\": %d,\n", scalar.contacts);
+    fprintf(out, "      \"batches\": %d,\n", int(batchedSolver.batches / ticks));
+    fprintf(out, "      \"scalar_rows\": %d,\n", int(batchedSolver.scalarRows / ticks));
+    for (int i = 0; i < 2; ++i)
+    {
+        const SolverRun& r = i == 0 ? scalar : batched;
+        fprintf(out, "      \"%s\": { \"iterations_per_ms\": %.2f, \"solve_ms_per_tick\": %.3f, \"mean_residual\": %.3g, \"max_penetration\": %.4f, \"max_drift\": %.4f, \"max_speed\": %.4f },\n",
+                i == 0 ? "scalar" : "batched", r.iterationsPerMs, r.solveMsPerTick, r.meanResidual, r.maxPenetration, r.maxDrift, r.maxSpeed);
+    }
+    fprintf(out, "      \"speedup\": %.2f,\n", scalar.iterationsPerMs > 0 ? batched.iterationsPerMs / scalar.iterationsPerMs : 0);
+    fprintf(out, "      \"parity\": { \"penetration\": %s, \"drift\": %s, \"residual\": %s }\n",
+            penetrationParity ? "true" : "false", driftParity ? "true" : "false", residualParity ? "true" : "false");
+    fprintf(out, "    }");
+
+    return failures;
+}
+
+static int runSolver(const Options& options, FILE* out)
+{
+    int failures = 0;
+
+    fprintf(out, "  \"solver\": {\n");
+    fprintf(out, "    \"width\": %d,\n", BT_BATCHED_SOLVER_WIDTH);
+    failures += runSolverScene("stack", true, options, out);
+    fprintf(out, ",\n");
+    failures += runSolverScene("pile", false, options, out);
+    fprintf(out, ",\n    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Islands
+
+// Time spent in calculateSimulationIslands and solveConstraints, the solver itself is taken off afterwards
+struct IslandsWorld : public btDiscreteDynamicsWorld
+{
+    double islandsMs = 0;
+
+    IslandsWorld(btDispatcher* dispatcher, btBroadphaseInterface* broadphase, btConstraintSolver* solver, btCollisionConfiguration* configuration)
+        : btDiscreteDynamicsWorld(dispatcher, broadphase, solver, configuration)
+    {
+    }
+
+    virtual void calculateSimulationIslands()
+    {
+        auto start = std::chrono::steady_clock::now();
+        btDiscreteDynamicsWorld::calculateSimulationIslands();
+        islandsMs += elapsedMs(start);
+    }
+
+    virtual void solveConstraints(btContactSolverInfo& solverInfo)
+    {
+        auto start = std::chrono::steady_clock::now();
+        btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+        islandsMs += elapsedMs(start);
+    }
+};
+
+// 20 by 20 stacks of 5 boxes that fall asleep, hanging chains and a few boxes riding a kinematic platform
+struct IslandsScene
+{
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher;
+    btDbvtBroadphase broadphase;
+    MeasuredSolver<btSequentialImpulseConstraintSolver> solver;
+    IslandsWorld world;
+    btIncrementalIslandManager islandManager;
+    btRigidBody* ground;
+    btRigidBody* platform;
+    std::vector<btRigidBody*> bodies;
+    std::vector<btTypedConstraint*> constraints;
+
+    IslandsScene(btCollisionShape* groundShape, btCollisionShape* boxShape, btCollisionShape* sphereShape, btCollisionShape* platformShape,
+                 bool incremental, bool deterministic)
+        : dispatcher(&configuration),
+          world(&dispatcher, &broadphase, &solver, &configuration),
+          islandManager(broadphase.getOverlappingPairCache())
+    {
+        if (incremental)
+        {
+            broadphase.getOverlappingPairCache()->setInternalGhostPairCallback(&islandManager);
+            world.setIncrementalIslandManager(&islandManager);
+        }
+        if (deterministic)
+        {
+            btWorldSnapshot::enableDeterministicStepping(&world);
+        }
+
+        ground = new btRigidBody(0, nullptr, groundShape);
+        ground->getWorldTransform().setOrigin(btVector3(0, -1, 0));
+        world.addRigidBody(ground);
+
+        btVector3 boxInertia, sphereInertia;
+        boxShape->calculateLocalInertia(1, boxInertia);
+        sphereShape->calculateLocalInertia(1, sphereInertia);
+
+        for (int x = 0; x < 20; ++x)
+        {
+            for (int z = 0; z < 20; ++z)
+            {
+                for (int y = 0; y < 5; ++y)
+                {
+                    btTransform start = btTransform::getIdentity();
+                    start.setOrigin(btVector3(x * 3 - 28.5, btScalar(0.5) + y, z * 3 - 28.5));
+                    addBody(new btRigidBody(1, new btDefaultMotionState(start), boxShape, boxInertia));
+                }
+            }
+        }
+
+        for (int c = 0; c < 4; ++c)
+        {
+            btRigidBody* previous = nullptr;
+            const btVector3 anchor(-9 + c * 6, 12, 33);
+
+            for (int i = 0; i < 8; ++i)
+            {
+                btTransform start = btTransform::getIdentity();
+                start.setOrigin(anchor - btVector3(0, btScalar(0.7) * (i + 1), 0));
+
+                btRigidBody* link = new btRigidBody(1, new btDefaultMotionState(start), sphereShape, sphereInertia);
+                addBody(link);
+
+                btTypedConstraint* joint = previous
+                    ? new btPoint2PointConstraint(*previous, *link, btVector3(0, btScalar(-0.35), 0), btVector3(0, btScalar(0.35), 0))
+                    : new btPoint2PointConstraint(*link, btVector3(0, btScalar(0.7), 0));
+                constraints.push_back(joint);
+                world.addConstraint(joint, true);
+                previous = link;
+            }
+        }
+
+        btTransform platformStart = btTransform::getIdentity();
+        platformStart.setOrigin(btVector3(0, 2, -35));
+        platform = new btRigidBody(0, new btDefaultMotionState(platformStart), platformShape);
+        platform->setCollisionFlags(platform->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+        platform->setActivationState(DISABLE_DEACTIVATION);
+        world.addRigidBody(platform);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            btTransform start = btTransform::getIdentity();
+            start.setOrigin(btVector3(btScalar(-1 + (i % 2) * 2), btScalar(2.75), btScalar(-36 + (i / 2) * 2)));
+            addBody(new btRigidBody(1, new btDefaultMotionState(start), boxShape, boxInertia));
+        }
+    }
+
+    ~IslandsScene()
+    {
+        for (btTypedConstraint* joint : constraints)
+        {
+            world.removeConstraint(joint);
+            delete joint;
+        }
+        for (btRigidBody* body : bodies)
+        {
+            world.removeRigidBody(body);
+            delete body->getMotionState();
+            delete body;
+        }
+        world.removeRigidBody(platform);
+        delete platform->getMotionState();
+        delete platform;
+        world.removeRigidBody(ground);
+        delete ground;
+        world.setIncrementalIslandManager(nullptr);
+        broadphase.getOverlappingPairCache()->setInternalGhostPairCallback(nullptr);
+    }
+
+    void addBody(btRigidBody* body)
+    {
+        bodies.push_back(body);
+        world.addRigidBody(body);
+    }
+
+    int numAwake() const
+    {
+        int awake = 0;
+        for (btRigidBody* body : bodies)
+        {
+            if (body->isActive()) ++awake;
+        }
+        return awake;
+    }
+
+    // What happens to the scene before frame t: a kick, a poked chain, a body taken out and put back and the platform moving
+    void prepareFrame(int t, unsigned int kick)
+    {
+        if (t % 5 == 2)
+        {
+            btRigidBody* body = bodies[kick % 2000];
+            body->activate();
+            body->applyCentralImpulse(btVector3(0, 4, 1));
+        }
+        if (t % 60 == 30)
+        {
+            btRigidBody* end = bodies[2000 + (t / 60 % 4) * 8 + 7];
+            end->activate();
+            end->applyCentralImpulse(btVector3(2, 0, 0));
+        }
+        if (t % 50 == 25)
+        {
+            btRigidBody* body = bodies[(kick >> 8) % 2000];
+            world.removeRigidBody(body);
+            world.addRigidBody(body);
+        }
+
+        btTransform transform = btTransform::getIdentity();
+        transform.setOrigin(btVector3(3 * btSin(btScalar(t) * btScalar(0.1)), 2, -35));
+        platform->getMotionState()->setWorldTransform(transform);
+    }
+};
+
+// Islands of the stock and the incremental scene have to be the same sets of bodies
+static bool samePartition(const IslandsScene& stock, const IslandsScene& incremental)
+{
+    std::map<int, int> stockToIncremental, incrementalToStock;
+    for (size_t i = 0; i < stock.bodies.size(); ++i)
+    {
+        const int a = stock.bodies[i]->getIslandTag();
+        const int b = incremental.bodies[i]->getIslandTag();
+        if (stock.bodies[i]->getActivationState() != incremental.bodies[i]->getActivationState()) return false;
+
+        auto ab = stockToIncremental.insert(std::make_pair(a, b));
+        auto ba = incrementalToStock.insert(std::make_pair(b, a));
+        if (ab.first->second != b || ba.first->second != a) return false;
+    }
+    return true;
+}
+
+static int runIslands(const Options& options, FILE* out)
+{
+    const int settleTicks = 180;
+    const int frames = std::max(options.iterations, 20);
+    const int subSteps = 10;
+    const btScalar dt = btScalar(1) / 60;
+
+    int failures = 0;
+
+    btBoxShape groundShape(btVector3(40, 1, 40));
+    btBoxShape boxShape(btVector3(0.5, 0.5, 0.5));
+    btSphereShape sphereShape(0.3);
+    btBoxShape platformShape(btVector3(2, 0.25, 2));
+
+    // Parity: with deterministic stepping, where manifolds of an island are solved in the same order by both,
+    // every frame has to come out bit for bit the same, with the same islands and sleeping states
+    int divergentFrame = -1;
+    int partitionMismatches = 0;
+    int incrementalIslands = 0, awakeIslands = 0;
+    {
+        IslandsScene stock(&groundShape, &boxShape, &sphereShape, &platformShape, false, true);
+        IslandsScene incremental(&groundShape, &boxShape, &sphereShape, &platformShape, true, true);
+
+        for (int t = 0; t < settleTicks; ++t)
+        {
+            stock.world.stepSimulation(dt, 1, dt);
+            incremental.world.stepSimulation(dt, 1, dt);
+        }
+
+        unsigned int state = options.seed;
+        std::vector<btScalar> expected, actual;
+        for (int t = 0; t < frames; ++t)
+        {
+            const unsigned int kick = seededRand(state);
+            stock.prepareFrame(t, kick);
+            incremental.prepareFrame(t, kick);
+
+            // one rebuild from scratch halfway
+            if (t == frames / 2) incremental.islandManager.invalidateIslands();
+
+            stock.world.stepSimulation(dt * subSteps, subSteps, dt);
+            incremental.world.stepSimulation(dt * subSteps, subSteps, dt);
+
+            expected.clear();
+            actual.clear();
+            recordTick(stock.bodies, expected);
+            recordTick(incremental.bodies, actual);
+            if (divergentFrame < 0 && memcmp(&expected[0], &actual[0], expected.size() * sizeof(btScalar)) != 0) divergentFrame = t;
+            if (!samePartition(stock, incremental)) ++partitionMismatches;
+        }
+
+        incrementalIslands = incremental.islandManager.getNumIslands();
+        awakeIslands = incremental.islandManager.getNumAwakeIslands();
+    }
+    if (divergentFrame >= 0) ++failures;
+    if (partitionMismatches) ++failures;
+
+    // Timing: the default stepping, both scenes get the same kicks and take turns going first
+    IslandsScene stock(&groundShape, &boxShape, &sphereShape, &platformShape, false, false);
+    IslandsScene incremental(&groundShape, &boxShape, &sphereShape, &platformShape, true, false);
+
+    for (int t = 0; t < settleTicks; ++t)
+    {
+        stock.world.stepSimulation(dt, 1, dt);
+        incremental.world.stepSimulation(dt, 1, dt);
+    }
+
+    std::vector<double> stockIslandsMs, incrementalIslandsMs, stockStepMs, incrementalStepMs;
+    std::vector<double> awake;
+    unsigned int state = options.seed;
+    for (int t = 0; t < frames; ++t)
+    {
+        const unsigned int kick = seededRand(state);
+        for (int turn = 0; turn < 2; ++turn)
+        {
+            IslandsScene& scene = (turn == 0) == (t % 2 == 0) ? stock : incremental;
+            scene.prepareFrame(t, kick);
+            scene.world.islandsMs = 0;
+            scene.solver.solveMs = 0;
+
+            auto start = std::chrono::steady_clock::now();
+            scene.world.stepSimulation(dt * subSteps, subSteps, dt);
+            const double stepMs = elapsedMs(start);
+            const double islandsMs = scene.world.islandsMs - scene.solver.solveMs;
+
+            (&scene == &stock ? stockStepMs : incrementalStepMs).push_back(stepMs);
+            (&scene == &stock ? stockIslandsMs : incrementalIslandsMs).push_back(islandsMs);
+        }
+        awake.push_back(incremental.numAwake());
+    }
+
+    const double stockIslands = percentile(stockIslandsMs, 50);
+    const double incrementalIslandsP50 = percentile(incrementalIslandsMs, 50);
+
+    fprintf(out, "  \"islands\": {\n");
+    fprintf(out, "    \"bodies\": %d,\n", int(stock.bodies.size()));
+    fprintf(out, "    \"constraints\": %d,\n", int(stock.constraints.size()));
+    fprintf(out, "    \"sub_steps\": %d,\n", subSteps);
+    fprintf(out, "    \"awake_bodies_p50\": %d,\n", int(percentile(awake, 50)));
+    fprintf(out, "    \"islands\": %d,\n", incrementalIslands);
+    fprintf(out, "    \"awake_islands\": %d,\n", awakeIslands);
+    fprintf(out, "    \"stock_islands_ms_per_frame_p50\": %.3f,\n", stockIslands);
+    fprintf(out, "    \"incremental_islands_ms_per_frame_p50\": %.3f,\n", incrementalIslandsP50);
+    fprintf(out, "    \"islands_speedup\": %.2f,\n", incrementalIslandsP50 > 0 ? stockIslands / incrementalIslandsP50 : 0);
+    fprintf(out, "    \"stock_step_ms_p50\": %.3f,\n", percentile(stockStepMs, 50));
+    fprintf(out, "    \"incremental_step_ms_p50\": %.3f,\n", percentile(incrementalStepMs, 50));
+    fprintf(out, "    \"frames_compared\": %d,\n", frames);
+    fprintf(out, "    \"divergent_frame\": %d,\n", divergentFrame);
+    fprintf(out, "    \"partition_mismatches\": %d,\n", partitionMismatches);
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Trace
+
+// Boxes piled on a floor by the multithreaded world, with small fast spheres shot into it for continuous collision
+struct TraceScene
+{
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcherMt dispatcher;
+    btDbvtBroadphase broadphase;
+    btConstraintSolverPoolMt solverPool;
+    btDiscreteDynamicsWorldMt world;
+    btBoxShape groundShape;
+    btBoxShape boxShape;
+    btSphereShape bulletShape;
+    btRigidBody ground;
+    std::vector<btRigidBody*> boxes;
+    std::vector<btRigidBody*> bullets;
+
+    TraceScene(unsigned int seed, int numBoxes, int numBullets, int numThreads)
+    : dispatcher(&configuration),
+      solverPool(numThreads),
+      world(&dispatcher, &broadphase, &solverPool, &configuration),
+      groundShape(btVector3(50, 1, 50)),
+      boxShape(btVector3(0.5, 0.5, 0.5)),
+      bulletShape(0.1),
+      ground(0, nullptr, &groundShape)
+    {
+        ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+        world.addRigidBody(&ground);
+
+        btVector3 boxInertia, bulletInertia;
+        boxShape.calculateLocalInertia(1, boxInertia);
+        bulletShape.calculateLocalInertia(btScalar(0.1), bulletInertia);
+
+        for (int i = 0; i < numBoxes; ++i)
+        {
+            btRigidBody* box = new btRigidBody(1, nullptr, &boxShape, boxInertia);
+            box->getWorldTransform().setOrigin(btVector3(randomUnit(seed) * 12, 1 + btFabs(randomUnit(seed)) * 30, randomUnit(seed) * 12));
+            boxes.push_back(box);
+            world.addRigidBody(box);
+        }
+        for (int i = 0; i < numBullets; ++i)
+        {
+            btRigidBody* bullet = new btRigidBody(btScalar(0.1), nullptr, &bulletShape, bulletInertia);
+            bullet->setCcdMotionThreshold(btScalar(0.05));
+            bullet->setCcdSweptSphereRadius(btScalar(0.08));
+            bullet->setActivationState(DISABLE_DEACTIVATION);
+            bullets.push_back(bullet);
+            world.addRigidBody(bullet);
+        }
+    }
+
+    ~TraceScene()
+    {
+        for (btRigidBody* body : boxes)
+        {
+            world.removeRigidBody(body);
+            delete body;
+        }
+        for (btRigidBody* body : bullets)
+        {
+            world.removeRigidBody(body);
+            delete body;
+        }
+        world.removeRigidBody(&ground);
+    }
+
+    // sends every sphere down at the floor again, fast enough to tunnel through it without continuous collision
+    void fire(unsigned int& seed)
+    {
+        for (btRigidBody* bullet : bullets)
+        {
+            btTransform start = btTransform::getIdentity();
+            start.setOrigin(btVector3(randomUnit(seed) * 40, 8, 20 + randomUnit(seed) * 10));
+            bullet->setWorldTransform(start);
+            bullet->setInterpolationWorldTransform(start);
+            bullet->setLinearVelocity(btVector3(0, -150, 0));
+            bullet->setAngularVelocity(btVector3(0, 0, 0));
+        }
+    }
+};
+
+static int runTrace(btTaskSchedulerNative* scheduler, const Options& options, FILE* out)
+{
+    const int numBoxes = 600;
+    const int numBullets = 40;
+    const int frames = std::max(options.iterations, 10);
+    const int maxSubSteps = 2;
+    const btScalar dt = btScalar(1) / 60;
+    const int numThreads = std::min(4, scheduler->getMaxNumThreads());
+
+    int failures = 0;
+    scheduler->setNumThreads(numThreads);
+
+    // two copies of the scene take turns, the profiler is installed only while the second one steps
+    TraceScene plain(options.seed, numBoxes, numBullets, numThreads);
+    TraceScene traced(options.seed, numBoxes, numBullets, numThreads);
+    btTraceProfiler profiler(1 << 16, frames);
+
+    // a reader graphing the last frames while the world steps, the way the Sandbox would
+    std::atomic<bool> stepping(true);
+    std::atomic<int> reads(0), tornReads(0);
+    std::thread reader([&]() {
+        std::vector<btTraceFrame> window(64);
+        while (stepping.load())
+        {
+            const int count = profiler.getFrames(&window[0], int(window.size()));
+            for (int i = 0; i < count; ++i)
+            {
+                const btTraceFrame& frame = window[i];
+                bool whole = frame.m_numTicks >= 0 && frame.m_numTicks <= maxSubSteps && frame.m_counters[BT_TRACE_PAIRS] >= 0;
+                if (i > 0) whole = whole && frame.m_index == window[i - 1].m_index + 1 && frame.m_startTime >= window[i - 1].m_startTime;
+                if (!whole) ++tornReads;
+            }
+            ++reads;
+            std::this_thread::yield();
+        }
+    });
+
+    std::vector<double> plainMs, tracedMs;
+    int counterMismatches = 0, tickMismatches = 0;
+    long long int ccdHits = 0, solverIterations = 0, islands = 0;
+    unsigned int plainSeed = options.seed, tracedSeed = options.seed;
+
+    for (int t = 0; t < frames; ++t)
+    {
+        if (t % 30 == 0)
+        {
+            plain.fire(plainSeed);
+            traced.fire(tracedSeed);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        plain.world.stepSimulation(dt * maxSubSteps, maxSubSteps, dt);
+        plainMs.push_back(elapsedMs(start));
+
+        btTraceProfiler::install(&profiler);
+        start = std::chrono::steady_clock::now();
+        const int numTicks = traced.world.stepSimulation(dt * maxSubSteps, maxSubSteps, dt);
+        tracedMs.push_back(elapsedMs(start));
+        btTraceProfiler::install(nullptr);
+
+        // the frame has to describe the world as the step left it
+        btTraceFrame frame;
+        if (profiler.getFrames(&frame, 1) != 1 || frame.m_index != (unsigned long long int)t)
+        {
+            ++counterMismatches;
+            continue;
+        }
+        if (frame.m_numTicks != numTicks) ++tickMismatches;
+
+        btDispatcher* dispatcher = traced.world.getDispatcher();
+        int contactPoints = 0;
+        for (int i = 0; i < dispatcher->getNumManifolds(); ++i)
+        {
+            contactPoints += dispatcher->getManifoldByIndexInternal(i)->getNumContacts();
+        }
+        if (frame.m_counters[BT_TRACE_PAIRS] != traced.world.getPairCache()->getNumOverlappingPairs() ||
+            frame.m_counters[BT_TRACE_MANIFOLDS] != dispatcher->getNumManifolds() ||
+            frame.m_counters[BT_TRACE_CONTACT_POINTS] != contactPoints)
+        {
+            ++counterMismatches;
+        }
+        ccdHits += frame.m_counters[BT_TRACE_CCD_HITS];
+        solverIterations += frame.m_counters[BT_TRACE_SOLVER_ITERATIONS];
+        islands += frame.m_counters[BT_TRACE_ISLANDS];
+    }
+
+    stepping = false;
+    reader.join();
+
+    btAlignedObjectArray<char> trace;
+    profiler.exportChromeTrace(trace);
+    trace.push_back(0);
+
+    // every frame is one stepSimulation zone, and workers show up as threads of their own
+    int stepZones = 0;
+    std::set<std::string> threads;
+    for (const char* c = &trace[0]; (c = strstr(c, "\"name\":\"")) != nullptr; ++c)
+    {
+        if (strncmp(c, "\"name\":\"stepSimulation\"", 23) == 0) ++stepZones;
+        if (strncmp(c, "\"name\":\"Bullet thread ", 22) == 0) threads.insert(std::string(c + 22, strchr(c + 22, '"')));
+    }
+
+    if (counterMismatches || tickMismatches || tornReads) ++failures;
+    if (stepZones != frames) ++failures;
+    if (ccdHits == 0 || solverIterations == 0 || islands == 0) ++failures;
+
+    const double plainP50 = percentile(plainMs, 50);
+    const double tracedP50 = percentile(tracedMs, 50);
+
+    fprintf(out, "  \"trace\": {\n");
+    fprintf(out, "    \"bodies\": %d,\n", numBoxes + numBullets);
+    fprintf(out, "    \"threads\": %d,\n", numThreads);
+    fprintf(out, "    \"frames\": %d,\n", frames);
+    fprintf(out, "    \"step_ms_p50\": %.3f,\n", plainP50);
+    fprintf(out, "    \"traced_step_ms_p50\": %.3f,\n", tracedP50);
+    fprintf(out, "    \"overhead_percent\": %.1f,\n", plainP50 > 0 ? (tracedP50 / plainP50 - 1) * 100 : 0);
+    fprintf(out, "    \"trace_bytes\": %d,\n", trace.size() - 1);
+    fprintf(out, "    \"trace_threads\": %d,\n", int(threads.size()));
+    fprintf(out, "    \"step_zones\": %d,\n", stepZones);
+    fprintf(out, "    \"islands\": %lld,\n", islands);
+    fprintf(out, "    \"solver_iterations\": %lld,\n", solverIterations);
+    fprintf(out, "    \"ccd_hits\": %lld,\n", ccdHits);
+    fprintf(out, "    \"reader_polls\": %d,\n", reads.load());
+    fprintf(out, "    \"torn_reads\": %d,\n", tornReads.load());
+    fprintf(out, "    \"counter_mismatches\": %d,\n", counterMismatches);
+    fprintf(out, "    \"tick_mismatches\": %d,\n", tickMismatches);
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Memory
+
+// A pile of boxes, spheres, capsules and two-part compounds on a floor, stepped by either world
+struct MemoryScene
+{
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher* dispatcher;
+    btDbvtBroadphase broadphase;
+    btSequentialImpulseConstraintSolver solver;
+    btConstraintSolverPoolMt* solverPool;
+    btDiscreteDynamicsWorld* world;
+    btBoxShape groundShape;
+    btBoxShape boxShape;
+    btSphereShape sphereShape;
+    btCapsuleShape capsuleShape;
+    btCompoundShape compoundShape;
+    btRigidBody ground;
+    std::vector<btRigidBody*> bodies;
+    std::vector<btRigidBody*> compounds;
+
+    MemoryScene(unsigned int seed, int numBodies, int numThreads)
+    : groundShape(btVector3(50, 1, 50)),
+      boxShape(btVector3(0.5, 0.5, 0.5)),
+      sphereShape(0.5),
+      capsuleShape(0.3, 1),
+      ground(0, nullptr, &groundShape)
+    {
+        if (numThreads > 1)
+        {
+            dispatcher = new btCollisionDispatcherMt(&configuration);
+            solverPool = new btConstraintSolverPoolMt(numThreads);
+            world = new btDiscreteDynamicsWorldMt(dispatcher, &broadphase, solverPool, &configuration);
+        }
+        else
+        {
+            dispatcher = new btCollisionDispatcher(&configuration);
+            solverPool = nullptr;
+            world = new btDiscreteDynamicsWorld(dispatcher, &broadphase, &solver, &configuration);
+        }
+
+        btTransform child = btTransform::getIdentity();
+        child.setOrigin(btVector3(0.5, 0, 0));
+        compoundShape.addChildShape(child, &boxShape);
+        child.setOrigin(btVector3(-0.5, 0, 0));
+        compoundShape.addChildShape(child, &sphereShape);
+
+        ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+        world->addRigidBody(&ground);
+
+        btCollisionShape* shapes[] = { &boxShape, &sphereShape, &capsuleShape, &compoundShape };
+
+        for (int i = 0; i < numBodies; ++i)
+        {
+            btCollisionShape* shape = shapes[i % 4];
+            btVector3 inertia;
+            shape->calculateLocalInertia(1, inertia);
+
+            btRigidBody* body = new btRigidBody(1, nullptr, shape, inertia);
+            body->getWorldTransform().setOrigin(btVector3(randomUnit(seed) * 10, 1 + btFabs(randomUnit(seed)) * 20, randomUnit(seed) * 10));
+            // awake bodies keep their pairs coming and going, which is where a steady tick still allocates
+            body->setActivationState(DISABLE_DEACTIVATION);
+            bodies.push_back(body);
+            if (shape == &compoundShape) compounds.push_back(body);
+            world->addRigidBody(body);
+        }
+    }
+
+    ~MemoryScene()
+    {
+        for (btRigidBody* body : bodies)
+        {
+            world->removeRigidBody(body);
+            delete body;
+        }
+        world->removeRigidBody(&ground);
+
+        delete world;
+        delete solverPool;
+        delete dispatcher;
+    }
+
+    // the queries a game makes between steps: line of sight rays, a few sweeps and overlap tests of compound bodies
+    int query(int frame)
+    {
+        for (int i = 0; i < 20; ++i)
+        {
+            const btVector3 from(btScalar(i - 10), 25, btScalar(frame % 7 - 3));
+            const btVector3 to(btScalar(i - 10), -5, btScalar(frame % 7 - 3));
+            btCollisionWorld::ClosestRayResultCallback callback(from, to);
+            world->rayTest(from, to, callback);
+        }
+        for (int i = 0; i < 10; ++i)
+        {
+            btTransform from = btTransform::getIdentity(), to = btTransform::getIdentity();
+            from.setOrigin(btVector3(btScalar(i - 5), 25, 1));
+            to.setOrigin(btVector3(btScalar(i - 5), -5, 1));
+            btCollisionWorld::ClosestConvexResultCallback callback(from.getOrigin(), to.getOrigin());
+            world->convexSweepTest(&sphereShape, from, to, callback);
+        }
+
+        CountContacts contacts;
+        for (int i = 0; i < 10; ++i)
+        {
+            world->contactTest(compounds[(frame * 10 + i) % compounds.size()], contacts);
+        }
+        return contacts.count;
+    }
+};
+
+struct MemoryTotals
+{
+    long long int allocations[btMemoryTracker::MAX_TAGS] = {};
+    long long int mallocs[btMemoryTracker::MAX_TAGS] = {};
+
+    // adds the frame just closed
+    void add()
+    {
+        btMemoryTracker::nextFrame();
+        for (int tag = 0; tag < btMemoryTracker::getNumTags(); ++tag)
+        {
+            btMemoryTagStats stats;
+            btMemoryTracker::getStats(tag, stats);
+            allocations[tag] += stats.m_frameAllocations;
+            mallocs[tag] += stats.m_frameMallocs;
+        }
+    }
+
+    long long int totalMallocs() const
+    {
+        long long int total = 0;
+        for (int tag = 0; tag < btMemoryTracker::MAX_TAGS; ++tag) total += mallocs[tag];
+        return total;
+    }
+};
+
+static void liveBytes(long long int* bytes)
+{
+    for (int tag = 0; tag < btMemoryTracker::getNumTags(); ++tag)
+    {
+        btMemoryTagStats stats;
+        btMemoryTracker::getStats(tag, stats);
+        bytes[tag] = stats.m_liveBytes;
+    }
+}
+
+static int runMemoryScene(const char* name, int numThreads, const Options& options, FILE* out)
+{
+    const int numBodies = 300;
+    const int settleFrames = 300;
+    const int frames = std::max(options.iterations, 20);
+    const int warmupFrames = 5;
+    const btScalar dt = btScalar(1) / 60;
+
+    int failures = 0;
+
+    long long int liveBefore[btMemoryTracker::MAX_TAGS] = {};
+    liveBytes(liveBefore);
+
+    MemoryTotals steady, plainQueries, arenaQueries;
+    std::vector<double> plainMs, arenaMs;
+    int contactMismatches = 0;
+    long long int arenaWarmupMallocs = 0;
+    btMemoryTagStats tagStats[btMemoryTracker::MAX_TAGS];
+
+    {
+        MemoryScene scene(options.seed, numBodies, numThreads);
+
+        for (int t = 0; t < settleFrames; ++t)
+        {
+            scene.world->stepSimulation(dt, 1, dt);
+        }
+        btMemoryTracker::nextFrame();
+
+        for (int t = 0; t < frames; ++t)
+        {
+            scene.world->stepSimulation(dt, 1, dt);
+            steady.add();
+
+            // the same queries against the same state, with temporaries from malloc and from the arena
+            btMemoryTracker::setArenaEnabled(false);
+            auto start = std::chrono::steady_clock::now();
+            const int plainContacts = scene.query(t);
+            plainMs.push_back(elapsedMs(start));
+            plainQueries.add();
+
+            btMemoryTracker::setArenaEnabled(true);
+            start = std::chrono::steady_clock::now();
+            const int arenaContacts = scene.query(t);
+            arenaMs.push_back(elapsedMs(start));
+            btMemoryTracker::setArenaEnabled(false);
+
+            // the first frames make the chunks
+            if (t < warmupFrames)
+            {
+                MemoryTotals warmup;
+                warmup.add();
+                arenaWarmupMallocs += warmup.totalMallocs();
+            }
+            else
+            {
+                arenaQueries.add();
+            }
+
+            if (plainContacts != arenaContacts) ++contactMismatches;
+        }
+
+        for (int tag = 0; tag < btMemoryTracker::getNumTags(); ++tag)
+        {
+            btMemoryTracker::getStats(tag, tagStats[tag]);
+        }
+    }
+
+    // every block of the scene has to be accounted back to its tag
+    long long int liveAfter[btMemoryTracker::MAX_TAGS] = {};
+    liveBytes(liveAfter);
+    int leakedTags = 0;
+    for (int tag = 0; tag < btMemoryTracker::getNumTags(); ++tag)
+    {
+        if (liveAfter[tag] != liveBefore[tag]) ++leakedTags;
+    }
+
+    const long long int queryTag = BT_MEMORY_QUERIES;
+    if (contactMismatches || leakedTags) ++failures;
+    if (arenaQueries.mallocs[queryTag] != 0) ++failures;
+    if (plainQueries.allocations[queryTag] == 0) ++failures;
+
+    fprintf(out, "    \"%s\": {\n", name);
+    fprintf(out, "      \"threads\": %d,\n", numThreads);
+    fprintf(out, "      \"tags\": {\n");
+    for (int tag = 0; tag < BT_MEMORY_NUM_BUILTIN_TAGS; ++tag)
+    {
+        fprintf(out, "        \"%s\": { \"live_bytes\": %lld, \"peak_bytes\": %lld, \"tick_allocations\": %.2f, \"tick_mallocs\": %.2f }%s\n",
+                btMemoryTracker::getTagName(tag), tagStats[tag].m_liveBytes, tagStats[tag].m_peakBytes,
+                double(steady.allocations[tag]) / frames, double(steady.mallocs[tag]) / frames,
+                tag + 1 < BT_MEMORY_NUM_BUILTIN_TAGS ? "," : "");
+    }
+    fprintf(out, "      },\n");
+    fprintf(out, "      \"tick_mallocs\": %.2f,\n", double(steady.totalMallocs()) / frames);
+    fprintf(out, "      \"query_allocations_per_frame\": %.1f,\n", double(plainQueries.allocations[queryTag]) / frames);
+    fprintf(out, "      \"query_mallocs_per_frame\": %.1f,\n", double(plainQueries.totalMallocs()) / frames);
+    fprintf(out, "      \"arena_query_mallocs_per_frame\": %.2f,\n", double(arenaQueries.totalMallocs()) / (frames - warmupFrames));
+    fprintf(out, "      \"arena_warmup_mallocs\": %lld,\n", arenaWarmupMallocs);
+    fprintf(out, "      \"query_ms_p50\": %.3f,\n", percentile(plainMs, 50));
+    fprintf(out, "      \"arena_query_ms_p50\": %.3f,\n", percentile(arenaMs, 50));
+    fprintf(out, "      \"contact_mismatches\": %d,\n", contactMismatches);
+    fprintf(out, "      \"leaked_tags\": %d,\n", leakedTags);
+    fprintf(out, "      \"failures\": %d\n", failures);
+    fprintf(out, "    }");
+
+    return failures;
+}
+
+static int runMemory(btTaskSchedulerNative* scheduler, const Options& options, FILE* out)
+{
+    int failures = 0;
+
+    fprintf(out, "  \"memory\": {\n");
+
+    // main installs the tracker before anything is allocated, this fails only when it couldn't
+    if (!btMemoryTracker::isInstalled())
+    {
+        fprintf(out, "    \"installed\": false,\n");
+        fprintf(out, "    \"failures\": 1\n");
+        fprintf(out, "  }");
+        return 1;
+    }
+
+    const int numThreads = std::min(4, scheduler->getMaxNumThreads());
+    scheduler->setNumThreads(numThreads);
+
+    fprintf(out, "    \"installed\": true,\n");
+    failures += runMemoryScene("single", 1, options, out);
+    fprintf(out, ",\n");
+    failures += runMemoryScene("multithreaded", std::max(numThreads, 2), options, out);
+    fprintf(out, ",\n");
+    fprintf(out, "    \"arena_reserved_bytes\": %lld,\n", btMemoryTracker::getArenaReservedBytes());
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Hitboxes
+
+// Skeleton of a studio model: bone 0 is the pelvis, every other bone hangs off an earlier one
+struct HitboxSkeleton
+{
+    std::vector<int> parents;
+    std::vector<btTransform> rest;
+    std::vector<btHitbox> hitboxes;
+};
+
+static HitboxSkeleton makeSkeleton(unsigned int& state, int numBones)
+{
+    HitboxSkeleton skeleton;
+
+    for (int i = 0; i < numBones; ++i)
+    {
+        int parent = i == 0 ? -1 : int(seededRand(state) % unsigned(i));
+        skeleton.parents.push_back(parent);
+
+        btTransform local;
+        local.setIdentity();
+        local.setOrigin(i == 0 ? btVector3(0, 0, 40) : btVector3(randomUnit(state) * 4, randomUnit(state) * 4, randomUnit(state) * 8));
+        skeleton.rest.push_back(local);
+
+        // a box along the bone, like the limbs of a GoldSrc model
+        btHitbox hitbox;
+        hitbox.m_bone = i;
+        hitbox.m_group = i % 8;
+        hitbox.m_min = btVector3(-1 - btFabs(randomUnit(state)) * 2, -1 - btFabs(randomUnit(state)) * 2, -1);
+        hitbox.m_max = btVector3(2 + btFabs(randomUnit(state)) * 6, 1 + btFabs(randomUnit(state)) * 2, 1 + btFabs(randomUnit(state)));
+        skeleton.hitboxes.push_back(hitbox);
+    }
+
+    return skeleton;
+}
+
+// Model space bone transforms, every bone swung around its rest pose by phase
+static void poseSkeleton(const HitboxSkeleton& skeleton, btScalar phase, btTransform* bones)
+{
+    for (size_t i = 0; i < skeleton.parents.size(); ++i)
+    {
+        btTransform local = skeleton.rest[i];
+        local.setRotation(btQuaternion(btVector3(btScalar(0.3), btScalar(0.5), 1).normalized(), btSin(phase + i) * btScalar(0.6)));
+
+        int parent = skeleton.parents[i];
+        bones[i] = parent < 0 ? local : bones[parent] * local;
+    }
+}
+
+// Slab test in the space of the box, independent of the batched one
+static bool rayBox(const btTransform& boxTransform, const btVector3& min, const btVector3& max, const btVector3& from, const btVector3& to, btScalar& fraction)
+{
+    btTransform inverse = boxTransform.inverse();
+    btVector3 localFrom = inverse(from);
+    btVector3 localTo = inverse(to);
+
+    btScalar lambda = btScalar(1.);
+    btVector3 normal;
+    if (btRayAabb(localFrom, localTo, min, max, lambda, normal))
+    {
+        fraction = lambda;
+        return true;
+    }
+
+    // btRayAabb misses rays starting inside
+    if (localFrom.x() >= min.x() && localFrom.y() >= min.y() && localFrom.z() >= min.z() &&
+        localFrom.x() <= max.x() && localFrom.y() <= max.y() && localFrom.z() <= max.z())
+    {
+        fraction = 0;
+        return true;
+    }
+
+    return false;
+}
+
+static int runHitboxes(const Options& options, FILE* out)
+{
+    const int counts[] = { 16, 64, 256, 1024 };
+    const int numBones = 20;
+    const int numRays = std::max(options.iterations, 1) * 10;
+    const int frames = 5;
+
+    unsigned int state = options.seed;
+    int failures = 0;
+
+    HitboxSkeleton skeleton = makeSkeleton(state, numBones);
+    std::vector<btTransform> bones(numBones);
+
+    // the box the scene used to test, large enough for every pose
+    const btVector3 entityMin(-30, -30, 0);
+    const btVector3 entityMax(30, 30, 80);
+
+    fprintf(out, "  \"hitboxes\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"hitboxes_per_entity\": %d,\n", numBones);
+    fprintf(out, "    \"rays\": %d,\n", numRays);
+    fprintf(out, "    \"runs\": [\n");
+
+    for (int c = 0; c < 4; ++c)
+    {
+        const int numEntities = counts[c];
+        const btScalar arena = btSqrt(btScalar(numEntities)) * 120;
+
+        btHitboxWorld world(btScalar(4.));
+        int model = world.addModel(&skeleton.hitboxes[0], numBones);
+
+        std::vector<int> entities;
+        std::vector<btTransform> placements;
+        for (int i = 0; i < numEntities; ++i)
+        {
+            entities.push_back(world.addEntity(model));
+
+            btTransform placement;
+            placement.setIdentity();
+            placement.setOrigin(btVector3(randomUnit(state) * arena, randomUnit(state) * arena, 0));
+            placement.setRotation(btQuaternion(btVector3(0, 0, 1), randomUnit(state) * SIMD_PI));
+            placements.push_back(placement);
+        }
+
+        // shots across the arena at standing height, some of them straight down
+        btAlignedObjectArray<btVector3> from;
+        btAlignedObjectArray<btVector3> to;
+        for (int i = 0; i < numRays; ++i)
+        {
+            btVector3 start(randomUnit(state) * arena, randomUnit(state) * arena, 20 + btFabs(randomUnit(state)) * 50);
+            btVector3 end = i % 8 == 0
+                ? btVector3(start.x() + randomUnit(state) * 40, start.y() + randomUnit(state) * 40, -10)
+                : btVector3(randomUnit(state) * arena, randomUnit(state) * arena, btFabs(randomUnit(state)) * 80);
+            from.push_back(start);
+            to.push_back(end);
+        }
+
+        std::vector<btTransform> posed(size_t(numEntities) * numBones);
+        std::vector<double> poseTimes, aabbTimes, bruteTimes, hitboxTimes;
+        int mismatches = 0;
+        int hits = 0;
+        int aabbHits = 0;
+
+        for (int f = 0; f < frames; ++f)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < numEntities; ++i)
+            {
+                poseSkeleton(skeleton, btScalar(f) * btScalar(0.1) + btScalar(i), &bones[0]);
+                world.setPose(entities[i], placements[i], &bones[0], numBones);
+                for (int b = 0; b < numBones; ++b) posed[size_t(i) * numBones + b] = placements[i] * bones[b];
+            }
+            poseTimes.push_back(elapsedMs(start));
+
+            // what makeShoot did: one box per entity, every entity
+            start = std::chrono::steady_clock::now();
+            int frameAabbHits = 0;
+            for (int r = 0; r < numRays; ++r)
+            {
+                btScalar best = 1;
+                int closest = -1;
+                for (int i = 0; i < numEntities; ++i)
+                {
+                    btScalar lambda = best;
+                    btVector3 normal;
+                    const btVector3& origin = placements[i].getOrigin();
+                    if (btRayAabb(from[r], to[r], origin + entityMin, origin + entityMax, lambda, normal) && lambda < best)
+                    {
+                        best = lambda;
+                        closest = i;
+                    }
+                }
+                if (closest >= 0) ++frameAabbHits;
+            }
+            aabbTimes.push_back(elapsedMs(start));
+            aabbHits = frameAabbHits;
+
+            std::vector<btScalar> bruteFractions(numRays, 1);
+            std::vector<int> bruteHitboxes(numRays, -1);
+
+            start = std::chrono::steady_clock::now();
+            for (int r = 0; r < numRays; ++r)
+            {
+                for (int i = 0; i < numEntities; ++i)
+                {
+                    for (int b = 0; b < numBones; ++b)
+                    {
+                        btScalar fraction;
+                        const btHitbox& hitbox = skeleton.hitboxes[b];
+                        if (rayBox(posed[size_t(i) * numBones + hitbox.m_bone], hitbox.m_min, hitbox.m_max, from[r], to[r], fraction) && fraction < bruteFractions[r])
+                        {
+                            bruteFractions[r] = fraction;
+                            bruteHitboxes[r] = i * numBones + b;
+                        }
+                    }
+                }
+            }
+            bruteTimes.push_back(elapsedMs(start));
+
+            std::vector<btHitboxWorld::RayResult> results(numRays);
+            start = std::chrono::steady_clock::now();
+            for (int r = 0; r < numRays; ++r)
+            {
+                world.rayTest(from[r], to[r], results[r]);
+            }
+            hitboxTimes.push_back(elapsedMs(start));
+
+            hits = 0;
+            for (int r = 0; r < numRays; ++r)
+            {
+                const btHitboxWorld::RayResult& result = results[r];
+                int found = result.m_entity < 0 ? -1 : result.m_entity * numBones + result.m_hitbox;
+                if (found >= 0) ++hits;
+
+                // two boxes entered at the same fraction may come out either way
+                bool same = found == bruteHitboxes[r] ||
+                    (found >= 0 && bruteHitboxes[r] >= 0 && btFabs(result.m_fraction - bruteFractions[r]) < btScalar(1e-4));
+                if (!same) ++mismatches;
+            }
+        }
+
+        if (mismatches > 0) ++failures;
+
+        double poseP50 = percentile(poseTimes, 50);
+        double aabbP50 = percentile(aabbTimes, 50);
+        double bruteP50 = percentile(bruteTimes, 50);
+        double hitboxP50 = percentile(hitboxTimes, 50);
+
+        fprintf(out, "      {\n");
+        fprintf(out, "        \"entities\": %d,\n", numEntities);
+        fprintf(out, "        \"pose_us_per_entity\": %.2f,\n", poseP50 * 1e3 / numEntities);
+        fprintf(out, "        \"entity_aabb_scan_ns_per_ray\": %.1f,\n", aabbP50 * 1e6 / numRays);
+        fprintf(out, "        \"hitbox_scan_ns_per_ray\": %.1f,\n", bruteP50 * 1e6 / numRays);
+        fprintf(out, "        \"hitbox_world_ns_per_ray\": %.1f,\n", hitboxP50 * 1e6 / numRays);
+        fprintf(out, "        \"speedup_over_aabb_scan\": %.2f,\n", hitboxP50 > 0 ? aabbP50 / hitboxP50 : 0.0);
+        fprintf(out, "        \"entity_aabb_hits\": %d,\n", aabbHits);
+        fprintf(out, "        \"hitbox_hits\": %d,\n", hits);
+        fprintf(out, "        \"mismatches\": %d\n", mismatches);
+        fprintf(out, "      }%s\n", c == 3 ? "" : ",");
+    }
+
+    fprintf(out, "    ],\n");
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Characters
+
+// Added first and last to the world's actions, so the time between them is the time spent in every controller
+struct ActionTimer : public btActionInterface
+{
+    std::chrono::steady_clock::time_point* start;
+    double* elapsed;
+    bool isStart;
+
+    virtual void updateAction(btCollisionWorld*, btScalar)
+    {
+        if (isStart) *start = std::chrono::steady_clock::now();
+        else *elapsed += elapsedMs(*start);
+    }
+
+    virtual void debugDraw(btIDebugDraw*)
+    {
+    }
+};
+
+struct CharacterScene
+{
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher;
+    btDbvtBroadphase broadphase;
+    btSequentialImpulseConstraintSolver solver;
+    btDiscreteDynamicsWorld world;
+
+    btBoxShape groundShape;
+    btBoxShape stepShape;
+    btBoxShape crateShape;
+    btCapsuleShapeZ capsuleShape;
+
+    std::vector<btRigidBody*> statics;
+    std::vector<btRigidBody*> bodies;
+    std::vector<DynamicCharacterController*> controllers;
+    DynamicCharacterGroup group;
+    bool grouped;
+
+    std::chrono::steady_clock::time_point actionsStart;
+    double actionsMs = 0;
+    ActionTimer first, last;
+
+    CharacterScene(unsigned int seed, int numControllers, bool useManifolds, bool grouped = false)
+        : dispatcher(&configuration),
+          world(&dispatcher, &broadphase, &solver, &configuration),
+          groundShape(btVector3(40, 40, 1)),
+          stepShape(btVector3(1, 1, btScalar(0.1))),
+          crateShape(btVector3(btScalar(0.5), btScalar(0.5), btScalar(0.5))),
+          capsuleShape(btScalar(0.3), btScalar(1.0)),
+          grouped(grouped)
+    {
+        world.setGravity(btVector3(0, 0, btScalar(-9.81)));
+
+        auto addStatic = [&](btCollisionShape* shape, const btVector3& origin)
+        {
+            btRigidBody* body = new btRigidBody(0, nullptr, shape);
+            body->getWorldTransform().setOrigin(origin);
+            world.addRigidBody(body);
+            statics.push_back(body);
+        };
+
+        addStatic(&groundShape, btVector3(0, 0, -1));
+
+        // stairs of 20cm steps and crates the characters have to walk around
+        unsigned int state = seed;
+        for (int i = 0; i < 40; ++i)
+        {
+            btVector3 origin(randomUnit(state) * 20, randomUnit(state) * 20, 0);
+            for (int s = 0; s < 3; ++s)
+            {
+                addStatic(&stepShape, origin + btVector3(btScalar(0.6) * s, 0, btScalar(0.1) + btScalar(0.2) * s));
+            }
+            addStatic(&crateShape, btVector3(randomUnit(state) * 20, randomUnit(state) * 20, btScalar(0.5)));
+        }
+
+        btVector3 inertia(0, 0, 0);
+        const int side = int(btSqrt(btScalar(numControllers)) + btScalar(0.5));
+        for (int i = 0; i < numControllers; ++i)
+        {
+            btTransform start = btTransform::getIdentity();
+            start.setOrigin(btVector3((i % side) * 2 - side + 1, (i / side) * 2 - side + 1, btScalar(1.4)));
+
+            btRigidBody* body = new btRigidBody(70, new btDefaultMotionState(start), &capsuleShape, inertia);
+            world.addRigidBody(body);
+            bodies.push_back(body);
+
+            DynamicCharacterController* controller = new DynamicCharacterController(body, &capsuleShape);
+            controller->mUseManifolds = useManifolds;
+            controllers.push_back(controller);
+        }
+
+        first.start = last.start = &actionsStart;
+        first.elapsed = last.elapsed = &actionsMs;
+        first.isStart = true;
+        last.isStart = false;
+
+        world.addAction(&first);
+        if (grouped)
+        {
+            for (DynamicCharacterController* controller : controllers) group.addController(controller);
+            world.addAction(&group);
+        }
+        else
+        {
+            for (DynamicCharacterController* controller : controllers) world.addAction(controller);
+        }
+        world.addAction(&last);
+    }
+
+    ~CharacterScene()
+    {
+        world.removeAction(&first);
+        world.removeAction(&last);
+        world.removeAction(&group);
+        for (size_t i = 0; i < controllers.size(); ++i)
+        {
+            if (!grouped) world.removeAction(controllers[i]);
+            delete controllers[i];
+            world.removeRigidBody(bodies[i]);
+            delete bodies[i]->getMotionState();
+            delete bodies[i];
+        }
+        for (btRigidBody* body : statics)
+        {
+            world.removeRigidBody(body);
+            delete body;
+        }
+    }
+
+    // Every controller walks a new random way every second
+    void walk(unsigned int& state, int tick)
+    {
+        if (tick % 60 != 0) return;
+
+        for (DynamicCharacterController* controller : controllers)
+        {
+            controller->setMovementDirection(btVector3(randomUnit(state), randomUnit(state), 0));
+            if (tick % 240 == 120) controller->jump();
+        }
+    }
+};
+
+static int runCharacters(const Options& options, FILE* out)
+{
+    const int numControllers = 64;
+    const int ticks = std::max(options.iterations, 60) * 3;
+    const btScalar dt = btScalar(1) / 60;
+
+    int failures = 0;
+
+    CharacterScene contactTests(options.seed, numControllers, false);
+    CharacterScene manifolds(options.seed, numControllers, true);
+
+    unsigned int walkState[2] = { options.seed, options.seed };
+    double stepMs[2] = { 0, 0 };
+    long long onGround[2] = { 0, 0 };
+    long long comparedTicks = 0;
+    long long groundMismatches = 0;
+    btScalar maxDistance = 0;
+
+    for (int t = 0; t < ticks; ++t)
+    {
+        CharacterScene* scenes[2] = { &contactTests, &manifolds };
+        for (int s = 0; s < 2; ++s)
+        {
+            scenes[s]->walk(walkState[s], t);
+
+            auto start = std::chrono::steady_clock::now();
+            scenes[s]->world.stepSimulation(dt, 1, dt);
+            stepMs[s] += elapsedMs(start);
+        }
+
+        for (int i = 0; i < numControllers; ++i)
+        {
+            bool a = contactTests.controllers[i]->canJump();
+            bool b = manifolds.controllers[i]->canJump();
+            onGround[0] += a;
+            onGround[1] += b;
+
+            // Small differences add up until the two walk elsewhere, only compare while they are together
+            btScalar distance = contactTests.bodies[i]->getWorldTransform().getOrigin().distance(manifolds.bodies[i]->getWorldTransform().getOrigin());
+            maxDistance = btMax(maxDistance, distance);
+            if (distance < btScalar(0.01))
+            {
+                ++comparedTicks;
+                if (a != b) ++groundMismatches;
+            }
+        }
+    }
+
+    // The manifold points are moved to where contactTest finds them, so both have to agree on the ground
+    // nearly every tick they are compared, and as often over the whole run
+    const long long controllerTicks = (long long) ticks * numControllers;
+    const bool groundParity = groundMismatches * 100 <= comparedTicks && std::abs(onGround[0] - onGround[1]) * 50 <= controllerTicks;
+    if (!groundParity) ++failures;
+
+    fprintf(out, "  \"characters\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"controllers\": %d,\n", numControllers);
+    fprintf(out, "    \"ticks\": %d,\n", ticks);
+    fprintf(out, "    \"contact_test\": { \"actions_us_per_tick\": %.1f, \"step_ms_per_tick\": %.3f, \"on_ground\": %.3f },\n",
+            contactTests.actionsMs * 1e3 / ticks, stepMs[0] / ticks, double(onGround[0]) / controllerTicks);
+    fprintf(out, "    \"manifolds\": { \"actions_us_per_tick\": %.1f, \"step_ms_per_tick\": %.3f, \"on_ground\": %.3f },\n",
+            manifolds.actionsMs * 1e3 / ticks, stepMs[1] / ticks, double(onGround[1]) / controllerTicks);
+    fprintf(out, "    \"actions_speedup\": %.2f,\n", manifolds.actionsMs > 0 ? contactTests.actionsMs / manifolds.actionsMs : 0.0);
+    fprintf(out, "    \"compared_ticks\": %lld,\n", comparedTicks);
+    fprintf(out, "    \"ground_mismatches\": %lld,\n", groundMismatches);
+    fprintf(out, "    \"max_position_difference\": %.4f,\n", double(maxDistance));
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Crowd
+
+// Bit for bit, as the group has to move every character where it moves alone
+static int countCrowdMismatches(const CharacterScene& expected, const CharacterScene& scene)
+{
+    int mismatches = 0;
+    for (size_t i = 0; i < expected.bodies.size(); ++i)
+    {
+        const btRigidBody* a = expected.bodies[i];
+        const btRigidBody* b = scene.bodies[i];
+        if (memcmp(&a->getWorldTransform(), &b->getWorldTransform(), sizeof(btTransform)) != 0 ||
+            memcmp(&a->getLinearVelocity(), &b->getLinearVelocity(), sizeof(btVector3)) != 0 ||
+            expected.controllers[i]->canJump() != scene.controllers[i]->canJump())
+        {
+            ++mismatches;
+        }
+    }
+    return mismatches;
+}
+
+static int runCrowd(btTaskSchedulerNative* scheduler, const Options& options, FILE* out)
+{
+    const int crowdSizes[] = { 256, 1024 };
+    const int threadCounts[] = { 1, 2, 4, 8 };
+    const int ticks = std::max(options.iterations, 60);
+    const btScalar dt = btScalar(1) / 60;
+
+    int failures = 0;
+
+    fprintf(out, "  \"crowd\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"ticks\": %d,\n", ticks);
+    fprintf(out, "    \"max_threads\": %d,\n", scheduler->getMaxNumThreads());
+    fprintf(out, "    \"runs\": [\n");
+
+    for (int c = 0; c < 2; ++c)
+    {
+        const int numControllers = crowdSizes[c];
+
+        // One action per character, as the characters mode steps them
+        scheduler->setNumThreads(1);
+        CharacterScene expected(options.seed, numControllers, false);
+        unsigned int expectedState = options.seed;
+        double expectedStepMs = 0;
+        for (int t = 0; t < ticks; ++t)
+        {
+            expected.walk(expectedState, t);
+            auto start = std::chrono::steady_clock::now();
+            expected.world.stepSimulation(dt, 1, dt);
+            expectedStepMs += elapsedMs(start);
+        }
+
+        for (int t = 0; t < 4; ++t)
+        {
+            scheduler->setNumThreads(threadCounts[t]);
+            scheduler->setSpinCount(10000);
+
+            CharacterScene scene(options.seed, numControllers, false, true);
+            unsigned int state = options.seed;
+            double stepMs = 0;
+            for (int i = 0; i < ticks; ++i)
+            {
+                scene.walk(state, i);
+                auto start = std::chrono::steady_clock::now();
+                scene.world.stepSimulation(dt, 1, dt);
+                stepMs += elapsedMs(start);
+            }
+
+            const int mismatches = countCrowdMismatches(expected, scene);
+            if (mismatches > 0) ++failures;
+
+            fprintf(out, "      {\n");
+            fprintf(out, "        \"controllers\": %d,\n", numControllers);
+            fprintf(out, "        \"threads\": %d,\n", scheduler->getNumThreads());
+            fprintf(out, "        \"actions_us_per_tick\": %.1f,\n", expected.actionsMs * 1e3 / ticks);
+            fprintf(out, "        \"group_us_per_tick\": %.1f,\n", scene.actionsMs * 1e3 / ticks);
+            fprintf(out, "        \"step_ms_per_tick\": %.3f,\n", expectedStepMs / ticks);
+            fprintf(out, "        \"group_step_ms_per_tick\": %.3f,\n", stepMs / ticks);
+            fprintf(out, "        \"speedup\": %.2f,\n", scene.actionsMs > 0 ? expected.actionsMs / scene.actionsMs : 0.0);
+            fprintf(out, "        \"mismatches\": %d\n", mismatches);
+            fprintf(out, "      }%s\n", c == 1 && t == 3 ? "" : ",");
+        }
+    }
+
+    scheduler->setNumThreads(1);
+
+    fprintf(out, "    ],\n");
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Bake
+
+struct BrushIndices : public btStaticBrushCallback
+{
+    std::vector<int> indices;
+    void processBrush(int brushIndex) override { indices.push_back(brushIndex); }
+};
+
+// Map-like brush set: boxes cut by a slanted plane, and every 8th brush a hull of many points like a curved brush
+static btStaticBrushSetShape* buildBrushSet(unsigned int state, int count, std::vector<btPolyhedralConvexShape*>& brushes)
+{
+    btScalar extent = btSqrt(btScalar(count)) * 4;
+    btStaticBrushSetShape* brushSet = new btStaticBrushSetShape();
+
+    for (int i = 0; i < count; ++i)
+    {
+        btVector3 center(-extent + 2 * extent * i / count, randomUnit(state) * extent, btFabs(randomUnit(state)) * 20);
+        btPolyhedralConvexShape* brush;
+
+        if (i % 8 == 7)
+        {
+            btAlignedObjectArray<btVector3> points = brushPoints(state, i % 16 == 15 ? 24 : 80);
+            btHillClimbingConvexHullShape* hull = new btHillClimbingConvexHullShape();
+
+            for (int p = 0; p < points.size(); ++p)
+            {
+                hull->addPoint(points[p] + center);
+            }
+            if (points.size() >= 64) hull->buildAdjacency();
+
+            brush = hull;
+        }
+        else
+        {
+            btVector3 half(1 + btFabs(randomUnit(state)) * 3, 1 + btFabs(randomUnit(state)) * 3, btScalar(0.5) + btFabs(randomUnit(state)));
+            btVector3 cut(randomUnit(state), randomUnit(state), 1);
+            cut.normalize();
+
+            btVector3 planes[7];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                btVector3 normal(0, 0, 0);
+                normal[axis] = 1;
+                planes[axis * 2] = normal;
+                planes[axis * 2][3] = -center[axis] - half[axis];
+                planes[axis * 2 + 1] = -normal;
+                planes[axis * 2 + 1][3] = center[axis] - half[axis];
+            }
+            planes[6] = cut;
+            planes[6][3] = -cut.dot(center) - half.z() * btScalar(0.6);
+
+            brush = new btBrushShape(planes, 7);
+        }
+
+        brushes.push_back(brush);
+        brushSet->addBrush(brush);
+    }
+
+    brushSet->buildBvh();
+
+    return brushSet;
+}
+
+static bool sameVector(const btVector3& a, const btVector3& b)
+{
+    return a.x() == b.x() && a.y() == b.y() && a.z() == b.z();
+}
+
+// Everything the narrowphase reads from a brush: type, box, features and support points
+static int countBrushMismatches(const btStaticBrushSetShape* built, const btStaticBrushSetShape* baked, unsigned int state)
+{
+    if (built->getNumBrushes() != baked->getNumBrushes()) return built->getNumBrushes();
+
+    int mismatches = 0;
+
+    for (int i = 0; i < built->getNumBrushes(); ++i)
+    {
+        const btPolyhedralConvexShape* a = built->getBrush(i);
+        const btPolyhedralConvexShape* b = baked->getBrush(i);
+
+        bool same = a->getShapeType() == b->getShapeType() && a->getMargin() == b->getMargin() &&
+            sameVector(built->getBrushAabbMin(i), baked->getBrushAabbMin(i)) &&
+            sameVector(built->getBrushAabbMax(i), baked->getBrushAabbMax(i)) &&
+            a->getNumVertices() == b->getNumVertices() && a->getNumPlanes() == b->getNumPlanes() &&
+            (a->getConvexPolyhedron() != nullptr) == (b->getConvexPolyhedron() != nullptr);
+
+        for (int v = 0; same && v < a->getNumVertices(); ++v)
+        {
+            btVector3 va, vb;
+            a->getVertex(v, va);
+            b->getVertex(v, vb);
+            same = sameVector(va, vb);
+        }
+
+        if (same && a->getConvexPolyhedron())
+        {
+            const btConvexPolyhedron* pa = a->getConvexPolyhedron();
+            const btConvexPolyhedron* pb = b->getConvexPolyhedron();
+            same = pa->m_vertices.size() == pb->m_vertices.size() && pa->m_faces.size() == pb->m_faces.size() &&
+                pa->m_uniqueEdges.size() == pb->m_uniqueEdges.size() && pa->m_radius == pb->m_radius;
+
+            for (int f = 0; same && f < pa->m_faces.size(); ++f)
+            {
+                same = pa->m_faces[f].m_indices.size() == pb->m_faces[f].m_indices.size() &&
+                    memcmp(pa->m_faces[f].m_plane, pb->m_faces[f].m_plane, sizeof(pa->m_faces[f].m_plane)) == 0;
+            }
+        }
+
+        for (int d = 0; same && d < 8; ++d)
+        {
+            btVector3 dir(randomUnit(state), randomUnit(state), randomUnit(state));
+            same = sameVector(a->localGetSupportingVertex(dir), b->localGetSupportingVertex(dir));
+        }
+
+        if (!same) ++mismatches;
+    }
+
+    return mismatches;
+}
+
+static int runBake(const Options& options, FILE* out)
+{
+    const int brushCounts[] = { 1000, 5000, 20000 };
+    const int queries = 2000;
+
+    int failures = 0;
+
+    fprintf(out, "  \"bake\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"runs\": [\n");
+
+    for (int c = 0; c < 3; ++c)
+    {
+        int count = brushCounts[c];
+        btScalar extent = btSqrt(btScalar(count)) * 4;
+        const unsigned long long sourceHash = 0x9e3779b97f4a7c15ull + count;
+
+        std::vector<btPolyhedralConvexShape*> brushes;
+
+        auto start = std::chrono::steady_clock::now();
+        btStaticBrushSetShape* built = buildBrushSet(options.seed, count, brushes);
+        double buildMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        unsigned size = btBakedBrushSet::calculateBakedSize(built);
+        void* blob = btAlignedAlloc(size, 16);
+        bool baked = size > 0 && btBakedBrushSet::bake(built, sourceHash, blob, size);
+        double bakeMs = elapsedMs(start);
+
+        if (!baked) ++failures;
+
+        // what the game gets from mapping the file: a private copy the bvh is fixed up in
+        void* mapped = btAlignedAlloc(size, 16);
+        memcpy(mapped, blob, size);
+
+        btBakedBrushSet* loaded = new btBakedBrushSet();
+        start = std::chrono::steady_clock::now();
+        bool loadedOk = loaded->load(mapped, size, sourceHash);
+        double loadMs = elapsedMs(start);
+
+        // a bake of other source or cut short must not load
+        btBakedBrushSet rejected;
+        int rejectFailures = 0;
+        if (rejected.load(blob, size, sourceHash + 1)) ++rejectFailures;
+        if (rejected.load(blob, size / 2, sourceHash)) ++rejectFailures;
+
+        int brushMismatches = count;
+        int queryMismatches = queries;
+        int rayMismatches = queries;
+
+        if (loadedOk)
+        {
+            btStaticBrushSetShape* shape = loaded->getShape();
+            brushMismatches = countBrushMismatches(built, shape, options.seed + 2);
+
+            // the same brushes must come out of the deserialized bvh, in the same order
+            unsigned int queryState = options.seed + 1;
+            queryMismatches = 0;
+            for (int q = 0; q < queries; ++q)
+            {
+                btVector3 center(randomUnit(queryState) * extent, randomUnit(queryState) * extent, btFabs(randomUnit(queryState)) * 20);
+                BrushIndices a, b;
+                built->processBrushesInAabb(&a, center - btVector3(2, 2, 2), center + btVector3(2, 2, 2));
+                shape->processBrushesInAabb(&b, center - btVector3(2, 2, 2), center + btVector3(2, 2, 2));
+                if (a.indices != b.indices) ++queryMismatches;
+            }
+
+            // and the same hits through the collision world
+            StaticWorld worlds[2];
+            btCollisionObject objects[2];
+            objects[0].setCollisionShape(built);
+            objects[1].setCollisionShape(shape);
+
+            for (int w = 0; w < 2; ++w)
+            {
+                objects[w].setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT);
+                worlds[w].world.addCollisionObject(&objects[w]);
+            }
+
+            rayMismatches = 0;
+            for (int q = 0; q < queries; ++q)
+            {
+                btVector3 from(randomUnit(queryState) * extent, randomUnit(queryState) * extent, 40);
+                btVector3 to(randomUnit(queryState) * extent, randomUnit(queryState) * extent, -5);
+
+                btCollisionWorld::ClosestRayResultCallback a(from, to), b(from, to);
+                worlds[0].world.rayTest(from, to, a);
+                worlds[1].world.rayTest(from, to, b);
+
+                if (a.hasHit() != b.hasHit() || a.m_closestHitFraction != b.m_closestHitFraction || !sameVector(a.m_hitNormalWorld, b.m_hitNormalWorld))
+                {
+                    ++rayMismatches;
+                }
+            }
+
+            for (int w = 0; w < 2; ++w)
+            {
+                worlds[w].world.removeCollisionObject(&objects[w]);
+            }
+        }
+
+        if (!loadedOk || brushMismatches || queryMismatches || rayMismatches || rejectFailures) ++failures;
+
+        fprintf(out, "      {\n");
+        fprintf(out, "        \"brushes\": %d,\n", count);
+        fprintf(out, "        \"bytes\": %u,\n", size);
+        fprintf(out, "        \"build_ms\": %.3f,\n", buildMs);
+        fprintf(out, "        \"bake_ms\": %.3f,\n", bakeMs);
+        fprintf(out, "        \"load_ms\": %.3f,\n", loadMs);
+        fprintf(out, "        \"load_speedup\": %.2f,\n", loadMs > 0 ? buildMs / loadMs : 0.0);
+        fprintf(out, "        \"brush_mismatches\": %d,\n", brushMismatches);
+        fprintf(out, "        \"query_mismatches\": %d,\n", queryMismatches);
+        fprintf(out, "        \"ray_mismatches\": %d,\n", rayMismatches);
+        fprintf(out, "        \"rejected\": %s\n", rejectFailures == 0 ? "true" : "false");
+        fprintf(out, "      }%s\n", c < 2 ? "," : "");
+
+        // the loaded shape uses the mapping until it is gone
+        delete loaded;
+        btAlignedFree(mapped);
+        btAlignedFree(blob);
+
+        delete built;
+        for (btPolyhedralConvexShape* brush : brushes) delete brush;
+    }
+
+    fprintf(out, "    ],\n");
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - LOD
+
+struct LodScene
+{
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher;
+    btDbvtBroadphase broadphase;
+    btSequentialImpulseConstraintSolver solver;
+    btDiscreteDynamicsWorld world;
+    btSimulationLod lod;
+    btBoxShape groundShape;
+    btBoxShape boxShape;
+    btRigidBody ground;
+    std::vector<btRigidBody*> boxes;
+
+    // boxes dropped flat on a grid far enough apart that none touch, so every world lands them the same way
+    LodScene(unsigned int seed, int side, btScalar spacing)
+    : dispatcher(&configuration),
+      world(&dispatcher, &broadphase, &solver, &configuration),
+      groundShape(btVector3(side * spacing, 1, side * spacing)),
+      boxShape(btVector3(0.4, 0.4, 0.4)),
+      ground(0, nullptr, &groundShape)
+    {
+        ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+        world.addRigidBody(&ground);
+
+        // one tick per motion state write would hide bodies that moved on a tick and sleep again at the write
+        world.setLatencyMotionStateInterpolation(false);
+
+        btVector3 inertia;
+        boxShape.calculateLocalInertia(1, inertia);
+
+        for (int x = 0; x < side; ++x)
+        {
+            for (int z = 0; z < side; ++z)
+            {
+                btTransform start(btQuaternion(btVector3(0, 1, 0), randomUnit(seed) * SIMD_PI),
+                                  btVector3((x - side / 2) * spacing, 2 + btFabs(randomUnit(seed)) * 2, (z - side / 2) * spacing));
+
+                btRigidBody::btRigidBodyConstructionInfo info(1, new btDefaultMotionState(start), &boxShape, inertia);
+                btRigidBody* box = new btRigidBody(info);
+                boxes.push_back(box);
+                world.addRigidBody(box);
+            }
+        }
+    }
+
+    ~LodScene()
+    {
+        world.setSimulationLod(nullptr);
+        for (btRigidBody* box : boxes)
+        {
+            lod.removeBody(box);
+            world.removeRigidBody(box);
+            delete box->getMotionState();
+            delete box;
+        }
+        world.removeRigidBody(&ground);
+    }
+
+    void enableLod(const btSimulationLod::Settings& settings, const btVector3& viewer, const btVector3& direction)
+    {
+        lod.setSettings(settings);
+        lod.setViewer(viewer, direction, btScalar(0.5));
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            lod.addBody(boxes[i], i % 50 == 49 ? btSimulationLod::ALWAYS_FULL_RATE : 0);
+        }
+        world.setSimulationLod(&lod);
+    }
+
+    double step(int ticks, int& steppedTicks)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ticks; t += 2)
+        {
+            world.stepSimulation(btScalar(2. / 60.), 2, btScalar(1. / 60.));
+            steppedTicks += lod.getStats().m_numStepped;
+        }
+        return elapsedMs(start);
+    }
+};
+
+static bool sameTransforms(const LodScene& a, const LodScene& b)
+{
+    for (size_t i = 0; i < a.boxes.size(); ++i)
+    {
+        if (memcmp(&a.boxes[i]->getWorldTransform(), &b.boxes[i]->getWorldTransform(), sizeof(btTransform)) != 0) return false;
+        if (memcmp(&a.boxes[i]->getLinearVelocity(), &b.boxes[i]->getLinearVelocity(), sizeof(btVector3)) != 0) return false;
+    }
+    return true;
+}
+
+// Bodies away from where the plain world has them, by tier; the stepped tiers may lead by a few ticks while they fall
+static void countLodMismatches(const LodScene& plain, const LodScene& lod, btScalar fallTolerance, btScalar restTolerance,
+                               bool falling, int mismatches[BT_LOD_NUM_TIERS], int& unsynchronized)
+{
+    const btSimulationLod::Settings& settings = lod.lod.getSettings();
+
+    for (size_t i = 0; i < plain.boxes.size(); ++i)
+    {
+        const btRigidBody* expected = plain.boxes[i];
+        const btRigidBody* actual = lod.boxes[i];
+        int tier = lod.lod.getBodyTier(actual);
+
+        btVector3 offset = actual->getWorldTransform().getOrigin() - expected->getWorldTransform().getOrigin();
+        btScalar tolerance = restTolerance;
+
+        if (tier == BT_LOD_FROZEN)
+        {
+            // frozen where it was when it froze
+            tolerance = BT_LARGE_FLOAT;
+        }
+        else if (falling)
+        {
+            tolerance = fallTolerance * (settings.m_periods[tier] - 1) + restTolerance;
+        }
+
+        if (offset.length() > tolerance) ++mismatches[tier];
+
+        btTransform drawn;
+        actual->getMotionState()->getWorldTransform(drawn);
+        if ((drawn.getOrigin() - actual->getWorldTransform().getOrigin()).length() > btScalar(1e-4)) ++unsynchronized;
+    }
+}
+
+static int runLod(const Options& options, FILE* out)
+{
+    const int side = 41;
+    const btScalar spacing = 5;
+    const int ticks = 300;
+
+    int failures = 0;
+
+    btSimulationLod::Settings settings;
+    btSimulationLod::Settings everythingFull;
+    everythingFull.m_distances[BT_LOD_REDUCED_RATE] = everythingFull.m_distances[BT_LOD_LOW_RATE] = everythingFull.m_distances[BT_LOD_FROZEN] = BT_LARGE_FLOAT;
+
+    LodScene plain(options.seed, side, spacing);
+    LodScene full(options.seed, side, spacing);
+    LodScene lod(options.seed, side, spacing);
+
+    // looking down +x from the middle, the far corner behind the viewer freezes
+    btVector3 viewer(0, 2, 0);
+    btVector3 direction(1, 0, 0);
+    full.enableLod(everythingFull, viewer, direction);
+    lod.enableLod(settings, viewer, direction);
+
+    std::vector<btTransform> frozenStart(lod.boxes.size());
+    std::vector<int> tierStart(lod.boxes.size());
+
+    fprintf(out, "  \"lod\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"bodies\": %d,\n", int(lod.boxes.size()));
+    fprintf(out, "    \"runs\": [\n");
+
+    // falling for the first 20 ticks, resting by the end; then the viewer walks to the frozen corner and they thaw
+    const int phaseTicks[] = { 20, ticks - 20, ticks };
+    const char* phaseNames[] = { "falling", "resting", "approached" };
+
+    for (int phase = 0; phase < 3; ++phase)
+    {
+        if (phase == 2)
+        {
+            viewer = btVector3(-(side / 2) * spacing, 2, -(side / 2) * spacing);
+            direction = btVector3(1, 0, 1);
+            full.lod.setViewer(viewer, direction, btScalar(0.5));
+            lod.lod.setViewer(viewer, direction, btScalar(0.5));
+        }
+
+        // a box frozen over the whole phase must not have moved at all
+        for (size_t i = 0; i < lod.boxes.size(); ++i)
+        {
+            frozenStart[i] = lod.boxes[i]->getWorldTransform();
+            tierStart[i] = phase == 0 ? BT_LOD_FROZEN : lod.lod.getBodyTier(lod.boxes[i]);
+        }
+
+        int plainStepped = 0;
+        int fullStepped = 0;
+        int lodStepped = 0;
+        double plainMs = plain.step(phaseTicks[phase], plainStepped);
+        double fullMs = full.step(phaseTicks[phase], fullStepped);
+        double lodMs = lod.step(phaseTicks[phase], lodStepped);
+
+        // everything at full rate has to be the plain world bit for bit
+        bool fullMatches = sameTransforms(plain, full);
+
+        // v at tick 20 is g t = 3.3 m/s, a tick ahead is 5.6 cm
+        int mismatches[BT_LOD_NUM_TIERS] = { 0, 0, 0, 0 };
+        int unsynchronized = 0;
+        countLodMismatches(plain, lod, btScalar(0.06), btScalar(0.01), phase == 0, mismatches, unsynchronized);
+
+        int frozenMoved = 0;
+        for (size_t i = 0; i < lod.boxes.size(); ++i)
+        {
+            if (tierStart[i] == BT_LOD_FROZEN && lod.lod.getBodyTier(lod.boxes[i]) == BT_LOD_FROZEN &&
+                memcmp(&frozenStart[i], &lod.boxes[i]->getWorldTransform(), sizeof(btTransform)) != 0)
+            {
+                ++frozenMoved;
+            }
+        }
+
+        const btSimulationLod::Stats& stats = lod.lod.getStats();
+
+        if (!fullMatches || unsynchronized || frozenMoved) ++failures;
+        for (int tier = 0; tier < BT_LOD_NUM_TIERS; ++tier)
+        {
+            if (mismatches[tier]) ++failures;
+        }
+        if (phase == 2 && stats.m_numBodies[BT_LOD_FROZEN] == lod.lod.getNumBodies()) ++failures;
+
+        int stepTicks = phaseTicks[phase] / 2 * 2;
+
+        fprintf(out, "      {\n");
+        fprintf(out, "        \"phase\": \"%s\",\n", phaseNames[phase]);
+        fprintf(out, "        \"ticks\": %d,\n", phaseTicks[phase]);
+        fprintf(out, "        \"plain_ms\": %.3f,\n", plainMs);
+        fprintf(out, "        \"full_rate_lod_ms\": %.3f,\n", fullMs);
+        fprintf(out, "        \"lod_ms\": %.3f,\n", lodMs);
+        fprintf(out, "        \"speedup\": %.2f,\n", lodMs > 0 ? plainMs / lodMs : 0.0);
+        fprintf(out, "        \"bodies_per_tier\": [%d, %d, %d, %d],\n", stats.m_numBodies[0], stats.m_numBodies[1], stats.m_numBodies[2], stats.m_numBodies[3]);
+        fprintf(out, "        \"groups_per_tier\": [%d, %d, %d, %d],\n", stats.m_numGroups[0], stats.m_numGroups[1], stats.m_numGroups[2], stats.m_numGroups[3]);
+        fprintf(out, "        \"awake_bodies_per_tick\": [%.1f, %.1f],\n", double(fullStepped) / (stepTicks / 2), double(lodStepped) / (stepTicks / 2));
+        fprintf(out, "        \"full_rate_matches\": %s,\n", fullMatches ? "true" : "false");
+        fprintf(out, "        \"mismatches_per_tier\": [%d, %d, %d, %d],\n", mismatches[0], mismatches[1], mismatches[2], mismatches[3]);
+        fprintf(out, "        \"frozen_moved\": %d,\n", frozenMoved);
+        fprintf(out, "        \"unsynchronized_motion_states\": %d\n", unsynchronized);
+        fprintf(out, "      }%s\n", phase < 2 ? "," : "");
+    }
+
+    // a frozen box taken out of the world leaves the lod and gets its mass back
+    bool removedFrozenThawed = true;
+    for (btRigidBody* box : lod.boxes)
+    {
+        if (lod.lod.getBodyTier(box) != BT_LOD_FROZEN) continue;
+
+        int numBodies = lod.lod.getNumBodies();
+        lod.world.removeRigidBody(box);
+        removedFrozenThawed = lod.lod.getNumBodies() == numBodies - 1 && box->getInvMass() != btScalar(0) &&
+            !(box->getCollisionFlags() & btCollisionObject::CF_KINEMATIC_OBJECT);
+        lod.world.addRigidBody(box);
+        break;
+    }
+    if (!removedFrozenThawed) ++failures;
+
+    fprintf(out, "    ],\n");
+    fprintf(out, "    \"removed_frozen_thawed\": %s,\n", removedFrozenThawed ? "true" : "false");
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    return failures;
+}
+
+// MARK: - Broadphase
+
+// Debris flying around a walled arena, the same objects in the same order for either broadphase
+struct DebrisScene
+{
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher;
+    btBroadphaseInterface* broadphase;
+    btCollisionWorld world;
+    btBoxShape smallShape;
+    btBoxShape mediumShape;
+    btBoxShape crateShape;
+    btBoxShape wallShape;
+    btBoxShape floorShape;
+    btBoxShape slabShape;
+    std::vector<btCollisionObject*> debris;
+    std::vector<btCollisionObject*> walls;
+    std::vector<btVector3> velocities;
+    btCollisionObject* slab = nullptr;
+    btScalar halfExtent;
+
+    DebrisScene(btBroadphaseInterface* broadphase_, unsigned int seed, int count, bool withSlab)
+    : dispatcher(&configuration),
+      broadphase(broadphase_),
+      world(&dispatcher, broadphase, &configuration),
+      smallShape(btVector3(btScalar(0.05), btScalar(0.05), btScalar(0.05))),
+      mediumShape(btVector3(btScalar(0.15), btScalar(0.1), btScalar(0.08))),
+      crateShape(btVector3(btScalar(0.5), btScalar(0.5), btScalar(0.5))),
+      wallShape(btVector3(1, 1, 2)),
+      floorShape(btVector3(1000, 1000, 1)),
+      slabShape(btVector3(300, 300, btScalar(0.5))),
+      halfExtent(btScalar(std::cbrt(double(count))) * btScalar(0.4))
+    {
+        // the floor, and pillars all over the arena through static proxies built in one go
+        std::vector<btCollisionObject*> fixed;
+        btCollisionObject* floor = new btCollisionObject();
+        floor->setCollisionShape(&floorShape);
+        floor->getWorldTransform().setOrigin(btVector3(0, 0, -halfExtent - 1));
+        fixed.push_back(floor);
+
+        for (int i = 0; i < 64; ++i)
+        {
+            btCollisionObject* wall = new btCollisionObject();
+            wall->setCollisionShape(&wallShape);
+            wall->getWorldTransform().setOrigin(btVector3(randomUnit(seed) * halfExtent, randomUnit(seed) * halfExtent, randomUnit(seed) * halfExtent));
+            fixed.push_back(wall);
+        }
+
+        for (size_t i = 0; i < fixed.size(); ++i)
+        {
+            fixed[i]->setUserIndex(int(i));
+            walls.push_back(fixed[i]);
+        }
+        world.addStaticCollisionObjects(fixed.data(), int(fixed.size()));
+
+        // mostly gibs and casings, a crate every tenth
+        for (int i = 0; i < count; ++i)
+        {
+            btCollisionObject* piece = new btCollisionObject();
+            piece->setCollisionShape(i % 10 == 9 ? &crateShape : (i % 2 ? &mediumShape : &smallShape));
+            piece->getWorldTransform().setRotation(btQuaternion(btVector3(0, 0, 1), randomUnit(seed) * SIMD_PI));
+            piece->getWorldTransform().setOrigin(btVector3(randomUnit(seed) * halfExtent, randomUnit(seed) * halfExtent, randomUnit(seed) * halfExtent));
+            piece->setUserIndex(int(walls.size() + debris.size()));
+            debris.push_back(piece);
+            velocities.push_back(btVector3(randomUnit(seed), randomUnit(seed), randomUnit(seed)) * 8);
+            world.addCollisionObject(piece);
+        }
+
+        // one dynamic object far too large for any level of the grid
+        if (withSlab)
+        {
+            slab = new btCollisionObject();
+            slab->setCollisionShape(&slabShape);
+            slab->getWorldTransform().setOrigin(btVector3(0, 0, -halfExtent * btScalar(0.5)));
+            slab->setUserIndex(int(walls.size() + debris.size()));
+            world.addCollisionObject(slab);
+        }
+
+        world.updateAabbs();
+        broadphase->calculateOverlappingPairs(&dispatcher);
+    }
+
+    ~DebrisScene()
+    {
+        for (btCollisionObject* object : debris)
+        {
+            world.removeCollisionObject(object);
+            delete object;
+        }
+        for (btCollisionObject* object : walls)
+        {
+            world.removeCollisionObject(object);
+            delete object;
+        }
+        if (slab)
+        {
+            world.removeCollisionObject(slab);
+            delete slab;
+        }
+        delete broadphase;
+    }
+
+    // the first moving pieces fly on and bounce off the arena bounds, the rest stay where they are
+    void move(int moving, btScalar dt)
+    {
+        for (int i = 0; i < moving; ++i)
+        {
+            btVector3 position = debris[i]->getWorldTransform().getOrigin() + velocities[i] * dt;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (btFabs(position[axis]) > halfExtent)
+                {
+                    velocities[i][axis] = -velocities[i][axis];
+                    position[axis] = btClamped(position[axis], -halfExtent, halfExtent);
+                }
+            }
+            debris[i]->getWorldTransform().setOrigin(position);
+        }
+    }
+
+    double update()
+    {
+        auto start = std::chrono::steady_clock::now();
+        world.updateAabbs();
+        broadphase->calculateOverlappingPairs(&dispatcher);
+        return elapsedMs(start);
+    }
+
+    std::vector<btCollisionObject*> objects() const
+    {
+        std::vector<btCollisionObject*> all(walls);
+        all.insert(all.end(), debris.begin(), debris.end());
+        if (slab) all.push_back(slab);
+        return all;
+    }
+};
+
+typedef std::pair<int, int> IndexPair;
+
+static IndexPair orderedIndexPair(const btBroadphaseProxy* a, const btBroadphaseProxy* b)
+{
+    int ia = static_cast<const btCollisionObject*>(a->m_clientObject)->getUserIndex();
+    int ib = static_cast<const btCollisionObject*>(b->m_clientObject)->getUserIndex();
+    return ia < ib ? IndexPair(ia, ib) : IndexPair(ib, ia);
+}
+
+static std::set<IndexPair> cachedPairs(const DebrisScene& scene)
+{
+    std::set<IndexPair> pairs;
+    const btBroadphasePairArray& array = scene.broadphase->getOverlappingPairCache()->getOverlappingPairArray();
+    for (int i = 0; i < array.size(); ++i)
+    {
+        pairs.insert(orderedIndexPair(array[i].m_pProxy0, array[i].m_pProxy1));
+    }
+    return pairs;
+}
+
+// Every pair of proxies whose bounds overlap and whose filters let them collide, one by one
+static std::set<IndexPair> overlappingPairs(const DebrisScene& scene)
+{
+    std::set<IndexPair> pairs;
+    std::vector<btCollisionObject*> objects = scene.objects();
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        const btBroadphaseProxy* a = objects[i]->getBroadphaseHandle();
+        for (size_t j = i + 1; j < objects.size(); ++j)
+        {
+            const btBroadphaseProxy* b = objects[j]->getBroadphaseHandle();
+            if (!(a->m_collisionFilterGroup & b->m_collisionFilterMask) || !(b->m_collisionFilterGroup & a->m_collisionFilterMask)) continue;
+            if (TestAabbAgainstAabb2(a->m_aabbMin, a->m_aabbMax, b->m_aabbMin, b->m_aabbMax))
+            {
+                pairs.insert(orderedIndexPair(a, b));
+            }
+        }
+    }
+    return pairs;
+}
+
+struct CollectProxies : public btBroadphaseAabbCallback
+{
+    std::vector<int> indices;
+
+    bool process(const btBroadphaseProxy* proxy) override
+    {
+        indices.push_back(static_cast<const btCollisionObject*>(proxy->m_clientObject)->getUserIndex());
+        return true;
+    }
+};
+
+// Every proxy a ray or sweep is handed, set up the way btCollisionWorld sets up its ray callbacks
+struct CollectRayProxies : public btBroadphaseRayCallback
+{
+    std::vector<int> indices;
+
+    CollectRayProxies(const btVector3& from, const btVector3& to)
+    {
+        btVector3 direction = (to - from).normalized();
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            m_rayDirectionInverse[axis] = direction[axis] == btScalar(0) ? btScalar(BT_LARGE_FLOAT) : btScalar(1) / direction[axis];
+            m_signs[axis] = m_rayDirectionInverse[axis] < btScalar(0);
+        }
+        m_lambda_max = direction.dot(to - from);
+    }
+
+    bool process(const btBroadphaseProxy* proxy) override
+    {
+        indices.push_back(static_cast<const btCollisionObject*>(proxy->m_clientObject)->getUserIndex());
+        return true;
+    }
+};
+
+static int countMissing(const std::set<IndexPair>& expected, const std::set<IndexPair>& actual)
+{
+    int missing = 0;
+    for (const IndexPair& pair : expected)
+    {
+        if (!actual.count(pair)) ++missing;
+    }
+    return missing;
+}
+
+// Queries of the grid between two builds, with pieces taken out, put back elsewhere and teleported
+static int countQueryMismatches(DebrisScene& grid, DebrisScene& dbvt, unsigned int& state, int& checks)
+{
+    int mismatches = 0;
+
+    for (int n = 0; n < 20; ++n)
+    {
+        int i = int(seededRand(state) % grid.debris.size());
+        btVector3 origin(randomUnit(state) * grid.halfExtent, randomUnit(state) * grid.halfExtent, randomUnit(state) * grid.halfExtent);
+        DebrisScene* scenes[2] = { &grid, &dbvt };
+        for (DebrisScene* scene : scenes)
+        {
+            btCollisionObject* piece = scene->debris[i];
+            if (n % 2)
+            {
+                scene->world.removeCollisionObject(piece);
+                piece->getWorldTransform().setOrigin(origin);
+                scene->world.addCollisionObject(piece);
+            }
+            else
+            {
+                piece->getWorldTransform().setOrigin(origin);
+                scene->world.updateSingleAabb(piece);
+            }
+        }
+    }
+
+    // rays and sphere sweeps against the proxies one by one, with the slab test the tree does on its leaves; the tree
+    // pads its leaves, so only this tells whether the grid hands over every proxy the ray touches
+    std::vector<btCollisionObject*> objects = grid.objects();
+    const btVector3 probeMin(btScalar(-0.1), btScalar(-0.1), btScalar(-0.1));
+    const btVector3 probeMax(btScalar(0.1), btScalar(0.1), btScalar(0.1));
+    for (int n = 0; n < 600; ++n)
+    {
+        btScalar e = grid.halfExtent;
+        btVector3 from(randomUnit(state) * e, randomUnit(state) * e, randomUnit(state) * e);
+        btVector3 to = n % 3 ? from + btVector3(randomUnit(state), randomUnit(state), randomUnit(state)) * 3 : btVector3(randomUnit(state) * e, randomUnit(state) * e, randomUnit(state) * e);
+        btVector3 boundsMin = n % 4 == 3 ? probeMin : btVector3(0, 0, 0);
+        btVector3 boundsMax = n % 4 == 3 ? probeMax : btVector3(0, 0, 0);
+
+        CollectRayProxies actual(from, to);
+        grid.broadphase->rayTest(from, to, actual, boundsMin, boundsMax);
+        std::sort(actual.indices.begin(), actual.indices.end());
+
+        std::vector<int> expected;
+        for (btCollisionObject* object : objects)
+        {
+            const btBroadphaseProxy* proxy = object->getBroadphaseHandle();
+            btVector3 bounds[2] = { proxy->m_aabbMin - boundsMax, proxy->m_aabbMax - boundsMin };
+            btScalar tmin;
+            if (btRayAabb2(from, actual.m_rayDirectionInverse, actual.m_signs, bounds, tmin, 0, actual.m_lambda_max)) expected.push_back(object->getUserIndex());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        if (expected != actual.indices) ++mismatches;
+        ++checks;
+    }
+
+    // boxes against the proxies one by one, each overlapping proxy reported exactly once
+    for (int n = 0; n < 200; ++n)
+    {
+        btVector3 center(randomUnit(state) * grid.halfExtent, randomUnit(state) * grid.halfExtent, randomUnit(state) * grid.halfExtent);
+        btVector3 half = btVector3(btFabs(randomUnit(state)), btFabs(randomUnit(state)), btFabs(randomUnit(state))) * btScalar(n % 10 ? 1 : 10);
+        btVector3 aabbMin = center - half;
+        btVector3 aabbMax = center + half;
+
+        CollectProxies actual;
+        grid.broadphase->aabbTest(aabbMin, aabbMax, actual);
+        std::sort(actual.indices.begin(), actual.indices.end());
+
+        std::vector<int> expected;
+        for (btCollisionObject* object : objects)
+        {
+            const btBroadphaseProxy* proxy = object->getBroadphaseHandle();
+            if (TestAabbAgainstAabb2(aabbMin, aabbMax, proxy->m_aabbMin, proxy->m_aabbMax)) expected.push_back(object->getUserIndex());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        if (expected != actual.indices) ++mismatches;
+        ++checks;
+    }
+
+    return mismatches;
+}
+
+struct DroppedBoxes
+{
+    btDefaultCollisionConfiguration configuration;
+    btCollisionDispatcher dispatcher;
+    btBroadphaseInterface* broadphase;
+    btSequentialImpulseConstraintSolver solver;
+    btDiscreteDynamicsWorld world;
+    btBoxShape groundShape;
+    btBoxShape boxShape;
+    btRigidBody ground;
+    std::vector<btRigidBody*> boxes;
+
+    DroppedBoxes(btBroadphaseInterface* broadphase_, unsigned int seed, int count)
+    : dispatcher(&configuration),
+      broadphase(broadphase_),
+      world(&dispatcher, broadphase, &solver, &configuration),
+      groundShape(btVector3(50, 1, 50)),
+      boxShape(btVector3(btScalar(0.15), btScalar(0.15), btScalar(0.15))),
+      ground(0, nullptr, &groundShape)
+    {
+        ground.getWorldTransform().setOrigin(btVector3(0, -1, 0));
+        btRigidBody* fixed = &ground;
+        world.addStaticRigidBodies(&fixed, 1);
+
+        btVector3 inertia;
+        boxShape.calculateLocalInertia(1, inertia);
+        for (int i = 0; i < count; ++i)
+        {
+            btRigidBody::btRigidBodyConstructionInfo info(1, nullptr, &boxShape, inertia);
+            info.m_startWorldTransform.setOrigin(btVector3(randomUnit(seed) * 3, btScalar(0.5) + btFabs(randomUnit(seed)) * 6, randomUnit(seed) * 3));
+            btRigidBody* box = new btRigidBody(info);
+            boxes.push_back(box);
+            world.addRigidBody(box);
+        }
+    }
+
+    ~DroppedBoxes()
+    {
+        for (btRigidBody* box : boxes)
+        {
+            world.removeRigidBody(box);
+            delete box;
+        }
+        world.removeRigidBody(&ground);
+        delete broadphase;
+    }
+
+    // boxes that ended up through the ground
+    int countFallen() const
+    {
+        int fallen = 0;
+        for (btRigidBody* box : boxes)
+        {
+            if (box->getWorldTransform().getOrigin().y() < btScalar(0.1)) ++fallen;
+        }
+        return fallen;
+    }
+};
+
+static int runBroadphase(btTaskSchedulerNative* scheduler, const Options& options, FILE* out)
+{
+    const int debrisCounts[] = { 1000, 4000, 16000 };
+    const btScalar movingFractions[] = { 1, btScalar(0.1) };
+    const int frames = std::max(options.iterations / 4, 20);
+    const btScalar dt = btScalar(1. / 60.);
+
+    scheduler->setNumThreads(scheduler->getMaxNumThreads());
+
+    int failures = 0;
+    unsigned int state = options.seed;
+
+    fprintf(out, "  \"broadphase\": {\n");
+    fprintf(out, "    \"seed\": %u,\n", options.seed);
+    fprintf(out, "    \"threads\": %d,\n", scheduler->getNumThreads());
+
+    // The grid has to find exactly the pairs whose bounds overlap and answer queries like the tree, while pieces
+    // move, leave and come back between two builds
+    {
+        DebrisScene grid(new btHashGridBroadphase(), options.seed, 2000, true);
+        DebrisScene dbvt(new btDbvtBroadphase(), options.seed, 2000, true);
+
+        int missing = 0;
+        int extra = 0;
+        int dbvtMissing = 0;
+        int queryMismatches = 0;
+        int queryChecks = 0;
+        int pairs = 0;
+
+        for (int frame = 0; frame < 30; ++frame)
+        {
+            grid.move(int(grid.debris.size()), dt);
+            dbvt.move(int(dbvt.debris.size()), dt);
+            grid.update();
+            dbvt.update();
+
+            if (frame % 10 == 9)
+            {
+                std::set<IndexPair> expected = overlappingPairs(grid);
+                std::set<IndexPair> actual = cachedPairs(grid);
+                missing += countMissing(expected, actual);
+                extra += countMissing(actual, expected);
+                // the tree pairs slightly inflated bounds, it finds more but never less
+                dbvtMissing += countMissing(expected, cachedPairs(dbvt));
+                pairs = int(expected.size());
+            }
+
+            queryMismatches += countQueryMismatches(grid, dbvt, state, queryChecks);
+        }
+
+        if (missing || extra || dbvtMissing || queryMismatches) ++failures;
+
+        const btHashGridBroadphase* hashGrid = static_cast<const btHashGridBroadphase*>(grid.broadphase);
+
+        fprintf(out, "    \"check\": {\n");
+        fprintf(out, "      \"pieces\": %d,\n", int(grid.debris.size()));
+        fprintf(out, "      \"pairs\": %d,\n", pairs);
+        fprintf(out, "      \"cells\": %d,\n", hashGrid->getNumCells());
+        fprintf(out, "      \"oversized\": %d,\n", hashGrid->getNumProxiesOnLevel(hashGrid->getNumLevels()));
+        fprintf(out, "      \"missing_pairs\": %d,\n", missing);
+        fprintf(out, "      \"extra_pairs\": %d,\n", extra);
+        fprintf(out, "      \"dbvt_missing_pairs\": %d,\n", dbvtMissing);
+        fprintf(out, "      \"queries\": %d,\n", queryChecks);
+        fprintf(out, "      \"query_mismatches\": %d\n", queryMismatches);
+        fprintf(out, "    },\n");
+    }
+
+    // The same pile dropped through a dynamics world on either broadphase, none may fall through the ground
+    {
+        DroppedBoxes grid(new btHashGridBroadphase(), options.seed, 500);
+        DroppedBoxes dbvt(new btDbvtBroadphase(), options.seed, 500);
+        for (int tick = 0; tick < 300; ++tick)
+        {
+            grid.world.stepSimulation(dt, 1, dt);
+            dbvt.world.stepSimulation(dt, 1, dt);
+        }
+
+        int gridFallen = grid.countFallen();
+        int dbvtFallen = dbvt.countFallen();
+        if (gridFallen || dbvtFallen) ++failures;
+
+        fprintf(out, "    \"pile\": {\n");
+        fprintf(out, "      \"boxes\": %d,\n", int(grid.boxes.size()));
+        fprintf(out, "      \"grid_manifolds\": %d,\n", grid.dispatcher.getNumManifolds());
+        fprintf(out, "      \"dbvt_manifolds\": %d,\n", dbvt.dispatcher.getNumManifolds());
+        fprintf(out, "      \"grid_fallen\": %d,\n", gridFallen);
+        fprintf(out, "      \"dbvt_fallen\": %d\n", dbvtFallen);
+        fprintf(out, "    },\n");
+    }
+
+    // Time spent in updateAabbs and calculateOverlappingPairs per frame; the grid builds everything again every frame,
+    // the tree only moves what moved, so the grid wins once most pieces are flying
+    fprintf(out, "    \"runs\": [\n");
+
+    for (int c = 0; c < 3; ++c)
+    {
+        for (int m = 0; m < 2; ++m)
+        {
+            DebrisScene grid(new btHashGridBroadphase(), options.seed, debrisCounts[c], false);
+            DebrisScene dbvt(new btDbvtBroadphase(), options.seed, debrisCounts[c], false);
+            int moving = int(btScalar(debrisCounts[c]) * movingFractions[m]);
+
+            std::vector<double> gridTimes;
+            std::vector<double> dbvtTimes;
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                grid.move(moving, dt);
+                dbvt.move(moving, dt);
+                gridTimes.push_back(grid.update());
+                dbvtTimes.push_back(dbvt.update());
+            }
+
+            double gridP50 = percentile(gridTimes, 50);
+            double dbvtP50 = percentile(dbvtTimes, 50);
+
+            fprintf(out, "      {\n");
+            fprintf(out, "        \"pieces\": %d,\n", debrisCounts[c]);
+            fprintf(out, "        \"moving\": %d,\n", moving);
+            fprintf(out, "        \"pairs\": %d,\n", grid.broadphase->getOverlappingPairCache()->getNumOverlappingPairs());
+            fprintf(out, "        \"dbvt_p50_ms\": %.3f,\n", dbvtP50);
+            fprintf(out, "        \"grid_p50_ms\": %.3f,\n", gridP50);
+            fprintf(out, "        \"grid_p99_ms\": %.3f,\n", percentile(gridTimes, 99));
+            fprintf(out, "        \"speedup\": %.2f\n", gridP50 > 0 ? dbvtP50 / gridP50 : 0.0);
+            fprintf(out, "      }%s\n", c < 2 || m < 1 ? "," : "");
+        }
+    }
+
+    fprintf(out, "    ],\n");
+    fprintf(out, "    \"failures\": %d\n", failures);
+    fprintf(out, "  }");
+
+    scheduler->setNumThreads(1);
+
+    return failures;
+}
+
+int main(int argc, const char* argv[])
+{
+    Options options(argc, argv);
+
+    bool all = options.mode == "all";
+
+    // has to come before the first Bullet allocation, the task scheduler's included
+    if (all || options.mode == "memory")
+    {
+        btMemoryTracker::install();
+    }
+
+    btTaskSchedulerNative* scheduler = static_cast<btTaskSchedulerNative*>(btGetNativeTaskScheduler());
+    btSetTaskScheduler(scheduler);
+
+    FILE* out = options.output ? fopen(options.output, "w") : stdout;
+
+    if (out == nullptr)
+    {
+        fprintf(stderr, "can't open %s\n", options.output);
+        return 1;
+    }
+
+    int failures = 0;
+
+    fprintf(out, "{\n");
+
+    if (all || options.mode == "stress")
+    {
+        failures += runStress(scheduler, options, out);
+    }
+
+    if (all || options.mode == "scaling")
+    {
+        if (all) fprintf(out, ",\n");
+        runScaling(scheduler, options, out);
+    }
+
+    if (all || options.mode == "gjk")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runGjk(options, out);
+    }
+
+    if (all || options.mode == "rays")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runRays(scheduler, options, out);
+    }
+
+    if (all || options.mode == "packets")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runPackets(options, out);
+    }
+
+    if (all || options.mode == "bulk")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runBulk(options, out);
+    }
+
+    if (all || options.mode == "events")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runEvents(options, out);
+    }
+
+    if (all || options.mode == "triggers")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runTriggers(options, out);
+    }
+
+    if (all || options.mode == "async")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runAsync(options, out);
+    }
+
+    if (all || options.mode == "export")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runExport(options, out);
+    }
+
+    if (all || options.mode == "snapshot")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runSnapshot(options, out);
+    }
+
+    if (all || options.mode == "solver")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runSolver(options, out);
+    }
+
+    if (all || options.mode == "islands")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runIslands(options, out);
+    }
+
+    if (all || options.mode == "trace")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runTrace(scheduler, options, out);
+    }
+
+    if (all || options.mode == "memory")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runMemory(scheduler, options, out);
+    }
+
+    if (all || options.mode == "hitboxes")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runHitboxes(options, out);
+    }
+
+    if (all || options.mode == "characters")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runCharacters(options, out);
+    }
+
+    if (all || options.mode == "crowd")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runCrowd(scheduler, options, out);
+    }
+
+    if (all || options.mode == "bake")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runBake(options, out);
+    }
+
+    if (all || options.mode == "lod")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runLod(options, out);
+    }
+
+    if (all || options.mode == "broadphase")
+    {
+        if (all) fprintf(out, ",\n");
+        failures += runBroadphase(scheduler, options, out);
+    }
+
+    fprintf(out, "\n}\n");
+
+    if (out != stdout) fclose(out);
+
+    btSetTaskScheduler(btGetSequentialTaskScheduler());
+    scheduler->setNumThreads(1);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -1,8 +1,10 @@
 #include "DynamicCharacterController.h"
 
+#include <BulletCollision/BroadphaseCollision/btCollisionAlgorithm.h>
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
 #include <BulletCollision/CollisionShapes/btCapsuleShape.h>
-#include <BulletDynamics/Dynamics/btDynamicsWorld.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
+#include <BulletDynamics/Dynamics/btIncrementalIslandManager.h>
 #include <BulletDynamics/Dynamics/btRigidBody.h>
 #include <LinearMath/btDefaultMotionState.h>
 #include <LinearMath/btIDebugDraw.h>
@@ -10,57 +12,90 @@
 #include <cassert>
 
 namespace {
+typedef DynamicCharacterController::StepCandidate StepCandidate;
+
 class FindGroundAndSteps : public btCollisionWorld::ContactResultCallback {
 public:
 	FindGroundAndSteps(const DynamicCharacterController *controller,
-		const btCollisionWorld *world);
+		btAlignedObjectArray<StepCandidate> &candidates, bool findSteps);
 
 	btScalar addSingleResult(btManifoldPoint &cp,
 		const btCollisionObjectWrapper *colObj0, int partId0, int index0,
 		const btCollisionObjectWrapper *colObj1, int partId1, int index1);
-	btVector3 getInvNormal();
+
+	/**
+	 * Check a contact point, whose point and normal on B belong to the other
+	 * object, as contactTest reports them.
+	 */
+	void addPoint(const btManifoldPoint &cp);
 
 	bool mHaveGround = false;
 	btVector3 mGroundPoint;
-	bool mHaveStep = false;
-	btVector3 mStepPoint;
-	btVector3 mStepNormal;
 
 private:
 	void checkGround(const btManifoldPoint &cp);
 
+	/// The checks of a step that need no ray
+	void checkStep(const btManifoldPoint &cp);
+
 	const DynamicCharacterController *mController;
-	const btCollisionWorld *mWorld;
+	btAlignedObjectArray<StepCandidate> &mCandidates;
+	bool mFindSteps;
 
-	btScalar mStepDist2;
+	btScalar mNormalTolerance = 0.01;
+	btScalar mMinDot = 0.3;
 };
 
-class ResolveStepUp {
+/**
+ * Feeds the points of the manifolds of the pairs the body is in to
+ * FindGroundAndSteps, by querying the broadphase for the objects overlapping
+ * it.
+ */
+class FindInManifolds : public btBroadphaseAabbCallback {
 public:
-	ResolveStepUp(const DynamicCharacterController *controller,
-		const btCollisionWorld *world, const btManifoldPoint &cp);
-	bool mIsStep = false;
-	btVector3 mRealPosWorld;
-	btScalar mDist2;
+	FindInManifolds(btRigidBody *body, btCollisionWorld *world,
+		btAlignedObjectArray<btPersistentManifold *> &manifolds,
+		FindGroundAndSteps &groundSteps);
 
-private:
-	bool checkPreconditions();
-	bool findRealPoint();
-	bool canFit() const;
-
-	const DynamicCharacterController *mController;
-	const btCollisionWorld *mWorld;
+	bool process(const btBroadphaseProxy *proxy);
 
-	const btVector3 &mStepPos;
-	const btVector3 &mStepNormal;
-	const btTransform &mTransform;
-	btScalar mOriginHeight;
-	btVector3 mStepLocal;
+	/// An overlapping object has no manifold yet, so contactTest is needed
+	bool mMissingManifold = false;
 
-	btScalar mNormalTolerance = 0.01;
-	btScalar mStepSearchOvershoot = 0.01;
-	btScalar mMinDot = 0.3;
+private:
+	btRigidBody *mBody;
+	btCollisionWorld *mWorld;
+	btAlignedObjectArray<btPersistentManifold *> &mManifolds;
+	FindGroundAndSteps &mGroundSteps;
 };
+
+/// The closest hit fraction of a ray, 1 when it hits nothing
+btScalar castRay(const btCollisionWorld *world, const btVector3 &from,
+	const btVector3 &to, btVector3 *hitPoint = nullptr)
+{
+	btCollisionWorld::ClosestRayResultCallback callback(from, to);
+	world->rayTest(from, to, callback);
+	if (!callback.hasHit()) {
+		return 1;
+	}
+	if (hitPoint) {
+		*hitPoint = callback.m_hitPointWorld;
+	}
+	return callback.m_closestHitFraction;
+}
+
+btVector3 getInvNormal(const btVector3 &stepNormal)
+{
+	btMatrix3x3 frame;
+	// Build it as step to world
+	frame[2].setValue(0, 0, 1);
+	frame[1] = stepNormal;
+	frame[0] = frame[1].cross(frame[2]);
+	frame[0].normalize();
+	// Convert it to world to step
+	frame = frame.transpose();
+	return frame[1];
+}
 }
 
 DynamicCharacterController::DynamicCharacterController(btRigidBody *body,
@@ -92,18 +127,74 @@ void DynamicCharacterController::setupBody()
 void DynamicCharacterController::updateAction(btCollisionWorld *collisionWorld,
 	btScalar deltaTimeStep)
 {
-	FindGroundAndSteps groundSteps(this, collisionWorld);
+	findContacts(collisionWorld);
+
+	const StepCandidate *step = nullptr;
+	btScalar stepDist2 = 0;
+	for (int i = 0; i < mStepCandidates.size(); i++) {
+		StepCandidate &candidate = mStepCandidates[i];
+		if (resolveStep(collisionWorld, candidate)) {
+			btScalar dist2 = stepDistance2(candidate);
+			if (!step || dist2 < stepDist2) {
+				step = &candidate;
+				stepDist2 = dist2;
+			}
+		}
+	}
+
+	move(deltaTimeStep, step);
+	updateIslands(collisionWorld);
+}
+
+void DynamicCharacterController::findContacts(btCollisionWorld *collisionWorld)
+{
+	if (!findContactsInManifolds(collisionWorld)) {
+		findContactsByTest(collisionWorld);
+	}
+}
+
+bool DynamicCharacterController::findContactsInManifolds(
+	btCollisionWorld *collisionWorld)
+{
+	if (!mUseManifolds || !mRigidBody->getBroadphaseHandle()) {
+		return false;
+	}
+
+	/* A new step is looked for only when not stepping already, or when
+	jumping cancels the current one */
+	FindGroundAndSteps groundSteps(this, mStepCandidates, !mStepping || mJump);
+	const btBroadphaseProxy *proxy = mRigidBody->getBroadphaseHandle();
+	FindInManifolds manifolds(mRigidBody, collisionWorld, mManifolds,
+		groundSteps);
+	collisionWorld->getBroadphase()->aabbTest(proxy->m_aabbMin,
+		proxy->m_aabbMax, manifolds);
+	if (manifolds.mMissingManifold) {
+		return false;
+	}
+	mOnGround = groundSteps.mHaveGround;
+	mGroundPoint = groundSteps.mGroundPoint;
+	return true;
+}
+
+void DynamicCharacterController::findContactsByTest(
+	btCollisionWorld *collisionWorld)
+{
+	// Starts over, some points might have been found in the manifolds already
+	FindGroundAndSteps groundSteps(this, mStepCandidates, !mStepping || mJump);
 	collisionWorld->contactTest(mRigidBody, groundSteps);
 	mOnGround = groundSteps.mHaveGround;
 	mGroundPoint = groundSteps.mGroundPoint;
+}
 
-	updateVelocity(deltaTimeStep);
-	if (mStepping || groundSteps.mHaveStep) {
+void DynamicCharacterController::move(btScalar dt, const StepCandidate *step)
+{
+	updateVelocity(dt);
+	if (mStepping || step) {
 		if (!mStepping) {
-			mSteppingTo = groundSteps.mStepPoint;
-			mSteppingInvNormal = groundSteps.getInvNormal();
+			mSteppingTo = step->mRealPos;
+			mSteppingInvNormal = getInvNormal(step->mNormal);
 		}
-		stepUp(deltaTimeStep);
+		stepUp(dt);
 	}
 
 	if (mOnGround || mStepping) {
@@ -115,6 +206,26 @@ void DynamicCharacterController::updateAction(btCollisionWorld *collisionWorld,
 	}
 }
 
+void DynamicCharacterController::updateIslands(btCollisionWorld *collisionWorld)
+{
+	if (!mChangedKinematic) {
+		return;
+	}
+	mChangedKinematic = false;
+
+	// Actions are only added to dynamics worlds
+	btDynamicsWorld *world = static_cast<btDynamicsWorld *>(collisionWorld);
+	if (world->getWorldType() != BT_DISCRETE_DYNAMICS_WORLD) {
+		return;
+	}
+	btIncrementalIslandManager *islandManager =
+		static_cast<btDiscreteDynamicsWorld *>(world)
+			->getIncrementalIslandManager();
+	if (islandManager) {
+		islandManager->invalidateIslands();
+	}
+}
+
 void DynamicCharacterController::updateVelocity(float dt)
 {
 	btTransform transform;
@@ -159,6 +270,7 @@ void DynamicCharacterController::stepUp(float dt)
 		mPrestepFlags = mRigidBody->getCollisionFlags();
 		mRigidBody->setCollisionFlags(
 			btCollisionObject::CF_KINEMATIC_OBJECT);
+		mChangedKinematic = true;
 		mStepping = true;
 		mSteppingTo[2] += mShapeHalfHeight + mShapeRadius;
 	}
@@ -258,6 +370,7 @@ void DynamicCharacterController::cancelStep()
 	if (mRigidBody) {
 		if (mStepping) {
 			mRigidBody->setCollisionFlags(mPrestepFlags);
+			mChangedKinematic = true;
 		}
 		// Sometimes when going back to rigid body there are strange effects
 		mRigidBody->setAngularVelocity({ 0, 0, 0 });
@@ -265,17 +378,110 @@ void DynamicCharacterController::cancelStep()
 	mStepping = false;
 }
 
+bool DynamicCharacterController::resolveStep(
+	const btCollisionWorld *collisionWorld, StepCandidate &candidate) const
+{
+	btVector3 from[2], to[2];
+
+	getVisibilityRay(candidate, from[0], to[0]);
+	if (!visibilityRayPasses(castRay(collisionWorld, from[0], to[0]))) {
+		return false;
+	}
+
+	getRealPointRay(candidate, from[0], to[0]);
+	if (!realPointRayPasses(castRay(collisionWorld, from[0], to[0],
+			&candidate.mRealPos))) {
+		return false;
+	}
+
+	getFitRays(candidate, from, to);
+	return fitRayPasses(castRay(collisionWorld, from[0], to[0]))
+		&& fitRayPasses(castRay(collisionWorld, from[1], to[1]));
+}
+
+void DynamicCharacterController::getVisibilityRay(
+	const StepCandidate &candidate, btVector3 &from, btVector3 &to) const
+{
+	from = mRigidBody->getWorldTransform().getOrigin();
+	to = candidate.mPos;
+}
+
+bool DynamicCharacterController::visibilityRayPasses(btScalar hitFraction)
+{
+	// Only the step itself can be hit
+	return (1 - hitFraction) <= SIMD_EPSILON;
+}
+
+void DynamicCharacterController::getRealPointRay(
+	const StepCandidate &candidate, btVector3 &from, btVector3 &to) const
+{
+	/* Look for the real height of the step.
+	 * Move a bit along the ground-collision direction, horizontally,
+	 * and vertically use 0 and the max step height. */
+	const btTransform &transform = mRigidBody->getWorldTransform();
+	btVector3 minTargetPoint(candidate.mLocal[0], candidate.mLocal[1], 0);
+	minTargetPoint *= 1 + mStepSearchOvershoot / minTargetPoint.length();
+	/* We are using capsule lowest point, rather than ground, see
+	FindGroundAndSteps::checkStep */
+	minTargetPoint[2] -= mShapeHalfHeight + mShapeRadius;
+
+	btVector3 maxTargetPoint = minTargetPoint;
+	maxTargetPoint[2] += mMaxStepHeight + mStepSearchOvershoot;
+	from = transform(maxTargetPoint);
+	to = transform(minTargetPoint);
+}
+
+bool DynamicCharacterController::realPointRayPasses(btScalar hitFraction)
+{
+	// Missing, or almost at the minimum point, means it can walk normally
+	return (btScalar(1) - hitFraction) >= SIMD_EPSILON;
+}
+
+void DynamicCharacterController::getFitRays(const StepCandidate &candidate,
+	btVector3 *from, btVector3 *to) const
+{
+	// Not very robust test, but still better than nothing
+	const btScalar originHeight = mShapeHalfHeight + mShapeRadius;
+	btVector3 horFrom = candidate.mRealPos;
+	horFrom[2] += originHeight;
+	btVector3 horTo(candidate.mLocal[0], candidate.mLocal[1], 0);
+	horTo *= mShapeRadius / horTo.length();
+	horTo = horFrom + mRigidBody->getWorldTransform().getBasis() * horTo;
+
+	from[0] = candidate.mRealPos;
+	to[0] = horFrom;
+	to[0][2] += originHeight;
+	from[1] = horFrom;
+	to[1] = horTo;
+}
+
+bool DynamicCharacterController::fitRayPasses(btScalar hitFraction)
+{
+	return hitFraction >= 1;
+}
+
+btScalar DynamicCharacterController::stepDistance2(
+	const StepCandidate &candidate) const
+{
+	btVector3 origin = mRigidBody->getWorldTransform().getOrigin();
+	origin[2] -= mShapeHalfHeight + mShapeRadius;
+	return origin.distance2(candidate.mRealPos);
+}
+
 namespace {
 FindGroundAndSteps::FindGroundAndSteps(
-	const DynamicCharacterController *controller, const btCollisionWorld *world)
+	const DynamicCharacterController *controller,
+	btAlignedObjectArray<StepCandidate> &candidates, bool findSteps) :
+	mCandidates(candidates)
 {
 	mController = controller;
-	mWorld = world;
+	mFindSteps = findSteps;
+	mCandidates.resize(0);
 }
 
 btScalar FindGroundAndSteps::addSingleResult(btManifoldPoint &cp,
-	const btCollisionObjectWrapper *colObj0, int partId0, int index0,
-	const btCollisionObjectWrapper *colObj1, int partId1, int index1)
+	const btCollisionObjectWrapper *colObj0, int, int,
+	const btCollisionObjectWrapper *, int, int)
 {
 	if (colObj0->m_collisionObject == mController->getBody()) {
 		/* The first object should always be the rigid body of the
@@ -283,22 +489,21 @@ btScalar FindGroundAndSteps::addSingleResult(btManifoldPoint &cp,
 		In case the body is the second object, we cannot use the collision
 		information, because Bullet provides only the normal of the second
 		point. */
-		checkGround(cp);
-		ResolveStepUp resolve(mController, mWorld, cp);
-		if (resolve.mIsStep) {
-			if (!mHaveStep || resolve.mDist2 < mStepDist2) {
-				mStepPoint = resolve.mRealPosWorld;
-				mStepNormal = cp.m_normalWorldOnB;
-				mStepDist2 = resolve.mDist2;
-			}
-			mHaveStep = true;
-		}
+		addPoint(cp);
 	}
 
 	// By looking at btCollisionWorld.cpp, it seems Bullet ignores this value
 	return 0;
 }
 
+void FindGroundAndSteps::addPoint(const btManifoldPoint &cp)
+{
+	checkGround(cp);
+	if (mFindSteps) {
+		checkStep(cp);
+	}
+}
+
 void FindGroundAndSteps::checkGround(const btManifoldPoint &cp)
 {
 	if (mHaveGround) {
@@ -320,146 +525,127 @@ void FindGroundAndSteps::checkGround(const btManifoldPoint &cp)
 	}
 }
 
-btVector3 FindGroundAndSteps::getInvNormal()
-{
-	if (!mHaveStep) {
-		return btVector3(0, 0, 0);
-	}
-
-	btMatrix3x3 frame;
-	// Build it as step to world
-	frame[2].setValue(0, 0, 1);
-	frame[1] = mStepNormal;
-	frame[0] = frame[1].cross(frame[2]);
-	frame[0].normalize();
-	// Convert it to world to step
-	frame = frame.transpose();
-	return frame[1];
-}
-
-ResolveStepUp::ResolveStepUp(const DynamicCharacterController *controller,
-	const btCollisionWorld *world, const btManifoldPoint &cp) :
-	mStepPos(cp.m_positionWorldOnB), mStepNormal(cp.m_normalWorldOnB),
-	mTransform(controller->getBody()->getWorldTransform())
-{
-	mController = controller;
-	mWorld = world;
-	mOriginHeight = mController->mShapeHalfHeight + mController->mShapeRadius;
-
-	mIsStep = checkPreconditions() && findRealPoint() && canFit();
-	if (mIsStep) {
-		btVector3 origin = mTransform.getOrigin();
-		origin[2] -= mOriginHeight;
-		mDist2 = origin.distance2(mRealPosWorld);
-	}
-}
-
-bool ResolveStepUp::checkPreconditions()
+void FindGroundAndSteps::checkStep(const btManifoldPoint &cp)
 {
 	if (mController->getMovementDirection().fuzzyZero()) {
-		return false;
+		return;
 	}
 
+	const btVector3 &stepPos = cp.m_positionWorldOnB;
+	const btVector3 &stepNormal = cp.m_normalWorldOnB;
+
 	/* A step has little vertical component in its normal.
 	 * This strategy is not perfect, as it does not work with end points of the
 	 * ramps, but I do not have a solution for this, at the moment.
 	 *
 	 * Nice trick by https://cobertos.com/blog/post/how-to-climb-stairs-unity3d/
 	 */
-	if (fabs(mStepNormal.z()) > mNormalTolerance) {
-		return false;
+	if (fabs(stepNormal.z()) > mNormalTolerance) {
+		return;
 	}
 	/* We can step only when we are on ground, but since while we are doing
 	this check the characater cannot move, if we consider the lowest point of
 	the capsule as center, we have a constant error, that might be negligible.
 	On the other hand, we could also just store the various collisions and use
 	the correct ground point after we detected it. */
-	const btVector3 &origin = mTransform.getOrigin();
+	const btTransform &transform = mController->getBody()->getWorldTransform();
+	const btVector3 &origin = transform.getOrigin();
 	{
-		btScalar approximateHeight = mStepPos.z() - origin.z()
-			+ mOriginHeight;
+		btScalar approximateHeight = stepPos.z() - origin.z()
+			+ mController->mShapeHalfHeight + mController->mShapeRadius;
 		if (approximateHeight >= mController->mMaxStepHeight) {
-			return false;
+			return;
 		}
 	}
 
-	btTransform toLocal = mTransform.inverse();
 	/* Don't step if it's in a direction opposite to our movement.
 	 * This is a quick test, but likely not enough accurate. */
-	mStepLocal = toLocal(mStepPos);
-	if (mStepLocal.fuzzyZero()) {
-		return false;
+	btVector3 stepLocal = transform.inverse()(stepPos);
+	if (stepLocal.fuzzyZero()) {
+		return;
 	}
-	btVector3 stepDir = mStepLocal / mStepLocal.length();
+	btVector3 stepDir = stepLocal / stepLocal.length();
 	if (stepDir.dot(mController->getMovementDirection()) < mMinDot) {
-		return false;
-	}
-
-	btCollisionWorld::ClosestRayResultCallback callback(origin, mStepPos);
-	mWorld->rayTest(origin, mStepPos, callback);
-	if (callback.hasHit()
-			&& (1 - callback.m_closestHitFraction) > SIMD_EPSILON) {
-		return false;
+		return;
 	}
 
-	return true;
+	// The rays are cast later, see DynamicCharacterController::resolveStep
+	StepCandidate &candidate = mCandidates.expand();
+	candidate.mPos = stepPos;
+	candidate.mNormal = stepNormal;
+	candidate.mLocal = stepLocal;
 }
 
-bool ResolveStepUp::findRealPoint()
+FindInManifolds::FindInManifolds(btRigidBody *body,
+	btCollisionWorld *world,
+	btAlignedObjectArray<btPersistentManifold *> &manifolds,
+	FindGroundAndSteps &groundSteps) :
+	mManifolds(manifolds), mGroundSteps(groundSteps)
 {
-	/* Look for the real height of the step.
-	 * Move a bit along the ground-collision direction, horizontally,
-	 * and vertically use 0 and the max step height. */
-	btVector3 minTargetPoint(mStepLocal[0], mStepLocal[1], 0);
-	minTargetPoint *= 1 + mStepSearchOvershoot / minTargetPoint.length();
-	// As above: we are using capsule lowest point, rather than ground
-	minTargetPoint[2] -= mOriginHeight;
-
-	btVector3 maxTargetPoint = minTargetPoint;
-	maxTargetPoint[2] += mController->mMaxStepHeight + mStepSearchOvershoot;
-	minTargetPoint = mTransform(minTargetPoint);
-	maxTargetPoint = mTransform(maxTargetPoint);
-
-	btCollisionWorld::ClosestRayResultCallback callback(maxTargetPoint,
-		minTargetPoint);
-	mWorld->rayTest(maxTargetPoint, minTargetPoint, callback);
-	if (!callback.hasHit()) {
-		return false;
-	}
-	if ((btScalar(1) - callback.m_closestHitFraction) < SIMD_EPSILON) {
-		// Almost at the minimum point, can walk normally
-		return false;
-	}
-
-	mRealPosWorld = callback.m_hitPointWorld;
-	return true;
+	mBody = body;
+	mWorld = world;
 }
 
-bool ResolveStepUp::canFit() const
+bool FindInManifolds::process(const btBroadphaseProxy *proxy)
 {
-	// Not very robust test, but still better than nothing
-	btVector3 horFrom = mRealPosWorld;
-	horFrom[2] += mOriginHeight;
-	btVector3 horTo(mStepLocal[0], mStepLocal[1], 0);
-	horTo *= mController->mShapeRadius / horTo.length();
-	horTo = horFrom + mTransform.getBasis() * horTo;
-	const btVector3 &vertFrom = mRealPosWorld;
-	btVector3 vertTo = horFrom;
-	vertTo[2] += mOriginHeight;
+	btBroadphaseProxy *bodyProxy = mBody->getBroadphaseHandle();
+	if (proxy == bodyProxy) {
+		return true;
+	}
 
-	{
-		btCollisionWorld::ClosestRayResultCallback callback(vertFrom, vertTo);
-		mWorld->rayTest(vertFrom, vertTo, callback);
-		if (callback.hasHit()) {
-			return false;
-		}
+	// Objects filtered out by the broadphase have no pair on purpose
+	if (!(bodyProxy->m_collisionFilterGroup & proxy->m_collisionFilterMask)
+			|| !(proxy->m_collisionFilterGroup
+				& bodyProxy->m_collisionFilterMask)) {
+		return true;
 	}
 
-	{
-		btCollisionWorld::ClosestRayResultCallback callback(horFrom, horTo);
-		mWorld->rayTest(horFrom, horTo, callback);
-		if (callback.hasHit()) {
-			return false;
+	btBroadphasePair *pair = mWorld->getPairCache()->findPair(bodyProxy,
+		const_cast<btBroadphaseProxy *>(proxy));
+	if (!pair || !pair->m_algorithm) {
+		/* New overlap, or a pair the dispatcher skips, as the kinematic
+		body of auto stepping against static geometry: only contactTest
+		knows about it */
+		mMissingManifold = true;
+		return false;
+	}
+
+	mManifolds.resize(0);
+	pair->m_algorithm->getAllContactManifolds(mManifolds);
+
+	const btTransform &bodyTransform = mBody->getWorldTransform();
+	for (int i = 0; i < mManifolds.size(); i++) {
+		const btPersistentManifold *manifold = mManifolds[i];
+		const bool bodyIsA = manifold->getBody0() == mBody;
+		const btTransform &otherTransform = bodyIsA
+			? manifold->getBody1()->getWorldTransform()
+			: manifold->getBody0()->getWorldTransform();
+
+		for (int p = 0; p < manifold->getNumContacts(); p++) {
+			const btManifoldPoint &point = manifold->getContactPoint(p);
+
+			/* The points are from the last collision detection, before the
+			body was integrated. The manifold belongs to the solver, so instead
+			of refreshing it, move a copy where contactTest would find it:
+			the point on the body follows the body, the one on the other
+			object is projected from it along the normal. Seen from the body,
+			as contactTest reports it */
+			btManifoldPoint moved = point;
+			btVector3 onBody = bodyTransform(bodyIsA ? point.m_localPointA
+				: point.m_localPointB);
+			btVector3 onOther = otherTransform(bodyIsA ? point.m_localPointB
+				: point.m_localPointA);
+			if (!bodyIsA) {
+				moved.m_normalWorldOnB = -point.m_normalWorldOnB;
+			}
+			moved.m_distance1 = (onBody - onOther).dot(moved.m_normalWorldOnB);
+			if (moved.m_distance1 > manifold->getContactBreakingThreshold()) {
+				continue;
+			}
+			moved.m_positionWorldOnA = onBody;
+			moved.m_positionWorldOnB = onBody
+				- moved.m_normalWorldOnB * moved.m_distance1;
+			mGroundSteps.addPoint(moved);
 		}
 	}
 
@@ -2,8 +2,10 @@
 #define DYNAMIC_CHARACTER_CONTROLLER_H
 
 #include <BulletDynamics/Dynamics/btActionInterface.h>
+#include <LinearMath/btAlignedObjectArray.h>
 class btCapsuleShape;
 class btRigidBody;
+class btPersistentManifold;
 
 /**
  * Character controller for a rigid body with locked rotations.
@@ -37,7 +39,10 @@ public:
 	 */
 	const btVector3 &getMovementDirection() const;
 
-	/// Reset the movement status, but not the position.
+	/**
+	 * Reset the movement status, but not the position.
+	 * A step it cancels reaches the islands at the next update.
+	 */
 	void resetStatus();
 
 	/// Tell if the character can jump
@@ -118,7 +123,35 @@ public:
 	 */
 	btScalar mRadiusThreshold = 1e-2;
 
+	/**
+	 * Find ground and steps in the persistent manifolds that the dispatcher
+	 * already keeps for the body, instead of running a contactTest (that is,
+	 * broadphase and narrowphase again) on every update.
+	 * The points are moved along with the body to where contactTest would find
+	 * them, without touching the manifolds.
+	 * contactTest is still used when an object overlapping the body has no
+	 * manifold yet, e.g. after a teleport or while auto stepping.
+	 * Disabled by default.
+	 */
+	bool mUseManifolds = false;
+
+	/// A contact point that might be the edge of a step to climb
+	struct StepCandidate {
+		/// The contact point on the step
+		btVector3 mPos;
+
+		/// The contact normal, seen from the step
+		btVector3 mNormal;
+
+		/// The contact point in body coordinates
+		btVector3 mLocal;
+
+		/// The top of the step, valid once the real point ray passed
+		btVector3 mRealPos;
+	};
+
 protected:
+	friend class DynamicCharacterGroup;
 
 	/**
 	 * Default constructor, to be used by child classes.
@@ -145,6 +178,69 @@ protected:
 	/// Cancel auto stepping
 	inline void cancelStep();
 
+	/**
+	 * First half of updateAction: find the ground and the contacts that might
+	 * be steps, without changing the body.
+	 * \param collisionWorld The world the body is in
+	 */
+	void findContacts(btCollisionWorld *collisionWorld);
+
+	/**
+	 * Find the contacts in the manifolds of the body, which only reads the
+	 * world, so it is safe to run for many characters at once.
+	 * \return false when mUseManifolds is off or a manifold is missing, and
+	 * findContactsByTest has to run instead
+	 */
+	bool findContactsInManifolds(btCollisionWorld *collisionWorld);
+
+	/**
+	 * Find the contacts with btCollisionWorld::contactTest. It creates and
+	 * releases manifolds in the dispatcher, so it must not run on two threads.
+	 */
+	void findContactsByTest(btCollisionWorld *collisionWorld);
+
+	/**
+	 * Second half of updateAction: update the velocity and climb stairs.
+	 * \param dt The time elapsed since the last step
+	 * \param step The closest of the candidates that passed every ray, or null
+	 */
+	void move(btScalar dt, const StepCandidate *step);
+
+	/**
+	 * Rebuild the islands of the incremental island manager of the world, if
+	 * any, when stepping made the body kinematic or dynamic again. It writes
+	 * to the world, so it must not run on two threads.
+	 */
+	void updateIslands(btCollisionWorld *collisionWorld);
+
+	/**
+	 * Cast the rays of a candidate one by one.
+	 * \return Whether the candidate is a step to climb
+	 */
+	bool resolveStep(const btCollisionWorld *collisionWorld,
+		StepCandidate &candidate) const;
+
+	/**
+	 * The rays that tell whether a candidate is a step, in the order they are
+	 * cast, each one only if the previous ones passed: nothing must be between
+	 * the body and the contact, a ray down finds the top of the step, and the
+	 * character must fit above it (two rays).
+	 * Whether a ray passes depends only on its closest hit fraction, which is
+	 * 1 when it hits nothing.
+	 */
+	void getVisibilityRay(const StepCandidate &candidate, btVector3 &from,
+		btVector3 &to) const;
+	static bool visibilityRayPasses(btScalar hitFraction);
+	void getRealPointRay(const StepCandidate &candidate, btVector3 &from,
+		btVector3 &to) const;
+	static bool realPointRayPasses(btScalar hitFraction);
+	void getFitRays(const StepCandidate &candidate, btVector3 *from,
+		btVector3 *to) const;
+	static bool fitRayPasses(btScalar hitFraction);
+
+	/// Squared distance of a step from the lowest point of the capsule
+	btScalar stepDistance2(const StepCandidate &candidate) const;
+
 	/// The controlled rigid body
 	btRigidBody *mRigidBody;
 
@@ -171,7 +267,7 @@ protected:
 	btVector3 mGroundPoint;
 
 	/// Tells whether the character is auto stepping
-	bool mStepping;
+	bool mStepping = false;
 
 	/// Tells the point the character is stepping to
 	btVector3 mSteppingTo;
@@ -181,6 +277,18 @@ protected:
 
 	/// Tells the flag to restore to make the character dynamic again after step
 	int mPrestepFlags;
+
+	/// Tells whether the body became kinematic or dynamic since updateIslands
+	bool mChangedKinematic = false;
+
+	/// The manifolds of one pair, reused by every update with mUseManifolds
+	btAlignedObjectArray<btPersistentManifold *> mManifolds;
+
+	/// The contacts found by findContacts that might be steps
+	btAlignedObjectArray<StepCandidate> mStepCandidates;
+
+	/// How far past the contact point to look for the top of a step
+	btScalar mStepSearchOvershoot = 0.01;
 };
 
 #endif
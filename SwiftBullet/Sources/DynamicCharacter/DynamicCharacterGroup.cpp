@@ -0,0 +1,210 @@
+#include "DynamicCharacterGroup.h"
+#include "DynamicCharacterController.h"
+
+#include <LinearMath/btThreads.h>
+
+class DynamicCharacterGroup::FindContactsLoop : public btIParallelForBody {
+public:
+	FindContactsLoop(DynamicCharacterController *const *controllers,
+		btCollisionWorld *world, bool *needContactTest) :
+		mControllers(controllers), mWorld(world),
+		mNeedContactTest(needContactTest)
+	{
+	}
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		for (int i = iBegin; i < iEnd; i++) {
+			mNeedContactTest[i] =
+				!mControllers[i]->findContactsInManifolds(mWorld);
+		}
+	}
+
+private:
+	DynamicCharacterController *const *mControllers;
+	btCollisionWorld *mWorld;
+	bool *mNeedContactTest;
+};
+
+class DynamicCharacterGroup::MoveLoop : public btIParallelForBody {
+public:
+	MoveLoop(DynamicCharacterController *const *controllers, const int *steps,
+		btScalar dt) :
+		mControllers(controllers), mSteps(steps), mDt(dt)
+	{
+	}
+
+	void forLoop(int iBegin, int iEnd) const
+	{
+		for (int i = iBegin; i < iEnd; i++) {
+			DynamicCharacterController *controller = mControllers[i];
+			const int step = mSteps[i];
+			controller->move(mDt, step < 0 ? nullptr
+				: &controller->mStepCandidates[step]);
+		}
+	}
+
+private:
+	DynamicCharacterController *const *mControllers;
+	const int *mSteps;
+	btScalar mDt;
+};
+
+void DynamicCharacterGroup::updateAction(btCollisionWorld *collisionWorld,
+	btScalar deltaTimeStep)
+{
+	const int numControllers = mControllers.size();
+	if (!numControllers) {
+		return;
+	}
+
+	/* Every controller only reads the world and writes to itself, and the
+	bodies don't move until all of them have found their contacts */
+	mNeedContactTest.resize(numControllers);
+	forEachController(FindContactsLoop(&mControllers[0], collisionWorld,
+		&mNeedContactTest[0]));
+
+	/* contactTest gets and releases manifolds of the dispatcher, which the
+	single-threaded one does without a lock */
+	for (int c = 0; c < numControllers; c++) {
+		if (mNeedContactTest[c]) {
+			mControllers[c]->findContactsByTest(collisionWorld);
+		}
+	}
+
+	mPending.resize(0);
+	for (int c = 0; c < numControllers; c++) {
+		for (int i = 0; i < mControllers[c]->mStepCandidates.size(); i++) {
+			PendingStep &pending = mPending.expand();
+			pending.mController = c;
+			pending.mCandidate = i;
+		}
+	}
+
+	castStepRays(collisionWorld, VISIBILITY_RAY);
+	castStepRays(collisionWorld, REAL_POINT_RAY);
+	castStepRays(collisionWorld, FIT_RAYS);
+
+	// The candidates are still in order, so ties go the same way as alone
+	mSteps.resize(numControllers);
+	mStepDist2.resize(numControllers);
+	for (int c = 0; c < numControllers; c++) {
+		mSteps[c] = -1;
+	}
+	for (int i = 0; i < mPending.size(); i++) {
+		const PendingStep &pending = mPending[i];
+		const DynamicCharacterController *controller =
+			mControllers[pending.mController];
+		btScalar dist2 = controller->stepDistance2(
+			controller->mStepCandidates[pending.mCandidate]);
+		if (mSteps[pending.mController] < 0
+				|| dist2 < mStepDist2[pending.mController]) {
+			mSteps[pending.mController] = pending.mCandidate;
+			mStepDist2[pending.mController] = dist2;
+		}
+	}
+
+	forEachController(MoveLoop(&mControllers[0], &mSteps[0], deltaTimeStep));
+
+	for (int c = 0; c < numControllers; c++) {
+		mControllers[c]->updateIslands(collisionWorld);
+	}
+}
+
+void DynamicCharacterGroup::castStepRays(
+	const btCollisionWorld *collisionWorld, StepRay ray)
+{
+	if (!mPending.size()) {
+		return;
+	}
+
+	const int raysPerStep = ray == FIT_RAYS ? 2 : 1;
+	mRayFrom.resize(mPending.size() * raysPerStep);
+	mRayTo.resize(mPending.size() * raysPerStep);
+	for (int i = 0; i < mPending.size(); i++) {
+		const PendingStep &pending = mPending[i];
+		const DynamicCharacterController *controller =
+			mControllers[pending.mController];
+		const DynamicCharacterController::StepCandidate &candidate =
+			controller->mStepCandidates[pending.mCandidate];
+		btVector3 *from = &mRayFrom[i * raysPerStep];
+		btVector3 *to = &mRayTo[i * raysPerStep];
+		switch (ray) {
+		case VISIBILITY_RAY:
+			controller->getVisibilityRay(candidate, *from, *to);
+			break;
+		case REAL_POINT_RAY:
+			controller->getRealPointRay(candidate, *from, *to);
+			break;
+		case FIT_RAYS:
+			controller->getFitRays(candidate, from, to);
+			break;
+		}
+	}
+
+	collisionWorld->rayTestBatch(&mRayFrom[0], &mRayTo[0], nullptr, nullptr,
+		mRayFrom.size(), mRayResults);
+
+	int numKept = 0;
+	for (int i = 0; i < mPending.size(); i++) {
+		const PendingStep &pending = mPending[i];
+		const btScalar *hitFraction = &mRayResults.m_hitFraction[i * raysPerStep];
+		bool passes = false;
+		switch (ray) {
+		case VISIBILITY_RAY:
+			passes = DynamicCharacterController::visibilityRayPasses(
+				hitFraction[0]);
+			break;
+		case REAL_POINT_RAY:
+			passes = DynamicCharacterController::realPointRayPasses(
+				hitFraction[0]);
+			if (passes) {
+				mControllers[pending.mController]->mStepCandidates[
+					pending.mCandidate].mRealPos = mRayResults.m_hitPointWorld[i];
+			}
+			break;
+		case FIT_RAYS:
+			passes = DynamicCharacterController::fitRayPasses(hitFraction[0])
+				&& DynamicCharacterController::fitRayPasses(hitFraction[1]);
+			break;
+		}
+		if (passes) {
+			mPending[numKept++] = pending;
+		}
+	}
+	mPending.resize(numKept);
+}
+
+void DynamicCharacterGroup::forEachController(
+	const btIParallelForBody &loop) const
+{
+	if (mParallel) {
+		btParallelFor(0, mControllers.size(), mGrainSize, loop);
+	} else {
+		loop.forLoop(0, mControllers.size());
+	}
+}
+
+void DynamicCharacterGroup::debugDraw(btIDebugDraw *debugDrawer)
+{
+	for (int i = 0; i < mControllers.size(); i++) {
+		mControllers[i]->debugDraw(debugDrawer);
+	}
+}
+
+void DynamicCharacterGroup::addController(
+	DynamicCharacterController *controller)
+{
+	mControllers.push_back(controller);
+}
+
+void DynamicCharacterGroup::removeController(
+	DynamicCharacterController *controller)
+{
+	mControllers.remove(controller);
+}
+
+int DynamicCharacterGroup::getNumControllers() const
+{
+	return mControllers.size();
+}
@@ -0,0 +1,101 @@
+#ifndef DYNAMIC_CHARACTER_GROUP_H
+#define DYNAMIC_CHARACTER_GROUP_H
+
+#include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletDynamics/Dynamics/btActionInterface.h>
+#include <LinearMath/btAlignedObjectArray.h>
+class DynamicCharacterController;
+class btIParallelForBody;
+
+/**
+ * Action that updates many character controllers in one pass, e.g. a crowd of
+ * NPCs, instead of adding each of them to the world.
+ *
+ * First every character finds its ground and the contacts that might be
+ * steps. Then the rays that tell whether those contacts are steps are cast for
+ * all the characters at once with btCollisionWorld::rayTestBatch, one batch
+ * for each ray of the test. Finally every character moves.
+ * Finding contacts and moving are split over the task scheduler as well,
+ * except for the characters that fall back to contactTest, which are done on
+ * the calling thread.
+ *
+ * The characters end up where they would have, had they been updated one by
+ * one.
+ */
+class DynamicCharacterGroup : public btActionInterface
+{
+public:
+	virtual ~DynamicCharacterGroup() = default;
+
+	void updateAction(btCollisionWorld *collisionWorld, btScalar deltaTimeStep);
+	void debugDraw(btIDebugDraw *debugDrawer);
+
+	/**
+	 * Add a controller to the group.
+	 * \param controller The controller, that must not be an action of the
+	 * world, too. The group does not own it.
+	 */
+	void addController(DynamicCharacterController *controller);
+
+	/// Remove a controller from the group
+	void removeController(DynamicCharacterController *controller);
+
+	/// Get the number of controllers in the group
+	int getNumControllers() const;
+
+	/**
+	 * Split the work of the characters over the task scheduler with
+	 * btParallelFor. When disabled, everything but the ray batches runs on the
+	 * calling thread.
+	 * Enabled by default.
+	 */
+	bool mParallel = true;
+
+	/// How many characters a task of the scheduler updates
+	int mGrainSize = 8;
+
+protected:
+	/// The rays of the step test, see DynamicCharacterController::resolveStep
+	enum StepRay {
+		VISIBILITY_RAY,
+		REAL_POINT_RAY,
+		FIT_RAYS
+	};
+
+	/**
+	 * Cast a ray of the step test for every pending candidate in one batch,
+	 * and keep those that pass it.
+	 */
+	void castStepRays(const btCollisionWorld *collisionWorld, StepRay ray);
+
+	/// The btParallelFor bodies of the two halves of the update
+	class FindContactsLoop;
+	class MoveLoop;
+
+	/// Run a loop over the controllers, on the scheduler or in place
+	void forEachController(const btIParallelForBody &loop) const;
+
+	/// The step candidate of a controller that passed the rays cast so far
+	struct PendingStep {
+		int mController;
+		int mCandidate;
+	};
+
+	btAlignedObjectArray<DynamicCharacterController *> mControllers;
+
+	btAlignedObjectArray<PendingStep> mPending;
+
+	/// Whether each controller missed a manifold and needs contactTest
+	btAlignedObjectArray<bool> mNeedContactTest;
+
+	/// The rays of a batch, and their results
+	btAlignedObjectArray<btVector3> mRayFrom;
+	btAlignedObjectArray<btVector3> mRayTo;
+	btCollisionWorld::BatchedQueryResults mRayResults;
+
+	/// The candidate index of the closest step of each controller, or -1
+	btAlignedObjectArray<int> mSteps;
+	btAlignedObjectArray<btScalar> mStepDist2;
+};
+
+#endif
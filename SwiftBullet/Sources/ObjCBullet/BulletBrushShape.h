@@ -0,0 +1,35 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+#import "BulletCollisionShape.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Convex brush given by its planes (normal, distance), inside where dot(normal, point) <= distance.
+@interface BulletBrushShape : BulletCollisionShape
+- (instancetype)initWithPlanes:(const vector_float4 *)planes
+                numberOfPlanes:(NSInteger)numberOfPlanes NS_REFINED_FOR_SWIFT;
+/// NO if the planes don't enclose a volume
+@property (nonatomic, readonly, getter = isValid) BOOL valid;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,61 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import "BulletBrushShape.h"
+#import "BulletCollision/CollisionShapes/btBrushShape.h"
+
+@implementation BulletBrushShape
+{
+  btBrushShape *m_shape;
+}
+
+- (instancetype)initWithPlanes:(const vector_float4 *)planes
+                numberOfPlanes:(NSInteger)numberOfPlanes
+{
+  self = [super init];
+  if (self) {
+    btAlignedObjectArray<btVector3> equations;
+    for (NSInteger i = 0; i < numberOfPlanes; ++i) {
+      btVector3 &equation = equations.expand();
+      equation.setValue(planes[i].x, planes[i].y, planes[i].z);
+      equation[3] = -planes[i].w;
+    }
+    m_shape = new btBrushShape(numberOfPlanes > 0 ? &equations[0] : nullptr, (int)numberOfPlanes);
+    m_shape->setUserPointer((__bridge void *)self);
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  delete m_shape;
+}
+
+- (btCollisionShapeC *)ptr
+{
+  return bullet_cast(static_cast<btCollisionShape *>(m_shape));
+}
+
+- (BOOL)isValid
+{
+  return m_shape->isValid();
+}
+
+@end
@@ -34,6 +34,8 @@ typedef struct {} btContactResultCallbackC;
 typedef struct {} btAllHitsRayResultCallbackC;
 typedef struct {} btClosestRayResultCallbackC;
 typedef struct {} btClosestConvexResultCallbackC;
+typedef struct {} btContactEventQueueC;
+typedef struct {} btTriggerManagerC;
 
 #ifdef __cplusplus
 #include <BulletCollision/CollisionDispatch/btCollisionObject.h>
@@ -49,6 +51,8 @@ typedef struct {} btClosestConvexResultCallbackC;
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
+#include <BulletCollision/CollisionDispatch/btContactEventQueue.h>
+#include <BulletCollision/CollisionDispatch/btTriggerManager.h>
 
 inline btCollisionObject * bullet_cast(btCollisionObjectC *p) { return reinterpret_cast<btCollisionObject *>(p); }
 inline btCollisionObjectC * bullet_cast(btCollisionObject *p) { return reinterpret_cast<btCollisionObjectC *>(p); }
@@ -120,6 +124,16 @@ inline btClosestConvexResultCallbackC * bullet_cast(btCollisionWorld::ClosestCon
 inline const btCollisionWorld::ClosestConvexResultCallback * bullet_cast(const btClosestConvexResultCallbackC *p) { return reinterpret_cast<const btCollisionWorld::ClosestConvexResultCallback *>(p); }
 inline const btClosestConvexResultCallbackC * bullet_cast(const btCollisionWorld::ClosestConvexResultCallback *p) { return reinterpret_cast<const btClosestConvexResultCallbackC *>(p); }
 
+inline btContactEventQueue * bullet_cast(btContactEventQueueC *p) { return reinterpret_cast<btContactEventQueue *>(p); }
+inline btContactEventQueueC * bullet_cast(btContactEventQueue *p) { return reinterpret_cast<btContactEventQueueC *>(p); }
+inline const btContactEventQueue * bullet_cast(const btContactEventQueueC *p) { return reinterpret_cast<const btContactEventQueue *>(p); }
+inline const btContactEventQueueC * bullet_cast(const btContactEventQueue *p) { return reinterpret_cast<const btContactEventQueueC *>(p); }
+
+inline btTriggerManager * bullet_cast(btTriggerManagerC *p) { return reinterpret_cast<btTriggerManager *>(p); }
+inline btTriggerManagerC * bullet_cast(btTriggerManager *p) { return reinterpret_cast<btTriggerManagerC *>(p); }
+inline const btTriggerManager * bullet_cast(const btTriggerManagerC *p) { return reinterpret_cast<const btTriggerManager *>(p); }
+inline const btTriggerManagerC * bullet_cast(const btTriggerManager *p) { return reinterpret_cast<const btTriggerManagerC *>(p); }
+
 #endif
 
 #endif /* BulletCast_h */
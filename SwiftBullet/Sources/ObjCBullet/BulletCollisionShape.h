@@ -33,6 +33,9 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly, getter = isPolyhedral) BOOL polyhedral;
 - (btCollisionShapeC *)ptr;
 - (vector_float3)calculateLocalInertiaWithMass:(float)mass NS_REFINED_FOR_SWIFT;
+/// Builds faces and edges so contacts against BulletBrushShape are clipped from faces.
+/// Returns NO for shapes that aren't polyhedral.
+- (BOOL)initializePolyhedralFeatures;
 @end
 
 NS_ASSUME_NONNULL_END
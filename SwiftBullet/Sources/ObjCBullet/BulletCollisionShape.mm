@@ -19,6 +19,7 @@
  */
 
 #import "BulletCollisionShape.h"
+#import "BulletCollision/CollisionShapes/btPolyhedralConvexShape.h"
 
 @implementation BulletCollisionShape
 
@@ -70,6 +71,15 @@
   return vector3(inertia.x(), inertia.y(), inertia.z());
 }
 
+- (BOOL)initializePolyhedralFeatures
+{
+  btCollisionShape *shape = bullet_cast(self.ptr);
+  if (!shape->isPolyhedral()) {
+    return NO;
+  }
+  return static_cast<btPolyhedralConvexShape *>(shape)->initializePolyhedralFeatures();
+}
+
 - (NSString *)description
 {
   NSMutableString *s = [NSMutableString string];
@@ -0,0 +1,62 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+#import "BulletCast.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class BulletCollisionObject;
+
+typedef NS_ENUM(NSInteger, BulletContactEventType) {
+  BulletContactEventType_begin = 0,
+  BulletContactEventType_persist = 1,
+  BulletContactEventType_end = 2,
+};
+
+/// Contact events drained from BulletWorld once per frame. Keep one around:
+/// the storage only grows, so draining doesn't allocate once it fits a busy frame.
+/// node1 is the object the position lies on, the normal points from node1 to node0.
+@interface BulletContactEvents : NSObject
+@property (nonatomic, readonly) NSUInteger count;
+/// Events lost since the previous drain because the world's queue was full
+@property (nonatomic, readonly) NSUInteger numberOfDroppedEvents;
+
+- (instancetype)init;
+
+- (BulletContactEventType)typeAtIndex:(NSUInteger)index;
+- (nullable BulletCollisionObject *)node0AtIndex:(NSUInteger)index;
+- (nullable BulletCollisionObject *)node1AtIndex:(NSUInteger)index;
+- (vector_float3)positionAtIndex:(NSUInteger)index;
+- (vector_float3)normalAtIndex:(NSUInteger)index;
+- (float)distanceAtIndex:(NSUInteger)index;
+/// Summed over every contact point of the pair, 0 for end events
+- (float)appliedImpulseAtIndex:(NSUInteger)index;
+- (int)numberOfContactsAtIndex:(NSUInteger)index;
+/// Internal tick that produced the event, events of one tick are adjacent
+- (int)tickAtIndex:(NSUInteger)index;
+
+/// Takes every queued event, nodes keeps the objects removed from the world alive while their events are read.
+/// A nil queue leaves the events empty
+- (void)drainQueue:(nullable btContactEventQueueC *)queue retainingNodes:(NSArray<BulletCollisionObject *> *)nodes;
+@end
+
+NS_ASSUME_NONNULL_END
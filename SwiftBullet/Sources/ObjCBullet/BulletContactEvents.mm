@@ -0,0 +1,114 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import "BulletContactEvents.h"
+#import "BulletCollisionObject.h"
+#import "BulletCollision/CollisionDispatch/btContactEventQueue.h"
+
+@implementation BulletContactEvents
+{
+  btAlignedObjectArray<btContactEvent> m_events;
+  int m_numDropped;
+  NSMutableArray<BulletCollisionObject *> *m_removedNodes;
+}
+
+- (instancetype)init
+{
+  self = [super init];
+  if (self) {
+    m_numDropped = 0;
+    m_removedNodes = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (NSUInteger)count
+{
+  return m_events.size();
+}
+
+- (NSUInteger)numberOfDroppedEvents
+{
+  return m_numDropped;
+}
+
+- (BulletContactEventType)typeAtIndex:(NSUInteger)index
+{
+  return (BulletContactEventType)m_events[(int)index].m_type;
+}
+
+- (BulletCollisionObject *)node0AtIndex:(NSUInteger)index
+{
+  const btCollisionObject *objectPtr = m_events[(int)index].m_objectA;
+  return (objectPtr) ? (__bridge BulletCollisionObject *)objectPtr->getUserPointer() : nil;
+}
+
+- (BulletCollisionObject *)node1AtIndex:(NSUInteger)index
+{
+  const btCollisionObject *objectPtr = m_events[(int)index].m_objectB;
+  return (objectPtr) ? (__bridge BulletCollisionObject *)objectPtr->getUserPointer() : nil;
+}
+
+- (vector_float3)positionAtIndex:(NSUInteger)index
+{
+  btVector3 v = m_events[(int)index].m_pointWorldOnB;
+  return vector3(v.x(), v.y(), v.z());
+}
+
+- (vector_float3)normalAtIndex:(NSUInteger)index
+{
+  btVector3 v = m_events[(int)index].m_normalWorldOnB;
+  return vector3(v.x(), v.y(), v.z());
+}
+
+- (float)distanceAtIndex:(NSUInteger)index
+{
+  return m_events[(int)index].m_distance;
+}
+
+- (float)appliedImpulseAtIndex:(NSUInteger)index
+{
+  return m_events[(int)index].m_appliedImpulse;
+}
+
+- (int)numberOfContactsAtIndex:(NSUInteger)index
+{
+  return m_events[(int)index].m_numContacts;
+}
+
+- (int)tickAtIndex:(NSUInteger)index
+{
+  return m_events[(int)index].m_tick;
+}
+
+- (void)drainQueue:(btContactEventQueueC *)queue retainingNodes:(NSArray<BulletCollisionObject *> *)nodes
+{
+  btContactEventQueue *q = bullet_cast(queue);
+  
+  // keeps the capacity, the events of one frame are about as many as the last one's
+  m_events.resize(q ? q->size() : 0);
+  if (m_events.size() > 0) {
+    q->drain(&m_events[0], m_events.size());
+  }
+  m_numDropped = q ? q->takeNumDropped() : 0;
+  [m_removedNodes setArray:nodes];
+}
+
+@end
@@ -30,6 +30,9 @@ NS_ASSUME_NONNULL_BEGIN
                 numberOfPoints:(NSInteger)numberOfPoints
             numberOfComponents:(NSInteger)numberOfComponents;
 - (void)addPoint:(vector_float3)point;
+/// Precomputes hull edges so support queries walk the hull instead of testing every point.
+/// Call after the last addPoint; returns NO if the points don't span a volume.
+- (BOOL)buildVertexAdjacency;
 @end
 
 NS_ASSUME_NONNULL_END
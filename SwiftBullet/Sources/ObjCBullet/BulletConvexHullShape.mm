@@ -21,6 +21,7 @@
 #import "BulletConvexHullShape.h"
 #import "BulletUpAxis.h"
 #import "BulletCollision/CollisionShapes/btConvexHullShape.h"
+#import "BulletCollision/CollisionShapes/btHillClimbingConvexHullShape.h"
 #import "BulletCollision/CollisionShapes/btTriangleMesh.h"
 #import "BulletCollision/CollisionShapes/btConvexShape.h"
 #import "BulletCollision/CollisionShapes/btShapeHull.h"
@@ -28,14 +29,14 @@
 
 @implementation BulletConvexHullShape
 {
-  btConvexHullShape *m_shape;
+  btHillClimbingConvexHullShape *m_shape;
 }
 
 - (instancetype)init
 {
   self = [super init];
   if (self) {
-    m_shape = new btConvexHullShape(nullptr, 0);
+    m_shape = new btHillClimbingConvexHullShape(nullptr, 0);
     m_shape->setUserPointer((__bridge void *)self);
   }
   return self;
@@ -72,4 +73,9 @@
   m_shape->addPoint(btVector3(point.x, point.y, point.z));
 }
 
+- (BOOL)buildVertexAdjacency
+{
+  return m_shape->buildAdjacency();
+}
+
 @end
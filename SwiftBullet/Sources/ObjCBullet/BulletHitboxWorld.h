@@ -0,0 +1,69 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Box in the space of a bone, bone -1 for the space of the model, as mstudiobbox_t of a GoldSrc model
+typedef struct {
+  int bone;
+  int group;
+  vector_float3 mins;
+  vector_float3 maxs;
+} BulletHitbox;
+
+/// Closest hitbox along a ray, hitbox is its index in the model and normal is 0 when the ray starts inside
+typedef struct {
+  NSInteger entity;
+  int hitbox;
+  int bone;
+  int group;
+  float fraction;
+  vector_float3 point;
+  vector_float3 normal;
+} BulletHitboxHit;
+
+/// Shots against the posed hitboxes of animated entities, apart from any BulletWorld. Entities are culled with
+/// a tree of their boxes and the hitboxes of the ones on the way are tested four at a time
+@interface BulletHitboxWorld : NSObject
+
+- (instancetype)init;
+/// margin grows the tree box of an entity when it moves, so small moves of the pose keep it in place
+- (instancetype)initWithMargin:(float)margin;
+
+/// Index of a model shared by the entities made from it
+- (NSInteger)addModelWithHitboxes:(const BulletHitbox *)hitboxes count:(NSUInteger)count NS_REFINED_FOR_SWIFT;
+/// Can't be hit before its first pose
+- (NSInteger)addEntityWithModel:(NSInteger)model NS_REFINED_FOR_SWIFT;
+- (void)removeEntity:(NSInteger)entity NS_REFINED_FOR_SWIFT;
+
+/// bones are the model space bone matrices the mesh was drawn with, transform is its model matrix
+- (void)setPoseOfEntity:(NSInteger)entity
+              transform:(matrix_float4x4)transform
+                  bones:(nullable const matrix_float4x4 *)bones
+                  count:(NSUInteger)count NS_REFINED_FOR_SWIFT;
+
+- (BOOL)rayTestFrom:(vector_float3)from to:(vector_float3)to hit:(BulletHitboxHit *)hit NS_REFINED_FOR_SWIFT;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,115 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import "BulletHitboxWorld.h"
+#import "BulletCollision/CollisionDispatch/btHitboxWorld.h"
+
+static btTransform transformFromMatrix(const matrix_float4x4 &matrix)
+{
+  btTransform transform;
+  transform.setFromOpenGLMatrix(reinterpret_cast<const btScalar *>(&matrix));
+  return transform;
+}
+
+@implementation BulletHitboxWorld
+{
+  btHitboxWorld *m_world;
+  btAlignedObjectArray<btTransform> m_bones;
+}
+
+- (instancetype)init
+{
+  return [self initWithMargin:0.05f];
+}
+
+- (instancetype)initWithMargin:(float)margin
+{
+  self = [super init];
+  if (self) {
+    m_world = new btHitboxWorld(margin);
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  delete m_world;
+}
+
+- (NSInteger)addModelWithHitboxes:(const BulletHitbox *)hitboxes count:(NSUInteger)count
+{
+  btAlignedObjectArray<btHitbox> converted;
+  converted.resize((int)count);
+  
+  for (NSUInteger i = 0; i < count; i++) {
+    btHitbox &hitbox = converted[(int)i];
+    hitbox.m_bone = hitboxes[i].bone;
+    hitbox.m_group = hitboxes[i].group;
+    hitbox.m_min = btVector3(hitboxes[i].mins.x, hitboxes[i].mins.y, hitboxes[i].mins.z);
+    hitbox.m_max = btVector3(hitboxes[i].maxs.x, hitboxes[i].maxs.y, hitboxes[i].maxs.z);
+  }
+  
+  return m_world->addModel(count ? &converted[0] : nullptr, (int)count);
+}
+
+- (NSInteger)addEntityWithModel:(NSInteger)model
+{
+  return m_world->addEntity((int)model);
+}
+
+- (void)removeEntity:(NSInteger)entity
+{
+  m_world->removeEntity((int)entity);
+}
+
+- (void)setPoseOfEntity:(NSInteger)entity
+              transform:(matrix_float4x4)transform
+                  bones:(const matrix_float4x4 *)bones
+                  count:(NSUInteger)count
+{
+  m_bones.resize(bones ? (int)count : 0);
+  
+  for (int i = 0; i < m_bones.size(); i++) {
+    m_bones[i] = transformFromMatrix(bones[i]);
+  }
+  
+  m_world->setPose((int)entity, transformFromMatrix(transform), m_bones.size() ? &m_bones[0] : nullptr, m_bones.size());
+}
+
+- (BOOL)rayTestFrom:(vector_float3)from to:(vector_float3)to hit:(BulletHitboxHit *)hit
+{
+  btHitboxWorld::RayResult result;
+  
+  if (!m_world->rayTest(btVector3(from.x, from.y, from.z), btVector3(to.x, to.y, to.z), result)) {
+    return NO;
+  }
+  
+  hit->entity = result.m_entity;
+  hit->hitbox = result.m_hitbox;
+  hit->bone = result.m_bone;
+  hit->group = result.m_group;
+  hit->fraction = result.m_fraction;
+  hit->point = simd_make_float3(result.m_point.x(), result.m_point.y(), result.m_point.z());
+  hit->normal = simd_make_float3(result.m_normal.x(), result.m_normal.y(), result.m_normal.z());
+  
+  return YES;
+}
+
+@end
@@ -0,0 +1,68 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Same signatures as btMemoryTracker::allocate and deallocate, for the allocator hooks of Recast and Detour
+typedef void * _Nullable (*BulletAllocFunction)(size_t size, int tag);
+typedef void (*BulletFreeFunction)(void * _Nullable ptr);
+
+/// Allocations of one tag, frame counters are the ones of the last frame closed by nextFrame
+typedef struct {
+  int64_t liveBytes;
+  int64_t peakBytes;
+  int64_t liveAllocations;
+  int64_t totalAllocations;
+  int64_t frameAllocations;
+  int64_t frameBytes;
+  /// Allocations of the frame that went to malloc instead of an arena
+  int64_t frameMallocs;
+} BulletMemoryStats;
+
+/// Counts every native allocation by subsystem: Bullet's broadphase, narrowphase, islands, solver and queries
+/// are tagged by the library itself, other libraries register tags and allocate through allocFunction.
+@interface BulletMemoryTracker : NSObject
+
+/// Routes every Bullet allocation through the tracker for good. NO when Bullet memory is already in use,
+/// so call it at launch before any world is created
++ (BOOL)install;
+@property (class, nonatomic, readonly) BOOL isInstalled;
+
+/// Index of the tag called name, added the first time, -1 when there's no room left
++ (int)registerTag:(NSString *)name;
+@property (class, nonatomic, readonly) int numberOfTags;
++ (NSString *)nameOfTag:(int)tag;
++ (BulletMemoryStats)statsForTag:(int)tag;
+
+/// Closes the frame that frame counters report on, once per frame
++ (void)nextFrame;
+
+/// Temporaries of contact tests come from reusable per-thread chunks instead of malloc
+@property (class, nonatomic) BOOL arenaEnabled;
+@property (class, nonatomic, readonly) int64_t arenaReservedBytes;
+
+@property (class, nonatomic, readonly) BulletAllocFunction allocFunction;
+@property (class, nonatomic, readonly) BulletFreeFunction freeFunction;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,97 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import "BulletMemoryTracker.h"
+#import "LinearMath/btMemoryTracker.h"
+
+@implementation BulletMemoryTracker
+
++ (BOOL)install
+{
+  return btMemoryTracker::install();
+}
+
++ (BOOL)isInstalled
+{
+  return btMemoryTracker::isInstalled();
+}
+
++ (int)registerTag:(NSString *)name
+{
+  return btMemoryTracker::registerTag(name.UTF8String);
+}
+
++ (int)numberOfTags
+{
+  return btMemoryTracker::getNumTags();
+}
+
++ (NSString *)nameOfTag:(int)tag
+{
+  return [NSString stringWithUTF8String:btMemoryTracker::getTagName(tag)];
+}
+
++ (BulletMemoryStats)statsForTag:(int)tag
+{
+  btMemoryTagStats stats;
+  btMemoryTracker::getStats(tag, stats);
+  
+  BulletMemoryStats out;
+  out.liveBytes = stats.m_liveBytes;
+  out.peakBytes = stats.m_peakBytes;
+  out.liveAllocations = stats.m_liveAllocations;
+  out.totalAllocations = stats.m_totalAllocations;
+  out.frameAllocations = stats.m_frameAllocations;
+  out.frameBytes = stats.m_frameBytes;
+  out.frameMallocs = stats.m_frameMallocs;
+  return out;
+}
+
++ (void)nextFrame
+{
+  btMemoryTracker::nextFrame();
+}
+
++ (BOOL)arenaEnabled
+{
+  return btMemoryTracker::isArenaEnabled();
+}
+
++ (void)setArenaEnabled:(BOOL)arenaEnabled
+{
+  btMemoryTracker::setArenaEnabled(arenaEnabled);
+}
+
++ (int64_t)arenaReservedBytes
+{
+  return btMemoryTracker::getArenaReservedBytes();
+}
+
++ (BulletAllocFunction)allocFunction
+{
+  return btMemoryTracker::allocate;
+}
+
++ (BulletFreeFunction)freeFunction
+{
+  return btMemoryTracker::deallocate;
+}
+
+@end
@@ -0,0 +1,54 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+#import "BulletCast.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class BulletCollisionObject;
+
+/// A reusable list of ray or sweep queries answered in one call to BulletWorld.
+/// Queries are sorted for coherence and spread over the world's worker threads,
+/// results are read back by the index addRayFrom returned.
+@interface BulletQueryBatch : NSObject
+@property (nonatomic, readonly) NSUInteger count;
+
+- (instancetype)init;
+- (NSUInteger)addRayFrom:(vector_float3)fromPos
+                      to:(vector_float3)toPos
+    collisionFilterGroup:(int)collisionFilterGroup
+     collisionFilterMask:(int)collisionFilterMask;
+- (void)removeAllQueries;
+
+- (BOOL)hasHitAtIndex:(NSUInteger)index;
+- (float)hitFractionAtIndex:(NSUInteger)index;
+- (vector_float3)hitPosAtIndex:(NSUInteger)index;
+- (vector_float3)hitNormalAtIndex:(NSUInteger)index;
+- (nullable BulletCollisionObject *)nodeAtIndex:(NSUInteger)index;
+- (int)shapePartAtIndex:(NSUInteger)index;
+- (int)triangleIndexAtIndex:(NSUInteger)index;
+
+- (void)rayTestInWorld:(btDynamicsWorldC *)world;
+- (void)convexTestInWorld:(btDynamicsWorldC *)world shape:(btCollisionShapeC *)shape;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,139 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import "BulletQueryBatch.h"
+#import "BulletCollisionObject.h"
+#import "BulletCollision/CollisionDispatch/btCollisionWorld.h"
+#import "BulletCollision/CollisionShapes/btConvexShape.h"
+
+@implementation BulletQueryBatch
+{
+  btAlignedObjectArray<btVector3> m_from;
+  btAlignedObjectArray<btVector3> m_to;
+  btAlignedObjectArray<int> m_filterGroups;
+  btAlignedObjectArray<int> m_filterMasks;
+  btCollisionWorld::BatchedQueryResults m_results;
+}
+
+- (instancetype)init
+{
+  self = [super init];
+  return self;
+}
+
+- (NSUInteger)count
+{
+  return m_from.size();
+}
+
+- (NSUInteger)addRayFrom:(vector_float3)fromPos
+                      to:(vector_float3)toPos
+    collisionFilterGroup:(int)collisionFilterGroup
+     collisionFilterMask:(int)collisionFilterMask
+{
+  m_from.push_back(btVector3(fromPos.x, fromPos.y, fromPos.z));
+  m_to.push_back(btVector3(toPos.x, toPos.y, toPos.z));
+  m_filterGroups.push_back(collisionFilterGroup);
+  m_filterMasks.push_back(collisionFilterMask);
+  return m_from.size() - 1;
+}
+
+- (void)removeAllQueries
+{
+  // keeps the capacity, a batch is meant to be refilled every frame
+  m_from.resize(0);
+  m_to.resize(0);
+  m_filterGroups.resize(0);
+  m_filterMasks.resize(0);
+  m_results.resize(0);
+}
+
+- (BOOL)hasHitAtIndex:(NSUInteger)index
+{
+  return m_results.hasHit((int)index);
+}
+
+- (float)hitFractionAtIndex:(NSUInteger)index
+{
+  return m_results.m_hitFraction[(int)index];
+}
+
+- (vector_float3)hitPosAtIndex:(NSUInteger)index
+{
+  btVector3 v = m_results.m_hitPointWorld[(int)index];
+  return vector3(v.x(), v.y(), v.z());
+}
+
+- (vector_float3)hitNormalAtIndex:(NSUInteger)index
+{
+  btVector3 v = m_results.m_hitNormalWorld[(int)index];
+  return vector3(v.x(), v.y(), v.z());
+}
+
+- (BulletCollisionObject *)nodeAtIndex:(NSUInteger)index
+{
+  const btCollisionObject *objectPtr = m_results.m_hitCollisionObject[(int)index];
+  return (objectPtr) ? (__bridge BulletCollisionObject *)objectPtr->getUserPointer() : nil;
+}
+
+- (int)shapePartAtIndex:(NSUInteger)index
+{
+  return m_results.m_shapePart[(int)index];
+}
+
+- (int)triangleIndexAtIndex:(NSUInteger)index
+{
+  return m_results.m_triangleIndex[(int)index];
+}
+
+- (void)rayTestInWorld:(btDynamicsWorldC *)world
+{
+  if (m_from.size() == 0) {
+    m_results.resize(0);
+    return;
+  }
+  
+  bullet_cast(world)->rayTestBatch(&m_from[0], &m_to[0], &m_filterGroups[0], &m_filterMasks[0], m_from.size(), m_results);
+}
+
+- (void)convexTestInWorld:(btDynamicsWorldC *)world shape:(btCollisionShapeC *)shape
+{
+  if (m_from.size() == 0) {
+    m_results.resize(0);
+    return;
+  }
+  
+  btCollisionShape *collisionShape = bullet_cast(shape);
+  NSAssert(collisionShape->isConvex(), @"sweeps need a convex shape");
+  
+  btAlignedObjectArray<btTransform> from;
+  btAlignedObjectArray<btTransform> to;
+  from.resize(m_from.size());
+  to.resize(m_to.size());
+  
+  for (int i = 0; i < m_from.size(); i++) {
+    from[i] = btTransform(btQuaternion::getIdentity(), m_from[i]);
+    to[i] = btTransform(btQuaternion::getIdentity(), m_to[i]);
+  }
+  
+  bullet_cast(world)->convexSweepTestBatch(static_cast<btConvexShape *>(collisionShape), &from[0], &to[0], &m_filterGroups[0], &m_filterMasks[0], m_from.size(), m_results);
+}
+
+@end
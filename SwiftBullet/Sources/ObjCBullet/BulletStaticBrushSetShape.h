@@ -0,0 +1,45 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import <Foundation/Foundation.h>
+#import <simd/simd.h>
+#import "BulletCollisionShape.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// All static brushes of a map in one shape, queried through a quantized BVH.
+/// Add every brush, then call buildBvh before adding the shape to a rigid body.
+/// A built set can be baked into a file that initWithBakedFile loads back without building anything.
+@interface BulletStaticBrushSetShape : BulletCollisionShape
+- (instancetype)init;
+/// Maps a file written from bakeWithSourceHash, nil when it is missing, was baked by another build
+/// or from another source than sourceHash
+- (nullable instancetype)initWithBakedFile:(NSString *)path sourceHash:(uint64_t)sourceHash;
+/// brush must be polyhedral (convex hull, box) and in the space of the brush set
+- (void)addBrush:(BulletCollisionShape *)brush;
+- (void)buildBvh;
+- (NSUInteger)numberOfBrushes;
+/// nil for a set loaded from a baked file, its brushes have no wrappers
+- (nullable BulletCollisionShape *)brushAtIndex:(NSUInteger)index;
+/// Brushes and BVH in one blob, nil before buildBvh or when a brush is neither a brush nor a convex hull shape
+- (nullable NSData *)bakeWithSourceHash:(uint64_t)sourceHash;
+@end
+
+NS_ASSUME_NONNULL_END
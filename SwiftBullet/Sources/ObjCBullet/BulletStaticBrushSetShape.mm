@@ -0,0 +1,148 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import "BulletStaticBrushSetShape.h"
+#import "BulletCollision/CollisionShapes/btStaticBrushSetShape.h"
+#import "BulletCollision/CollisionShapes/btBakedBrushSet.h"
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import <fcntl.h>
+#import <unistd.h>
+
+@implementation BulletStaticBrushSetShape
+{
+  btStaticBrushSetShape *m_shape;
+  NSMutableArray<BulletCollisionShape *> *m_brushes;
+  // set when loaded from a baked file, owns m_shape and the brushes; the bvh lives in the mapping
+  btBakedBrushSet *m_baked;
+  void *m_mapping;
+  size_t m_mappingSize;
+}
+
+- (instancetype)init
+{
+  self = [super init];
+  if (self) {
+    m_shape = new btStaticBrushSetShape();
+    m_shape->setUserPointer((__bridge void *)self);
+    m_brushes = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (nullable instancetype)initWithBakedFile:(NSString *)path sourceHash:(uint64_t)sourceHash
+{
+  self = [super init];
+  if (self) {
+    int fd = open(path.fileSystemRepresentation, O_RDONLY);
+    if (fd < 0) {
+      return nil;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0 || info.st_size > UINT32_MAX) {
+      close(fd);
+      return nil;
+    }
+    
+    // private and writable: deserializing the bvh in place fixes up its array pointers, the file is left alone
+    void *mapping = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+      return nil;
+    }
+    
+    m_mapping = mapping;
+    m_mappingSize = (size_t)info.st_size;
+    m_baked = new btBakedBrushSet();
+    
+    if (!m_baked->load(m_mapping, (unsigned)m_mappingSize, sourceHash)) {
+      return nil;
+    }
+    
+    m_shape = m_baked->getShape();
+    m_shape->setUserPointer((__bridge void *)self);
+    m_brushes = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  if (m_baked) {
+    delete m_baked;
+  } else {
+    delete m_shape;
+  }
+  if (m_mapping) {
+    munmap(m_mapping, m_mappingSize);
+  }
+}
+
+- (btCollisionShapeC *)ptr
+{
+  return bullet_cast(static_cast<btCollisionShape *>(m_shape));
+}
+
+- (void)addBrush:(BulletCollisionShape *)brush
+{
+  NSAssert(m_baked == nullptr, @"brushes can't be added to a baked set");
+
+  btCollisionShape *shape = bullet_cast(brush.ptr);
+  NSAssert(shape->isPolyhedral(), @"brush must be a polyhedral convex shape");
+  
+  [m_brushes addObject:brush];
+  m_shape->addBrush(static_cast<btPolyhedralConvexShape *>(shape));
+}
+
+- (void)buildBvh
+{
+  m_shape->buildBvh();
+}
+
+- (NSUInteger)numberOfBrushes
+{
+  return m_shape->getNumBrushes();
+}
+
+- (nullable BulletCollisionShape *)brushAtIndex:(NSUInteger)index
+{
+  return m_baked ? nil : m_brushes[index];
+}
+
+- (nullable NSData *)bakeWithSourceHash:(uint64_t)sourceHash
+{
+  unsigned size = btBakedBrushSet::calculateBakedSize(m_shape);
+  if (size == 0) {
+    return nil;
+  }
+  
+  void *buffer = btAlignedAlloc(size, 16);
+  if (!btBakedBrushSet::bake(m_shape, sourceHash, buffer, size)) {
+    btAlignedFree(buffer);
+    return nil;
+  }
+  
+  NSData *data = [NSData dataWithBytes:buffer length:size];
+  btAlignedFree(buffer);
+  return data;
+}
+
+@end
@@ -0,0 +1,65 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// One stepSimulation call, times are in milliseconds since the profiler was created.
+/// pairs, manifolds and contactPoints are counted after the last tick, the others summed over the ticks
+typedef struct {
+  uint64_t index;
+  double startTime;
+  double duration;
+  int numberOfTicks;
+  int pairs;
+  int manifolds;
+  int contactPoints;
+  int islands;
+  int solverIterations;
+  int ccdHits;
+} BulletTraceFrame;
+
+/// Records every profile zone of Bullet into a lock-free ring buffer per thread, and the counters above per step,
+/// from any world while installed. Only one profiler is installed at a time, install and uninstall between steps.
+@interface BulletTraceProfiler : NSObject
+@property (nonatomic, readonly) BOOL isInstalled;
+/// Number of frames kept for frames(maxCount:)
+@property (nonatomic, readonly) NSUInteger maxFrames;
+
+- (instancetype)init;
+/// eventsPerThread zones are kept for every thread stepping or helping to step a world
+- (instancetype)initWithEventsPerThread:(NSUInteger)eventsPerThread maxFrames:(NSUInteger)maxFrames;
+
+- (void)install;
+- (void)uninstall;
+
+/// Copies up to maxCount of the last frames into frames, oldest first, and returns how many.
+/// Can be called while a world steps on another thread
+- (NSUInteger)copyFrames:(BulletTraceFrame *)frames maxCount:(NSUInteger)maxCount NS_REFINED_FOR_SWIFT;
+
+/// The recorded zones and frame counters as Chrome trace event JSON, opened by chrome://tracing and Perfetto
+- (NSData *)chromeTrace;
+
+/// Forgets the recorded zones and frames
+- (void)clear;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,107 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import "BulletTraceProfiler.h"
+#import "LinearMath/btTraceProfiler.h"
+
+@implementation BulletTraceProfiler
+{
+  btTraceProfiler *m_profiler;
+  btAlignedObjectArray<btTraceFrame> m_frames;
+}
+
+- (instancetype)init
+{
+  return [self initWithEventsPerThread:65536 maxFrames:600];
+}
+
+- (instancetype)initWithEventsPerThread:(NSUInteger)eventsPerThread maxFrames:(NSUInteger)maxFrames
+{
+  self = [super init];
+  if (self) {
+    m_profiler = new btTraceProfiler((int)eventsPerThread, (int)maxFrames);
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  // uninstalls itself
+  delete m_profiler;
+}
+
+- (BOOL)isInstalled
+{
+  return btTraceProfiler::getInstalled() == m_profiler;
+}
+
+- (NSUInteger)maxFrames
+{
+  return m_profiler->getMaxFrames();
+}
+
+- (void)install
+{
+  btTraceProfiler::install(m_profiler);
+}
+
+- (void)uninstall
+{
+  if (self.isInstalled) {
+    btTraceProfiler::install(nullptr);
+  }
+}
+
+- (NSUInteger)copyFrames:(BulletTraceFrame *)frames maxCount:(NSUInteger)maxCount
+{
+  // the counters are 64 bit on the Bullet side
+  m_frames.resize((int)btMin(maxCount, self.maxFrames));
+  const int count = m_frames.size() ? m_profiler->getFrames(&m_frames[0], m_frames.size()) : 0;
+  
+  for (int i = 0; i < count; i++) {
+    const btTraceFrame &frame = m_frames[i];
+    BulletTraceFrame &out = frames[i];
+    out.index = frame.m_index;
+    out.startTime = frame.m_startTime * 1e-6;
+    out.duration = frame.m_duration * 1e-6;
+    out.numberOfTicks = frame.m_numTicks;
+    out.pairs = (int)frame.m_counters[BT_TRACE_PAIRS];
+    out.manifolds = (int)frame.m_counters[BT_TRACE_MANIFOLDS];
+    out.contactPoints = (int)frame.m_counters[BT_TRACE_CONTACT_POINTS];
+    out.islands = (int)frame.m_counters[BT_TRACE_ISLANDS];
+    out.solverIterations = (int)frame.m_counters[BT_TRACE_SOLVER_ITERATIONS];
+    out.ccdHits = (int)frame.m_counters[BT_TRACE_CCD_HITS];
+  }
+  return count;
+}
+
+- (NSData *)chromeTrace
+{
+  btAlignedObjectArray<char> json;
+  m_profiler->exportChromeTrace(json);
+  return [NSData dataWithBytes:&json[0] length:json.size()];
+}
+
+- (void)clear
+{
+  m_profiler->clear();
+}
+
+@end
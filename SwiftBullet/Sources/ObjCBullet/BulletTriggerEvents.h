@@ -0,0 +1,49 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import <Foundation/Foundation.h>
+#import "BulletCast.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class BulletCollisionObject;
+@class BulletGhostObject;
+
+typedef NS_ENUM(NSInteger, BulletTriggerEventType) {
+  BulletTriggerEventType_enter = 0,
+  BulletTriggerEventType_exit = 1,
+};
+
+/// Trigger enter/exit events drained from BulletWorld once per frame, in the order they happened.
+/// Keep one around, the storage only grows.
+@interface BulletTriggerEvents : NSObject
+@property (nonatomic, readonly) NSUInteger count;
+
+- (instancetype)init;
+
+- (BulletTriggerEventType)typeAtIndex:(NSUInteger)index;
+- (nullable BulletGhostObject *)triggerAtIndex:(NSUInteger)index;
+- (nullable BulletCollisionObject *)nodeAtIndex:(NSUInteger)index;
+
+/// Takes every published event, nodes keeps the objects removed from the world alive while their events are read
+- (void)drainManager:(btTriggerManagerC *)manager retainingNodes:(NSArray<BulletCollisionObject *> *)nodes;
+@end
+
+NS_ASSUME_NONNULL_END
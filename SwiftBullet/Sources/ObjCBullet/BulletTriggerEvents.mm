@@ -0,0 +1,73 @@
+/**
+ Bullet Continuous Collision Detection and Physics Library
+ Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+ 
+ Swift Binding
+ Copyright (c) 2018 Yohei Yoshihara
+ 
+ This software is provided 'as-is', without any express or implied warranty.
+ In no event will the authors be held liable for any damages arising from the use of this software.
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it freely,
+ subject to the following restrictions:
+ 
+ 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+    If you use this software in a product, an acknowledgment in the product documentation would be appreciated
+    but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+ */
+
+#import "BulletTriggerEvents.h"
+#import "BulletCollisionObject.h"
+#import "BulletGhostObject.h"
+#import "BulletCollision/CollisionDispatch/btTriggerManager.h"
+
+@implementation BulletTriggerEvents
+{
+  btAlignedObjectArray<btTriggerEvent> m_events;
+  NSMutableArray<BulletCollisionObject *> *m_removedNodes;
+}
+
+- (instancetype)init
+{
+  self = [super init];
+  if (self) {
+    m_removedNodes = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (NSUInteger)count
+{
+  return m_events.size();
+}
+
+- (BulletTriggerEventType)typeAtIndex:(NSUInteger)index
+{
+  return (BulletTriggerEventType)m_events[(int)index].m_type;
+}
+
+- (BulletGhostObject *)triggerAtIndex:(NSUInteger)index
+{
+  const btCollisionObject *objectPtr = m_events[(int)index].m_trigger;
+  return (objectPtr) ? (__bridge BulletGhostObject *)objectPtr->getUserPointer() : nil;
+}
+
+- (BulletCollisionObject *)nodeAtIndex:(NSUInteger)index
+{
+  const btCollisionObject *objectPtr = m_events[(int)index].m_other;
+  return (objectPtr) ? (__bridge BulletCollisionObject *)objectPtr->getUserPointer() : nil;
+}
+
+- (void)drainManager:(btTriggerManagerC *)manager retainingNodes:(NSArray<BulletCollisionObject *> *)nodes
+{
+  btTriggerManager *m = bullet_cast(manager);
+  
+  // keeps the capacity of both sides
+  m_events.copyFromArray(m->getEvents());
+  m->clearEvents();
+  [m_removedNodes setArray:nodes];
+}
+
+@end
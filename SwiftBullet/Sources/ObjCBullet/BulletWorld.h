@@ -31,17 +31,54 @@ NS_ASSUME_NONNULL_BEGIN
 @class BulletCollisionShape;
 @class BulletAllHitsRayResult;
 @class BulletClosestHitRayResult;
+@class BulletQueryBatch;
+@class BulletContactEvents;
+@class BulletTriggerEvents;
 @class BulletVehicle;
 @class BulletPersistentManifold;
 
+/// Rigid body transform from the buffer filled after every asynchronous step, rotation is a quaternion (x, y, z, w)
+typedef struct {
+    vector_float3 position;
+    vector_float4 rotation;
+} BulletBodyTransform;
+
+/// Bodies per tier of the simulation LOD at its last regrouping, and how many of them were stepped on the last tick
+typedef struct {
+    int fullRate;
+    int reducedRate;
+    int lowRate;
+    int frozen;
+    int stepped;
+} BulletLodStats;
+
+/// Dbvt keeps a tree that only changes where bodies moved, HashGrid builds grids of cells again on every step and pays
+/// off when thousands of small bodies move at once
+typedef NS_ENUM(NSInteger, BulletBroadphaseType) {
+    BulletBroadphaseTypeDbvt,
+    BulletBroadphaseTypeHashGrid
+};
+
 @interface BulletWorld : NSObject
 
 + (btCollisionObjectC *)getCollisionObject:(BulletCollisionObject *)node;
 - (btDynamicsWorldC *)getWorld;
 
 @property (nonatomic) vector_float3 gravity;
+@property (nonatomic, readonly) int numberOfThreads;
 
 - (instancetype)init;
+
+/// numberOfThreads > 1 builds btDiscreteDynamicsWorldMt stepped by the native task scheduler,
+/// 0 uses every core, 1 is the same as init
+- (instancetype)initWithNumberOfThreads:(int)numberOfThreads NS_REFINED_FOR_SWIFT;
+/// batchedSolver solves contacts with btBatchedConstraintSolver, several rows at a time with SSE, AVX or NEON
+- (instancetype)initWithNumberOfThreads:(int)numberOfThreads batchedSolver:(BOOL)batchedSolver NS_REFINED_FOR_SWIFT;
+/// Snapshots and deterministic stepping need the Dbvt broadphase
+- (instancetype)initWithNumberOfThreads:(int)numberOfThreads
+                          batchedSolver:(BOOL)batchedSolver
+                             broadphase:(BulletBroadphaseType)broadphase NS_REFINED_FOR_SWIFT;
+@property (nonatomic, readonly) BulletBroadphaseType broadphaseType;
 - (void)registerGImpact;
 
 - (int)stepSimulationWithTimeStep:(float)timeStep maxSubSteps:(int)maxSubSteps fixedTimeStep:(float)fixedTimeStep NS_REFINED_FOR_SWIFT;
@@ -51,12 +88,17 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)addRigidBody:(BulletRigidBody *)rigidBody withCollisionFilterGroup:(int)collisionFilterGroup
     collisionFilterMask:(int)collisionFilterMask NS_REFINED_FOR_SWIFT;
 - (void)addRigidBody:(BulletRigidBody *)rigidBody NS_REFINED_FOR_SWIFT;
+/// Adds bodies of zero mass in one go and builds the static broadphase tree once, for loading a map
+- (void)addStaticRigidBodies:(NSArray<BulletRigidBody *> *)rigidBodies NS_REFINED_FOR_SWIFT;
 - (void)removeRigidBody:(BulletRigidBody *)rigidBody NS_REFINED_FOR_SWIFT;
 - (void)removeAllRigidBodies;
 - (BulletRigidBody *)rigidBodyAt:(NSUInteger)index;
 - (NSUInteger)numberOfRigidBodies;
 
 - (void)addGhost:(BulletGhostObject *)ghostNode NS_REFINED_FOR_SWIFT;
+/// Adds a ghost whose enter/exit events are drained with drainTriggerEvents, removed with removeGhost.
+/// exact waits for a narrowphase contact instead of overlapping bounding boxes
+- (void)addTrigger:(BulletGhostObject *)trigger exact:(BOOL)exact NS_REFINED_FOR_SWIFT;
 - (void)removeGhost:(BulletGhostObject *)ghostNode NS_REFINED_FOR_SWIFT;
 - (void)removeAllGhosts;
 - (BulletGhostObject *)ghostAt:(NSUInteger)index;
@@ -72,8 +114,81 @@ NS_ASSUME_NONNULL_BEGIN
 - (BulletContactResult *)contactTestPairWithNode0:(BulletCollisionObject *)node0 node1:(BulletCollisionObject *)node1;
 
 - (NSUInteger)numberOfManifolds;
+- (NSUInteger)numberOfOverlappingPairs;
 - (BulletPersistentManifold *)manifoldByIndex:(NSUInteger)index;
 
+/// Starts queueing begin/persist/end events of touching pairs after every internal tick,
+/// capacity is the number of events kept between two drains
+- (void)enableContactEventsWithCapacity:(NSUInteger)capacity reportPersistent:(BOOL)reportPersistent;
+/// Moves the events queued since the last call into events, once per frame
+- (void)drainContactEvents:(BulletContactEvents *)events;
+
+- (NSUInteger)numberOfNodesInsideTrigger:(BulletGhostObject *)trigger;
+/// Moves the trigger events published since the last call into events, once per frame
+- (void)drainTriggerEvents:(BulletTriggerEvents *)events;
+
+/// Interpolated transforms of awake bodies go straight into these arrays after every step, at the index from
+/// addTransformExportForRigidBody; any of them may be NULL, capacity is the number of bodies each holds.
+/// With async stepping, read them between waitForStep and beginStep
+- (void)setTransformExportPositions:(nullable vector_float3 *)positions
+                          rotations:(nullable vector_float4 *)rotations
+                           matrices:(nullable matrix_float4x4 *)matrices
+                           capacity:(NSUInteger)capacity;
+- (NSInteger)addTransformExportForRigidBody:(BulletRigidBody *)rigidBody NS_REFINED_FOR_SWIFT;
+- (void)removeTransformExportForRigidBody:(BulletRigidBody *)rigidBody NS_REFINED_FOR_SWIFT;
+/// Indices written since the last clear, each once; sleeping bodies aren't written
+- (nullable const int *)dirtyTransformIndicesWithCount:(NSUInteger *)count NS_REFINED_FOR_SWIFT;
+- (void)clearDirtyTransformIndices;
+
+/// Steps on a thread of its own from now on, single-threaded world only. beginStep returns right away and waitForStep
+/// blocks until that step is done; the world may only be queried or changed in between, while a step runs use
+/// the queue methods and the transform buffer
+- (void)enableAsyncStepping;
+@property (nonatomic, readonly) BOOL isStepping;
+- (void)beginStepWithTimeStep:(float)timeStep maxSubSteps:(int)maxSubSteps fixedTimeStep:(float)fixedTimeStep NS_REFINED_FOR_SWIFT;
+/// Does nothing unless a step is running
+- (void)waitForStep;
+
+/// Index of rigidBody in the transforms written after every asynchronous step, starting with the next one
+- (NSInteger)addTransformSlotForRigidBody:(BulletRigidBody *)rigidBody NS_REFINED_FOR_SWIFT;
+- (void)removeTransformSlot:(NSInteger)slot NS_REFINED_FOR_SWIFT;
+/// Transforms of the last finished step by slot, valid until the next call, never half written
+- (nullable const BulletBodyTransform *)acquireTransformsWithCount:(NSUInteger *)count NS_REFINED_FOR_SWIFT;
+
+/// Applied in order at the start of the next asynchronous step
+- (void)queueCentralImpulse:(vector_float3)impulse toRigidBody:(BulletRigidBody *)rigidBody;
+- (void)queueCentralForce:(vector_float3)force toRigidBody:(BulletRigidBody *)rigidBody;
+- (void)queueLinearVelocity:(vector_float3)velocity toRigidBody:(BulletRigidBody *)rigidBody;
+- (void)queueTeleportRigidBody:(BulletRigidBody *)rigidBody origin:(vector_float3)origin rotation:(vector_float4)rotation;
+- (void)queueAddRigidBody:(BulletRigidBody *)rigidBody;
+- (void)queueRemoveRigidBody:(BulletRigidBody *)rigidBody;
+
+/// Stepping on from a restored snapshot repeats what followed the capture bit for bit from now on,
+/// call before the first step, single-threaded world only
+- (void)enableDeterministicStepping;
+/// Positions, velocities, sleeping state, contacts and constraint impulses of everything but static bodies.
+/// Contact and trigger events, vehicles and the transform slots of async stepping aren't part of it
+- (NSData *)captureSnapshot;
+/// Writes a snapshot of this world back in place, NO when bodies, ghosts or constraints were added or removed since
+- (BOOL)restoreSnapshot:(NSData *)snapshot;
+
+/// Keeps simulation islands from one tick to the next instead of rebuilding them every tick, so a world of mostly sleeping
+/// bodies pays only for the awake ones. Same islands and results as before, single-threaded world only
+- (void)enableIncrementalIslands;
+
+/// Steps islands of added bodies farther than reducedRateDistance from the viewer every second tick and past
+/// lowRateDistance every fourth, a larger timestep on the tick they run; past frozenDistance they hold still until the
+/// viewer comes closer. Islands outside the view cone count twice as far
+- (void)enableSimulationLodWithReducedRateDistance:(float)reducedRateDistance
+                                   lowRateDistance:(float)lowRateDistance
+                                    frozenDistance:(float)frozenDistance;
+/// alwaysFullRate keeps the body and whatever touches it on every tick, for bodies the gameplay depends on
+- (void)addLodForRigidBody:(BulletRigidBody *)rigidBody alwaysFullRate:(BOOL)alwaysFullRate NS_REFINED_FOR_SWIFT;
+- (void)removeLodForRigidBody:(BulletRigidBody *)rigidBody NS_REFINED_FOR_SWIFT;
+/// Once per frame before the step, cosHalfAngle of the view cone
+- (void)setLodViewerPosition:(vector_float3)position direction:(vector_float3)direction cosHalfAngle:(float)cosHalfAngle;
+@property (nonatomic, readonly) BulletLodStats lodStats;
+
 - (BulletAllHitsRayResult *)rayTestAllFrom:(vector_float3)fromPos
                                         to:(vector_float3)toPos
                       collisionFilterGroup:(int)collisionFilterGroup
@@ -90,6 +205,11 @@ NS_ASSUME_NONNULL_BEGIN
                                 collisionFilterGroup:(int)collisionFilterGroup
                                  collisionFilterMask:(int)collisionFilterMask;
 
+/// Answers every ray of the batch, in parallel when the world has worker threads
+- (void)rayTestBatch:(BulletQueryBatch *)batch;
+/// Sweeps shape along every ray of the batch, shape must be convex
+- (void)convexTestBatch:(BulletQueryBatch *)batch shape:(BulletCollisionShape *)shape;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -21,6 +21,9 @@
 #import "BulletAllHitsRayResult.h"
 #import "BulletClosestHitRayResult.h"
 #import "BulletClosestHitConvexResult.h"
+#import "BulletQueryBatch.h"
+#import "BulletContactEvents.h"
+#import "BulletTriggerEvents.h"
 #import "BulletConstraint.h"
 #import "BulletContactResult.h"
 #import "BulletGhostObject.h"
@@ -29,27 +32,78 @@
 #import "BulletUpAxis.h"
 #import "BulletPersistentManifold.h"
 #import "BulletCollision/CollisionShapes/btBox2dShape.h"
+#import "BulletCollision/BroadphaseCollision/btHashGridBroadphase.h"
 #import "btBulletDynamicsCommon.h"
 #import "BulletCollision/CollisionDispatch/btGhostObject.h"
 #import "BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h"
+#import "BulletCollision/CollisionDispatch/btStaticBrushSetCollisionAlgorithm.h"
+#import "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#import "BulletCollision/CollisionDispatch/btContactEventQueue.h"
+#import "BulletCollision/CollisionDispatch/btTriggerManager.h"
+#import "BulletDynamics/ConstraintSolver/btBatchedConstraintSolver.h"
+#import "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#import "BulletDynamics/Dynamics/btAsyncStepper.h"
+#import "BulletDynamics/Dynamics/btIncrementalIslandManager.h"
+#import "BulletDynamics/Dynamics/btSimulationLod.h"
+#import "BulletDynamics/Dynamics/btTransformExport.h"
+#import "BulletDynamics/Dynamics/btWorldSnapshot.h"
+#import "LinearMath/btTaskSchedulerNative.h"
 
 #import "BulletCollisionShape.h"
 
 @interface BulletWorld ()
 @end
 
+static_assert(sizeof(BulletBodyTransform) == sizeof(btAsyncStepper::BodyTransform), "frames are handed out as BulletBodyTransform");
+
+// what runs after every internal tick, the world's user info points to it
+struct BulletWorldTickCallbacks
+{
+    btContactEventQueue *contactEvents = nullptr;
+    btTriggerManager *triggers = nullptr;
+};
+
+static void worldTickCallback(btDynamicsWorld *world, btScalar timeStep)
+{
+    BulletWorldTickCallbacks *callbacks = static_cast<BulletWorldTickCallbacks *>(world->getWorldUserInfo());
+    
+    if (callbacks->contactEvents) {
+        callbacks->contactEvents->processManifolds(world->getDispatcher());
+    }
+    
+    if (callbacks->triggers) {
+        callbacks->triggers->processTriggers();
+    }
+}
+
 @implementation BulletWorld
 {
     btDefaultCollisionConfiguration *m_collisionConfig;
-    btDbvtBroadphase *m_broadphase;
+    btBroadphaseInterface *m_broadphase;
+    BulletBroadphaseType m_broadphaseType;
     btCollisionDispatcher *m_collisionDispatcher;
-    btSequentialImpulseConstraintSolver *m_constraintSolver;
+    btConstraintSolver *m_constraintSolver;
     btDiscreteDynamicsWorld *m_world;
+    int m_numberOfThreads;
+    btGhostPairCallback *m_ghostPairCallback;
+    btContactEventQueue *m_contactEvents;
+    btTriggerManager *m_triggers;
+    BulletWorldTickCallbacks m_tickCallbacks;
+    btAsyncStepper *m_stepper;
+    btTransformExport *m_transformExport;
+    btWorldSnapshot *m_snapshot;
+    btIncrementalIslandManager *m_islands;
+    btSimulationLod *m_lod;
     
     NSMutableArray<BulletRigidBody *> *m_bodies;
     NSMutableArray<BulletGhostObject *> *m_ghosts;
     NSMutableArray<BulletConstraint *> *m_constraints;
     NSMutableArray *m_vehicles;
+    NSMutableArray<BulletCollisionObject *> *m_removedContactNodes;
+    NSMutableArray<BulletCollisionObject *> *m_removedTriggerNodes;
+    NSMutableArray *m_slotNodes;
+    NSMutableArray<BulletRigidBody *> *m_pendingReleases;
+    NSMutableArray<BulletRigidBody *> *m_releasesInFlight;
 }
 
 + (btCollisionObjectC *)getCollisionObject:(BulletCollisionObject *)node
@@ -69,34 +123,140 @@
 }
 
 - (instancetype)init
+{
+    return [self initWithNumberOfThreads:1];
+}
+
+- (instancetype)initWithNumberOfThreads:(int)numberOfThreads
+{
+    return [self initWithNumberOfThreads:numberOfThreads batchedSolver:NO];
+}
+
+- (instancetype)initWithNumberOfThreads:(int)numberOfThreads batchedSolver:(BOOL)batchedSolver
+{
+    return [self initWithNumberOfThreads:numberOfThreads batchedSolver:batchedSolver broadphase:BulletBroadphaseTypeDbvt];
+}
+
+- (instancetype)initWithNumberOfThreads:(int)numberOfThreads
+                          batchedSolver:(BOOL)batchedSolver
+                             broadphase:(BulletBroadphaseType)broadphase
 {
     self = [super init];
     
     if (self)
     {
-        m_collisionConfig = new btDefaultCollisionConfiguration();
-        m_broadphase = new btDbvtBroadphase();
-        m_collisionDispatcher = new btCollisionDispatcher(m_collisionConfig);
-        m_constraintSolver = new btSequentialImpulseConstraintSolver();
-        m_world = new btDiscreteDynamicsWorld(m_collisionDispatcher,
-                                              m_broadphase,
-                                              m_constraintSolver,
-                                              m_collisionConfig);
+        m_broadphaseType = broadphase;
+        if (broadphase == BulletBroadphaseTypeHashGrid)
+        {
+            m_broadphase = new btHashGridBroadphase();
+        }
+        else
+        {
+            m_broadphase = new btDbvtBroadphase();
+        }
+        
+        btITaskScheduler *scheduler = numberOfThreads != 1 ? btGetNativeTaskScheduler() : nullptr;
+        
+        if (scheduler)
+        {
+            m_numberOfThreads = numberOfThreads > 0 ? btMin(numberOfThreads, int(BT_MAX_THREAD_COUNT)) : scheduler->getMaxNumThreads();
+        }
+        else
+        {
+            m_numberOfThreads = 1;
+        }
+        
+        if (m_numberOfThreads > 1)
+        {
+            // the scheduler is global, the last multithreaded world decides the thread count
+            scheduler->setNumThreads(m_numberOfThreads);
+            btSetTaskScheduler(scheduler);
+            
+            // pools are shared by the worker threads, keep them from spilling to the heap
+            btDefaultCollisionConstructionInfo info;
+            info.m_defaultMaxPersistentManifoldPoolSize = 80000;
+            info.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+            
+            m_collisionConfig = new btDefaultCollisionConfiguration(info);
+            m_collisionDispatcher = new btCollisionDispatcherMt(m_collisionConfig);
+            
+            btConstraintSolverPoolMt *solverPool;
+            if (batchedSolver)
+            {
+                // the pool deletes the solvers it is given
+                btAlignedObjectArray<btConstraintSolver *> solvers;
+                for (int i = 0; i < m_numberOfThreads; i++)
+                {
+                    solvers.push_back(new btBatchedConstraintSolver());
+                }
+                solverPool = new btConstraintSolverPoolMt(&solvers[0], solvers.size());
+            }
+            else
+            {
+                solverPool = new btConstraintSolverPoolMt(m_numberOfThreads);
+            }
+            m_constraintSolver = solverPool;
+            
+            // btDiscreteDynamicsWorldMt creates its own btSimulationIslandManagerMt
+            m_world = new btDiscreteDynamicsWorldMt(m_collisionDispatcher,
+                                                    m_broadphase,
+                                                    solverPool,
+                                                    m_collisionConfig);
+        }
+        else
+        {
+            m_collisionConfig = new btDefaultCollisionConfiguration();
+            m_collisionDispatcher = new btCollisionDispatcher(m_collisionConfig);
+            if (batchedSolver)
+            {
+                m_constraintSolver = new btBatchedConstraintSolver();
+            }
+            else
+            {
+                m_constraintSolver = new btSequentialImpulseConstraintSolver();
+            }
+            m_world = new btDiscreteDynamicsWorld(m_collisionDispatcher,
+                                                  m_broadphase,
+                                                  m_constraintSolver,
+                                                  m_collisionConfig);
+        }
+        
+        // triggers see the pairs first and pass them on to the ghost objects
+        m_ghostPairCallback = new btGhostPairCallback();
+        m_triggers = new btTriggerManager(m_broadphase->getOverlappingPairCache(), m_ghostPairCallback);
+        m_broadphase->getOverlappingPairCache()->setInternalGhostPairCallback(m_triggers);
         
-        m_broadphase->getOverlappingPairCache()->setInternalGhostPairCallback(new btGhostPairCallback());
+        m_tickCallbacks.triggers = m_triggers;
+        m_world->setInternalTickCallback(worldTickCallback, &m_tickCallbacks);
+        
+        // cheap, and BulletStaticBrushSetShape doesn't collide without it
+        btStaticBrushSetCollisionAlgorithm::registerAlgorithm(m_collisionDispatcher);
         
         m_bodies = [NSMutableArray array];
         m_ghosts = [NSMutableArray array];
         m_constraints = [NSMutableArray array];
         m_vehicles = [NSMutableArray array];
+        m_removedContactNodes = [NSMutableArray array];
+        m_removedTriggerNodes = [NSMutableArray array];
+        m_slotNodes = [NSMutableArray array];
+        m_pendingReleases = [NSMutableArray array];
+        m_releasesInFlight = [NSMutableArray array];
     }
     return self;
 }
 
 - (void)dealloc
 {
+    delete m_stepper;
     [self removeAll];
     delete m_world;
+    delete m_transformExport;
+    delete m_snapshot;
+    delete m_islands;
+    delete m_lod;
+    delete m_contactEvents;
+    delete m_triggers;
+    delete m_ghostPairCallback;
     delete m_collisionConfig;
     delete m_broadphase;
     delete m_collisionDispatcher;
@@ -128,11 +288,22 @@
     return vector3(m_world->getGravity().x(), m_world->getGravity().y(), m_world->getGravity().z());
 }
 
+- (int)numberOfThreads
+{
+    return m_numberOfThreads;
+}
+
+- (BulletBroadphaseType)broadphaseType
+{
+    return m_broadphaseType;
+}
+
 #pragma mark rigid body
 
 - (void)addRigidBody:(BulletRigidBody *)rigidBody withCollisionFilterGroup:(int)collisionFilterGroup
  collisionFilterMask:(int)collisionFilterMask
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
     NSAssert(![m_bodies containsObject:rigidBody], @"this rigid body already exists");
     
     btRigidBody *ptr = btRigidBody::upcast(bullet_cast(rigidBody.ptr));
@@ -144,6 +315,7 @@
 
 - (void)addRigidBody:(BulletRigidBody *)rigidBody
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
     NSAssert(![m_bodies containsObject:rigidBody], @"this rigid body already exists");
     
     btRigidBody *ptr = btRigidBody::upcast(bullet_cast(rigidBody.ptr));
@@ -153,23 +325,61 @@
     m_world->addRigidBody(ptr);
 }
 
+- (void)addStaticRigidBodies:(NSArray<BulletRigidBody *> *)rigidBodies
+{
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    
+    btAlignedObjectArray<btRigidBody *> bodies;
+    bodies.reserve((int)rigidBodies.count);
+    
+    for (BulletRigidBody *rigidBody in rigidBodies) {
+        NSAssert(![m_bodies containsObject:rigidBody], @"this rigid body already exists");
+        
+        btRigidBody *ptr = btRigidBody::upcast(bullet_cast(rigidBody.ptr));
+        NSAssert(ptr != nullptr, @"object is not a rigid body");
+        NSAssert(ptr->isStaticObject(), @"rigid body is not static");
+        
+        bodies.push_back(ptr);
+    }
+    
+    if (bodies.size() == 0) {
+        return;
+    }
+    
+    [m_bodies addObjectsFromArray:rigidBodies];
+    m_world->addStaticRigidBodies(&bodies[0], bodies.size());
+}
+
 - (void)removeRigidBody:(BulletRigidBody *)rigidBody
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
     NSAssert([m_bodies containsObject:rigidBody], @"this rigid body does not exist");
     
     btRigidBody *ptr = btRigidBody::upcast(bullet_cast(rigidBody.ptr));
     NSAssert(ptr != nullptr, @"object is not a rigid body");
     
+    [self willRemoveNode:rigidBody];
     [m_bodies removeObject:rigidBody];
     m_world->removeRigidBody(ptr);
+    
+    if (m_transformExport) {
+        m_transformExport->removeBody(ptr);
+    }
 }
 
 - (void)removeAllRigidBodies
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    
     for(BulletRigidBody *rigidBody in m_bodies) {
         btRigidBody *ptr = btRigidBody::upcast(bullet_cast(rigidBody.ptr));
         NSAssert(ptr != nullptr, @"object is not a rigid body");
+        [self willRemoveNode:rigidBody];
         m_world->removeRigidBody(ptr);
+        
+        if (m_transformExport) {
+            m_transformExport->removeBody(ptr);
+        }
     }
     [m_bodies removeAllObjects];
 }
@@ -188,6 +398,7 @@
 
 - (void)addGhost:(BulletGhostObject *)ghostNode
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
     NSAssert(![m_ghosts containsObject:ghostNode], @"this ghost body already exists");
     
     btGhostObject *ptr = btGhostObject::upcast((btCollisionObject *)ghostNode.ptr);
@@ -204,21 +415,28 @@
 
 - (void)removeGhost:(BulletGhostObject *)ghostNode
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
     NSAssert([m_ghosts containsObject:ghostNode], @"this ghost body does not exist");
     
     btGhostObject *ptr = btGhostObject::upcast((btCollisionObject *)ghostNode.ptr);
     NSAssert(ptr != nullptr, @"object is not a ghost body");
     
+    [self willRemoveNode:ghostNode];
     [m_ghosts removeObject:ghostNode];
     m_world->removeCollisionObject(ptr);
+    m_triggers->removeTrigger(ptr);
 }
 
 - (void)removeAllGhosts
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    
     for(BulletGhostObject *ghostNode in m_ghosts) {
         btGhostObject *ptr = btGhostObject::upcast((btCollisionObject *)ghostNode.ptr);
         NSAssert(ptr != nullptr, @"object is not a ghost body");
+        [self willRemoveNode:ghostNode];
         m_world->removeCollisionObject(ptr);
+        m_triggers->removeTrigger(ptr);
     }
     [m_ghosts removeAllObjects];
 }
@@ -237,6 +455,7 @@
 
 - (void)addConstraint:(BulletConstraint *)constraint disableCollisionsBetweenLinkedBodies:(BOOL)disableCollisionsBetweenLinkedBodies
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
     NSAssert(constraint, @"constraint must not be nil");
     NSAssert(![m_constraints containsObject:constraint], @"constraint already attached");
     [m_constraints addObject:constraint];
@@ -245,6 +464,7 @@
 
 - (void)removeConstraint:(BulletConstraint *)constraint
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
     NSAssert([m_constraints containsObject:constraint], @"constraint not attached");
     [m_constraints removeObject:constraint];
     m_world->removeConstraint(bullet_cast(constraint.ptr));
@@ -252,6 +472,8 @@
 
 - (void)removeAllConstraints
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    
     for(BulletConstraint *constraint in m_constraints) {
         m_world->removeConstraint(bullet_cast(constraint.ptr));
     }
@@ -271,11 +493,13 @@
 #pragma mark common
 
 - (int)stepSimulationWithTimeStep:(float)timeStep maxSubSteps:(int)maxSubSteps fixedTimeStep:(float)fixedTimeStep {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
     return m_world->stepSimulation(timeStep, maxSubSteps, fixedTimeStep);
 }
 
 - (BulletContactResult *)contactTest:(BulletCollisionObject *)node
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
     btCollisionObject *obj = bullet_cast([BulletWorld getCollisionObject:node]);
     BulletContactResult *cb = [[BulletContactResult alloc] init];
     if (obj) {
@@ -286,6 +510,7 @@
 
 - (BulletContactResult *)contactTestPairWithNode0:(BulletCollisionObject *)node0 node1:(BulletCollisionObject *)node1
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
     btCollisionObject *obj0 = bullet_cast([BulletWorld getCollisionObject:node0]);
     btCollisionObject *obj1 = bullet_cast([BulletWorld getCollisionObject:node1]);
     
@@ -303,17 +528,408 @@
     return m_world->getDispatcher()->getNumManifolds();
 }
 
+- (NSUInteger)numberOfOverlappingPairs
+{
+    return m_broadphase->getOverlappingPairCache()->getNumOverlappingPairs();
+}
+
 - (BulletPersistentManifold *)manifoldByIndex:(NSUInteger)index
 {
     btPersistentManifold *pm = m_world->getDispatcher()->getManifoldByIndexInternal(static_cast<int>(index));
     return [[BulletPersistentManifold alloc] initWithPersistentManifold:bullet_cast(pm)];
 }
 
+#pragma mark contact events
+
+- (void)enableContactEventsWithCapacity:(NSUInteger)capacity reportPersistent:(BOOL)reportPersistent
+{
+    if (m_contactEvents == nullptr) {
+        m_contactEvents = new btContactEventQueue((int)capacity);
+        m_tickCallbacks.contactEvents = m_contactEvents;
+    }
+    m_contactEvents->setReportPersistent(reportPersistent);
+}
+
+- (void)drainContactEvents:(BulletContactEvents *)events
+{
+    [events drainQueue:bullet_cast(m_contactEvents) retainingNodes:m_removedContactNodes];
+    [m_removedContactNodes removeAllObjects];
+}
+
+#pragma mark triggers
+
+- (void)addTrigger:(BulletGhostObject *)trigger exact:(BOOL)exact
+{
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    
+    btGhostObject *ptr = btGhostObject::upcast((btCollisionObject *)trigger.ptr);
+    NSAssert(ptr != nullptr, @"object is not a ghost body");
+    
+    // registered before the broadphase reports its first pairs
+    m_triggers->addTrigger(ptr, exact);
+    [self addGhost:trigger];
+}
+
+- (NSUInteger)numberOfNodesInsideTrigger:(BulletGhostObject *)trigger
+{
+    return m_triggers->getNumInside(bullet_cast(trigger.ptr));
+}
+
+- (void)drainTriggerEvents:(BulletTriggerEvents *)events
+{
+    [events drainManager:bullet_cast(m_triggers) retainingNodes:m_removedTriggerNodes];
+    [m_removedTriggerNodes removeAllObjects];
+}
+
+- (void)willRemoveNode:(BulletCollisionObject *)node
+{
+    // queued events still point to the object, keep it alive until they are drained
+    if (m_contactEvents) {
+        m_contactEvents->removeCollisionObject(bullet_cast([BulletWorld getCollisionObject:node]));
+        [m_removedContactNodes addObject:node];
+    }
+    
+    if (m_triggers->getEvents().size() > 0 || m_triggers->getNumOverlaps() > 0) {
+        [m_removedTriggerNodes addObject:node];
+    }
+}
+
+#pragma mark transform export
+
+- (void)setTransformExportPositions:(vector_float3 *)positions
+                          rotations:(vector_float4 *)rotations
+                           matrices:(matrix_float4x4 *)matrices
+                           capacity:(NSUInteger)capacity
+{
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    
+    if (m_transformExport == nullptr) {
+        m_transformExport = new btTransformExport();
+        m_world->setTransformExport(m_transformExport);
+    }
+    m_transformExport->setBuffers(reinterpret_cast<btScalar *>(positions),
+                                  reinterpret_cast<btScalar *>(rotations),
+                                  reinterpret_cast<btScalar *>(matrices),
+                                  (int)capacity);
+}
+
+- (NSInteger)addTransformExportForRigidBody:(BulletRigidBody *)rigidBody
+{
+    NSAssert(m_transformExport != nullptr, @"transform export buffers are not set");
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    
+    btRigidBody *ptr = btRigidBody::upcast(bullet_cast(rigidBody.ptr));
+    NSAssert(ptr != nullptr, @"object is not a rigid body");
+    
+    return m_transformExport->addBody(ptr);
+}
+
+- (void)removeTransformExportForRigidBody:(BulletRigidBody *)rigidBody
+{
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    
+    btRigidBody *ptr = btRigidBody::upcast(bullet_cast(rigidBody.ptr));
+    NSAssert(ptr != nullptr, @"object is not a rigid body");
+    
+    if (m_transformExport) {
+        m_transformExport->removeBody(ptr);
+    }
+}
+
+- (const int *)dirtyTransformIndicesWithCount:(NSUInteger *)count
+{
+    if (m_transformExport == nullptr || m_transformExport->getDirtyIndices().size() == 0) {
+        *count = 0;
+        return nullptr;
+    }
+    
+    *count = m_transformExport->getDirtyIndices().size();
+    return &m_transformExport->getDirtyIndices()[0];
+}
+
+- (void)clearDirtyTransformIndices
+{
+    if (m_transformExport) {
+        m_transformExport->clearDirtyIndices();
+    }
+}
+
+#pragma mark async stepping
+
+- (void)enableAsyncStepping
+{
+    // parallel loops started off the main thread run in place, and the per-thread pools of the
+    // multithreaded world have no room for the stepping thread
+    NSAssert(m_numberOfThreads == 1, @"async stepping needs the single-threaded world");
+    
+    if (m_stepper == nullptr) {
+        m_stepper = new btAsyncStepper(m_world);
+    }
+}
+
+- (BOOL)isStepping
+{
+    return m_stepper != nullptr && m_stepper->isStepping();
+}
+
+- (void)beginStepWithTimeStep:(float)timeStep maxSubSteps:(int)maxSubSteps fixedTimeStep:(float)fixedTimeStep
+{
+    NSAssert(m_stepper != nullptr, @"async stepping is not enabled");
+    
+    [self waitForStep];
+    m_stepper->beginStep(timeStep, maxSubSteps, fixedTimeStep);
+    
+    // bodies let go of by this step's commands live until it is done
+    NSMutableArray<BulletRigidBody *> *releases = m_releasesInFlight;
+    m_releasesInFlight = m_pendingReleases;
+    m_pendingReleases = releases;
+}
+
+- (void)waitForStep
+{
+    if (!self.isStepping) {
+        return;
+    }
+    
+    m_stepper->waitForStep();
+    
+    for (BulletRigidBody *rigidBody in m_releasesInFlight) {
+        btRigidBody *ptr = btRigidBody::upcast(bullet_cast(rigidBody.ptr));
+        if (m_transformExport && !ptr->isInWorld()) {
+            m_transformExport->removeBody(ptr);
+        }
+        if (m_contactEvents) {
+            [m_removedContactNodes addObject:rigidBody];
+        }
+        if (m_triggers->getEvents().size() > 0) {
+            [m_removedTriggerNodes addObject:rigidBody];
+        }
+    }
+    [m_releasesInFlight removeAllObjects];
+}
+
+- (NSInteger)addTransformSlotForRigidBody:(BulletRigidBody *)rigidBody
+{
+    NSAssert(m_stepper != nullptr, @"async stepping is not enabled");
+    
+    NSInteger slot = m_stepper->addSlot(btRigidBody::upcast(bullet_cast(rigidBody.ptr)));
+    if (slot == (NSInteger)m_slotNodes.count) {
+        [m_slotNodes addObject:rigidBody];
+    } else {
+        m_slotNodes[(NSUInteger)slot] = rigidBody;
+    }
+    return slot;
+}
+
+- (void)removeTransformSlot:(NSInteger)slot
+{
+    NSAssert(m_stepper != nullptr, @"async stepping is not enabled");
+    NSAssert(slot >= 0 && slot < (NSInteger)m_slotNodes.count && m_slotNodes[(NSUInteger)slot] != [NSNull null], @"slot is not in use");
+    
+    m_stepper->releaseSlot((int)slot);
+    [m_pendingReleases addObject:m_slotNodes[(NSUInteger)slot]];
+    m_slotNodes[(NSUInteger)slot] = [NSNull null];
+}
+
+- (const BulletBodyTransform *)acquireTransformsWithCount:(NSUInteger *)count
+{
+    if (m_stepper == nullptr) {
+        *count = 0;
+        return nullptr;
+    }
+    
+    const btAsyncStepper::Frame &frame = m_stepper->getFrame();
+    *count = frame.m_transforms.size();
+    return *count > 0 ? reinterpret_cast<const BulletBodyTransform *>(&frame.m_transforms[0]) : nullptr;
+}
+
+- (void)queueCentralImpulse:(vector_float3)impulse toRigidBody:(BulletRigidBody *)rigidBody
+{
+    NSAssert(m_stepper != nullptr, @"async stepping is not enabled");
+    m_stepper->applyCentralImpulse(btRigidBody::upcast(bullet_cast(rigidBody.ptr)), btVector3(impulse.x, impulse.y, impulse.z));
+}
+
+- (void)queueCentralForce:(vector_float3)force toRigidBody:(BulletRigidBody *)rigidBody
+{
+    NSAssert(m_stepper != nullptr, @"async stepping is not enabled");
+    m_stepper->applyCentralForce(btRigidBody::upcast(bullet_cast(rigidBody.ptr)), btVector3(force.x, force.y, force.z));
+}
+
+- (void)queueLinearVelocity:(vector_float3)velocity toRigidBody:(BulletRigidBody *)rigidBody
+{
+    NSAssert(m_stepper != nullptr, @"async stepping is not enabled");
+    m_stepper->setLinearVelocity(btRigidBody::upcast(bullet_cast(rigidBody.ptr)), btVector3(velocity.x, velocity.y, velocity.z));
+}
+
+- (void)queueTeleportRigidBody:(BulletRigidBody *)rigidBody origin:(vector_float3)origin rotation:(vector_float4)rotation
+{
+    NSAssert(m_stepper != nullptr, @"async stepping is not enabled");
+    
+    btTransform transform(btQuaternion(rotation.x, rotation.y, rotation.z, rotation.w), btVector3(origin.x, origin.y, origin.z));
+    m_stepper->setWorldTransform(btRigidBody::upcast(bullet_cast(rigidBody.ptr)), transform);
+}
+
+- (void)queueAddRigidBody:(BulletRigidBody *)rigidBody
+{
+    NSAssert(m_stepper != nullptr, @"async stepping is not enabled");
+    NSAssert(![m_bodies containsObject:rigidBody], @"this rigid body already exists");
+    
+    btRigidBody *ptr = btRigidBody::upcast(bullet_cast(rigidBody.ptr));
+    NSAssert(ptr != nullptr, @"object is not a rigid body");
+    
+    [m_bodies addObject:rigidBody];
+    m_stepper->addRigidBody(ptr);
+}
+
+- (void)queueRemoveRigidBody:(BulletRigidBody *)rigidBody
+{
+    NSAssert(m_stepper != nullptr, @"async stepping is not enabled");
+    NSAssert([m_bodies containsObject:rigidBody], @"this rigid body does not exist");
+    
+    btRigidBody *ptr = btRigidBody::upcast(bullet_cast(rigidBody.ptr));
+    NSAssert(ptr != nullptr, @"object is not a rigid body");
+    
+    // the stepping thread still reports its end events
+    [m_pendingReleases addObject:rigidBody];
+    [m_bodies removeObject:rigidBody];
+    m_stepper->removeRigidBody(ptr);
+}
+
+#pragma mark snapshots
+
+- (void)enableDeterministicStepping
+{
+    // the multithreaded world solves islands in whatever order the threads pick them up
+    NSAssert(m_numberOfThreads == 1, @"deterministic stepping needs the single-threaded world");
+    NSAssert(m_broadphaseType == BulletBroadphaseTypeDbvt, @"deterministic stepping needs the Dbvt broadphase");
+    
+    btWorldSnapshot::enableDeterministicStepping(m_world);
+}
+
+- (NSData *)captureSnapshot
+{
+    NSAssert(!self.isStepping, @"wait for the step first");
+    NSAssert(m_broadphaseType == BulletBroadphaseTypeDbvt, @"snapshots need the Dbvt broadphase");
+    
+    if (m_snapshot == nullptr) {
+        m_snapshot = new btWorldSnapshot();
+    }
+    m_snapshot->capture(m_world);
+    
+    return [NSData dataWithBytes:m_snapshot->getBuffer() length:m_snapshot->getBufferSize()];
+}
+
+- (BOOL)restoreSnapshot:(NSData *)snapshot
+{
+    NSAssert(!self.isStepping, @"wait for the step first");
+    NSAssert(m_broadphaseType == BulletBroadphaseTypeDbvt, @"snapshots need the Dbvt broadphase");
+    
+    if (m_snapshot == nullptr) {
+        m_snapshot = new btWorldSnapshot();
+    }
+    m_snapshot->setBuffer(snapshot.bytes, int(snapshot.length));
+    
+    if (!m_snapshot->restore(m_world)) {
+        return NO;
+    }
+    // restored sleeping states and pairs, the islands are built again from them
+    if (m_islands != nullptr) {
+        m_islands->invalidateIslands();
+    }
+    return YES;
+}
+
+#pragma mark islands
+
+- (void)enableIncrementalIslands
+{
+    NSAssert(m_numberOfThreads == 1, @"incremental islands need the single-threaded world");
+    NSAssert(!self.isStepping, @"wait for the step first");
+    
+    if (m_islands != nullptr) {
+        return;
+    }
+    // in front of the triggers, which pass the pairs on to the ghost objects
+    m_islands = new btIncrementalIslandManager(m_broadphase->getOverlappingPairCache(), m_triggers);
+    m_broadphase->getOverlappingPairCache()->setInternalGhostPairCallback(m_islands);
+    m_world->setIncrementalIslandManager(m_islands);
+}
+
+#pragma mark simulation LOD
+
+- (void)enableSimulationLodWithReducedRateDistance:(float)reducedRateDistance
+                                   lowRateDistance:(float)lowRateDistance
+                                    frozenDistance:(float)frozenDistance
+{
+    NSAssert(!self.isStepping, @"wait for the step first");
+    
+    if (m_lod == nullptr) {
+        m_lod = new btSimulationLod();
+        m_world->setSimulationLod(m_lod);
+    }
+    btSimulationLod::Settings settings = m_lod->getSettings();
+    settings.m_distances[BT_LOD_REDUCED_RATE] = reducedRateDistance;
+    settings.m_distances[BT_LOD_LOW_RATE] = lowRateDistance;
+    settings.m_distances[BT_LOD_FROZEN] = frozenDistance;
+    m_lod->setSettings(settings);
+}
+
+- (void)addLodForRigidBody:(BulletRigidBody *)rigidBody alwaysFullRate:(BOOL)alwaysFullRate
+{
+    NSAssert(m_lod != nullptr, @"enable the simulation LOD first");
+    NSAssert([m_bodies containsObject:rigidBody], @"add the rigid body to the world first");
+    NSAssert(!self.isStepping, @"wait for the step first");
+    
+    btRigidBody *ptr = btRigidBody::upcast(bullet_cast(rigidBody.ptr));
+    NSAssert(ptr != nullptr, @"object is not a rigid body");
+    
+    m_lod->addBody(ptr, alwaysFullRate ? btSimulationLod::ALWAYS_FULL_RATE : 0);
+}
+
+- (void)removeLodForRigidBody:(BulletRigidBody *)rigidBody
+{
+    NSAssert(!self.isStepping, @"wait for the step first");
+    
+    if (m_lod == nullptr) {
+        return;
+    }
+    m_lod->removeBody(btRigidBody::upcast(bullet_cast(rigidBody.ptr)));
+}
+
+- (void)setLodViewerPosition:(vector_float3)position direction:(vector_float3)direction cosHalfAngle:(float)cosHalfAngle
+{
+    NSAssert(!self.isStepping, @"wait for the step first");
+    
+    if (m_lod == nullptr) {
+        return;
+    }
+    m_lod->setViewer(btVector3(position.x, position.y, position.z), btVector3(direction.x, direction.y, direction.z), cosHalfAngle);
+}
+
+- (BulletLodStats)lodStats
+{
+    BulletLodStats result = {};
+    if (m_lod == nullptr) {
+        return result;
+    }
+    const btSimulationLod::Stats& stats = m_lod->getStats();
+    result.fullRate = stats.m_numBodies[BT_LOD_FULL_RATE];
+    result.reducedRate = stats.m_numBodies[BT_LOD_REDUCED_RATE];
+    result.lowRate = stats.m_numBodies[BT_LOD_LOW_RATE];
+    result.frozen = stats.m_numBodies[BT_LOD_FROZEN];
+    result.stepped = stats.m_numStepped;
+    return result;
+}
+
+#pragma mark queries
+
 - (BulletAllHitsRayResult *)rayTestAllFrom:(vector_float3)fromPos
                                         to:(vector_float3)toPos
                       collisionFilterGroup:(int)collisionFilterGroup
                        collisionFilterMask:(int)collisionFilterMask
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    
     const btVector3 from(fromPos.x, fromPos.y, fromPos.z);
     const btVector3 to(toPos.x, toPos.y, toPos.z);
     
@@ -330,6 +946,8 @@
                              collisionFilterGroup:(int)collisionFilterGroup
                               collisionFilterMask:(int)collisionFilterMask
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    
     const btVector3 from(fromPos.x, fromPos.y, fromPos.z);
     const btVector3 to(toPos.x, toPos.y, toPos.z);
     
@@ -347,6 +965,8 @@
                                    collisionFilterGroup:(int)collisionFilterGroup
                                     collisionFilterMask:(int)collisionFilterMask
 {
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    
     btTransform from;
     from.setIdentity();
     from.setOrigin(btVector3(fromPos.x, fromPos.y, fromPos.z));
@@ -366,4 +986,16 @@
     return cb;
 }
 
+- (void)rayTestBatch:(BulletQueryBatch *)batch
+{
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    [batch rayTestInWorld:[self getWorld]];
+}
+
+- (void)convexTestBatch:(BulletQueryBatch *)batch shape:(BulletCollisionShape *)shape
+{
+    NSAssert(!self.isStepping, @"an asynchronous step is running");
+    [batch convexTestInWorld:[self getWorld] shape:shape.ptr];
+}
+
 @end
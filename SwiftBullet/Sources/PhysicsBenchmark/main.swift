@@ -0,0 +1,318 @@
+//
+//  main.swift
+//  PhysicsBenchmark
+//
+//  Created by Fedor Artemenkov on 18.10.2026.
+//
+//  Headless scene benchmark: drops boxes onto the brush world of every .wld map
+//  and compares step times of the single and multithreaded BulletWorld, and of
+//  one static body per brush against a single BulletStaticBrushSetShape.
+//  Usage: swift run -c release PhysicsBenchmark [maps dir] [--boxes N] [--steps N] [--threads N] [--seed N] [--out file.json]
+//
+
+import Foundation
+import BenchmarkSupport
+import SwiftBullet
+import simd
+
+struct Options
+{
+    var mapsDir = "../WorkingDir/Assets/maps"
+    var boxes = 300
+    var steps = 600
+    var threads = 0
+    var seed: UInt32 = 1337
+    var output: String?
+
+    init(arguments: [String])
+    {
+        var args = arguments.makeIterator()
+
+        while let arg = args.next()
+        {
+            switch arg
+            {
+                case "--boxes": boxes = args.next().flatMap { Int($0) } ?? boxes
+                case "--steps": steps = args.next().flatMap { Int($0) } ?? steps
+                case "--threads": threads = args.next().flatMap { Int($0) } ?? threads
+                case "--seed": seed = args.next().flatMap { UInt32($0) } ?? seed
+                case "--out": output = args.next()
+                default: mapsDir = arg
+            }
+        }
+    }
+}
+
+struct StepReport: Encodable
+{
+    let threads: Int
+    let merged: Bool
+    let insert_ms: Double
+    let overlapping_pairs: Int
+    let p50_ms: Double
+    let p99_ms: Double
+    let mean_ms: Double
+    let manifolds: Int
+}
+
+struct SceneReport: Encodable
+{
+    let map: String
+    let brushes: Int
+    let boxes: Int
+    let steps: Int
+    let single: StepReport
+    let multi: StepReport
+    let speedup: Double
+    let per_brush: StepReport
+    let merged_speedup: Double
+}
+
+let q2b: Float = 2.54 / 100
+
+func seededRand(_ state: inout UInt32) -> UInt32
+{
+    state ^= state << 13
+    state ^= state >> 17
+    state ^= state << 5
+    return state
+}
+
+// Same triple-plane intersection as BrushCollision
+func brushVertices(_ planes: [CollisionAsset.Plane]) -> [SIMD3<Float>]
+{
+    var vertices: [SIMD3<Float>] = []
+
+    guard planes.count >= 4 else { return vertices }
+
+    for i in 0 ..< planes.count - 2
+    {
+        for j in i + 1 ..< planes.count - 1
+        {
+            for k in j + 1 ..< planes.count
+            {
+                let n1 = planes[i].normal
+                let n2 = planes[j].normal
+                let n3 = planes[k].normal
+
+                let denom = dot(n1, cross(n2, n3))
+
+                if abs(denom) <= 1e-5 { continue }
+
+                let p = (planes[i].distance * cross(n2, n3) + planes[j].distance * cross(n3, n1) + planes[k].distance * cross(n1, n2)) / denom
+
+                if planes.allSatisfy({ dot($0.normal, p) - $0.distance <= 1e-3 })
+                {
+                    vertices.append(p)
+                }
+            }
+        }
+    }
+
+    return vertices
+}
+
+func loadBrushes(_ asset: CollisionAsset) -> [[SIMD3<Float>]]
+{
+    let SOLID = 0x1
+    let PLAYERCLIP = 0x10000
+
+    return asset.brushes
+        .filter { $0.contentFlags & (SOLID | PLAYERCLIP) != 0 }
+        .map { brush in
+            let sides = asset.brushSides[brush.brushside ..< brush.brushside + brush.numBrushsides]
+            return brushVertices(sides.map { asset.planes[$0.plane] })
+        }
+        .filter { !$0.isEmpty }
+}
+
+// Floor with a ring of pillars, used when no maps are available
+func syntheticBrushes() -> [[SIMD3<Float>]]
+{
+    func box(_ minP: SIMD3<Float>, _ maxP: SIMD3<Float>) -> [SIMD3<Float>]
+    {
+        var vertices: [SIMD3<Float>] = []
+
+        for i in 0 ..< 8
+        {
+            vertices.append(SIMD3<Float>(i & 1 == 0 ? minP.x : maxP.x,
+                                         i & 2 == 0 ? minP.y : maxP.y,
+                                         i & 4 == 0 ? minP.z : maxP.z))
+        }
+
+        return vertices
+    }
+
+    var brushes = [box(SIMD3<Float>(-1024, -1024, -16), SIMD3<Float>(1024, 1024, 0))]
+
+    for i in 0 ..< 16
+    {
+        let angle = Float(i) / 16 * 2 * .pi
+        let center = SIMD3<Float>(cos(angle), sin(angle), 0) * 512
+
+        brushes.append(box(center - SIMD3<Float>(32, 32, 0), center + SIMD3<Float>(32, 32, 256)))
+    }
+
+    return brushes
+}
+
+func staticBody(_ shape: BulletCollisionShape) -> BulletRigidBody
+{
+    let transform = BulletTransform()
+    transform.setIdentity()
+
+    let body = BulletRigidBody(mass: 0,
+                               motionState: BulletMotionState(transform: transform),
+                               collisionShape: shape)
+    body.friction = 0.5
+
+    return body
+}
+
+func runScene(brushes: [[SIMD3<Float>]], threads: Int, merged: Bool, options: Options) -> StepReport
+{
+    let world = BulletWorld(numberOfThreads: threads)
+    world.gravity = SIMD3<Float>(0, 0, -800 * q2b)
+
+    var tops: [SIMD3<Float>] = []
+    var statics: [BulletRigidBody] = []
+    let brushSet = BulletStaticBrushSetShape()
+
+    let insertStart = DispatchTime.now().uptimeNanoseconds
+
+    for vertices in brushes
+    {
+        let shape = BulletConvexHullShape()
+
+        for point in vertices
+        {
+            shape.addPoint(point * q2b)
+        }
+
+        if merged
+        {
+            brushSet.addBrush(shape)
+        }
+        else
+        {
+            statics.append(staticBody(shape))
+        }
+
+        let minP = vertices.reduce(vertices[0], { simd_min($0, $1) })
+        let maxP = vertices.reduce(vertices[0], { simd_max($0, $1) })
+        tops.append(SIMD3<Float>((minP.x + maxP.x) * 0.5, (minP.y + maxP.y) * 0.5, maxP.z))
+    }
+
+    if merged
+    {
+        brushSet.buildBvh()
+        world.add(rigidBody: staticBody(brushSet))
+    }
+    else
+    {
+        world.add(staticRigidBodies: statics)
+    }
+
+    let insertMs = Double(DispatchTime.now().uptimeNanoseconds - insertStart) / 1e6
+
+    // Same boxes in the same places for both runs
+    var state = options.seed
+    let boxShape = BulletBoxShape(halfExtents: SIMD3<Float>(15, 15, 15) * q2b)
+    let localInertia = boxShape.calculateLocalInertia(mass: 1)
+
+    for i in 0 ..< options.boxes
+    {
+        let top = tops[Int(seededRand(&state)) % tops.count]
+        let jitter = SIMD3<Float>(Float(seededRand(&state) % 64) - 32, Float(seededRand(&state) % 64) - 32, 0)
+
+        let transform = BulletTransform()
+        transform.setIdentity()
+        transform.origin = (top + jitter + SIMD3<Float>(0, 0, 64 + Float(i % 8) * 40)) * q2b
+
+        let body = BulletRigidBody(mass: 1,
+                                   motionState: BulletMotionState(transform: transform),
+                                   collisionShape: boxShape,
+                                   localInertia: localInertia)
+        world.add(rigidBody: body)
+    }
+
+    var times: [Double] = []
+    times.reserveCapacity(options.steps)
+
+    for _ in 0 ..< options.steps
+    {
+        let start = DispatchTime.now().uptimeNanoseconds
+        world.stepSimulation(timeStep: 1.0 / 60.0, maxSubSteps: 1)
+        times.append(Double(DispatchTime.now().uptimeNanoseconds - start) / 1e6)
+    }
+
+    return StepReport(threads: Int(world.numberOfThreads),
+                      merged: merged,
+                      insert_ms: insertMs,
+                      overlapping_pairs: Int(world.numberOfOverlappingPairs()),
+                      p50_ms: percentile(times, 50),
+                      p99_ms: percentile(times, 99),
+                      mean_ms: times.reduce(0, +) / Double(max(times.count, 1)),
+                      manifolds: Int(world.numberOfManifolds()))
+}
+
+func benchmark(map: String, brushes: [[SIMD3<Float>]], options: Options) -> SceneReport
+{
+    let single = runScene(brushes: brushes, threads: 1, merged: true, options: options)
+    let multi = runScene(brushes: brushes, threads: options.threads, merged: true, options: options)
+    let perBrush = runScene(brushes: brushes, threads: 1, merged: false, options: options)
+
+    return SceneReport(map: map,
+                       brushes: brushes.count,
+                       boxes: options.boxes,
+                       steps: options.steps,
+                       single: single,
+                       multi: multi,
+                       speedup: multi.mean_ms > 0 ? single.mean_ms / multi.mean_ms : 0,
+                       per_brush: perBrush,
+                       merged_speedup: single.mean_ms > 0 ? perBrush.mean_ms / single.mean_ms : 0)
+}
+
+let options = Options(arguments: Array(CommandLine.arguments.dropFirst()))
+let mapsURL = URL(fileURLWithPath: options.mapsDir)
+
+let maps = ((try? FileManager.default.contentsOfDirectory(at: mapsURL, includingPropertiesForKeys: nil)) ?? [])
+    .filter { $0.pathExtension == "wld" }
+    .sorted { $0.lastPathComponent < $1.lastPathComponent }
+
+var reports: [SceneReport] = []
+
+for map in maps
+{
+    guard let data = readEntry("collision.json", from: map),
+          let asset = try? JSONDecoder().decode(CollisionAsset.self, from: data)
+    else { continue }
+
+    let brushes = loadBrushes(asset)
+
+    if !brushes.isEmpty
+    {
+        reports.append(benchmark(map: map.lastPathComponent, brushes: brushes, options: options))
+    }
+}
+
+if reports.isEmpty
+{
+    reports.append(benchmark(map: "synthetic", brushes: syntheticBrushes(), options: options))
+}
+
+let encoder = JSONEncoder()
+encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+
+if let json = try? encoder.encode(reports)
+{
+    if let output = options.output
+    {
+        try? json.write(to: URL(fileURLWithPath: output))
+    }
+    else
+    {
+        FileHandle.standardOutput.write(json)
+        print("")
+    }
+}
@@ -29,3 +29,12 @@ public extension BulletCollisionShape
         return __calculateLocalInertia(withMass: mass)
     }
 }
+
+public extension BulletBrushShape
+{
+    /// Planes are (normal, distance), inside where dot(normal, point) <= distance
+    convenience init(planes: [SIMD4<Float>])
+    {
+        self.init(__planes: planes, numberOfPlanes: planes.count)
+    }
+}
@@ -0,0 +1,40 @@
+//
+//  BulletHitboxWorld.swift
+//
+//
+//  Created by Fedor Artemenkov on 18.10.2026.
+//
+
+import ObjCBullet
+import Foundation
+import simd
+
+public extension BulletHitboxWorld
+{
+    func addModel(hitboxes: [BulletHitbox]) -> Int
+    {
+        return __addModel(withHitboxes: hitboxes, count: UInt(hitboxes.count))
+    }
+    
+    func addEntity(model: Int) -> Int
+    {
+        return __addEntity(withModel: model)
+    }
+    
+    func remove(entity: Int)
+    {
+        __removeEntity(entity)
+    }
+    
+    /// bones are model space matrices by bone index, the ones the mesh was drawn with
+    func setPose(entity: Int, transform: matrix_float4x4, bones: UnsafeBufferPointer<matrix_float4x4>)
+    {
+        __setPose(ofEntity: entity, transform: transform, bones: bones.baseAddress, count: UInt(bones.count))
+    }
+    
+    func rayTest(from: vector_float3, to: vector_float3) -> BulletHitboxHit?
+    {
+        var hit = BulletHitboxHit()
+        return __rayTest(from: from, to: to, hit: &hit) ? hit : nil
+    }
+}
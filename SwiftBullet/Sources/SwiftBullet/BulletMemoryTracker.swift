@@ -0,0 +1,38 @@
+//
+//  BulletMemoryTracker.swift
+//
+//
+//  Created by Fedor Artemenkov on 18.10.2026.
+//
+
+import ObjCBullet
+import Foundation
+
+public extension BulletMemoryTracker
+{
+    /// Hands the tracking allocator and the permanent and temporary tags to a library outside Bullet
+    typealias AllocatorHook = (_ alloc: BulletAllocFunction, _ free: BulletFreeFunction,
+                               _ permanentTag: Int32, _ temporaryTag: Int32) -> Void
+    
+    /// Counts native allocations by subsystem from the first one on, contact test temporaries come from arenas.
+    /// Every library gets the tags "name" and "name/temp". Call it at launch, before any world is created
+    static func installTracking(libraries: [(name: String, hook: AllocatorHook)] = [])
+    {
+        guard install() else { return }
+        
+        for library in libraries {
+            library.hook(allocFunction, freeFunction,
+                         registerTag(library.name), registerTag(library.name + "/temp"))
+        }
+        
+        arenaEnabled = true
+    }
+    
+    /// Stats of every tag by name, for a memory panel or a log line per frame
+    static func stats() -> [(name: String, stats: BulletMemoryStats)]
+    {
+        return (0 ..< numberOfTags).map { tag in
+            (name: nameOfTag(tag), stats: stats(forTag: tag))
+        }
+    }
+}
@@ -0,0 +1,29 @@
+//
+//  BulletTraceProfiler.swift
+//
+//
+//  Created by Fedor Artemenkov on 18.10.2026.
+//
+
+import ObjCBullet
+import Foundation
+
+public extension BulletTraceProfiler
+{
+    /// The last frames, oldest first, for graphing step times and counters
+    func frames(maxCount: Int) -> [BulletTraceFrame]
+    {
+        let capacity = min(maxCount, Int(maxFrames))
+        guard capacity > 0 else { return [] }
+        
+        return [BulletTraceFrame](unsafeUninitializedCapacity: capacity) { buffer, count in
+            count = Int(__copyFrames(buffer.baseAddress!, maxCount: UInt(capacity)))
+        }
+    }
+    
+    /// Writes chromeTrace to url, open it in chrome://tracing or ui.perfetto.dev
+    func writeChromeTrace(to url: URL) throws
+    {
+        try chromeTrace().write(to: url)
+    }
+}
@@ -24,12 +24,62 @@ import simd
 
 public extension BulletWorld
 {
+    /// More than one thread builds the multithreaded world, 0 uses every core.
+    /// batchedSolver solves contacts several rows at a time with SIMD, broadphase .hashGrid suits worlds full of small debris
+    convenience init(numberOfThreads: Int, batchedSolver: Bool = false, broadphase: BulletBroadphaseType = .dbvt)
+    {
+        self.init(__numberOfThreads: Int32(numberOfThreads), batchedSolver: batchedSolver, broadphase: broadphase)
+    }
+    
     @discardableResult
     func stepSimulation(timeStep: Float, maxSubSteps: Int = 1, fixedTimeStep: Float = Float(1.0/60.0)) -> Int
     {
         return Int(__stepSimulation(withTimeStep: timeStep, maxSubSteps: Int32(maxSubSteps), fixedTimeStep: fixedTimeStep))
     }
     
+    /// Index of rigidBody in the arrays given to setTransformExportPositions
+    func addTransformExport(for rigidBody: BulletRigidBody) -> Int
+    {
+        return __addTransformExport(for: rigidBody)
+    }
+    
+    func removeTransformExport(for rigidBody: BulletRigidBody)
+    {
+        __removeTransformExport(for: rigidBody)
+    }
+    
+    /// Export indices written since clearDirtyTransformIndices, each once
+    var dirtyTransformIndices: UnsafeBufferPointer<Int32>
+    {
+        var count: UInt = 0
+        let start = __dirtyTransformIndices(withCount: &count)
+        return UnsafeBufferPointer(start: start, count: Int(count))
+    }
+    
+    /// Starts the next step on the stepping thread and returns, see enableAsyncStepping
+    func beginStep(timeStep: Float, maxSubSteps: Int = 1, fixedTimeStep: Float = Float(1.0/60.0))
+    {
+        __beginStep(withTimeStep: timeStep, maxSubSteps: Int32(maxSubSteps), fixedTimeStep: fixedTimeStep)
+    }
+    
+    func addTransformSlot(for rigidBody: BulletRigidBody) -> Int
+    {
+        return __addTransformSlot(for: rigidBody)
+    }
+    
+    func removeTransformSlot(_ slot: Int)
+    {
+        __removeTransformSlot(slot)
+    }
+    
+    /// Transforms of the last finished asynchronous step by slot, valid until the next call
+    var transforms: UnsafeBufferPointer<BulletBodyTransform>
+    {
+        var count: UInt = 0
+        let start = __acquireTransforms(withCount: &count)
+        return UnsafeBufferPointer(start: start, count: Int(count))
+    }
+    
     func add(rigidBody: BulletRigidBody, collisionFilterGroup: Int32, collisionFilterMask: Int32)
     {
         __add(rigidBody, withCollisionFilterGroup: collisionFilterGroup, collisionFilterMask: collisionFilterMask)
@@ -40,6 +90,12 @@ public extension BulletWorld
         __add(rigidBody)
     }
     
+    /// Static bodies of a map, added at once so the broadphase builds its static tree in one pass
+    func add(staticRigidBodies: [BulletRigidBody])
+    {
+        __addStaticRigidBodies(staticRigidBodies)
+    }
+    
     func remove(rigidBody: BulletRigidBody)
     {
         __remove(rigidBody)
@@ -50,8 +106,25 @@ public extension BulletWorld
         __addGhost(ghost)
     }
     
+    /// exact waits for a narrowphase contact instead of overlapping bounding boxes
+    func add(trigger: BulletGhostObject, exact: Bool = false)
+    {
+        __addTrigger(trigger, exact: exact)
+    }
+    
     func remove(ghost: BulletGhostObject)
     {
         __removeGhost(ghost)
     }
+    
+    /// Puts rigidBody under the simulation LOD, see enableSimulationLod
+    func addLod(for rigidBody: BulletRigidBody, alwaysFullRate: Bool = false)
+    {
+        __addLod(for: rigidBody, alwaysFullRate: alwaysFullRate)
+    }
+    
+    func removeLod(for rigidBody: BulletRigidBody)
+    {
+        __removeLod(for: rigidBody)
+    }
 }
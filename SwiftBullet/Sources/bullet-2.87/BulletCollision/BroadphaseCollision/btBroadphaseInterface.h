@@ -67,6 +67,15 @@ public:
 	virtual ~btBroadphaseInterface() {}
 
 	virtual btBroadphaseProxy*	createProxy(  const btVector3& aabbMin,  const btVector3& aabbMax,int shapeType,void* userPtr,  int collisionFilterGroup, int collisionFilterMask, btDispatcher* dispatcher) =0;
+	///createStaticProxies creates proxies for objects that will not move, all with the same filter, into proxies[0..numProxies).
+	///Broadphases that keep static objects in a structure of their own can build it in one pass; by default they are created one by one.
+	virtual void	createStaticProxies(int numProxies, const btVector3* aabbMin, const btVector3* aabbMax, const int* shapeTypes, void* const* userPtrs, int collisionFilterGroup, int collisionFilterMask, btDispatcher* dispatcher, btBroadphaseProxy** proxies)
+	{
+		for (int i=0;i<numProxies;i++)
+		{
+			proxies[i] = createProxy(aabbMin[i], aabbMax[i], shapeTypes[i], userPtrs[i], collisionFilterGroup, collisionFilterMask, dispatcher);
+		}
+	}
 	virtual void	destroyProxy(btBroadphaseProxy* proxy,btDispatcher* dispatcher)=0;
 	virtual void	setAabb(btBroadphaseProxy* proxy,const btVector3& aabbMin,const btVector3& aabbMax, btDispatcher* dispatcher)=0;
 	virtual void	getAabb(btBroadphaseProxy* proxy,btVector3& aabbMin, btVector3& aabbMax ) const =0;
@@ -408,6 +408,151 @@ static btDbvtNode*			topdown(btDbvt* pdbvt,
 	return(leaves[0]);
 }
 
+// half the surface area, the SAH cost of a node
+static DBVT_INLINE btScalar		area(const btDbvtVolume& a)
+{
+	const btVector3	edges=a.Lengths();
+	return(	edges.x()*edges.y()+
+		edges.y()*edges.z()+
+		edges.z()*edges.x());
+}
+
+// leaf with its center, kept together so the SAH build walks one array
+struct	btDbvtSahItem
+{
+	btDbvtVolume	volume;
+	btVector3		center;
+	btDbvtNode*		leaf;
+};
+typedef btAlignedObjectArray<btDbvtSahItem>	tSahItemArray;
+
+//
+static btDbvtNode*			topdownsah(btDbvt* pdbvt,
+									   btDbvtSahItem* items,
+									   int count,
+									   const btDbvtVolume& vol,
+									   const btVector3& cmin,
+									   const btVector3& cmax)
+{
+	enum { BINS=16 };
+	if(count==1)
+	{
+		return(items[0].leaf);
+	}
+	/* bin the centers on every axis in one pass	*/ 
+	btScalar		scale[3];
+	int				bincount[3][BINS];
+	btDbvtVolume	binvolume[3][BINS];
+	for(int axis=0;axis<3;++axis)
+	{
+		const btScalar	extent=cmax[axis]-cmin[axis];
+		scale[axis]=extent>SIMD_EPSILON?btScalar(BINS)*(btScalar(1)-SIMD_EPSILON)/extent:0;
+		for(int b=0;b<BINS;++b) bincount[axis][b]=0;
+	}
+	for(int i=0;i<count;++i)
+	{
+		for(int axis=0;axis<3;++axis)
+		{
+			if(scale[axis]==0) continue;
+			const int	b=btMin<int>(BINS-1,(int)((items[i].center[axis]-cmin[axis])*scale[axis]));
+			if(bincount[axis][b]++) Merge(binvolume[axis][b],items[i].volume,binvolume[axis][b]); else binvolume[axis][b]=items[i].volume;
+		}
+	}
+	/* find the cheapest split, sweeping the cost of the right side first	*/ 
+	int			bestaxis=-1;
+	int			bestbin=0;
+	btScalar	bestcost=SIMD_INFINITY;
+	for(int axis=0;axis<3;++axis)
+	{
+		if(scale[axis]==0) continue;
+		btScalar		rightcost[BINS];
+		btDbvtVolume	acc;
+		int				n=0;
+		for(int b=BINS-1;b>0;--b)
+		{
+			if(bincount[axis][b]) { if(n) Merge(acc,binvolume[axis][b],acc); else acc=binvolume[axis][b]; n+=bincount[axis][b]; }
+			rightcost[b]=n?area(acc)*n:0;
+		}
+		n=0;
+		for(int b=0;b<BINS-1;++b)
+		{
+			if(bincount[axis][b]) { if(n) Merge(acc,binvolume[axis][b],acc); else acc=binvolume[axis][b]; n+=bincount[axis][b]; }
+			if((n==0)||(n==count)) continue;
+			const btScalar	cost=area(acc)*n+rightcost[b+1];
+			if(cost<bestcost)
+			{
+				bestcost	=	cost;
+				bestaxis	=	axis;
+				bestbin		=	b;
+			}
+		}
+	}
+	/* partition, gathering bounds of both sides on the way	*/ 
+	int	partition=0;
+	if(bestaxis>=0)
+	{
+		int	end=count;
+		while(partition<end)
+		{
+			const int	b=btMin<int>(BINS-1,(int)((items[partition].center[bestaxis]-cmin[bestaxis])*scale[bestaxis]));
+			if(b<=bestbin)
+			{
+				++partition;
+			}
+			else
+			{
+				--end;
+				btSwap(items[partition],items[end]);
+			}
+		}
+	}
+	else
+	{
+		/* all centers in one place, any halves do	*/ 
+		partition=count/2;
+	}
+	btAssert(partition>0 && partition<count);
+	btDbvtVolume	childvol[2]={items[0].volume,items[partition].volume};
+	btVector3		childcmin[2]={items[0].center,items[partition].center};
+	btVector3		childcmax[2]={items[0].center,items[partition].center};
+	for(int i=0;i<count;++i)
+	{
+		const int	side=i<partition?0:1;
+		Merge(childvol[side],items[i].volume,childvol[side]);
+		childcmin[side].setMin(items[i].center);
+		childcmax[side].setMax(items[i].center);
+	}
+	btDbvtNode*	node=createnode(pdbvt,0,vol,0);
+	node->childs[0]=topdownsah(pdbvt,&items[0],partition,childvol[0],childcmin[0],childcmax[0]);
+	node->childs[1]=topdownsah(pdbvt,&items[partition],count-partition,childvol[1],childcmin[1],childcmax[1]);
+	node->childs[0]->parent=node;
+	node->childs[1]->parent=node;
+	return(node);
+}
+
+//
+static btDbvtNode*			topdownsah(btDbvt* pdbvt,
+									   const tNodeArray& leaves)
+{
+	tSahItemArray	items;
+	items.resize(leaves.size());
+	btDbvtVolume	vol=leaves[0]->volume;
+	btVector3		cmin=vol.Center();
+	btVector3		cmax=cmin;
+	for(int i=0;i<leaves.size();++i)
+	{
+		items[i].volume=leaves[i]->volume;
+		items[i].center=leaves[i]->volume.Center();
+		items[i].leaf=leaves[i];
+		Merge(vol,items[i].volume,vol);
+		cmin.setMin(items[i].center);
+		cmax.setMax(items[i].center);
+	}
+	btDbvtNode*	root=topdownsah(pdbvt,&items[0],items.size(),vol,cmin,cmax);
+	root->parent=0;
+	return(root);
+}
+
 //
 static DBVT_INLINE btDbvtNode*	sort(btDbvtNode* n,btDbvtNode*& r)
 {
@@ -502,6 +647,18 @@ void			btDbvt::optimizeTopDown(int bu_treshold)
 	}
 }
 
+//
+void			btDbvt::optimizeSAH()
+{
+	if(m_root)
+	{
+		tNodeArray	leaves;
+		leaves.reserve(m_leaves);
+		fetchleaves(this,m_root,leaves);
+		m_root=topdownsah(this,leaves);
+	}
+}
+
 //
 void			btDbvt::optimizeIncremental(int passes)
 {
@@ -531,6 +688,22 @@ btDbvtNode*	btDbvt::insert(const btDbvtVolume& volume,void* data)
 	return(leaf);
 }
 
+//
+void			btDbvt::insertBulk(const btDbvtVolume* volumes,void* const* data,int count,btDbvtNode** leaves)
+{
+	if(count<=0) return;
+	tNodeArray	all;
+	all.reserve(m_leaves+count);
+	if(m_root) fetchleaves(this,m_root,all);
+	for(int i=0;i<count;++i)
+	{
+		leaves[i]=createnode(this,0,volumes[i],data[i]);
+		all.push_back(leaves[i]);
+	}
+	m_leaves+=count;
+	m_root=topdownsah(this,all);
+}
+
 //
 void			btDbvt::update(btDbvtNode* leaf,int lookahead)
 {
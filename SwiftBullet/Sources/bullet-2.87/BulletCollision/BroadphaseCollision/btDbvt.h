@@ -30,6 +30,7 @@ subject to the following restrictions:
 #include "LinearMath/btVector3.h"
 #include "LinearMath/btTransform.h"
 #include "LinearMath/btAabbUtil2.h"
+#include "btRayPacket.h"
 
 //
 // Compile time configuration
@@ -243,6 +244,7 @@ struct	btDbvt
 			DBVT_VIRTUAL void	Process(const btDbvtNode*,const btDbvtNode*)		{}
 		DBVT_VIRTUAL void	Process(const btDbvtNode*)					{}
 		DBVT_VIRTUAL void	Process(const btDbvtNode* n,btScalar)			{ Process(n); }
+		DBVT_VIRTUAL void	ProcessRays(const btDbvtNode* n,unsigned int)		{ Process(n); }
 		DBVT_VIRTUAL bool	Descent(const btDbvtNode*)					{ return(true); }
 		DBVT_VIRTUAL bool	AllLeaves(const btDbvtNode*)					{ return(true); }
 	};
@@ -285,8 +287,13 @@ struct	btDbvt
 	bool			empty() const { return(0==m_root); }
 	void			optimizeBottomUp();
 	void			optimizeTopDown(int bu_treshold=128);
+	///optimizeSAH rebuilds the whole tree top-down, splitting where the binned surface area heuristic is cheapest
+	void			optimizeSAH();
 	void			optimizeIncremental(int passes);
 	btDbvtNode*		insert(const btDbvtVolume& box,void* data);
+	///insertBulk adds count leaves at once and rebuilds the tree as optimizeSAH does, instead of count incremental inserts.
+	///leaves[i] receives the leaf of volumes[i] and data[i].
+	void			insertBulk(const btDbvtVolume* volumes,void* const* data,int count,btDbvtNode** leaves);
 	void			update(btDbvtNode* leaf,int lookahead=-1);
 	void			update(btDbvtNode* leaf,btDbvtVolume& volume);
 	bool			update(btDbvtNode* leaf,btDbvtVolume& volume,const btVector3& velocity,btScalar margin);
@@ -367,6 +374,14 @@ struct	btDbvt
 								const btVector3& aabbMax,
                                 btAlignedObjectArray<const btDbvtNode*>& stack,
 								DBVT_IPOLICY) const;
+	///rayTestPacket traverses up to BT_RAY_PACKET_SIZE coherent rays together, slab testing each node against all of them at once.
+	///A subtree reached by a single ray continues with the scalar test. Leaves are reported to ProcessRays, with bit i set for ray i.
+	DBVT_PREFIX
+		static void		rayTestPacket(	const btDbvtNode* root,
+		const btVector3* rayFrom,
+		const btVector3* rayTo,
+		int numRays,
+		DBVT_IPOLICY);
 
 	DBVT_PREFIX
 		static void		collideKDOP(const btDbvtNode* root,
@@ -1064,6 +1079,61 @@ inline void		btDbvt::rayTestInternal(	const btDbvtNode* root,
 	}
 }
 
+//
+DBVT_PREFIX
+inline void		btDbvt::rayTestPacket(	const btDbvtNode* root,
+								const btVector3* rayFrom,
+								const btVector3* rayTo,
+								int numRays,
+								DBVT_IPOLICY)
+{
+	DBVT_CHECKTYPE
+		if(root)
+		{
+			btRayPacket	packet;
+			packet.init(rayFrom,rayTo,numRays);
+
+			btAlignedObjectArray<sStkNP>	stack;
+
+			ATTRIBUTE_ALIGNED16(char tempmemory[DOUBLE_STACKSIZE * sizeof(sStkNP)]);
+#ifndef BT_DISABLE_STACK_TEMP_MEMORY
+			stack.initializeFromBuffer(tempmemory, 0, DOUBLE_STACKSIZE);
+#else//BT_DISABLE_STACK_TEMP_MEMORY
+			stack.reserve(DOUBLE_STACKSIZE);
+#endif //BT_DISABLE_STACK_TEMP_MEMORY
+			stack.push_back(sStkNP(root,packet.m_activeMask));
+			do	{
+				const sStkNP	se=stack[stack.size()-1];
+				stack.pop_back();
+
+				const btDbvtNode*	node=se.node;
+				unsigned int		mask=se.mask;
+
+				if(btRayPacket::isSingleRay(mask))
+				{
+					mask=packet.testAabbSingle(btRayPacket::firstRay(mask),node->volume.Mins(),node->volume.Maxs())?mask:0;
+				}
+				else
+				{
+					mask=packet.testAabb(node->volume.Mins(),node->volume.Maxs(),mask);
+				}
+
+				if(mask)
+				{
+					if(node->isinternal())
+					{
+						stack.push_back(sStkNP(node->childs[0],mask));
+						stack.push_back(sStkNP(node->childs[1],mask));
+					}
+					else
+					{
+						policy.ProcessRays(node,mask);
+					}
+				}
+			} while(stack.size()>0);
+		}
+}
+
 //
 DBVT_PREFIX
 inline void		btDbvt::rayTest(	const btDbvtNode* root,
@@ -202,6 +202,55 @@ btBroadphaseProxy*				btDbvtBroadphase::createProxy(	const btVector3& aabbMin,
 	return(proxy);
 }
 
+//
+void							btDbvtBroadphase::createStaticProxies(	int numProxies,
+																	  const btVector3* aabbMin,
+																	  const btVector3* aabbMax,
+																	  const int* /*shapeTypes*/,
+																	  void* const* userPtrs,
+																	  int collisionFilterGroup,
+																	  int collisionFilterMask,
+																	  btDispatcher* /*dispatcher*/,
+																	  btBroadphaseProxy** proxies)
+{
+	if(numProxies<=0) return;
+	btAlignedObjectArray<btDbvtVolume>	volumes;
+	btAlignedObjectArray<void*>			data;
+	btAlignedObjectArray<btDbvtNode*>	leaves;
+	volumes.resize(numProxies);
+	data.resize(numProxies);
+	leaves.resize(numProxies);
+	for(int i=0;i<numProxies;++i)
+	{
+		btDbvtProxy*		proxy=new(btAlignedAlloc(sizeof(btDbvtProxy),16)) btDbvtProxy(	aabbMin[i],aabbMax[i],userPtrs[i],
+			collisionFilterGroup,
+			collisionFilterMask);
+		proxy->stage		=	STAGECOUNT;
+		proxy->m_uniqueId	=	++m_gid;
+		listappend(proxy,m_stageRoots[STAGECOUNT]);
+		volumes[i]	=	btDbvtVolume::FromMM(aabbMin[i],aabbMax[i]);
+		data[i]		=	proxy;
+		proxies[i]	=	proxy;
+	}
+	m_sets[1].insertBulk(&volumes[0],&data[0],numProxies,&leaves[0]);
+	for(int i=0;i<numProxies;++i)
+	{
+		((btDbvtProxy*)proxies[i])->leaf=leaves[i];
+	}
+	/* the fixed set is freshly built, nothing left to optimize	*/ 
+	m_fixedleft=0;
+	if(!m_deferedcollide)
+	{
+		/* fixed/fixed pairs never reach the narrowphase, only look for dynamic ones	*/ 
+		btDbvtTreeCollider	collider(this);
+		for(int i=0;i<numProxies;++i)
+		{
+			collider.proxy=(btDbvtProxy*)proxies[i];
+			m_sets[0].collideTV(m_sets[0].m_root,volumes[i],collider);
+		}
+	}
+}
+
 //
 void							btDbvtBroadphase::destroyProxy(	btBroadphaseProxy* absproxy,
 															   btDispatcher* dispatcher)
@@ -520,6 +569,41 @@ void btDbvtBroadphase::performDeferredRemoval(btDispatcher* dispatcher)
 }
 
 //
+//
+void							btDbvtBroadphase::getProxyState(const btBroadphaseProxy* absproxy,btDbvtVolume& volume,int& stage) const
+{
+	const btDbvtProxy*	proxy=(const btDbvtProxy*)absproxy;
+	volume	=	proxy->leaf->volume;
+	stage	=	proxy->stage;
+}
+
+//
+void							btDbvtBroadphase::setProxyState(btBroadphaseProxy* absproxy,const btDbvtVolume& volume,int stage)
+{
+	btDbvtProxy*	proxy=(btDbvtProxy*)absproxy;
+	const int		set=stage==STAGECOUNT?FIXED_SET:DYNAMIC_SET;
+	const int		current=proxy->stage==STAGECOUNT?FIXED_SET:DYNAMIC_SET;
+	if(set!=current)
+	{
+		m_sets[current].remove(proxy->leaf);
+		proxy->leaf=m_sets[set].insert(volume,proxy);
+	}
+	else if(NotEqual(volume,proxy->leaf->volume))
+	{/* grow the parents to fit instead of reinserting, the next update of the leaf tightens them again	*/ 
+		proxy->leaf->volume=volume;
+		for(btDbvtNode* node=proxy->leaf->parent;node&&!node->volume.Contain(volume);node=node->parent)
+		{
+			Merge(node->volume,volume,node->volume);
+		}
+	}
+	if(proxy->stage!=stage)
+	{
+		listremove(proxy,m_stageRoots[proxy->stage]);
+		proxy->stage	=	stage;
+		listappend(proxy,m_stageRoots[stage]);
+	}
+}
+
 void							btDbvtBroadphase::collide(btDispatcher* dispatcher)
 {
 	/*printf("---------------------------------------------------------\n");
@@ -115,6 +115,8 @@ struct	btDbvtBroadphase : btBroadphaseInterface
 	
 	/* btBroadphaseInterface Implementation	*/
 	btBroadphaseProxy*				createProxy(const btVector3& aabbMin,const btVector3& aabbMax,int shapeType,void* userPtr, int collisionFilterGroup, int collisionFilterMask,btDispatcher* dispatcher);
+	///static proxies go straight into the fixed set, which is rebuilt once with btDbvt::insertBulk, and are only paired against the dynamic set
+	void							createStaticProxies(int numProxies, const btVector3* aabbMin, const btVector3* aabbMax, const int* shapeTypes, void* const* userPtrs, int collisionFilterGroup, int collisionFilterMask, btDispatcher* dispatcher, btBroadphaseProxy** proxies);
 	virtual void					destroyProxy(btBroadphaseProxy* proxy,btDispatcher* dispatcher);
 	virtual void					setAabb(btBroadphaseProxy* proxy,const btVector3& aabbMin,const btVector3& aabbMax,btDispatcher* dispatcher);
 	virtual void					rayTest(const btVector3& rayFrom,const btVector3& rayTo, btBroadphaseRayCallback& rayCallback, const btVector3& aabbMin=btVector3(0,0,0), const btVector3& aabbMax = btVector3(0,0,0));
@@ -148,6 +150,11 @@ struct	btDbvtBroadphase : btBroadphaseInterface
 	///http://code.google.com/p/bullet/issues/detail?id=223
 	void							setAabbForceUpdate(		btBroadphaseProxy* absproxy,const btVector3& aabbMin,const btVector3& aabbMax,btDispatcher* /*dispatcher*/);
 
+	///leaf volume and stage of a proxy, what setAabb and collide leave behind for it; stage is STAGECOUNT in the fixed set
+	void							getProxyState(const btBroadphaseProxy* proxy,btDbvtVolume& volume,int& stage) const;
+	///puts a proxy back into the set and stage list of a saved state without looking for pairs, see btWorldSnapshot
+	void							setProxyState(btBroadphaseProxy* proxy,const btDbvtVolume& volume,int stage);
+
 	static void						benchmark(btBroadphaseInterface*);
 
 
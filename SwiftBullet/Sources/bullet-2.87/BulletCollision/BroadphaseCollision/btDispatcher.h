@@ -36,6 +36,10 @@ struct btCollisionObjectWrapper;
 class btPersistentManifold;
 class btPoolAllocator;
 
+///per brush narrowphase filter of btStaticBrushSetCollisionAlgorithm, return false to skip the brush for this object.
+///called from the dispatcher threads when btCollisionDispatcherMt is used
+typedef bool (*btStaticBrushPairCallback)(const btCollisionObjectWrapper* otherObjWrap, int brushIndex);
+
 struct btDispatcherInfo
 {
 	enum DispatchFunc
@@ -55,7 +59,9 @@ struct btDispatcherInfo
 		m_useEpa(true),
 		m_allowedCcdPenetration(btScalar(0.04)),
 		m_useConvexConservativeDistanceUtil(false),
-		m_convexConservativeDistanceThreshold(0.0f)
+		m_convexConservativeDistanceThreshold(0.0f),
+		m_deterministicOverlappingPairs(false),
+		m_staticBrushPairCallback(0)
 	{
 
 	}
@@ -71,6 +77,10 @@ struct btDispatcherInfo
 	btScalar	m_allowedCcdPenetration;
 	bool		m_useConvexConservativeDistanceUtil;
 	btScalar	m_convexConservativeDistanceThreshold;
+	///solve the manifolds and constraints of an island in an order that doesn't depend on the order pairs were found in
+	bool		m_deterministicOverlappingPairs;
+	///skips brushes of a btStaticBrushSetShape for some objects, null to collide with all of them
+	btStaticBrushPairCallback	m_staticBrushPairCallback;
 };
 
 enum ebtDispatcherQueryType
@@ -0,0 +1,1066 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btHashGridBroadphase.h"
+#include "LinearMath/btAabbUtil2.h"
+#include "LinearMath/btQuickprof.h"
+#include "LinearMath/btThreads.h"
+
+#include <stdio.h>
+
+//cells are swept in this many chunks at most, whatever the number of threads, so the pairs come out in the same order
+static const int	BT_HASH_GRID_MAX_CHUNKS = 64;
+static const int	BT_HASH_GRID_CELLS_PER_CHUNK = 32;
+
+static SIMD_FORCE_INLINE int	btHashGridCoordinate(btScalar value,btScalar invCellSize)
+{
+	//far away coordinates share the outermost cells instead of overflowing
+	const btScalar limit = btScalar(1 << 30);
+	const btScalar scaled = btClamped(value * invCellSize,-limit,limit);
+	const int coordinate = int(scaled);
+	return btScalar(coordinate) > scaled ? coordinate - 1 : coordinate;
+}
+
+static SIMD_FORCE_INLINE int	btHashGridDistance(int a,int b)
+{
+	return a < b ? b - a : a - b;
+}
+
+static SIMD_FORCE_INLINE bool	btHashGridContains(const btVector3& outerMin,const btVector3& outerMax,const btVector3& innerMin,const btVector3& innerMax)
+{
+	return outerMin.x() <= innerMin.x() && outerMin.y() <= innerMin.y() && outerMin.z() <= innerMin.z() &&
+		innerMax.x() <= outerMax.x() && innerMax.y() <= outerMax.y() && innerMax.z() <= outerMax.z();
+}
+
+struct btHashGridBroadphase::SortCellsLoop : public btIParallelForBody
+{
+	btHashGridBroadphase*	m_broadphase;
+
+	SortCellsLoop(btHashGridBroadphase* broadphase)
+	:m_broadphase(broadphase)
+	{
+	}
+
+	void	forLoop(int iBegin,int iEnd) const BT_OVERRIDE
+	{
+		for (int i=iBegin;i<iEnd;i++)
+		{
+			m_broadphase->sortCells(i);
+		}
+	}
+};
+
+struct btHashGridBroadphase::FindPairsLoop : public btIParallelForBody
+{
+	btHashGridBroadphase*	m_broadphase;
+
+	FindPairsLoop(btHashGridBroadphase* broadphase)
+	:m_broadphase(broadphase)
+	{
+	}
+
+	void	forLoop(int iBegin,int iEnd) const BT_OVERRIDE
+	{
+		for (int i=iBegin;i<iEnd;i++)
+		{
+			m_broadphase->findPairs(i);
+		}
+	}
+};
+
+btHashGridBroadphase::btHashGridBroadphase(btScalar cellSize,int numLevels,btOverlappingPairCache* pairCache)
+:m_pairCache(pairCache),
+m_ownsPairCache(pairCache == 0),
+m_numLevels(btMax(1,btMin(numLevels,int(MAX_LEVELS)))),
+m_uniqueId(0),
+m_numChunks(0)
+{
+	if (m_ownsPairCache)
+	{
+		m_pairCache = new(btAlignedAlloc(sizeof(btHashedOverlappingPairCache),16)) btHashedOverlappingPairCache();
+	}
+
+	btScalar size = cellSize;
+	for (int i=0;i<m_numLevels;i++)
+	{
+		m_cellSizes[i] = size;
+		m_invCellSizes[i] = btScalar(1.) / size;
+		size *= btScalar(2.);
+	}
+	for (int i=0;i<MAX_LEVELS + 2;i++)
+	{
+		m_levelStarts[i] = 0;
+	}
+
+#if BT_THREADSAFE
+	m_rayTestStacks.resize(BT_MAX_THREAD_COUNT);
+#else
+	m_rayTestStacks.resize(1);
+#endif
+}
+
+btHashGridBroadphase::~btHashGridBroadphase()
+{
+	if (m_ownsPairCache)
+	{
+		m_pairCache->~btOverlappingPairCache();
+		btAlignedFree(m_pairCache);
+	}
+}
+
+int	btHashGridBroadphase::getLevel(const btVector3& aabbMin,const btVector3& aabbMax) const
+{
+	const btVector3 extent = aabbMax - aabbMin;
+	const btScalar size = btMax(extent.x(),btMax(extent.y(),extent.z()));
+
+	int level = 0;
+	while (level < m_numLevels - 1 && size > m_cellSizes[level])
+	{
+		level++;
+	}
+
+	if (size > m_cellSizes[level])
+	{
+		const CellKey lo = getCellKey(aabbMin,level);
+		const CellKey hi = getCellKey(aabbMax,level);
+		const btScalar numCells = btScalar(hi.m_x - lo.m_x + 1) * btScalar(hi.m_y - lo.m_y + 1) * btScalar(hi.m_z - lo.m_z + 1);
+		if (numCells > btScalar(MAX_CELLS_PER_PROXY))
+		{
+			return m_numLevels;
+		}
+	}
+	return level;
+}
+
+btHashGridBroadphase::CellKey	btHashGridBroadphase::getCellKey(const btVector3& point,int level) const
+{
+	const btScalar invCellSize = m_invCellSizes[level];
+
+	CellKey key;
+	key.m_x = btHashGridCoordinate(point.x(),invCellSize);
+	key.m_y = btHashGridCoordinate(point.y(),invCellSize);
+	key.m_z = btHashGridCoordinate(point.z(),invCellSize);
+	key.m_level = level;
+	return key;
+}
+
+unsigned	btHashGridBroadphase::hashCellKey(const CellKey& key)
+{
+	unsigned hash = unsigned(key.m_x) * 73856093u ^ unsigned(key.m_y) * 19349663u ^ unsigned(key.m_z) * 83492791u ^ unsigned(key.m_level) * 2654435761u;
+	return hash ^ (hash >> 16);
+}
+
+int	btHashGridBroadphase::findCell(const CellKey& key) const
+{
+	if (m_cellTable.size() == 0)
+	{
+		return -1;
+	}
+
+	const unsigned mask = unsigned(m_cellTable.size() - 1);
+	for (unsigned slot = hashCellKey(key) & mask;;slot = (slot + 1) & mask)
+	{
+		const int index = m_cellTable[slot];
+		if (index < 0 || m_cells[index].m_key == key)
+		{
+			return index;
+		}
+	}
+}
+
+int	btHashGridBroadphase::findOrInsertCell(const CellKey& key)
+{
+	if ((m_cells.size() + 1) * 2 > m_cellTable.size())
+	{
+		growCellTable();
+	}
+
+	const unsigned mask = unsigned(m_cellTable.size() - 1);
+	for (unsigned slot = hashCellKey(key) & mask;;slot = (slot + 1) & mask)
+	{
+		const int index = m_cellTable[slot];
+		if (index >= 0)
+		{
+			if (m_cells[index].m_key == key)
+			{
+				return index;
+			}
+			continue;
+		}
+
+		Cell& cell = m_cells.expandNonInitializing();
+		cell.m_key = key;
+		cell.m_start = 0;
+		cell.m_count = 0;
+		m_cellTable[slot] = m_cells.size() - 1;
+		return m_cells.size() - 1;
+	}
+}
+
+void	btHashGridBroadphase::growCellTable()
+{
+	const int size = btMax(64,m_cellTable.size() * 2);
+	m_cellTable.resize(size);
+	for (int i=0;i<size;i++)
+	{
+		m_cellTable[i] = -1;
+	}
+
+	const unsigned mask = unsigned(size - 1);
+	for (int i=0;i<m_cells.size();i++)
+	{
+		unsigned slot = hashCellKey(m_cells[i].m_key) & mask;
+		while (m_cellTable[slot] >= 0)
+		{
+			slot = (slot + 1) & mask;
+		}
+		m_cellTable[slot] = i;
+	}
+}
+
+void	btHashGridBroadphase::buildGrid()
+{
+	BT_PROFILE("btHashGridBroadphase::buildGrid");
+
+	const int numProxies = m_dynamicProxies.size();
+
+	//proxies by level, the oversized ones last
+	int counts[MAX_LEVELS + 1];
+	for (int level=0;level<=m_numLevels;level++)
+	{
+		counts[level] = 0;
+	}
+	m_proxyLevels.resize(numProxies);
+	for (int i=0;i<numProxies;i++)
+	{
+		const btHashGridProxy* proxy = m_dynamicProxies[i];
+		m_proxyLevels[i] = getLevel(proxy->m_aabbMin,proxy->m_aabbMax);
+		counts[m_proxyLevels[i]]++;
+	}
+
+	int cursors[MAX_LEVELS + 1];
+	m_levelStarts[0] = 0;
+	for (int level=0;level<=m_numLevels;level++)
+	{
+		cursors[level] = m_levelStarts[level];
+		m_levelStarts[level + 1] = m_levelStarts[level] + counts[level];
+	}
+
+	m_gridProxies.resize(numProxies);
+	for (int i=0;i<numProxies;i++)
+	{
+		btHashGridProxy* proxy = m_dynamicProxies[i];
+		const int gridIndex = cursors[m_proxyLevels[i]]++;
+
+		GridProxy& gridProxy = m_gridProxies[gridIndex];
+		gridProxy.m_aabbMin = proxy->m_aabbMin;
+		gridProxy.m_aabbMax = proxy->m_aabbMax;
+		gridProxy.m_proxy = proxy;
+		gridProxy.m_level = m_proxyLevels[i];
+		proxy->m_gridIndex = gridIndex;
+	}
+
+	//everything is in the grid again
+	for (int i=0;i<m_looseProxies.size();i++)
+	{
+		m_looseProxies[i]->m_looseIndex = -1;
+	}
+	m_looseProxies.resize(0);
+
+	//cells of every proxy in order of first use, then the proxies of every cell next to each other
+	m_cells.resize(0);
+	for (int i=0;i<m_cellTable.size();i++)
+	{
+		m_cellTable[i] = -1;
+	}
+
+	const int numGridded = m_levelStarts[m_numLevels];
+	m_entryCells.resize(0);
+	for (int i=0;i<numGridded;i++)
+	{
+		const GridProxy& gridProxy = m_gridProxies[i];
+		const CellKey lo = getCellKey(gridProxy.m_aabbMin,gridProxy.m_level);
+		const CellKey hi = getCellKey(gridProxy.m_aabbMax,gridProxy.m_level);
+
+		CellKey key;
+		key.m_level = gridProxy.m_level;
+		for (key.m_z=lo.m_z;key.m_z<=hi.m_z;key.m_z++)
+		{
+			for (key.m_y=lo.m_y;key.m_y<=hi.m_y;key.m_y++)
+			{
+				for (key.m_x=lo.m_x;key.m_x<=hi.m_x;key.m_x++)
+				{
+					const int cell = findOrInsertCell(key);
+					m_cells[cell].m_count++;
+					m_entryCells.push_back(cell);
+					m_entryCells.push_back(i);
+				}
+			}
+		}
+	}
+
+	const int numCells = m_cells.size();
+	int start = 0;
+	for (int i=0;i<numCells;i++)
+	{
+		m_cells[i].m_start = start;
+		start += m_cells[i].m_count;
+	}
+
+	m_entries.resize(start);
+	m_cellFill.resize(numCells);
+	for (int i=0;i<numCells;i++)
+	{
+		m_cellFill[i] = 0;
+	}
+	for (int i=0;i<m_entryCells.size();i+=2)
+	{
+		const int cell = m_entryCells[i];
+		const int gridIndex = m_entryCells[i + 1];
+
+		Entry& entry = m_entries[m_cells[cell].m_start + m_cellFill[cell]++];
+		entry.m_minX = m_gridProxies[gridIndex].m_aabbMin.x();
+		entry.m_gridIndex = gridIndex;
+	}
+}
+
+struct btHashGridEntryLess
+{
+	template <typename Entry>
+	bool	operator()(const Entry& a,const Entry& b) const
+	{
+		return a.m_minX < b.m_minX || (a.m_minX == b.m_minX && a.m_gridIndex < b.m_gridIndex);
+	}
+};
+
+void	btHashGridBroadphase::sortCells(int chunk)
+{
+	const int numCells = m_cells.size();
+	const int begin = int((long long)numCells * chunk / m_numChunks);
+	const int end = int((long long)numCells * (chunk + 1) / m_numChunks);
+
+	//each chunk sorts its own cells, none of them shares an entry with another
+	for (int i=begin;i<end;i++)
+	{
+		const Cell& cell = m_cells[i];
+		if (cell.m_count > 1)
+		{
+			m_entries.quickSortInternal(btHashGridEntryLess(),cell.m_start,cell.m_start + cell.m_count - 1);
+		}
+	}
+}
+
+void	btHashGridBroadphase::findStaticPairs(const GridProxy& gridProxy,btAlignedObjectArray<Pair>& pairs,btNodeStack& stack) const
+{
+	struct StaticCollider : btDbvt::ICollide
+	{
+		btBroadphaseProxy*	m_proxy;
+		btAlignedObjectArray<Pair>*	m_pairs;
+
+		void	Process(const btDbvtNode* leaf)
+		{
+			Pair& pair = m_pairs->expandNonInitializing();
+			pair.m_proxy0 = m_proxy;
+			pair.m_proxy1 = (btBroadphaseProxy*)leaf->data;
+		}
+	};
+
+	if (m_staticSet.m_root == 0)
+	{
+		return;
+	}
+
+	StaticCollider collider;
+	collider.m_proxy = gridProxy.m_proxy;
+	collider.m_pairs = &pairs;
+	m_staticSet.collideTVNoStackAlloc(m_staticSet.m_root,btDbvtVolume::FromMM(gridProxy.m_aabbMin,gridProxy.m_aabbMax),stack,collider);
+}
+
+void	btHashGridBroadphase::findPairs(int chunk)
+{
+	btAlignedObjectArray<Pair>& pairs = m_chunkPairs[chunk];
+	btNodeStack& stack = m_chunkStacks[chunk];
+	pairs.resize(0);
+
+	//the chunk after the cells pairs the oversized proxies
+	if (chunk == m_numChunks)
+	{
+		findOversizedPairs(pairs,stack);
+		return;
+	}
+
+	const int numCells = m_cells.size();
+	const int begin = int((long long)numCells * chunk / m_numChunks);
+	const int end = int((long long)numCells * (chunk + 1) / m_numChunks);
+
+	for (int c=begin;c<end;c++)
+	{
+		const Cell& cell = m_cells[c];
+		const Entry* entries = &m_entries[cell.m_start];
+		const int level = cell.m_key.m_level;
+
+		for (int i=0;i<cell.m_count;i++)
+		{
+			const GridProxy& a = m_gridProxies[entries[i].m_gridIndex];
+
+			//proxies of the same level sharing the cell, sorted along x; the overlap of a pair spanning several cells
+			//has its lowest corner in only one of them
+			for (int j=i+1;j<cell.m_count && entries[j].m_minX <= a.m_aabbMax.x();j++)
+			{
+				const GridProxy& b = m_gridProxies[entries[j].m_gridIndex];
+				if (a.m_aabbMin.y() > b.m_aabbMax.y() || a.m_aabbMax.y() < b.m_aabbMin.y() ||
+					a.m_aabbMin.z() > b.m_aabbMax.z() || a.m_aabbMax.z() < b.m_aabbMin.z())
+				{
+					continue;
+				}
+
+				btVector3 corner = a.m_aabbMin;
+				corner.setMax(b.m_aabbMin);
+				if (!(getCellKey(corner,level) == cell.m_key))
+				{
+					continue;
+				}
+
+				Pair& pair = pairs.expandNonInitializing();
+				pair.m_proxy0 = a.m_proxy;
+				pair.m_proxy1 = b.m_proxy;
+			}
+
+			//the coarser levels and the static tree once per proxy, from the cell that holds its lowest corner
+			if (!(getCellKey(a.m_aabbMin,level) == cell.m_key))
+			{
+				continue;
+			}
+
+			for (int upper=level+1;upper<m_numLevels;upper++)
+			{
+				if (m_levelStarts[upper + 1] == m_levelStarts[upper])
+				{
+					continue;
+				}
+
+				const CellKey lo = getCellKey(a.m_aabbMin,upper);
+				const CellKey hi = getCellKey(a.m_aabbMax,upper);
+
+				CellKey key;
+				key.m_level = upper;
+				for (key.m_z=lo.m_z;key.m_z<=hi.m_z;key.m_z++)
+				{
+					for (key.m_y=lo.m_y;key.m_y<=hi.m_y;key.m_y++)
+					{
+						for (key.m_x=lo.m_x;key.m_x<=hi.m_x;key.m_x++)
+						{
+							const int index = findCell(key);
+							if (index < 0)
+							{
+								continue;
+							}
+
+							const Cell& other = m_cells[index];
+							for (int k=0;k<other.m_count;k++)
+							{
+								const GridProxy& b = m_gridProxies[m_entries[other.m_start + k].m_gridIndex];
+								if (!TestAabbAgainstAabb2(a.m_aabbMin,a.m_aabbMax,b.m_aabbMin,b.m_aabbMax))
+								{
+									continue;
+								}
+
+								btVector3 corner = a.m_aabbMin;
+								corner.setMax(b.m_aabbMin);
+								if (!(getCellKey(corner,upper) == key))
+								{
+									continue;
+								}
+
+								Pair& pair = pairs.expandNonInitializing();
+								pair.m_proxy0 = a.m_proxy;
+								pair.m_proxy1 = b.m_proxy;
+							}
+						}
+					}
+				}
+			}
+
+			findStaticPairs(a,pairs,stack);
+		}
+	}
+}
+
+void	btHashGridBroadphase::findOversizedPairs(btAlignedObjectArray<Pair>& pairs,btNodeStack& stack) const
+{
+	const int begin = m_levelStarts[m_numLevels];
+	const int end = m_levelStarts[m_numLevels + 1];
+
+	for (int i=begin;i<end;i++)
+	{
+		const GridProxy& a = m_gridProxies[i];
+
+		//everything in the grid, and the oversized ones after this one
+		for (int j=0;j<end;j++)
+		{
+			if (j == begin)
+			{
+				j = i + 1;
+				if (j >= end)
+				{
+					break;
+				}
+			}
+
+			const GridProxy& b = m_gridProxies[j];
+			if (TestAabbAgainstAabb2(a.m_aabbMin,a.m_aabbMax,b.m_aabbMin,b.m_aabbMax))
+			{
+				Pair& pair = pairs.expandNonInitializing();
+				pair.m_proxy0 = a.m_proxy;
+				pair.m_proxy1 = b.m_proxy;
+			}
+		}
+
+		findStaticPairs(a,pairs,stack);
+	}
+}
+
+void	btHashGridBroadphase::calculateOverlappingPairs(btDispatcher* dispatcher)
+{
+	BT_PROFILE("btHashGridBroadphase::calculateOverlappingPairs");
+
+	buildGrid();
+
+	const int numCells = m_cells.size();
+	m_numChunks = btMin(BT_HASH_GRID_MAX_CHUNKS,(numCells + BT_HASH_GRID_CELLS_PER_CHUNK - 1) / BT_HASH_GRID_CELLS_PER_CHUNK);
+	if (m_chunkPairs.size() < m_numChunks + 1)
+	{
+		m_chunkPairs.resize(m_numChunks + 1);
+		m_chunkStacks.resize(m_numChunks + 1);
+	}
+
+	{
+		BT_PROFILE("findPairs");
+		if (m_numChunks > 0)
+		{
+			btParallelFor(0,m_numChunks,1,SortCellsLoop(this));
+		}
+		btParallelFor(0,m_numChunks + 1,1,FindPairsLoop(this));
+	}
+
+	//in chunk order, so the pair cache and the narrowphase see the same order for any number of threads
+	for (int chunk=0;chunk<=m_numChunks;chunk++)
+	{
+		const btAlignedObjectArray<Pair>& pairs = m_chunkPairs[chunk];
+		for (int i=0;i<pairs.size();i++)
+		{
+			m_pairCache->addOverlappingPair(pairs[i].m_proxy0,pairs[i].m_proxy1);
+		}
+	}
+
+	//pairs that stopped overlapping, from the back since removing one moves the last pair into its place
+	btBroadphasePairArray& overlappingPairs = m_pairCache->getOverlappingPairArray();
+	for (int i=overlappingPairs.size()-1;i>=0;i--)
+	{
+		btBroadphaseProxy* proxy0 = overlappingPairs[i].m_pProxy0;
+		btBroadphaseProxy* proxy1 = overlappingPairs[i].m_pProxy1;
+		if (!TestAabbAgainstAabb2(proxy0->m_aabbMin,proxy0->m_aabbMax,proxy1->m_aabbMin,proxy1->m_aabbMax))
+		{
+			m_pairCache->removeOverlappingPair(proxy0,proxy1,dispatcher);
+		}
+	}
+}
+
+btBroadphaseProxy*	btHashGridBroadphase::createProxy(const btVector3& aabbMin,const btVector3& aabbMax,int /*shapeType*/,void* userPtr,int collisionFilterGroup,int collisionFilterMask,btDispatcher* /*dispatcher*/)
+{
+	btHashGridProxy* proxy = new(btAlignedAlloc(sizeof(btHashGridProxy),16)) btHashGridProxy(aabbMin,aabbMax,userPtr,collisionFilterGroup,collisionFilterMask);
+	proxy->m_uniqueId = ++m_uniqueId;
+
+	if (collisionFilterGroup & btBroadphaseProxy::StaticFilter)
+	{
+		proxy->m_leaf = m_staticSet.insert(btDbvtVolume::FromMM(aabbMin,aabbMax),proxy);
+		return proxy;
+	}
+
+	//queries test it one by one until the next build puts it into the grid
+	proxy->m_index = m_dynamicProxies.size();
+	m_dynamicProxies.push_back(proxy);
+	proxy->m_looseIndex = m_looseProxies.size();
+	m_looseProxies.push_back(proxy);
+	return proxy;
+}
+
+void	btHashGridBroadphase::createStaticProxies(int numProxies,const btVector3* aabbMin,const btVector3* aabbMax,const int* /*shapeTypes*/,void* const* userPtrs,int collisionFilterGroup,int collisionFilterMask,btDispatcher* /*dispatcher*/,btBroadphaseProxy** proxies)
+{
+	if (numProxies <= 0)
+	{
+		return;
+	}
+
+	btAlignedObjectArray<btDbvtVolume> volumes;
+	btAlignedObjectArray<void*> data;
+	btAlignedObjectArray<btDbvtNode*> leaves;
+	volumes.resize(numProxies);
+	data.resize(numProxies);
+	leaves.resize(numProxies);
+	for (int i=0;i<numProxies;i++)
+	{
+		btHashGridProxy* proxy = new(btAlignedAlloc(sizeof(btHashGridProxy),16)) btHashGridProxy(aabbMin[i],aabbMax[i],userPtrs[i],collisionFilterGroup,collisionFilterMask);
+		proxy->m_uniqueId = ++m_uniqueId;
+		volumes[i] = btDbvtVolume::FromMM(aabbMin[i],aabbMax[i]);
+		data[i] = proxy;
+		proxies[i] = proxy;
+	}
+	m_staticSet.insertBulk(&volumes[0],&data[0],numProxies,&leaves[0]);
+	for (int i=0;i<numProxies;i++)
+	{
+		((btHashGridProxy*)proxies[i])->m_leaf = leaves[i];
+	}
+}
+
+void	btHashGridBroadphase::destroyProxy(btBroadphaseProxy* absproxy,btDispatcher* dispatcher)
+{
+	btHashGridProxy* proxy = (btHashGridProxy*)absproxy;
+
+	if (proxy->m_leaf)
+	{
+		m_staticSet.remove(proxy->m_leaf);
+	}
+	else
+	{
+		btHashGridProxy* last = m_dynamicProxies[m_dynamicProxies.size() - 1];
+		m_dynamicProxies[proxy->m_index] = last;
+		last->m_index = proxy->m_index;
+		m_dynamicProxies.pop_back();
+
+		//queries skip it until the next build
+		if (proxy->m_gridIndex >= 0)
+		{
+			m_gridProxies[proxy->m_gridIndex].m_proxy = 0;
+		}
+		if (proxy->m_looseIndex >= 0)
+		{
+			btHashGridProxy* lastLoose = m_looseProxies[m_looseProxies.size() - 1];
+			m_looseProxies[proxy->m_looseIndex] = lastLoose;
+			lastLoose->m_looseIndex = proxy->m_looseIndex;
+			m_looseProxies.pop_back();
+		}
+	}
+
+	m_pairCache->removeOverlappingPairsContainingProxy(proxy,dispatcher);
+	btAlignedFree(proxy);
+}
+
+void	btHashGridBroadphase::setAabb(btBroadphaseProxy* absproxy,const btVector3& aabbMin,const btVector3& aabbMax,btDispatcher* /*dispatcher*/)
+{
+	btHashGridProxy* proxy = (btHashGridProxy*)absproxy;
+
+	if (proxy->m_leaf)
+	{
+		//updateAabbs sets the bounds of static bodies every step, leave the tree alone unless they changed
+		if (aabbMin == proxy->m_aabbMin && aabbMax == proxy->m_aabbMax)
+		{
+			return;
+		}
+		proxy->m_aabbMin = aabbMin;
+		proxy->m_aabbMax = aabbMax;
+
+		btDbvtVolume volume = btDbvtVolume::FromMM(aabbMin,aabbMax);
+		m_staticSet.update(proxy->m_leaf,volume);
+		return;
+	}
+
+	proxy->m_aabbMin = aabbMin;
+	proxy->m_aabbMax = aabbMax;
+
+	if (proxy->m_looseIndex >= 0)
+	{
+		return;
+	}
+	if (proxy->m_gridIndex >= 0)
+	{
+		const GridProxy& gridProxy = m_gridProxies[proxy->m_gridIndex];
+		if (btHashGridContains(gridProxy.m_aabbMin,gridProxy.m_aabbMax,aabbMin,aabbMax))
+		{
+			return;
+		}
+	}
+
+	//left the cells it is in, queries test it one by one until the next build
+	proxy->m_looseIndex = m_looseProxies.size();
+	m_looseProxies.push_back(proxy);
+}
+
+void	btHashGridBroadphase::getAabb(btBroadphaseProxy* proxy,btVector3& aabbMin,btVector3& aabbMax) const
+{
+	aabbMin = proxy->m_aabbMin;
+	aabbMax = proxy->m_aabbMax;
+}
+
+template <typename Visitor>
+void	btHashGridBroadphase::visitRange(int begin,int end,Visitor& visitor) const
+{
+	for (int i=begin;i<end;i++)
+	{
+		btHashGridProxy* proxy = m_gridProxies[i].m_proxy;
+		if (proxy && proxy->m_looseIndex < 0)
+		{
+			visitor(proxy);
+		}
+	}
+}
+
+template <typename Visitor>
+void	btHashGridBroadphase::visitLoose(Visitor& visitor) const
+{
+	for (int i=0;i<m_looseProxies.size();i++)
+	{
+		visitor(m_looseProxies[i]);
+	}
+}
+
+template <typename Visitor>
+void	btHashGridBroadphase::visitBox(int level,const btVector3& aabbMin,const btVector3& aabbMax,Visitor& visitor) const
+{
+	const int begin = m_levelStarts[level];
+	const int end = m_levelStarts[level + 1];
+	if (begin == end)
+	{
+		return;
+	}
+
+	const CellKey lo = getCellKey(aabbMin,level);
+	const CellKey hi = getCellKey(aabbMax,level);
+
+	//a box covering more cells than the level has proxies is cheaper to answer one by one
+	const btScalar numCells = btScalar(hi.m_x - lo.m_x + 1) * btScalar(hi.m_y - lo.m_y + 1) * btScalar(hi.m_z - lo.m_z + 1);
+	if (numCells > btScalar(end - begin))
+	{
+		visitRange(begin,end,visitor);
+		return;
+	}
+
+	CellKey key;
+	key.m_level = level;
+	for (key.m_z=lo.m_z;key.m_z<=hi.m_z;key.m_z++)
+	{
+		for (key.m_y=lo.m_y;key.m_y<=hi.m_y;key.m_y++)
+		{
+			for (key.m_x=lo.m_x;key.m_x<=hi.m_x;key.m_x++)
+			{
+				const int index = findCell(key);
+				if (index < 0)
+				{
+					continue;
+				}
+
+				const Cell& cell = m_cells[index];
+				for (int i=0;i<cell.m_count;i++)
+				{
+					const GridProxy& gridProxy = m_gridProxies[m_entries[cell.m_start + i].m_gridIndex];
+					if (gridProxy.m_proxy == 0 || gridProxy.m_proxy->m_looseIndex >= 0)
+					{
+						continue;
+					}
+
+					//only from the cell holding the lowest corner of the overlap
+					btVector3 corner = gridProxy.m_aabbMin;
+					corner.setMax(aabbMin);
+					if (!(getCellKey(corner,level) == key))
+					{
+						continue;
+					}
+					visitor(gridProxy.m_proxy);
+				}
+			}
+		}
+	}
+}
+
+template <typename Visitor>
+void	btHashGridBroadphase::visitRay(int level,const btVector3& rayFrom,const btVector3& rayTo,Visitor& visitor) const
+{
+	const int begin = m_levelStarts[level];
+	const int end = m_levelStarts[level + 1];
+	if (begin == end)
+	{
+		return;
+	}
+
+	CellKey cell = getCellKey(rayFrom,level);
+	const CellKey last = getCellKey(rayTo,level);
+
+	//a ray through more cells than the level has proxies is cheaper to answer one by one
+	const int numSteps = btHashGridDistance(cell.m_x,last.m_x) + btHashGridDistance(cell.m_y,last.m_y) + btHashGridDistance(cell.m_z,last.m_z);
+	if (numSteps + 1 > end - begin)
+	{
+		visitRange(begin,end,visitor);
+		return;
+	}
+
+	//walks the cells along the ray from the first to the last one, one axis at a time; a proxy holding the ray
+	//is in one of them, and a proxy is visited from the first of its cells the walk enters
+	const btVector3 delta = rayTo - rayFrom;
+	const btScalar cellSize = m_cellSizes[level];
+	int* coordinates[3] = {&cell.m_x,&cell.m_y,&cell.m_z};
+	const int lastCoordinates[3] = {last.m_x,last.m_y,last.m_z};
+	int steps[3];
+	btScalar next[3];
+	btScalar advance[3];
+	for (int axis=0;axis<3;axis++)
+	{
+		const int coordinate = *coordinates[axis];
+		if (coordinate == lastCoordinates[axis])
+		{
+			steps[axis] = 0;
+			next[axis] = BT_LARGE_FLOAT;
+			advance[axis] = 0;
+		}
+		else if (delta[axis] > 0)
+		{
+			steps[axis] = 1;
+			next[axis] = (btScalar(coordinate + 1) * cellSize - rayFrom[axis]) / delta[axis];
+			advance[axis] = cellSize / delta[axis];
+		}
+		else
+		{
+			steps[axis] = -1;
+			next[axis] = (btScalar(coordinate) * cellSize - rayFrom[axis]) / delta[axis];
+			advance[axis] = -cellSize / delta[axis];
+		}
+	}
+
+	CellKey previous = cell;
+	for (int step=0;step<=numSteps;step++)
+	{
+		const int index = findCell(cell);
+		if (index >= 0)
+		{
+			const Cell& current = m_cells[index];
+			for (int i=0;i<current.m_count;i++)
+			{
+				const GridProxy& gridProxy = m_gridProxies[m_entries[current.m_start + i].m_gridIndex];
+				if (gridProxy.m_proxy == 0 || gridProxy.m_proxy->m_looseIndex >= 0)
+				{
+					continue;
+				}
+
+				if (step > 0)
+				{
+					const CellKey lo = getCellKey(gridProxy.m_aabbMin,level);
+					const CellKey hi = getCellKey(gridProxy.m_aabbMax,level);
+					if (lo.m_x <= previous.m_x && previous.m_x <= hi.m_x &&
+						lo.m_y <= previous.m_y && previous.m_y <= hi.m_y &&
+						lo.m_z <= previous.m_z && previous.m_z <= hi.m_z)
+					{
+						continue;
+					}
+				}
+				visitor(gridProxy.m_proxy);
+			}
+		}
+
+		//the walk never passes the last cell on any axis, so it ends there after numSteps steps
+		previous = cell;
+		int axis = next[0] <= next[1] ? 0 : 1;
+		if (next[2] < next[axis])
+		{
+			axis = 2;
+		}
+		*coordinates[axis] += steps[axis];
+		next[axis] += advance[axis];
+		if (*coordinates[axis] == lastCoordinates[axis])
+		{
+			next[axis] = BT_LARGE_FLOAT;
+		}
+	}
+}
+
+struct btHashGridRayTester : btDbvt::ICollide
+{
+	btBroadphaseRayCallback&	m_rayCallback;
+	const btVector3&	m_rayFrom;
+	const btVector3&	m_aabbMin;
+	const btVector3&	m_aabbMax;
+
+	btHashGridRayTester(btBroadphaseRayCallback& rayCallback,const btVector3& rayFrom,const btVector3& aabbMin,const btVector3& aabbMax)
+	:m_rayCallback(rayCallback),
+	m_rayFrom(rayFrom),
+	m_aabbMin(aabbMin),
+	m_aabbMax(aabbMax)
+	{
+	}
+
+	void	Process(const btDbvtNode* leaf)
+	{
+		m_rayCallback.process((btBroadphaseProxy*)leaf->data);
+	}
+
+	//the same slab test btDbvt::rayTestInternal does on its nodes
+	void	operator()(btBroadphaseProxy* proxy)
+	{
+		btVector3 bounds[2];
+		bounds[0] = proxy->m_aabbMin - m_aabbMax;
+		bounds[1] = proxy->m_aabbMax - m_aabbMin;
+		btScalar tmin;
+		if (btRayAabb2(m_rayFrom,m_rayCallback.m_rayDirectionInverse,m_rayCallback.m_signs,bounds,tmin,0,m_rayCallback.m_lambda_max))
+		{
+			m_rayCallback.process(proxy);
+		}
+	}
+};
+
+void	btHashGridBroadphase::rayTest(const btVector3& rayFrom,const btVector3& rayTo,btBroadphaseRayCallback& rayCallback,const btVector3& aabbMin,const btVector3& aabbMax)
+{
+	btHashGridRayTester tester(rayCallback,rayFrom,aabbMin,aabbMax);
+
+	if (m_staticSet.m_root)
+	{
+		btNodeStack* stack = &m_rayTestStacks[0];
+#if BT_THREADSAFE
+		//one stack per thread, rays may be cast from several of them at once
+		const int threadIndex = btGetCurrentThreadIndex();
+		btNodeStack localStack;
+		if (threadIndex < m_rayTestStacks.size())
+		{
+			stack = &m_rayTestStacks[threadIndex];
+		}
+		else
+		{
+			stack = &localStack;
+		}
+#endif
+		m_staticSet.rayTestInternal(m_staticSet.m_root,
+			rayFrom,
+			rayTo,
+			rayCallback.m_rayDirectionInverse,
+			rayCallback.m_signs,
+			rayCallback.m_lambda_max,
+			aabbMin,
+			aabbMax,
+			*stack,
+			tester);
+	}
+
+	if (aabbMin == btVector3(0,0,0) && aabbMax == btVector3(0,0,0))
+	{
+		for (int level=0;level<m_numLevels;level++)
+		{
+			visitRay(level,rayFrom,rayTo,tester);
+		}
+	}
+	else
+	{
+		//a swept box, every cell the sweep touches
+		btVector3 sweepMin = rayFrom;
+		btVector3 sweepMax = rayFrom;
+		sweepMin.setMin(rayTo);
+		sweepMax.setMax(rayTo);
+		sweepMin += aabbMin;
+		sweepMax += aabbMax;
+		for (int level=0;level<m_numLevels;level++)
+		{
+			visitBox(level,sweepMin,sweepMax,tester);
+		}
+	}
+
+	visitRange(m_levelStarts[m_numLevels],m_levelStarts[m_numLevels + 1],tester);
+	visitLoose(tester);
+}
+
+struct btHashGridAabbTester : btDbvt::ICollide
+{
+	btBroadphaseAabbCallback&	m_callback;
+	const btVector3&	m_aabbMin;
+	const btVector3&	m_aabbMax;
+
+	btHashGridAabbTester(btBroadphaseAabbCallback& callback,const btVector3& aabbMin,const btVector3& aabbMax)
+	:m_callback(callback),
+	m_aabbMin(aabbMin),
+	m_aabbMax(aabbMax)
+	{
+	}
+
+	void	Process(const btDbvtNode* leaf)
+	{
+		m_callback.process((btBroadphaseProxy*)leaf->data);
+	}
+
+	void	operator()(btBroadphaseProxy* proxy)
+	{
+		if (TestAabbAgainstAabb2(m_aabbMin,m_aabbMax,proxy->m_aabbMin,proxy->m_aabbMax))
+		{
+			m_callback.process(proxy);
+		}
+	}
+};
+
+void	btHashGridBroadphase::aabbTest(const btVector3& aabbMin,const btVector3& aabbMax,btBroadphaseAabbCallback& callback)
+{
+	btHashGridAabbTester tester(callback,aabbMin,aabbMax);
+
+	if (m_staticSet.m_root)
+	{
+		m_staticSet.collideTV(m_staticSet.m_root,btDbvtVolume::FromMM(aabbMin,aabbMax),tester);
+	}
+
+	for (int level=0;level<m_numLevels;level++)
+	{
+		visitBox(level,aabbMin,aabbMax,tester);
+	}
+	visitRange(m_levelStarts[m_numLevels],m_levelStarts[m_numLevels + 1],tester);
+	visitLoose(tester);
+}
+
+void	btHashGridBroadphase::getBroadphaseAabb(btVector3& aabbMin,btVector3& aabbMax) const
+{
+	if (m_staticSet.m_root)
+	{
+		aabbMin = m_staticSet.m_root->volume.Mins();
+		aabbMax = m_staticSet.m_root->volume.Maxs();
+	}
+	else if (m_dynamicProxies.size())
+	{
+		aabbMin = m_dynamicProxies[0]->m_aabbMin;
+		aabbMax = m_dynamicProxies[0]->m_aabbMax;
+	}
+	else
+	{
+		aabbMin.setValue(0,0,0);
+		aabbMax.setValue(0,0,0);
+		return;
+	}
+
+	for (int i=0;i<m_dynamicProxies.size();i++)
+	{
+		aabbMin.setMin(m_dynamicProxies[i]->m_aabbMin);
+		aabbMax.setMax(m_dynamicProxies[i]->m_aabbMax);
+	}
+}
+
+void	btHashGridBroadphase::printStats()
+{
+	printf("btHashGridBroadphase: %d dynamic proxies in %d cells on %d levels, %d oversized, %d static proxies\n",
+		m_dynamicProxies.size(),m_cells.size(),m_numLevels,getNumProxiesOnLevel(m_numLevels),m_staticSet.m_leaves);
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,228 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_HASH_GRID_BROADPHASE_H
+#define BT_HASH_GRID_BROADPHASE_H
+
+#include "BulletCollision/BroadphaseCollision/btBroadphaseInterface.h"
+#include "BulletCollision/BroadphaseCollision/btDbvt.h"
+#include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+struct btHashGridProxy : btBroadphaseProxy
+{
+	btDbvtNode*	m_leaf;			//in the static tree, 0 for dynamic proxies
+	int	m_index;				//in the dynamic proxies
+	int	m_gridIndex;			//in the grid of the last calculateOverlappingPairs, -1 when it isn't in there
+	int	m_looseIndex;			//in the proxies queries test one by one until the next build, -1 otherwise
+
+	btHashGridProxy(const btVector3& aabbMin,const btVector3& aabbMax,void* userPtr,int collisionFilterGroup,int collisionFilterMask)
+	:btBroadphaseProxy(aabbMin,aabbMax,userPtr,collisionFilterGroup,collisionFilterMask),
+	m_leaf(0),
+	m_index(-1),
+	m_gridIndex(-1),
+	m_looseIndex(-1)
+	{
+	}
+};
+
+///btHashGridBroadphase keeps dynamic proxies in a stack of uniform grids hashed by cell and static ones (StaticFilter, or made
+///with createStaticProxies) in a btDbvt. Level 0 has cells of cellSize, every level above twice the size of the one below, and
+///a proxy goes into the lowest level whose cells are at least as large as it is, so it covers at most eight of them.
+///calculateOverlappingPairs builds the grids again from scratch and sweeps the cells in parallel with btParallelFor: proxies
+///sharing a cell are sorted along x and swept, and every proxy looks up the cells it covers on the coarser levels and in the
+///static tree. A pair is only reported by the one cell that holds the lowest corner of the overlap, so no cell needs to know
+///what another found. The pairs are reported in the same order for any thread count.
+///Building everything again is cheaper than updating a tree when thousands of small bodies move every frame, but it costs the
+///same for resting ones, so btDbvtBroadphase is still the better choice for a world that mostly sleeps.
+///Queries between two calculateOverlappingPairs see proxies that were added or moved out of their cells since by testing them
+///one by one. rayTest walks the cells along the ray on each level, and it and aabbTest may run on several threads at once.
+class btHashGridBroadphase : public btBroadphaseInterface
+{
+public:
+
+	enum
+	{
+		MAX_LEVELS = 16,
+		//proxies that would cover more cells than this even on the top level are paired with everything one by one
+		MAX_CELLS_PER_PROXY = 64
+	};
+
+protected:
+
+	struct GridProxy
+	{
+		btVector3	m_aabbMin;		//as of the last build, the cells it is in cover this
+		btVector3	m_aabbMax;
+		btHashGridProxy*	m_proxy;	//0 once destroyed
+		int	m_level;				//getNumLevels() for oversized proxies
+	};
+
+	struct CellKey
+	{
+		int	m_x;
+		int	m_y;
+		int	m_z;
+		int	m_level;
+
+		bool	operator==(const CellKey& other) const
+		{
+			return m_x == other.m_x && m_y == other.m_y && m_z == other.m_z && m_level == other.m_level;
+		}
+	};
+
+	struct Cell
+	{
+		CellKey	m_key;
+		int	m_start;				//in m_entries
+		int	m_count;
+	};
+
+	struct Entry
+	{
+		btScalar	m_minX;
+		int	m_gridIndex;
+	};
+
+	struct Pair
+	{
+		btBroadphaseProxy*	m_proxy0;
+		btBroadphaseProxy*	m_proxy1;
+	};
+
+	btOverlappingPairCache*	m_pairCache;
+	bool	m_ownsPairCache;
+
+	int	m_numLevels;
+	btScalar	m_cellSizes[MAX_LEVELS];
+	btScalar	m_invCellSizes[MAX_LEVELS];
+
+	btDbvt	m_staticSet;
+	btAlignedObjectArray<btHashGridProxy*>	m_dynamicProxies;
+	btAlignedObjectArray<btHashGridProxy*>	m_looseProxies;
+	int	m_uniqueId;
+
+	//the grid, proxies by level with the oversized ones last, cells in order of first use
+	btAlignedObjectArray<GridProxy>	m_gridProxies;
+	int	m_levelStarts[MAX_LEVELS + 2];
+	btAlignedObjectArray<Cell>	m_cells;
+	btAlignedObjectArray<int>	m_cellTable;	//open addressing, index in m_cells or -1
+	btAlignedObjectArray<Entry>	m_entries;
+
+	//scratch of the build and of every chunk of cells calculateOverlappingPairs sweeps
+	btAlignedObjectArray<int>	m_proxyLevels;
+	btAlignedObjectArray<int>	m_entryCells;
+	btAlignedObjectArray<int>	m_cellFill;
+	btAlignedObjectArray< btAlignedObjectArray<Pair> >	m_chunkPairs;
+	btAlignedObjectArray<btNodeStack>	m_chunkStacks;
+	int	m_numChunks;
+	btAlignedObjectArray<btNodeStack>	m_rayTestStacks;
+
+	int	getLevel(const btVector3& aabbMin,const btVector3& aabbMax) const;
+	CellKey	getCellKey(const btVector3& point,int level) const;
+	static unsigned	hashCellKey(const CellKey& key);
+	int	findCell(const CellKey& key) const;
+	int	findOrInsertCell(const CellKey& key);
+	void	growCellTable();
+
+	void	buildGrid();
+	void	sortCells(int chunk);
+	void	findPairs(int chunk);
+	void	findOversizedPairs(btAlignedObjectArray<Pair>& pairs,btNodeStack& stack) const;
+	void	findStaticPairs(const GridProxy& gridProxy,btAlignedObjectArray<Pair>& pairs,btNodeStack& stack) const;
+
+	template <typename Visitor>
+	void	visitBox(int level,const btVector3& aabbMin,const btVector3& aabbMax,Visitor& visitor) const;
+	template <typename Visitor>
+	void	visitRay(int level,const btVector3& rayFrom,const btVector3& rayTo,Visitor& visitor) const;
+	template <typename Visitor>
+	void	visitRange(int begin,int end,Visitor& visitor) const;
+	template <typename Visitor>
+	void	visitLoose(Visitor& visitor) const;
+
+	struct SortCellsLoop;
+	struct FindPairsLoop;
+	friend struct SortCellsLoop;
+	friend struct FindPairsLoop;
+
+public:
+
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	///cellSize is the cell size of the lowest level, about the size of the smallest bodies; the top level has cells of
+	///cellSize * 2^(numLevels - 1)
+	btHashGridBroadphase(btScalar cellSize = btScalar(0.5),int numLevels = 8,btOverlappingPairCache* pairCache = 0);
+	virtual ~btHashGridBroadphase();
+
+	int	getNumLevels() const
+	{
+		return m_numLevels;
+	}
+	btScalar	getCellSize(int level) const
+	{
+		return m_cellSizes[level];
+	}
+	///proxies on level of the grid the last calculateOverlappingPairs built, level getNumLevels() holds the oversized ones
+	int	getNumProxiesOnLevel(int level) const
+	{
+		return m_levelStarts[level + 1] - m_levelStarts[level];
+	}
+	int	getNumCells() const
+	{
+		return m_cells.size();
+	}
+
+	virtual btBroadphaseProxy*	createProxy(const btVector3& aabbMin,const btVector3& aabbMax,int shapeType,void* userPtr,int collisionFilterGroup,int collisionFilterMask,btDispatcher* dispatcher);
+	///the proxies go into the static tree, which is rebuilt once with btDbvt::insertBulk
+	virtual void	createStaticProxies(int numProxies,const btVector3* aabbMin,const btVector3* aabbMax,const int* shapeTypes,void* const* userPtrs,int collisionFilterGroup,int collisionFilterMask,btDispatcher* dispatcher,btBroadphaseProxy** proxies);
+	virtual void	destroyProxy(btBroadphaseProxy* proxy,btDispatcher* dispatcher);
+	virtual void	setAabb(btBroadphaseProxy* proxy,const btVector3& aabbMin,const btVector3& aabbMax,btDispatcher* dispatcher);
+	virtual void	getAabb(btBroadphaseProxy* proxy,btVector3& aabbMin,btVector3& aabbMax) const;
+
+	virtual void	rayTest(const btVector3& rayFrom,const btVector3& rayTo,btBroadphaseRayCallback& rayCallback,const btVector3& aabbMin = btVector3(0,0,0),const btVector3& aabbMax = btVector3(0,0,0));
+	virtual void	aabbTest(const btVector3& aabbMin,const btVector3& aabbMax,btBroadphaseAabbCallback& callback);
+
+	///builds the grid, adds the pairs that overlap now and removes the ones that stopped
+	virtual void	calculateOverlappingPairs(btDispatcher* dispatcher);
+
+	virtual btOverlappingPairCache*	getOverlappingPairCache()
+	{
+		return m_pairCache;
+	}
+	virtual const btOverlappingPairCache*	getOverlappingPairCache() const
+	{
+		return m_pairCache;
+	}
+
+	virtual void	getBroadphaseAabb(btVector3& aabbMin,btVector3& aabbMax) const;
+
+	virtual void	printStats();
+};
+
+#endif //BT_HASH_GRID_BROADPHASE_H
+
+#pragma clang diagnostic pop
@@ -23,6 +23,7 @@ subject to the following restrictions:
 */
 
 #include "btQuantizedBvh.h"
+#include "btRayPacket.h"
 
 #include "LinearMath/btAabbUtil2.h"
 #include "LinearMath/btIDebugDraw.h"
@@ -693,6 +694,86 @@ void	btQuantizedBvh::walkStacklessQuantizedTreeAgainstRay(btNodeOverlapCallback*
 
 }
 
+void	btQuantizedBvh::walkStacklessQuantizedTreeAgainstRayPacket(btNodeOverlapPacketCallback* nodeCallback, const btRayPacket& packet, const btVector3& packetAabbMin, const btVector3& packetAabbMax, int startNodeIndex,int endNodeIndex) const
+{
+	btAssert(m_useQuantization);
+
+	int curIndex = startNodeIndex;
+	const btQuantizedBvhNode* rootNode = &m_quantizedContiguousNodes[startNodeIndex];
+
+	/* Quick pruning by the quantized box around all rays of the packet */
+	unsigned short int quantizedQueryAabbMin[3];
+	unsigned short int quantizedQueryAabbMax[3];
+	quantizeWithClamp(quantizedQueryAabbMin,packetAabbMin,0);
+	quantizeWithClamp(quantizedQueryAabbMax,packetAabbMax,1);
+
+	//rays still active in the current subtree, and where each enclosing subtree ends with the mask to restore there
+	unsigned int rayMask = packet.m_activeMask;
+	int subtreeEnd[128];
+	unsigned int subtreeMask[128];
+	int depth = 0;
+
+	while (curIndex < endNodeIndex)
+	{
+		while (depth > 0 && curIndex >= subtreeEnd[depth-1])
+		{
+			depth--;
+			rayMask = subtreeMask[depth];
+		}
+
+		unsigned int hitMask = 0;
+		bool isLeafNode = rootNode->isLeafNode();
+
+		if (testQuantizedAabbAgainstQuantizedAabb(quantizedQueryAabbMin,quantizedQueryAabbMax,rootNode->m_quantizedAabbMin,rootNode->m_quantizedAabbMax))
+		{
+			btVector3 boundsMin = unQuantize(rootNode->m_quantizedAabbMin);
+			btVector3 boundsMax = unQuantize(rootNode->m_quantizedAabbMax);
+
+			if (btRayPacket::isSingleRay(rayMask))
+			{
+				//diverged: the scalar test is cheaper than four lanes for one ray
+				hitMask = packet.testAabbSingle(btRayPacket::firstRay(rayMask),boundsMin,boundsMax) ? rayMask : 0;
+			}
+			else
+			{
+				hitMask = packet.testAabb(boundsMin,boundsMax,rayMask);
+			}
+		}
+
+		if (isLeafNode)
+		{
+			if (hitMask)
+			{
+				nodeCallback->processNode(rootNode->getPartId(),rootNode->getTriangleIndex(),hitMask);
+			}
+			rootNode++;
+			curIndex++;
+		}
+		else if (hitMask)
+		{
+			int escapeIndex = rootNode->getEscapeIndex();
+
+			if (depth < 128)
+			{
+				subtreeEnd[depth] = curIndex + escapeIndex;
+				subtreeMask[depth] = rayMask;
+				depth++;
+				rayMask = hitMask;
+			}
+			//deeper than that, the subtree keeps the parent's mask, which is conservative
+
+			rootNode++;
+			curIndex++;
+		}
+		else
+		{
+			int escapeIndex = rootNode->getEscapeIndex();
+			rootNode += escapeIndex;
+			curIndex += escapeIndex;
+		}
+	}
+}
+
 void	btQuantizedBvh::walkStacklessQuantizedTree(btNodeOverlapCallback* nodeCallback,unsigned short int* quantizedQueryAabbMin,unsigned short int* quantizedQueryAabbMax,int startNodeIndex,int endNodeIndex) const
 {
 	btAssert(m_useQuantization);
@@ -788,6 +869,52 @@ void	btQuantizedBvh::reportRayOverlappingNodex (btNodeOverlapCallback* nodeCallb
 }
 
 
+struct	btSingleRayOfPacketCallback : public btNodeOverlapCallback
+{
+	btNodeOverlapPacketCallback*	m_packetCallback;
+	unsigned int	m_rayMask;
+
+	virtual void processNode(int subPart, int triangleIndex)
+	{
+		m_packetCallback->processNode(subPart, triangleIndex, m_rayMask);
+	}
+};
+
+void	btQuantizedBvh::reportRayPacketOverlappingNodex(btNodeOverlapPacketCallback* nodeCallback, const btVector3* raySource, const btVector3* rayTarget, int numRays) const
+{
+	btAssert(numRays > 0 && numRays <= BT_RAY_PACKET_SIZE);
+
+	if (!m_useQuantization)
+	{
+		btSingleRayOfPacketCallback	singleRayCallback;
+		singleRayCallback.m_packetCallback = nodeCallback;
+
+		for (int i = 0; i < numRays; i++)
+		{
+			singleRayCallback.m_rayMask = 1u << i;
+			walkStacklessTreeAgainstRay(&singleRayCallback, raySource[i], rayTarget[i], btVector3(0,0,0), btVector3(0,0,0), 0, m_curNodeIndex);
+		}
+		return;
+	}
+
+	btRayPacket packet;
+	packet.init(raySource, rayTarget, numRays);
+
+	btVector3 packetAabbMin = raySource[0];
+	btVector3 packetAabbMax = raySource[0];
+
+	for (int i = 0; i < numRays; i++)
+	{
+		packetAabbMin.setMin(raySource[i]);
+		packetAabbMin.setMin(rayTarget[i]);
+		packetAabbMax.setMax(raySource[i]);
+		packetAabbMax.setMax(rayTarget[i]);
+	}
+
+	walkStacklessQuantizedTreeAgainstRayPacket(nodeCallback, packet, packetAabbMin, packetAabbMax, 0, m_curNodeIndex);
+}
+
+
 void	btQuantizedBvh::reportBoxCastOverlappingNodex(btNodeOverlapCallback* nodeCallback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin,const btVector3& aabbMax) const
 {
 	//always use stackless
@@ -166,6 +166,17 @@ public:
 	virtual void processNode(int subPart, int triangleIndex) = 0;
 };
 
+///btNodeOverlapPacketCallback receives the leaves reached by a ray packet, bit i of rayMask is set for every ray i that reaches it
+class btNodeOverlapPacketCallback
+{
+public:
+	virtual ~btNodeOverlapPacketCallback() {};
+
+	virtual void processNode(int subPart, int triangleIndex, unsigned int rayMask) = 0;
+};
+
+struct btRayPacket;
+
 #include "LinearMath/btAlignedAllocator.h"
 #include "LinearMath/btAlignedObjectArray.h"
 
@@ -323,6 +334,7 @@ protected:
 	void	walkStacklessQuantizedTreeAgainstRay(btNodeOverlapCallback* nodeCallback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin, const btVector3& aabbMax, int startNodeIndex,int endNodeIndex) const;
 	void	walkStacklessQuantizedTree(btNodeOverlapCallback* nodeCallback,unsigned short int* quantizedQueryAabbMin,unsigned short int* quantizedQueryAabbMax,int startNodeIndex,int endNodeIndex) const;
 	void	walkStacklessTreeAgainstRay(btNodeOverlapCallback* nodeCallback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin, const btVector3& aabbMax, int startNodeIndex,int endNodeIndex) const;
+	void	walkStacklessQuantizedTreeAgainstRayPacket(btNodeOverlapPacketCallback* nodeCallback, const btRayPacket& packet, const btVector3& packetAabbMin, const btVector3& packetAabbMax, int startNodeIndex,int endNodeIndex) const;
 
 	///tree traversal designed for small-memory processors like PS3 SPU
 	void	walkStacklessQuantizedTreeCacheFriendly(btNodeOverlapCallback* nodeCallback,unsigned short int* quantizedQueryAabbMin,unsigned short int* quantizedQueryAabbMax) const;
@@ -357,6 +369,9 @@ public:
 	void	reportAabbOverlappingNodex(btNodeOverlapCallback* nodeCallback,const btVector3& aabbMin,const btVector3& aabbMax) const;
 	void	reportRayOverlappingNodex (btNodeOverlapCallback* nodeCallback, const btVector3& raySource, const btVector3& rayTarget) const;
 	void	reportBoxCastOverlappingNodex(btNodeOverlapCallback* nodeCallback, const btVector3& raySource, const btVector3& rayTarget, const btVector3& aabbMin,const btVector3& aabbMax) const;
+	///reportRayPacketOverlappingNodex walks the tree once for up to BT_RAY_PACKET_SIZE coherent rays (see btRayPacket.h).
+	///It reports the same leaves as reportRayOverlappingNodex would for each ray. Trees without quantization are walked ray by ray.
+	void	reportRayPacketOverlappingNodex(btNodeOverlapPacketCallback* nodeCallback, const btVector3* raySource, const btVector3* rayTarget, int numRays) const;
 
 		SIMD_FORCE_INLINE void quantize(unsigned short* out, const btVector3& point,int isMax) const
 	{
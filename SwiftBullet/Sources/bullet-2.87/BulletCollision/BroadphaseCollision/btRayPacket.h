@@ -0,0 +1,196 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_RAY_PACKET_H
+#define BT_RAY_PACKET_H
+
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btAabbUtil2.h"
+
+#if !defined(BT_USE_DOUBLE_PRECISION) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define BT_RAY_PACKET_SSE 1
+#include <emmintrin.h>
+#elif !defined(BT_USE_DOUBLE_PRECISION) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define BT_RAY_PACKET_NEON 1
+#include <arm_neon.h>
+#endif
+
+#define BT_RAY_PACKET_SIZE 4
+
+///btRayPacket holds up to BT_RAY_PACKET_SIZE rays in SoA layout, so one node AABB is slab tested against all of them at once.
+///Each ray is set up exactly like btRayAabb2 expects it (normalized direction, BT_LARGE_FLOAT for zero components,
+///lambda_max is the ray length), so a packet visits the same nodes as its rays would one by one.
+ATTRIBUTE_ALIGNED16(struct) btRayPacket
+{
+	btScalar	m_fromX[BT_RAY_PACKET_SIZE];
+	btScalar	m_fromY[BT_RAY_PACKET_SIZE];
+	btScalar	m_fromZ[BT_RAY_PACKET_SIZE];
+	btScalar	m_invDirX[BT_RAY_PACKET_SIZE];
+	btScalar	m_invDirY[BT_RAY_PACKET_SIZE];
+	btScalar	m_invDirZ[BT_RAY_PACKET_SIZE];
+	btScalar	m_lambdaMax[BT_RAY_PACKET_SIZE];
+
+	//per ray copies for the scalar path, once a subtree is left with a single ray
+	btVector3	m_rayFrom[BT_RAY_PACKET_SIZE];
+	btVector3	m_rayDirectionInverse[BT_RAY_PACKET_SIZE];
+	unsigned int	m_signs[BT_RAY_PACKET_SIZE][3];
+
+	///bit i is set for every ray i of the packet
+	unsigned int	m_activeMask;
+
+	void	init(const btVector3* rayFrom, const btVector3* rayTo, int numRays)
+	{
+		btAssert(numRays > 0 && numRays <= BT_RAY_PACKET_SIZE);
+
+		m_activeMask = (1u << numRays) - 1;
+
+		for (int i = 0; i < BT_RAY_PACKET_SIZE; i++)
+		{
+			//unused lanes repeat the first ray, the active mask keeps them out of the results
+			int r = i < numRays ? i : 0;
+
+			btVector3 rayDir = rayTo[r] - rayFrom[r];
+			rayDir.normalize();
+
+			btVector3& inv = m_rayDirectionInverse[i];
+			inv[0] = rayDir[0] == btScalar(0.0) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0) / rayDir[0];
+			inv[1] = rayDir[1] == btScalar(0.0) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0) / rayDir[1];
+			inv[2] = rayDir[2] == btScalar(0.0) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0) / rayDir[2];
+
+			m_signs[i][0] = inv[0] < 0.0;
+			m_signs[i][1] = inv[1] < 0.0;
+			m_signs[i][2] = inv[2] < 0.0;
+
+			m_rayFrom[i] = rayFrom[r];
+
+			m_fromX[i] = rayFrom[r].getX();
+			m_fromY[i] = rayFrom[r].getY();
+			m_fromZ[i] = rayFrom[r].getZ();
+			m_invDirX[i] = inv.getX();
+			m_invDirY[i] = inv.getY();
+			m_invDirZ[i] = inv.getZ();
+			m_lambdaMax[i] = rayDir.dot(rayTo[r] - rayFrom[r]);
+		}
+	}
+
+	///returns the rays of rayMask that pass btRayAabb2 against the box
+	unsigned int	testAabb(const btVector3& aabbMin, const btVector3& aabbMax, unsigned int rayMask) const
+	{
+		//near/far per axis as min/max of both slabs is what btRayAabb2 selects with the signs,
+		//and enter <= exit covers all of its early outs
+#if defined(BT_RAY_PACKET_SSE)
+		__m128 fromX = _mm_loadu_ps(m_fromX);
+		__m128 fromY = _mm_loadu_ps(m_fromY);
+		__m128 fromZ = _mm_loadu_ps(m_fromZ);
+		__m128 invX = _mm_loadu_ps(m_invDirX);
+		__m128 invY = _mm_loadu_ps(m_invDirY);
+		__m128 invZ = _mm_loadu_ps(m_invDirZ);
+
+		__m128 t0x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMin.getX()), fromX), invX);
+		__m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMax.getX()), fromX), invX);
+		__m128 t0y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMin.getY()), fromY), invY);
+		__m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMax.getY()), fromY), invY);
+		__m128 t0z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMin.getZ()), fromZ), invZ);
+		__m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aabbMax.getZ()), fromZ), invZ);
+
+		__m128 enter = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)), _mm_min_ps(t0z, t1z));
+		__m128 exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)), _mm_max_ps(t0z, t1z));
+
+		__m128 hit = _mm_and_ps(_mm_cmple_ps(enter, exit),
+								_mm_and_ps(_mm_cmplt_ps(enter, _mm_loadu_ps(m_lambdaMax)), _mm_cmpgt_ps(exit, _mm_setzero_ps())));
+
+		return (unsigned int)_mm_movemask_ps(hit) & rayMask;
+#elif defined(BT_RAY_PACKET_NEON)
+		float32x4_t fromX = vld1q_f32(m_fromX);
+		float32x4_t fromY = vld1q_f32(m_fromY);
+		float32x4_t fromZ = vld1q_f32(m_fromZ);
+		float32x4_t invX = vld1q_f32(m_invDirX);
+		float32x4_t invY = vld1q_f32(m_invDirY);
+		float32x4_t invZ = vld1q_f32(m_invDirZ);
+
+		float32x4_t t0x = vmulq_f32(vsubq_f32(vdupq_n_f32(aabbMin.getX()), fromX), invX);
+		float32x4_t t1x = vmulq_f32(vsubq_f32(vdupq_n_f32(aabbMax.getX()), fromX), invX);
+		float32x4_t t0y = vmulq_f32(vsubq_f32(vdupq_n_f32(aabbMin.getY()), fromY), invY);
+		float32x4_t t1y = vmulq_f32(vsubq_f32(vdupq_n_f32(aabbMax.getY()), fromY), invY);
+		float32x4_t t0z = vmulq_f32(vsubq_f32(vdupq_n_f32(aabbMin.getZ()), fromZ), invZ);
+		float32x4_t t1z = vmulq_f32(vsubq_f32(vdupq_n_f32(aabbMax.getZ()), fromZ), invZ);
+
+		float32x4_t enter = vmaxq_f32(vmaxq_f32(vminq_f32(t0x, t1x), vminq_f32(t0y, t1y)), vminq_f32(t0z, t1z));
+		float32x4_t exit = vminq_f32(vminq_f32(vmaxq_f32(t0x, t1x), vmaxq_f32(t0y, t1y)), vmaxq_f32(t0z, t1z));
+
+		uint32x4_t hit = vandq_u32(vcleq_f32(enter, exit),
+								   vandq_u32(vcltq_f32(enter, vld1q_f32(m_lambdaMax)), vcgtq_f32(exit, vdupq_n_f32(0.f))));
+
+		static const uint32_t laneBits[4] = { 1, 2, 4, 8 };
+		uint32x4_t bits = vandq_u32(hit, vld1q_u32(laneBits));
+		uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+
+		return (vget_lane_u32(sum, 0) | vget_lane_u32(sum, 1)) & rayMask;
+#else
+		unsigned int result = 0;
+
+		for (int i = 0; i < BT_RAY_PACKET_SIZE; i++)
+		{
+			if ((rayMask & (1u << i)) && testAabbSingle(i, aabbMin, aabbMax))
+			{
+				result |= 1u << i;
+			}
+		}
+
+		return result;
+#endif
+	}
+
+	///btRayAabb2 for one ray of the packet
+	bool	testAabbSingle(int ray, const btVector3& aabbMin, const btVector3& aabbMax) const
+	{
+		btVector3 bounds[2] = { aabbMin, aabbMax };
+		btScalar tmin = 1.f;
+
+		return btRayAabb2(m_rayFrom[ray], m_rayDirectionInverse[ray], m_signs[ray], bounds, tmin, 0.f, m_lambdaMax[ray]);
+	}
+
+	///index of the lowest ray in rayMask
+	static int	firstRay(unsigned int rayMask)
+	{
+		int ray = 0;
+		while (!(rayMask & (1u << ray)))
+		{
+			ray++;
+		}
+		return ray;
+	}
+
+	static bool	isSingleRay(unsigned int rayMask)
+	{
+		return (rayMask & (rayMask - 1)) == 0;
+	}
+};
+
+#endif //BT_RAY_PACKET_H
+
+#pragma clang diagnostic pop
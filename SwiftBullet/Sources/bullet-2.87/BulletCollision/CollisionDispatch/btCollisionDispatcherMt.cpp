@@ -26,6 +26,7 @@ subject to the following restrictions:
 
 #include "btCollisionDispatcherMt.h"
 #include "LinearMath/btQuickprof.h"
+#include "LinearMath/btMemoryTracker.h"
 
 #include "BulletCollision/BroadphaseCollision/btCollisionAlgorithm.h"
 
@@ -125,6 +126,7 @@ struct CollisionDispatcherUpdater : public btIParallelForBody
     }
     void forLoop( int iBegin, int iEnd ) const
     {
+        BT_MEMORY_TAG( BT_MEMORY_NARROWPHASE );
         for ( int i = iBegin; i < iEnd; ++i )
         {
             btBroadphasePair* pair = &mPairArray[ i ];
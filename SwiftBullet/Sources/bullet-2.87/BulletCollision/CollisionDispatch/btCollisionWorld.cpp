@@ -32,6 +32,8 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h" //for raycasting
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletCollision/CollisionShapes/btCompoundShape.h"
+#include "BulletCollision/CollisionShapes/btStaticBrushSetShape.h" //for raycasting
+#include "BulletCollision/CollisionShapes/btBrushShape.h" //for raycasting
 #include "BulletCollision/NarrowPhaseCollision/btSubSimplexConvexCast.h"
 #include "BulletCollision/NarrowPhaseCollision/btGjkConvexCast.h"
 #include "BulletCollision/NarrowPhaseCollision/btContinuousConvexCollision.h"
@@ -40,7 +42,9 @@ subject to the following restrictions:
 #include "BulletCollision/BroadphaseCollision/btDbvt.h"
 #include "LinearMath/btAabbUtil2.h"
 #include "LinearMath/btQuickprof.h"
+#include "LinearMath/btMemoryTracker.h"
 #include "LinearMath/btSerializer.h"
+#include "LinearMath/btThreads.h"
 #include "BulletCollision/CollisionShapes/btConvexPolyhedron.h"
 #include "BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h"
 
@@ -154,6 +158,51 @@ void	btCollisionWorld::addCollisionObject(btCollisionObject* collisionObject, in
 
 
 
+void	btCollisionWorld::addStaticCollisionObjects(btCollisionObject** collisionObjects, int numObjects, int collisionFilterGroup, int collisionFilterMask)
+{
+	BT_PROFILE("addStaticCollisionObjects");
+
+	if (numObjects <= 0)
+	{
+		return;
+	}
+
+	btAlignedObjectArray<btVector3> minAabbs;
+	btAlignedObjectArray<btVector3> maxAabbs;
+	btAlignedObjectArray<int> types;
+	btAlignedObjectArray<void*> userPtrs;
+	btAlignedObjectArray<btBroadphaseProxy*> proxies;
+	minAabbs.resize(numObjects);
+	maxAabbs.resize(numObjects);
+	types.resize(numObjects);
+	userPtrs.resize(numObjects);
+	proxies.resize(numObjects);
+
+	m_collisionObjects.reserve(m_collisionObjects.size() + numObjects);
+
+	for (int i = 0; i < numObjects; i++)
+	{
+		btCollisionObject* collisionObject = collisionObjects[i];
+
+		btAssert(collisionObject);
+		btAssert(collisionObject->getWorldArrayIndex() == -1);  // do not add the same object to more than one collision world
+
+		collisionObject->setWorldArrayIndex(m_collisionObjects.size());
+		m_collisionObjects.push_back(collisionObject);
+
+		collisionObject->getCollisionShape()->getAabb(collisionObject->getWorldTransform(), minAabbs[i], maxAabbs[i]);
+		types[i] = collisionObject->getCollisionShape()->getShapeType();
+		userPtrs[i] = collisionObject;
+	}
+
+	getBroadphase()->createStaticProxies(numObjects, &minAabbs[0], &maxAabbs[0], &types[0], &userPtrs[0], collisionFilterGroup, collisionFilterMask, m_dispatcher1, &proxies[0]);
+
+	for (int i = 0; i < numObjects; i++)
+	{
+		collisionObjects[i]->setBroadphaseHandle(proxies[i]);
+	}
+}
+
 void	btCollisionWorld::updateSingleAabb(btCollisionObject* colObj)
 {
 	btVector3 minAabb,maxAabb;
@@ -200,6 +249,7 @@ void	btCollisionWorld::updateSingleAabb(btCollisionObject* colObj)
 void	btCollisionWorld::updateAabbs()
 {
 	BT_PROFILE("updateAabbs");
+	BT_MEMORY_TAG(BT_MEMORY_BROADPHASE);
 
 	btTransform predictedTrans;
 	for ( int i=0;i<m_collisionObjects.size();i++)
@@ -219,6 +269,7 @@ void	btCollisionWorld::updateAabbs()
 void	btCollisionWorld::computeOverlappingPairs()
 {
 	BT_PROFILE("calculateOverlappingPairs");
+	BT_MEMORY_TAG(BT_MEMORY_BROADPHASE);
 	m_broadphasePairCache->calculateOverlappingPairs(m_dispatcher1);
 }
 
@@ -235,6 +286,7 @@ void	btCollisionWorld::performDiscreteCollisionDetection()
 	btDispatcher* dispatcher = getDispatcher();
 	{
 		BT_PROFILE("dispatchAllCollisionPairs");
+		BT_MEMORY_TAG(BT_MEMORY_NARROWPHASE);
 		if (dispatcher)
 			dispatcher->dispatchAllCollisionPairs(m_broadphasePairCache->getOverlappingPairCache(),dispatchInfo,m_dispatcher1);
 	}
@@ -306,7 +358,33 @@ void	btCollisionWorld::rayTestSingleInternal(const btTransform& rayFromTrans,con
 	const btCollisionShape* collisionShape = collisionObjectWrap->getCollisionShape();
 	const btTransform& colObjWorldTransform = collisionObjectWrap->getWorldTransform();
 
-	if (collisionShape->isConvex())
+	if (collisionShape->getShapeType()==BRUSH_SHAPE_PROXYTYPE)
+	{
+		///brushes are clipped against their planes, no convex cast needed
+		const btBrushShape* brushShape = (const btBrushShape*)collisionShape;
+
+		btTransform worldTocollisionObject = colObjWorldTransform.inverse();
+		btVector3 rayFromLocal = worldTocollisionObject * rayFromTrans.getOrigin();
+		btVector3 rayToLocal = worldTocollisionObject * rayToTrans.getOrigin();
+
+		btScalar hitFraction;
+		btVector3 hitNormalLocal;
+
+		if (brushShape->rayTest(rayFromLocal, rayToLocal, hitFraction, hitNormalLocal) &&
+			hitFraction < resultCallback.m_closestHitFraction)
+		{
+			btCollisionWorld::LocalRayResult localRayResult
+				(
+				collisionObjectWrap->getCollisionObject(),
+				0,
+				colObjWorldTransform.getBasis() * hitNormalLocal,
+				hitFraction
+				);
+
+			bool normalInWorldSpace = true;
+			resultCallback.addSingleResult(localRayResult, normalInWorldSpace);
+		}
+	} else if (collisionShape->isConvex())
 	{
 		//		BT_PROFILE("rayTestConvex");
 		btConvexCast::CastResult castResult;
@@ -407,7 +485,74 @@ void	btCollisionWorld::rayTestSingleInternal(const btTransform& rayFromTrans,con
 			btVector3 rayToLocal = worldTocollisionObject * rayToTrans.getOrigin();
 
 			//			BT_PROFILE("rayTestConcave");
-			if (collisionShape->getShapeType()==TRIANGLE_MESH_SHAPE_PROXYTYPE)
+			if (collisionShape->getShapeType()==STATIC_BRUSH_SET_SHAPE_PROXYTYPE)
+			{
+				///the brushes along the ray are tested as convex shapes
+				struct BrushInfoAdder : public RayResultCallback
+				{
+					RayResultCallback* m_userCallback;
+					int m_i;
+
+					BrushInfoAdder (int i, RayResultCallback *user)
+						: m_userCallback(user), m_i(i)
+					{
+						m_closestHitFraction = m_userCallback->m_closestHitFraction;
+						m_flags = m_userCallback->m_flags;
+					}
+					virtual bool needsCollision(btBroadphaseProxy* p) const
+					{
+						return m_userCallback->needsCollision(p);
+					}
+
+					virtual btScalar addSingleResult (btCollisionWorld::LocalRayResult &r, bool b)
+					{
+						btCollisionWorld::LocalShapeInfo shapeInfo;
+						shapeInfo.m_shapePart = -1;
+						shapeInfo.m_triangleIndex = m_i;
+						if (r.m_localShapeInfo == NULL)
+							r.m_localShapeInfo = &shapeInfo;
+
+						const btScalar result = m_userCallback->addSingleResult(r, b);
+						m_closestHitFraction = m_userCallback->m_closestHitFraction;
+						return result;
+					}
+				};
+
+				struct BrushRayTester : public btStaticBrushCallback
+				{
+					const btCollisionObjectWrapper* m_colObjWrap;
+					const btStaticBrushSetShape* m_brushSet;
+					const btTransform& m_rayFromTrans;
+					const btTransform& m_rayToTrans;
+					RayResultCallback& m_resultCallback;
+
+					BrushRayTester(const btCollisionObjectWrapper* colObjWrap,
+							const btStaticBrushSetShape* brushSet,
+							const btTransform& rayFromTrans,
+							const btTransform& rayToTrans,
+							RayResultCallback& resultCallback):
+						m_colObjWrap(colObjWrap),
+						m_brushSet(brushSet),
+						m_rayFromTrans(rayFromTrans),
+						m_rayToTrans(rayToTrans),
+						m_resultCallback(resultCallback)
+					{
+					}
+
+					virtual void processBrush(int brushIndex)
+					{
+						btCollisionObjectWrapper tmpOb(m_colObjWrap,m_brushSet->getBrush(brushIndex),m_colObjWrap->getCollisionObject(),m_colObjWrap->getWorldTransform(),-1,brushIndex);
+						BrushInfoAdder my_cb(brushIndex, &m_resultCallback);
+
+						rayTestSingleInternal(m_rayFromTrans, m_rayToTrans, &tmpOb, my_cb);
+					}
+				};
+
+				const btStaticBrushSetShape* brushSet = static_cast<const btStaticBrushSetShape*>(collisionShape);
+				BrushRayTester rayCB(collisionObjectWrap, brushSet, rayFromTrans, rayToTrans, resultCallback);
+				brushSet->performRaycast(&rayCB, rayFromLocal, rayToLocal);
+			}
+			else if (collisionShape->getShapeType()==TRIANGLE_MESH_SHAPE_PROXYTYPE)
 			{
 				///optimized version for btBvhTriangleMeshShape
 				btBvhTriangleMeshShape* triangleMesh = (btBvhTriangleMeshShape*)collisionShape;
@@ -658,7 +803,86 @@ void	btCollisionWorld::objectQuerySingleInternal(const btConvexShape* castShape,
 	} else {
 		if (collisionShape->isConcave())
 		{
-			if (collisionShape->getShapeType()==TRIANGLE_MESH_SHAPE_PROXYTYPE)
+			if (collisionShape->getShapeType()==STATIC_BRUSH_SET_SHAPE_PROXYTYPE)
+			{
+				//BT_PROFILE("convexSweepBrushSet");
+				///the brushes along the sweep are tested as convex shapes
+				struct BrushInfoAdder : public ConvexResultCallback
+				{
+					ConvexResultCallback* m_userCallback;
+					int m_i;
+
+					BrushInfoAdder(int i, ConvexResultCallback *user)
+						: m_userCallback(user), m_i(i)
+					{
+						m_closestHitFraction = m_userCallback->m_closestHitFraction;
+					}
+					virtual bool needsCollision(btBroadphaseProxy* p) const
+					{
+						return m_userCallback->needsCollision(p);
+					}
+					virtual btScalar addSingleResult(btCollisionWorld::LocalConvexResult&	r, bool b)
+					{
+						btCollisionWorld::LocalShapeInfo	shapeInfo;
+						shapeInfo.m_shapePart = -1;
+						shapeInfo.m_triangleIndex = m_i;
+						if (r.m_localShapeInfo == NULL)
+							r.m_localShapeInfo = &shapeInfo;
+						const btScalar result = m_userCallback->addSingleResult(r, b);
+						m_closestHitFraction = m_userCallback->m_closestHitFraction;
+						return result;
+					}
+				};
+
+				struct BrushSweepTester : public btStaticBrushCallback
+				{
+					const btCollisionObjectWrapper* m_colObjWrap;
+					const btStaticBrushSetShape* m_brushSet;
+					const btConvexShape* m_castShape;
+					const btTransform& m_convexFromTrans;
+					const btTransform& m_convexToTrans;
+					btScalar m_allowedPenetration;
+					ConvexResultCallback& m_resultCallback;
+
+					BrushSweepTester(const btCollisionObjectWrapper* colObjWrap,
+							const btStaticBrushSetShape* brushSet,
+							const btConvexShape* castShape,
+							const btTransform& convexFromTrans,
+							const btTransform& convexToTrans,
+							btScalar allowedPenetration,
+							ConvexResultCallback& resultCallback):
+						m_colObjWrap(colObjWrap),
+						m_brushSet(brushSet),
+						m_castShape(castShape),
+						m_convexFromTrans(convexFromTrans),
+						m_convexToTrans(convexToTrans),
+						m_allowedPenetration(allowedPenetration),
+						m_resultCallback(resultCallback)
+					{
+					}
+
+					virtual void processBrush(int brushIndex)
+					{
+						btCollisionObjectWrapper tmpObj(m_colObjWrap, m_brushSet->getBrush(brushIndex), m_colObjWrap->getCollisionObject(), m_colObjWrap->getWorldTransform(), -1, brushIndex);
+						BrushInfoAdder my_cb(brushIndex, &m_resultCallback);
+
+						objectQuerySingleInternal(m_castShape, m_convexFromTrans, m_convexToTrans, &tmpObj, my_cb, m_allowedPenetration);
+					}
+				};
+
+				const btStaticBrushSetShape* brushSet = static_cast<const btStaticBrushSetShape*>(collisionShape);
+				btTransform worldTocollisionObject = colObjWorldTransform.inverse();
+				btVector3 convexFromLocal = worldTocollisionObject * convexFromTrans.getOrigin();
+				btVector3 convexToLocal = worldTocollisionObject * convexToTrans.getOrigin();
+				btTransform rotationXform = btTransform(worldTocollisionObject.getBasis() * convexToTrans.getBasis());
+
+				btVector3 boxMinLocal, boxMaxLocal;
+				castShape->getAabb(rotationXform, boxMinLocal, boxMaxLocal);
+
+				BrushSweepTester callback(colObjWrap, brushSet, castShape, convexFromTrans, convexToTrans, allowedPenetration, resultCallback);
+				brushSet->performConvexcast(&callback, convexFromLocal, convexToLocal, boxMinLocal, boxMaxLocal);
+			}
+			else if (collisionShape->getShapeType()==TRIANGLE_MESH_SHAPE_PROXYTYPE)
 			{
 				//BT_PROFILE("convexSweepbtBvhTriangleMesh");
 				btBvhTriangleMeshShape* triangleMesh = (btBvhTriangleMeshShape*)collisionShape;
@@ -1017,6 +1241,7 @@ struct btSingleRayCallback : public btBroadphaseRayCallback
 void	btCollisionWorld::rayTest(const btVector3& rayFromWorld, const btVector3& rayToWorld, RayResultCallback& resultCallback) const
 {
 	//BT_PROFILE("rayTest");
+	BT_MEMORY_TAG(BT_MEMORY_QUERIES);
 	/// use the broadphase to accelerate the search for objects, based on their aabb
 	/// and for each object with ray-aabb overlap, perform an exact ray test
 	btSingleRayCallback rayCB(rayFromWorld,rayToWorld,this,resultCallback);
@@ -1096,6 +1321,7 @@ void	btCollisionWorld::convexSweepTest(const btConvexShape* castShape, const btT
 {
 
 	BT_PROFILE("convexSweepTest");
+	BT_MEMORY_TAG(BT_MEMORY_QUERIES);
 	/// use the broadphase to accelerate the search for objects, based on their aabb
 	/// and for each object with ray-aabb overlap, perform an exact ray test
 	/// unfortunately the implementation for rayTest and convexSweepTest duplicated, albeit practically identical
@@ -1153,6 +1379,244 @@ void	btCollisionWorld::convexSweepTest(const btConvexShape* castShape, const btT
 #endif //USE_BRUTEFORCE_RAYBROADPHASE
 }
 
+void	btCollisionWorld::BatchedQueryResults::resize(int numQueries)
+{
+	m_hitFraction.resize(numQueries);
+	m_hitPointWorld.resize(numQueries);
+	m_hitNormalWorld.resize(numQueries);
+	m_hitCollisionObject.resize(numQueries);
+	m_shapePart.resize(numQueries);
+	m_triangleIndex.resize(numQueries);
+	m_order.resize(numQueries);
+}
+
+struct btBatchedOrderLess
+{
+	bool operator() (unsigned long long a, unsigned long long b) const
+	{
+		return a < b;
+	}
+};
+
+static unsigned int btSpreadBits10(unsigned int v)
+{
+	v &= 0x3ff;
+	v = (v | (v << 16)) & 0x030000ff;
+	v = (v | (v << 8)) & 0x0300f00f;
+	v = (v | (v << 4)) & 0x030c30c3;
+	v = (v | (v << 2)) & 0x09249249;
+	return v;
+}
+
+///sorts queries by direction octant, then by the morton code of their origin, so neighbouring queries visit the same nodes.
+///the keys hold the octant in the top 3 bits, the 30 bit morton code below and the query index in the low 31 bits
+static void btSortBatchedQueries(const btVector3* origins, int originStride, const btVector3* targets, int targetStride, int numQueries, btAlignedObjectArray<unsigned long long>& order)
+{
+	#define BT_BATCH_ORIGIN(i) (*(const btVector3*)((const char*)origins + (i) * originStride))
+	#define BT_BATCH_TARGET(i) (*(const btVector3*)((const char*)targets + (i) * targetStride))
+
+	btVector3 boundsMin(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+	btVector3 boundsMax(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+
+	for (int i = 0; i < numQueries; i++)
+	{
+		boundsMin.setMin(BT_BATCH_ORIGIN(i));
+		boundsMax.setMax(BT_BATCH_ORIGIN(i));
+	}
+
+	btVector3 extent = boundsMax - boundsMin;
+	btVector3 scale(extent.x() > SIMD_EPSILON ? btScalar(1023.) / extent.x() : btScalar(0.),
+					extent.y() > SIMD_EPSILON ? btScalar(1023.) / extent.y() : btScalar(0.),
+					extent.z() > SIMD_EPSILON ? btScalar(1023.) / extent.z() : btScalar(0.));
+
+	for (int i = 0; i < numQueries; i++)
+	{
+		btVector3 cell = (BT_BATCH_ORIGIN(i) - boundsMin) * scale;
+		btVector3 dir = BT_BATCH_TARGET(i) - BT_BATCH_ORIGIN(i);
+
+		unsigned int octant = (dir.x() < 0 ? 1 : 0) | (dir.y() < 0 ? 2 : 0) | (dir.z() < 0 ? 4 : 0);
+		unsigned int morton = btSpreadBits10((unsigned int)cell.x()) | (btSpreadBits10((unsigned int)cell.y()) << 1) | (btSpreadBits10((unsigned int)cell.z()) << 2);
+
+		unsigned long long key = ((unsigned long long)octant << 30) | morton;
+		order[i] = (key << 31) | (unsigned int)i;
+	}
+
+	#undef BT_BATCH_ORIGIN
+	#undef BT_BATCH_TARGET
+
+	order.quickSort(btBatchedOrderLess());
+}
+
+struct btBatchedClosestRayCallback : public btCollisionWorld::ClosestRayResultCallback
+{
+	int	m_shapePart;
+	int	m_triangleIndex;
+
+	btBatchedClosestRayCallback(const btVector3& rayFromWorld, const btVector3& rayToWorld)
+		:ClosestRayResultCallback(rayFromWorld, rayToWorld),
+		m_shapePart(-1),
+		m_triangleIndex(-1)
+	{
+	}
+
+	virtual	btScalar	addSingleResult(btCollisionWorld::LocalRayResult& rayResult,bool normalInWorldSpace)
+	{
+		btScalar result = ClosestRayResultCallback::addSingleResult(rayResult, normalInWorldSpace);
+		// a closer hit without shape info must not keep the part of the one it replaced
+		m_shapePart = rayResult.m_localShapeInfo ? rayResult.m_localShapeInfo->m_shapePart : -1;
+		m_triangleIndex = rayResult.m_localShapeInfo ? rayResult.m_localShapeInfo->m_triangleIndex : -1;
+		return result;
+	}
+};
+
+struct btBatchedClosestConvexCallback : public btCollisionWorld::ClosestConvexResultCallback
+{
+	int	m_shapePart;
+	int	m_triangleIndex;
+
+	btBatchedClosestConvexCallback(const btVector3& convexFromWorld, const btVector3& convexToWorld)
+		:ClosestConvexResultCallback(convexFromWorld, convexToWorld),
+		m_shapePart(-1),
+		m_triangleIndex(-1)
+	{
+	}
+
+	virtual	btScalar	addSingleResult(btCollisionWorld::LocalConvexResult& convexResult,bool normalInWorldSpace)
+	{
+		btScalar result = ClosestConvexResultCallback::addSingleResult(convexResult, normalInWorldSpace);
+		// a closer hit without shape info must not keep the part of the one it replaced
+		m_shapePart = convexResult.m_localShapeInfo ? convexResult.m_localShapeInfo->m_shapePart : -1;
+		m_triangleIndex = convexResult.m_localShapeInfo ? convexResult.m_localShapeInfo->m_triangleIndex : -1;
+		return result;
+	}
+};
+
+struct btRayTestBatchLoop : public btIParallelForBody
+{
+	const btCollisionWorld*	m_world;
+	const btVector3*	m_rayFromWorld;
+	const btVector3*	m_rayToWorld;
+	const int*	m_filterGroups;
+	const int*	m_filterMasks;
+	btCollisionWorld::BatchedQueryResults*	m_results;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		btCollisionWorld::BatchedQueryResults& results = *m_results;
+
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			int q = int(results.m_order[i] & 0x7fffffffull);
+
+			btBatchedClosestRayCallback callback(m_rayFromWorld[q], m_rayToWorld[q]);
+			if (m_filterGroups)
+				callback.m_collisionFilterGroup = m_filterGroups[q];
+			if (m_filterMasks)
+				callback.m_collisionFilterMask = m_filterMasks[q];
+
+			m_world->rayTest(m_rayFromWorld[q], m_rayToWorld[q], callback);
+
+			results.m_hitFraction[q] = callback.m_closestHitFraction;
+			results.m_hitPointWorld[q] = callback.hasHit() ? callback.m_hitPointWorld : m_rayToWorld[q];
+			results.m_hitNormalWorld[q] = callback.hasHit() ? callback.m_hitNormalWorld : btVector3(0, 0, 0);
+			results.m_hitCollisionObject[q] = callback.m_collisionObject;
+			results.m_shapePart[q] = callback.m_shapePart;
+			results.m_triangleIndex[q] = callback.m_triangleIndex;
+		}
+	}
+};
+
+struct btConvexSweepTestBatchLoop : public btIParallelForBody
+{
+	const btCollisionWorld*	m_world;
+	const btConvexShape*	m_castShape;
+	const btTransform*	m_convexFromWorld;
+	const btTransform*	m_convexToWorld;
+	const int*	m_filterGroups;
+	const int*	m_filterMasks;
+	btScalar	m_allowedCcdPenetration;
+	btCollisionWorld::BatchedQueryResults*	m_results;
+
+	void forLoop(int iBegin, int iEnd) const BT_OVERRIDE
+	{
+		btCollisionWorld::BatchedQueryResults& results = *m_results;
+
+		for (int i = iBegin; i < iEnd; i++)
+		{
+			int q = int(results.m_order[i] & 0x7fffffffull);
+
+			const btVector3& from = m_convexFromWorld[q].getOrigin();
+			const btVector3& to = m_convexToWorld[q].getOrigin();
+
+			btBatchedClosestConvexCallback callback(from, to);
+			if (m_filterGroups)
+				callback.m_collisionFilterGroup = m_filterGroups[q];
+			if (m_filterMasks)
+				callback.m_collisionFilterMask = m_filterMasks[q];
+
+			m_world->convexSweepTest(m_castShape, m_convexFromWorld[q], m_convexToWorld[q], callback, m_allowedCcdPenetration);
+
+			results.m_hitFraction[q] = callback.m_closestHitFraction;
+			results.m_hitPointWorld[q] = callback.hasHit() ? callback.m_hitPointWorld : to;
+			results.m_hitNormalWorld[q] = callback.hasHit() ? callback.m_hitNormalWorld : btVector3(0, 0, 0);
+			results.m_hitCollisionObject[q] = callback.m_hitCollisionObject;
+			results.m_shapePart[q] = callback.m_shapePart;
+			results.m_triangleIndex[q] = callback.m_triangleIndex;
+		}
+	}
+};
+
+void	btCollisionWorld::rayTestBatch(const btVector3* rayFromWorld, const btVector3* rayToWorld, const int* filterGroups, const int* filterMasks, int numRays, BatchedQueryResults& results) const
+{
+	BT_PROFILE("rayTestBatch");
+	BT_MEMORY_TAG(BT_MEMORY_QUERIES);
+
+	results.resize(numRays);
+	if (numRays == 0)
+	{
+		return;
+	}
+
+	btSortBatchedQueries(rayFromWorld, sizeof(btVector3), rayToWorld, sizeof(btVector3), numRays, results.m_order);
+
+	btRayTestBatchLoop loop;
+	loop.m_world = this;
+	loop.m_rayFromWorld = rayFromWorld;
+	loop.m_rayToWorld = rayToWorld;
+	loop.m_filterGroups = filterGroups;
+	loop.m_filterMasks = filterMasks;
+	loop.m_results = &results;
+
+	// a ray costs a few microseconds, smaller grains spend more on scheduling than on rays
+	btParallelFor(0, numRays, 64, loop);
+}
+
+void	btCollisionWorld::convexSweepTestBatch(const btConvexShape* castShape, const btTransform* convexFromWorld, const btTransform* convexToWorld, const int* filterGroups, const int* filterMasks, int numSweeps, BatchedQueryResults& results, btScalar allowedCcdPenetration) const
+{
+	BT_PROFILE("convexSweepTestBatch");
+	BT_MEMORY_TAG(BT_MEMORY_QUERIES);
+
+	results.resize(numSweeps);
+	if (numSweeps == 0)
+	{
+		return;
+	}
+
+	btSortBatchedQueries(&convexFromWorld[0].getOrigin(), sizeof(btTransform), &convexToWorld[0].getOrigin(), sizeof(btTransform), numSweeps, results.m_order);
+
+	btConvexSweepTestBatchLoop loop;
+	loop.m_world = this;
+	loop.m_castShape = castShape;
+	loop.m_convexFromWorld = convexFromWorld;
+	loop.m_convexToWorld = convexToWorld;
+	loop.m_filterGroups = filterGroups;
+	loop.m_filterMasks = filterMasks;
+	loop.m_allowedCcdPenetration = allowedCcdPenetration;
+	loop.m_results = &results;
+
+	btParallelFor(0, numSweeps, 16, loop);
+}
+
 
 
 struct btBridgedManifoldResult : public btManifoldResult
@@ -1260,6 +1724,10 @@ struct btSingleContactCallback : public btBroadphaseAabbCallback
 ///it reports one or more contact points for every overlapping object (including the one with deepest penetration)
 void	btCollisionWorld::contactTest( btCollisionObject* colObj, ContactResultCallback& resultCallback)
 {
+	//the compound algorithms and pair caches made for every overlapping object are freed before returning
+	BT_MEMORY_TAG(BT_MEMORY_QUERIES);
+	BT_MEMORY_TRANSIENT();
+
 	btVector3 aabbMin,aabbMax;
 	colObj->getCollisionShape()->getAabb(colObj->getWorldTransform(),aabbMin,aabbMax);
 	btSingleContactCallback	contactCB(colObj,this,resultCallback);
@@ -1272,6 +1740,9 @@ void	btCollisionWorld::contactTest( btCollisionObject* colObj, ContactResultCall
 ///it reports one or more contact points (including the one with deepest penetration)
 void	btCollisionWorld::contactPairTest(btCollisionObject* colObjA, btCollisionObject* colObjB, ContactResultCallback& resultCallback)
 {
+	BT_MEMORY_TAG(BT_MEMORY_QUERIES);
+	BT_MEMORY_TRANSIENT();
+
 	btCollisionObjectWrapper obA(0,colObjA->getCollisionShape(),colObjA,colObjA->getWorldTransform(),-1,-1);
 	btCollisionObjectWrapper obB(0,colObjB->getCollisionShape(),colObjB,colObjB->getWorldTransform(),-1,-1);
 
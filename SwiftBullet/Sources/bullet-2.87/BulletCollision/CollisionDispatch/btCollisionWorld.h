@@ -252,13 +252,16 @@ public:
 	{
 		ClosestRayResultCallback(const btVector3&	rayFromWorld,const btVector3&	rayToWorld)
 		:m_rayFromWorld(rayFromWorld),
-		m_rayToWorld(rayToWorld)
+		m_rayToWorld(rayToWorld),
+		m_hitNormalWorld(btScalar(0.),btScalar(0.),btScalar(0.)),
+		m_hitPointWorld(rayToWorld)
 		{
 		}
 
 		btVector3	m_rayFromWorld;//used to calculate hitPointWorld from hitFraction
 		btVector3	m_rayToWorld;
 
+		///zero normal and the ray end until there is a hit
 		btVector3	m_hitNormalWorld;
 		btVector3	m_hitPointWorld;
 			
@@ -385,6 +388,8 @@ public:
 		ClosestConvexResultCallback(const btVector3&	convexFromWorld,const btVector3&	convexToWorld)
 		:m_convexFromWorld(convexFromWorld),
 		m_convexToWorld(convexToWorld),
+		m_hitNormalWorld(btScalar(0.),btScalar(0.),btScalar(0.)),
+		m_hitPointWorld(convexToWorld),
 		m_hitCollisionObject(0)
 		{
 		}
@@ -392,6 +397,7 @@ public:
 		btVector3	m_convexFromWorld;//used to calculate hitPointWorld from hitFraction
 		btVector3	m_convexToWorld;
 
+		///zero normal and the cast end until there is a hit
 		btVector3	m_hitNormalWorld;
 		btVector3	m_hitPointWorld;
 		const btCollisionObject*	m_hitCollisionObject;
@@ -444,6 +450,33 @@ public:
 		virtual	btScalar	addSingleResult(btManifoldPoint& cp,	const btCollisionObjectWrapper* colObj0Wrap,int partId0,int index0,const btCollisionObjectWrapper* colObj1Wrap,int partId1,int index1) = 0;
 	};
 
+	///BatchedQueryResults holds the closest hit of every query of rayTestBatch or convexSweepTestBatch, in query order.
+	///Keep one around between frames: the arrays only grow, so repeated batches of similar size don't allocate.
+	struct	BatchedQueryResults
+	{
+		btAlignedObjectArray<btScalar>	m_hitFraction; //1 when nothing was hit
+		btAlignedObjectArray<btVector3>	m_hitPointWorld;
+		btAlignedObjectArray<btVector3>	m_hitNormalWorld;
+		btAlignedObjectArray<const btCollisionObject*>	m_hitCollisionObject; //0 when nothing was hit
+		btAlignedObjectArray<int>	m_shapePart;
+		btAlignedObjectArray<int>	m_triangleIndex;
+
+		//sort key in the high bits, query index in the low 31 bits
+		btAlignedObjectArray<unsigned long long>	m_order;
+
+		int	size() const
+		{
+			return m_hitFraction.size();
+		}
+
+		bool	hasHit(int i) const
+		{
+			return m_hitCollisionObject[i] != 0;
+		}
+
+		void	resize(int numQueries);
+	};
+
 
 
 	int	getNumCollisionObjects() const
@@ -459,6 +492,14 @@ public:
 	/// This allows for several queries: first hit, all hits, any hit, dependent on the value return by the callback.
 	void    convexSweepTest (const btConvexShape* castShape, const btTransform& from, const btTransform& to, ConvexResultCallback& resultCallback,  btScalar allowedCcdPenetration = btScalar(0.)) const;
 
+	///rayTestBatch finds the closest hit of many rays at once. Rays are sorted by direction octant and origin for coherent
+	///traversal and split across the task scheduler (btParallelFor). filterGroups and filterMasks may be 0 for the defaults.
+	///The world must not be stepped or changed while the batch runs.
+	void	rayTestBatch(const btVector3* rayFromWorld, const btVector3* rayToWorld, const int* filterGroups, const int* filterMasks, int numRays, BatchedQueryResults& results) const;
+
+	///convexSweepTestBatch is rayTestBatch for swept convex shapes, all sweeps use the same castShape
+	void	convexSweepTestBatch(const btConvexShape* castShape, const btTransform* convexFromWorld, const btTransform* convexToWorld, const int* filterGroups, const int* filterMasks, int numSweeps, BatchedQueryResults& results, btScalar allowedCcdPenetration = btScalar(0.)) const;
+
 	///contactTest performs a discrete collision test between colObj against all objects in the btCollisionWorld, and calls the resultCallback.
 	///it reports one or more contact points for every overlapping object (including the one with deepest penetration)
 	void	contactTest(btCollisionObject* colObj, ContactResultCallback& resultCallback);
@@ -494,6 +535,10 @@ public:
 
 	virtual void	addCollisionObject(btCollisionObject* collisionObject, int collisionFilterGroup=btBroadphaseProxy::DefaultFilter, int collisionFilterMask=btBroadphaseProxy::AllFilter);
 
+	///addStaticCollisionObjects adds objects that will not move in one go, so the broadphase can build its static structure once
+	///(see btBroadphaseInterface::createStaticProxies) instead of inserting them one at a time. Use it when loading a level.
+	void	addStaticCollisionObjects(btCollisionObject** collisionObjects, int numObjects, int collisionFilterGroup=btBroadphaseProxy::StaticFilter, int collisionFilterMask=btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter);
+
 	btCollisionObjectArray& getCollisionObjectArray()
 	{
 		return m_collisionObjects;
@@ -0,0 +1,241 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btContactEventQueue.h"
+#include "BulletCollision/BroadphaseCollision/btDispatcher.h"
+#include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+
+struct btContactPairKeyPredicate
+{
+	bool operator() (const btContactEventQueue::PairState& a, const btContactEventQueue::PairState& b) const
+	{
+		return a.m_key < b.m_key;
+	}
+};
+
+btContactEventQueue::btContactEventQueue(int capacity)
+:m_current(0),
+m_head(0),
+m_tail(0),
+m_numDropped(0),
+m_tick(0),
+m_contactThreshold(0),
+m_reportPersistent(true)
+{
+	int size = 1;
+	while (size < capacity)
+	{
+		size <<= 1;
+	}
+	m_events.resize(size);
+}
+
+void	btContactEventQueue::push(int type, const PairState& pair)
+{
+	if (m_head - m_tail == unsigned(m_events.size()))
+	{
+		++m_numDropped;
+		return;
+	}
+
+	btContactEvent& event = m_events[m_head & (m_events.size() - 1)];
+	event.m_type = type;
+	event.m_tick = m_tick;
+	event.m_objectA = pair.m_objectA;
+	event.m_objectB = pair.m_objectB;
+	event.m_pointWorldOnB = pair.m_pointWorldOnB;
+	event.m_normalWorldOnB = pair.m_normalWorldOnB;
+	event.m_distance = pair.m_distance;
+	event.m_appliedImpulse = type == btContactEvent::END ? btScalar(0) : pair.m_appliedImpulse;
+	event.m_numContacts = type == btContactEvent::END ? 0 : pair.m_numContacts;
+	++m_head;
+}
+
+void	btContactEventQueue::processManifolds(btDispatcher* dispatcher)
+{
+	++m_tick;
+
+	const btAlignedObjectArray<PairState>& previous = m_pairs[m_current];
+	m_current = 1 - m_current;
+	btAlignedObjectArray<PairState>& current = m_pairs[m_current];
+	current.resize(0);
+
+	// one state per manifold with touching points, in dispatcher order
+	int numManifolds = dispatcher->getNumManifolds();
+	for (int i = 0; i < numManifolds; i++)
+	{
+		const btPersistentManifold* manifold = dispatcher->getInternalManifoldPointer()[i];
+		const btCollisionObject* body0 = manifold->getBody0();
+		const btCollisionObject* body1 = manifold->getBody1();
+
+		if (!body0->getBroadphaseHandle() || !body1->getBroadphaseHandle())
+		{
+			continue;
+		}
+
+		unsigned int id0 = unsigned(body0->getBroadphaseHandle()->m_uniqueId);
+		unsigned int id1 = unsigned(body1->getBroadphaseHandle()->m_uniqueId);
+		bool swapped = id0 > id1;
+
+		int numContacts = 0;
+		int deepest = -1;
+		btScalar appliedImpulse = 0;
+
+		for (int p = 0; p < manifold->getNumContacts(); p++)
+		{
+			const btManifoldPoint& pt = manifold->getContactPoint(p);
+			if (pt.getDistance() > m_contactThreshold)
+			{
+				continue;
+			}
+			if (deepest < 0 || pt.getDistance() < manifold->getContactPoint(deepest).getDistance())
+			{
+				deepest = p;
+			}
+			appliedImpulse += pt.getAppliedImpulse();
+			numContacts++;
+		}
+
+		if (numContacts == 0)
+		{
+			continue;
+		}
+
+		const btManifoldPoint& pt = manifold->getContactPoint(deepest);
+
+		PairState& pair = current.expandNonInitializing();
+		pair.m_key = swapped ? ((unsigned long long)id1 << 32) | id0 : ((unsigned long long)id0 << 32) | id1;
+		pair.m_objectA = swapped ? body1 : body0;
+		pair.m_objectB = swapped ? body0 : body1;
+		pair.m_pointWorldOnB = swapped ? pt.getPositionWorldOnA() : pt.getPositionWorldOnB();
+		pair.m_normalWorldOnB = swapped ? -pt.m_normalWorldOnB : pt.m_normalWorldOnB;
+		pair.m_distance = pt.getDistance();
+		pair.m_appliedImpulse = appliedImpulse;
+		pair.m_numContacts = numContacts;
+	}
+
+	// compound and concave shapes can keep several manifolds for one pair of objects, fold them together
+	if (current.size() > 1)
+	{
+		current.quickSort(btContactPairKeyPredicate());
+
+		int n = 0;
+		for (int i = 1; i < current.size(); i++)
+		{
+			PairState& last = current[n];
+			const PairState& pair = current[i];
+
+			if (pair.m_key != last.m_key)
+			{
+				current[++n] = pair;
+				continue;
+			}
+
+			if (pair.m_distance < last.m_distance)
+			{
+				last.m_pointWorldOnB = pair.m_pointWorldOnB;
+				last.m_normalWorldOnB = pair.m_normalWorldOnB;
+				last.m_distance = pair.m_distance;
+			}
+			last.m_appliedImpulse += pair.m_appliedImpulse;
+			last.m_numContacts += pair.m_numContacts;
+		}
+		current.resize(n + 1);
+	}
+
+	// both lists are sorted by key, walk them together
+	int i = 0;
+	int j = 0;
+	while (i < previous.size() || j < current.size())
+	{
+		if (j == current.size() || (i < previous.size() && previous[i].m_key < current[j].m_key))
+		{
+			push(btContactEvent::END, previous[i++]);
+		}
+		else if (i == previous.size() || current[j].m_key < previous[i].m_key)
+		{
+			push(btContactEvent::BEGIN, current[j++]);
+		}
+		else
+		{
+			if (m_reportPersistent)
+			{
+				push(btContactEvent::PERSIST, current[j]);
+			}
+			i++;
+			j++;
+		}
+	}
+}
+
+int	btContactEventQueue::drain(btContactEvent* events, int maxEvents)
+{
+	int count = btMin(size(), maxEvents);
+	int mask = m_events.size() - 1;
+
+	for (int i = 0; i < count; i++)
+	{
+		events[i] = m_events[(m_tail + i) & mask];
+	}
+	m_tail += count;
+
+	return count;
+}
+
+void	btContactEventQueue::removeCollisionObject(const btCollisionObject* colObj)
+{
+	btAlignedObjectArray<PairState>& pairs = m_pairs[m_current];
+
+	// compact in place, the remaining pairs stay sorted
+	int n = 0;
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		if (pairs[i].m_objectA == colObj || pairs[i].m_objectB == colObj)
+		{
+			push(btContactEvent::END, pairs[i]);
+		}
+		else
+		{
+			pairs[n++] = pairs[i];
+		}
+	}
+	pairs.resize(n);
+}
+
+void	btContactEventQueue::reset()
+{
+	m_pairs[0].resize(0);
+	m_pairs[1].resize(0);
+	m_head = 0;
+	m_tail = 0;
+	m_numDropped = 0;
+}
+
+
+#pragma clang diagnostic pop
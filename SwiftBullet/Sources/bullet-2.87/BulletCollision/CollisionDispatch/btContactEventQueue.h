@@ -0,0 +1,169 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_CONTACT_EVENT_QUEUE_H
+#define BT_CONTACT_EVENT_QUEUE_H
+
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+class btCollisionObject;
+class btDispatcher;
+
+///btContactEvent reports a change in the touching state of a pair of collision objects.
+///Object A is the one whose broadphase proxy was created first, the normal points from B to A.
+struct btContactEvent
+{
+	enum Type
+	{
+		BEGIN,
+		PERSIST,
+		END
+	};
+
+	int	m_type;
+	int	m_tick; //processManifolds call that produced the event
+	const btCollisionObject*	m_objectA;
+	const btCollisionObject*	m_objectB;
+	btVector3	m_pointWorldOnB; //deepest point of the pair
+	btVector3	m_normalWorldOnB;
+	btScalar	m_distance;
+	btScalar	m_appliedImpulse; //summed over every point of the pair, 0 for END
+	int	m_numContacts;
+};
+
+///btContactEventQueue turns the persistent manifolds of a dispatcher into begin/persist/end events.
+///Call processManifolds once per internal tick, after the solver (from an internal tick callback), and drain the
+///events once per frame. The touching pairs of the previous tick are kept sorted by proxy id and diffed against the
+///current ones, and events go into a ring buffer allocated up front, so nothing is allocated once the pair arrays
+///have grown to the size of the scene.
+///END events of removed objects still carry their pointers, don't dereference them after removing an object.
+class btContactEventQueue
+{
+public:
+
+	struct PairState
+	{
+		unsigned long long	m_key; //proxy ids of A and B
+		const btCollisionObject*	m_objectA;
+		const btCollisionObject*	m_objectB;
+		btVector3	m_pointWorldOnB;
+		btVector3	m_normalWorldOnB;
+		btScalar	m_distance;
+		btScalar	m_appliedImpulse;
+		int	m_numContacts;
+	};
+
+protected:
+
+	btAlignedObjectArray<PairState>	m_pairs[2];
+	int	m_current;
+
+	btAlignedObjectArray<btContactEvent>	m_events;
+	unsigned int	m_head; //events written
+	unsigned int	m_tail; //events read
+	int	m_numDropped;
+	int	m_tick;
+
+	btScalar	m_contactThreshold;
+	bool	m_reportPersistent;
+
+	void	push(int type, const PairState& pair);
+
+public:
+
+	///capacity is rounded up to a power of two
+	btContactEventQueue(int capacity = 4096);
+
+	///diffs the manifolds of dispatcher against the previous call and queues the events
+	void	processManifolds(btDispatcher* dispatcher);
+
+	///copies up to maxEvents of the oldest events into events and removes them from the queue, returns how many were copied
+	int	drain(btContactEvent* events, int maxEvents);
+
+	///queues the END events of the pairs of colObj right away, call it before removing colObj from the world.
+	///events already queued still point to colObj, drain them before deleting it
+	void	removeCollisionObject(const btCollisionObject* colObj);
+
+	///forgets the touching pairs and the queued events, for when the world is emptied
+	void	reset();
+
+	int	size() const
+	{
+		return int(m_head - m_tail);
+	}
+
+	int	capacity() const
+	{
+		return m_events.size();
+	}
+
+	///events lost because the queue was full since the last call, the queue keeps the oldest ones
+	int	takeNumDropped()
+	{
+		int numDropped = m_numDropped;
+		m_numDropped = 0;
+		return numDropped;
+	}
+
+	int	getNumTouchingPairs() const
+	{
+		return m_pairs[m_current].size();
+	}
+
+	const PairState&	getTouchingPair(int i) const
+	{
+		return m_pairs[m_current][i];
+	}
+
+	///points further apart than this don't count as touching, the default 0 skips speculative points
+	void	setContactThreshold(btScalar threshold)
+	{
+		m_contactThreshold = threshold;
+	}
+
+	btScalar	getContactThreshold() const
+	{
+		return m_contactThreshold;
+	}
+
+	///PERSIST events are queued for every touching pair on every tick, turn them off when only begin/end matter
+	void	setReportPersistent(bool reportPersistent)
+	{
+		m_reportPersistent = reportPersistent;
+	}
+
+	bool	getReportPersistent() const
+	{
+		return m_reportPersistent;
+	}
+};
+
+#endif //BT_CONTACT_EVENT_QUEUE_H
+
+
+#pragma clang diagnostic pop
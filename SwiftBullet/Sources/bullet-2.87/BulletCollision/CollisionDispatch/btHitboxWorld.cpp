@@ -0,0 +1,487 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btHitboxWorld.h"
+#include "LinearMath/btMinMax.h"
+#include <string.h> //for memset
+
+//Four boxes per test with SSE or NEON, lane by lane otherwise
+#if defined (BT_USE_DOUBLE_PRECISION)
+#define BT_HITBOX_SCALAR
+#elif defined (BT_USE_NEON)
+#include <arm_neon.h>
+#define BT_HITBOX_NEON
+#elif defined (BT_USE_SSE) || defined (__SSE2__) || defined (_M_X64)
+#include <emmintrin.h>
+#define BT_HITBOX_SSE
+#else
+#define BT_HITBOX_SCALAR
+#endif
+
+#if defined (BT_HITBOX_SSE)
+
+typedef __m128 btHitboxReal;
+
+static SIMD_FORCE_INLINE btHitboxReal btHitboxLoad(const btScalar* p) { return _mm_loadu_ps(p); }
+static SIMD_FORCE_INLINE void btHitboxStore(btScalar* p, btHitboxReal a) { _mm_storeu_ps(p, a); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxSplat(btScalar a) { return _mm_set1_ps(a); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxAdd(btHitboxReal a, btHitboxReal b) { return _mm_add_ps(a, b); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxSub(btHitboxReal a, btHitboxReal b) { return _mm_sub_ps(a, b); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxMul(btHitboxReal a, btHitboxReal b) { return _mm_mul_ps(a, b); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxDiv(btHitboxReal a, btHitboxReal b) { return _mm_div_ps(a, b); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxMin(btHitboxReal a, btHitboxReal b) { return _mm_min_ps(a, b); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxMax(btHitboxReal a, btHitboxReal b) { return _mm_max_ps(a, b); }
+///a < b ? c : d
+static SIMD_FORCE_INLINE btHitboxReal btHitboxSelectLess(btHitboxReal a, btHitboxReal b, btHitboxReal c, btHitboxReal d)
+{
+	__m128 mask = _mm_cmplt_ps(a, b);
+	return _mm_or_ps(_mm_and_ps(mask, c), _mm_andnot_ps(mask, d));
+}
+
+#elif defined (BT_HITBOX_NEON)
+
+typedef float32x4_t btHitboxReal;
+
+static SIMD_FORCE_INLINE btHitboxReal btHitboxLoad(const btScalar* p) { return vld1q_f32(p); }
+static SIMD_FORCE_INLINE void btHitboxStore(btScalar* p, btHitboxReal a) { vst1q_f32(p, a); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxSplat(btScalar a) { return vdupq_n_f32(a); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxAdd(btHitboxReal a, btHitboxReal b) { return vaddq_f32(a, b); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxSub(btHitboxReal a, btHitboxReal b) { return vsubq_f32(a, b); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxMul(btHitboxReal a, btHitboxReal b) { return vmulq_f32(a, b); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxMin(btHitboxReal a, btHitboxReal b) { return vminq_f32(a, b); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxMax(btHitboxReal a, btHitboxReal b) { return vmaxq_f32(a, b); }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxDiv(btHitboxReal a, btHitboxReal b)
+{
+	//two Newton steps on the estimate are as good as a divide for the slabs
+	float32x4_t r = vrecpeq_f32(b);
+	r = vmulq_f32(vrecpsq_f32(b, r), r);
+	r = vmulq_f32(vrecpsq_f32(b, r), r);
+	return vmulq_f32(a, r);
+}
+///a < b ? c : d
+static SIMD_FORCE_INLINE btHitboxReal btHitboxSelectLess(btHitboxReal a, btHitboxReal b, btHitboxReal c, btHitboxReal d) { return vbslq_f32(vcltq_f32(a, b), c, d); }
+
+#else //BT_HITBOX_SCALAR
+
+struct btHitboxReal
+{
+	btScalar	m_lanes[BT_HITBOX_BATCH_WIDTH];
+};
+
+#define BT_HITBOX_LANEWISE(expr) \
+	btHitboxReal r; \
+	for (int i = 0; i < BT_HITBOX_BATCH_WIDTH; i++) r.m_lanes[i] = expr; \
+	return r;
+
+static SIMD_FORCE_INLINE btHitboxReal btHitboxLoad(const btScalar* p) { BT_HITBOX_LANEWISE(p[i]) }
+static SIMD_FORCE_INLINE void btHitboxStore(btScalar* p, const btHitboxReal& a)
+{
+	for (int i = 0; i < BT_HITBOX_BATCH_WIDTH; i++) p[i] = a.m_lanes[i];
+}
+static SIMD_FORCE_INLINE btHitboxReal btHitboxSplat(btScalar a) { BT_HITBOX_LANEWISE(a) }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxAdd(const btHitboxReal& a, const btHitboxReal& b) { BT_HITBOX_LANEWISE(a.m_lanes[i] + b.m_lanes[i]) }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxSub(const btHitboxReal& a, const btHitboxReal& b) { BT_HITBOX_LANEWISE(a.m_lanes[i] - b.m_lanes[i]) }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxMul(const btHitboxReal& a, const btHitboxReal& b) { BT_HITBOX_LANEWISE(a.m_lanes[i] * b.m_lanes[i]) }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxDiv(const btHitboxReal& a, const btHitboxReal& b) { BT_HITBOX_LANEWISE(a.m_lanes[i] / b.m_lanes[i]) }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxMin(const btHitboxReal& a, const btHitboxReal& b) { BT_HITBOX_LANEWISE(btMin(a.m_lanes[i], b.m_lanes[i])) }
+static SIMD_FORCE_INLINE btHitboxReal btHitboxMax(const btHitboxReal& a, const btHitboxReal& b) { BT_HITBOX_LANEWISE(btMax(a.m_lanes[i], b.m_lanes[i])) }
+///a < b ? c : d
+static SIMD_FORCE_INLINE btHitboxReal btHitboxSelectLess(const btHitboxReal& a, const btHitboxReal& b, const btHitboxReal& c, const btHitboxReal& d)
+{
+	BT_HITBOX_LANEWISE(a.m_lanes[i] < b.m_lanes[i] ? c.m_lanes[i] : d.m_lanes[i])
+}
+
+#undef BT_HITBOX_LANEWISE
+
+#endif
+
+///slab test of a segment against an aabb, entry fraction in tmin
+static SIMD_FORCE_INLINE bool btHitboxRayAabb(const btVector3& from, const btVector3& invDirection, const btVector3& aabbMin, const btVector3& aabbMax, btScalar maxFraction, btScalar& tmin)
+{
+	btScalar tnear = btScalar(0.);
+	btScalar tfar = maxFraction;
+
+	for (int k = 0; k < 3; k++)
+	{
+		btScalar t0 = (aabbMin[k] - from[k]) * invDirection[k];
+		btScalar t1 = (aabbMax[k] - from[k]) * invDirection[k];
+		tnear = btMax(tnear, btMin(t0, t1));
+		tfar = btMin(tfar, btMax(t0, t1));
+	}
+
+	tmin = tnear;
+	return tnear <= tfar;
+}
+
+///keeps a direction component away from 0 so that its inverse is finite and slabs parallel to the ray stay exact
+static SIMD_FORCE_INLINE btScalar btHitboxSafeComponent(btScalar d)
+{
+	const btScalar eps = btScalar(1e-12);
+	return btFabs(d) < eps ? (d < btScalar(0.) ? -eps : eps) : d;
+}
+
+btHitboxWorld::btHitboxWorld(btScalar margin)
+:m_margin(margin)
+{
+}
+
+btHitboxWorld::~btHitboxWorld()
+{
+	m_tree.clear();
+}
+
+int	btHitboxWorld::addModel(const btHitbox* hitboxes, int numHitboxes)
+{
+	int index = m_models.size();
+	m_models.push_back(Model());
+
+	Model& model = m_models[index];
+	model.m_hitboxes.resize(numHitboxes);
+	for (int i = 0; i < numHitboxes; i++)
+	{
+		model.m_hitboxes[i] = hitboxes[i];
+	}
+
+	return index;
+}
+
+int	btHitboxWorld::addEntity(int model)
+{
+	btAssert(model >= 0 && model < m_models.size());
+
+	int index;
+	if (m_freeEntities.size())
+	{
+		index = m_freeEntities[m_freeEntities.size() - 1];
+		m_freeEntities.pop_back();
+	}
+	else
+	{
+		index = m_entities.size();
+		m_entities.push_back(Entity());
+	}
+
+	Entity& entity = m_entities[index];
+	entity.m_model = model;
+	entity.m_leaf = 0;
+
+	const int numHitboxes = m_models[model].m_hitboxes.size();
+	const int numBatches = (numHitboxes + BT_HITBOX_BATCH_WIDTH - 1) / BT_HITBOX_BATCH_WIDTH;
+	entity.m_batches.resize(numBatches);
+
+	for (int i = 0; i < numBatches; i++)
+	{
+		btHitboxBatch& batch = entity.m_batches[i];
+		memset(&batch, 0, sizeof(btHitboxBatch));
+
+		for (int lane = 0; lane < BT_HITBOX_BATCH_WIDTH; lane++)
+		{
+			const int hitbox = i * BT_HITBOX_BATCH_WIDTH + lane;
+			batch.m_hitbox[lane] = hitbox < numHitboxes ? hitbox : -1;
+		}
+	}
+
+	return index;
+}
+
+void	btHitboxWorld::removeEntity(int entity)
+{
+	Entity& e = m_entities[entity];
+	btAssert(e.m_model >= 0);
+
+	if (e.m_leaf)
+	{
+		m_tree.remove(e.m_leaf);
+	}
+
+	e.m_model = -1;
+	e.m_leaf = 0;
+	e.m_batches.clear();
+	m_freeEntities.push_back(entity);
+}
+
+void	btHitboxWorld::setPose(int entity, const btTransform& entityTransform, const btTransform* boneTransforms, int numBones)
+{
+	Entity& e = m_entities[entity];
+	const Model& model = m_models[e.m_model];
+
+	btVector3 aabbMin(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+	btVector3 aabbMax(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+
+	for (int i = 0; i < model.m_hitboxes.size(); i++)
+	{
+		const btHitbox& hitbox = model.m_hitboxes[i];
+		btHitboxBatch& batch = e.m_batches[i / BT_HITBOX_BATCH_WIDTH];
+		const int lane = i % BT_HITBOX_BATCH_WIDTH;
+
+		btTransform boxTransform = entityTransform;
+		if (hitbox.m_bone >= 0 && hitbox.m_bone < numBones)
+		{
+			boxTransform = entityTransform * boneTransforms[hitbox.m_bone];
+		}
+
+		const btVector3 center = boxTransform(btScalar(0.5) * (hitbox.m_min + hitbox.m_max));
+		const btVector3 halfExtents = btScalar(0.5) * (hitbox.m_max - hitbox.m_min);
+		const btMatrix3x3& basis = boxTransform.getBasis();
+
+		btVector3 extent(0, 0, 0);
+
+		for (int k = 0; k < 3; k++)
+		{
+			//a scaled entity transform scales the box, the axes stay unit
+			btVector3 axis = basis.getColumn(k);
+			const btScalar length = axis.length();
+			axis = length > SIMD_EPSILON ? axis / length : btVector3(k == 0, k == 1, k == 2);
+			const btScalar half = halfExtents[k] * length;
+
+			batch.m_center[k][lane] = center[k];
+			batch.m_halfExtent[k][lane] = half;
+			for (int c = 0; c < 3; c++)
+			{
+				batch.m_axis[k][c][lane] = axis[c];
+			}
+
+			extent += half * axis.absolute();
+		}
+
+		aabbMin.setMin(center - extent);
+		aabbMax.setMax(center + extent);
+	}
+
+	if (model.m_hitboxes.size() == 0)
+	{
+		return;
+	}
+
+	btDbvtVolume volume = btDbvtVolume::FromMM(aabbMin, aabbMax);
+
+	if (e.m_leaf)
+	{
+		//stays in place while the boxes are inside the grown leaf
+		m_tree.update(e.m_leaf, volume, m_margin);
+	}
+	else
+	{
+		volume.Expand(btVector3(m_margin, m_margin, m_margin));
+		e.m_leaf = m_tree.insert(volume, 0);
+		e.m_leaf->dataAsInt = entity;
+	}
+}
+
+void	btHitboxWorld::getPosedHitbox(int entity, int hitbox, btTransform& boxTransform, btVector3& halfExtents) const
+{
+	const btHitboxBatch& batch = m_entities[entity].m_batches[hitbox / BT_HITBOX_BATCH_WIDTH];
+	const int lane = hitbox % BT_HITBOX_BATCH_WIDTH;
+
+	btMatrix3x3 basis;
+	for (int k = 0; k < 3; k++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			basis[c][k] = batch.m_axis[k][c][lane];
+		}
+	}
+
+	boxTransform.setBasis(basis);
+	boxTransform.setOrigin(btVector3(batch.m_center[0][lane], batch.m_center[1][lane], batch.m_center[2][lane]));
+	halfExtents.setValue(batch.m_halfExtent[0][lane], batch.m_halfExtent[1][lane], batch.m_halfExtent[2][lane]);
+}
+
+bool	btHitboxWorld::testEntity(int entity, const btVector3& from, const btVector3& direction, RayResult& result) const
+{
+	const Entity& e = m_entities[entity];
+
+	const btHitboxReal fromX = btHitboxSplat(from.x()), fromY = btHitboxSplat(from.y()), fromZ = btHitboxSplat(from.z());
+	const btHitboxReal dirX = btHitboxSplat(direction.x()), dirY = btHitboxSplat(direction.y()), dirZ = btHitboxSplat(direction.z());
+	const btHitboxReal zero = btHitboxSplat(btScalar(0.));
+	const btHitboxReal eps = btHitboxSplat(btScalar(1e-12));
+	const btHitboxReal negEps = btHitboxSplat(btScalar(-1e-12));
+
+	bool hit = false;
+	ATTRIBUTE_ALIGNED16(btScalar) tnearLanes[BT_HITBOX_BATCH_WIDTH];
+	ATTRIBUTE_ALIGNED16(btScalar) tfarLanes[BT_HITBOX_BATCH_WIDTH];
+
+	for (int b = 0; b < e.m_batches.size(); b++)
+	{
+		const btHitboxBatch& batch = e.m_batches[b];
+
+		const btHitboxReal dx = btHitboxSub(fromX, btHitboxLoad(batch.m_center[0]));
+		const btHitboxReal dy = btHitboxSub(fromY, btHitboxLoad(batch.m_center[1]));
+		const btHitboxReal dz = btHitboxSub(fromZ, btHitboxLoad(batch.m_center[2]));
+
+		btHitboxReal tnear = btHitboxSplat(-BT_LARGE_FLOAT);
+		btHitboxReal tfar = btHitboxSplat(BT_LARGE_FLOAT);
+
+		for (int k = 0; k < 3; k++)
+		{
+			const btHitboxReal ax = btHitboxLoad(batch.m_axis[k][0]);
+			const btHitboxReal ay = btHitboxLoad(batch.m_axis[k][1]);
+			const btHitboxReal az = btHitboxLoad(batch.m_axis[k][2]);
+
+			//segment in the frame of the box
+			const btHitboxReal origin = btHitboxAdd(btHitboxAdd(btHitboxMul(dx, ax), btHitboxMul(dy, ay)), btHitboxMul(dz, az));
+			btHitboxReal dir = btHitboxAdd(btHitboxAdd(btHitboxMul(dirX, ax), btHitboxMul(dirY, ay)), btHitboxMul(dirZ, az));
+
+			//|dir| < eps becomes eps, keeping its sign
+			const btHitboxReal tiny = btHitboxSelectLess(dir, zero, negEps, eps);
+			dir = btHitboxSelectLess(btHitboxMax(dir, btHitboxSub(zero, dir)), eps, tiny, dir);
+
+			const btHitboxReal half = btHitboxLoad(batch.m_halfExtent[k]);
+			const btHitboxReal t0 = btHitboxDiv(btHitboxSub(btHitboxSub(zero, half), origin), dir);
+			const btHitboxReal t1 = btHitboxDiv(btHitboxSub(half, origin), dir);
+
+			tnear = btHitboxMax(tnear, btHitboxMin(t0, t1));
+			tfar = btHitboxMin(tfar, btHitboxMax(t0, t1));
+		}
+
+		btHitboxStore(tnearLanes, tnear);
+		btHitboxStore(tfarLanes, tfar);
+
+		for (int lane = 0; lane < BT_HITBOX_BATCH_WIDTH; lane++)
+		{
+			if (batch.m_hitbox[lane] < 0 || tnearLanes[lane] > tfarLanes[lane] || tfarLanes[lane] < btScalar(0.))
+			{
+				continue;
+			}
+
+			const btScalar fraction = btMax(tnearLanes[lane], btScalar(0.));
+			if (fraction < result.m_fraction)
+			{
+				result.m_fraction = fraction;
+				result.m_entity = entity;
+				result.m_hitbox = batch.m_hitbox[lane];
+				hit = true;
+			}
+		}
+	}
+
+	return hit;
+}
+
+bool	btHitboxWorld::rayTest(const btVector3& from, const btVector3& to, RayResult& result) const
+{
+	result.m_entity = -1;
+	result.m_hitbox = -1;
+	result.m_bone = -1;
+	result.m_group = 0;
+	result.m_fraction = btScalar(1.);
+
+	if (!m_tree.m_root)
+	{
+		return false;
+	}
+
+	const btVector3 direction = to - from;
+	const btVector3 invDirection(
+		btScalar(1.) / btHitboxSafeComponent(direction.x()),
+		btScalar(1.) / btHitboxSafeComponent(direction.y()),
+		btScalar(1.) / btHitboxSafeComponent(direction.z()));
+
+	//nearer child last, so it's popped first and the farther one is skipped once a hit lies in front of it
+	m_stack.resize(0);
+	m_stack.push_back(m_tree.m_root);
+
+	while (m_stack.size())
+	{
+		const btDbvtNode* node = m_stack[m_stack.size() - 1];
+		m_stack.pop_back();
+
+		btScalar tmin;
+		if (!btHitboxRayAabb(from, invDirection, node->volume.Mins(), node->volume.Maxs(), result.m_fraction, tmin))
+		{
+			continue;
+		}
+
+		if (node->isleaf())
+		{
+			testEntity(node->dataAsInt, from, direction, result);
+			continue;
+		}
+
+		btScalar t0, t1;
+		const bool hit0 = btHitboxRayAabb(from, invDirection, node->childs[0]->volume.Mins(), node->childs[0]->volume.Maxs(), result.m_fraction, t0);
+		const bool hit1 = btHitboxRayAabb(from, invDirection, node->childs[1]->volume.Mins(), node->childs[1]->volume.Maxs(), result.m_fraction, t1);
+
+		if (hit0 && hit1)
+		{
+			const int nearChild = t0 <= t1 ? 0 : 1;
+			m_stack.push_back(node->childs[1 - nearChild]);
+			m_stack.push_back(node->childs[nearChild]);
+		}
+		else if (hit0)
+		{
+			m_stack.push_back(node->childs[0]);
+		}
+		else if (hit1)
+		{
+			m_stack.push_back(node->childs[1]);
+		}
+	}
+
+	if (result.m_entity < 0)
+	{
+		return false;
+	}
+
+	const Entity& e = m_entities[result.m_entity];
+	const btHitbox& hitbox = m_models[e.m_model].m_hitboxes[result.m_hitbox];
+	result.m_bone = hitbox.m_bone;
+	result.m_group = hitbox.m_group;
+	result.m_point = from + result.m_fraction * direction;
+
+	//the entry face is on the slab that was entered last
+	btTransform boxTransform;
+	btVector3 halfExtents;
+	getPosedHitbox(result.m_entity, result.m_hitbox, boxTransform, halfExtents);
+
+	result.m_normal.setValue(0, 0, 0);
+	btScalar entry = -BT_LARGE_FLOAT;
+	const btVector3 origin = from - boxTransform.getOrigin();
+
+	for (int k = 0; k < 3; k++)
+	{
+		const btVector3 axis = boxTransform.getBasis().getColumn(k);
+		const btScalar d = btHitboxSafeComponent(direction.dot(axis));
+		const btScalar o = origin.dot(axis);
+		const btScalar t = (d > btScalar(0.) ? -halfExtents[k] - o : halfExtents[k] - o) / d;
+
+		if (t > entry)
+		{
+			entry = t;
+			result.m_normal = d > btScalar(0.) ? -axis : axis;
+		}
+	}
+
+	if (entry < btScalar(0.))
+	{
+		result.m_normal.setValue(0, 0, 0);
+	}
+
+	return true;
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,150 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_HITBOX_WORLD_H
+#define BT_HITBOX_WORLD_H
+
+#include "BulletCollision/BroadphaseCollision/btDbvt.h"
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+///number of boxes tested against a ray at once
+#define BT_HITBOX_BATCH_WIDTH 4
+
+///btHitbox is a box of a model in the space of one of its bones, as the hitboxes of a GoldSrc studio model.
+///m_bone -1 places it in the space of the model itself
+struct btHitbox
+{
+	int	m_bone;
+	int	m_group;
+	btVector3	m_min;
+	btVector3	m_max;
+};
+
+///BT_HITBOX_BATCH_WIDTH posed hitboxes of one entity stored field by field, as world space center, unit axes and half extents.
+///Unused lanes have m_hitbox -1
+ATTRIBUTE_ALIGNED16(struct) btHitboxBatch
+{
+	btScalar	m_center[3][BT_HITBOX_BATCH_WIDTH];
+	btScalar	m_axis[3][3][BT_HITBOX_BATCH_WIDTH];	//[box axis][component]
+	btScalar	m_halfExtent[3][BT_HITBOX_BATCH_WIDTH];
+	int	m_hitbox[BT_HITBOX_BATCH_WIDTH];
+};
+
+///btHitboxWorld answers shots against the hitboxes of animated entities, apart from any collision world.
+///Models are registered once with their hitboxes and shared by entities; setPose moves the boxes of an entity with its
+///bone transforms, usually the ones the mesh was drawn with. A dynamic AABB tree over the entities, with boxes grown
+///by the margin so that idle animations don't touch the tree, culls entities away from the ray front to back,
+///and the boxes of each entity it reaches are tested BT_HITBOX_BATCH_WIDTH at a time with SSE or NEON
+class btHitboxWorld
+{
+public:
+
+	struct RayResult
+	{
+		int	m_entity;
+		int	m_hitbox;	//index into the hitboxes of the entity's model
+		int	m_bone;
+		int	m_group;
+		btScalar	m_fraction;
+		btVector3	m_point;
+		btVector3	m_normal;	//unit, 0 when the ray starts inside the box
+	};
+
+protected:
+
+	struct Model
+	{
+		btAlignedObjectArray<btHitbox>	m_hitboxes;
+	};
+
+	struct Entity
+	{
+		int	m_model;	//-1 for a free slot
+		btDbvtNode*	m_leaf;	//0 until the first setPose
+		btAlignedObjectArray<btHitboxBatch>	m_batches;
+	};
+
+	btDbvt	m_tree;
+	btScalar	m_margin;
+	btAlignedObjectArray<Model>	m_models;
+	btAlignedObjectArray<Entity>	m_entities;
+	btAlignedObjectArray<int>	m_freeEntities;
+	mutable btAlignedObjectArray<const btDbvtNode*>	m_stack;
+
+	bool	testEntity(int entity, const btVector3& from, const btVector3& direction, RayResult& result) const;
+
+public:
+
+	///margin grows the tree box of an entity on every side when it has to move, in the units of the poses
+	btHitboxWorld(btScalar margin = btScalar(0.05));
+
+	virtual ~btHitboxWorld();
+
+	///copies the hitboxes, returns the model index for addEntity
+	int	addModel(const btHitbox* hitboxes, int numHitboxes);
+
+	int	getNumModels() const
+	{
+		return m_models.size();
+	}
+
+	const btHitbox&	getHitbox(int model, int hitbox) const
+	{
+		return m_models[model].m_hitboxes[hitbox];
+	}
+
+	int	getNumHitboxes(int model) const
+	{
+		return m_models[model].m_hitboxes.size();
+	}
+
+	///returns the entity index, slots of removed entities are reused. The entity can't be hit before its first setPose
+	int	addEntity(int model);
+
+	void	removeEntity(int entity);
+
+	///boneTransforms are in the space of the entity, entityTransform places it in the world and may be scaled.
+	///Hitboxes of bones past numBones stay in the space of the entity
+	void	setPose(int entity, const btTransform& entityTransform, const btTransform* boneTransforms, int numBones);
+
+	///center, unit axes as the columns of the basis and half extents of a posed hitbox
+	void	getPosedHitbox(int entity, int hitbox, btTransform& boxTransform, btVector3& halfExtents) const;
+
+	///closest hitbox along the segment, false when nothing is hit
+	bool	rayTest(const btVector3& from, const btVector3& to, RayResult& result) const;
+
+	///entity tree, whose leaves hold the entity index in dataAsInt
+	const btDbvt&	getTree() const
+	{
+		return m_tree;
+	}
+};
+
+#endif //BT_HITBOX_WORLD_H
+
+#pragma clang diagnostic pop
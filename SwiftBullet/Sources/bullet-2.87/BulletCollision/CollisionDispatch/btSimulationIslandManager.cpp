@@ -33,6 +33,7 @@ subject to the following restrictions:
 
 //#include <stdio.h>
 #include "LinearMath/btQuickprof.h"
+#include "LinearMath/btTraceProfiler.h"
 
 btSimulationIslandManager::btSimulationIslandManager():
 m_splitIslands(true)
@@ -208,6 +209,44 @@ class btPersistentManifoldSortPredicate
 		}
 };
 
+///orders the manifolds of an island by the proxy ids of their bodies, then by the feature of their first point,
+///which tells apart the child manifolds of a compound pair
+class btPersistentManifoldSortPredicateDeterministic
+{
+	public:
+
+		static void	getKey(const btPersistentManifold* manifold, int key[7])
+		{
+			key[0] = getIslandId(manifold);
+			key[1] = manifold->getBody0()->getBroadphaseHandle()->m_uniqueId;
+			key[2] = manifold->getBody1()->getBroadphaseHandle()->m_uniqueId;
+			if (manifold->getNumContacts())
+			{
+				const btManifoldPoint& pt = manifold->getContactPoint(0);
+				key[3] = pt.m_partId0;
+				key[4] = pt.m_index0;
+				key[5] = pt.m_partId1;
+				key[6] = pt.m_index1;
+			} else
+			{
+				key[3] = key[4] = key[5] = key[6] = -1;
+			}
+		}
+
+		bool operator() ( const btPersistentManifold* lhs, const btPersistentManifold* rhs ) const
+		{
+			int lkey[7],rkey[7];
+			getKey(lhs,lkey);
+			getKey(rhs,rkey);
+			for (int i=0;i<7;i++)
+			{
+				if (lkey[i] != rkey[i])
+					return lkey[i] < rkey[i];
+			}
+			return false;
+		}
+};
+
 
 void btSimulationIslandManager::buildIslands(btDispatcher* dispatcher,btCollisionWorld* collisionWorld)
 {
@@ -377,6 +416,7 @@ void btSimulationIslandManager::buildAndProcessIslands(btDispatcher* dispatcher,
 		btPersistentManifold** manifold = dispatcher->getInternalManifoldPointer();
 		int maxNumManifolds = dispatcher->getNumManifolds();
 		callback->processIsland(&collisionObjects[0],collisionObjects.size(),manifold,maxNumManifolds, -1);
+		BT_PROFILE_COUNT(BT_TRACE_ISLANDS, 1);
 	}
 	else
 	{
@@ -388,7 +428,10 @@ void btSimulationIslandManager::buildAndProcessIslands(btDispatcher* dispatcher,
 
 		//tried a radix sort, but quicksort/heapsort seems still faster
 		//@todo rewrite island management
-		m_islandmanifold.quickSort(btPersistentManifoldSortPredicate());
+		if (collisionWorld->getDispatchInfo().m_deterministicOverlappingPairs)
+			m_islandmanifold.quickSort(btPersistentManifoldSortPredicateDeterministic());
+		else
+			m_islandmanifold.quickSort(btPersistentManifoldSortPredicate());
 		//m_islandmanifold.heapSort(btPersistentManifoldSortPredicate());
 
 		//now process all active islands (sets of manifolds for now)
@@ -444,6 +487,7 @@ void btSimulationIslandManager::buildAndProcessIslands(btDispatcher* dispatcher,
 			if (!islandSleeping)
 			{
 				callback->processIsland(&m_islandBodies[0],m_islandBodies.size(),startManifold,numIslandManifolds, islandId);
+				BT_PROFILE_COUNT(BT_TRACE_ISLANDS, 1);
 	//			printf("Island callback of size:%d bodies, %d manifolds\n",islandBodies.size(),numIslandManifolds);
 			}
 			
@@ -0,0 +1,358 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btStaticBrushSetCollisionAlgorithm.h"
+#include "btCollisionDispatcher.h"
+#include "btCollisionObject.h"
+#include "btCollisionObjectWrapper.h"
+#include "btManifoldResult.h"
+#include "BulletCollision/CollisionShapes/btStaticBrushSetShape.h"
+#include "BulletCollision/CollisionShapes/btBrushShape.h"
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
+#include "BulletCollision/NarrowPhaseCollision/btSubSimplexConvexCast.h"
+#include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
+#include "LinearMath/btAabbUtil2.h"
+#include "LinearMath/btQuickprof.h"
+
+btStaticBrushSetCollisionAlgorithm::btStaticBrushSetCollisionAlgorithm(const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool isSwapped)
+:btActivatingCollisionAlgorithm(ci, body0Wrap, body1Wrap),
+m_sharedManifold(ci.m_manifold),
+m_isSwapped(isSwapped)
+{
+	void* ptr = btAlignedAlloc(sizeof(btHashedSimplePairCache),16);
+	m_brushAlgorithmCache = new(ptr) btHashedSimplePairCache();
+
+	btAssert((isSwapped ? body1Wrap : body0Wrap)->getCollisionShape()->getShapeType() == STATIC_BRUSH_SET_SHAPE_PROXYTYPE);
+}
+
+btStaticBrushSetCollisionAlgorithm::~btStaticBrushSetCollisionAlgorithm()
+{
+	removeBrushAlgorithms();
+	m_brushAlgorithmCache->~btHashedSimplePairCache();
+	btAlignedFree(m_brushAlgorithmCache);
+}
+
+void	btStaticBrushSetCollisionAlgorithm::removeBrushAlgorithms()
+{
+	btSimplePairArray& pairs = m_brushAlgorithmCache->getOverlappingPairArray();
+
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		if (pairs[i].m_userPointer)
+		{
+			btCollisionAlgorithm* algo = (btCollisionAlgorithm*) pairs[i].m_userPointer;
+			algo->~btCollisionAlgorithm();
+			m_dispatcher->freeCollisionAlgorithm(algo);
+		}
+	}
+	m_brushAlgorithmCache->removeAllPairs();
+}
+
+void	btStaticBrushSetCollisionAlgorithm::getAllContactManifolds(btManifoldArray& manifoldArray)
+{
+	btSimplePairArray& pairs = m_brushAlgorithmCache->getOverlappingPairArray();
+
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		if (pairs[i].m_userPointer)
+		{
+			((btCollisionAlgorithm*)pairs[i].m_userPointer)->getAllContactManifolds(manifoldArray);
+		}
+	}
+}
+
+struct btStaticBrushLeafCallback : public btStaticBrushCallback
+{
+	const btCollisionObjectWrapper*	m_brushSetObjWrap;
+	const btCollisionObjectWrapper*	m_otherObjWrap;
+	btDispatcher*	m_dispatcher;
+	const btDispatcherInfo&	m_dispatchInfo;
+	btManifoldResult*	m_resultOut;
+	btHashedSimplePairCache*	m_brushAlgorithmCache;
+	btPersistentManifold*	m_sharedManifold;
+	btVector3	m_aabbMin;
+	btVector3	m_aabbMax;
+
+	btStaticBrushLeafCallback(const btCollisionObjectWrapper* brushSetObjWrap, const btCollisionObjectWrapper* otherObjWrap, btDispatcher* dispatcher, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut, btHashedSimplePairCache* brushAlgorithmCache, btPersistentManifold* sharedManifold)
+		:m_brushSetObjWrap(brushSetObjWrap), m_otherObjWrap(otherObjWrap), m_dispatcher(dispatcher), m_dispatchInfo(dispatchInfo), m_resultOut(resultOut),
+		m_brushAlgorithmCache(brushAlgorithmCache), m_sharedManifold(sharedManifold)
+	{
+	}
+
+	virtual void processBrush(int brushIndex)
+	{
+		if (m_dispatchInfo.m_staticBrushPairCallback && !m_dispatchInfo.m_staticBrushPairCallback(m_otherObjWrap, brushIndex))
+		{
+			return;
+		}
+
+		const btStaticBrushSetShape* brushSet = static_cast<const btStaticBrushSetShape*>(m_brushSetObjWrap->getCollisionShape());
+		const btCollisionShape* brush = brushSet->getBrush(brushIndex);
+
+		// the bvh only knows the brush aabb, plane brushes can reject the corners of it exactly
+		if (brush->getShapeType() == BRUSH_SHAPE_PROXYTYPE)
+		{
+			btScalar threshold = brush->getMargin() + (m_sharedManifold ? m_sharedManifold->getContactBreakingThreshold() : btScalar(0.));
+			btVector3 thresholdVec(threshold, threshold, threshold);
+
+			if (!static_cast<const btBrushShape*>(brush)->intersectsAabb(m_aabbMin - thresholdVec, m_aabbMax + thresholdVec))
+			{
+				return;
+			}
+		}
+
+		// brushes live in the space of the brush set, no child transform
+		btCollisionObjectWrapper brushWrap(m_brushSetObjWrap, brush, m_brushSetObjWrap->getCollisionObject(), m_brushSetObjWrap->getWorldTransform(), -1, brushIndex);
+
+		btCollisionAlgorithm* algo = 0;
+		bool allocatedAlgorithm = false;
+
+		if (m_resultOut->m_closestPointDistanceThreshold > 0)
+		{
+			algo = m_dispatcher->findAlgorithm(&brushWrap, m_otherObjWrap, 0, BT_CLOSEST_POINT_ALGORITHMS);
+			allocatedAlgorithm = true;
+		}
+		else
+		{
+			btSimplePair* pair = m_brushAlgorithmCache->findPair(brushIndex, 0);
+			if (pair)
+			{
+				algo = (btCollisionAlgorithm*)pair->m_userPointer;
+			}
+			else
+			{
+				algo = m_dispatcher->findAlgorithm(&brushWrap, m_otherObjWrap, m_sharedManifold, BT_CONTACT_POINT_ALGORITHMS);
+				pair = m_brushAlgorithmCache->addOverlappingPair(brushIndex, 0);
+				btAssert(pair);
+				pair->m_userPointer = algo;
+			}
+		}
+
+		btAssert(algo);
+
+		const btCollisionObjectWrapper* tmpWrap = 0;
+
+		///detect swapping case
+		if (m_resultOut->getBody0Internal() == m_brushSetObjWrap->getCollisionObject())
+		{
+			tmpWrap = m_resultOut->getBody0Wrap();
+			m_resultOut->setBody0Wrap(&brushWrap);
+			m_resultOut->setShapeIdentifiersA(-1, brushIndex);
+		}
+		else
+		{
+			tmpWrap = m_resultOut->getBody1Wrap();
+			m_resultOut->setBody1Wrap(&brushWrap);
+			m_resultOut->setShapeIdentifiersB(-1, brushIndex);
+		}
+
+		algo->processCollision(&brushWrap, m_otherObjWrap, m_dispatchInfo, m_resultOut);
+
+		if (m_resultOut->getBody0Internal() == m_brushSetObjWrap->getCollisionObject())
+		{
+			m_resultOut->setBody0Wrap(tmpWrap);
+		}
+		else
+		{
+			m_resultOut->setBody1Wrap(tmpWrap);
+		}
+
+		if (allocatedAlgorithm)
+		{
+			algo->~btCollisionAlgorithm();
+			m_dispatcher->freeCollisionAlgorithm(algo);
+		}
+	}
+};
+
+void	btStaticBrushSetCollisionAlgorithm::processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	BT_PROFILE("btStaticBrushSetCollisionAlgorithm::processCollision");
+
+	const btCollisionObjectWrapper* brushSetObjWrap = m_isSwapped ? body1Wrap : body0Wrap;
+	const btCollisionObjectWrapper* otherObjWrap = m_isSwapped ? body0Wrap : body1Wrap;
+
+	btAssert(brushSetObjWrap->getCollisionShape()->getShapeType() == STATIC_BRUSH_SET_SHAPE_PROXYTYPE);
+	const btStaticBrushSetShape* brushSet = static_cast<const btStaticBrushSetShape*>(brushSetObjWrap->getCollisionShape());
+
+	///we need to refresh all contact manifolds
+	{
+		btManifoldArray manifoldArray;
+		btSimplePairArray& pairs = m_brushAlgorithmCache->getOverlappingPairArray();
+
+		for (int i = 0; i < pairs.size(); i++)
+		{
+			if (pairs[i].m_userPointer)
+			{
+				btCollisionAlgorithm* algo = (btCollisionAlgorithm*) pairs[i].m_userPointer;
+				algo->getAllContactManifolds(manifoldArray);
+				for (int m = 0; m < manifoldArray.size(); m++)
+				{
+					if (manifoldArray[m]->getNumContacts())
+					{
+						resultOut->setPersistentManifold(manifoldArray[m]);
+						resultOut->refreshContactPoints();
+						resultOut->setPersistentManifold(0);
+					}
+				}
+				manifoldArray.resize(0);
+			}
+		}
+	}
+
+	// aabb of the other object in the space of the brush set
+	btTransform otherInBrushSet = brushSetObjWrap->getWorldTransform().inverse() * otherObjWrap->getWorldTransform();
+	btVector3 aabbMin, aabbMax;
+	otherObjWrap->getCollisionShape()->getAabb(otherInBrushSet, aabbMin, aabbMax);
+
+	btVector3 thresholdVec(resultOut->m_closestPointDistanceThreshold, resultOut->m_closestPointDistanceThreshold, resultOut->m_closestPointDistanceThreshold);
+	aabbMin -= thresholdVec;
+	aabbMax += thresholdVec;
+
+	btStaticBrushLeafCallback callback(brushSetObjWrap, otherObjWrap, m_dispatcher, dispatchInfo, resultOut, m_brushAlgorithmCache, m_sharedManifold);
+	callback.m_aabbMin = aabbMin;
+	callback.m_aabbMax = aabbMax;
+	brushSet->processBrushesInAabb(&callback, aabbMin, aabbMax);
+
+	//remove brushes the object has left
+	{
+		btAssert(m_removePairs.size() == 0);
+
+		btSimplePairArray& pairs = m_brushAlgorithmCache->getOverlappingPairArray();
+
+		for (int i = 0; i < pairs.size(); i++)
+		{
+			int brushIndex = pairs[i].m_indexA;
+
+			if (!TestAabbAgainstAabb2(aabbMin, aabbMax, brushSet->getBrushAabbMin(brushIndex), brushSet->getBrushAabbMax(brushIndex)))
+			{
+				if (pairs[i].m_userPointer)
+				{
+					btCollisionAlgorithm* algo = (btCollisionAlgorithm*)pairs[i].m_userPointer;
+					algo->~btCollisionAlgorithm();
+					m_dispatcher->freeCollisionAlgorithm(algo);
+				}
+				m_removePairs.push_back(btSimplePair(pairs[i].m_indexA, pairs[i].m_indexB));
+			}
+		}
+		for (int i = 0; i < m_removePairs.size(); i++)
+		{
+			m_brushAlgorithmCache->removeOverlappingPair(m_removePairs[i].m_indexA, m_removePairs[i].m_indexB);
+		}
+		m_removePairs.clear();
+	}
+}
+
+struct btStaticBrushSphereCastCallback : public btStaticBrushCallback
+{
+	const btStaticBrushSetShape*	m_brushSet;
+	btTransform	m_ccdSphereFromTrans;
+	btTransform	m_ccdSphereToTrans;
+	btScalar	m_ccdSphereRadius;
+	btScalar	m_hitFraction;
+
+	btStaticBrushSphereCastCallback(const btStaticBrushSetShape* brushSet, const btTransform& from, const btTransform& to, btScalar ccdSphereRadius, btScalar hitFraction)
+		:m_brushSet(brushSet),
+		m_ccdSphereFromTrans(from),
+		m_ccdSphereToTrans(to),
+		m_ccdSphereRadius(ccdSphereRadius),
+		m_hitFraction(hitFraction)
+	{
+	}
+
+	virtual void processBrush(int brushIndex)
+	{
+		//swept sphere against the brush, same approximation as btConvexConcaveCollisionAlgorithm uses per triangle
+		btTransform ident;
+		ident.setIdentity();
+		btConvexCast::CastResult castResult;
+		castResult.m_fraction = m_hitFraction;
+		btSphereShape	pointShape(m_ccdSphereRadius);
+		btVoronoiSimplexSolver	simplexSolver;
+		btSubsimplexConvexCast convexCaster(&pointShape, m_brushSet->getBrush(brushIndex), &simplexSolver);
+
+		if (convexCaster.calcTimeOfImpact(m_ccdSphereFromTrans, m_ccdSphereToTrans, ident, ident, castResult))
+		{
+			if (m_hitFraction > castResult.m_fraction)
+				m_hitFraction = castResult.m_fraction;
+		}
+	}
+};
+
+btScalar	btStaticBrushSetCollisionAlgorithm::calculateTimeOfImpact(btCollisionObject* body0, btCollisionObject* body1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut)
+{
+	(void)resultOut;
+	(void)dispatchInfo;
+	btCollisionObject* convexbody = m_isSwapped ? body0 : body1;
+	btCollisionObject* brushSetBody = m_isSwapped ? body1 : body0;
+
+	//only perform CCD above a certain threshold, see btConvexConcaveCollisionAlgorithm::calculateTimeOfImpact
+	btScalar squareMot0 = (convexbody->getInterpolationWorldTransform().getOrigin() - convexbody->getWorldTransform().getOrigin()).length2();
+	if (squareMot0 < convexbody->getCcdSquareMotionThreshold())
+	{
+		return btScalar(1.);
+	}
+
+	btTransform brushSetInv = brushSetBody->getWorldTransform().inverse();
+	btTransform convexFromLocal = brushSetInv * convexbody->getWorldTransform();
+	btTransform convexToLocal = brushSetInv * convexbody->getInterpolationWorldTransform();
+
+	btScalar ccdRadius0 = convexbody->getCcdSweptSphereRadius();
+	btVector3 rayAabbMin = convexFromLocal.getOrigin();
+	rayAabbMin.setMin(convexToLocal.getOrigin());
+	btVector3 rayAabbMax = convexFromLocal.getOrigin();
+	rayAabbMax.setMax(convexToLocal.getOrigin());
+	rayAabbMin -= btVector3(ccdRadius0,ccdRadius0,ccdRadius0);
+	rayAabbMax += btVector3(ccdRadius0,ccdRadius0,ccdRadius0);
+
+	const btStaticBrushSetShape* brushSet = static_cast<const btStaticBrushSetShape*>(brushSetBody->getCollisionShape());
+	btStaticBrushSphereCastCallback castCallback(brushSet, convexFromLocal, convexToLocal, ccdRadius0, convexbody->getHitFraction());
+	brushSet->processBrushesInAabb(&castCallback, rayAabbMin, rayAabbMax);
+
+	if (castCallback.m_hitFraction < convexbody->getHitFraction())
+	{
+		convexbody->setHitFraction(castCallback.m_hitFraction);
+		return castCallback.m_hitFraction;
+	}
+
+	return btScalar(1.);
+}
+
+void	btStaticBrushSetCollisionAlgorithm::registerAlgorithm(btCollisionDispatcher* dispatcher)
+{
+	static btStaticBrushSetCollisionAlgorithm::CreateFunc s_createFunc;
+	static btStaticBrushSetCollisionAlgorithm::SwappedCreateFunc s_swappedCreateFunc;
+
+	// convex shapes only, compounds recurse into their convex children first
+	for (int i = 0; i < CONCAVE_SHAPES_START_HERE; i++)
+	{
+		dispatcher->registerCollisionCreateFunc(STATIC_BRUSH_SET_SHAPE_PROXYTYPE, i, &s_createFunc);
+		dispatcher->registerCollisionCreateFunc(i, STATIC_BRUSH_SET_SHAPE_PROXYTYPE, &s_swappedCreateFunc);
+		dispatcher->registerClosestPointsCreateFunc(STATIC_BRUSH_SET_SHAPE_PROXYTYPE, i, &s_createFunc);
+		dispatcher->registerClosestPointsCreateFunc(i, STATIC_BRUSH_SET_SHAPE_PROXYTYPE, &s_swappedCreateFunc);
+	}
+}
+
+
+#pragma clang diagnostic pop
@@ -0,0 +1,90 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_STATIC_BRUSH_SET_COLLISION_ALGORITHM_H
+#define BT_STATIC_BRUSH_SET_COLLISION_ALGORITHM_H
+
+#include "btActivatingCollisionAlgorithm.h"
+#include "BulletCollision/BroadphaseCollision/btDispatcher.h"
+#include "BulletCollision/BroadphaseCollision/btBroadphaseInterface.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "BulletCollision/CollisionDispatch/btCollisionCreateFunc.h"
+#include "BulletCollision/CollisionDispatch/btHashedSimplePairCache.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+class btCollisionDispatcher;
+struct btCollisionObjectWrapper;
+
+///btStaticBrushSetCollisionAlgorithm collides a convex object against the brushes of a btStaticBrushSetShape.
+///The brushes overlapping the object are found in the quantized bvh, each one gets its own cached convex algorithm.
+///Contact points carry the brush index as part/index of the brush set side (see gContactAddedCallback).
+///Brushes can be skipped per object with btDispatcherInfo::m_staticBrushPairCallback of the world.
+///Continuous collision sweeps the ccd sphere of the object against the brushes, like btConvexConcaveCollisionAlgorithm.
+class btStaticBrushSetCollisionAlgorithm : public btActivatingCollisionAlgorithm
+{
+	btHashedSimplePairCache*	m_brushAlgorithmCache;
+	btSimplePairArray	m_removePairs;
+	btPersistentManifold*	m_sharedManifold;
+	bool	m_isSwapped;
+
+	void	removeBrushAlgorithms();
+
+public:
+
+	btStaticBrushSetCollisionAlgorithm(const btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, bool isSwapped);
+
+	virtual ~btStaticBrushSetCollisionAlgorithm();
+
+	virtual void processCollision(const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut);
+
+	btScalar	calculateTimeOfImpact(btCollisionObject* body0, btCollisionObject* body1, const btDispatcherInfo& dispatchInfo, btManifoldResult* resultOut);
+
+	virtual	void	getAllContactManifolds(btManifoldArray& manifoldArray);
+
+	///use this function for register the algorithm externally
+	static void registerAlgorithm(btCollisionDispatcher* dispatcher);
+
+	struct CreateFunc : public btCollisionAlgorithmCreateFunc
+	{
+		virtual	btCollisionAlgorithm* CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap)
+		{
+			void* mem = ci.m_dispatcher1->allocateCollisionAlgorithm(sizeof(btStaticBrushSetCollisionAlgorithm));
+			return new(mem) btStaticBrushSetCollisionAlgorithm(ci, body0Wrap, body1Wrap, false);
+		}
+	};
+
+	struct SwappedCreateFunc : public btCollisionAlgorithmCreateFunc
+	{
+		virtual	btCollisionAlgorithm* CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo& ci, const btCollisionObjectWrapper* body0Wrap, const btCollisionObjectWrapper* body1Wrap)
+		{
+			void* mem = ci.m_dispatcher1->allocateCollisionAlgorithm(sizeof(btStaticBrushSetCollisionAlgorithm));
+			return new(mem) btStaticBrushSetCollisionAlgorithm(ci, body0Wrap, body1Wrap, true);
+		}
+	};
+};
+
+#endif //BT_STATIC_BRUSH_SET_COLLISION_ALGORITHM_H
+
+
+#pragma clang diagnostic pop
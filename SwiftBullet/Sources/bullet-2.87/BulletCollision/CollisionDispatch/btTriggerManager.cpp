@@ -0,0 +1,383 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btTriggerManager.h"
+#include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
+#include "BulletCollision/BroadphaseCollision/btCollisionAlgorithm.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "LinearMath/btAabbUtil2.h"
+
+btTriggerManager::btTriggerManager(btOverlappingPairCache* pairCache, btOverlappingPairCallback* next, int triggerGroup)
+:m_pairCache(pairCache),
+m_next(next),
+m_triggerGroup(triggerGroup),
+m_tick(0)
+{
+}
+
+btTriggerManager::~btTriggerManager()
+{
+}
+
+int	btTriggerManager::findTrigger(const btBroadphaseProxy* proxy) const
+{
+	if (!(proxy->m_collisionFilterGroup & m_triggerGroup))
+	{
+		return -1;
+	}
+
+	const int* index = m_triggerIndices.find(btHashPtr(proxy->m_clientObject));
+	return index ? *index : -1;
+}
+
+void	btTriggerManager::pushEvent(int type, const Overlap& overlap)
+{
+	btTriggerEvent& event = m_events.expandNonInitializing();
+	event.m_type = type;
+	event.m_trigger = (const btCollisionObject*) overlap.m_trigger->m_clientObject;
+	event.m_other = (const btCollisionObject*) overlap.m_other->m_clientObject;
+
+	m_triggers[overlap.m_triggerIndex].m_numInside += type == btTriggerEvent::ENTER ? 1 : -1;
+}
+
+bool	btTriggerManager::testExact(const Overlap& overlap)
+{
+	btBroadphasePair* pair = m_pairCache->findPair(overlap.m_trigger, overlap.m_other);
+	if (!pair || !pair->m_algorithm)
+	{
+		return false;
+	}
+
+	m_manifolds.resize(0);
+	pair->m_algorithm->getAllContactManifolds(m_manifolds);
+
+	for (int i = 0; i < m_manifolds.size(); i++)
+	{
+		for (int p = 0; p < m_manifolds[i]->getNumContacts(); p++)
+		{
+			if (m_manifolds[i]->getContactPoint(p).getDistance() <= btScalar(0))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void	btTriggerManager::checkOverlap(Overlap& overlap)
+{
+	overlap.m_checkedTick = m_tick;
+
+	bool inside = m_triggers[overlap.m_triggerIndex].m_exact ?
+		testExact(overlap) :
+		TestAabbAgainstAabb2(overlap.m_trigger->m_aabbMin, overlap.m_trigger->m_aabbMax, overlap.m_other->m_aabbMin, overlap.m_other->m_aabbMax);
+
+	if (inside != overlap.m_inside)
+	{
+		overlap.m_inside = inside;
+		pushEvent(inside ? btTriggerEvent::ENTER : btTriggerEvent::EXIT, overlap);
+	}
+}
+
+void	btTriggerManager::removeOverlap(PairKey key)
+{
+	Overlap* overlap = m_overlaps.find(key);
+	if (overlap->m_inside)
+	{
+		pushEvent(btTriggerEvent::EXIT, *overlap);
+	}
+
+	// both lists fill the freed slot with their last key
+	btAlignedObjectArray<PairKey>& triggerKeys = m_triggers[overlap->m_triggerIndex].m_keys;
+	int slot = overlap->m_triggerSlot;
+	if (slot != triggerKeys.size() - 1)
+	{
+		triggerKeys[slot] = triggerKeys[triggerKeys.size() - 1];
+		m_overlaps.find(triggerKeys[slot])->m_triggerSlot = slot;
+	}
+	triggerKeys.pop_back();
+
+	int otherId = overlap->m_other->m_uniqueId;
+	int index = *m_otherIndices.find(btHashInt(otherId));
+	btAlignedObjectArray<PairKey>& otherKeys = m_others[index].m_keys;
+	slot = overlap->m_otherSlot;
+	if (slot != otherKeys.size() - 1)
+	{
+		otherKeys[slot] = otherKeys[otherKeys.size() - 1];
+		m_overlaps.find(otherKeys[slot])->m_otherSlot = slot;
+	}
+	otherKeys.pop_back();
+
+	if (!otherKeys.size())
+	{
+		int last = m_others.size() - 1;
+		m_otherIndices.remove(btHashInt(otherId));
+		if (index != last)
+		{
+			m_others[index] = m_others[last];
+			m_otherIndices.insert(btHashInt(m_others[index].m_proxy->m_uniqueId), index);
+		}
+		m_others.pop_back();
+	}
+
+	m_overlaps.remove(key);
+}
+
+void	btTriggerManager::addTrigger(btCollisionObject* colObj, bool exact)
+{
+	btAssert(!m_triggerIndices.find(btHashPtr(colObj)));
+
+	Trigger& trigger = m_triggers.expand();
+	trigger.m_object = colObj;
+	trigger.m_aabbMin.setValue(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+	trigger.m_aabbMax.setValue(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+	trigger.m_exact = exact;
+	trigger.m_moved = true;
+	trigger.m_numInside = 0;
+
+	m_triggerIndices.insert(btHashPtr(colObj), m_triggers.size() - 1);
+}
+
+void	btTriggerManager::removeTrigger(btCollisionObject* colObj)
+{
+	const int* found = m_triggerIndices.find(btHashPtr(colObj));
+	if (!found)
+	{
+		return;
+	}
+
+	int index = *found;
+	int last = m_triggers.size() - 1;
+
+	btAlignedObjectArray<PairKey>& keys = m_triggers[index].m_keys;
+	while (keys.size())
+	{
+		removeOverlap(keys[keys.size() - 1]);
+	}
+
+	m_triggerIndices.remove(btHashPtr(colObj));
+	if (index != last)
+	{
+		m_triggers[index] = m_triggers[last];
+		m_triggerIndices.insert(btHashPtr(m_triggers[index].m_object), index);
+
+		const btAlignedObjectArray<PairKey>& movedKeys = m_triggers[index].m_keys;
+		for (int i = 0; i < movedKeys.size(); i++)
+		{
+			m_overlaps.find(movedKeys[i])->m_triggerIndex = index;
+		}
+	}
+	m_triggers.pop_back();
+}
+
+bool	btTriggerManager::isTrigger(const btCollisionObject* colObj) const
+{
+	return m_triggerIndices.find(btHashPtr(colObj)) != 0;
+}
+
+int	btTriggerManager::getNumInside(const btCollisionObject* trigger) const
+{
+	const int* index = m_triggerIndices.find(btHashPtr(trigger));
+	return index ? m_triggers[*index].m_numInside : 0;
+}
+
+void	btTriggerManager::processTriggers()
+{
+	m_tick++;
+
+	// nothing moved, nothing changed: only the overlaps of awake objects and of those that just stopped are checked
+	for (int i = 0; i < m_others.size(); i++)
+	{
+		Other& other = m_others[i];
+		const btCollisionObject* colObj = (const btCollisionObject*) other.m_proxy->m_clientObject;
+
+		if (!colObj->isStaticObject() && colObj->isActive())
+		{
+			other.m_settleTicks = 2;
+		}
+		else if (other.m_settleTicks > 0)
+		{
+			other.m_settleTicks--;
+		}
+		else
+		{
+			continue;
+		}
+
+		for (int k = 0; k < other.m_keys.size(); k++)
+		{
+			checkOverlap(*m_overlaps.find(other.m_keys[k]));
+		}
+	}
+
+	// ghosts never fall asleep, so compare their boxes instead
+	for (int i = 0; i < m_triggers.size(); i++)
+	{
+		Trigger& trigger = m_triggers[i];
+		const btBroadphaseProxy* proxy = trigger.m_object->getBroadphaseHandle();
+
+		trigger.m_moved = proxy && (proxy->m_aabbMin != trigger.m_aabbMin || proxy->m_aabbMax != trigger.m_aabbMax);
+		if (!trigger.m_moved)
+		{
+			continue;
+		}
+
+		trigger.m_aabbMin = proxy->m_aabbMin;
+		trigger.m_aabbMax = proxy->m_aabbMax;
+
+		for (int k = 0; k < trigger.m_keys.size(); k++)
+		{
+			Overlap& overlap = *m_overlaps.find(trigger.m_keys[k]);
+			if (overlap.m_checkedTick != m_tick)
+			{
+				checkOverlap(overlap);
+			}
+		}
+	}
+}
+
+btBroadphasePair*	btTriggerManager::addOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1)
+{
+	if (m_next)
+	{
+		m_next->addOverlappingPair(proxy0, proxy1);
+	}
+
+	if (!((proxy0->m_collisionFilterGroup | proxy1->m_collisionFilterGroup) & m_triggerGroup))
+	{
+		return 0;
+	}
+
+	Overlap overlap;
+	overlap.m_trigger = proxy0;
+	overlap.m_other = proxy1;
+	overlap.m_triggerIndex = findTrigger(proxy0);
+	overlap.m_checkedTick = m_tick;
+	overlap.m_inside = false;
+
+	if (overlap.m_triggerIndex < 0)
+	{
+		btSwap(overlap.m_trigger, overlap.m_other);
+		overlap.m_triggerIndex = findTrigger(proxy1);
+
+		if (overlap.m_triggerIndex < 0)
+		{
+			return 0;
+		}
+	}
+
+	PairKey key(overlap.m_trigger->m_uniqueId, overlap.m_other->m_uniqueId);
+	if (m_overlaps.find(key))
+	{
+		return 0;
+	}
+
+	// the broadphase only adds pairs whose boxes overlap, an exact trigger waits for the narrowphase
+	if (!m_triggers[overlap.m_triggerIndex].m_exact)
+	{
+		overlap.m_inside = true;
+		pushEvent(btTriggerEvent::ENTER, overlap);
+	}
+
+	btAlignedObjectArray<PairKey>& triggerKeys = m_triggers[overlap.m_triggerIndex].m_keys;
+	overlap.m_triggerSlot = triggerKeys.size();
+	triggerKeys.push_back(key);
+
+	const int* found = m_otherIndices.find(btHashInt(overlap.m_other->m_uniqueId));
+	int index = found ? *found : m_others.size();
+	if (!found)
+	{
+		Other& other = m_others.expand();
+		other.m_proxy = overlap.m_other;
+		m_otherIndices.insert(btHashInt(overlap.m_other->m_uniqueId), index);
+	}
+
+	// checked for a couple of ticks even if it sleeps, the manifold of an exact trigger comes with the next dispatch
+	Other& other = m_others[index];
+	other.m_settleTicks = 2;
+	overlap.m_otherSlot = other.m_keys.size();
+	other.m_keys.push_back(key);
+
+	m_overlaps.insert(key, overlap);
+	return 0;
+}
+
+void*	btTriggerManager::removeOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1, btDispatcher* dispatcher)
+{
+	if (m_next)
+	{
+		m_next->removeOverlappingPair(proxy0, proxy1, dispatcher);
+	}
+
+	if (!((proxy0->m_collisionFilterGroup | proxy1->m_collisionFilterGroup) & m_triggerGroup))
+	{
+		return 0;
+	}
+
+	PairKey key(proxy0->m_uniqueId, proxy1->m_uniqueId);
+	Overlap* overlap = m_overlaps.find(key);
+
+	if (!overlap)
+	{
+		key = PairKey(proxy1->m_uniqueId, proxy0->m_uniqueId);
+		overlap = m_overlaps.find(key);
+	}
+
+	if (overlap)
+	{
+		removeOverlap(key);
+	}
+	return 0;
+}
+
+void	btTriggerManager::removeOverlappingPairsContainingProxy(btBroadphaseProxy* proxy0, btDispatcher* dispatcher)
+{
+	if (m_next)
+	{
+		m_next->removeOverlappingPairsContainingProxy(proxy0, dispatcher);
+	}
+
+	// removeOverlap takes the last key off both lists and drops the other object with its last overlap
+	int index = findTrigger(proxy0);
+	if (index >= 0)
+	{
+		btAlignedObjectArray<PairKey>& keys = m_triggers[index].m_keys;
+		while (keys.size())
+		{
+			removeOverlap(keys[keys.size() - 1]);
+		}
+	}
+
+	for (const int* found = m_otherIndices.find(btHashInt(proxy0->m_uniqueId)); found; found = m_otherIndices.find(btHashInt(proxy0->m_uniqueId)))
+	{
+		const btAlignedObjectArray<PairKey>& keys = m_others[*found].m_keys;
+		removeOverlap(keys[keys.size() - 1]);
+	}
+}
+
+
+#pragma clang diagnostic pop
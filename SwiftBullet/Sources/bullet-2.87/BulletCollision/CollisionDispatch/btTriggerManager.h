@@ -0,0 +1,200 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_TRIGGER_MANAGER_H
+#define BT_TRIGGER_MANAGER_H
+
+#include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
+#include "BulletCollision/BroadphaseCollision/btOverlappingPairCallback.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btHashMap.h"
+
+class btOverlappingPairCache;
+class btPersistentManifold;
+typedef btAlignedObjectArray<btPersistentManifold*> btManifoldArray;
+
+///btTriggerEvent reports an object entering or leaving a trigger registered with btTriggerManager
+struct btTriggerEvent
+{
+	enum Type
+	{
+		ENTER,
+		EXIT
+	};
+
+	int	m_type;
+	const btCollisionObject*	m_trigger;
+	const btCollisionObject*	m_other;
+};
+
+///btTriggerManager tracks the objects inside sensor volumes from the add/remove callbacks of the broadphase pair cache.
+///Install it with btOverlappingPairCache::setInternalGhostPairCallback, a previously installed callback (such as
+///btGhostPairCallback) can be chained behind it. Pairs that don't involve a trigger are rejected on their filter group,
+///so the work done in the callbacks follows the pairs that appear and disappear, not the pairs that stay.
+///A broadphase trigger counts an object as inside while their AABBs overlap. An exact trigger waits for a contact point
+///in the narrowphase manifold of the pair, so the dispatcher has to collide it (give it CF_NO_CONTACT_RESPONSE).
+///Call processTriggers after every internal tick. It rechecks an overlap only when the trigger moved or the other
+///object is awake, which is also how exits are found before the broadphase gets around to removing the pair.
+///Overlaps are listed per trigger and per other object, so a tick costs an activation check per object inside a
+///trigger plus the overlaps that are rechecked. Overlaps of static and sleeping objects are left alone.
+///Events pile up until the caller takes them with getEvents/clearEvents, once per frame.
+class btTriggerManager : public btOverlappingPairCallback
+{
+public:
+
+	///proxy ids of the trigger and of the other object
+	class PairKey
+	{
+		unsigned long long	m_key;
+
+	public:
+
+		PairKey()
+		{
+		}
+
+		PairKey(int triggerId, int otherId)
+			:m_key(((unsigned long long)unsigned(triggerId) << 32) | unsigned(otherId))
+		{
+		}
+
+		bool	equals(const PairKey& other) const
+		{
+			return m_key == other.m_key;
+		}
+
+		unsigned int	getHash() const
+		{
+			unsigned long long key = m_key;
+			key ^= key >> 33;
+			key *= 0xff51afd7ed558ccdULL;
+			key ^= key >> 33;
+			return unsigned(key);
+		}
+	};
+
+	struct Trigger
+	{
+		btCollisionObject*	m_object;
+		btVector3	m_aabbMin; //proxy box at the last processTriggers
+		btVector3	m_aabbMax;
+		bool	m_exact;
+		bool	m_moved;
+		int	m_numInside;
+		btAlignedObjectArray<PairKey>	m_keys; //overlaps of the trigger
+	};
+
+	///an object overlapping at least one trigger
+	struct Other
+	{
+		btBroadphaseProxy*	m_proxy;
+		int	m_settleTicks; //checks left after the object stopped, its last move shows up a tick late
+		btAlignedObjectArray<PairKey>	m_keys; //overlaps of the object
+	};
+
+	struct Overlap
+	{
+		btBroadphaseProxy*	m_trigger; //trigger side of the pair
+		btBroadphaseProxy*	m_other;
+		int	m_triggerIndex;
+		int	m_triggerSlot; //in the m_keys of the trigger
+		int	m_otherSlot; //in the m_keys of the other object
+		int	m_checkedTick;
+		bool	m_inside;
+	};
+
+protected:
+
+	btOverlappingPairCache*	m_pairCache;
+	btOverlappingPairCallback*	m_next;
+	int	m_triggerGroup;
+
+	btAlignedObjectArray<Trigger>	m_triggers;
+	btHashMap<btHashPtr, int>	m_triggerIndices;
+	btAlignedObjectArray<Other>	m_others;
+	btHashMap<btHashInt, int>	m_otherIndices; //by proxy id
+	btHashMap<PairKey, Overlap>	m_overlaps;
+	btAlignedObjectArray<btTriggerEvent>	m_events;
+	btManifoldArray	m_manifolds;
+	int	m_tick;
+
+	int	findTrigger(const btBroadphaseProxy* proxy) const;
+	void	pushEvent(int type, const Overlap& overlap);
+	bool	testExact(const Overlap& overlap);
+	void	checkOverlap(Overlap& overlap);
+	void	removeOverlap(PairKey key);
+
+public:
+
+	///pairCache is the cache the manager is installed on, next is called for every pair after the manager.
+	///triggerGroup is the collision filter group of trigger proxies, pairs without it are skipped right away
+	btTriggerManager(btOverlappingPairCache* pairCache, btOverlappingPairCallback* next = 0, int triggerGroup = btBroadphaseProxy::SensorTrigger);
+
+	virtual ~btTriggerManager();
+
+	///register colObj before adding it to the world, with triggerGroup in its collision filter group
+	void	addTrigger(btCollisionObject* colObj, bool exact);
+
+	///unregister colObj after removing it from the world, which already reported its exits
+	void	removeTrigger(btCollisionObject* colObj);
+
+	bool	isTrigger(const btCollisionObject* colObj) const;
+
+	///objects inside the trigger right now
+	int	getNumInside(const btCollisionObject* trigger) const;
+
+	///updates the inside state of the overlaps that may have changed and queues the enter/exit events
+	void	processTriggers();
+
+	const btAlignedObjectArray<btTriggerEvent>&	getEvents() const
+	{
+		return m_events;
+	}
+
+	///keeps the capacity, the events of the next frame reuse it
+	void	clearEvents()
+	{
+		m_events.resize(0);
+	}
+
+	int	getNumOverlaps() const
+	{
+		return m_overlaps.size();
+	}
+
+	virtual btBroadphasePair*	addOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1);
+
+	virtual void*	removeOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1, btDispatcher* dispatcher);
+
+	virtual void	removeOverlappingPairsContainingProxy(btBroadphaseProxy* proxy0, btDispatcher* dispatcher);
+};
+
+#endif //BT_TRIGGER_MANAGER_H
+
+
+#pragma clang diagnostic pop
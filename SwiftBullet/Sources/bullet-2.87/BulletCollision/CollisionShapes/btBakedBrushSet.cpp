@@ -0,0 +1,572 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btBakedBrushSet.h"
+#include "btBrushShape.h"
+#include "btHillClimbingConvexHullShape.h"
+#include "btStaticBrushSetShape.h"
+#include "BulletCollision/BroadphaseCollision/btQuantizedBvh.h"
+#include "LinearMath/btQuickprof.h"
+
+#include <string.h>
+
+#define BT_BAKED_BRUSH_SET_MAGIC 0x42535242	// "BRSB" when read back in the same byte order
+
+struct btBakedBrushSetHeader
+{
+	unsigned int	m_magic;
+	unsigned int	m_version;
+	unsigned int	m_layout;
+	unsigned int	m_size;
+	unsigned long long	m_sourceHash;
+	int	m_numBrushes;
+	unsigned int	m_bvhOffset;
+	unsigned int	m_bvhSize;
+};
+
+///sizes the blob depends on besides the version; the bvh is stored as the object itself, vtable pointer included
+static unsigned int	btBakedBrushSetLayout()
+{
+	return unsigned(sizeof(btScalar)) | (unsigned(sizeof(void*)) << 4) | (unsigned(sizeof(btQuantizedBvh)) << 8);
+}
+
+///one per brush, followed by its arrays; plain data (btVector3Data instead of btVector3) so it is cleared and copied bytewise
+struct btBakedBrush
+{
+	int	m_shapeType;
+	int	m_numPlanes;		//btBrushShape: unscaled planes, then as many scaled face planes as the polyhedron has faces
+	int	m_numPoints;		//btBrushShape: vertices, btConvexHullShape: unscaled points
+	int	m_numEdges;			//btBrushShape: vertex index pairs
+	int	m_numAdjacency;		//btHillClimbingConvexHullShape: neighbours, -1 without adjacency
+	int	m_startVertex;
+	int	m_hasPolyhedron;
+	int	m_padding;
+	btVector3Data	m_localScaling;
+	btScalar	m_margin;
+};
+
+///followed by the vertices, face sizes, face planes, face indices and unique edges
+struct btBakedPolyhedron
+{
+	int	m_numVertices;
+	int	m_numFaces;
+	int	m_numFaceIndices;
+	int	m_numUniqueEdges;
+	btVector3Data	m_localCenter;
+	btVector3Data	m_extents;
+	btVector3Data	m_C;
+	btVector3Data	m_E;
+	btScalar	m_radius;
+};
+
+struct btBakeWriter
+{
+	unsigned char*	m_buffer;
+	unsigned	m_offset;
+
+	btBakeWriter(void* buffer)
+	:m_buffer((unsigned char*)buffer),
+	m_offset(0)
+	{
+	}
+
+	// every piece starts 16 byte aligned, so btVector3 arrays and the bvh can be used where they are
+	void*	reserve(unsigned size)
+	{
+		m_offset = (m_offset + 15) & ~15u;
+		void* at = m_buffer ? m_buffer + m_offset : 0;
+		m_offset += size;
+		return at;
+	}
+
+	template <typename T>
+	void	write(const T* data, int count)
+	{
+		void* at = reserve(unsigned(sizeof(T) * count));
+		if (at && count > 0)
+		{
+			memcpy(at, data, sizeof(T) * count);
+		}
+	}
+
+	template <typename T>
+	void	write(const T& value)
+	{
+		write(&value, 1);
+	}
+};
+
+struct btBakeReader
+{
+	const unsigned char*	m_buffer;
+	unsigned	m_size;
+	unsigned	m_offset;
+	bool	m_failed;
+
+	btBakeReader(const void* buffer, unsigned size, unsigned offset)
+	:m_buffer((const unsigned char*)buffer),
+	m_size(size),
+	m_offset(offset),
+	m_failed(false)
+	{
+	}
+
+	const void*	take(unsigned size)
+	{
+		m_offset = (m_offset + 15) & ~15u;
+		if (m_failed || m_offset > m_size || size > m_size - m_offset)
+		{
+			m_failed = true;
+			return 0;
+		}
+		const void* at = m_buffer + m_offset;
+		m_offset += size;
+		return at;
+	}
+
+	template <typename T>
+	void	read(T* data, int count)
+	{
+		if (count < 0)
+		{
+			m_failed = true;
+			return;
+		}
+		const void* at = take(unsigned(sizeof(T) * count));
+		if (at && count > 0)
+		{
+			memcpy(data, at, sizeof(T) * count);
+		}
+	}
+
+	template <typename T>
+	void	read(btAlignedObjectArray<T>& array, int count)
+	{
+		if (count < 0 || m_failed)
+		{
+			m_failed = true;
+			return;
+		}
+		array.resize(count);
+		read(count ? &array[0] : (T*)0, count);
+	}
+
+	template <typename T>
+	void	read(T& value)
+	{
+		read(&value, 1);
+	}
+};
+
+static void	btWritePolyhedron(const btConvexPolyhedron* polyhedron, btBakeWriter& writer)
+{
+	btBakedPolyhedron record;
+	memset(&record, 0, sizeof(record));
+	record.m_numVertices = polyhedron->m_vertices.size();
+	record.m_numFaces = polyhedron->m_faces.size();
+	record.m_numUniqueEdges = polyhedron->m_uniqueEdges.size();
+	polyhedron->m_localCenter.serialize(record.m_localCenter);
+	polyhedron->m_extents.serialize(record.m_extents);
+	polyhedron->mC.serialize(record.m_C);
+	polyhedron->mE.serialize(record.m_E);
+	record.m_radius = polyhedron->m_radius;
+
+	btAlignedObjectArray<int> faceSizes;
+	btAlignedObjectArray<btScalar> facePlanes;
+	btAlignedObjectArray<int> faceIndices;
+
+	for (int f = 0; f < polyhedron->m_faces.size(); f++)
+	{
+		const btFace& face = polyhedron->m_faces[f];
+		faceSizes.push_back(face.m_indices.size());
+		for (int i = 0; i < 4; i++)
+		{
+			facePlanes.push_back(face.m_plane[i]);
+		}
+		for (int i = 0; i < face.m_indices.size(); i++)
+		{
+			faceIndices.push_back(face.m_indices[i]);
+		}
+	}
+	record.m_numFaceIndices = faceIndices.size();
+
+	writer.write(record);
+	writer.write(record.m_numVertices ? &polyhedron->m_vertices[0] : (const btVector3*)0, record.m_numVertices);
+	writer.write(record.m_numFaces ? &faceSizes[0] : (const int*)0, record.m_numFaces);
+	writer.write(record.m_numFaces ? &facePlanes[0] : (const btScalar*)0, record.m_numFaces * 4);
+	writer.write(record.m_numFaceIndices ? &faceIndices[0] : (const int*)0, record.m_numFaceIndices);
+	writer.write(record.m_numUniqueEdges ? &polyhedron->m_uniqueEdges[0] : (const btVector3*)0, record.m_numUniqueEdges);
+}
+
+static btConvexPolyhedron*	btReadPolyhedron(btBakeReader& reader)
+{
+	btBakedPolyhedron record;
+	reader.read(record);
+	if (reader.m_failed)
+	{
+		return 0;
+	}
+
+	void* mem = btAlignedAlloc(sizeof(btConvexPolyhedron),16);
+	btConvexPolyhedron* polyhedron = new (mem) btConvexPolyhedron;
+	polyhedron->m_localCenter.deSerialize(record.m_localCenter);
+	polyhedron->m_extents.deSerialize(record.m_extents);
+	polyhedron->mC.deSerialize(record.m_C);
+	polyhedron->mE.deSerialize(record.m_E);
+	polyhedron->m_radius = record.m_radius;
+
+	btAlignedObjectArray<int> faceSizes;
+	btAlignedObjectArray<btScalar> facePlanes;
+	btAlignedObjectArray<int> faceIndices;
+
+	reader.read(polyhedron->m_vertices, record.m_numVertices);
+	reader.read(faceSizes, record.m_numFaces);
+	reader.read(facePlanes, record.m_numFaces * 4);
+	reader.read(faceIndices, record.m_numFaceIndices);
+	reader.read(polyhedron->m_uniqueEdges, record.m_numUniqueEdges);
+
+	if (!reader.m_failed)
+	{
+		polyhedron->m_faces.resize(record.m_numFaces);
+
+		int first = 0;
+		for (int f = 0; f < record.m_numFaces && !reader.m_failed; f++)
+		{
+			btFace& face = polyhedron->m_faces[f];
+			if (faceSizes[f] < 0 || faceSizes[f] > record.m_numFaceIndices - first)
+			{
+				reader.m_failed = true;
+				break;
+			}
+			face.m_indices.resize(faceSizes[f]);
+			for (int i = 0; i < faceSizes[f]; i++)
+			{
+				face.m_indices[i] = faceIndices[first + i];
+			}
+			first += faceSizes[f];
+			for (int i = 0; i < 4; i++)
+			{
+				face.m_plane[i] = facePlanes[f * 4 + i];
+			}
+		}
+	}
+
+	if (reader.m_failed)
+	{
+		polyhedron->~btConvexPolyhedron();
+		btAlignedFree(polyhedron);
+		return 0;
+	}
+
+	return polyhedron;
+}
+
+bool	btBakedBrushSet::writeBlob(const btStaticBrushSetShape* shape, unsigned long long sourceHash, btBakeWriter& writer)
+{
+	const btQuantizedBvh* bvh = shape->getBvh();
+	if (!bvh)
+	{
+		return false;
+	}
+
+	btBakedBrushSetHeader* header = (btBakedBrushSetHeader*)writer.reserve(sizeof(btBakedBrushSetHeader));
+
+	for (int b = 0; b < shape->getNumBrushes(); b++)
+	{
+		const btPolyhedralConvexShape* brush = shape->getBrush(b);
+
+		btBakedBrush record;
+		memset(&record, 0, sizeof(record));
+		record.m_shapeType = brush->getShapeType();
+		record.m_numAdjacency = -1;
+		brush->getLocalScaling().serialize(record.m_localScaling);
+		record.m_margin = brush->getMargin();
+		record.m_hasPolyhedron = brush->getConvexPolyhedron() != 0;
+
+		if (record.m_shapeType == BRUSH_SHAPE_PROXYTYPE)
+		{
+			const btBrushShape* brushShape = static_cast<const btBrushShape*>(brush);
+			record.m_numPlanes = brushShape->m_unscaledPlanes.size();
+			record.m_numPoints = brushShape->m_vertices.size();
+			record.m_numEdges = brushShape->m_edges.size() / 2;
+
+			writer.write(record);
+			writer.write(record.m_numPlanes ? &brushShape->m_unscaledPlanes[0] : (const btVector3*)0, record.m_numPlanes);
+			writer.write(brushShape->m_planes.size());
+			writer.write(brushShape->m_planes.size() ? &brushShape->m_planes[0] : (const btVector3*)0, brushShape->m_planes.size());
+			writer.write(record.m_numPoints ? &brushShape->m_vertices[0] : (const btVector3*)0, record.m_numPoints);
+			writer.write(record.m_numEdges ? &brushShape->m_edges[0] : (const int*)0, record.m_numEdges * 2);
+		}
+		else if (record.m_shapeType == CONVEX_HULL_SHAPE_PROXYTYPE)
+		{
+			const btConvexHullShape* hull = static_cast<const btConvexHullShape*>(brush);
+			record.m_numPoints = hull->getNumPoints();
+
+			// only btHillClimbingConvexHullShape has adjacency
+			const btHillClimbingConvexHullShape* climbing = hull->hasVertexAdjacency() ? static_cast<const btHillClimbingConvexHullShape*>(hull) : 0;
+			if (climbing)
+			{
+				record.m_numAdjacency = climbing->m_adjacency.size();
+				record.m_startVertex = climbing->m_startVertex;
+			}
+
+			writer.write(record);
+			writer.write(record.m_numPoints ? hull->getUnscaledPoints() : (const btVector3*)0, record.m_numPoints);
+			if (climbing)
+			{
+				writer.write(&climbing->m_adjacencyOffsets[0], record.m_numPoints + 1);
+				writer.write(record.m_numAdjacency ? &climbing->m_adjacency[0] : (const int*)0, record.m_numAdjacency);
+			}
+		}
+		else
+		{
+			return false;
+		}
+
+		if (record.m_hasPolyhedron)
+		{
+			btWritePolyhedron(brush->getConvexPolyhedron(), writer);
+		}
+	}
+
+	const unsigned bvhSize = bvh->calculateSerializeBufferSize();
+	void* bvhBuffer = writer.reserve(bvhSize);
+	const unsigned bvhOffset = writer.m_offset - bvhSize;
+
+	if (header)
+	{
+		memset(header, 0, sizeof(btBakedBrushSetHeader));
+		header->m_magic = BT_BAKED_BRUSH_SET_MAGIC;
+		header->m_version = BT_BAKED_BRUSH_SET_VERSION;
+		header->m_layout = btBakedBrushSetLayout();
+		header->m_size = writer.m_offset;
+		header->m_sourceHash = sourceHash;
+		header->m_numBrushes = shape->getNumBrushes();
+		header->m_bvhOffset = bvhOffset;
+		header->m_bvhSize = bvhSize;
+
+		if (!bvh->serialize(bvhBuffer, bvhSize, false))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+btBakedBrushSet::btBakedBrushSet()
+:m_shape(0)
+{
+}
+
+btBakedBrushSet::~btBakedBrushSet()
+{
+	clear();
+}
+
+void	btBakedBrushSet::clear()
+{
+	// the shape keeps pointers to the brushes
+	delete m_shape;
+	m_shape = 0;
+
+	for (int i = 0; i < m_brushes.size(); i++)
+	{
+		delete m_brushes[i];
+	}
+	m_brushes.clear();
+}
+
+unsigned	btBakedBrushSet::calculateBakedSize(const btStaticBrushSetShape* shape)
+{
+	btBakeWriter writer(0);
+	if (!writeBlob(shape, 0, writer))
+	{
+		return 0;
+	}
+	return writer.m_offset;
+}
+
+bool	btBakedBrushSet::bake(const btStaticBrushSetShape* shape, unsigned long long sourceHash, void* alignedBuffer, unsigned bufferSize)
+{
+	BT_PROFILE("btBakedBrushSet::bake");
+
+	const unsigned size = calculateBakedSize(shape);
+	if (!size || bufferSize < size || ((size_t)alignedBuffer & 15) != 0)
+	{
+		return false;
+	}
+
+	btBakeWriter writer(alignedBuffer);
+	return writeBlob(shape, sourceHash, writer);
+}
+
+unsigned long long	btBakedBrushSet::getSourceHash(const void* alignedBuffer, unsigned bufferSize)
+{
+	if (!alignedBuffer || bufferSize < sizeof(btBakedBrushSetHeader) || ((size_t)alignedBuffer & 15) != 0)
+	{
+		return 0;
+	}
+
+	const btBakedBrushSetHeader* header = (const btBakedBrushSetHeader*)alignedBuffer;
+	if (header->m_magic != BT_BAKED_BRUSH_SET_MAGIC || header->m_version != BT_BAKED_BRUSH_SET_VERSION ||
+		header->m_layout != btBakedBrushSetLayout() || header->m_size > bufferSize ||
+		header->m_bvhOffset > header->m_size || header->m_bvhSize > header->m_size - header->m_bvhOffset)
+	{
+		return 0;
+	}
+
+	return header->m_sourceHash;
+}
+
+bool	btBakedBrushSet::load(void* alignedBuffer, unsigned bufferSize, unsigned long long sourceHash)
+{
+	BT_PROFILE("btBakedBrushSet::load");
+
+	clear();
+
+	if (!sourceHash || getSourceHash(alignedBuffer, bufferSize) != sourceHash)
+	{
+		return false;
+	}
+
+	const btBakedBrushSetHeader* header = (const btBakedBrushSetHeader*)alignedBuffer;
+	btBakeReader reader(alignedBuffer, header->m_bvhOffset, sizeof(btBakedBrushSetHeader));
+
+	for (int b = 0; b < header->m_numBrushes && !reader.m_failed; b++)
+	{
+		btBakedBrush record;
+		reader.read(record);
+		if (reader.m_failed)
+		{
+			break;
+		}
+
+		btPolyhedralConvexShape* brush = 0;
+
+		if (record.m_shapeType == BRUSH_SHAPE_PROXYTYPE)
+		{
+			btBrushShape* brushShape = new btBrushShape();
+			brush = brushShape;
+
+			int numFacePlanes = 0;
+			reader.read(brushShape->m_unscaledPlanes, record.m_numPlanes);
+			reader.read(numFacePlanes);
+			reader.read(brushShape->m_planes, numFacePlanes);
+			reader.read(brushShape->m_vertices, record.m_numPoints);
+			reader.read(brushShape->m_edges, record.m_numEdges * 2);
+
+			// setLocalScaling would build the features again
+			brushShape->m_localScaling.deSerialize(record.m_localScaling);
+		}
+		else if (record.m_shapeType == CONVEX_HULL_SHAPE_PROXYTYPE)
+		{
+			btHillClimbingConvexHullShape* hull = new btHillClimbingConvexHullShape();
+			brush = hull;
+
+			btAlignedObjectArray<btVector3> points;
+			reader.read(points, record.m_numPoints);
+			for (int i = 0; i < points.size(); i++)
+			{
+				hull->addPoint(points[i], false);
+			}
+			btVector3 localScaling;
+			localScaling.deSerialize(record.m_localScaling);
+			hull->setLocalScaling(localScaling);
+
+			if (record.m_numAdjacency >= 0)
+			{
+				reader.read(hull->m_adjacencyOffsets, record.m_numPoints + 1);
+				reader.read(hull->m_adjacency, record.m_numAdjacency);
+
+				if (!reader.m_failed && record.m_startVertex >= 0 && record.m_startVertex < record.m_numPoints)
+				{
+					hull->m_startVertex = record.m_startVertex;
+					for (int i = 0; i < int(sizeof(hull->m_supportHint) / sizeof(hull->m_supportHint[0])); i++)
+					{
+						hull->m_supportHint[i] = record.m_startVertex;
+					}
+					hull->m_hasVertexAdjacency = true;
+				}
+				else
+				{
+					reader.m_failed = true;
+				}
+			}
+		}
+		else
+		{
+			reader.m_failed = true;
+			break;
+		}
+
+		m_brushes.push_back(brush);
+		brush->setMargin(record.m_margin);
+
+		if (record.m_hasPolyhedron && !reader.m_failed)
+		{
+			btConvexPolyhedron* polyhedron = btReadPolyhedron(reader);
+			if (record.m_shapeType == BRUSH_SHAPE_PROXYTYPE)
+			{
+				static_cast<btBrushShape*>(brush)->m_polyhedron = polyhedron;
+			}
+			else
+			{
+				static_cast<btHillClimbingConvexHullShape*>(brush)->m_polyhedron = polyhedron;
+			}
+		}
+
+		if (record.m_shapeType == BRUSH_SHAPE_PROXYTYPE)
+		{
+			static_cast<btBrushShape*>(brush)->recalcLocalAabb();
+		}
+	}
+
+	if (reader.m_failed || m_brushes.size() != header->m_numBrushes)
+	{
+		clear();
+		return false;
+	}
+
+	m_shape = new btStaticBrushSetShape();
+	for (int i = 0; i < m_brushes.size(); i++)
+	{
+		m_shape->addBrush(m_brushes[i]);
+	}
+
+	btQuantizedBvh* bvh = btQuantizedBvh::deSerializeInPlace((unsigned char*)alignedBuffer + header->m_bvhOffset, header->m_bvhSize, false);
+	if (!bvh)
+	{
+		clear();
+		return false;
+	}
+	m_shape->setBvh(bvh);
+
+	return true;
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,84 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_BAKED_BRUSH_SET_H
+#define BT_BAKED_BRUSH_SET_H
+
+#include "LinearMath/btAlignedObjectArray.h"
+
+class btStaticBrushSetShape;
+class btPolyhedralConvexShape;
+struct btBakeWriter;
+
+///bumped whenever the blob layout or the way brushes build their features changes, older blobs are then rejected
+#define BT_BAKED_BRUSH_SET_VERSION 3
+
+///btBakedBrushSet stores a btStaticBrushSetShape in one blob, keyed by a hash of the source it was built from: the planes,
+///vertices, edges and polyhedral faces of each btBrushShape, the points and vertex adjacency of each btConvexHullShape
+///and the quantized bvh over the brushes. Loading copies the brush arrays and deserializes the bvh in
+///place, so nothing is intersected, welded, hulled or sorted again. A blob only loads into the build that baked it
+///(same version, scalar, pointer and bvh size and endianness), it is a cache and not an exchange format.
+class btBakedBrushSet
+{
+	btStaticBrushSetShape*	m_shape;
+	btAlignedObjectArray<btPolyhedralConvexShape*>	m_brushes;
+
+	void	clear();
+
+	///sizes the blob when the writer has no buffer, so sizing and baking can't disagree
+	static bool	writeBlob(const btStaticBrushSetShape* shape, unsigned long long sourceHash, btBakeWriter& writer);
+
+public:
+
+	btBakedBrushSet();
+
+	~btBakedBrushSet();
+
+	///size of the blob bake writes, 0 when shape has no bvh or a brush is neither a btBrushShape nor a btConvexHullShape
+	static unsigned	calculateBakedSize(const btStaticBrushSetShape* shape);
+
+	///writes the blob for shape into alignedBuffer, which must be 16 byte aligned and at least calculateBakedSize long
+	static bool	bake(const btStaticBrushSetShape* shape, unsigned long long sourceHash, void* alignedBuffer, unsigned bufferSize);
+
+	///the hash a blob was baked with, 0 when buffer isn't a blob this build can load
+	static unsigned long long	getSourceHash(const void* alignedBuffer, unsigned bufferSize);
+
+	///makes the brushes and the shape of a blob, false when it can't be loaded or was baked from another source.
+	///The bvh is deserialized in place, so the buffer must be writable and outlive the shape; a private mapping of the
+	///file will do, only the pages of the bvh header are written
+	bool	load(void* alignedBuffer, unsigned bufferSize, unsigned long long sourceHash);
+
+	///the loaded shape, owned by this object along with its brushes
+	btStaticBrushSetShape*	getShape() const
+	{
+		return m_shape;
+	}
+};
+
+#endif //BT_BAKED_BRUSH_SET_H
+
+#pragma clang diagnostic pop
@@ -0,0 +1,400 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btBrushShape.h"
+#include "LinearMath/btGeometryUtil.h"
+
+btBrushShape::btBrushShape()
+: btPolyhedralConvexAabbCachingShape()
+{
+	m_shapeType = BRUSH_SHAPE_PROXYTYPE;
+}
+
+btBrushShape::btBrushShape(const btVector3* planeEquations, int numPlanes)
+: btPolyhedralConvexAabbCachingShape()
+{
+	m_shapeType = BRUSH_SHAPE_PROXYTYPE;
+
+	for (int i = 0; i < numPlanes; i++)
+	{
+		m_unscaledPlanes.push_back(planeEquations[i]);
+	}
+
+	buildFeatures();
+}
+
+void	btBrushShape::buildFeatures()
+{
+	m_planes.clear();
+	m_vertices.clear();
+	m_edges.clear();
+
+	// dot(n, x) + w = 0 with x = s * x' gives dot(n / s, x') + w = 0
+	btAlignedObjectArray<btVector3> scaledPlanes;
+
+	for (int i = 0; i < m_unscaledPlanes.size(); i++)
+	{
+		btVector3 normal = m_unscaledPlanes[i] / m_localScaling;
+		btScalar length = normal.length();
+
+		if (length < SIMD_EPSILON)
+		{
+			continue;
+		}
+
+		btVector3& plane = scaledPlanes.expand();
+		plane = normal / length;
+		plane[3] = m_unscaledPlanes[i][3] / length;
+	}
+
+	btAlignedObjectArray<btVector3> corners;
+	btGeometryUtil::getVerticesFromPlaneEquations(scaledPlanes, corners);
+
+	if (corners.size() < 4)
+	{
+		if (m_polyhedron)
+		{
+			m_polyhedron->~btConvexPolyhedron();
+			btAlignedFree(m_polyhedron);
+			m_polyhedron = 0;
+		}
+		recalcLocalAabb();
+		return;
+	}
+
+	btVector3 cornersMin = corners[0];
+	btVector3 cornersMax = corners[0];
+
+	for (int i = 1; i < corners.size(); i++)
+	{
+		cornersMin.setMin(corners[i]);
+		cornersMax.setMax(corners[i]);
+	}
+
+	// tolerances relative to the brush size
+	const btScalar weldDistance = (cornersMax - cornersMin).length() * btScalar(1e-4);
+	const btScalar onPlaneDistance = weldDistance * btScalar(10.);
+
+	// where more than three planes meet the same corner is found several times
+	for (int i = 0; i < corners.size(); i++)
+	{
+		bool found = false;
+
+		for (int j = 0; j < m_vertices.size(); j++)
+		{
+			if (m_vertices[j].distance2(corners[i]) <= weldDistance * weldDistance)
+			{
+				found = true;
+				break;
+			}
+		}
+
+		if (!found)
+		{
+			m_vertices.push_back(corners[i]);
+		}
+	}
+
+	if (m_polyhedron)
+	{
+		m_polyhedron->~btConvexPolyhedron();
+		btAlignedFree(m_polyhedron);
+	}
+
+	void* mem = btAlignedAlloc(sizeof(btConvexPolyhedron),16);
+	m_polyhedron = new (mem) btConvexPolyhedron;
+	m_polyhedron->m_vertices = m_vertices;
+
+	for (int p = 0; p < scaledPlanes.size(); p++)
+	{
+		const btVector3& plane = scaledPlanes[p];
+
+		btAlignedObjectArray<int> indices;
+		btVector3 center(0, 0, 0);
+
+		for (int v = 0; v < m_vertices.size(); v++)
+		{
+			if (btFabs(plane.dot(m_vertices[v]) + plane[3]) <= onPlaneDistance)
+			{
+				indices.push_back(v);
+				center += m_vertices[v];
+			}
+		}
+
+		// bevels and duplicates touch the brush in an edge or a corner only
+		if (indices.size() < 3)
+		{
+			continue;
+		}
+
+		bool duplicate = false;
+
+		for (int f = 0; f < m_planes.size(); f++)
+		{
+			if (m_planes[f].dot(plane) > btScalar(0.9999) && btFabs(m_planes[f][3] - plane[3]) <= onPlaneDistance)
+			{
+				duplicate = true;
+				break;
+			}
+		}
+
+		if (duplicate)
+		{
+			continue;
+		}
+
+		center /= btScalar(indices.size());
+
+		// counter-clockwise around the outward normal, as btPolyhedralContactClipping expects
+		btVector3 u, v;
+		btPlaneSpace1(plane, u, v);
+
+		btAlignedObjectArray<btScalar> angles;
+		angles.resize(indices.size());
+
+		for (int i = 0; i < indices.size(); i++)
+		{
+			btVector3 offset = m_vertices[indices[i]] - center;
+			angles[i] = btAtan2(offset.dot(v), offset.dot(u));
+		}
+
+		for (int i = 1; i < indices.size(); i++)
+		{
+			for (int j = i; j > 0 && angles[j - 1] > angles[j]; j--)
+			{
+				btSwap(angles[j - 1], angles[j]);
+				btSwap(indices[j - 1], indices[j]);
+			}
+		}
+
+		btFace& face = m_polyhedron->m_faces.expand();
+		face.m_indices = indices;
+		face.m_plane[0] = plane.getX();
+		face.m_plane[1] = plane.getY();
+		face.m_plane[2] = plane.getZ();
+		face.m_plane[3] = plane[3];
+
+		m_planes.push_back(plane);
+
+		for (int i = 0; i < indices.size(); i++)
+		{
+			int a = indices[i];
+			int b = indices[(i + 1) % indices.size()];
+			bool known = false;
+
+			for (int e = 0; e < m_edges.size(); e += 2)
+			{
+				if ((m_edges[e] == a && m_edges[e + 1] == b) || (m_edges[e] == b && m_edges[e + 1] == a))
+				{
+					known = true;
+					break;
+				}
+			}
+
+			if (!known)
+			{
+				m_edges.push_back(a);
+				m_edges.push_back(b);
+			}
+		}
+	}
+
+	m_polyhedron->initialize();
+
+	recalcLocalAabb();
+}
+
+bool	btBrushShape::rayTest(const btVector3& rayFrom, const btVector3& rayTo, btScalar& hitFraction, btVector3& hitNormal) const
+{
+	btScalar enter = btScalar(0.);
+	btScalar exit = btScalar(1.);
+	int enterPlane = -1;
+
+	for (int i = 0; i < m_planes.size(); i++)
+	{
+		const btVector3& plane = m_planes[i];
+		btScalar distFrom = plane.dot(rayFrom) + plane[3];
+		btScalar distTo = plane.dot(rayTo) + plane[3];
+
+		if (distFrom > btScalar(0.) && distTo > btScalar(0.))
+		{
+			return false;
+		}
+
+		if (distFrom <= btScalar(0.) && distTo <= btScalar(0.))
+		{
+			continue;
+		}
+
+		btScalar fraction = distFrom / (distFrom - distTo);
+
+		if (distFrom > btScalar(0.))
+		{
+			if (fraction > enter)
+			{
+				enter = fraction;
+				enterPlane = i;
+			}
+		}
+		else if (fraction < exit)
+		{
+			exit = fraction;
+		}
+
+		if (enter > exit)
+		{
+			return false;
+		}
+	}
+
+	if (enterPlane < 0)
+	{
+		return false;
+	}
+
+	hitFraction = enter;
+	hitNormal = m_planes[enterPlane];
+	hitNormal[3] = btScalar(0.);
+	return true;
+}
+
+bool	btBrushShape::intersectsAabb(const btVector3& aabbMin, const btVector3& aabbMax) const
+{
+	btVector3 localAabbMin, localAabbMax;
+	getCachedLocalAabb(localAabbMin, localAabbMax);
+
+	if (!TestAabbAgainstAabb2(aabbMin, aabbMax, localAabbMin, localAabbMax))
+	{
+		return false;
+	}
+
+	const btVector3 center = (aabbMin + aabbMax) * btScalar(0.5);
+	const btVector3 extents = (aabbMax - aabbMin) * btScalar(0.5);
+
+	for (int i = 0; i < m_planes.size(); i++)
+	{
+		const btVector3& plane = m_planes[i];
+		btScalar radius = extents.dot(plane.absolute());
+
+		if (plane.dot(center) + plane[3] > radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+btVector3	btBrushShape::localGetSupportingVertexWithoutMargin(const btVector3& vec)const
+{
+	if (m_vertices.size() == 0)
+	{
+		return btVector3(btScalar(0.),btScalar(0.),btScalar(0.));
+	}
+
+	btScalar maxDot;
+	int index = (int) vec.maxDot(&m_vertices[0], m_vertices.size(), maxDot);
+	return m_vertices[index];
+}
+
+void	btBrushShape::batchedUnitVectorGetSupportingVertexWithoutMargin(const btVector3* vectors,btVector3* supportVerticesOut,int numVectors) const
+{
+	for (int j = 0; j < numVectors; j++)
+	{
+		if (m_vertices.size() == 0)
+		{
+			supportVerticesOut[j][3] = -BT_LARGE_FLOAT;
+			continue;
+		}
+
+		btScalar maxDot;
+		int i = (int) vectors[j].maxDot(&m_vertices[0], m_vertices.size(), maxDot);
+		supportVerticesOut[j] = m_vertices[i];
+		supportVerticesOut[j][3] = maxDot;
+	}
+}
+
+bool	btBrushShape::initializePolyhedralFeatures(int shiftVerticesByMargin)
+{
+	///the features come from the planes and already exist
+	(void)shiftVerticesByMargin;
+	return m_polyhedron != 0;
+}
+
+int	btBrushShape::getNumVertices() const
+{
+	return m_vertices.size();
+}
+
+int	btBrushShape::getNumEdges() const
+{
+	return m_edges.size() / 2;
+}
+
+void	btBrushShape::getEdge(int i,btVector3& pa,btVector3& pb) const
+{
+	pa = m_vertices[m_edges[i * 2]];
+	pb = m_vertices[m_edges[i * 2 + 1]];
+}
+
+void	btBrushShape::getVertex(int i,btVector3& vtx) const
+{
+	vtx = m_vertices[i];
+}
+
+int	btBrushShape::getNumPlanes() const
+{
+	return m_planes.size();
+}
+
+void	btBrushShape::getPlane(btVector3& planeNormal,btVector3& planeSupport,int i ) const
+{
+	planeNormal = m_planes[i];
+	planeNormal[3] = btScalar(0.);
+	planeSupport = planeNormal * -m_planes[i][3];
+}
+
+bool	btBrushShape::isInside(const btVector3& pt,btScalar tolerance) const
+{
+	for (int i = 0; i < m_planes.size(); i++)
+	{
+		if (m_planes[i].dot(pt) + m_planes[i][3] > tolerance)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void	btBrushShape::setLocalScaling(const btVector3& scaling)
+{
+	m_localScaling = scaling;
+	buildFeatures();
+}
+
+
+#pragma clang diagnostic pop
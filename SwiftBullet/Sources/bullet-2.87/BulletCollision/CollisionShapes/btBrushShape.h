@@ -0,0 +1,107 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_BRUSH_SHAPE_H
+#define BT_BRUSH_SHAPE_H
+
+#include "btPolyhedralConvexShape.h"
+#include "btConvexPolyhedron.h"
+#include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h" // for the types
+#include "LinearMath/btAlignedObjectArray.h"
+
+///btBrushShape takes the custom polyhedral type, so the built-in shape types keep their values
+#define BRUSH_SHAPE_PROXYTYPE CUSTOM_POLYHEDRAL_SHAPE_TYPE
+
+
+///The btBrushShape is a convex brush given by its planes, like the brushes of a Quake 3 map.
+///Vertices, faces and edges are built once from the planes, so the shape always has polyhedral features:
+///against any other shape with polyhedral features btConvexConvexAlgorithm clips the touching faces (btPolyhedralContactClipping)
+///and gets a full contact patch in one pass. The separating axis comes from GJK, or from the SAT search with m_enableSatConvex.
+///Ray tests in btCollisionWorld and intersectsAabb clip against the planes exactly, without the collision margin.
+///Planes that don't touch the brush with a face, such as the axial bevels of map compilers, are dropped.
+ATTRIBUTE_ALIGNED16(class) btBrushShape : public btPolyhedralConvexAabbCachingShape
+{
+	// plane equations as in btGeometryUtil: dot(normal, x) + w = 0 on the plane, negative inside
+	btAlignedObjectArray<btVector3>	m_unscaledPlanes;
+	btAlignedObjectArray<btVector3>	m_planes;
+	btAlignedObjectArray<btVector3>	m_vertices;
+	btAlignedObjectArray<int>	m_edges;
+
+	void	buildFeatures();
+
+	///empty, btBakedBrushSet copies the features in
+	btBrushShape();
+
+	friend class btBakedBrushSet;
+
+public:
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btBrushShape(const btVector3* planeEquations, int numPlanes);
+
+	///false if the planes don't enclose a volume
+	bool	isValid() const
+	{
+		return m_planes.size() >= 4;
+	}
+
+	const btVector3*	getPlaneEquations() const
+	{
+		return &m_planes[0];
+	}
+
+	///exact ray against the planes in local space, a ray starting inside the brush doesn't hit it
+	bool	rayTest(const btVector3& rayFrom, const btVector3& rayTo, btScalar& hitFraction, btVector3& hitNormal) const;
+
+	///local space aabb against the planes and the brush aabb; edge-edge separation isn't tested, so it may report overlap of a box near an edge
+	bool	intersectsAabb(const btVector3& aabbMin, const btVector3& aabbMax) const;
+
+	virtual btVector3	localGetSupportingVertexWithoutMargin(const btVector3& vec)const;
+	virtual void	batchedUnitVectorGetSupportingVertexWithoutMargin(const btVector3* vectors,btVector3* supportVerticesOut,int numVectors) const;
+
+	virtual bool	initializePolyhedralFeatures(int shiftVerticesByMargin=0);
+
+	//debugging
+	virtual const char*	getName()const {return "Brush";}
+
+	virtual int	getNumVertices() const;
+	virtual int getNumEdges() const;
+	virtual void getEdge(int i,btVector3& pa,btVector3& pb) const;
+	virtual void getVertex(int i,btVector3& vtx) const;
+	virtual int	getNumPlanes() const;
+	virtual void getPlane(btVector3& planeNormal,btVector3& planeSupport,int i ) const;
+	virtual	bool isInside(const btVector3& pt,btScalar tolerance) const;
+
+	///the planes are scaled and the features rebuilt
+	virtual void	setLocalScaling(const btVector3& scaling);
+};
+
+
+#endif //BT_BRUSH_SHAPE_H
+
+
+#pragma clang diagnostic pop
@@ -37,6 +37,7 @@ subject to the following restrictions:
 btConvexHullShape ::btConvexHullShape (const btScalar* points,int numPoints,int stride) : btPolyhedralConvexAabbCachingShape ()
 {
 	m_shapeType = CONVEX_HULL_SHAPE_PROXYTYPE;
+	m_hasVertexAdjacency = false;
 	m_unscaledPoints.resize(numPoints);
 
 	unsigned char* pointsAddress = (unsigned char*)points;
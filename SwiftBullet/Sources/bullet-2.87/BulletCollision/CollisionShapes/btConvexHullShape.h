@@ -36,6 +36,10 @@ ATTRIBUTE_ALIGNED16(class) btConvexHullShape : public btPolyhedralConvexAabbCach
 {
 	btAlignedObjectArray<btVector3>	m_unscaledPoints;
 
+protected:
+	///set by btHillClimbingConvexHullShape, the non-virtual support mapping then calls the virtual one
+	bool	m_hasVertexAdjacency;
+
 public:
 	BT_DECLARE_ALIGNED_ALLOCATOR();
 
@@ -65,6 +69,11 @@ public:
 	}
 
     void optimizeConvexHull();
+
+	bool	hasVertexAdjacency() const
+	{
+		return m_hasVertexAdjacency;
+	}
     
 	SIMD_FORCE_INLINE	btVector3 getScaledPoint(int i) const
 	{
@@ -293,6 +293,8 @@ btVector3 btConvexShape::localGetSupportVertexWithoutMarginNonVirtual (const btV
 	case CONVEX_HULL_SHAPE_PROXYTYPE:
 	{
 		btConvexHullShape* convexHullShape = (btConvexHullShape*)this;
+		if (convexHullShape->hasVertexAdjacency())
+			return convexHullShape->localGetSupportingVertexWithoutMargin(localDir);
 		btVector3* points = convexHullShape->getUnscaledPoints();
 		int numPoints = convexHullShape->getNumPoints ();
 		return convexHullSupport (localDir, points, numPoints,convexHullShape->getLocalScalingNV());
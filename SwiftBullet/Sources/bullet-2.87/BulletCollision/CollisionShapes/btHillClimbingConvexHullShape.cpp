@@ -0,0 +1,272 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btHillClimbingConvexHullShape.h"
+#include "LinearMath/btConvexHullComputer.h"
+
+btHillClimbingConvexHullShape::btHillClimbingConvexHullShape(const btScalar* points,int numPoints, int stride)
+: btConvexHullShape(points, numPoints, stride),
+m_startVertex(0)
+{
+	for (int i = 0; i < int(sizeof(m_supportHint) / sizeof(m_supportHint[0])); i++)
+	{
+		m_supportHint[i] = 0;
+	}
+
+	if (numPoints > 0)
+	{
+		buildAdjacency();
+	}
+}
+
+bool	btHillClimbingConvexHullShape::buildAdjacency()
+{
+	m_hasVertexAdjacency = false;
+	m_adjacencyOffsets.clear();
+	m_adjacency.clear();
+
+	const int numPoints = getNumPoints();
+
+	if (numPoints < 4)
+	{
+		return false;
+	}
+
+	const btVector3* points = getUnscaledPoints();
+
+	btConvexHullComputer hull;
+	hull.compute(&points[0].getX(), sizeof(btVector3), numPoints, 0, 0);
+
+	if (hull.vertices.size() < 4 || hull.edges.size() == 0)
+	{
+		return false;
+	}
+
+	// the computer rounds coordinates, map its vertices back to the closest input points
+	btAlignedObjectArray<int> pointIndex;
+	pointIndex.resize(hull.vertices.size());
+
+	for (int v = 0; v < hull.vertices.size(); v++)
+	{
+		int closest = 0;
+		btScalar closestDist2 = BT_LARGE_FLOAT;
+
+		for (int i = 0; i < numPoints; i++)
+		{
+			btScalar dist2 = points[i].distance2(hull.vertices[v]);
+			if (dist2 < closestDist2)
+			{
+				closestDist2 = dist2;
+				closest = i;
+			}
+		}
+
+		pointIndex[v] = closest;
+	}
+
+	// every edge is stored in both directions, so counting by source vertex covers all neighbours
+	m_adjacencyOffsets.resize(numPoints + 1, 0);
+
+	for (int e = 0; e < hull.edges.size(); e++)
+	{
+		m_adjacencyOffsets[pointIndex[hull.edges[e].getSourceVertex()] + 1]++;
+	}
+
+	for (int i = 0; i < numPoints; i++)
+	{
+		m_adjacencyOffsets[i + 1] += m_adjacencyOffsets[i];
+	}
+
+	btAlignedObjectArray<int> cursor;
+	cursor.resize(numPoints);
+
+	for (int i = 0; i < numPoints; i++)
+	{
+		cursor[i] = m_adjacencyOffsets[i];
+	}
+
+	m_adjacency.resize(hull.edges.size());
+
+	for (int e = 0; e < hull.edges.size(); e++)
+	{
+		const btConvexHullComputer::Edge& edge = hull.edges[e];
+		m_adjacency[cursor[pointIndex[edge.getSourceVertex()]]++] = pointIndex[edge.getTargetVertex()];
+	}
+
+	m_startVertex = pointIndex[0];
+
+	for (int i = 0; i < int(sizeof(m_supportHint) / sizeof(m_supportHint[0])); i++)
+	{
+		m_supportHint[i] = m_startVertex;
+	}
+
+	m_hasVertexAdjacency = true;
+	return true;
+}
+
+int	btHillClimbingConvexHullShape::climb(const btVector3& scaledDir) const
+{
+	const btVector3* points = getUnscaledPoints();
+	const int numPoints = getNumPoints();
+
+#if BT_THREADSAFE
+	int& hint = m_supportHint[btGetCurrentThreadIndex()];
+#else
+	int& hint = m_supportHint[0];
+#endif
+
+	// the hint may be stale after points were added without rebuilding
+	int vertex = hint;
+	if (vertex >= numPoints || m_adjacencyOffsets[vertex] == m_adjacencyOffsets[vertex + 1])
+	{
+		vertex = m_startVertex;
+	}
+
+	btScalar best = scaledDir.dot(points[vertex]);
+
+	// on a convex hull every vertex that isn't the support has a better neighbour,
+	// the step limit only guards against rounding on nearly coplanar faces
+	for (int step = 0; step < numPoints; step++)
+	{
+		int next = vertex;
+
+		for (int k = m_adjacencyOffsets[vertex]; k < m_adjacencyOffsets[vertex + 1]; k++)
+		{
+			const int neighbour = m_adjacency[k];
+			const btScalar dot = scaledDir.dot(points[neighbour]);
+
+			if (dot > best)
+			{
+				best = dot;
+				next = neighbour;
+			}
+		}
+
+		if (next == vertex)
+		{
+			hint = vertex;
+			return settle(scaledDir, vertex, best);
+		}
+
+		vertex = next;
+	}
+
+	btScalar maxDot;
+	return (int) scaledDir.maxDot(points, numPoints, maxDot);
+}
+
+int	btHillClimbingConvexHullShape::settle(const btVector3& scaledDir, int vertex, btScalar best) const
+{
+	const btVector3* points = getUnscaledPoints();
+	const int numPoints = getNumPoints();
+
+	// where the walk stops on a face depends on where it started, so collect the vertices at the top
+	// (with some slack for rounding on nearly coplanar faces) and pick the best one with the lowest index,
+	// the same one the linear scan picks; the support then depends only on the direction, not on the query history
+	const btScalar slack = btScalar(1e-5) * btFabs(best) + SIMD_EPSILON;
+	const int maxTop = 64;
+	int top[maxTop];
+	int numTop = 1;
+	top[0] = vertex;
+
+	int result = vertex;
+	btScalar resultDot = best;
+
+	for (int t = 0; t < numTop; t++)
+	{
+		const int v = top[t];
+
+		for (int k = m_adjacencyOffsets[v]; k < m_adjacencyOffsets[v + 1]; k++)
+		{
+			const int neighbour = m_adjacency[k];
+			const btScalar dot = scaledDir.dot(points[neighbour]);
+
+			if (dot < best - slack)
+			{
+				continue;
+			}
+
+			bool seen = false;
+			for (int i = 0; i < numTop && !seen; i++)
+			{
+				seen = top[i] == neighbour;
+			}
+
+			if (seen)
+			{
+				continue;
+			}
+
+			if (numTop == maxTop)
+			{
+				btScalar maxDot;
+				return (int) scaledDir.maxDot(points, numPoints, maxDot);
+			}
+
+			top[numTop++] = neighbour;
+
+			if (dot > resultDot || (dot == resultDot && neighbour < result))
+			{
+				resultDot = dot;
+				result = neighbour;
+			}
+		}
+	}
+
+	return result;
+}
+
+btVector3	btHillClimbingConvexHullShape::localGetSupportingVertexWithoutMargin(const btVector3& vec)const
+{
+	if (!m_hasVertexAdjacency || m_adjacencyOffsets.size() != getNumPoints() + 1)
+	{
+		return btConvexHullShape::localGetSupportingVertexWithoutMargin(vec);
+	}
+
+	// dot(a, b*c) = dot(a*b, c), same as btConvexHullShape
+	return getScaledPoint(climb(vec * m_localScaling));
+}
+
+void	btHillClimbingConvexHullShape::batchedUnitVectorGetSupportingVertexWithoutMargin(const btVector3* vectors,btVector3* supportVerticesOut,int numVectors) const
+{
+	if (!m_hasVertexAdjacency || m_adjacencyOffsets.size() != getNumPoints() + 1)
+	{
+		btConvexHullShape::batchedUnitVectorGetSupportingVertexWithoutMargin(vectors, supportVerticesOut, numVectors);
+		return;
+	}
+
+	for (int j = 0; j < numVectors; j++)
+	{
+		btVector3 vec = vectors[j] * m_localScaling;
+		int i = climb(vec);
+		supportVerticesOut[j] = getScaledPoint(i);
+		supportVerticesOut[j][3] = vec.dot(getUnscaledPoints()[i]);
+	}
+}
+
+
+#pragma clang diagnostic pop
@@ -0,0 +1,79 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_HILL_CLIMBING_CONVEX_HULL_SHAPE_H
+#define BT_HILL_CLIMBING_CONVEX_HULL_SHAPE_H
+
+#include "btConvexHullShape.h"
+#include "LinearMath/btThreads.h"
+
+
+///The btHillClimbingConvexHullShape is a btConvexHullShape whose support mapping walks the hull edges instead of testing every point.
+///Vertex neighbours are precomputed with btConvexHullComputer, and each thread starts the walk from the support vertex it found last,
+///which is usually one or two steps away between GJK iterations and between frames.
+///Ties on faces go to the lowest point index, so the support doesn't depend on where the walk started.
+///Hulls of a handful of points gain nothing over the linear scan, see BulletBenchmark gjk.
+///Call buildAdjacency after the last addPoint or optimizeConvexHull, otherwise the shape behaves like btConvexHullShape.
+ATTRIBUTE_ALIGNED16(class) btHillClimbingConvexHullShape : public btConvexHullShape
+{
+	// neighbours of point i are m_adjacency[m_adjacencyOffsets[i] .. m_adjacencyOffsets[i+1]), points inside the hull have none
+	btAlignedObjectArray<int>	m_adjacencyOffsets;
+	btAlignedObjectArray<int>	m_adjacency;
+	int	m_startVertex;
+
+#if BT_THREADSAFE
+	mutable int	m_supportHint[BT_MAX_THREAD_COUNT];
+#else
+	mutable int	m_supportHint[1];
+#endif
+
+	int	climb(const btVector3& scaledDir) const;
+	int	settle(const btVector3& scaledDir, int vertex, btScalar best) const;
+
+	friend class btBakedBrushSet;
+
+public:
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	///points are copied, the adjacency is built right away when any are given
+	btHillClimbingConvexHullShape(const btScalar* points=0,int numPoints=0, int stride=sizeof(btVector3));
+
+	///returns false when the points don't span a volume, the shape then keeps the linear scan
+	bool	buildAdjacency();
+
+	virtual btVector3	localGetSupportingVertexWithoutMargin(const btVector3& vec)const;
+	virtual void	batchedUnitVectorGetSupportingVertexWithoutMargin(const btVector3* vectors,btVector3* supportVerticesOut,int numVectors) const;
+
+	//debugging
+	virtual const char*	getName()const {return "HillClimbingConvex";}
+};
+
+
+#endif //BT_HILL_CLIMBING_CONVEX_HULL_SHAPE_H
+
+
+#pragma clang diagnostic pop
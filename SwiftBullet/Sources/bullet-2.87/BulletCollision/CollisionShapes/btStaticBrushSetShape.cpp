@@ -0,0 +1,237 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btStaticBrushSetShape.h"
+#include "btConvexPolyhedron.h"
+#include "LinearMath/btAabbUtil2.h"
+#include "LinearMath/btQuickprof.h"
+
+btStaticBrushSetShape::btStaticBrushSetShape()
+:m_localAabbMin(btScalar(BT_LARGE_FLOAT),btScalar(BT_LARGE_FLOAT),btScalar(BT_LARGE_FLOAT)),
+m_localAabbMax(btScalar(-BT_LARGE_FLOAT),btScalar(-BT_LARGE_FLOAT),btScalar(-BT_LARGE_FLOAT)),
+m_localScaling(btScalar(1.),btScalar(1.),btScalar(1.)),
+m_bvh(0),
+m_ownsBvh(false)
+{
+	m_shapeType = STATIC_BRUSH_SET_SHAPE_PROXYTYPE;
+}
+
+btStaticBrushSetShape::~btStaticBrushSetShape()
+{
+	if (m_bvh && m_ownsBvh)
+	{
+		m_bvh->~btQuantizedBvh();
+		btAlignedFree(m_bvh);
+	}
+}
+
+int	btStaticBrushSetShape::addBrush(btPolyhedralConvexShape* brush)
+{
+	btTransform identity;
+	identity.setIdentity();
+
+	btVector3 aabbMin, aabbMax;
+	brush->getAabb(identity, aabbMin, aabbMax);
+
+	m_brushes.push_back(brush);
+	m_brushAabbMin.push_back(aabbMin);
+	m_brushAabbMax.push_back(aabbMax);
+
+	m_localAabbMin.setMin(aabbMin);
+	m_localAabbMax.setMax(aabbMax);
+
+	return m_brushes.size() - 1;
+}
+
+void	btStaticBrushSetShape::buildBvh()
+{
+	BT_PROFILE("btStaticBrushSetShape::buildBvh");
+
+	if (m_bvh && m_ownsBvh)
+	{
+		m_bvh->~btQuantizedBvh();
+		btAlignedFree(m_bvh);
+	}
+	m_bvh = 0;
+	m_ownsBvh = false;
+
+	if (m_brushes.size() == 0)
+	{
+		return;
+	}
+
+	void* mem = btAlignedAlloc(sizeof(btQuantizedBvh),16);
+	m_bvh = new (mem) btQuantizedBvh();
+	m_ownsBvh = true;
+	m_bvh->setQuantizationValues(m_localAabbMin, m_localAabbMax);
+
+	// one leaf per brush, the brush index goes where btOptimizedBvh keeps the triangle index
+	QuantizedNodeArray& leafNodes = m_bvh->getLeafNodeArray();
+	leafNodes.resize(m_brushes.size());
+
+	for (int i = 0; i < m_brushes.size(); i++)
+	{
+		btAssert(i < (1<<(31-MAX_NUM_PARTS_IN_BITS)));
+
+		m_bvh->quantizeWithClamp(&leafNodes[i].m_quantizedAabbMin[0], m_brushAabbMin[i], 0);
+		m_bvh->quantizeWithClamp(&leafNodes[i].m_quantizedAabbMax[0], m_brushAabbMax[i], 1);
+		leafNodes[i].m_escapeIndexOrTriangleIndex = i;
+	}
+
+	m_bvh->buildInternal();
+}
+
+struct btStaticBrushNodeCallback : public btNodeOverlapCallback
+{
+	btStaticBrushCallback* m_callback;
+
+	btStaticBrushNodeCallback(btStaticBrushCallback* callback)
+		:m_callback(callback)
+	{
+	}
+
+	virtual void processNode(int subPart, int brushIndex)
+	{
+		(void)subPart;
+		m_callback->processBrush(brushIndex);
+	}
+};
+
+void	btStaticBrushSetShape::setBvh(btQuantizedBvh* bvh)
+{
+	if (m_bvh && m_ownsBvh)
+	{
+		m_bvh->~btQuantizedBvh();
+		btAlignedFree(m_bvh);
+	}
+	m_bvh = bvh;
+	m_ownsBvh = false;
+}
+
+void	btStaticBrushSetShape::processBrushesInAabb(btStaticBrushCallback* callback, const btVector3& aabbMin, const btVector3& aabbMax) const
+{
+	if (!m_bvh)
+	{
+		return;
+	}
+
+	btStaticBrushNodeCallback nodeCallback(callback);
+	m_bvh->reportAabbOverlappingNodex(&nodeCallback, aabbMin, aabbMax);
+}
+
+void	btStaticBrushSetShape::performRaycast(btStaticBrushCallback* callback, const btVector3& raySource, const btVector3& rayTarget) const
+{
+	if (!m_bvh)
+	{
+		return;
+	}
+
+	btStaticBrushNodeCallback nodeCallback(callback);
+	m_bvh->reportRayOverlappingNodex(&nodeCallback, raySource, rayTarget);
+}
+
+void	btStaticBrushSetShape::performConvexcast(btStaticBrushCallback* callback, const btVector3& boxSource, const btVector3& boxTarget, const btVector3& boxMin, const btVector3& boxMax) const
+{
+	if (!m_bvh)
+	{
+		return;
+	}
+
+	btStaticBrushNodeCallback nodeCallback(callback);
+	m_bvh->reportBoxCastOverlappingNodex(&nodeCallback, boxSource, boxTarget, boxMin, boxMax);
+}
+
+void	btStaticBrushSetShape::processAllTriangles(btTriangleCallback* callback, const btVector3& aabbMin, const btVector3& aabbMax) const
+{
+	struct FaceTriangleCallback : public btStaticBrushCallback
+	{
+		const btStaticBrushSetShape* m_shape;
+		btTriangleCallback* m_callback;
+
+		FaceTriangleCallback(const btStaticBrushSetShape* shape, btTriangleCallback* callback)
+			:m_shape(shape), m_callback(callback)
+		{
+		}
+
+		virtual void processBrush(int brushIndex)
+		{
+			// only brushes with polyhedral features have faces
+			const btConvexPolyhedron* polyhedron = m_shape->getBrush(brushIndex)->getConvexPolyhedron();
+			if (!polyhedron)
+			{
+				return;
+			}
+
+			int triangleIndex = 0;
+			btVector3 triangle[3];
+
+			for (int f = 0; f < polyhedron->m_faces.size(); f++)
+			{
+				const btFace& face = polyhedron->m_faces[f];
+
+				// fan triangulation, brush faces are convex
+				for (int v = 2; v < face.m_indices.size(); v++)
+				{
+					triangle[0] = polyhedron->m_vertices[face.m_indices[0]];
+					triangle[1] = polyhedron->m_vertices[face.m_indices[v - 1]];
+					triangle[2] = polyhedron->m_vertices[face.m_indices[v]];
+
+					m_callback->processTriangle(triangle, brushIndex, triangleIndex++);
+				}
+			}
+		}
+	};
+
+	FaceTriangleCallback brushCallback(this, callback);
+	processBrushesInAabb(&brushCallback, aabbMin, aabbMax);
+}
+
+void	btStaticBrushSetShape::getAabb(const btTransform& t, btVector3& aabbMin, btVector3& aabbMax) const
+{
+	if (m_brushes.size() == 0)
+	{
+		aabbMin = aabbMax = t.getOrigin();
+		return;
+	}
+
+	btTransformAabb(m_localAabbMin, m_localAabbMax, m_collisionMargin, t, aabbMin, aabbMax);
+}
+
+void	btStaticBrushSetShape::setLocalScaling(const btVector3& scaling)
+{
+	// the brushes and the bvh are built in final units, scale the brush points instead
+	btAssert((scaling - btVector3(1, 1, 1)).fuzzyZero());
+	m_localScaling = scaling;
+}
+
+void	btStaticBrushSetShape::calculateLocalInertia(btScalar mass, btVector3& inertia) const
+{
+	// static only, like the other concave shapes
+	(void)mass;
+	btAssert(mass == btScalar(0.));
+	inertia.setValue(btScalar(0.),btScalar(0.),btScalar(0.));
+}
+
+
+#pragma clang diagnostic pop
@@ -0,0 +1,140 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_STATIC_BRUSH_SET_SHAPE_H
+#define BT_STATIC_BRUSH_SET_SHAPE_H
+
+#include "btConcaveShape.h"
+#include "btPolyhedralConvexShape.h"
+#include "BulletCollision/BroadphaseCollision/btQuantizedBvh.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+///btStaticBrushSetShape takes the custom concave type, so the built-in shape types keep their values
+#define STATIC_BRUSH_SET_SHAPE_PROXYTYPE CUSTOM_CONCAVE_SHAPE_TYPE
+
+///btStaticBrushCallback is called for every brush found by a btStaticBrushSetShape query
+struct btStaticBrushCallback
+{
+	virtual ~btStaticBrushCallback() {}
+
+	virtual void processBrush(int brushIndex) = 0;
+};
+
+///The btStaticBrushSetShape packs a static set of convex brushes (for example a whole Quake 3 map) into one shape,
+///so the world needs a single collision object and a single broadphase proxy instead of one per brush.
+///A quantized bvh over the brush aabbs finds the brushes near another object, btStaticBrushSetCollisionAlgorithm
+///then runs the regular convex-convex narrowphase per brush; btBrushShape brushes are first tested against the exact planes. Ray and convex casts in btCollisionWorld test the brushes
+///as convex shapes. processAllTriangles, used for debug drawing, only reports the faces of brushes that had
+///initializePolyhedralFeatures called on them.
+ATTRIBUTE_ALIGNED16(class) btStaticBrushSetShape : public btConcaveShape
+{
+protected:
+	btAlignedObjectArray<btPolyhedralConvexShape*>	m_brushes;
+	btAlignedObjectArray<btVector3>	m_brushAabbMin;
+	btAlignedObjectArray<btVector3>	m_brushAabbMax;
+
+	btVector3	m_localAabbMin;
+	btVector3	m_localAabbMax;
+	btVector3	m_localScaling;
+
+	btQuantizedBvh*	m_bvh;
+	bool	m_ownsBvh;
+
+public:
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btStaticBrushSetShape();
+
+	virtual ~btStaticBrushSetShape();
+
+	///brushes are in the local space of the shape and are not owned, they must outlive it
+	///call buildBvh after the last brush is added
+	int	addBrush(btPolyhedralConvexShape* brush);
+
+	void	buildBvh();
+
+	int	getNumBrushes() const
+	{
+		return m_brushes.size();
+	}
+
+	btPolyhedralConvexShape* getBrush(int brushIndex)
+	{
+		return m_brushes[brushIndex];
+	}
+
+	const btPolyhedralConvexShape* getBrush(int brushIndex) const
+	{
+		return m_brushes[brushIndex];
+	}
+
+	const btVector3& getBrushAabbMin(int brushIndex) const
+	{
+		return m_brushAabbMin[brushIndex];
+	}
+
+	const btVector3& getBrushAabbMax(int brushIndex) const
+	{
+		return m_brushAabbMax[brushIndex];
+	}
+
+	const btQuantizedBvh* getBvh() const
+	{
+		return m_bvh;
+	}
+
+	///uses a bvh built over the brushes elsewhere, such as one deserialized in place by btBakedBrushSet, instead of buildBvh;
+	///it is not owned and must outlive the shape
+	void	setBvh(btQuantizedBvh* bvh);
+
+	///all queries are in the local space of the shape
+	void	processBrushesInAabb(btStaticBrushCallback* callback, const btVector3& aabbMin, const btVector3& aabbMax) const;
+
+	void	performRaycast(btStaticBrushCallback* callback, const btVector3& raySource, const btVector3& rayTarget) const;
+
+	void	performConvexcast(btStaticBrushCallback* callback, const btVector3& boxSource, const btVector3& boxTarget, const btVector3& boxMin, const btVector3& boxMax) const;
+
+	virtual void	processAllTriangles(btTriangleCallback* callback, const btVector3& aabbMin, const btVector3& aabbMax) const;
+
+	virtual void	getAabb(const btTransform& t, btVector3& aabbMin, btVector3& aabbMax) const;
+
+	virtual void	setLocalScaling(const btVector3& scaling);
+
+	virtual const btVector3& getLocalScaling() const
+	{
+		return m_localScaling;
+	}
+
+	virtual void	calculateLocalInertia(btScalar mass, btVector3& inertia) const;
+
+	virtual const char*	getName() const
+	{
+		return "StaticBrushSet";
+	}
+};
+
+#endif //BT_STATIC_BRUSH_SET_SHAPE_H
+
+
+#pragma clang diagnostic pop
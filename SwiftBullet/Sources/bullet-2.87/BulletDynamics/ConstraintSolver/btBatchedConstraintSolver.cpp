@@ -0,0 +1,673 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btBatchedConstraintSolver.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btQuickprof.h"
+#include <string.h> //for memset
+
+#define BT_BATCH_WIDTH BT_BATCHED_SOLVER_WIDTH
+
+//One vector type per instruction set, each with the same handful of operations. Body velocities are stored as
+//btVector3, four floats, and are transposed on the way in and out. Loads and stores are unaligned: without
+//BT_USE_SSE, ATTRIBUTE_ALIGNED16 is empty and solver bodies are only 8 byte aligned
+#if defined (BT_USE_DOUBLE_PRECISION)
+#define BT_BATCH_SCALAR
+#elif defined (__AVX__)
+#include <immintrin.h>
+#define BT_BATCH_AVX
+#elif defined (BT_USE_NEON)
+#include <arm_neon.h>
+#define BT_BATCH_NEON
+#elif defined (BT_USE_SSE) || defined (__SSE2__) || defined (_M_X64)
+#include <emmintrin.h>
+#define BT_BATCH_SSE
+#else
+#define BT_BATCH_SCALAR
+#endif
+
+#if defined (BT_BATCH_AVX) || defined (BT_BATCH_SSE)
+
+static SIMD_FORCE_INLINE void btBatchLoad4(const btScalar* const* p, __m128& x, __m128& y, __m128& z, __m128& w)
+{
+	x = _mm_loadu_ps(p[0]);
+	y = _mm_loadu_ps(p[1]);
+	z = _mm_loadu_ps(p[2]);
+	w = _mm_loadu_ps(p[3]);
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+}
+
+static SIMD_FORCE_INLINE void btBatchStore4(btScalar* const* p, __m128 x, __m128 y, __m128 z, __m128 w)
+{
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	_mm_storeu_ps(p[0], x);
+	_mm_storeu_ps(p[1], y);
+	_mm_storeu_ps(p[2], z);
+	_mm_storeu_ps(p[3], w);
+}
+
+#endif
+
+#if defined (BT_BATCH_AVX)
+
+typedef __m256 btBatchReal;
+
+static SIMD_FORCE_INLINE btBatchReal btBatchLoad(const btScalar* p) { return _mm256_loadu_ps(p); }
+static SIMD_FORCE_INLINE void btBatchStore(btScalar* p, btBatchReal a) { _mm256_storeu_ps(p, a); }
+static SIMD_FORCE_INLINE btBatchReal btBatchSplat(btScalar a) { return _mm256_set1_ps(a); }
+static SIMD_FORCE_INLINE btBatchReal btBatchAdd(btBatchReal a, btBatchReal b) { return _mm256_add_ps(a, b); }
+static SIMD_FORCE_INLINE btBatchReal btBatchSub(btBatchReal a, btBatchReal b) { return _mm256_sub_ps(a, b); }
+static SIMD_FORCE_INLINE btBatchReal btBatchMul(btBatchReal a, btBatchReal b) { return _mm256_mul_ps(a, b); }
+///a < b ? c : d
+static SIMD_FORCE_INLINE btBatchReal btBatchSelectLess(btBatchReal a, btBatchReal b, btBatchReal c, btBatchReal d) { return _mm256_blendv_ps(d, c, _mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+
+static SIMD_FORCE_INLINE void btBatchGather(const btScalar* const* p, btBatchReal& x, btBatchReal& y, btBatchReal& z, btBatchReal& w)
+{
+	__m128 x0, y0, z0, w0, x1, y1, z1, w1;
+	btBatchLoad4(p, x0, y0, z0, w0);
+	btBatchLoad4(p + 4, x1, y1, z1, w1);
+	x = _mm256_insertf128_ps(_mm256_castps128_ps256(x0), x1, 1);
+	y = _mm256_insertf128_ps(_mm256_castps128_ps256(y0), y1, 1);
+	z = _mm256_insertf128_ps(_mm256_castps128_ps256(z0), z1, 1);
+	w = _mm256_insertf128_ps(_mm256_castps128_ps256(w0), w1, 1);
+}
+
+static SIMD_FORCE_INLINE void btBatchScatter(btScalar* const* p, btBatchReal x, btBatchReal y, btBatchReal z, btBatchReal w)
+{
+	btBatchStore4(p, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z), _mm256_castps256_ps128(w));
+	btBatchStore4(p + 4, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1));
+}
+
+#elif defined (BT_BATCH_SSE)
+
+typedef __m128 btBatchReal;
+
+static SIMD_FORCE_INLINE btBatchReal btBatchLoad(const btScalar* p) { return _mm_loadu_ps(p); }
+static SIMD_FORCE_INLINE void btBatchStore(btScalar* p, btBatchReal a) { _mm_storeu_ps(p, a); }
+static SIMD_FORCE_INLINE btBatchReal btBatchSplat(btScalar a) { return _mm_set1_ps(a); }
+static SIMD_FORCE_INLINE btBatchReal btBatchAdd(btBatchReal a, btBatchReal b) { return _mm_add_ps(a, b); }
+static SIMD_FORCE_INLINE btBatchReal btBatchSub(btBatchReal a, btBatchReal b) { return _mm_sub_ps(a, b); }
+static SIMD_FORCE_INLINE btBatchReal btBatchMul(btBatchReal a, btBatchReal b) { return _mm_mul_ps(a, b); }
+///a < b ? c : d
+static SIMD_FORCE_INLINE btBatchReal btBatchSelectLess(btBatchReal a, btBatchReal b, btBatchReal c, btBatchReal d)
+{
+	__m128 mask = _mm_cmplt_ps(a, b);
+	return _mm_or_ps(_mm_and_ps(mask, c), _mm_andnot_ps(mask, d));
+}
+
+static SIMD_FORCE_INLINE void btBatchGather(const btScalar* const* p, btBatchReal& x, btBatchReal& y, btBatchReal& z, btBatchReal& w)
+{
+	btBatchLoad4(p, x, y, z, w);
+}
+
+static SIMD_FORCE_INLINE void btBatchScatter(btScalar* const* p, btBatchReal x, btBatchReal y, btBatchReal z, btBatchReal w)
+{
+	btBatchStore4(p, x, y, z, w);
+}
+
+#elif defined (BT_BATCH_NEON)
+
+typedef float32x4_t btBatchReal;
+
+static SIMD_FORCE_INLINE btBatchReal btBatchLoad(const btScalar* p) { return vld1q_f32(p); }
+static SIMD_FORCE_INLINE void btBatchStore(btScalar* p, btBatchReal a) { vst1q_f32(p, a); }
+static SIMD_FORCE_INLINE btBatchReal btBatchSplat(btScalar a) { return vdupq_n_f32(a); }
+static SIMD_FORCE_INLINE btBatchReal btBatchAdd(btBatchReal a, btBatchReal b) { return vaddq_f32(a, b); }
+static SIMD_FORCE_INLINE btBatchReal btBatchSub(btBatchReal a, btBatchReal b) { return vsubq_f32(a, b); }
+static SIMD_FORCE_INLINE btBatchReal btBatchMul(btBatchReal a, btBatchReal b) { return vmulq_f32(a, b); }
+///a < b ? c : d
+static SIMD_FORCE_INLINE btBatchReal btBatchSelectLess(btBatchReal a, btBatchReal b, btBatchReal c, btBatchReal d) { return vbslq_f32(vcltq_f32(a, b), c, d); }
+
+static SIMD_FORCE_INLINE void btBatchTranspose(btBatchReal& x, btBatchReal& y, btBatchReal& z, btBatchReal& w)
+{
+	float32x4x2_t xy = vtrnq_f32(x, y);
+	float32x4x2_t zw = vtrnq_f32(z, w);
+	x = vcombine_f32(vget_low_f32(xy.val[0]), vget_low_f32(zw.val[0]));
+	y = vcombine_f32(vget_low_f32(xy.val[1]), vget_low_f32(zw.val[1]));
+	z = vcombine_f32(vget_high_f32(xy.val[0]), vget_high_f32(zw.val[0]));
+	w = vcombine_f32(vget_high_f32(xy.val[1]), vget_high_f32(zw.val[1]));
+}
+
+static SIMD_FORCE_INLINE void btBatchGather(const btScalar* const* p, btBatchReal& x, btBatchReal& y, btBatchReal& z, btBatchReal& w)
+{
+	x = vld1q_f32(p[0]);
+	y = vld1q_f32(p[1]);
+	z = vld1q_f32(p[2]);
+	w = vld1q_f32(p[3]);
+	btBatchTranspose(x, y, z, w);
+}
+
+static SIMD_FORCE_INLINE void btBatchScatter(btScalar* const* p, btBatchReal x, btBatchReal y, btBatchReal z, btBatchReal w)
+{
+	btBatchTranspose(x, y, z, w);
+	vst1q_f32(p[0], x);
+	vst1q_f32(p[1], y);
+	vst1q_f32(p[2], z);
+	vst1q_f32(p[3], w);
+}
+
+#else //BT_BATCH_SCALAR
+
+struct btBatchReal
+{
+	btScalar	m_lanes[BT_BATCH_WIDTH];
+};
+
+static SIMD_FORCE_INLINE btBatchReal btBatchLoad(const btScalar* p)
+{
+	btBatchReal r;
+	for (int i = 0; i < BT_BATCH_WIDTH; i++) r.m_lanes[i] = p[i];
+	return r;
+}
+static SIMD_FORCE_INLINE void btBatchStore(btScalar* p, const btBatchReal& a)
+{
+	for (int i = 0; i < BT_BATCH_WIDTH; i++) p[i] = a.m_lanes[i];
+}
+static SIMD_FORCE_INLINE btBatchReal btBatchSplat(btScalar a)
+{
+	btBatchReal r;
+	for (int i = 0; i < BT_BATCH_WIDTH; i++) r.m_lanes[i] = a;
+	return r;
+}
+static SIMD_FORCE_INLINE btBatchReal btBatchAdd(const btBatchReal& a, const btBatchReal& b)
+{
+	btBatchReal r;
+	for (int i = 0; i < BT_BATCH_WIDTH; i++) r.m_lanes[i] = a.m_lanes[i] + b.m_lanes[i];
+	return r;
+}
+static SIMD_FORCE_INLINE btBatchReal btBatchSub(const btBatchReal& a, const btBatchReal& b)
+{
+	btBatchReal r;
+	for (int i = 0; i < BT_BATCH_WIDTH; i++) r.m_lanes[i] = a.m_lanes[i] - b.m_lanes[i];
+	return r;
+}
+static SIMD_FORCE_INLINE btBatchReal btBatchMul(const btBatchReal& a, const btBatchReal& b)
+{
+	btBatchReal r;
+	for (int i = 0; i < BT_BATCH_WIDTH; i++) r.m_lanes[i] = a.m_lanes[i] * b.m_lanes[i];
+	return r;
+}
+///a < b ? c : d
+static SIMD_FORCE_INLINE btBatchReal btBatchSelectLess(const btBatchReal& a, const btBatchReal& b, const btBatchReal& c, const btBatchReal& d)
+{
+	btBatchReal r;
+	for (int i = 0; i < BT_BATCH_WIDTH; i++) r.m_lanes[i] = a.m_lanes[i] < b.m_lanes[i] ? c.m_lanes[i] : d.m_lanes[i];
+	return r;
+}
+
+static SIMD_FORCE_INLINE void btBatchGather(const btScalar* const* p, btBatchReal& x, btBatchReal& y, btBatchReal& z, btBatchReal& w)
+{
+	for (int i = 0; i < BT_BATCH_WIDTH; i++)
+	{
+		x.m_lanes[i] = p[i][0];
+		y.m_lanes[i] = p[i][1];
+		z.m_lanes[i] = p[i][2];
+		w.m_lanes[i] = p[i][3];
+	}
+}
+
+static SIMD_FORCE_INLINE void btBatchScatter(btScalar* const* p, const btBatchReal& x, const btBatchReal& y, const btBatchReal& z, const btBatchReal& w)
+{
+	for (int i = 0; i < BT_BATCH_WIDTH; i++)
+	{
+		p[i][0] = x.m_lanes[i];
+		p[i][1] = y.m_lanes[i];
+		p[i][2] = z.m_lanes[i];
+		p[i][3] = w.m_lanes[i];
+	}
+}
+
+#endif
+
+///velocity change of both bodies of a batch, gathered before and scattered back after the rows are solved
+struct btBatchBodyDeltas
+{
+	btScalar*	m_linearA[BT_BATCH_WIDTH];
+	btScalar*	m_angularA[BT_BATCH_WIDTH];
+	btScalar*	m_linearB[BT_BATCH_WIDTH];
+	btScalar*	m_angularB[BT_BATCH_WIDTH];
+
+	btBatchReal	m_lax, m_lay, m_laz, m_law;
+	btBatchReal	m_aax, m_aay, m_aaz, m_aaw;
+	btBatchReal	m_lbx, m_lby, m_lbz, m_lbw;
+	btBatchReal	m_abx, m_aby, m_abz, m_abw;
+
+	SIMD_FORCE_INLINE void	gather(btAlignedObjectArray<btSolverBody>& bodies, const btBatchedSolverRows& rows)
+	{
+		for (int i = 0; i < BT_BATCH_WIDTH; i++)
+		{
+			btSolverBody& bodyA = bodies[rows.m_solverBodyIdA[i]];
+			btSolverBody& bodyB = bodies[rows.m_solverBodyIdB[i]];
+			m_linearA[i] = bodyA.internalGetDeltaLinearVelocity();
+			m_angularA[i] = bodyA.internalGetDeltaAngularVelocity();
+			m_linearB[i] = bodyB.internalGetDeltaLinearVelocity();
+			m_angularB[i] = bodyB.internalGetDeltaAngularVelocity();
+		}
+		btBatchGather(m_linearA, m_lax, m_lay, m_laz, m_law);
+		btBatchGather(m_angularA, m_aax, m_aay, m_aaz, m_aaw);
+		btBatchGather(m_linearB, m_lbx, m_lby, m_lbz, m_lbw);
+		btBatchGather(m_angularB, m_abx, m_aby, m_abz, m_abw);
+	}
+
+	///normal . delta velocity of A plus the same for B, the relative velocity change along the rows
+	SIMD_FORCE_INLINE btBatchReal	relativeVelocity(const btBatchedSolverRows& rows) const
+	{
+		btBatchReal v = btBatchMul(btBatchLoad(rows.m_normalA[0]), m_lax);
+		v = btBatchAdd(v, btBatchMul(btBatchLoad(rows.m_normalA[1]), m_lay));
+		v = btBatchAdd(v, btBatchMul(btBatchLoad(rows.m_normalA[2]), m_laz));
+		v = btBatchAdd(v, btBatchMul(btBatchLoad(rows.m_crossA[0]), m_aax));
+		v = btBatchAdd(v, btBatchMul(btBatchLoad(rows.m_crossA[1]), m_aay));
+		v = btBatchAdd(v, btBatchMul(btBatchLoad(rows.m_crossA[2]), m_aaz));
+		v = btBatchAdd(v, btBatchMul(btBatchLoad(rows.m_normalB[0]), m_lbx));
+		v = btBatchAdd(v, btBatchMul(btBatchLoad(rows.m_normalB[1]), m_lby));
+		v = btBatchAdd(v, btBatchMul(btBatchLoad(rows.m_normalB[2]), m_lbz));
+		v = btBatchAdd(v, btBatchMul(btBatchLoad(rows.m_crossB[0]), m_abx));
+		v = btBatchAdd(v, btBatchMul(btBatchLoad(rows.m_crossB[1]), m_aby));
+		v = btBatchAdd(v, btBatchMul(btBatchLoad(rows.m_crossB[2]), m_abz));
+		return v;
+	}
+
+	SIMD_FORCE_INLINE void	applyAndScatter(const btBatchedSolverRows& rows, const btBatchReal& deltaImpulse)
+	{
+		m_lax = btBatchAdd(m_lax, btBatchMul(btBatchLoad(rows.m_linearA[0]), deltaImpulse));
+		m_lay = btBatchAdd(m_lay, btBatchMul(btBatchLoad(rows.m_linearA[1]), deltaImpulse));
+		m_laz = btBatchAdd(m_laz, btBatchMul(btBatchLoad(rows.m_linearA[2]), deltaImpulse));
+		m_aax = btBatchAdd(m_aax, btBatchMul(btBatchLoad(rows.m_angularA[0]), deltaImpulse));
+		m_aay = btBatchAdd(m_aay, btBatchMul(btBatchLoad(rows.m_angularA[1]), deltaImpulse));
+		m_aaz = btBatchAdd(m_aaz, btBatchMul(btBatchLoad(rows.m_angularA[2]), deltaImpulse));
+		m_lbx = btBatchAdd(m_lbx, btBatchMul(btBatchLoad(rows.m_linearB[0]), deltaImpulse));
+		m_lby = btBatchAdd(m_lby, btBatchMul(btBatchLoad(rows.m_linearB[1]), deltaImpulse));
+		m_lbz = btBatchAdd(m_lbz, btBatchMul(btBatchLoad(rows.m_linearB[2]), deltaImpulse));
+		m_abx = btBatchAdd(m_abx, btBatchMul(btBatchLoad(rows.m_angularB[0]), deltaImpulse));
+		m_aby = btBatchAdd(m_aby, btBatchMul(btBatchLoad(rows.m_angularB[1]), deltaImpulse));
+		m_abz = btBatchAdd(m_abz, btBatchMul(btBatchLoad(rows.m_angularB[2]), deltaImpulse));
+
+		//lanes that share the fixed or the padding body write back the unchanged velocity, so the order of the stores doesn't matter
+		btBatchScatter(m_linearA, m_lax, m_lay, m_laz, m_law);
+		btBatchScatter(m_angularA, m_aax, m_aay, m_aaz, m_aaw);
+		btBatchScatter(m_linearB, m_lbx, m_lby, m_lbz, m_lbw);
+		btBatchScatter(m_angularB, m_abx, m_aby, m_abz, m_abw);
+	}
+};
+
+static SIMD_FORCE_INLINE btScalar btBatchSum(const btBatchReal& a)
+{
+	ATTRIBUTE_ALIGNED16(btScalar lanes[BT_BATCH_WIDTH]);
+	btBatchStore(lanes, a);
+	btScalar sum = 0.f;
+	for (int i = 0; i < BT_BATCH_WIDTH; i++)
+	{
+		sum += lanes[i];
+	}
+	return sum;
+}
+
+
+
+btBatchedConstraintSolver::btBatchedConstraintSolver()
+:m_paddingBodyId(-1),
+m_batched(false),
+m_minBatchedRows(4*BT_BATCH_WIDTH)
+{
+}
+
+
+void	btBatchedConstraintSolver::buildBatches(const btConstraintArray& pool, bool friction, btAlignedObjectArray<btBatchedSolverRows>& batches, btAlignedObjectArray<int>& scalarRows)
+{
+	const int maxColours = 32;
+	int numRows = pool.size();
+
+	batches.resizeNoInitialize(0);
+	scalarRows.resizeNoInitialize(0);
+
+	m_bodyColours.resize(m_tmpSolverBodyPool.size());
+	for (int i = 0; i < m_bodyColours.size(); i++)
+	{
+		m_bodyColours[i] = 0;
+	}
+	m_rowColours.resizeNoInitialize(numRows);
+	if (!friction)
+	{
+		m_contactSlots.resize(numRows);
+		for (int r = 0; r < numRows; r++)
+		{
+			m_contactSlots[r] = -1;
+		}
+	}
+	m_colourBatches.resize(maxColours);
+	for (int c = 0; c < maxColours; c++)
+	{
+		m_colourBatches[c] = 0;
+	}
+
+	//greedy colouring in pool order, each row takes the lowest colour neither of its dynamic bodies has yet
+	for (int r = 0; r < numRows; r++)
+	{
+		int bodyIdA = pool[r].m_solverBodyIdA;
+		int bodyIdB = pool[r].m_solverBodyIdB;
+		//every static object is the one fixed body, it never changes velocity so any number of rows of a batch may use it
+		bool sharedA = bodyIdA == m_fixedBodyId;
+		bool sharedB = bodyIdB == m_fixedBodyId;
+		unsigned int used = (sharedA ? 0u : m_bodyColours[bodyIdA]) | (sharedB ? 0u : m_bodyColours[bodyIdB]);
+
+		int colour = 0;
+		while (colour < maxColours && (used & (1u << colour)))
+		{
+			colour++;
+		}
+		m_rowColours[r] = colour;
+		if (colour == maxColours)
+		{
+			scalarRows.push_back(r);
+			continue;
+		}
+		if (!sharedA)
+			m_bodyColours[bodyIdA] |= 1u << colour;
+		if (!sharedB)
+			m_bodyColours[bodyIdB] |= 1u << colour;
+		m_colourBatches[colour]++;
+	}
+
+	//row counts become the first slot of each colour, a colour starts a new batch
+	int numBatches = 0;
+	for (int c = 0; c < maxColours; c++)
+	{
+		int rows = m_colourBatches[c];
+		m_colourBatches[c] = numBatches * BT_BATCH_WIDTH;
+		numBatches += (rows + BT_BATCH_WIDTH - 1) / BT_BATCH_WIDTH;
+	}
+
+	batches.resizeNoInitialize(numBatches);
+	for (int b = 0; b < numBatches; b++)
+	{
+		btBatchedSolverRows& rows = batches[b];
+		memset(&rows, 0, sizeof(btBatchedSolverRows));
+		for (int i = 0; i < BT_BATCH_WIDTH; i++)
+		{
+			rows.m_solverBodyIdA[i] = m_paddingBodyId;
+			rows.m_solverBodyIdB[i] = m_paddingBodyId;
+			rows.m_row[i] = -1;
+			rows.m_frictionIndex[i] = -1;
+		}
+	}
+
+	for (int r = 0; r < numRows; r++)
+	{
+		int colour = m_rowColours[r];
+		if (colour == maxColours)
+			continue;
+
+		int slot = m_colourBatches[colour]++;
+		btBatchedSolverRows& rows = batches[slot / BT_BATCH_WIDTH];
+		int lane = slot % BT_BATCH_WIDTH;
+		if (!friction)
+			m_contactSlots[r] = slot;
+
+		const btSolverConstraint& c = pool[r];
+		const btSolverBody& bodyA = m_tmpSolverBodyPool[c.m_solverBodyIdA];
+		const btSolverBody& bodyB = m_tmpSolverBodyPool[c.m_solverBodyIdB];
+
+		//same factors as btSolverBody::internalApplyImpulse, which does nothing to bodies without a rigid body
+		btVector3 linearA = bodyA.m_originalBody ? c.m_contactNormal1*bodyA.internalGetInvMass()*bodyA.m_linearFactor : btVector3(0,0,0);
+		btVector3 angularA = bodyA.m_originalBody ? c.m_angularComponentA*bodyA.m_angularFactor : btVector3(0,0,0);
+		btVector3 linearB = bodyB.m_originalBody ? c.m_contactNormal2*bodyB.internalGetInvMass()*bodyB.m_linearFactor : btVector3(0,0,0);
+		btVector3 angularB = bodyB.m_originalBody ? c.m_angularComponentB*bodyB.m_angularFactor : btVector3(0,0,0);
+
+		for (int k = 0; k < 3; k++)
+		{
+			rows.m_linearA[k][lane] = linearA[k];
+			rows.m_normalA[k][lane] = c.m_contactNormal1[k];
+			rows.m_crossA[k][lane] = c.m_relpos1CrossNormal[k];
+			rows.m_angularA[k][lane] = angularA[k];
+			rows.m_linearB[k][lane] = linearB[k];
+			rows.m_normalB[k][lane] = c.m_contactNormal2[k];
+			rows.m_crossB[k][lane] = c.m_relpos2CrossNormal[k];
+			rows.m_angularB[k][lane] = angularB[k];
+		}
+		rows.m_rhs[lane] = c.m_rhs;
+		rows.m_cfm[lane] = c.m_cfm;
+		rows.m_jacDiagABInv[lane] = c.m_jacDiagABInv;
+		rows.m_lowerLimit[lane] = c.m_lowerLimit;
+		rows.m_friction[lane] = c.m_friction;
+		rows.m_appliedImpulse[lane] = c.m_appliedImpulse;
+		rows.m_solverBodyIdA[lane] = c.m_solverBodyIdA;
+		rows.m_solverBodyIdB[lane] = c.m_solverBodyIdB;
+		rows.m_row[lane] = r;
+		rows.m_frictionIndex[lane] = friction ? c.m_frictionIndex : -1;
+	}
+}
+
+
+btScalar btBatchedConstraintSolver::solveGroupCacheFriendlySetup(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer)
+{
+	btSequentialImpulseConstraintSolver::solveGroupCacheFriendlySetup(bodies, numBodies, manifoldPtr, numManifolds, constraints, numConstraints, infoGlobal, debugDrawer);
+
+	m_batched = !(infoGlobal.m_solverMode & (SOLVER_RANDMIZE_ORDER | SOLVER_INTERLEAVE_CONTACT_AND_FRICTION_CONSTRAINTS)) &&
+		m_tmpSolverContactConstraintPool.size() >= m_minBatchedRows;
+
+	m_contactBatches.resizeNoInitialize(0);
+	m_frictionBatches.resizeNoInitialize(0);
+	m_scalarContactRows.resizeNoInitialize(0);
+	m_scalarFrictionRows.resizeNoInitialize(0);
+
+	if (m_batched)
+	{
+		BT_PROFILE("buildBatches");
+
+		//unused lanes read and write this body, it has no rigid body so solveGroupCacheFriendlyFinish skips it
+		m_paddingBodyId = m_tmpSolverBodyPool.size();
+		btSolverBody& padding = m_tmpSolverBodyPool.expandNonInitializing();
+		initSolverBody(&padding, 0, infoGlobal.m_timeStep);
+
+		buildBatches(m_tmpSolverContactConstraintPool, false, m_contactBatches, m_scalarContactRows);
+		buildBatches(m_tmpSolverContactFrictionConstraintPool, true, m_frictionBatches, m_scalarFrictionRows);
+	}
+	return 0.f;
+}
+
+
+btScalar btBatchedConstraintSolver::solveContactBatches()
+{
+	btBatchReal residual = btBatchSplat(0.f);
+	btBatchBodyDeltas deltas;
+
+	for (int b = 0; b < m_contactBatches.size(); b++)
+	{
+		btBatchedSolverRows& rows = m_contactBatches[b];
+		deltas.gather(m_tmpSolverBodyPool, rows);
+
+		btBatchReal appliedImpulse = btBatchLoad(rows.m_appliedImpulse);
+		btBatchReal lowerLimit = btBatchLoad(rows.m_lowerLimit);
+		btBatchReal deltaImpulse = btBatchSub(btBatchLoad(rows.m_rhs), btBatchMul(appliedImpulse, btBatchLoad(rows.m_cfm)));
+		deltaImpulse = btBatchSub(deltaImpulse, btBatchMul(deltas.relativeVelocity(rows), btBatchLoad(rows.m_jacDiagABInv)));
+
+		btBatchReal sum = btBatchAdd(appliedImpulse, deltaImpulse);
+		deltaImpulse = btBatchSelectLess(sum, lowerLimit, btBatchSub(lowerLimit, appliedImpulse), deltaImpulse);
+		btBatchStore(rows.m_appliedImpulse, btBatchSelectLess(sum, lowerLimit, lowerLimit, sum));
+		residual = btBatchAdd(residual, btBatchMul(deltaImpulse, deltaImpulse));
+
+		deltas.applyAndScatter(rows, deltaImpulse);
+	}
+	return btBatchSum(residual);
+}
+
+
+btScalar btBatchedConstraintSolver::solveFrictionBatches()
+{
+	btBatchReal residual = btBatchSplat(0.f);
+	btBatchReal zero = btBatchSplat(0.f);
+	btBatchBodyDeltas deltas;
+	ATTRIBUTE_ALIGNED16(btScalar totalImpulses[BT_BATCH_WIDTH]);
+
+	for (int b = 0; b < m_frictionBatches.size(); b++)
+	{
+		btBatchedSolverRows& rows = m_frictionBatches[b];
+		for (int i = 0; i < BT_BATCH_WIDTH; i++)
+		{
+			int frictionIndex = rows.m_frictionIndex[i];
+			totalImpulses[i] = frictionIndex >= 0 ? getContactImpulse(frictionIndex) : btScalar(0);
+		}
+		deltas.gather(m_tmpSolverBodyPool, rows);
+
+		//like the scalar solver, rows whose contact pushes nothing are left as they are
+		btBatchReal totalImpulse = btBatchLoad(totalImpulses);
+		btBatchReal upperLimit = btBatchMul(btBatchLoad(rows.m_friction), totalImpulse);
+		btBatchReal lowerLimit = btBatchSub(zero, upperLimit);
+
+		btBatchReal appliedImpulse = btBatchLoad(rows.m_appliedImpulse);
+		btBatchReal deltaImpulse = btBatchSub(btBatchLoad(rows.m_rhs), btBatchMul(appliedImpulse, btBatchLoad(rows.m_cfm)));
+		deltaImpulse = btBatchSub(deltaImpulse, btBatchMul(deltas.relativeVelocity(rows), btBatchLoad(rows.m_jacDiagABInv)));
+
+		btBatchReal sum = btBatchAdd(appliedImpulse, deltaImpulse);
+		deltaImpulse = btBatchSelectLess(sum, lowerLimit, btBatchSub(lowerLimit, appliedImpulse), deltaImpulse);
+		deltaImpulse = btBatchSelectLess(upperLimit, sum, btBatchSub(upperLimit, appliedImpulse), deltaImpulse);
+		sum = btBatchSelectLess(sum, lowerLimit, lowerLimit, sum);
+		sum = btBatchSelectLess(upperLimit, sum, upperLimit, sum);
+
+		deltaImpulse = btBatchSelectLess(zero, totalImpulse, deltaImpulse, zero);
+		btBatchStore(rows.m_appliedImpulse, btBatchSelectLess(zero, totalImpulse, sum, appliedImpulse));
+		residual = btBatchAdd(residual, btBatchMul(deltaImpulse, deltaImpulse));
+
+		deltas.applyAndScatter(rows, deltaImpulse);
+	}
+	return btBatchSum(residual);
+}
+
+
+btScalar btBatchedConstraintSolver::solveSingleIteration(int iteration, btCollisionObject** bodies ,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer)
+{
+	if (!m_batched)
+	{
+		return btSequentialImpulseConstraintSolver::solveSingleIteration(iteration, bodies, numBodies, manifoldPtr, numManifolds, constraints, numConstraints, infoGlobal, debugDrawer);
+	}
+
+	btScalar leastSquaresResidual = 0.f;
+
+	///solve all joint constraints
+	for (int j=0;j<m_tmpSolverNonContactConstraintPool.size();j++)
+	{
+		btSolverConstraint& constraint = m_tmpSolverNonContactConstraintPool[m_orderNonContactConstraintPool[j]];
+		if (iteration < constraint.m_overrideNumSolverIterations)
+		{
+			btScalar residual = resolveSingleConstraintRowGeneric(m_tmpSolverBodyPool[constraint.m_solverBodyIdA],m_tmpSolverBodyPool[constraint.m_solverBodyIdB],constraint);
+			leastSquaresResidual += residual*residual;
+		}
+	}
+
+	if (iteration< infoGlobal.m_numIterations)
+	{
+		for (int j=0;j<numConstraints;j++)
+		{
+			if (constraints[j]->isEnabled())
+			{
+				int bodyAid = getOrInitSolverBody(constraints[j]->getRigidBodyA(),infoGlobal.m_timeStep);
+				int bodyBid = getOrInitSolverBody(constraints[j]->getRigidBodyB(),infoGlobal.m_timeStep);
+				btSolverBody& bodyA = m_tmpSolverBodyPool[bodyAid];
+				btSolverBody& bodyB = m_tmpSolverBodyPool[bodyBid];
+				constraints[j]->solveConstraintObsolete(bodyA,bodyB,infoGlobal.m_timeStep);
+			}
+		}
+
+		///solve all contact constraints, then all friction constraints
+		leastSquaresResidual += solveContactBatches();
+		for (int j=0;j<m_scalarContactRows.size();j++)
+		{
+			const btSolverConstraint& solveManifold = m_tmpSolverContactConstraintPool[m_scalarContactRows[j]];
+			btScalar residual = resolveSingleConstraintRowLowerLimit(m_tmpSolverBodyPool[solveManifold.m_solverBodyIdA],m_tmpSolverBodyPool[solveManifold.m_solverBodyIdB],solveManifold);
+			leastSquaresResidual += residual*residual;
+		}
+
+		leastSquaresResidual += solveFrictionBatches();
+		for (int j=0;j<m_scalarFrictionRows.size();j++)
+		{
+			btSolverConstraint& solveManifold = m_tmpSolverContactFrictionConstraintPool[m_scalarFrictionRows[j]];
+			btScalar totalImpulse = getContactImpulse(solveManifold.m_frictionIndex);
+
+			if (totalImpulse>btScalar(0))
+			{
+				solveManifold.m_lowerLimit = -(solveManifold.m_friction*totalImpulse);
+				solveManifold.m_upperLimit = solveManifold.m_friction*totalImpulse;
+
+				btScalar residual = resolveSingleConstraintRowGeneric(m_tmpSolverBodyPool[solveManifold.m_solverBodyIdA],m_tmpSolverBodyPool[solveManifold.m_solverBodyIdB],solveManifold);
+				leastSquaresResidual += residual*residual;
+			}
+		}
+
+		int numRollingFrictionPoolConstraints = m_tmpSolverContactRollingFrictionConstraintPool.size();
+		for (int j=0;j<numRollingFrictionPoolConstraints;j++)
+		{
+			btSolverConstraint& rollingFrictionConstraint = m_tmpSolverContactRollingFrictionConstraintPool[j];
+			btScalar totalImpulse = getContactImpulse(rollingFrictionConstraint.m_frictionIndex);
+			if (totalImpulse>btScalar(0))
+			{
+				btScalar rollingFrictionMagnitude = rollingFrictionConstraint.m_friction*totalImpulse;
+				if (rollingFrictionMagnitude>rollingFrictionConstraint.m_friction)
+					rollingFrictionMagnitude = rollingFrictionConstraint.m_friction;
+
+				rollingFrictionConstraint.m_lowerLimit = -rollingFrictionMagnitude;
+				rollingFrictionConstraint.m_upperLimit = rollingFrictionMagnitude;
+
+				btScalar residual = resolveSingleConstraintRowGeneric(m_tmpSolverBodyPool[rollingFrictionConstraint.m_solverBodyIdA],m_tmpSolverBodyPool[rollingFrictionConstraint.m_solverBodyIdB],rollingFrictionConstraint);
+				leastSquaresResidual += residual*residual;
+			}
+		}
+	}
+	return leastSquaresResidual;
+}
+
+
+btScalar btBatchedConstraintSolver::solveGroupCacheFriendlyFinish(btCollisionObject** bodies,int numBodies,const btContactSolverInfo& infoGlobal)
+{
+	//the impulses of batched rows only live in the batches
+	for (int b = 0; b < m_contactBatches.size(); b++)
+	{
+		const btBatchedSolverRows& rows = m_contactBatches[b];
+		for (int i = 0; i < BT_BATCH_WIDTH; i++)
+		{
+			if (rows.m_row[i] >= 0)
+			{
+				m_tmpSolverContactConstraintPool[rows.m_row[i]].m_appliedImpulse = rows.m_appliedImpulse[i];
+			}
+		}
+	}
+	for (int b = 0; b < m_frictionBatches.size(); b++)
+	{
+		const btBatchedSolverRows& rows = m_frictionBatches[b];
+		for (int i = 0; i < BT_BATCH_WIDTH; i++)
+		{
+			if (rows.m_row[i] >= 0)
+			{
+				m_tmpSolverContactFrictionConstraintPool[rows.m_row[i]].m_appliedImpulse = rows.m_appliedImpulse[i];
+			}
+		}
+	}
+	m_batched = false;
+
+	return btSequentialImpulseConstraintSolver::solveGroupCacheFriendlyFinish(bodies, numBodies, infoGlobal);
+}
+
+
+#pragma clang diagnostic pop
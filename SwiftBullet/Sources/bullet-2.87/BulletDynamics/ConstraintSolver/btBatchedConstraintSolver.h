@@ -0,0 +1,145 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_BATCHED_CONSTRAINT_SOLVER_H
+#define BT_BATCHED_CONSTRAINT_SOLVER_H
+
+#include "btSequentialImpulseConstraintSolver.h"
+
+///number of rows solved at once, 8 when the compiler targets AVX
+#if defined (__AVX__) && !defined (BT_USE_DOUBLE_PRECISION)
+#define BT_BATCHED_SOLVER_WIDTH 8
+#else
+#define BT_BATCHED_SOLVER_WIDTH 4
+#endif
+
+///Up to BT_BATCHED_SOLVER_WIDTH contact or friction rows that don't share a dynamic body, stored field by field.
+///Unused lanes point at a padding body and have all coefficients zero
+ATTRIBUTE_ALIGNED16(struct) btBatchedSolverRows
+{
+	btScalar	m_linearA[3][BT_BATCHED_SOLVER_WIDTH];	//contact normal times inverse mass and linear factor of body A
+	btScalar	m_normalA[3][BT_BATCHED_SOLVER_WIDTH];
+	btScalar	m_crossA[3][BT_BATCHED_SOLVER_WIDTH];
+	btScalar	m_angularA[3][BT_BATCHED_SOLVER_WIDTH];
+	btScalar	m_linearB[3][BT_BATCHED_SOLVER_WIDTH];
+	btScalar	m_normalB[3][BT_BATCHED_SOLVER_WIDTH];
+	btScalar	m_crossB[3][BT_BATCHED_SOLVER_WIDTH];
+	btScalar	m_angularB[3][BT_BATCHED_SOLVER_WIDTH];
+
+	btScalar	m_rhs[BT_BATCHED_SOLVER_WIDTH];
+	btScalar	m_cfm[BT_BATCHED_SOLVER_WIDTH];
+	btScalar	m_jacDiagABInv[BT_BATCHED_SOLVER_WIDTH];
+	btScalar	m_lowerLimit[BT_BATCHED_SOLVER_WIDTH];
+	btScalar	m_friction[BT_BATCHED_SOLVER_WIDTH];
+	btScalar	m_appliedImpulse[BT_BATCHED_SOLVER_WIDTH];
+
+	int			m_solverBodyIdA[BT_BATCHED_SOLVER_WIDTH];
+	int			m_solverBodyIdB[BT_BATCHED_SOLVER_WIDTH];
+	int			m_row[BT_BATCHED_SOLVER_WIDTH];				//index into the constraint pool, -1 for padding
+	int			m_frictionIndex[BT_BATCHED_SOLVER_WIDTH];	//contact row limiting a friction row, -1 for padding
+};
+
+///btBatchedConstraintSolver solves the same rows as btSequentialImpulseConstraintSolver, but colours contact and friction
+///rows so that no two rows of a colour share a dynamic body, and solves each colour BT_BATCHED_SOLVER_WIDTH rows at a time
+///with SSE, AVX or NEON. Joints, rolling friction, split impulse and rows left over by the colouring stay scalar.
+///Rows are solved colour by colour rather than in pool order, and SOLVER_RANDMIZE_ORDER and
+///SOLVER_INTERLEAVE_CONTACT_AND_FRICTION_CONSTRAINTS fall back to the scalar solver
+ATTRIBUTE_ALIGNED16(class) btBatchedConstraintSolver : public btSequentialImpulseConstraintSolver
+{
+protected:
+
+	btAlignedObjectArray<btBatchedSolverRows>	m_contactBatches;
+	btAlignedObjectArray<btBatchedSolverRows>	m_frictionBatches;
+	btAlignedObjectArray<int>	m_scalarContactRows;
+	btAlignedObjectArray<int>	m_scalarFrictionRows;
+	btAlignedObjectArray<int>	m_contactSlots;	//batch times width plus lane of each contact row, -1 when it is solved scalar
+
+	btAlignedObjectArray<unsigned int>	m_bodyColours;	//bit c is set when a row of colour c uses the body
+	btAlignedObjectArray<int>	m_rowColours;
+	btAlignedObjectArray<int>	m_colourBatches;
+
+	int		m_paddingBodyId;
+	bool	m_batched;
+	int		m_minBatchedRows;
+
+	void	buildBatches(const btConstraintArray& pool, bool friction, btAlignedObjectArray<btBatchedSolverRows>& batches, btAlignedObjectArray<int>& scalarRows);
+
+	///normal impulse of a contact row so far, it lives in the batches until solveGroupCacheFriendlyFinish
+	btScalar	getContactImpulse(int contactRow) const
+	{
+		int slot = m_contactSlots[contactRow];
+		if (slot < 0)
+			return m_tmpSolverContactConstraintPool[contactRow].m_appliedImpulse;
+		return m_contactBatches[slot / BT_BATCHED_SOLVER_WIDTH].m_appliedImpulse[slot % BT_BATCHED_SOLVER_WIDTH];
+	}
+
+	btScalar	solveContactBatches();
+	btScalar	solveFrictionBatches();
+
+	virtual btScalar solveGroupCacheFriendlySetup(btCollisionObject** bodies,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer);
+	virtual btScalar solveSingleIteration(int iteration, btCollisionObject** bodies ,int numBodies,btPersistentManifold** manifoldPtr, int numManifolds,btTypedConstraint** constraints,int numConstraints,const btContactSolverInfo& infoGlobal,btIDebugDraw* debugDrawer);
+	virtual btScalar solveGroupCacheFriendlyFinish(btCollisionObject** bodies,int numBodies,const btContactSolverInfo& infoGlobal);
+
+public:
+
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btBatchedConstraintSolver();
+
+	virtual btConstraintSolverType getSolverType() const
+	{
+		return BT_BATCHED_SOLVER;
+	}
+
+	///groups with fewer contact rows are solved by the scalar solver, colouring them doesn't pay off
+	void	setMinBatchedRows(int minBatchedRows)
+	{
+		m_minBatchedRows = minBatchedRows;
+	}
+	int		getMinBatchedRows() const
+	{
+		return m_minBatchedRows;
+	}
+
+	///batches and leftover rows of the last group solved, for statistics
+	int		getNumContactBatches() const
+	{
+		return m_contactBatches.size();
+	}
+	int		getNumFrictionBatches() const
+	{
+		return m_frictionBatches.size();
+	}
+	int		getNumScalarRows() const
+	{
+		return m_scalarContactRows.size() + m_scalarFrictionRows.size();
+	}
+};
+
+#endif //BT_BATCHED_CONSTRAINT_SOLVER_H
+
+
+#pragma clang diagnostic pop
@@ -39,6 +39,8 @@ subject to the following restrictions:
 #include <new>
 #include "LinearMath/btStackAlloc.h"
 #include "LinearMath/btQuickprof.h"
+#include "LinearMath/btTraceProfiler.h"
+#include "LinearMath/btMemoryTracker.h"
 //#include "btSolverBody.h"
 //#include "btSolverConstraint.h"
 #include "LinearMath/btAlignedObjectArray.h"
@@ -1867,6 +1869,7 @@ btScalar btSequentialImpulseConstraintSolver::solveGroupCacheFriendlyIterations(
 #ifdef VERBOSE_RESIDUAL_PRINTF
 						printf("residual = %f at iteration #%d\n",m_leastSquaresResidual,iteration);
 #endif
+				BT_PROFILE_COUNT(BT_TRACE_SOLVER_ITERATIONS, iteration + 1);
 				break;
 			}
 		}
@@ -1965,6 +1968,7 @@ btScalar btSequentialImpulseConstraintSolver::solveGroup(btCollisionObject** bod
 {
 
 	BT_PROFILE("solveGroup");
+	BT_MEMORY_TAG(BT_MEMORY_SOLVER);
 	//you need to provide at least some bodies
 
 	solveGroupCacheFriendlySetup( bodies, numBodies, manifoldPtr,  numManifolds,constraints, numConstraints,infoGlobal,debugDrawer);
@@ -0,0 +1,296 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+
+#include "btAsyncStepper.h"
+#include "btDiscreteDynamicsWorld.h"
+#include "btRigidBody.h"
+#include "LinearMath/btMotionState.h"
+
+btAsyncStepper::btAsyncStepper(btDiscreteDynamicsWorld* world)
+:m_world(world),
+m_queueIndex(0),
+m_numSlots(0),
+m_stepping(false),
+m_timeStep(0),
+m_maxSubSteps(1),
+m_fixedTimeStep(btScalar(1.) / btScalar(60.)),
+m_stepIndex(0),
+m_latest(1),
+m_writeIndex(2),
+m_readIndex(0),
+m_runIndex(1),
+m_hasWork(false),
+m_exit(false)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		m_frames[i].m_numSubSteps = 0;
+		m_frames[i].m_stepIndex = 0;
+	}
+	m_thread = std::thread(&btAsyncStepper::threadMain, this);
+}
+
+btAsyncStepper::~btAsyncStepper()
+{
+	waitForStep();
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_exit = true;
+	}
+	m_startCondition.notify_one();
+	m_thread.join();
+}
+
+void	btAsyncStepper::beginStep(btScalar timeStep, int maxSubSteps, btScalar fixedTimeStep)
+{
+	waitForStep();
+
+	m_timeStep = timeStep;
+	m_maxSubSteps = maxSubSteps;
+	m_fixedTimeStep = fixedTimeStep;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_runIndex = m_queueIndex;
+		m_hasWork = true;
+	}
+	m_queueIndex ^= 1;
+	m_stepping = true;
+	m_startCondition.notify_one();
+}
+
+void	btAsyncStepper::waitForStep()
+{
+	if (!m_stepping)
+		return;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_hasWork)
+	{
+		m_doneCondition.wait(lock);
+	}
+	m_stepping = false;
+}
+
+void	btAsyncStepper::threadMain()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;)
+	{
+		while (!m_hasWork && !m_exit)
+		{
+			m_startCondition.wait(lock);
+		}
+		if (m_exit)
+			break;
+		lock.unlock();
+
+		runCommands(m_commands[m_runIndex]);
+		int numSubSteps = m_world->stepSimulation(m_timeStep, m_maxSubSteps, m_fixedTimeStep);
+		writeFrame(numSubSteps);
+
+		lock.lock();
+		m_hasWork = false;
+		m_doneCondition.notify_all();
+	}
+}
+
+void	btAsyncStepper::runCommands(btAlignedObjectArray<Command>& commands)
+{
+	for (int i = 0; i < commands.size(); i++)
+	{
+		const Command& command = commands[i];
+		btRigidBody* body = command.m_body;
+
+		switch (command.m_type)
+		{
+		case APPLY_CENTRAL_FORCE:
+			body->applyCentralForce(command.m_transform.getOrigin());
+			body->activate(true);
+			break;
+		case APPLY_CENTRAL_IMPULSE:
+			body->applyCentralImpulse(command.m_transform.getOrigin());
+			body->activate(true);
+			break;
+		case SET_LINEAR_VELOCITY:
+			body->setLinearVelocity(command.m_transform.getOrigin());
+			body->activate(true);
+			break;
+		case SET_WORLD_TRANSFORM:
+			body->setCenterOfMassTransform(command.m_transform);
+			if (body->getMotionState())
+				body->getMotionState()->setWorldTransform(command.m_transform);
+			if (body->isInWorld())
+				m_world->updateSingleAabb(body);
+			body->activate(true);
+			break;
+		case ADD_RIGID_BODY:
+			m_world->addRigidBody(body, command.m_group, command.m_mask);
+			break;
+		case ADD_RIGID_BODY_DEFAULT_FILTER:
+			m_world->addRigidBody(body);
+			break;
+		case REMOVE_RIGID_BODY:
+			m_world->removeRigidBody(body);
+			break;
+		case SET_SLOT:
+			if (command.m_group >= m_slotBodies.size())
+				m_slotBodies.resize(command.m_group + 1, 0);
+			m_slotBodies[command.m_group] = body;
+			break;
+		case RUN_CALLBACK:
+			command.m_callback(m_world, command.m_userData);
+			break;
+		}
+	}
+	commands.resizeNoInitialize(0);
+}
+
+void	btAsyncStepper::writeFrame(int numSubSteps)
+{
+	Frame& frame = m_frames[m_writeIndex];
+	frame.m_transforms.resize(m_slotBodies.size());
+	frame.m_numSubSteps = numSubSteps;
+	frame.m_stepIndex = ++m_stepIndex;
+
+	for (int i = 0; i < m_slotBodies.size(); i++)
+	{
+		BodyTransform& out = frame.m_transforms[i];
+		btTransform transform = btTransform::getIdentity();
+		const btRigidBody* body = m_slotBodies[i];
+
+		if (body && body->getMotionState())
+			body->getMotionState()->getWorldTransform(transform);
+		else if (body)
+			transform = body->getWorldTransform();
+
+		const btVector3& origin = transform.getOrigin();
+		const btQuaternion rotation = transform.getRotation();
+		out.m_position[0] = origin.x();
+		out.m_position[1] = origin.y();
+		out.m_position[2] = origin.z();
+		out.m_position[3] = btScalar(0.);
+		out.m_rotation[0] = rotation.x();
+		out.m_rotation[1] = rotation.y();
+		out.m_rotation[2] = rotation.z();
+		out.m_rotation[3] = rotation.w();
+	}
+
+	//hand the frame over, take back whichever one the reader isn't holding
+	m_writeIndex = m_latest.exchange(m_writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+}
+
+const btAsyncStepper::Frame&	btAsyncStepper::getFrame()
+{
+	if (m_latest.load(std::memory_order_acquire) & FRESH)
+	{
+		m_readIndex = m_latest.exchange(m_readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+	return m_frames[m_readIndex];
+}
+
+btAsyncStepper::Command&	btAsyncStepper::pushCommand(int type, btRigidBody* body)
+{
+	Command& command = m_commands[m_queueIndex].expandNonInitializing();
+	command.m_type = type;
+	command.m_body = body;
+	command.m_group = 0;
+	command.m_mask = 0;
+	command.m_callback = 0;
+	command.m_userData = 0;
+	return command;
+}
+
+int	btAsyncStepper::addSlot(btRigidBody* body)
+{
+	int slot;
+	if (m_freeSlots.size())
+	{
+		slot = m_freeSlots[m_freeSlots.size() - 1];
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		slot = m_numSlots++;
+	}
+	pushCommand(SET_SLOT, body).m_group = slot;
+	return slot;
+}
+
+void	btAsyncStepper::releaseSlot(int slot)
+{
+	btAssert(slot >= 0 && slot < m_numSlots);
+	pushCommand(SET_SLOT, 0).m_group = slot;
+	m_freeSlots.push_back(slot);
+}
+
+void	btAsyncStepper::applyCentralForce(btRigidBody* body, const btVector3& force)
+{
+	pushCommand(APPLY_CENTRAL_FORCE, body).m_transform.setOrigin(force);
+}
+
+void	btAsyncStepper::applyCentralImpulse(btRigidBody* body, const btVector3& impulse)
+{
+	pushCommand(APPLY_CENTRAL_IMPULSE, body).m_transform.setOrigin(impulse);
+}
+
+void	btAsyncStepper::setLinearVelocity(btRigidBody* body, const btVector3& velocity)
+{
+	pushCommand(SET_LINEAR_VELOCITY, body).m_transform.setOrigin(velocity);
+}
+
+void	btAsyncStepper::setWorldTransform(btRigidBody* body, const btTransform& transform)
+{
+	pushCommand(SET_WORLD_TRANSFORM, body).m_transform = transform;
+}
+
+void	btAsyncStepper::addRigidBody(btRigidBody* body)
+{
+	pushCommand(ADD_RIGID_BODY_DEFAULT_FILTER, body);
+}
+
+void	btAsyncStepper::addRigidBody(btRigidBody* body, int group, int mask)
+{
+	Command& command = pushCommand(ADD_RIGID_BODY, body);
+	command.m_group = group;
+	command.m_mask = mask;
+}
+
+void	btAsyncStepper::removeRigidBody(btRigidBody* body)
+{
+	pushCommand(REMOVE_RIGID_BODY, body);
+}
+
+void	btAsyncStepper::queueCallback(btAsyncStepperCallback callback, void* userData)
+{
+	Command& command = pushCommand(RUN_CALLBACK, 0);
+	command.m_callback = callback;
+	command.m_userData = userData;
+}
+
+
+#pragma clang diagnostic pop
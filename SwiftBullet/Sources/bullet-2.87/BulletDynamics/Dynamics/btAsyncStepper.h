@@ -0,0 +1,191 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+
+#ifndef BT_ASYNC_STEPPER_H
+#define BT_ASYNC_STEPPER_H
+
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+class btDiscreteDynamicsWorld;
+class btRigidBody;
+
+///runs on the stepping thread before the step, for edits that have no command of their own
+typedef void (*btAsyncStepperCallback)(btDiscreteDynamicsWorld* world, void* userData);
+
+///btAsyncStepper steps a btDiscreteDynamicsWorld on a thread of its own, so the next step runs while the caller renders
+///the last one. The caller owns the world only between waitForStep and beginStep: queries, event drains and direct edits
+///go there. Edits made while a step runs are queued as commands, applied in order at the start of the next step.
+///After every step the transforms of the registered bodies are copied into a triple buffer, getFrame reads the newest
+///one without locking and without ever seeing a half written frame, from one reader thread.
+///Parallel loops started on the stepping thread run in place (see btTaskSchedulerNative), step a single-threaded world.
+class btAsyncStepper
+{
+public:
+
+	///position and rotation of one body, laid out as simd_float3 followed by simd_quatf
+	struct BodyTransform
+	{
+		btScalar	m_position[4];
+		btScalar	m_rotation[4]; //x, y, z, w
+	};
+
+	struct Frame
+	{
+		btAlignedObjectArray<BodyTransform>	m_transforms; //by slot, identity for free slots
+		int	m_numSubSteps;
+		unsigned int	m_stepIndex;
+	};
+
+protected:
+
+	enum CommandType
+	{
+		APPLY_CENTRAL_FORCE,
+		APPLY_CENTRAL_IMPULSE,
+		SET_LINEAR_VELOCITY,
+		SET_WORLD_TRANSFORM,
+		ADD_RIGID_BODY,
+		ADD_RIGID_BODY_DEFAULT_FILTER,
+		REMOVE_RIGID_BODY,
+		SET_SLOT,
+		RUN_CALLBACK
+	};
+
+	struct Command
+	{
+		int	m_type;
+		btRigidBody*	m_body;
+		btTransform	m_transform; //origin holds the vector of the force, impulse and velocity commands
+		int	m_group; //also the slot of SET_SLOT
+		int	m_mask;
+		btAsyncStepperCallback	m_callback;
+		void*	m_userData;
+	};
+
+	btDiscreteDynamicsWorld*	m_world;
+
+	//caller side
+	btAlignedObjectArray<Command>	m_commands[2]; //the one being filled flips in beginStep
+	int	m_queueIndex;
+	btAlignedObjectArray<int>	m_freeSlots;
+	int	m_numSlots;
+	bool	m_stepping;
+
+	//stepping thread side
+	btAlignedObjectArray<btRigidBody*>	m_slotBodies;
+	btScalar	m_timeStep;
+	int	m_maxSubSteps;
+	btScalar	m_fixedTimeStep;
+	unsigned int	m_stepIndex;
+
+	//triple buffer, m_latest holds the last published frame and FRESH until the reader swaps it out
+	enum { FRESH = 4, INDEX_MASK = 3 };
+	Frame	m_frames[3];
+	std::atomic<int>	m_latest;
+	int	m_writeIndex;
+	int	m_readIndex;
+
+	std::thread	m_thread;
+	std::mutex	m_mutex;
+	std::condition_variable	m_startCondition;
+	std::condition_variable	m_doneCondition;
+	int	m_runIndex; //commands of the step in flight
+	bool	m_hasWork;
+	bool	m_exit;
+
+	Command&	pushCommand(int type, btRigidBody* body);
+	void	runCommands(btAlignedObjectArray<Command>& commands);
+	void	writeFrame(int numSubSteps);
+	void	threadMain();
+
+public:
+
+	btAsyncStepper(btDiscreteDynamicsWorld* world);
+
+	///waits for the step in flight and stops the thread, the world is left to its owner
+	virtual ~btAsyncStepper();
+
+	///waits for the previous step, then starts stepSimulation with the queued commands on the stepping thread
+	void	beginStep(btScalar timeStep, int maxSubSteps = 1, btScalar fixedTimeStep = btScalar(1.) / btScalar(60.));
+
+	///blocks until the step started by beginStep is done, the world is the caller's again
+	void	waitForStep();
+
+	bool	isStepping() const
+	{
+		return m_stepping;
+	}
+
+	btDiscreteDynamicsWorld*	getWorld()
+	{
+		return m_world;
+	}
+
+	///slot of body in the frames from the next step on, the body keeps it until releaseSlot
+	int	addSlot(btRigidBody* body);
+
+	///frees the slot from the next step on, release it before the body is deleted
+	void	releaseSlot(int slot);
+
+	int	getNumSlots() const
+	{
+		return m_numSlots;
+	}
+
+	///newest finished frame, stays valid until the next call
+	const Frame&	getFrame();
+
+	void	applyCentralForce(btRigidBody* body, const btVector3& force);
+
+	void	applyCentralImpulse(btRigidBody* body, const btVector3& impulse);
+
+	void	setLinearVelocity(btRigidBody* body, const btVector3& velocity);
+
+	///moves the body and its motion state without interpolating, and wakes it up
+	void	setWorldTransform(btRigidBody* body, const btTransform& transform);
+
+	void	addRigidBody(btRigidBody* body);
+
+	void	addRigidBody(btRigidBody* body, int group, int mask);
+
+	///the body must stay alive until waitForStep returns for the step that removes it
+	void	removeRigidBody(btRigidBody* body);
+
+	void	queueCallback(btAsyncStepperCallback callback, void* userData);
+};
+
+#endif //BT_ASYNC_STEPPER_H
+
+
+#pragma clang diagnostic pop
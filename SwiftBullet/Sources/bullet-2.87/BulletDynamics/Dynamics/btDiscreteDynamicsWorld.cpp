@@ -33,9 +33,14 @@ subject to the following restrictions:
 #include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
 #include "LinearMath/btTransformUtil.h"
 #include "LinearMath/btQuickprof.h"
+#include "LinearMath/btTraceProfiler.h"
+#include "LinearMath/btMemoryTracker.h"
 
 //rigidbody & constraints
 #include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "BulletDynamics/Dynamics/btTransformExport.h"
+#include "BulletDynamics/Dynamics/btIncrementalIslandManager.h"
+#include "BulletDynamics/Dynamics/btSimulationLod.h"
 #include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
 #include "BulletDynamics/ConstraintSolver/btContactSolverInfo.h"
 #include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
@@ -54,6 +59,7 @@ subject to the following restrictions:
 
 #include "BulletDynamics/Dynamics/btActionInterface.h"
 #include "LinearMath/btQuickprof.h"
+#include "LinearMath/btTraceProfiler.h"
 #include "LinearMath/btMotionState.h"
 
 #include "LinearMath/btSerializer.h"
@@ -90,6 +96,16 @@ class btSortConstraintOnIslandPredicate
 		}
 };
 
+class btSortConstraintKeyPredicate
+{
+	public:
+
+		bool operator() ( const unsigned long long& lhs, const unsigned long long& rhs ) const
+		{
+			return lhs < rhs;
+		}
+};
+
 struct InplaceSolverIslandCallback : public btSimulationIslandManager::IslandCallback
 {
 	btContactSolverInfo*	m_solverInfo;
@@ -220,7 +236,10 @@ m_fixedTimeStep(0),
 m_synchronizeAllMotionStates(false),
 m_applySpeculativeContactRestitution(false),
 m_profileTimings(0),
-m_latencyMotionStateInterpolation(true)
+m_latencyMotionStateInterpolation(true),
+m_transformExport(0),
+m_incrementalIslandManager(0),
+m_simulationLod(0)
 
 {
 	if (!m_constraintSolver)
@@ -356,6 +375,11 @@ void	btDiscreteDynamicsWorld::applyGravity()
 			body->applyGravity();
 		}
 	}
+
+	if (m_simulationLod)
+	{
+		m_simulationLod->applyGravity();
+	}
 }
 
 
@@ -363,7 +387,9 @@ void	btDiscreteDynamicsWorld::synchronizeSingleMotionState(btRigidBody* body)
 {
 	btAssert(body);
 
-	if (body->getMotionState() && !body->isStaticOrKinematicObject())
+	bool exported = m_transformExport && body->getTransformExportIndex() >= 0 && body->isActive();
+
+	if ((body->getMotionState() || exported) && !body->isStaticOrKinematicObject())
 	{
 		//we need to call the update at least once, even for sleeping objects
 		//otherwise the 'graphics' transform never updates properly
@@ -375,8 +401,15 @@ void	btDiscreteDynamicsWorld::synchronizeSingleMotionState(btRigidBody* body)
 				body->getInterpolationLinearVelocity(),body->getInterpolationAngularVelocity(),
 				(m_latencyMotionStateInterpolation && m_fixedTimeStep) ? m_localTime - m_fixedTimeStep : m_localTime*body->getHitFraction(),
 				interpolatedTransform);
-			body->getMotionState()->setWorldTransform(interpolatedTransform);
+			if (body->getMotionState())
+				body->getMotionState()->setWorldTransform(interpolatedTransform);
+			//sleeping bodies keep the transform they were last exported with
+			if (exported)
+				m_transformExport->writeTransform(body->getTransformExportIndex(), interpolatedTransform);
 		}
+	} else if (exported && body->isKinematicObject())
+	{
+		m_transformExport->writeTransform(body->getTransformExportIndex(), body->getWorldTransform());
 	}
 }
 
@@ -403,6 +436,11 @@ void	btDiscreteDynamicsWorld::synchronizeMotionStates()
 			if (body->isActive())
 				synchronizeSingleMotionState(body);
 		}
+
+		if (m_simulationLod)
+		{
+			m_simulationLod->synchronizeMotionStates(this);
+		}
 	}
 }
 
@@ -411,6 +449,12 @@ int	btDiscreteDynamicsWorld::stepSimulation( btScalar timeStep,int maxSubSteps,
 {
 	startProfiling(timeStep);
 
+#ifndef BT_NO_PROFILE
+	btTraceProfiler* traceProfiler = btTraceProfiler::getInstalled();
+	if (traceProfiler)
+		traceProfiler->beginFrame();
+#endif //BT_NO_PROFILE
+
 
 	int numSimulationSubSteps = 0;
 
@@ -474,6 +518,8 @@ int	btDiscreteDynamicsWorld::stepSimulation( btScalar timeStep,int maxSubSteps,
 
 #ifndef BT_NO_PROFILE
 	CProfileManager::Increment_Frame_Counter();
+	if (traceProfiler)
+		traceProfiler->endFrame(btMin(numSimulationSubSteps, maxSubSteps));
 #endif //BT_NO_PROFILE
 
 	return numSimulationSubSteps;
@@ -488,6 +534,11 @@ void	btDiscreteDynamicsWorld::internalSingleStepSimulation(btScalar timeStep)
 		(*m_internalPreTickCallback)(this, timeStep);
 	}
 
+	if (m_simulationLod)
+	{
+		m_simulationLod->beginTick(this, timeStep);
+	}
+
 	///apply gravity, predict motion
 	predictUnconstraintMotion(timeStep);
 
@@ -524,6 +575,25 @@ void	btDiscreteDynamicsWorld::internalSingleStepSimulation(btScalar timeStep)
 
 	updateActivationState( timeStep );
 
+	if (m_simulationLod)
+	{
+		m_simulationLod->endTick(this, timeStep);
+	}
+
+#ifndef BT_NO_PROFILE
+	if (btTraceProfiler* traceProfiler = btTraceProfiler::getInstalled())
+	{
+		int numContactPoints = 0;
+		for (int i = 0; i < m_dispatcher1->getNumManifolds(); i++)
+		{
+			numContactPoints += m_dispatcher1->getManifoldByIndexInternal(i)->getNumContacts();
+		}
+		traceProfiler->setCounter(BT_TRACE_PAIRS, m_broadphasePairCache->getOverlappingPairCache()->getNumOverlappingPairs());
+		traceProfiler->setCounter(BT_TRACE_MANIFOLDS, m_dispatcher1->getNumManifolds());
+		traceProfiler->setCounter(BT_TRACE_CONTACT_POINTS, numContactPoints);
+	}
+#endif //BT_NO_PROFILE
+
 	if(0 != m_internalTickCallback) {
 		(*m_internalTickCallback)(this, timeStep);
 	}
@@ -550,21 +620,37 @@ btVector3 btDiscreteDynamicsWorld::getGravity () const
 void	btDiscreteDynamicsWorld::addCollisionObject(btCollisionObject* collisionObject, int collisionFilterGroup, int collisionFilterMask)
 {
 	btCollisionWorld::addCollisionObject(collisionObject,collisionFilterGroup,collisionFilterMask);
+
+	if (m_incrementalIslandManager)
+		m_incrementalIslandManager->addCollisionObject(collisionObject);
 }
 
 void	btDiscreteDynamicsWorld::removeCollisionObject(btCollisionObject* collisionObject)
 {
 	btRigidBody* body = btRigidBody::upcast(collisionObject);
 	if (body)
+	{
 		removeRigidBody(body);
-	else
+	} else
+	{
 		btCollisionWorld::removeCollisionObject(collisionObject);
+
+		if (m_incrementalIslandManager)
+			m_incrementalIslandManager->removeCollisionObject(collisionObject);
+	}
 }
 
 void	btDiscreteDynamicsWorld::removeRigidBody(btRigidBody* body)
 {
+	//thaws it first, a frozen body would leave with zero mass
+	if (m_simulationLod)
+		m_simulationLod->removeBody(body);
+
 	m_nonStaticRigidBodies.remove(body);
 	btCollisionWorld::removeCollisionObject(body);
+
+	if (m_incrementalIslandManager)
+		m_incrementalIslandManager->removeCollisionObject(body);
 }
 
 
@@ -615,6 +701,28 @@ void	btDiscreteDynamicsWorld::addRigidBody(btRigidBody* body, int group, int mas
 }
 
 
+void	btDiscreteDynamicsWorld::addStaticRigidBodies(btRigidBody** bodies, int numBodies, int group, int mask)
+{
+	btAlignedObjectArray<btCollisionObject*> objects;
+	objects.reserve(numBodies);
+
+	for (int i = 0; i < numBodies; i++)
+	{
+		btAssert(bodies[i]->isStaticObject());
+
+		if (bodies[i]->getCollisionShape())
+		{
+			bodies[i]->setActivationState(ISLAND_SLEEPING);
+			objects.push_back(bodies[i]);
+		}
+	}
+
+	if (objects.size())
+	{
+		addStaticCollisionObjects(&objects[0], objects.size(), group, mask);
+	}
+}
+
 void	btDiscreteDynamicsWorld::updateActions(btScalar timeStep)
 {
 	BT_PROFILE("updateActions");
@@ -719,19 +827,36 @@ void	btDiscreteDynamicsWorld::removeCharacter(btActionInterface* character)
 void	btDiscreteDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
 {
 	BT_PROFILE("solveConstraints");
+	BT_MEMORY_TAG(BT_MEMORY_SOLVER);
 
 	m_sortedConstraints.resize( m_constraints.size());
 	int i;
-	for (i=0;i<getNumConstraints();i++)
+	if (getDispatchInfo().m_deterministicOverlappingPairs)
 	{
-		m_sortedConstraints[i] = m_constraints[i];
-	}
+		//island ids depend on the order pairs were united in, keep the order of m_constraints within an island
+		m_sortedConstraintKeys.resize(m_constraints.size());
+		for (i=0;i<getNumConstraints();i++)
+		{
+			m_sortedConstraintKeys[i] = ((unsigned long long)unsigned(btGetConstraintIslandId(m_constraints[i])+1) << 32) | unsigned(i);
+		}
+		m_sortedConstraintKeys.quickSort(btSortConstraintKeyPredicate());
+		for (i=0;i<getNumConstraints();i++)
+		{
+			m_sortedConstraints[i] = m_constraints[int(m_sortedConstraintKeys[i] & 0xffffffffu)];
+		}
+	} else
+	{
+		for (i=0;i<getNumConstraints();i++)
+		{
+			m_sortedConstraints[i] = m_constraints[i];
+		}
 
-//	btAssert(0);
+//		btAssert(0);
 
 
 
-	m_sortedConstraints.quickSort(btSortConstraintOnIslandPredicate());
+		m_sortedConstraints.quickSort(btSortConstraintOnIslandPredicate());
+	}
 
 	btTypedConstraint** constraintsPtr = getNumConstraints() ? &m_sortedConstraints[0] : 0;
 
@@ -739,7 +864,10 @@ void	btDiscreteDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
 	m_constraintSolver->prepareSolve(getCollisionWorld()->getNumCollisionObjects(), getCollisionWorld()->getDispatcher()->getNumManifolds());
 
 	/// solve all the constraints for this island
-	m_islandManager->buildAndProcessIslands(getCollisionWorld()->getDispatcher(),getCollisionWorld(),m_solverIslandCallback);
+	if (m_incrementalIslandManager)
+		m_incrementalIslandManager->processIslands(getCollisionWorld()->getDispatcher(),getCollisionWorld(),m_solverIslandCallback);
+	else
+		m_islandManager->buildAndProcessIslands(getCollisionWorld()->getDispatcher(),getCollisionWorld(),m_solverIslandCallback);
 
 	m_solverIslandCallback->processConstraints();
 
@@ -750,6 +878,15 @@ void	btDiscreteDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
 void	btDiscreteDynamicsWorld::calculateSimulationIslands()
 {
 	BT_PROFILE("calculateSimulationIslands");
+	BT_MEMORY_TAG(BT_MEMORY_ISLANDS);
+
+	if (m_incrementalIslandManager)
+	{
+		m_incrementalIslandManager->updateIslands(getCollisionWorld(),
+			m_constraints.size() ? &m_constraints[0] : 0, m_constraints.size(),
+			m_predictiveManifolds.size() ? &m_predictiveManifolds[0] : 0, m_predictiveManifolds.size());
+		return;
+	}
 
 	getSimulationIslandManager()->updateActivationState(getCollisionWorld(),getCollisionWorld()->getDispatcher());
 
@@ -942,6 +1079,7 @@ void btDiscreteDynamicsWorld::createPredictiveContactsInternal( btRigidBody** bo
 					convexSweepTest(&tmpSphere,body->getWorldTransform(),modifiedPredictedTrans,sweepResults);
 					if (sweepResults.hasHit() && (sweepResults.m_closestHitFraction < 1.f))
 					{
+						BT_PROFILE_COUNT(BT_TRACE_CCD_HITS, 1);
 
 						btVector3 distVec = (predictedTrans.getOrigin()-body->getWorldTransform().getOrigin())*sweepResults.m_closestHitFraction;
 						btScalar distance = distVec.dot(-sweepResults.m_hitNormalWorld);
@@ -1052,6 +1190,7 @@ void btDiscreteDynamicsWorld::integrateTransformsInternal( btRigidBody** bodies,
 					convexSweepTest(&tmpSphere,body->getWorldTransform(),modifiedPredictedTrans,sweepResults);
 					if (sweepResults.hasHit() && (sweepResults.m_closestHitFraction < 1.f))
 					{
+						BT_PROFILE_COUNT(BT_TRACE_CCD_HITS, 1);
 
 						//printf("clamped integration to hit fraction = %f\n",fraction);
 						body->setHitFraction(sweepResults.m_closestHitFraction);
@@ -1433,6 +1572,15 @@ btConstraintSolver* btDiscreteDynamicsWorld::getConstraintSolver()
 	return m_constraintSolver;
 }
 
+void	btDiscreteDynamicsWorld::setIncrementalIslandManager(btIncrementalIslandManager* incrementalIslandManager)
+{
+	m_incrementalIslandManager = incrementalIslandManager;
+
+	//objects added or removed while it wasn't in use are unknown to it
+	if (m_incrementalIslandManager)
+		m_incrementalIslandManager->invalidateIslands();
+}
+
 
 int		btDiscreteDynamicsWorld::getNumConstraints() const
 {
@@ -36,6 +36,9 @@ class btTypedConstraint;
 class btActionInterface;
 class btPersistentManifold;
 class btIDebugDraw;
+class btTransformExport;
+class btIncrementalIslandManager;
+class btSimulationLod;
 struct InplaceSolverIslandCallback;
 
 #include "LinearMath/btAlignedObjectArray.h"
@@ -49,6 +52,7 @@ ATTRIBUTE_ALIGNED16(class) btDiscreteDynamicsWorld : public btDynamicsWorld
 protected:
 	
     btAlignedObjectArray<btTypedConstraint*>	m_sortedConstraints;
+	btAlignedObjectArray<unsigned long long>	m_sortedConstraintKeys;
 	InplaceSolverIslandCallback* 	m_solverIslandCallback;
 
 	btConstraintSolver*	m_constraintSolver;
@@ -77,6 +81,12 @@ protected:
 
 	bool	m_latencyMotionStateInterpolation;
 
+	btTransformExport*	m_transformExport;
+
+	btIncrementalIslandManager*	m_incrementalIslandManager;
+
+	btSimulationLod*	m_simulationLod;
+
 	btAlignedObjectArray<btPersistentManifold*>	m_predictiveManifolds;
     btSpinMutex m_predictiveManifoldsMutex;  // used to synchronize threads creating predictive contacts
 
@@ -159,6 +169,9 @@ public:
 
 	virtual void	addRigidBody(btRigidBody* body, int group, int mask);
 
+	///addStaticRigidBodies adds bodies of zero mass at once, through btCollisionWorld::addStaticCollisionObjects
+	void	addStaticRigidBodies(btRigidBody** bodies, int numBodies, int group=btBroadphaseProxy::StaticFilter, int mask=btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter);
+
 	virtual void	removeRigidBody(btRigidBody* body);
 
 	///removeCollisionObject will first check if it is a rigid body, if so call removeRigidBody otherwise call btCollisionWorld::removeCollisionObject
@@ -243,6 +256,46 @@ public:
 	{
 		return m_latencyMotionStateInterpolation;
 	}
+
+	///synchronizeMotionStates also writes the interpolated transforms of awake bodies with an export index into transformExport,
+	///the world doesn't own it
+	void	setTransformExport(btTransformExport* transformExport)
+	{
+		m_transformExport = transformExport;
+	}
+	btTransformExport*	getTransformExport() const
+	{
+		return m_transformExport;
+	}
+
+	///keeps the simulation islands between internal ticks with incrementalIslandManager instead of rebuilding them with the
+	///island manager on each of them, 0 goes back to that. The world doesn't own it, btDiscreteDynamicsWorldMt ignores it
+	void	setIncrementalIslandManager(btIncrementalIslandManager* incrementalIslandManager);
+	btIncrementalIslandManager*	getIncrementalIslandManager() const
+	{
+		return m_incrementalIslandManager;
+	}
+
+	///steps the bodies added to simulationLod at the rate of their distance from its viewer, 0 steps everything every tick.
+	///The world doesn't own it
+	void	setSimulationLod(btSimulationLod* simulationLod)
+	{
+		m_simulationLod = simulationLod;
+	}
+	btSimulationLod*	getSimulationLod() const
+	{
+		return m_simulationLod;
+	}
+
+	///time left over from the last stepSimulation, interpolated motion states are based on it
+	btScalar	getLocalTime() const
+	{
+		return m_localTime;
+	}
+	void	setLocalTime(btScalar localTime)
+	{
+		m_localTime = localTime;
+	}
 };
 
 #endif //BT_DISCRETE_DYNAMICS_WORLD_H
@@ -0,0 +1,961 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+
+
+#include "btIncrementalIslandManager.h"
+#include "BulletCollision/BroadphaseCollision/btCollisionAlgorithm.h"
+#include "BulletCollision/BroadphaseCollision/btDispatcher.h"
+#include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/CollisionDispatch/btCollisionWorld.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
+#include "LinearMath/btQuickprof.h"
+#include "LinearMath/btTraceProfiler.h"
+
+#include <string.h>
+
+static SIMD_FORCE_INLINE int	btGetManifoldIslandId(const btPersistentManifold* manifold)
+{
+	const btCollisionObject* colObj0 = manifold->getBody0();
+	const btCollisionObject* colObj1 = manifold->getBody1();
+	return colObj0->getIslandTag() >= 0 ? colObj0->getIslandTag() : colObj1->getIslandTag();
+}
+
+class btSortManifoldsOnIslandPredicate
+{
+	public:
+
+		bool operator() ( const btPersistentManifold* lhs, const btPersistentManifold* rhs ) const
+		{
+			return btGetManifoldIslandId(lhs) < btGetManifoldIslandId(rhs);
+		}
+};
+
+///orders the manifolds of one island like btSimulationIslandManager does with deterministic overlapping pairs:
+///by the proxy ids of their bodies, then by the feature of their first point
+class btSortIslandManifoldsDeterministicPredicate
+{
+	public:
+
+		static void	getKey(const btPersistentManifold* manifold, int key[6])
+		{
+			key[0] = manifold->getBody0()->getBroadphaseHandle()->m_uniqueId;
+			key[1] = manifold->getBody1()->getBroadphaseHandle()->m_uniqueId;
+			if (manifold->getNumContacts())
+			{
+				const btManifoldPoint& pt = manifold->getContactPoint(0);
+				key[2] = pt.m_partId0;
+				key[3] = pt.m_index0;
+				key[4] = pt.m_partId1;
+				key[5] = pt.m_index1;
+			} else
+			{
+				key[2] = key[3] = key[4] = key[5] = -1;
+			}
+		}
+
+		bool operator() ( const btPersistentManifold* lhs, const btPersistentManifold* rhs ) const
+		{
+			int lkey[6],rkey[6];
+			getKey(lhs,lkey);
+			getKey(rhs,rkey);
+			for (int i=0;i<6;i++)
+			{
+				if (lkey[i] != rkey[i])
+					return lkey[i] < rkey[i];
+			}
+			return false;
+		}
+};
+
+class btSortBodiesOnWorldIndexPredicate
+{
+	public:
+
+		bool operator() ( const btCollisionObject* lhs, const btCollisionObject* rhs ) const
+		{
+			return lhs->getWorldArrayIndex() < rhs->getWorldArrayIndex();
+		}
+};
+
+class btSortTransientLinksPredicate
+{
+	public:
+
+		template <class TransientLink>
+		bool operator() ( const TransientLink& lhs, const TransientLink& rhs ) const
+		{
+			if (lhs.m_object0 != rhs.m_object0)
+				return size_t(lhs.m_object0) < size_t(rhs.m_object0);
+			return size_t(lhs.m_object1) < size_t(rhs.m_object1);
+		}
+};
+
+class btSortIslandsOnFirstBodyPredicate
+{
+	public:
+
+		template <class Island>
+		bool operator() ( const Island* lhs, const Island* rhs ) const
+		{
+			return lhs->m_firstBody < rhs->m_firstBody;
+		}
+};
+
+template <class Island>
+static void	btRemoveIslandFromList(btAlignedObjectArray<Island*>& list, Island* island)
+{
+	Island* last = list[list.size() - 1];
+	list[island->m_listIndex] = last;
+	last->m_listIndex = island->m_listIndex;
+	list.pop_back();
+}
+
+btIncrementalIslandManager::btIncrementalIslandManager(btOverlappingPairCache* pairCache, btOverlappingPairCallback* next)
+:m_pairCache(pairCache),
+m_next(next),
+m_rebuild(true),
+m_visit(0),
+m_freeLink(-1)
+{
+}
+
+btIncrementalIslandManager::~btIncrementalIslandManager()
+{
+	for (int i = 0; i < m_islands.size(); i++)
+	{
+		m_islands[i]->~Island();
+		btAlignedFree(m_islands[i]);
+	}
+}
+
+int	btIncrementalIslandManager::findNode(const btCollisionObject* colObj) const
+{
+	const int* node = m_nodeIndices.find(btHashPtr(colObj));
+	return node ? *node : -1;
+}
+
+int	btIncrementalIslandManager::addNode(btCollisionObject* colObj)
+{
+	int node;
+	if (m_freeNodes.size())
+	{
+		node = m_freeNodes[m_freeNodes.size() - 1];
+		m_freeNodes.pop_back();
+	} else
+	{
+		node = m_nodes.size();
+		m_nodes.expandNonInitializing();
+	}
+
+	Island* island = allocateIsland(colObj->isActive());
+	island->m_nodes.push_back(node);
+
+	Node& n = m_nodes[node];
+	n.m_object = colObj;
+	n.m_island = island->m_id;
+	n.m_indexInIsland = 0;
+	n.m_firstLink = -1;
+	n.m_visit = 0;
+
+	colObj->setIslandTag(island->m_id);
+	colObj->setCompanionId(-1);
+	m_nodeIndices.insert(btHashPtr(colObj), node);
+	return node;
+}
+
+void	btIncrementalIslandManager::removeNode(int node)
+{
+	Node& n = m_nodes[node];
+	Island* island = m_islands[n.m_island];
+
+	//the pairs went with the proxy, what is left are constraints and predictive contacts
+	int link = n.m_firstLink;
+	while (link >= 0)
+	{
+		const Link& l = m_links[link];
+		if (l.m_node >= 0)
+		{
+			removeLink(l.m_node, l.m_proxy ? n.m_object->getBroadphaseHandle() : 0, node);
+		}
+		if (l.m_merges)
+		{
+			markSplit(island);
+		}
+
+		int next = l.m_next;
+		m_links[link].m_next = m_freeLink;
+		m_freeLink = link;
+		link = next;
+	}
+
+	int last = island->m_nodes[island->m_nodes.size() - 1];
+	island->m_nodes[n.m_indexInIsland] = last;
+	m_nodes[last].m_indexInIsland = n.m_indexInIsland;
+	island->m_nodes.pop_back();
+	if (island->m_nodes.size() == 0)
+	{
+		freeIsland(island);
+	}
+
+	//links to it from the last tick are gone, so the diff at the next tick doesn't look for them
+	const btCollisionObject* colObj = n.m_object;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		btAlignedObjectArray<TransientLink>& transientLinks = pass ? m_sortedLastTransientLinks : m_lastTransientLinks;
+		int numKept = 0;
+		for (int i = 0; i < transientLinks.size(); i++)
+		{
+			if (transientLinks[i].m_object0 != colObj && transientLinks[i].m_object1 != colObj)
+			{
+				transientLinks[numKept++] = transientLinks[i];
+			}
+		}
+		transientLinks.resize(numKept);
+	}
+
+	n.m_object->setIslandTag(-1);
+	m_nodeIndices.remove(btHashPtr(colObj));
+	n.m_object = 0;
+	m_freeNodes.push_back(node);
+}
+
+void	btIncrementalIslandManager::addLink(int node, btBroadphaseProxy* proxy, int otherNode, bool merges)
+{
+	int link;
+	if (m_freeLink >= 0)
+	{
+		link = m_freeLink;
+		m_freeLink = m_links[link].m_next;
+	} else
+	{
+		link = m_links.size();
+		m_links.expandNonInitializing();
+	}
+
+	Link& l = m_links[link];
+	l.m_proxy = proxy;
+	l.m_node = otherNode;
+	l.m_merges = merges;
+	l.m_next = m_nodes[node].m_firstLink;
+	m_nodes[node].m_firstLink = link;
+}
+
+bool	btIncrementalIslandManager::removeLink(int node, btBroadphaseProxy* proxy, int otherNode)
+{
+	int* previous = &m_nodes[node].m_firstLink;
+	for (int link = *previous; link >= 0; link = *previous)
+	{
+		Link& l = m_links[link];
+		if (l.m_proxy == proxy && l.m_node == otherNode)
+		{
+			*previous = l.m_next;
+			l.m_next = m_freeLink;
+			m_freeLink = link;
+			return l.m_merges;
+		}
+		previous = &l.m_next;
+	}
+	return false;
+}
+
+void	btIncrementalIslandManager::linkPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1)
+{
+	btCollisionObject* colObj0 = static_cast<btCollisionObject*>(proxy0->m_clientObject);
+	btCollisionObject* colObj1 = static_cast<btCollisionObject*>(proxy1->m_clientObject);
+	if (!colObj0 || !colObj1)
+	{
+		return;
+	}
+
+	//pairs of an object being added show up before the world tells about it
+	int node0 = -1;
+	int node1 = -1;
+	if (!colObj0->isStaticOrKinematicObject())
+	{
+		node0 = findNode(colObj0);
+		if (node0 < 0)
+			node0 = addNode(colObj0);
+	}
+	if (!colObj1->isStaticOrKinematicObject())
+	{
+		node1 = findNode(colObj1);
+		if (node1 < 0)
+			node1 = addNode(colObj1);
+	}
+
+	if (node0 < 0 && node1 < 0)
+	{
+		return;
+	}
+
+	bool merges = node0 >= 0 && node1 >= 0 && colObj0->mergesSimulationIslands() && colObj1->mergesSimulationIslands();
+
+	if (node0 >= 0)
+	{
+		addLink(node0, proxy1, node1, merges);
+	} else if (colObj0->isKinematicObject())
+	{
+		KinematicPair pair = { colObj0, colObj1 };
+		m_kinematicPairs.push_back(pair);
+	}
+
+	if (node1 >= 0)
+	{
+		addLink(node1, proxy0, node0, merges);
+	} else if (colObj1->isKinematicObject())
+	{
+		KinematicPair pair = { colObj1, colObj0 };
+		m_kinematicPairs.push_back(pair);
+	}
+
+	if (merges)
+	{
+		mergeIslands(m_nodes[node0].m_island, m_nodes[node1].m_island);
+	}
+}
+
+void	btIncrementalIslandManager::unlinkPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1)
+{
+	btCollisionObject* colObj0 = static_cast<btCollisionObject*>(proxy0->m_clientObject);
+	btCollisionObject* colObj1 = static_cast<btCollisionObject*>(proxy1->m_clientObject);
+	if (!colObj0 || !colObj1)
+	{
+		return;
+	}
+
+	int node0 = findNode(colObj0);
+	int node1 = findNode(colObj1);
+
+	bool merged = false;
+	if (node0 >= 0)
+	{
+		merged |= removeLink(node0, proxy1, node1);
+	}
+	if (node1 >= 0)
+	{
+		merged |= removeLink(node1, proxy0, node0);
+	}
+
+	if (merged)
+	{
+		markSplit(m_islands[m_nodes[node0].m_island]);
+	}
+
+	if (node0 < 0 || node1 < 0)
+	{
+		for (int i = 0; i < m_kinematicPairs.size(); i++)
+		{
+			const KinematicPair& pair = m_kinematicPairs[i];
+			if ((pair.m_kinematic == colObj0 && pair.m_other == colObj1) || (pair.m_kinematic == colObj1 && pair.m_other == colObj0))
+			{
+				m_kinematicPairs.swap(i, m_kinematicPairs.size() - 1);
+				m_kinematicPairs.pop_back();
+				break;
+			}
+		}
+	}
+}
+
+void	btIncrementalIslandManager::updateTransientLinks(btTypedConstraint** constraints, int numConstraints, btPersistentManifold** predictiveManifolds, int numPredictiveManifolds)
+{
+	m_transientLinks.resize(0);
+
+	for (int i = 0; i < numConstraints + numPredictiveManifolds; i++)
+	{
+		const btCollisionObject* colObj0;
+		const btCollisionObject* colObj1;
+		if (i < numConstraints)
+		{
+			if (!constraints[i]->isEnabled())
+				continue;
+			colObj0 = &constraints[i]->getRigidBodyA();
+			colObj1 = &constraints[i]->getRigidBodyB();
+		} else
+		{
+			colObj0 = predictiveManifolds[i - numConstraints]->getBody0();
+			colObj1 = predictiveManifolds[i - numConstraints]->getBody1();
+		}
+
+		if (colObj0->isStaticOrKinematicObject() || colObj1->isStaticOrKinematicObject())
+			continue;
+
+		if (size_t(colObj1) < size_t(colObj0))
+			btSwap(colObj0, colObj1);
+
+		TransientLink link = { colObj0, colObj1 };
+		m_transientLinks.push_back(link);
+	}
+
+	//the same constraints in the same order and no predictive contacts is the common case
+	if (m_transientLinks.size() == m_lastTransientLinks.size() &&
+		(m_transientLinks.size() == 0 || memcmp(&m_transientLinks[0], &m_lastTransientLinks[0], m_transientLinks.size() * sizeof(TransientLink)) == 0))
+	{
+		return;
+	}
+
+	m_sortedTransientLinks.copyFromArray(m_transientLinks);
+	m_sortedTransientLinks.quickSort(btSortTransientLinksPredicate());
+
+	btSortTransientLinksPredicate less;
+	int i = 0;
+	int j = 0;
+	while (i < m_sortedLastTransientLinks.size() || j < m_sortedTransientLinks.size())
+	{
+		bool removed = j == m_sortedTransientLinks.size() || (i < m_sortedLastTransientLinks.size() && less(m_sortedLastTransientLinks[i], m_sortedTransientLinks[j]));
+		bool added = !removed && (i == m_sortedLastTransientLinks.size() || less(m_sortedTransientLinks[j], m_sortedLastTransientLinks[i]));
+
+		if (!removed && !added)
+		{
+			i++;
+			j++;
+			continue;
+		}
+
+		const TransientLink& link = removed ? m_sortedLastTransientLinks[i++] : m_sortedTransientLinks[j++];
+		int node0 = findNode(link.m_object0);
+		int node1 = findNode(link.m_object1);
+		if (node0 < 0 || node1 < 0)
+			continue;
+
+		if (added)
+		{
+			addLink(node0, 0, node1, true);
+			addLink(node1, 0, node0, true);
+			mergeIslands(m_nodes[node0].m_island, m_nodes[node1].m_island);
+		} else
+		{
+			removeLink(node0, 0, node1);
+			removeLink(node1, 0, node0);
+			markSplit(m_islands[m_nodes[node0].m_island]);
+		}
+	}
+
+	m_lastTransientLinks.copyFromArray(m_transientLinks);
+	m_sortedLastTransientLinks.copyFromArray(m_sortedTransientLinks);
+}
+
+btIncrementalIslandManager::Island*	btIncrementalIslandManager::allocateIsland(bool awake)
+{
+	Island* island;
+	if (m_freeIslands.size())
+	{
+		island = m_freeIslands[m_freeIslands.size() - 1];
+		m_freeIslands.pop_back();
+	} else
+	{
+		void* mem = btAlignedAlloc(sizeof(Island), 16);
+		island = new (mem) Island();
+		island->m_id = m_islands.size();
+		m_islands.push_back(island);
+	}
+
+	btAlignedObjectArray<Island*>& list = awake ? m_awakeIslands : m_sleepingIslands;
+	island->m_nodes.resize(0);
+	island->m_listIndex = list.size();
+	island->m_awake = awake;
+	island->m_split = false;
+	list.push_back(island);
+	return island;
+}
+
+void	btIncrementalIslandManager::freeIsland(Island* island)
+{
+	btRemoveIslandFromList(island->m_awake ? m_awakeIslands : m_sleepingIslands, island);
+	island->m_nodes.resize(0);
+	island->m_split = false;
+	m_freeIslands.push_back(island);
+}
+
+void	btIncrementalIslandManager::setIslandAwake(Island* island, bool awake)
+{
+	if (island->m_awake == awake)
+	{
+		return;
+	}
+
+	btRemoveIslandFromList(island->m_awake ? m_awakeIslands : m_sleepingIslands, island);
+
+	btAlignedObjectArray<Island*>& list = awake ? m_awakeIslands : m_sleepingIslands;
+	island->m_listIndex = list.size();
+	island->m_awake = awake;
+	list.push_back(island);
+}
+
+void	btIncrementalIslandManager::markSplit(Island* island)
+{
+	if (!island->m_split)
+	{
+		island->m_split = true;
+		m_splitIslandIds.push_back(island->m_id);
+	}
+}
+
+void	btIncrementalIslandManager::mergeIslands(int island0, int island1)
+{
+	if (island0 == island1)
+	{
+		return;
+	}
+
+	//the bodies of the smaller island get relabeled
+	Island* target = m_islands[island0];
+	Island* source = m_islands[island1];
+	if (target->m_nodes.size() < source->m_nodes.size())
+	{
+		btSwap(target, source);
+	}
+
+	for (int i = 0; i < source->m_nodes.size(); i++)
+	{
+		Node& n = m_nodes[source->m_nodes[i]];
+		n.m_island = target->m_id;
+		n.m_indexInIsland = target->m_nodes.size();
+		n.m_object->setIslandTag(target->m_id);
+		target->m_nodes.push_back(source->m_nodes[i]);
+	}
+
+	if (source->m_split)
+	{
+		markSplit(target);
+	}
+	if (source->m_awake)
+	{
+		setIslandAwake(target, true);
+	}
+
+	freeIsland(source);
+}
+
+void	btIncrementalIslandManager::splitIsland(Island* island)
+{
+	island->m_split = false;
+	if (island->m_nodes.size() < 2)
+	{
+		return;
+	}
+
+	m_splitNodes.copyFromArray(island->m_nodes);
+	m_visit++;
+
+	bool first = true;
+	for (int i = 0; i < m_splitNodes.size(); i++)
+	{
+		int start = m_splitNodes[i];
+		if (m_nodes[start].m_visit == m_visit)
+			continue;
+
+		m_component.resize(0);
+		m_component.push_back(start);
+		m_nodes[start].m_visit = m_visit;
+
+		for (int j = 0; j < m_component.size(); j++)
+		{
+			for (int link = m_nodes[m_component[j]].m_firstLink; link >= 0; link = m_links[link].m_next)
+			{
+				const Link& l = m_links[link];
+				if (l.m_merges && m_nodes[l.m_node].m_visit != m_visit)
+				{
+					m_nodes[l.m_node].m_visit = m_visit;
+					m_component.push_back(l.m_node);
+				}
+			}
+		}
+
+		//the first part keeps the island, the others get new ones with the same sleeping state
+		Island* target;
+		if (first)
+		{
+			first = false;
+			if (m_component.size() == m_splitNodes.size())
+				return;
+			target = island;
+			target->m_nodes.resize(0);
+		} else
+		{
+			target = allocateIsland(island->m_awake);
+		}
+
+		for (int j = 0; j < m_component.size(); j++)
+		{
+			Node& n = m_nodes[m_component[j]];
+			n.m_island = target->m_id;
+			n.m_indexInIsland = target->m_nodes.size();
+			n.m_object->setIslandTag(target->m_id);
+			target->m_nodes.push_back(m_component[j]);
+		}
+	}
+}
+
+void	btIncrementalIslandManager::rebuildIslands(btCollisionWorld* collisionWorld)
+{
+	BT_PROFILE("rebuildIslands");
+
+	while (m_awakeIslands.size())
+	{
+		freeIsland(m_awakeIslands[m_awakeIslands.size() - 1]);
+	}
+	while (m_sleepingIslands.size())
+	{
+		freeIsland(m_sleepingIslands[m_sleepingIslands.size() - 1]);
+	}
+
+	m_nodes.resize(0);
+	m_freeNodes.resize(0);
+	m_nodeIndices.clear();
+	m_links.resize(0);
+	m_freeLink = -1;
+	m_splitIslandIds.resize(0);
+	m_kinematicPairs.resize(0);
+	m_lastTransientLinks.resize(0);
+	m_sortedLastTransientLinks.resize(0);
+	m_rebuild = false;
+
+	btCollisionObjectArray& collisionObjects = collisionWorld->getCollisionObjectArray();
+	for (int i = 0; i < collisionObjects.size(); i++)
+	{
+		btCollisionObject* colObj = collisionObjects[i];
+		if (colObj->isStaticOrKinematicObject())
+		{
+			colObj->setIslandTag(-1);
+			colObj->setCompanionId(-2);
+		} else
+		{
+			addNode(colObj);
+		}
+	}
+
+	const btBroadphasePairArray& pairs = m_pairCache->getOverlappingPairArray();
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		linkPair(pairs[i].m_pProxy0, pairs[i].m_pProxy1);
+	}
+}
+
+void	btIncrementalIslandManager::addCollisionObject(btCollisionObject* colObj)
+{
+	if (m_rebuild)
+	{
+		return;
+	}
+
+	if (colObj->isStaticOrKinematicObject())
+	{
+		colObj->setIslandTag(-1);
+		colObj->setCompanionId(-2);
+	} else if (findNode(colObj) < 0)
+	{
+		addNode(colObj);
+	}
+}
+
+void	btIncrementalIslandManager::removeCollisionObject(btCollisionObject* colObj)
+{
+	if (m_rebuild)
+	{
+		return;
+	}
+
+	int node = findNode(colObj);
+	if (node >= 0)
+	{
+		removeNode(node);
+	}
+}
+
+void	btIncrementalIslandManager::updateIslands(btCollisionWorld* collisionWorld, btTypedConstraint** constraints, int numConstraints, btPersistentManifold** predictiveManifolds, int numPredictiveManifolds)
+{
+	BT_PROFILE("updateIncrementalIslands");
+
+	if (m_rebuild)
+	{
+		rebuildIslands(collisionWorld);
+	}
+
+	updateTransientLinks(constraints, numConstraints, predictiveManifolds, numPredictiveManifolds);
+
+	for (int i = 0; i < m_splitIslandIds.size(); i++)
+	{
+		Island* island = m_islands[m_splitIslandIds[i]];
+		if (island->m_split)
+		{
+			splitIsland(island);
+		}
+	}
+	m_splitIslandIds.resize(0);
+
+	m_predictiveManifolds.resize(0);
+	for (int i = 0; i < numPredictiveManifolds; i++)
+	{
+		m_predictiveManifolds.push_back(predictiveManifolds[i]);
+	}
+	m_predictiveManifolds.quickSort(btSortManifoldsOnIslandPredicate());
+}
+
+void	btIncrementalIslandManager::wakeUpKinematicContacts()
+{
+	//what btSimulationIslandManager::buildIslands does for the manifolds of kinematic objects
+	for (int i = 0; i < m_kinematicPairs.size(); i++)
+	{
+		btCollisionObject* kinematic = m_kinematicPairs[i].m_kinematic;
+		btCollisionObject* other = m_kinematicPairs[i].m_other;
+		if (kinematic->getActivationState() == ISLAND_SLEEPING || !kinematic->hasContactResponse())
+			continue;
+
+		btBroadphasePair* pair = m_pairCache->findPair(kinematic->getBroadphaseHandle(), other->getBroadphaseHandle());
+		if (!pair || !pair->m_algorithm)
+			continue;
+
+		m_pairManifolds.resize(0);
+		pair->m_algorithm->getAllContactManifolds(m_pairManifolds);
+		if (m_pairManifolds.size())
+		{
+			other->activate();
+			setIslandAwake(m_islands[other->getIslandTag()], true);
+		}
+	}
+
+	for (int i = 0; i < m_predictiveManifolds.size(); i++)
+	{
+		btCollisionObject* colObj0 = const_cast<btCollisionObject*>(m_predictiveManifolds[i]->getBody0());
+		btCollisionObject* colObj1 = const_cast<btCollisionObject*>(m_predictiveManifolds[i]->getBody1());
+		if (colObj0->isKinematicObject() && colObj0->getActivationState() != ISLAND_SLEEPING && colObj0->hasContactResponse())
+			colObj1->activate();
+		if (colObj1->isKinematicObject() && colObj1->getActivationState() != ISLAND_SLEEPING && colObj1->hasContactResponse())
+			colObj0->activate();
+	}
+}
+
+void	btIncrementalIslandManager::gatherManifolds(btDispatcher* dispatcher, const Island* island)
+{
+	m_islandManifolds.resize(0);
+
+	for (int i = 0; i < island->m_nodes.size(); i++)
+	{
+		const Node& n = m_nodes[island->m_nodes[i]];
+		btBroadphaseProxy* proxy = n.m_object->getBroadphaseHandle();
+		if (!proxy || !n.m_object->hasContactResponse())
+			continue;
+
+		for (int link = n.m_firstLink; link >= 0; link = m_links[link].m_next)
+		{
+			const Link& l = m_links[link];
+
+			//a pair of two nodes is taken from the one with the lower proxy id, pairs with an object that has no
+			//contact response are never solved
+			if (!l.m_proxy || (l.m_node >= 0 && (!l.m_merges || l.m_proxy->m_uniqueId < proxy->m_uniqueId)))
+				continue;
+
+			btBroadphasePair* pair = m_pairCache->findPair(proxy, l.m_proxy);
+			if (!pair || !pair->m_algorithm)
+				continue;
+
+			m_pairManifolds.resize(0);
+			pair->m_algorithm->getAllContactManifolds(m_pairManifolds);
+			for (int j = 0; j < m_pairManifolds.size(); j++)
+			{
+				btPersistentManifold* manifold = m_pairManifolds[j];
+				const btCollisionObject* colObj0 = manifold->getBody0();
+				const btCollisionObject* colObj1 = manifold->getBody1();
+				if ((colObj0->getActivationState() != ISLAND_SLEEPING || colObj1->getActivationState() != ISLAND_SLEEPING) &&
+					dispatcher->needsResponse(colObj0, colObj1))
+				{
+					m_islandManifolds.push_back(manifold);
+				}
+			}
+		}
+	}
+
+	//predictive contacts are sorted by island, find the ones of this island
+	int lo = 0;
+	int hi = m_predictiveManifolds.size();
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
+		if (btGetManifoldIslandId(m_predictiveManifolds[mid]) < island->m_id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	for (int i = lo; i < m_predictiveManifolds.size() && btGetManifoldIslandId(m_predictiveManifolds[i]) == island->m_id; i++)
+	{
+		btPersistentManifold* manifold = m_predictiveManifolds[i];
+		const btCollisionObject* colObj0 = manifold->getBody0();
+		const btCollisionObject* colObj1 = manifold->getBody1();
+		if ((colObj0->getActivationState() != ISLAND_SLEEPING || colObj1->getActivationState() != ISLAND_SLEEPING) &&
+			dispatcher->needsResponse(colObj0, colObj1))
+		{
+			m_islandManifolds.push_back(manifold);
+		}
+	}
+}
+
+void	btIncrementalIslandManager::processIslands(btDispatcher* dispatcher, btCollisionWorld* collisionWorld, btSimulationIslandManager::IslandCallback* callback)
+{
+	BT_PROFILE("processIncrementalIslands");
+
+	//activate() on a body of a sleeping island since the last tick wakes the island
+	for (int i = m_sleepingIslands.size() - 1; i >= 0; i--)
+	{
+		Island* island = m_sleepingIslands[i];
+		for (int j = 0; j < island->m_nodes.size(); j++)
+		{
+			if (m_nodes[island->m_nodes[j]].m_object->isActive())
+			{
+				setIslandAwake(island, true);
+				break;
+			}
+		}
+	}
+
+	//an island with no body that is active and can't sleep goes to sleep as a whole, otherwise it is woken up
+	for (int i = m_awakeIslands.size() - 1; i >= 0; i--)
+	{
+		Island* island = m_awakeIslands[i];
+
+		bool allSleeping = true;
+		for (int j = 0; j < island->m_nodes.size(); j++)
+		{
+			int state = m_nodes[island->m_nodes[j]].m_object->getActivationState();
+			if (state == ACTIVE_TAG || state == DISABLE_DEACTIVATION)
+			{
+				allSleeping = false;
+				break;
+			}
+		}
+
+		for (int j = 0; j < island->m_nodes.size(); j++)
+		{
+			btCollisionObject* colObj = m_nodes[island->m_nodes[j]].m_object;
+			colObj->setHitFraction(btScalar(1.));
+			if (allSleeping)
+			{
+				colObj->setActivationState(ISLAND_SLEEPING);
+			} else if (colObj->getActivationState() == ISLAND_SLEEPING)
+			{
+				colObj->setActivationState(WANTS_DEACTIVATION);
+				colObj->setDeactivationTime(0.f);
+			}
+		}
+
+		if (allSleeping)
+		{
+			setIslandAwake(island, false);
+		}
+	}
+
+	wakeUpKinematicContacts();
+
+	bool deterministic = collisionWorld->getDispatchInfo().m_deterministicOverlappingPairs;
+
+	m_solveOrder.copyFromArray(m_awakeIslands);
+	if (deterministic)
+	{
+		//island ids depend on the order links came and went in, solve in the order of the first body in the world instead
+		for (int i = 0; i < m_solveOrder.size(); i++)
+		{
+			Island* island = m_solveOrder[i];
+			island->m_firstBody = m_nodes[island->m_nodes[0]].m_object->getWorldArrayIndex();
+			for (int j = 1; j < island->m_nodes.size(); j++)
+			{
+				island->m_firstBody = btMin(island->m_firstBody, m_nodes[island->m_nodes[j]].m_object->getWorldArrayIndex());
+			}
+		}
+		m_solveOrder.quickSort(btSortIslandsOnFirstBodyPredicate());
+	}
+
+	for (int i = 0; i < m_solveOrder.size(); i++)
+	{
+		const Island* island = m_solveOrder[i];
+
+		m_islandBodies.resize(0);
+		bool islandSleeping = true;
+		for (int j = 0; j < island->m_nodes.size(); j++)
+		{
+			btCollisionObject* colObj = m_nodes[island->m_nodes[j]].m_object;
+			m_islandBodies.push_back(colObj);
+			if (colObj->isActive())
+				islandSleeping = false;
+		}
+
+		if (islandSleeping)
+			continue;
+
+		gatherManifolds(dispatcher, island);
+
+		if (deterministic)
+		{
+			m_islandBodies.quickSort(btSortBodiesOnWorldIndexPredicate());
+			m_islandManifolds.quickSort(btSortIslandManifoldsDeterministicPredicate());
+		}
+
+		callback->processIsland(&m_islandBodies[0], m_islandBodies.size(), m_islandManifolds.size() ? &m_islandManifolds[0] : 0, m_islandManifolds.size(), island->m_id);
+		BT_PROFILE_COUNT(BT_TRACE_ISLANDS, 1);
+	}
+}
+
+btBroadphasePair*	btIncrementalIslandManager::addOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1)
+{
+	if (m_next)
+	{
+		m_next->addOverlappingPair(proxy0, proxy1);
+	}
+
+	if (!m_rebuild)
+	{
+		linkPair(proxy0, proxy1);
+	}
+	return 0;
+}
+
+void*	btIncrementalIslandManager::removeOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1, btDispatcher* dispatcher)
+{
+	if (m_next)
+	{
+		m_next->removeOverlappingPair(proxy0, proxy1, dispatcher);
+	}
+
+	if (!m_rebuild)
+	{
+		unlinkPair(proxy0, proxy1);
+	}
+	return 0;
+}
+
+void	btIncrementalIslandManager::removeOverlappingPairsContainingProxy(btBroadphaseProxy* proxy0, btDispatcher* dispatcher)
+{
+	//the pair cache removes them one by one through removeOverlappingPair
+	if (m_next)
+	{
+		m_next->removeOverlappingPairsContainingProxy(proxy0, dispatcher);
+	}
+}
+
+
+#pragma clang diagnostic pop
@@ -0,0 +1,203 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+
+
+#ifndef BT_INCREMENTAL_ISLAND_MANAGER_H
+#define BT_INCREMENTAL_ISLAND_MANAGER_H
+
+#include "BulletCollision/BroadphaseCollision/btBroadphaseProxy.h"
+#include "BulletCollision/BroadphaseCollision/btOverlappingPairCallback.h"
+#include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btHashMap.h"
+
+class btCollisionObject;
+class btCollisionWorld;
+class btDispatcher;
+class btOverlappingPairCache;
+class btPersistentManifold;
+class btTypedConstraint;
+
+///btIncrementalIslandManager keeps the simulation islands of a btDiscreteDynamicsWorld from one internal tick to the next,
+///where btSimulationIslandManager runs union-find over every object and sorts every manifold by island on each of them.
+///Install it with btOverlappingPairCache::setInternalGhostPairCallback, a previously installed callback can be chained
+///behind it, then hand it to btDiscreteDynamicsWorld::setIncrementalIslandManager.
+///A new overlapping pair, constraint or predictive contact merges two islands right away, relabeling the smaller one.
+///One that goes away only marks its island, which is split once at the next tick however many links it lost.
+///Islands that are asleep cost a read of the activation state of their bodies per tick, which catches activate() from
+///outside; the manifolds solved are gathered from the pairs of the bodies in awake islands.
+///The islands and the sleeping decisions are the ones btSimulationIslandManager comes to. Objects that become static or
+///kinematic or lose their contact response while in the world need invalidateIslands.
+class btIncrementalIslandManager : public btOverlappingPairCallback
+{
+public:
+
+	struct Island
+	{
+		btAlignedObjectArray<int>	m_nodes;
+		int	m_id; //island tag of its bodies
+		int	m_listIndex; //in m_awakeIslands or m_sleepingIslands
+		int	m_firstBody; //lowest world index of its bodies, set for deterministic stepping
+		bool	m_awake;
+		bool	m_split; //lost a link that merged islands since the last tick
+	};
+
+protected:
+
+	///a non-static, non-kinematic object in the world
+	struct Node
+	{
+		btCollisionObject*	m_object;
+		int	m_island;
+		int	m_indexInIsland;
+		int	m_firstLink;
+		int	m_visit;
+	};
+
+	///one end of an overlapping pair, constraint or predictive contact, kept in a list per node
+	struct Link
+	{
+		btBroadphaseProxy*	m_proxy; //of the other object, 0 for constraints and predictive contacts
+		int	m_node; //of the other object, -1 for static and kinematic objects
+		int	m_next;
+		bool	m_merges;
+	};
+
+	///a constraint or predictive contact between two nodes, these are diffed against the ones of the last tick
+	struct TransientLink
+	{
+		const btCollisionObject*	m_object0;
+		const btCollisionObject*	m_object1;
+	};
+
+	struct KinematicPair
+	{
+		btCollisionObject*	m_kinematic;
+		btCollisionObject*	m_other;
+	};
+
+	btOverlappingPairCache*	m_pairCache;
+	btOverlappingPairCallback*	m_next;
+	bool	m_rebuild;
+	int	m_visit;
+
+	btAlignedObjectArray<Node>	m_nodes;
+	btAlignedObjectArray<int>	m_freeNodes;
+	btHashMap<btHashPtr, int>	m_nodeIndices;
+
+	btAlignedObjectArray<Link>	m_links;
+	int	m_freeLink;
+
+	btAlignedObjectArray<Island*>	m_islands; //by id, an island keeps its id when it is freed
+	btAlignedObjectArray<Island*>	m_freeIslands;
+	btAlignedObjectArray<Island*>	m_awakeIslands;
+	btAlignedObjectArray<Island*>	m_sleepingIslands;
+	btAlignedObjectArray<int>	m_splitIslandIds;
+
+	btAlignedObjectArray<TransientLink>	m_transientLinks; //of this tick, in world order
+	btAlignedObjectArray<TransientLink>	m_lastTransientLinks; //of the last tick, in world order
+	btAlignedObjectArray<TransientLink>	m_sortedTransientLinks;
+	btAlignedObjectArray<TransientLink>	m_sortedLastTransientLinks;
+
+	btAlignedObjectArray<KinematicPair>	m_kinematicPairs;
+
+	btAlignedObjectArray<btPersistentManifold*>	m_predictiveManifolds; //of this tick, by island id
+	btAlignedObjectArray<Island*>	m_solveOrder;
+	btAlignedObjectArray<int>	m_component;
+	btAlignedObjectArray<int>	m_splitNodes;
+	btAlignedObjectArray<btCollisionObject*>	m_islandBodies;
+	btAlignedObjectArray<btPersistentManifold*>	m_islandManifolds;
+	btAlignedObjectArray<btPersistentManifold*>	m_pairManifolds;
+
+	int	findNode(const btCollisionObject* colObj) const;
+	int	addNode(btCollisionObject* colObj);
+	void	removeNode(int node);
+
+	void	addLink(int node, btBroadphaseProxy* proxy, int otherNode, bool merges);
+	///true when the link removed merged islands
+	bool	removeLink(int node, btBroadphaseProxy* proxy, int otherNode);
+	void	linkPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1);
+	void	unlinkPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1);
+	void	updateTransientLinks(btTypedConstraint** constraints, int numConstraints, btPersistentManifold** predictiveManifolds, int numPredictiveManifolds);
+
+	Island*	allocateIsland(bool awake);
+	void	freeIsland(Island* island);
+	void	setIslandAwake(Island* island, bool awake);
+	void	markSplit(Island* island);
+	void	mergeIslands(int island0, int island1);
+	void	splitIsland(Island* island);
+	void	rebuildIslands(btCollisionWorld* collisionWorld);
+	void	gatherManifolds(btDispatcher* dispatcher, const Island* island);
+	void	wakeUpKinematicContacts();
+
+public:
+
+	///pairCache is the cache the manager is installed on, next is called for every pair after the manager
+	btIncrementalIslandManager(btOverlappingPairCache* pairCache, btOverlappingPairCallback* next = 0);
+
+	virtual ~btIncrementalIslandManager();
+
+	///the islands are built from scratch at the next tick
+	void	invalidateIslands()
+	{
+		m_rebuild = true;
+	}
+
+	///called by btDiscreteDynamicsWorld when objects enter and leave it
+	void	addCollisionObject(btCollisionObject* colObj);
+	void	removeCollisionObject(btCollisionObject* colObj);
+
+	///applies the links the constraints and predictive contacts of this tick added or dropped and splits marked islands,
+	///in place of btDiscreteDynamicsWorld::calculateSimulationIslands
+	void	updateIslands(btCollisionWorld* collisionWorld, btTypedConstraint** constraints, int numConstraints, btPersistentManifold** predictiveManifolds, int numPredictiveManifolds);
+
+	///puts islands to sleep or wakes them up like btSimulationIslandManager::buildIslands, then calls back for every
+	///island with an active body, in place of btSimulationIslandManager::buildAndProcessIslands
+	void	processIslands(btDispatcher* dispatcher, btCollisionWorld* collisionWorld, btSimulationIslandManager::IslandCallback* callback);
+
+	int	getNumIslands() const
+	{
+		return m_awakeIslands.size() + m_sleepingIslands.size();
+	}
+
+	int	getNumAwakeIslands() const
+	{
+		return m_awakeIslands.size();
+	}
+
+	virtual btBroadphasePair*	addOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1);
+
+	virtual void*	removeOverlappingPair(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1, btDispatcher* dispatcher);
+
+	virtual void	removeOverlappingPairsContainingProxy(btBroadphaseProxy* proxy0, btDispatcher* dispatcher);
+};
+
+#endif //BT_INCREMENTAL_ISLAND_MANAGER_H
+
+
+#pragma clang diagnostic pop
@@ -105,6 +105,8 @@ class btRigidBody  : public btCollisionObject
 	int				m_rigidbodyFlags;
 	
 	int				m_debugBodyId;
+
+	int				m_transformExportIndex;
 	
 
 protected:
@@ -283,6 +285,12 @@ public:
 	const btMatrix3x3& getInvInertiaTensorWorld() const { 
 		return m_invInertiaTensorWorld; 
 	}
+
+	///for restoring a saved state, updateInertiaTensor recomputes it from the world transform
+	void	setInvInertiaTensorWorld(const btMatrix3x3& invInertiaTensorWorld)
+	{
+		m_invInertiaTensorWorld = invInertiaTensorWorld;
+	}
 		
 	void			integrateVelocities(btScalar step);
 
@@ -302,6 +310,17 @@ public:
 	{
 		return m_totalTorque;
 	};
+
+	///for restoring a saved state, forces are normally accumulated with applyForce and cleared after every step
+	void	setTotalForce(const btVector3& totalForce)
+	{
+		m_totalForce = totalForce;
+	}
+
+	void	setTotalTorque(const btVector3& totalTorque)
+	{
+		m_totalTorque = totalTorque;
+	}
     
 	const btVector3& getInvInertiaDiagLocal() const
 	{
@@ -544,6 +563,17 @@ public:
 		return m_rigidbodyFlags;
 	}
 
+	///index in the btTransformExport of the world, -1 when not exported
+	int	getTransformExportIndex() const
+	{
+		return m_transformExportIndex;
+	}
+
+	void	setTransformExportIndex(int index)
+	{
+		m_transformExportIndex = index;
+	}
+
 
 	
 
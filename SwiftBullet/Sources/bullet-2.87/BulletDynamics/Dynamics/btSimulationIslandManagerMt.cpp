@@ -34,6 +34,7 @@ subject to the following restrictions:
 
 //#include <stdio.h>
 #include "LinearMath/btQuickprof.h"
+#include "LinearMath/btTraceProfiler.h"
 
 
 SIMD_FORCE_INLINE int calcBatchCost( int bodies, int manifolds, int constraints )
@@ -663,6 +664,7 @@ void btSimulationIslandManagerMt::buildAndProcessIslands( btDispatcher* dispatch
                                  constraints.size(),
                                  -1
                                  );
+        BT_PROFILE_COUNT(BT_TRACE_ISLANDS, 1);
 	}
 	else
 	{
@@ -672,6 +674,7 @@ void btSimulationIslandManagerMt::buildAndProcessIslands( btDispatcher* dispatch
         addBodiesToIslands( collisionWorld );
         addManifoldsToIslands( dispatcher );
         addConstraintsToIslands( constraints );
+        BT_PROFILE_COUNT(BT_TRACE_ISLANDS, m_activeIslands.size());
 
         // m_activeIslands array should now contain all non-sleeping Islands, and each Island should
         // have all the necessary bodies, manifolds and constraints.
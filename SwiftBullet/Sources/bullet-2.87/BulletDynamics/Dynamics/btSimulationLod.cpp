@@ -0,0 +1,562 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btSimulationLod.h"
+#include "btDiscreteDynamicsWorld.h"
+#include "btIncrementalIslandManager.h"
+#include "btRigidBody.h"
+#include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
+#include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
+#include "LinearMath/btQuickprof.h"
+
+#include <string.h>
+
+///applyCentralForce and applyTorque multiply by the factors again
+static btVector3	btRemoveFactor(const btVector3& v, const btVector3& factor)
+{
+	return btVector3(factor.x() != btScalar(0) ? v.x() / factor.x() : btScalar(0),
+		factor.y() != btScalar(0) ? v.y() / factor.y() : btScalar(0),
+		factor.z() != btScalar(0) ? v.z() / factor.z() : btScalar(0));
+}
+
+btSimulationLod::Settings::Settings()
+:m_hysteresis(btScalar(0.1)),
+m_outOfViewScale(btScalar(2.))
+{
+	m_distances[BT_LOD_FULL_RATE] = btScalar(0.);
+	m_distances[BT_LOD_REDUCED_RATE] = btScalar(30.);
+	m_distances[BT_LOD_LOW_RATE] = btScalar(60.);
+	m_distances[BT_LOD_FROZEN] = btScalar(120.);
+
+	m_periods[BT_LOD_FULL_RATE] = 1;
+	m_periods[BT_LOD_REDUCED_RATE] = 2;
+	m_periods[BT_LOD_LOW_RATE] = 4;
+}
+
+btSimulationLod::btSimulationLod()
+:m_viewerPosition(0,0,0),
+m_viewerDirection(0,0,0),
+m_viewerCosHalfAngle(btScalar(-1.)),
+m_tick(0),
+m_changedKinematic(false)
+{
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+btSimulationLod::~btSimulationLod()
+{
+}
+
+void	btSimulationLod::setSettings(const Settings& settings)
+{
+	btAssert(settings.m_periods[BT_LOD_FULL_RATE] == 1);
+	btAssert(settings.m_periods[BT_LOD_LOW_RATE] % settings.m_periods[BT_LOD_REDUCED_RATE] == 0);
+	m_settings = settings;
+}
+
+void	btSimulationLod::setViewer(const btVector3& position, const btVector3& direction, btScalar cosHalfAngle)
+{
+	m_viewerPosition = position;
+	m_viewerDirection = direction.fuzzyZero() ? btVector3(0,0,0) : direction.normalized();
+	m_viewerCosHalfAngle = cosHalfAngle;
+}
+
+int	btSimulationLod::findEntry(const btCollisionObject* colObj) const
+{
+	const int* index = m_entryIndices.find(btHashPtr(colObj));
+	return index ? *index : -1;
+}
+
+void	btSimulationLod::addBody(btRigidBody* body, int flags)
+{
+	btAssert(body && !body->isStaticOrKinematicObject());
+
+	if (findEntry(body) >= 0)
+	{
+		setBodyFlags(body, flags);
+		return;
+	}
+
+	Entry& entry = m_entries.expandNonInitializing();
+	entry.m_body = body;
+	entry.m_flags = flags;
+	entry.m_tier = BT_LOD_FULL_RATE;
+	entry.m_phase = 0;
+	entry.m_state = RUNNING;
+	entry.m_scale = 1;
+	entry.m_unsynchronized = false;
+
+	m_entryIndices.insert(btHashPtr(body), m_entries.size() - 1);
+}
+
+void	btSimulationLod::removeBody(btRigidBody* body)
+{
+	int index = findEntry(body);
+	if (index < 0)
+	{
+		return;
+	}
+
+	Entry& entry = m_entries[index];
+	if (entry.m_state == SUSPENDED)
+	{
+		resume(entry);
+	}
+	else if (entry.m_state == FROZEN)
+	{
+		thaw(entry);
+	}
+
+	int last = m_entries.size() - 1;
+	if (index != last)
+	{
+		m_entries[index] = m_entries[last];
+		m_entryIndices.insert(btHashPtr(m_entries[index].m_body), index);
+	}
+	m_entries.pop_back();
+	m_entryIndices.remove(btHashPtr(body));
+}
+
+void	btSimulationLod::setBodyFlags(btRigidBody* body, int flags)
+{
+	int index = findEntry(body);
+	if (index >= 0)
+	{
+		m_entries[index].m_flags = flags;
+	}
+}
+
+int	btSimulationLod::getBodyTier(const btRigidBody* body) const
+{
+	int index = findEntry(body);
+	return index >= 0 ? m_entries[index].m_tier : BT_LOD_FULL_RATE;
+}
+
+int	btSimulationLod::findGroup(int entry)
+{
+	while (m_groupParents[entry] != entry)
+	{
+		m_groupParents[entry] = m_groupParents[m_groupParents[entry]];
+		entry = m_groupParents[entry];
+	}
+	return entry;
+}
+
+void	btSimulationLod::uniteGroups(int entry0, int entry1)
+{
+	int root0 = findGroup(entry0);
+	int root1 = findGroup(entry1);
+	if (root0 == root1)
+	{
+		return;
+	}
+
+	// the lowest entry is the root, it gives the group its phase
+	if (root0 < root1)
+	{
+		m_groupParents[root1] = root0;
+	}
+	else
+	{
+		m_groupParents[root0] = root1;
+	}
+}
+
+void	btSimulationLod::linkGroups(const btCollisionObject* colObj, const btCollisionObject* other)
+{
+	int entry0 = findEntry(colObj);
+	int entry1 = findEntry(other);
+
+	if (entry0 >= 0 && entry1 >= 0)
+	{
+		uniteGroups(entry0, entry1);
+	}
+	// a dynamic body stepped every tick would wake the group in its island anyway
+	else if (entry0 >= 0 && other->mergesSimulationIslands())
+	{
+		m_groupPinned[entry0] = 1;
+	}
+	else if (entry1 >= 0 && colObj->mergesSimulationIslands())
+	{
+		m_groupPinned[entry1] = 1;
+	}
+}
+
+void	btSimulationLod::assignTiers(btDiscreteDynamicsWorld* world)
+{
+	BT_PROFILE("btSimulationLod::assignTiers");
+
+	const int numEntries = m_entries.size();
+
+	m_groupParents.resize(numEntries);
+	m_groupDistances.resize(numEntries);
+	m_groupTiers.resize(numEntries);
+	m_groupPinned.resize(numEntries);
+
+	for (int i = 0; i < numEntries; i++)
+	{
+		m_groupParents[i] = i;
+		m_groupDistances[i] = BT_LARGE_FLOAT;
+		m_groupTiers[i] = BT_LOD_FROZEN;
+		m_groupPinned[i] = (m_entries[i].m_flags & ALWAYS_FULL_RATE) ? 1 : 0;
+	}
+
+	// the same links the world builds its islands from
+	btBroadphasePairArray& pairs = world->getPairCache()->getOverlappingPairArray();
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		linkGroups((const btCollisionObject*)pairs[i].m_pProxy0->m_clientObject, (const btCollisionObject*)pairs[i].m_pProxy1->m_clientObject);
+	}
+
+	for (int i = 0; i < world->getNumConstraints(); i++)
+	{
+		const btTypedConstraint* constraint = world->getConstraint(i);
+		if (constraint->isEnabled())
+		{
+			linkGroups(&constraint->getRigidBodyA(), &constraint->getRigidBodyB());
+		}
+	}
+
+	const bool hasViewCone = !m_viewerDirection.fuzzyZero();
+
+	for (int i = 0; i < numEntries; i++)
+	{
+		const Entry& entry = m_entries[i];
+		int root = findGroup(i);
+
+		btVector3 toBody = entry.m_body->getWorldTransform().getOrigin() - m_viewerPosition;
+		btScalar distance = toBody.length();
+		if (hasViewCone && toBody.dot(m_viewerDirection) < m_viewerCosHalfAngle * distance)
+		{
+			distance *= m_settings.m_outOfViewScale;
+		}
+
+		m_groupDistances[root] = btMin(m_groupDistances[root], distance);
+		m_groupTiers[root] = btMin(m_groupTiers[root], entry.m_tier);
+		m_groupPinned[root] |= m_groupPinned[i];
+	}
+
+	memset(m_stats.m_numBodies, 0, sizeof(m_stats.m_numBodies));
+	memset(m_stats.m_numGroups, 0, sizeof(m_stats.m_numGroups));
+
+	for (int i = 0; i < numEntries; i++)
+	{
+		if (m_groupParents[i] != i)
+		{
+			continue;
+		}
+
+		// the group was at the lowest tier of its bodies, leaving it for a farther one takes the hysteresis
+		int lastTier = m_groupTiers[i];
+		int tier = BT_LOD_FULL_RATE;
+
+		if (!m_groupPinned[i])
+		{
+			for (int t = BT_LOD_REDUCED_RATE; t < BT_LOD_NUM_TIERS; t++)
+			{
+				btScalar threshold = m_settings.m_distances[t];
+				if (lastTier < t)
+				{
+					threshold *= btScalar(1.) + m_settings.m_hysteresis;
+				}
+				if (m_groupDistances[i] <= threshold)
+				{
+					break;
+				}
+				tier = t;
+			}
+		}
+
+		m_groupTiers[i] = tier;
+		m_stats.m_numGroups[tier]++;
+	}
+
+	for (int i = 0; i < numEntries; i++)
+	{
+		Entry& entry = m_entries[i];
+		int root = findGroup(i);
+		entry.m_tier = m_groupTiers[root];
+		entry.m_phase = root;
+		m_stats.m_numBodies[entry.m_tier]++;
+	}
+}
+
+void	btSimulationLod::suspend(Entry& entry)
+{
+	btRigidBody* body = entry.m_body;
+
+	entry.m_activationState = body->getActivationState();
+	entry.m_deactivationTime = body->getDeactivationTime();
+	entry.m_linearVelocity = body->getLinearVelocity();
+	entry.m_angularVelocity = body->getAngularVelocity();
+
+	body->forceActivationState(ISLAND_SLEEPING);
+	entry.m_state = SUSPENDED;
+}
+
+void	btSimulationLod::resume(Entry& entry)
+{
+	btRigidBody* body = entry.m_body;
+
+	// unless something woke it in the meantime
+	if (body->getActivationState() == ISLAND_SLEEPING)
+	{
+		body->forceActivationState(entry.m_activationState);
+		body->setDeactivationTime(entry.m_deactivationTime);
+		body->setLinearVelocity(entry.m_linearVelocity);
+		body->setAngularVelocity(entry.m_angularVelocity);
+	}
+	entry.m_state = RUNNING;
+}
+
+void	btSimulationLod::freeze(Entry& entry)
+{
+	btRigidBody* body = entry.m_body;
+
+	entry.m_activationState = body->getActivationState();
+	entry.m_deactivationTime = body->getDeactivationTime();
+	entry.m_linearVelocity = body->getLinearVelocity();
+	entry.m_angularVelocity = body->getAngularVelocity();
+	entry.m_collisionFlags = body->getCollisionFlags();
+	entry.m_mass = body->getInvMass() != btScalar(0.) ? btScalar(1.) / body->getInvMass() : btScalar(0.);
+	entry.m_localInertia = body->getLocalInertia();
+	entry.m_invInertiaTensorWorld = body->getInvInertiaTensorWorld();
+
+	// zero mass, so the solver can't move it, and kinematic, so nothing integrates it
+	body->setLinearVelocity(btVector3(0,0,0));
+	body->setAngularVelocity(btVector3(0,0,0));
+	body->setMassProps(btScalar(0.), btVector3(0,0,0));
+	body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+	body->forceActivationState(ISLAND_SLEEPING);
+
+	entry.m_state = FROZEN;
+	m_changedKinematic = true;
+}
+
+void	btSimulationLod::thaw(Entry& entry)
+{
+	btRigidBody* body = entry.m_body;
+
+	body->setMassProps(entry.m_mass, entry.m_localInertia);
+	body->setCollisionFlags(entry.m_collisionFlags);
+	body->setInvInertiaTensorWorld(entry.m_invInertiaTensorWorld);
+	body->forceActivationState(entry.m_activationState);
+	body->setDeactivationTime(entry.m_deactivationTime);
+	body->setLinearVelocity(entry.m_linearVelocity);
+	body->setAngularVelocity(entry.m_angularVelocity);
+
+	entry.m_state = RUNNING;
+	m_changedKinematic = true;
+}
+
+///In velocities multiplied by period the tick covers period ticks of motion: forces and gravity go in period squared, so
+///the velocity they add comes back divided by period, and the damping is compounded over the ticks.
+void	btSimulationLod::scale(Entry& entry, int period)
+{
+	btRigidBody* body = entry.m_body;
+	const btScalar p = btScalar(period);
+
+	entry.m_totalForce = body->getTotalForce();
+	entry.m_totalTorque = body->getTotalTorque();
+	entry.m_linearDamping = body->getLinearDamping();
+	entry.m_angularDamping = body->getAngularDamping();
+	entry.m_linearSleepingThreshold = body->getLinearSleepingThreshold();
+	entry.m_angularSleepingThreshold = body->getAngularSleepingThreshold();
+
+	body->setLinearVelocity(body->getLinearVelocity() * p);
+	body->setAngularVelocity(body->getAngularVelocity() * p);
+	body->applyCentralForce(btRemoveFactor(entry.m_totalForce * (p * p - btScalar(1.)), body->getLinearFactor()));
+	body->applyTorque(btRemoveFactor(entry.m_totalTorque * (p * p - btScalar(1.)), body->getAngularFactor()));
+	body->setDamping(btScalar(1.) - btPow(btScalar(1.) - entry.m_linearDamping, p),
+		btScalar(1.) - btPow(btScalar(1.) - entry.m_angularDamping, p));
+	body->setSleepingThresholds(entry.m_linearSleepingThreshold * p, entry.m_angularSleepingThreshold * p);
+
+	entry.m_scale = period;
+}
+
+void	btSimulationLod::unscale(Entry& entry, btScalar timeStep)
+{
+	btRigidBody* body = entry.m_body;
+	const btScalar p = btScalar(entry.m_scale);
+
+	body->setLinearVelocity(body->getLinearVelocity() / p);
+	body->setAngularVelocity(body->getAngularVelocity() / p);
+	body->setInterpolationLinearVelocity(body->getInterpolationLinearVelocity() / p);
+	body->setInterpolationAngularVelocity(body->getInterpolationAngularVelocity() / p);
+
+	// the forces of the step go on to its next ticks as they were
+	body->clearForces();
+	body->applyCentralForce(btRemoveFactor(entry.m_totalForce, body->getLinearFactor()));
+	body->applyTorque(btRemoveFactor(entry.m_totalTorque, body->getAngularFactor()));
+	body->setDamping(entry.m_linearDamping, entry.m_angularDamping);
+	body->setSleepingThresholds(entry.m_linearSleepingThreshold, entry.m_angularSleepingThreshold);
+
+	// it was still for all the ticks it stood for
+	if (body->getDeactivationTime() > btScalar(0.))
+	{
+		body->setDeactivationTime(body->getDeactivationTime() + (p - btScalar(1.)) * timeStep);
+	}
+
+	entry.m_scale = 1;
+}
+
+void	btSimulationLod::beginTick(btDiscreteDynamicsWorld* world, btScalar timeStep)
+{
+	BT_PROFILE("btSimulationLod::beginTick");
+	(void)timeStep;
+
+	if (m_tick % unsigned(m_settings.m_periods[BT_LOD_LOW_RATE]) == 0)
+	{
+		assignTiers(world);
+	}
+
+	m_changedKinematic = false;
+	m_stats.m_numSuspended = 0;
+
+	for (int i = 0; i < m_entries.size(); i++)
+	{
+		Entry& entry = m_entries[i];
+
+		if (entry.m_tier == BT_LOD_FROZEN)
+		{
+			if (entry.m_state == SUSPENDED)
+			{
+				resume(entry);
+			}
+			if (entry.m_state != FROZEN)
+			{
+				freeze(entry);
+			}
+			continue;
+		}
+
+		if (entry.m_state == FROZEN)
+		{
+			thaw(entry);
+		}
+
+		const int period = m_settings.m_periods[entry.m_tier];
+
+		if ((m_tick + unsigned(entry.m_phase)) % unsigned(period) == 0)
+		{
+			if (entry.m_state == SUSPENDED)
+			{
+				resume(entry);
+			}
+			if (period > 1 && entry.m_body->isActive())
+			{
+				scale(entry, period);
+			}
+		}
+		else if (entry.m_state == RUNNING && entry.m_body->isActive())
+		{
+			suspend(entry);
+		}
+
+		if (entry.m_state == SUSPENDED)
+		{
+			m_stats.m_numSuspended++;
+		}
+	}
+
+	if (m_changedKinematic && world->getIncrementalIslandManager())
+	{
+		world->getIncrementalIslandManager()->invalidateIslands();
+	}
+}
+
+void	btSimulationLod::endTick(btDiscreteDynamicsWorld* world, btScalar timeStep)
+{
+	(void)world;
+	BT_PROFILE("btSimulationLod::endTick");
+
+	m_stats.m_numStepped = 0;
+
+	for (int i = 0; i < m_entries.size(); i++)
+	{
+		Entry& entry = m_entries[i];
+
+		if (entry.m_scale > 1)
+		{
+			unscale(entry, timeStep);
+			entry.m_unsynchronized = true;
+		}
+
+		if (entry.m_state == SUSPENDED)
+		{
+			if (entry.m_body->getActivationState() == ISLAND_SLEEPING)
+			{
+				// updateActivationState zeroes the velocities of sleeping bodies
+				entry.m_body->setLinearVelocity(entry.m_linearVelocity);
+				entry.m_body->setAngularVelocity(entry.m_angularVelocity);
+			}
+			else
+			{
+				// woken through its island, it was stepped with the rest of it
+				entry.m_state = RUNNING;
+			}
+		}
+
+		if (entry.m_state == RUNNING && entry.m_body->isActive())
+		{
+			m_stats.m_numStepped++;
+		}
+	}
+
+	m_tick++;
+}
+
+void	btSimulationLod::applyGravity()
+{
+	for (int i = 0; i < m_entries.size(); i++)
+	{
+		if (m_entries[i].m_state == SUSPENDED)
+		{
+			m_entries[i].m_body->applyGravity();
+		}
+	}
+}
+
+void	btSimulationLod::synchronizeMotionStates(btDiscreteDynamicsWorld* world)
+{
+	for (int i = 0; i < m_entries.size(); i++)
+	{
+		Entry& entry = m_entries[i];
+
+		// awake bodies were written by the world
+		if (entry.m_unsynchronized && entry.m_state == SUSPENDED)
+		{
+			btRigidBody* body = entry.m_body;
+			body->forceActivationState(entry.m_activationState);
+			world->synchronizeSingleMotionState(body);
+			body->forceActivationState(ISLAND_SLEEPING);
+		}
+		entry.m_unsynchronized = false;
+	}
+}
+
+#pragma clang diagnostic pop
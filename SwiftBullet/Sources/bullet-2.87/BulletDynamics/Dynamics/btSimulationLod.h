@@ -0,0 +1,212 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+
+
+#ifndef BT_SIMULATION_LOD_H
+#define BT_SIMULATION_LOD_H
+
+#include "LinearMath/btVector3.h"
+#include "LinearMath/btMatrix3x3.h"
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btHashMap.h"
+
+class btCollisionObject;
+class btRigidBody;
+class btDiscreteDynamicsWorld;
+
+///tiers of btSimulationLod, from the viewer out
+enum btSimulationLodTier
+{
+	BT_LOD_FULL_RATE,
+	BT_LOD_REDUCED_RATE,
+	BT_LOD_LOW_RATE,
+	BT_LOD_FROZEN,
+	BT_LOD_NUM_TIERS
+};
+
+///btSimulationLod steps the islands of the bodies added to it less often the farther they are from the viewer, and freezes
+///the farthest into kinematic bodies until the viewer comes back. Hand it to btDiscreteDynamicsWorld::setSimulationLod.
+///Bodies are grouped the way the world builds islands, by overlapping pairs and constraints, every
+///m_periods[BT_LOD_LOW_RATE] ticks, and a group takes the tier of its nearest body; bodies outside the view cone count as
+///farther. A group of a stepped tier sleeps on the ticks in between and on its own tick moves as far as it would have in
+///all of them: velocities, forces and sleeping thresholds are scaled by the period and the damping compounded for the tick.
+///A group touching an ALWAYS_FULL_RATE body or a dynamic body that isn't added stays at full rate, so what the player
+///pushes moves every tick. A sleeping group woken by another one is stepped unscaled until the next grouping.
+///Frozen bodies get zero mass and CF_KINEMATIC_OBJECT, and everything they had back when they thaw.
+///btDiscreteDynamicsWorld::removeRigidBody removes the body from here too, call removeBody only to keep it in the world.
+class btSimulationLod
+{
+public:
+
+	enum
+	{
+		///keeps the group of the body at full rate whatever the distance, for bodies gameplay reads every frame
+		ALWAYS_FULL_RATE = 1
+	};
+
+	struct Settings
+	{
+		btScalar	m_distances[BT_LOD_NUM_TIERS];	//a group goes to tier i beyond m_distances[i], m_distances[0] is unused
+		int	m_periods[BT_LOD_FROZEN];	//ticks per step of the stepped tiers, each divides m_periods[BT_LOD_LOW_RATE]
+		btScalar	m_hysteresis;	//fraction of a distance a group has to be past it to drop to the next tier
+		btScalar	m_outOfViewScale;	//distance multiplier of bodies outside the view cone
+
+		Settings();
+	};
+
+	struct Stats
+	{
+		int	m_numBodies[BT_LOD_NUM_TIERS];
+		int	m_numGroups[BT_LOD_NUM_TIERS];
+		int	m_numStepped;	//bodies that took part in the last tick awake
+		int	m_numSuspended;	//bodies put to sleep for the last tick
+	};
+
+protected:
+
+	enum
+	{
+		RUNNING,
+		SUSPENDED,	//put to sleep for ticks its tier isn't stepped on
+		FROZEN
+	};
+
+	struct Entry
+	{
+		btRigidBody*	m_body;
+		int	m_flags;
+		int	m_tier;
+		int	m_phase;
+		int	m_state;
+		int	m_scale;	//period the body was scaled by for this tick, 1 when it wasn't
+		bool	m_unsynchronized;	//moved since its motion state was last written
+
+		//what the body had before it was suspended, scaled or frozen
+		int	m_activationState;
+		int	m_collisionFlags;
+		btScalar	m_deactivationTime;
+		btVector3	m_linearVelocity;
+		btVector3	m_angularVelocity;
+		btVector3	m_totalForce;
+		btVector3	m_totalTorque;
+		btScalar	m_linearDamping;
+		btScalar	m_angularDamping;
+		btScalar	m_linearSleepingThreshold;
+		btScalar	m_angularSleepingThreshold;
+		btScalar	m_mass;
+		btVector3	m_localInertia;
+		btMatrix3x3	m_invInertiaTensorWorld;
+	};
+
+	Settings	m_settings;
+
+	btVector3	m_viewerPosition;
+	btVector3	m_viewerDirection;
+	btScalar	m_viewerCosHalfAngle;
+
+	btAlignedObjectArray<Entry>	m_entries;
+	btHashMap<btHashPtr, int>	m_entryIndices;
+
+	btAlignedObjectArray<int>	m_groupParents;
+	btAlignedObjectArray<btScalar>	m_groupDistances;
+	btAlignedObjectArray<int>	m_groupTiers;
+	btAlignedObjectArray<unsigned char>	m_groupPinned;
+
+	unsigned int	m_tick;
+	bool	m_changedKinematic;
+	Stats	m_stats;
+
+	int	findEntry(const btCollisionObject* colObj) const;
+	int	findGroup(int entry);
+	void	uniteGroups(int entry0, int entry1);
+	void	linkGroups(const btCollisionObject* colObj, const btCollisionObject* other);
+
+	void	assignTiers(btDiscreteDynamicsWorld* world);
+
+	void	suspend(Entry& entry);
+	void	resume(Entry& entry);
+	void	freeze(Entry& entry);
+	void	thaw(Entry& entry);
+	void	scale(Entry& entry, int period);
+	void	unscale(Entry& entry, btScalar timeStep);
+
+public:
+
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	btSimulationLod();
+
+	virtual ~btSimulationLod();
+
+	const Settings&	getSettings() const
+	{
+		return m_settings;
+	}
+
+	///takes effect at the next grouping
+	void	setSettings(const Settings& settings);
+
+	///direction may be zero for no view cone, bodies outside the cone count m_outOfViewScale times as far
+	void	setViewer(const btVector3& position, const btVector3& direction, btScalar cosHalfAngle);
+
+	///body must be a dynamic body in the world, it starts at full rate
+	void	addBody(btRigidBody* body, int flags = 0);
+
+	///gives the body back everything it had, only needed to keep the body in the world since removeRigidBody calls it
+	void	removeBody(btRigidBody* body);
+
+	void	setBodyFlags(btRigidBody* body, int flags);
+
+	int	getNumBodies() const
+	{
+		return m_entries.size();
+	}
+
+	///BT_LOD_FULL_RATE for bodies that weren't added
+	int	getBodyTier(const btRigidBody* body) const;
+
+	///counts of the last grouping and the last tick
+	const Stats&	getStats() const
+	{
+		return m_stats;
+	}
+
+	///called by the world around each internal tick
+	void	beginTick(btDiscreteDynamicsWorld* world, btScalar timeStep);
+	void	endTick(btDiscreteDynamicsWorld* world, btScalar timeStep);
+
+	///called by the world after its own, the bodies asleep for their tier get gravity for the ticks they are stepped on
+	void	applyGravity();
+
+	///called by the world after its own, writes the motion states of bodies that moved on a tick and sleep again since
+	void	synchronizeMotionStates(btDiscreteDynamicsWorld* world);
+};
+
+#endif //BT_SIMULATION_LOD_H
+
+#pragma clang diagnostic pop
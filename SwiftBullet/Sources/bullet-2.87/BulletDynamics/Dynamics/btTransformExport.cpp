@@ -0,0 +1,139 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+
+#include "btTransformExport.h"
+#include "btRigidBody.h"
+#include "LinearMath/btMotionState.h"
+
+btTransformExport::btTransformExport()
+:m_positions(0),
+m_rotations(0),
+m_matrices(0),
+m_capacity(0),
+m_numIndices(0)
+{
+}
+
+btTransformExport::~btTransformExport()
+{
+}
+
+void	btTransformExport::setBuffers(btScalar* positions, btScalar* rotations, btScalar* matrices, int capacity)
+{
+	m_positions = positions;
+	m_rotations = rotations;
+	m_matrices = matrices;
+	m_capacity = capacity;
+}
+
+int	btTransformExport::addBody(btRigidBody* body)
+{
+	btAssert(body->getTransformExportIndex() < 0);
+
+	int index;
+	if (m_freeIndices.size())
+	{
+		index = m_freeIndices[m_freeIndices.size() - 1];
+		m_freeIndices.pop_back();
+	}
+	else
+	{
+		index = m_numIndices++;
+		m_isDirty.push_back(0);
+	}
+
+	body->setTransformExportIndex(index);
+
+	btTransform transform;
+	if (body->getMotionState())
+		body->getMotionState()->getWorldTransform(transform);
+	else
+		transform = body->getWorldTransform();
+	writeTransform(index, transform);
+
+	return index;
+}
+
+void	btTransformExport::removeBody(btRigidBody* body)
+{
+	int index = body->getTransformExportIndex();
+	if (index < 0)
+		return;
+
+	body->setTransformExportIndex(-1);
+	m_freeIndices.push_back(index);
+}
+
+void	btTransformExport::writeTransform(int index, const btTransform& transform)
+{
+	btAssert(index < m_capacity);
+	if (index >= m_capacity)
+		return;
+
+	if (m_positions)
+	{
+		btScalar* position = m_positions + index * 4;
+		position[0] = transform.getOrigin().x();
+		position[1] = transform.getOrigin().y();
+		position[2] = transform.getOrigin().z();
+		position[3] = btScalar(0.);
+	}
+
+	if (m_rotations)
+	{
+		btQuaternion rotation = transform.getRotation();
+		btScalar* out = m_rotations + index * 4;
+		out[0] = rotation.x();
+		out[1] = rotation.y();
+		out[2] = rotation.z();
+		out[3] = rotation.w();
+	}
+
+	if (m_matrices)
+	{
+		transform.getOpenGLMatrix(m_matrices + index * 16);
+	}
+
+	if (!m_isDirty[index])
+	{
+		m_isDirty[index] = 1;
+		m_dirtyIndices.push_back(index);
+	}
+}
+
+void	btTransformExport::clearDirtyIndices()
+{
+	for (int i = 0; i < m_dirtyIndices.size(); i++)
+	{
+		m_isDirty[m_dirtyIndices[i]] = 0;
+	}
+	m_dirtyIndices.resize(0);
+}
+
+
+#pragma clang diagnostic pop
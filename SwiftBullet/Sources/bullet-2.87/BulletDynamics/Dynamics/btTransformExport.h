@@ -0,0 +1,88 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+
+#ifndef BT_TRANSFORM_EXPORT_H
+#define BT_TRANSFORM_EXPORT_H
+
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btAlignedObjectArray.h"
+
+class btRigidBody;
+
+///btTransformExport collects the interpolated transforms that btDiscreteDynamicsWorld::synchronizeMotionStates computes
+///into arrays owned by the caller, so an instance buffer takes them with one copy instead of a btMotionState call per body.
+///Bodies get an index with addBody. Only awake bodies are written, sleeping ones keep their last transform, and the index
+///of every written body goes into the dirty list once until clearDirtyIndices.
+class btTransformExport
+{
+protected:
+
+	btScalar*	m_positions; //4 per body, x y z 0
+	btScalar*	m_rotations; //4 per body, quaternion x y z w
+	btScalar*	m_matrices; //16 per body, column major
+	int	m_capacity;
+
+	btAlignedObjectArray<int>	m_freeIndices;
+	int	m_numIndices;
+
+	btAlignedObjectArray<unsigned char>	m_isDirty;
+	btAlignedObjectArray<int>	m_dirtyIndices;
+
+public:
+
+	btTransformExport();
+
+	virtual ~btTransformExport();
+
+	///any of the arrays may be null, capacity is the number of bodies each of them holds
+	void	setBuffers(btScalar* positions, btScalar* rotations, btScalar* matrices, int capacity);
+
+	///index of body in the arrays, written right away with its current transform
+	int	addBody(btRigidBody* body);
+
+	void	removeBody(btRigidBody* body);
+
+	int	getNumIndices() const
+	{
+		return m_numIndices;
+	}
+
+	void	writeTransform(int index, const btTransform& transform);
+
+	const btAlignedObjectArray<int>&	getDirtyIndices() const
+	{
+		return m_dirtyIndices;
+	}
+
+	void	clearDirtyIndices();
+};
+
+#endif //BT_TRANSFORM_EXPORT_H
+
+
+#pragma clang diagnostic pop
@@ -0,0 +1,496 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "btWorldSnapshot.h"
+#include "btDiscreteDynamicsWorld.h"
+#include "btRigidBody.h"
+#include "btTransformExport.h"
+#include "BulletCollision/BroadphaseCollision/btCollisionAlgorithm.h"
+#include "BulletCollision/BroadphaseCollision/btDbvtBroadphase.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
+#include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
+
+#include <string.h> //memcpy
+
+static int	btAlign16(int size)
+{
+	return (size + 15) & ~15;
+}
+
+template<class T>
+static T*	btSnapshotSection(unsigned char* buffer, int offset)
+{
+	return reinterpret_cast<T*>(buffer + offset);
+}
+
+static void	btFirstPointFeature(const btManifoldPoint* point, int feature[4])
+{
+	if (point)
+	{
+		feature[0] = point->m_partId0;
+		feature[1] = point->m_index0;
+		feature[2] = point->m_partId1;
+		feature[3] = point->m_index1;
+	} else
+	{
+		feature[0] = feature[1] = feature[2] = feature[3] = -1;
+	}
+}
+
+static void	btSaveObject(btCollisionObject* colObj, btDbvtBroadphase* broadphase, int index, btWorldSnapshot::ObjectRecord& record)
+{
+	record.m_worldTransform = colObj->getWorldTransform();
+	record.m_interpolationWorldTransform = colObj->getInterpolationWorldTransform();
+	record.m_interpolationLinearVelocity = colObj->getInterpolationLinearVelocity();
+	record.m_interpolationAngularVelocity = colObj->getInterpolationAngularVelocity();
+	record.m_index = index;
+	record.m_activationState = colObj->getActivationState();
+	record.m_deactivationTime = colObj->getDeactivationTime();
+	record.m_hitFraction = colObj->getHitFraction();
+
+	btBroadphaseProxy* proxy = colObj->getBroadphaseHandle();
+	record.m_aabbMin = proxy->m_aabbMin;
+	record.m_aabbMax = proxy->m_aabbMax;
+	broadphase->getProxyState(proxy, record.m_volume, record.m_stage);
+
+	btRigidBody* body = btRigidBody::upcast(colObj);
+	if (body)
+	{
+		record.m_linearVelocity = body->getLinearVelocity();
+		record.m_angularVelocity = body->getAngularVelocity();
+		record.m_totalForce = body->getTotalForce();
+		record.m_totalTorque = body->getTotalTorque();
+		record.m_invInertiaTensorWorld = body->getInvInertiaTensorWorld();
+	} else
+	{
+		record.m_linearVelocity.setZero();
+		record.m_angularVelocity.setZero();
+		record.m_totalForce.setZero();
+		record.m_totalTorque.setZero();
+		record.m_invInertiaTensorWorld.setValue(0, 0, 0, 0, 0, 0, 0, 0, 0);
+	}
+}
+
+//the offsets of the sections follow from the counts in the header
+struct btSnapshotLayout
+{
+	int	m_objects;
+	int	m_points;
+	int	m_manifolds;
+	int	m_pairs;
+	int	m_constraints;
+	int	m_size;
+
+	btSnapshotLayout(const btWorldSnapshot::Header& header)
+	{
+		m_objects = btAlign16(sizeof(btWorldSnapshot::Header));
+		m_points = btAlign16(m_objects + header.m_numObjects * int(sizeof(btWorldSnapshot::ObjectRecord)));
+		m_manifolds = btAlign16(m_points + header.m_numPoints * int(sizeof(btManifoldPoint)));
+		m_pairs = m_manifolds + header.m_numManifolds * int(sizeof(btWorldSnapshot::ManifoldRecord));
+		m_constraints = btAlign16(m_pairs + header.m_numPairs * int(sizeof(btWorldSnapshot::PairRecord)));
+		m_size = m_constraints + header.m_numConstraints * int(sizeof(btWorldSnapshot::ConstraintRecord));
+	}
+};
+
+btWorldSnapshot::btWorldSnapshot()
+:m_numLostManifolds(0)
+{
+}
+
+btWorldSnapshot::~btWorldSnapshot()
+{
+}
+
+int	btWorldSnapshot::getSize(const Header& header)
+{
+	return btSnapshotLayout(header).m_size;
+}
+
+void	btWorldSnapshot::enableDeterministicStepping(btDiscreteDynamicsWorld* world)
+{
+	world->getDispatchInfo().m_deterministicOverlappingPairs = true;
+
+	btDbvtBroadphase* broadphase = static_cast<btDbvtBroadphase*>(world->getBroadphase());
+	broadphase->m_cupdates = 100;
+	broadphase->m_cid = 0;
+}
+
+void	btWorldSnapshot::setBuffer(const void* data, int size)
+{
+	m_buffer.resize(size);
+	if (size)
+		memcpy(&m_buffer[0], data, size);
+}
+
+void	btWorldSnapshot::capture(btDiscreteDynamicsWorld* world)
+{
+	btCollisionObjectArray& objects = world->getCollisionObjectArray();
+	btDbvtBroadphase* broadphase = static_cast<btDbvtBroadphase*>(world->getBroadphase());
+
+	Header header;
+	header.m_magic = MAGIC;
+	header.m_version = VERSION;
+	header.m_scalarSize = sizeof(btScalar);
+	header.m_numCollisionObjects = objects.size();
+	header.m_numConstraints = world->getNumConstraints();
+	header.m_numObjects = 0;
+	header.m_stageCurrent = broadphase->m_stageCurrent;
+	header.m_solverSeed = 0;
+	header.m_localTime = world->getLocalTime();
+
+	btConstraintSolver* solver = world->getConstraintSolver();
+	if (solver && solver->getSolverType() == BT_SEQUENTIAL_IMPULSE_SOLVER)
+		header.m_solverSeed = (unsigned int)static_cast<btSequentialImpulseConstraintSolver*>(solver)->getRandSeed();
+
+	for (int i = 0; i < objects.size(); i++)
+	{
+		if (!objects[i]->isStaticObject() && objects[i]->getBroadphaseHandle())
+			header.m_numObjects++;
+	}
+
+	btOverlappingPairCache* pairCache = broadphase->getOverlappingPairCache();
+	header.m_numPairs = pairCache->getNumOverlappingPairs();
+
+	btDispatcher* dispatcher = world->getDispatcher();
+	header.m_numManifolds = 0;
+	header.m_numPoints = 0;
+	for (int i = 0; i < dispatcher->getNumManifolds(); i++)
+	{
+		int numContacts = dispatcher->getManifoldByIndexInternal(i)->getNumContacts();
+		if (numContacts)
+		{
+			header.m_numManifolds++;
+			header.m_numPoints += numContacts;
+		}
+	}
+
+	btSnapshotLayout layout(header);
+	m_buffer.resize(layout.m_size);
+	unsigned char* buffer = &m_buffer[0];
+	memcpy(buffer, &header, sizeof(Header));
+
+	ObjectRecord* records = btSnapshotSection<ObjectRecord>(buffer, layout.m_objects);
+	for (int i = 0; i < objects.size(); i++)
+	{
+		btCollisionObject* colObj = objects[i];
+		if (colObj->isStaticObject() || !colObj->getBroadphaseHandle())
+			continue;
+
+		btSaveObject(colObj, broadphase, i, *records++);
+	}
+
+	btManifoldPoint* points = btSnapshotSection<btManifoldPoint>(buffer, layout.m_points);
+	ManifoldRecord* manifolds = btSnapshotSection<ManifoldRecord>(buffer, layout.m_manifolds);
+	for (int i = 0; i < dispatcher->getNumManifolds(); i++)
+	{
+		const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+		if (!manifold->getNumContacts())
+			continue;
+
+		ManifoldRecord& record = *manifolds++;
+		record.m_index0 = manifold->getBody0()->getWorldArrayIndex();
+		record.m_index1 = manifold->getBody1()->getWorldArrayIndex();
+		record.m_numPoints = manifold->getNumContacts();
+		record.m_dispatcherIndex = i;
+		for (int j = 0; j < manifold->getNumContacts(); j++)
+			*points++ = manifold->getContactPoint(j);
+	}
+
+	const btBroadphasePairArray& pairs = pairCache->getOverlappingPairArray();
+	PairRecord* pairRecords = btSnapshotSection<PairRecord>(buffer, layout.m_pairs);
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		pairRecords[i].m_index0 = static_cast<btCollisionObject*>(pairs[i].m_pProxy0->m_clientObject)->getWorldArrayIndex();
+		pairRecords[i].m_index1 = static_cast<btCollisionObject*>(pairs[i].m_pProxy1->m_clientObject)->getWorldArrayIndex();
+	}
+
+	ConstraintRecord* constraints = btSnapshotSection<ConstraintRecord>(buffer, layout.m_constraints);
+	for (int i = 0; i < header.m_numConstraints; i++)
+	{
+		const btTypedConstraint* constraint = world->getConstraint(i);
+		constraints[i].m_appliedImpulse = constraint->getAppliedImpulse();
+		constraints[i].m_enabled = constraint->isEnabled() ? 1 : 0;
+	}
+}
+
+void	btWorldSnapshot::restorePairs(btDiscreteDynamicsWorld* world, const Header& header)
+{
+	btCollisionObjectArray& objects = world->getCollisionObjectArray();
+	btOverlappingPairCache* pairCache = world->getBroadphase()->getOverlappingPairCache();
+	btBroadphasePairArray& pairs = pairCache->getOverlappingPairArray();
+	btDispatcher* dispatcher = world->getDispatcher();
+
+	btSnapshotLayout layout(header);
+	const PairRecord* saved = btSnapshotSection<PairRecord>(&m_buffer[0], layout.m_pairs);
+
+	m_isMatched.resize(pairs.size());
+	for (int i = 0; i < pairs.size(); i++)
+		m_isMatched[i] = 0;
+
+	m_pairsToAdd.resize(0);
+	for (int i = 0; i < header.m_numPairs; i++)
+	{
+		btBroadphaseProxy* proxy0 = objects[saved[i].m_index0]->getBroadphaseHandle();
+		btBroadphaseProxy* proxy1 = objects[saved[i].m_index1]->getBroadphaseHandle();
+
+		//pairs only move in the array when one before them is removed
+		if (i < pairs.size() && pairs[i].m_pProxy0 == proxy0 && pairs[i].m_pProxy1 == proxy1)
+		{
+			m_isMatched[i] = 1;
+			continue;
+		}
+
+		btBroadphasePair* pair = pairCache->findPair(proxy0, proxy1);
+		if (pair)
+			m_isMatched[int(pair - &pairs[0])] = 1;
+		else
+			m_pairsToAdd.push_back(saved[i]);
+	}
+
+	//removing moves pairs around in the array, so they are collected first
+	m_pairsToRemove.resize(0);
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		if (m_isMatched[i])
+			continue;
+		PairRecord pair;
+		pair.m_index0 = static_cast<btCollisionObject*>(pairs[i].m_pProxy0->m_clientObject)->getWorldArrayIndex();
+		pair.m_index1 = static_cast<btCollisionObject*>(pairs[i].m_pProxy1->m_clientObject)->getWorldArrayIndex();
+		m_pairsToRemove.push_back(pair);
+	}
+
+	for (int i = 0; i < m_pairsToRemove.size(); i++)
+	{
+		pairCache->removeOverlappingPair(objects[m_pairsToRemove[i].m_index0]->getBroadphaseHandle(), objects[m_pairsToRemove[i].m_index1]->getBroadphaseHandle(), dispatcher);
+	}
+	for (int i = 0; i < m_pairsToAdd.size(); i++)
+	{
+		pairCache->addOverlappingPair(objects[m_pairsToAdd[i].m_index0]->getBroadphaseHandle(), objects[m_pairsToAdd[i].m_index1]->getBroadphaseHandle());
+	}
+}
+
+btPersistentManifold*	btWorldSnapshot::findManifold(btDiscreteDynamicsWorld* world, const ManifoldRecord& record, const btManifoldPoint* points)
+{
+	btCollisionObjectArray& objects = world->getCollisionObjectArray();
+	btCollisionDispatcher* dispatcher = static_cast<btCollisionDispatcher*>(world->getDispatcher());
+
+	btCollisionObject* body0 = objects[record.m_index0];
+	btCollisionObject* body1 = objects[record.m_index1];
+
+	int feature[4];
+	btFirstPointFeature(points, feature);
+
+	if (record.m_dispatcherIndex < dispatcher->getNumManifolds())
+	{
+		btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(record.m_dispatcherIndex);
+		int current[4];
+		btFirstPointFeature(manifold->getNumContacts() ? &manifold->getContactPoint(0) : 0, current);
+		if (manifold->getBody0() == body0 && manifold->getBody1() == body1 && !m_isMatched[record.m_dispatcherIndex] &&
+			(!manifold->getNumContacts() || !memcmp(feature, current, sizeof(feature))))
+			return manifold;
+	}
+
+	btBroadphasePair* pair = world->getBroadphase()->getOverlappingPairCache()->findPair(body0->getBroadphaseHandle(), body1->getBroadphaseHandle());
+	if (!pair)
+		return 0;
+
+	m_manifoldArray.resize(0);
+	if (pair->m_algorithm)
+		pair->m_algorithm->getAllContactManifolds(m_manifoldArray);
+	if (!m_manifoldArray.size())
+	{
+		//the pair lost its manifold since the capture or was just added again, a narrowphase pass makes one
+		dispatcher->getNearCallback()(*pair, *dispatcher, world->getDispatchInfo());
+		if (pair->m_algorithm)
+			pair->m_algorithm->getAllContactManifolds(m_manifoldArray);
+		while (m_isMatched.size() < dispatcher->getNumManifolds())
+			m_isMatched.push_back(0);
+	}
+
+	//the manifold of the same child pair for compounds, any free one of the pair otherwise
+	btPersistentManifold* match = 0;
+	for (int i = 0; i < m_manifoldArray.size(); i++)
+	{
+		btPersistentManifold* manifold = m_manifoldArray[i];
+		if (manifold->getBody0() != body0 || manifold->getBody1() != body1 || m_isMatched[manifold->m_index1a])
+			continue;
+		if (!match)
+			match = manifold;
+
+		int current[4];
+		btFirstPointFeature(manifold->getNumContacts() ? &manifold->getContactPoint(0) : 0, current);
+		if (!memcmp(feature, current, sizeof(feature)))
+			return manifold;
+	}
+	return match;
+}
+
+void	btWorldSnapshot::restoreManifolds(btDiscreteDynamicsWorld* world, const Header& header)
+{
+	btDispatcher* dispatcher = world->getDispatcher();
+
+	btSnapshotLayout layout(header);
+	const ManifoldRecord* saved = btSnapshotSection<ManifoldRecord>(&m_buffer[0], layout.m_manifolds);
+	const btManifoldPoint* points = btSnapshotSection<btManifoldPoint>(&m_buffer[0], layout.m_points);
+
+	//by the index the dispatcher keeps in every manifold
+	m_isMatched.resize(dispatcher->getNumManifolds());
+	for (int i = 0; i < m_isMatched.size(); i++)
+		m_isMatched[i] = 0;
+
+	for (int i = 0; i < header.m_numManifolds; i++)
+	{
+		const btManifoldPoint* savedPoints = points;
+		points += saved[i].m_numPoints;
+
+		btPersistentManifold* manifold = findManifold(world, saved[i], savedPoints);
+		if (!manifold)
+		{
+			m_numLostManifolds++;
+			continue;
+		}
+
+		m_isMatched[manifold->m_index1a] = 1;
+		manifold->setNumContacts(saved[i].m_numPoints);
+		for (int j = 0; j < saved[i].m_numPoints; j++)
+			manifold->getContactPoint(j) = savedPoints[j];
+	}
+
+	for (int i = 0; i < dispatcher->getNumManifolds(); i++)
+	{
+		btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+		if (!m_isMatched[i] && manifold->getNumContacts())
+			manifold->clearManifold();
+	}
+}
+
+bool	btWorldSnapshot::restore(btDiscreteDynamicsWorld* world, bool synchronizeMotionStates)
+{
+	m_numLostManifolds = 0;
+
+	if (m_buffer.size() < int(sizeof(Header)))
+		return false;
+
+	Header header;
+	memcpy(&header, &m_buffer[0], sizeof(Header));
+
+	btCollisionObjectArray& objects = world->getCollisionObjectArray();
+	if (header.m_magic != MAGIC || header.m_version != VERSION || header.m_scalarSize != int(sizeof(btScalar)) ||
+		header.m_numCollisionObjects != objects.size() || header.m_numConstraints != world->getNumConstraints() ||
+		getSize(header) != m_buffer.size())
+		return false;
+
+	btSnapshotLayout layout(header);
+	const ObjectRecord* records = btSnapshotSection<ObjectRecord>(&m_buffer[0], layout.m_objects);
+
+	for (int i = 0; i < header.m_numObjects; i++)
+	{
+		int index = records[i].m_index;
+		if (index < 0 || index >= objects.size() || objects[index]->isStaticObject() || !objects[index]->getBroadphaseHandle())
+			return false;
+	}
+
+	btDbvtBroadphase* broadphase = static_cast<btDbvtBroadphase*>(world->getBroadphase());
+
+	//objects that haven't changed since the capture, sleeping ones mostly, are left alone
+	const bool sameTime = world->getLocalTime() == header.m_localTime;
+	const int compareSize = int(reinterpret_cast<const char*>(&records[0].m_hitFraction + 1) - reinterpret_cast<const char*>(&records[0]));
+	ObjectRecord current;
+	m_isChanged.resize(header.m_numObjects);
+
+	for (int i = 0; i < header.m_numObjects; i++)
+	{
+		const ObjectRecord& record = records[i];
+		btCollisionObject* colObj = objects[record.m_index];
+
+		btSaveObject(colObj, broadphase, record.m_index, current);
+		m_isChanged[i] = !sameTime || memcmp(&current, &record, compareSize);
+		if (!m_isChanged[i])
+			continue;
+
+		colObj->setWorldTransform(record.m_worldTransform);
+		colObj->setInterpolationWorldTransform(record.m_interpolationWorldTransform);
+		colObj->setInterpolationLinearVelocity(record.m_interpolationLinearVelocity);
+		colObj->setInterpolationAngularVelocity(record.m_interpolationAngularVelocity);
+		colObj->forceActivationState(record.m_activationState);
+		colObj->setDeactivationTime(record.m_deactivationTime);
+		colObj->setHitFraction(record.m_hitFraction);
+
+		btBroadphaseProxy* proxy = colObj->getBroadphaseHandle();
+		proxy->m_aabbMin = record.m_aabbMin;
+		proxy->m_aabbMax = record.m_aabbMax;
+		broadphase->setProxyState(proxy, record.m_volume, record.m_stage);
+
+		btRigidBody* body = btRigidBody::upcast(colObj);
+		if (body)
+		{
+			body->setLinearVelocity(record.m_linearVelocity);
+			body->setAngularVelocity(record.m_angularVelocity);
+			body->setTotalForce(record.m_totalForce);
+			body->setTotalTorque(record.m_totalTorque);
+			body->setInvInertiaTensorWorld(record.m_invInertiaTensorWorld);
+		}
+	}
+	broadphase->m_stageCurrent = header.m_stageCurrent;
+
+	restorePairs(world, header);
+	restoreManifolds(world, header);
+
+	const ConstraintRecord* constraints = btSnapshotSection<ConstraintRecord>(&m_buffer[0], layout.m_constraints);
+	for (int i = 0; i < header.m_numConstraints; i++)
+	{
+		btTypedConstraint* constraint = world->getConstraint(i);
+		constraint->internalSetAppliedImpulse(constraints[i].m_appliedImpulse);
+		constraint->setEnabled(constraints[i].m_enabled != 0);
+	}
+
+	btConstraintSolver* solver = world->getConstraintSolver();
+	if (solver && solver->getSolverType() == BT_SEQUENTIAL_IMPULSE_SOLVER)
+		static_cast<btSequentialImpulseConstraintSolver*>(solver)->setRandSeed(header.m_solverSeed);
+
+	world->setLocalTime(header.m_localTime);
+
+	if (!synchronizeMotionStates)
+		return true;
+
+	btTransformExport* transformExport = world->getTransformExport();
+	for (int i = 0; i < header.m_numObjects; i++)
+	{
+		btRigidBody* body = btRigidBody::upcast(objects[records[i].m_index]);
+		if (!body || !m_isChanged[i])
+			continue;
+		world->synchronizeSingleMotionState(body);
+		if (transformExport && body->getTransformExportIndex() >= 0 && !body->isActive())
+			transformExport->writeTransform(body->getTransformExportIndex(), body->getWorldTransform());
+	}
+
+	return true;
+}
+
+
+#pragma clang diagnostic pop
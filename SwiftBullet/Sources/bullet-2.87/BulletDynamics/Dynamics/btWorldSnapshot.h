@@ -0,0 +1,178 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef BT_WORLD_SNAPSHOT_H
+#define BT_WORLD_SNAPSHOT_H
+
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btAlignedObjectArray.h"
+#include "BulletCollision/BroadphaseCollision/btDbvt.h"
+
+class btDiscreteDynamicsWorld;
+class btPersistentManifold;
+class btManifoldPoint;
+typedef btAlignedObjectArray<btPersistentManifold*> btManifoldArray;
+
+///btWorldSnapshot saves the state a btDiscreteDynamicsWorld changes while it steps into one flat buffer and writes it back
+///in place, for rollback and replays. It holds the transforms, velocities, forces and activation of every object that isn't
+///static, their broadphase boxes, the overlapping pairs, the contact points with their warm starting impulses, the applied
+///impulse of the constraints and the time left over for interpolation. Objects are found by their index in the collision
+///object array, so restore expects the world to hold the same objects and constraints in the same order as at capture,
+///and returns false otherwise. Static objects are not saved, take snapshots after the first step.
+///Stepping on from a restored snapshot gives the same results as stepping on from the capture only with
+///enableDeterministicStepping, called before the first step, and a btDbvtBroadphase with its default pair cache.
+///State outside of the world isn't saved: actions such as character controllers, contact event queues and trigger managers
+///keep theirs, and the user persistent data of contact points is written back as it was saved.
+class btWorldSnapshot
+{
+public:
+
+	struct Header
+	{
+		int	m_magic;
+		int	m_version;
+		int	m_scalarSize;
+		int	m_numCollisionObjects; //in the world, checked on restore
+		int	m_numConstraints;
+		int	m_numObjects; //saved ones
+		int	m_numPairs;
+		int	m_numManifolds;
+		int	m_numPoints;
+		int	m_stageCurrent;
+		unsigned int	m_solverSeed;
+		btScalar	m_localTime;
+	};
+
+	ATTRIBUTE_ALIGNED16(struct) ObjectRecord
+	{
+		btTransform	m_worldTransform;
+		btTransform	m_interpolationWorldTransform;
+		btVector3	m_interpolationLinearVelocity;
+		btVector3	m_interpolationAngularVelocity;
+		btVector3	m_linearVelocity;
+		btVector3	m_angularVelocity;
+		btVector3	m_totalForce;
+		btVector3	m_totalTorque;
+		btMatrix3x3	m_invInertiaTensorWorld;
+		btVector3	m_aabbMin; //proxy box
+		btVector3	m_aabbMax;
+		btDbvtVolume	m_volume; //broadphase leaf, fattened while the object moves
+		int	m_index;
+		int	m_activationState;
+		int	m_stage;
+		btScalar	m_deactivationTime;
+		btScalar	m_hitFraction;
+	};
+
+	///collision object indices of the two proxies, in the order of the pair array at capture
+	struct PairRecord
+	{
+		int	m_index0;
+		int	m_index1;
+	};
+
+	///collision object indices of body0 and body1, the contact points follow in the same order.
+	///m_dispatcherIndex is where the manifold was at capture, most of them are still there on restore
+	struct ManifoldRecord
+	{
+		int	m_index0;
+		int	m_index1;
+		int	m_numPoints;
+		int	m_dispatcherIndex;
+	};
+
+	struct ConstraintRecord
+	{
+		btScalar	m_appliedImpulse;
+		int	m_enabled;
+	};
+
+	enum
+	{
+		MAGIC = 0x53535442, //BTSS
+		VERSION = 1
+	};
+
+protected:
+
+	btAlignedObjectArray<unsigned char>	m_buffer;
+	int	m_numLostManifolds;
+
+	btAlignedObjectArray<PairRecord>	m_pairsToAdd;
+	btAlignedObjectArray<PairRecord>	m_pairsToRemove;
+	btAlignedObjectArray<unsigned char>	m_isMatched;
+	btAlignedObjectArray<unsigned char>	m_isChanged;
+	btManifoldArray	m_manifoldArray;
+
+	static int	getSize(const Header& header);
+
+	btPersistentManifold*	findManifold(btDiscreteDynamicsWorld* world, const ManifoldRecord& record, const btManifoldPoint* points);
+
+	void	restorePairs(btDiscreteDynamicsWorld* world, const Header& header);
+	void	restoreManifolds(btDiscreteDynamicsWorld* world, const Header& header);
+
+public:
+
+	btWorldSnapshot();
+
+	virtual ~btWorldSnapshot();
+
+	///the solver orders manifolds and constraints by body, and the broadphase rechecks every pair after each step,
+	///so the pair array order, which a restore changes, doesn't reach the results
+	static void	enableDeterministicStepping(btDiscreteDynamicsWorld* world);
+
+	///between two steps, the buffer keeps its capacity for the next capture
+	void	capture(btDiscreteDynamicsWorld* world);
+
+	///false when the buffer doesn't match the world, which is then left untouched. Motion states and the transform
+	///export of the restored bodies are brought up to date unless synchronizeMotionStates is false, as a rollback that
+	///steps right after restoring doesn't need them
+	bool	restore(btDiscreteDynamicsWorld* world, bool synchronizeMotionStates = true);
+
+	const unsigned char*	getBuffer() const
+	{
+		return m_buffer.size() ? &m_buffer[0] : 0;
+	}
+
+	int	getBufferSize() const
+	{
+		return m_buffer.size();
+	}
+
+	///copies a buffer from getBuffer, of the same build, for restore
+	void	setBuffer(const void* data, int size);
+
+	///manifolds of the last restore that had no counterpart in the world, and no pair to create one for
+	int	getNumLostManifolds() const
+	{
+		return m_numLostManifolds;
+	}
+};
+
+#endif //BT_WORLD_SNAPSHOT_H
+
+
+#pragma clang diagnostic pop
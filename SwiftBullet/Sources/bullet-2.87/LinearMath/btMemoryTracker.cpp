@@ -0,0 +1,384 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btMemoryTracker.h"
+#include "btAlignedAllocator.h"
+#include "btThreads.h"
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+extern int gNumAlignedAllocs;
+extern int gNumAlignedFree;
+
+enum
+{
+	BT_MEMORY_HEADER_SIZE = 16,
+	BT_MEMORY_MAGIC = 0x6d74
+};
+
+// chunks of a thread's arena, blocks follow the chunk header one after the other
+struct btMemoryArenaChunk
+{
+	std::atomic<int>		m_numLive;
+	unsigned int			m_used;
+	btMemoryArenaChunk*		m_next;
+};
+
+struct btMemoryBlockHeader
+{
+	btMemoryArenaChunk*		m_chunk;	// 0 for blocks from malloc
+	unsigned int			m_size;
+	unsigned short			m_tag;
+	unsigned short			m_magic;
+};
+
+static_assert(sizeof(btMemoryArenaChunk) <= BT_MEMORY_HEADER_SIZE, "arena chunk header too large");
+static_assert(sizeof(btMemoryBlockHeader) <= BT_MEMORY_HEADER_SIZE, "block header too large");
+
+struct btMemoryTagCounters
+{
+	std::atomic<long long int>	m_liveBytes;
+	std::atomic<long long int>	m_peakBytes;
+	std::atomic<long long int>	m_liveAllocations;
+	std::atomic<long long int>	m_totalAllocations;
+	std::atomic<long long int>	m_frameAllocations;
+	std::atomic<long long int>	m_frameBytes;
+	std::atomic<long long int>	m_frameMallocs;
+	std::atomic<long long int>	m_lastFrameAllocations;
+	std::atomic<long long int>	m_lastFrameBytes;
+	std::atomic<long long int>	m_lastFrameMallocs;
+	char						m_name[btMemoryTracker::MAX_TAG_NAME];
+};
+
+// plain data, so it can be a __thread variable. Chunks of a thread that exits stay allocated but unused
+struct btMemoryThreadState
+{
+	int						m_tag;
+	int						m_transientDepth;
+	btMemoryArenaChunk*		m_chunks;
+	btMemoryArenaChunk*		m_current;
+};
+
+static const char* const	gBuiltinMemoryTagNames[BT_MEMORY_NUM_BUILTIN_TAGS] =
+{
+	"bullet",
+	"bullet/broadphase",
+	"bullet/narrowphase",
+	"bullet/islands",
+	"bullet/solver",
+	"bullet/queries"
+};
+
+static btMemoryTagCounters		gMemoryTags[btMemoryTracker::MAX_TAGS];
+static std::atomic<int>			gNumMemoryTags(0);
+static btSpinMutex				gMemoryTagsMutex;
+static std::atomic<bool>		gMemoryArenaEnabled(false);
+static std::atomic<long long int>	gMemoryArenaReservedBytes(0);
+static bool						gMemoryTrackerInstalled = false;
+
+static __thread btMemoryThreadState	sMemoryThreadState;
+
+static void	btMemoryAddTag(const char* name)
+{
+	btMemoryTagCounters& counters = gMemoryTags[gNumMemoryTags.load()];
+	strncpy(counters.m_name, name, btMemoryTracker::MAX_TAG_NAME - 1);
+	counters.m_name[btMemoryTracker::MAX_TAG_NAME - 1] = 0;
+	gNumMemoryTags.fetch_add(1);
+}
+
+// called with gMemoryTagsMutex locked
+static void	btMemoryAddBuiltinTags()
+{
+	if (gNumMemoryTags.load() == 0)
+	{
+		for (int i = 0; i < BT_MEMORY_NUM_BUILTIN_TAGS; i++)
+		{
+			btMemoryAddTag(gBuiltinMemoryTagNames[i]);
+		}
+	}
+}
+
+// the chunk of the calling thread that has room for blockSize more bytes, a new one only when every chunk holds live blocks
+static btMemoryArenaChunk*	btMemoryArenaChunkFor(btMemoryThreadState& thread, unsigned int blockSize, bool& isNew)
+{
+	btMemoryArenaChunk* chunk = thread.m_current;
+
+	if (chunk && chunk->m_numLive.load(std::memory_order_acquire) == 0)
+	{
+		chunk->m_used = 0;
+	}
+
+	if (chunk && chunk->m_used + blockSize <= btMemoryTracker::ARENA_CHUNK_SIZE)
+	{
+		return chunk;
+	}
+
+	for (chunk = thread.m_chunks; chunk; chunk = chunk->m_next)
+	{
+		if (chunk->m_numLive.load(std::memory_order_acquire) == 0)
+		{
+			chunk->m_used = 0;
+			thread.m_current = chunk;
+			return chunk;
+		}
+	}
+
+	chunk = (btMemoryArenaChunk*)malloc(BT_MEMORY_HEADER_SIZE + btMemoryTracker::ARENA_CHUNK_SIZE);
+	if (!chunk)
+	{
+		return 0;
+	}
+
+	new (&chunk->m_numLive) std::atomic<int>(0);
+	chunk->m_used = 0;
+	chunk->m_next = thread.m_chunks;
+	thread.m_chunks = chunk;
+	thread.m_current = chunk;
+	gMemoryArenaReservedBytes.fetch_add(btMemoryTracker::ARENA_CHUNK_SIZE, std::memory_order_relaxed);
+	isNew = true;
+	return chunk;
+}
+
+static void*	btMemoryTrackerAllocFunc(size_t size)
+{
+	return btMemoryTracker::allocate(size, sMemoryThreadState.m_tag);
+}
+
+static void	btMemoryTrackerFreeFunc(void* ptr)
+{
+	btMemoryTracker::deallocate(ptr);
+}
+
+bool	btMemoryTracker::install()
+{
+	if (gMemoryTrackerInstalled)
+	{
+		return true;
+	}
+	if (gNumAlignedAllocs != gNumAlignedFree)
+	{
+		return false;
+	}
+
+	gMemoryTagsMutex.lock();
+	btMemoryAddBuiltinTags();
+	gMemoryTagsMutex.unlock();
+
+	btAlignedAllocSetCustom(btMemoryTrackerAllocFunc, btMemoryTrackerFreeFunc);
+	gMemoryTrackerInstalled = true;
+	return true;
+}
+
+bool	btMemoryTracker::isInstalled()
+{
+	return gMemoryTrackerInstalled;
+}
+
+int	btMemoryTracker::registerTag(const char* name)
+{
+	gMemoryTagsMutex.lock();
+	btMemoryAddBuiltinTags();
+
+	int tag = -1;
+	for (int i = 0; i < gNumMemoryTags.load(); i++)
+	{
+		if (strncmp(gMemoryTags[i].m_name, name, MAX_TAG_NAME - 1) == 0)
+		{
+			tag = i;
+			break;
+		}
+	}
+	if (tag < 0 && gNumMemoryTags.load() < MAX_TAGS)
+	{
+		tag = gNumMemoryTags.load();
+		btMemoryAddTag(name);
+	}
+
+	gMemoryTagsMutex.unlock();
+	return tag;
+}
+
+int	btMemoryTracker::getNumTags()
+{
+	return gNumMemoryTags.load();
+}
+
+const char*	btMemoryTracker::getTagName(int tag)
+{
+	return tag >= 0 && tag < gNumMemoryTags.load() ? gMemoryTags[tag].m_name : "";
+}
+
+void*	btMemoryTracker::allocate(size_t size, int tag)
+{
+	btAssert(size <= 0xffffffffu);
+	if (tag < 0 || tag >= gNumMemoryTags.load(std::memory_order_relaxed))
+	{
+		tag = BT_MEMORY_OTHER;
+	}
+	btMemoryTagCounters& counters = gMemoryTags[tag];
+	btMemoryThreadState& thread = sMemoryThreadState;
+
+	btMemoryBlockHeader* header = 0;
+	btMemoryArenaChunk* chunk = 0;
+	bool isMalloc = false;
+
+	if (thread.m_transientDepth > 0 && size <= ARENA_MAX_BLOCK && gMemoryArenaEnabled.load(std::memory_order_relaxed))
+	{
+		const unsigned int blockSize = BT_MEMORY_HEADER_SIZE + ((unsigned int)size + 15) / 16 * 16;
+		chunk = btMemoryArenaChunkFor(thread, blockSize, isMalloc);
+		if (chunk)
+		{
+			header = (btMemoryBlockHeader*)((char*)chunk + BT_MEMORY_HEADER_SIZE + chunk->m_used);
+			chunk->m_used += blockSize;
+			chunk->m_numLive.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	if (!header)
+	{
+		header = (btMemoryBlockHeader*)malloc(BT_MEMORY_HEADER_SIZE + size);
+		if (!header)
+		{
+			return 0;
+		}
+		isMalloc = true;
+	}
+
+	header->m_chunk = chunk;
+	header->m_size = (unsigned int)size;
+	header->m_tag = (unsigned short)tag;
+	header->m_magic = BT_MEMORY_MAGIC;
+
+	const long long int liveBytes = counters.m_liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	long long int peakBytes = counters.m_peakBytes.load(std::memory_order_relaxed);
+	while (liveBytes > peakBytes && !counters.m_peakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed))
+	{
+	}
+	counters.m_liveAllocations.fetch_add(1, std::memory_order_relaxed);
+	counters.m_totalAllocations.fetch_add(1, std::memory_order_relaxed);
+	counters.m_frameAllocations.fetch_add(1, std::memory_order_relaxed);
+	counters.m_frameBytes.fetch_add(size, std::memory_order_relaxed);
+	if (isMalloc)
+	{
+		counters.m_frameMallocs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	return (char*)header + BT_MEMORY_HEADER_SIZE;
+}
+
+void	btMemoryTracker::deallocate(void* ptr)
+{
+	if (!ptr)
+	{
+		return;
+	}
+
+	btMemoryBlockHeader* header = (btMemoryBlockHeader*)((char*)ptr - BT_MEMORY_HEADER_SIZE);
+	btAssert(header->m_magic == BT_MEMORY_MAGIC);
+
+	btMemoryTagCounters& counters = gMemoryTags[header->m_tag];
+	counters.m_liveBytes.fetch_sub(header->m_size, std::memory_order_relaxed);
+	counters.m_liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+
+	// the owner may reuse the chunk as soon as its count drops, so nothing of the block is read after that
+	if (btMemoryArenaChunk* chunk = header->m_chunk)
+	{
+		chunk->m_numLive.fetch_sub(1, std::memory_order_release);
+	}
+	else
+	{
+		free(header);
+	}
+}
+
+int	btMemoryTracker::setCurrentTag(int tag)
+{
+	const int previous = sMemoryThreadState.m_tag;
+	sMemoryThreadState.m_tag = tag;
+	return previous;
+}
+
+void	btMemoryTracker::beginTransient()
+{
+	sMemoryThreadState.m_transientDepth++;
+}
+
+void	btMemoryTracker::endTransient()
+{
+	btAssert(sMemoryThreadState.m_transientDepth > 0);
+	sMemoryThreadState.m_transientDepth--;
+}
+
+void	btMemoryTracker::setArenaEnabled(bool enabled)
+{
+	gMemoryArenaEnabled.store(enabled);
+}
+
+bool	btMemoryTracker::isArenaEnabled()
+{
+	return gMemoryArenaEnabled.load();
+}
+
+long long int	btMemoryTracker::getArenaReservedBytes()
+{
+	return gMemoryArenaReservedBytes.load();
+}
+
+void	btMemoryTracker::nextFrame()
+{
+	const int numTags = gNumMemoryTags.load();
+	for (int i = 0; i < numTags; i++)
+	{
+		btMemoryTagCounters& counters = gMemoryTags[i];
+		counters.m_lastFrameAllocations.store(counters.m_frameAllocations.exchange(0));
+		counters.m_lastFrameBytes.store(counters.m_frameBytes.exchange(0));
+		counters.m_lastFrameMallocs.store(counters.m_frameMallocs.exchange(0));
+	}
+}
+
+void	btMemoryTracker::getStats(int tag, btMemoryTagStats& stats)
+{
+	memset(&stats, 0, sizeof(stats));
+	if (tag < 0 || tag >= gNumMemoryTags.load())
+	{
+		return;
+	}
+
+	const btMemoryTagCounters& counters = gMemoryTags[tag];
+	stats.m_liveBytes = counters.m_liveBytes.load();
+	stats.m_peakBytes = counters.m_peakBytes.load();
+	stats.m_liveAllocations = counters.m_liveAllocations.load();
+	stats.m_totalAllocations = counters.m_totalAllocations.load();
+	stats.m_frameAllocations = counters.m_lastFrameAllocations.load();
+	stats.m_frameBytes = counters.m_lastFrameBytes.load();
+	stats.m_frameMallocs = counters.m_lastFrameMallocs.load();
+}
+
+#pragma clang diagnostic pop
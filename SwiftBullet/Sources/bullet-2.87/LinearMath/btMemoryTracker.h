@@ -0,0 +1,153 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_MEMORY_TRACKER_H
+#define BT_MEMORY_TRACKER_H
+
+#include "btScalar.h"
+
+#include <stddef.h>
+
+///Subsystems btMemoryTracker knows from the start, more are added with registerTag
+enum btMemoryTag
+{
+	BT_MEMORY_OTHER,		///allocations outside of any BT_MEMORY_TAG scope
+	BT_MEMORY_BROADPHASE,	///updateAabbs and computeOverlappingPairs
+	BT_MEMORY_NARROWPHASE,	///dispatchAllCollisionPairs
+	BT_MEMORY_ISLANDS,		///calculateSimulationIslands
+	BT_MEMORY_SOLVER,		///solveGroup
+	BT_MEMORY_QUERIES,		///ray, sweep and contact tests
+	BT_MEMORY_NUM_BUILTIN_TAGS
+};
+
+///Allocations of one tag, bytes are the sizes asked for without headers
+struct btMemoryTagStats
+{
+	long long int	m_liveBytes;
+	long long int	m_peakBytes;
+	long long int	m_liveAllocations;
+	long long int	m_totalAllocations;
+	long long int	m_frameAllocations;	///allocations made in the last frame closed by nextFrame
+	long long int	m_frameBytes;
+	long long int	m_frameMallocs;		///allocations of that frame which went to malloc, not to an arena
+};
+
+///btMemoryTracker sits behind btAlignedAllocSetCustom and gives every block a 16 byte header with its size and tag,
+///so live bytes, peaks and allocations per frame can be read for each subsystem. The tag of a block is the one of the
+///innermost BT_MEMORY_TAG scope of the allocating thread; Recast, Detour and anything else with an allocator hook can
+///register tags of their own and call allocate and deallocate directly.
+///Inside a BT_MEMORY_TRANSIENT scope, small blocks are carved from 64k chunks owned by the allocating thread while the
+///arena is enabled. A chunk is reused once every block in it was freed, from whichever thread, so temporaries of a query
+///cost no malloc after the first few; a block kept past its scope only holds its chunk back.
+class btMemoryTracker
+{
+public:
+
+	enum
+	{
+		MAX_TAGS = 32,
+		MAX_TAG_NAME = 32,
+		ARENA_CHUNK_SIZE = 65536,
+		ARENA_MAX_BLOCK = 8192	///larger blocks go to malloc even in a transient scope
+	};
+
+	///Routes every Bullet allocation through the tracker for the rest of the process. Blocks from another allocator
+	///can't be freed by it, so this fails if any Bullet block is alive: call it before the first world is created
+	static bool	install();
+
+	static bool	isInstalled();
+
+	///Index of the tag called name, which is added the first time, -1 once MAX_TAGS are in use
+	static int	registerTag(const char* name);
+
+	static int	getNumTags();
+
+	static const char*	getTagName(int tag);
+
+	///Tracked malloc and free, for allocator hooks of other libraries; both may be called from any thread
+	static void*	allocate(size_t size, int tag);
+	static void		deallocate(void* ptr);
+
+	///Tag that allocations of the calling thread go to, returns the one before
+	static int	setCurrentTag(int tag);
+
+	///Transient scopes of the calling thread, see BT_MEMORY_TRANSIENT
+	static void	beginTransient();
+	static void	endTransient();
+
+	static void	setArenaEnabled(bool enabled);
+	static bool	isArenaEnabled();
+
+	///Bytes of every arena chunk made so far, chunks are kept for reuse
+	static long long int	getArenaReservedBytes();
+
+	///Closes the frame the m_frame counters of getStats report on, call it once per frame of the application
+	static void	nextFrame();
+
+	static void	getStats(int tag, btMemoryTagStats& stats);
+};
+
+class btMemoryTagScope
+{
+	int	m_previous;
+
+public:
+
+	btMemoryTagScope(int tag)
+	:m_previous(btMemoryTracker::setCurrentTag(tag))
+	{
+	}
+
+	~btMemoryTagScope()
+	{
+		btMemoryTracker::setCurrentTag(m_previous);
+	}
+};
+
+class btMemoryTransientScope
+{
+public:
+
+	btMemoryTransientScope()
+	{
+		btMemoryTracker::beginTransient();
+	}
+
+	~btMemoryTransientScope()
+	{
+		btMemoryTracker::endTransient();
+	}
+};
+
+///Allocations of the calling thread go to tag until the end of the enclosing scope
+#define	BT_MEMORY_TAG(tag) btMemoryTagScope memoryTagScope_(tag)
+///Allocations of the calling thread until the end of the enclosing scope are temporaries, freed soon after it
+#define	BT_MEMORY_TRANSIENT() btMemoryTransientScope memoryTransientScope_
+
+#endif //BT_MEMORY_TRACKER_H
+
+#pragma clang diagnostic pop
@@ -0,0 +1,278 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Copyright (c) 2003-2014 Erwin Coumans  http://bullet.googlecode.com
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btTaskSchedulerNative.h"
+#include "btQuickprof.h"
+#include <algorithm>  // for min and max
+
+
+#if BT_THREADSAFE
+
+
+btTaskSchedulerNative::btTaskSchedulerNative() : btITaskScheduler( "Native" )
+{
+    m_forBody = NULL;
+    m_sumBody = NULL;
+    m_remainingChunks = 0;
+    m_jobGeneration = 0;
+    m_exit = false;
+    m_numThreads = 1;
+    m_spinCount = 10000;
+    m_isRunningJob = false;
+    m_queues.resize( 1 );
+}
+
+btTaskSchedulerNative::~btTaskSchedulerNative()
+{
+    stopWorkers();
+}
+
+int btTaskSchedulerNative::getMaxNumThreads() const
+{
+    int numCores = int( std::thread::hardware_concurrency() );
+    return ( std::max )( 1, ( std::min )( numCores, int( BT_MAX_THREAD_COUNT ) ) );
+}
+
+void btTaskSchedulerNative::setNumThreads( int numThreads )
+{
+    numThreads = ( std::max )( ( std::min )( numThreads, int( BT_MAX_THREAD_COUNT ) ), 1 );
+    if ( numThreads == m_numThreads && m_workers.size() == numThreads - 1 )
+    {
+        return;
+    }
+    stopWorkers();
+    m_numThreads = numThreads;
+    m_queues.resize( numThreads );
+
+    // we are about to create new worker threads, so reset the thread counter
+    // like the other schedulers do when they resize their thread pools
+    m_savedThreadCounter = 0;
+    if ( m_isActive )
+    {
+        btResetThreadIndexCounter();
+    }
+    startWorkers( numThreads - 1 );
+}
+
+void btTaskSchedulerNative::startWorkers( int numWorkers )
+{
+    m_exit = false;
+    for ( int i = 0; i < numWorkers; ++i )
+    {
+        m_workers.push_back( new std::thread( &btTaskSchedulerNative::workerMain, this, i + 1 ) );
+    }
+}
+
+void btTaskSchedulerNative::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_wakeMutex );
+        m_exit = true;
+    }
+    m_wakeCondition.notify_all();
+    for ( int i = 0; i < m_workers.size(); ++i )
+    {
+        m_workers[ i ]->join();
+        delete m_workers[ i ];
+    }
+    m_workers.clear();
+}
+
+void btTaskSchedulerNative::workerMain( int queueIndex )
+{
+    unsigned int seenGeneration = m_jobGeneration.load( std::memory_order_acquire );
+    while ( true )
+    {
+        // spin for a while, jobs tend to come in bursts within a frame
+        int spins = 0;
+        while ( m_jobGeneration.load( std::memory_order_acquire ) == seenGeneration && !m_exit.load( std::memory_order_acquire ) && spins < m_spinCount )
+        {
+            ++spins;
+        }
+        if ( m_jobGeneration.load( std::memory_order_acquire ) == seenGeneration )
+        {
+            std::unique_lock<std::mutex> lock( m_wakeMutex );
+            while ( m_jobGeneration.load( std::memory_order_acquire ) == seenGeneration && !m_exit.load( std::memory_order_acquire ) )
+            {
+                m_wakeCondition.wait( lock );
+            }
+        }
+        if ( m_exit.load( std::memory_order_acquire ) )
+        {
+            break;
+        }
+        seenGeneration = m_jobGeneration.load( std::memory_order_acquire );
+        while ( runChunk( queueIndex ) )
+        {
+        }
+    }
+}
+
+// pop a chunk from our own queue, or steal one from another queue, and run it.
+// returns false when every queue is empty
+bool btTaskSchedulerNative::runChunk( int queueIndex )
+{
+    int numQueues = m_queues.size();
+    int chunkIndex = -1;
+    for ( int i = 0; i < numQueues && chunkIndex < 0; ++i )
+    {
+        int victim = ( queueIndex + i ) % numQueues;
+        ChunkQueue& queue = m_queues[ victim ];
+        queue.m_mutex.lock();
+        if ( queue.m_head < queue.m_tail )
+        {
+            // owner works back to front so thieves take the chunks furthest from it
+            chunkIndex = ( i == 0 ) ? --queue.m_tail : queue.m_head++;
+        }
+        queue.m_mutex.unlock();
+    }
+    if ( chunkIndex < 0 )
+    {
+        return false;
+    }
+    const Chunk& chunk = m_chunks[ chunkIndex ];
+    if ( m_sumBody )
+    {
+        BT_PROFILE( "Native_sumJob" );
+        m_chunkSums[ chunkIndex ] = m_sumBody->sumLoop( chunk.m_begin, chunk.m_end );
+    }
+    else
+    {
+        BT_PROFILE( "Native_job" );
+        m_forBody->forLoop( chunk.m_begin, chunk.m_end );
+    }
+    m_remainingChunks.fetch_sub( 1, std::memory_order_acq_rel );
+    return true;
+}
+
+void btTaskSchedulerNative::runJob( int iBegin, int iEnd, int grainSize )
+{
+    grainSize = ( std::max )( grainSize, 1 );
+    int numChunks = ( iEnd - iBegin + grainSize - 1 ) / grainSize;
+    m_chunks.resizeNoInitialize( numChunks );
+    for ( int i = 0; i < numChunks; ++i )
+    {
+        m_chunks[ i ].m_begin = iBegin + i * grainSize;
+        m_chunks[ i ].m_end = ( std::min )( iBegin + ( i + 1 ) * grainSize, iEnd );
+    }
+    if ( m_sumBody )
+    {
+        m_chunkSums.resize( numChunks, btScalar( 0 ) );
+    }
+    m_remainingChunks.store( numChunks, std::memory_order_release );
+
+    // deal out contiguous runs of chunks, one run per thread
+    int numQueues = m_queues.size();
+    for ( int i = 0; i < numQueues; ++i )
+    {
+        ChunkQueue& queue = m_queues[ i ];
+        queue.m_mutex.lock();
+        queue.m_head = int( ( long long )( numChunks ) * i / numQueues );
+        queue.m_tail = int( ( long long )( numChunks ) * ( i + 1 ) / numQueues );
+        queue.m_mutex.unlock();
+    }
+
+    btPushThreadsAreRunning();
+    m_isRunningJob = true;
+    if ( m_workers.size() > 0 )
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_wakeMutex );
+            m_jobGeneration.fetch_add( 1, std::memory_order_acq_rel );
+        }
+        m_wakeCondition.notify_all();
+    }
+
+    // main thread works on queue 0 and then helps the others
+    while ( runChunk( 0 ) )
+    {
+    }
+    while ( m_remainingChunks.load( std::memory_order_acquire ) > 0 )
+    {
+        std::this_thread::yield();
+    }
+    m_isRunningJob = false;
+    btPopThreadsAreRunning();
+}
+
+void btTaskSchedulerNative::parallelFor( int iBegin, int iEnd, int grainSize, const btIParallelForBody& body )
+{
+    BT_PROFILE( "parallelFor_Native" );
+    if ( iBegin >= iEnd )
+    {
+        return;
+    }
+    // nested calls and calls from other threads run in place
+    if ( !btIsMainThread() || m_isRunningJob || ( m_workers.size() == 0 ) )
+    {
+        body.forLoop( iBegin, iEnd );
+        return;
+    }
+    m_forBody = &body;
+    m_sumBody = NULL;
+    runJob( iBegin, iEnd, grainSize );
+    m_forBody = NULL;
+}
+
+btScalar btTaskSchedulerNative::parallelSum( int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body )
+{
+    BT_PROFILE( "parallelSum_Native" );
+    if ( iBegin >= iEnd )
+    {
+        return btScalar( 0 );
+    }
+    if ( !btIsMainThread() || m_isRunningJob || ( m_workers.size() == 0 ) )
+    {
+        return body.sumLoop( iBegin, iEnd );
+    }
+    m_forBody = NULL;
+    m_sumBody = &body;
+    runJob( iBegin, iEnd, grainSize );
+    m_sumBody = NULL;
+
+    // add up in chunk order so the result doesn't depend on who ran what
+    btScalar sum = btScalar( 0 );
+    for ( int i = 0; i < m_chunkSums.size(); ++i )
+    {
+        sum += m_chunkSums[ i ];
+    }
+    return sum;
+}
+
+#endif // #if BT_THREADSAFE
+
+
+// create a native std::thread task scheduler (if BT_THREADSAFE, otherwise returns null)
+btITaskScheduler* btGetNativeTaskScheduler()
+{
+#if BT_THREADSAFE
+    static btTaskSchedulerNative sTaskScheduler;
+    return &sTaskScheduler;
+#else
+    return NULL;
+#endif
+}
+
+
+#pragma clang diagnostic pop
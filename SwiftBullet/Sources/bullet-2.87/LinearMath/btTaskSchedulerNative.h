@@ -0,0 +1,113 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Copyright (c) 2003-2014 Erwin Coumans  http://bullet.googlecode.com
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+
+#ifndef BT_TASK_SCHEDULER_NATIVE_H
+#define BT_TASK_SCHEDULER_NATIVE_H
+
+#include "btThreads.h"
+
+#if BT_THREADSAFE
+
+#include "btAlignedObjectArray.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+///
+/// btTaskSchedulerNative -- task scheduler built on std::thread, needs no external library.
+///
+/// Each parallelFor/parallelSum is cut into grain-sized chunks which are dealt out
+/// to one deque per thread. The owner pops chunks from the back of its deque and
+/// idle threads steal from the front of the others. The calling (main) thread
+/// takes part in the work. Workers spin for a while after running out of work
+/// before going to sleep, see setSpinCount().
+///
+/// parallelSum adds the per-chunk results in chunk order, so the result is the
+/// same for any number of threads.
+///
+class btTaskSchedulerNative : public btITaskScheduler
+{
+    struct Chunk
+    {
+        int m_begin;
+        int m_end;
+    };
+
+    // one deque of chunk indexes per thread, padded so owners don't share cache lines
+    struct ChunkQueue
+    {
+        btSpinMutex m_mutex;
+        int m_head;  // thieves take from here
+        int m_tail;  // owner pops from here
+        char m_padding[ 64 - sizeof( btSpinMutex ) - 2 * sizeof( int ) ];
+    };
+
+    btAlignedObjectArray<ChunkQueue> m_queues;
+    btAlignedObjectArray<Chunk> m_chunks;
+    btAlignedObjectArray<btScalar> m_chunkSums;
+    btAlignedObjectArray<std::thread*> m_workers;
+
+    const btIParallelForBody* m_forBody;
+    const btIParallelSumBody* m_sumBody;
+
+    std::atomic<int> m_remainingChunks;
+    std::atomic<unsigned int> m_jobGeneration;
+    std::atomic<bool> m_exit;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+
+    int m_numThreads;
+    std::atomic<int> m_spinCount;
+    bool m_isRunningJob;
+
+    void startWorkers( int numWorkers );
+    void stopWorkers();
+    void workerMain( int queueIndex );
+    bool runChunk( int queueIndex );
+    void runJob( int iBegin, int iEnd, int grainSize );
+
+public:
+    btTaskSchedulerNative();
+    virtual ~btTaskSchedulerNative();
+
+    virtual int getMaxNumThreads() const BT_OVERRIDE;
+    virtual int getNumThreads() const BT_OVERRIDE { return m_numThreads; }
+    virtual void setNumThreads( int numThreads ) BT_OVERRIDE;
+    virtual void parallelFor( int iBegin, int iEnd, int grainSize, const btIParallelForBody& body ) BT_OVERRIDE;
+    virtual btScalar parallelSum( int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body ) BT_OVERRIDE;
+
+    /// number of polls of the job queue an idle worker does before it goes to sleep
+    void setSpinCount( int spinCount ) { m_spinCount = spinCount; }
+    int getSpinCount() const { return m_spinCount; }
+};
+
+#endif // #if BT_THREADSAFE
+
+#endif //BT_TASK_SCHEDULER_NATIVE_H
+
+
+#pragma clang diagnostic pop
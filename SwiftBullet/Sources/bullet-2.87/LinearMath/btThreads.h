@@ -44,6 +44,8 @@ bool btIsMainThread();
 bool btThreadsAreRunning();
 unsigned int btGetCurrentThreadIndex();
 void btResetThreadIndexCounter(); // notify that all worker threads have been destroyed
+void btPushThreadsAreRunning(); // task schedulers bracket their jobs with these
+void btPopThreadsAreRunning();
 
 ///
 /// btSpinMutex -- lightweight spin-mutex implemented with atomic ops, never puts
@@ -111,6 +113,17 @@ public:
     virtual void forLoop( int iBegin, int iEnd ) const = 0;
 };
 
+//
+// btIParallelSumBody -- subclass this to express work that can be done in parallel
+//                       and produces a sum over all the iterations
+//
+class btIParallelSumBody
+{
+public:
+    virtual ~btIParallelSumBody() {}
+    virtual btScalar sumLoop( int iBegin, int iEnd ) const = 0;
+};
+
 //
 // btITaskScheduler -- subclass this to implement a task scheduler that can dispatch work to
 //                     worker threads
@@ -126,6 +139,7 @@ public:
     virtual int getNumThreads() const = 0;
     virtual void setNumThreads( int numThreads ) = 0;
     virtual void parallelFor( int iBegin, int iEnd, int grainSize, const btIParallelForBody& body ) = 0;
+    virtual btScalar parallelSum( int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body ) = 0;
 
     // internal use only
     virtual void activate();
@@ -156,10 +170,17 @@ btITaskScheduler* btGetTBBTaskScheduler();
 // get PPL task scheduler (if available, otherwise returns null)
 btITaskScheduler* btGetPPLTaskScheduler();
 
+// get native std::thread work-stealing task scheduler (if BT_THREADSAFE, otherwise returns null)
+btITaskScheduler* btGetNativeTaskScheduler();
+
 // btParallelFor -- call this to dispatch work like a for-loop
 //                 (iterations may be done out of order, so no dependencies are allowed)
 void btParallelFor( int iBegin, int iEnd, int grainSize, const btIParallelForBody& body );
 
+// btParallelSum -- call this to dispatch work like a for-loop, returns the sum of all iterations
+//                 (iterations may be done out of order, so no dependencies are allowed)
+btScalar btParallelSum( int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body );
+
 
 #endif
 
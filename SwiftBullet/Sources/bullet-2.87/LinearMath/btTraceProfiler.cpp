@@ -0,0 +1,370 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include "btTraceProfiler.h"
+#include "btMinMax.h"
+
+#ifndef BT_NO_PROFILE
+
+#include <chrono>
+#include <new>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+btTraceProfiler*	btTraceProfiler::s_installed = 0;
+
+static const char* const	gTraceCounterNames[BT_TRACE_NUM_COUNTERS] =
+{
+	"pairs",
+	"manifolds",
+	"contact points",
+	"islands",
+	"solver iterations",
+	"ccd hits"
+};
+
+static unsigned long long int	btTraceClock()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void	btTraceAppend(btAlignedObjectArray<char>& json, const char* format, ...)
+{
+	char line[512];
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(line, sizeof(line), format, args);
+	va_end(args);
+
+	length = btMin(length, int(sizeof(line)) - 1);
+	const int start = json.size();
+	json.resize(start + length);
+	memcpy(&json[start], line, length);
+}
+
+// zone names are string literals, but nothing stops one from holding a quote
+static void	btTraceAppendName(btAlignedObjectArray<char>& json, const char* name)
+{
+	for (const char* c = name; *c; c++)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			json.push_back('\\');
+		}
+		json.push_back((unsigned char)*c < 0x20 ? ' ' : *c);
+	}
+}
+
+// first index of a ring of capacity entries that no writer can be overwriting once count entries were published
+static unsigned long long int	btTraceFirstValid(unsigned long long int count, int capacity)
+{
+	return count + 1 > (unsigned long long int)capacity ? count + 1 - capacity : 0;
+}
+
+
+btTraceProfiler::btTraceProfiler(int eventsPerThread, int maxFrames)
+:m_eventCapacity(btMax(eventsPerThread, 2)),
+m_frameCapacity(btMax(maxFrames, 1) + 1), // one more slot than asked for, the one a writer may be filling
+m_numFrames(0),
+m_inFrame(false),
+m_startTime(btTraceClock()),
+m_previousEnter(0),
+m_previousLeave(0)
+{
+	for (unsigned int i = 0; i < BT_QUICKPROF_MAX_THREAD_COUNT; i++)
+	{
+		ThreadTrace& thread = m_threads[i];
+		thread.m_events.store(0);
+		thread.m_numEvents.store(0);
+		thread.m_depth = 0;
+		memset(thread.m_counters, 0, sizeof(thread.m_counters));
+	}
+	m_frames = new (btAlignedAlloc(sizeof(FrameSlot) * m_frameCapacity, 16)) FrameSlot[m_frameCapacity];
+	memset(&m_currentFrame, 0, sizeof(m_currentFrame));
+	memset(m_setCounters, 0, sizeof(m_setCounters));
+	memset(m_isSet, 0, sizeof(m_isSet));
+}
+
+btTraceProfiler::~btTraceProfiler()
+{
+	if (s_installed == this)
+	{
+		install(0);
+	}
+	for (unsigned int i = 0; i < BT_QUICKPROF_MAX_THREAD_COUNT; i++)
+	{
+		btAlignedFree(m_threads[i].m_events.load());
+	}
+	btAlignedFree(m_frames);
+}
+
+void	btTraceProfiler::install(btTraceProfiler* profiler)
+{
+	if (s_installed)
+	{
+		btSetCustomEnterProfileZoneFunc(s_installed->m_previousEnter);
+		btSetCustomLeaveProfileZoneFunc(s_installed->m_previousLeave);
+		s_installed = 0;
+	}
+	if (profiler)
+	{
+		profiler->m_previousEnter = btGetCurrentEnterProfileZoneFunc();
+		profiler->m_previousLeave = btGetCurrentLeaveProfileZoneFunc();
+		s_installed = profiler;
+		btSetCustomEnterProfileZoneFunc(enterZoneCallback);
+		btSetCustomLeaveProfileZoneFunc(leaveZoneCallback);
+	}
+}
+
+void	btTraceProfiler::enterZoneCallback(const char* name)
+{
+	if (btTraceProfiler* profiler = s_installed)
+	{
+		profiler->enterZone(name);
+	}
+}
+
+void	btTraceProfiler::leaveZoneCallback()
+{
+	if (btTraceProfiler* profiler = s_installed)
+	{
+		profiler->leaveZone();
+	}
+}
+
+unsigned long long int	btTraceProfiler::getTime() const
+{
+	return btTraceClock() - m_startTime;
+}
+
+btTraceProfiler::ThreadTrace*	btTraceProfiler::getThreadTrace()
+{
+	const unsigned int threadIndex = btQuickprofGetCurrentThreadIndex2();
+	return threadIndex < BT_QUICKPROF_MAX_THREAD_COUNT ? &m_threads[threadIndex] : 0;
+}
+
+void	btTraceProfiler::enterZone(const char* name)
+{
+	ThreadTrace* thread = getThreadTrace();
+	if (!thread)
+		return;
+
+	// zones deeper than that still have to be left, they just aren't recorded
+	if (thread->m_depth < MAX_DEPTH)
+	{
+		thread->m_openNames[thread->m_depth] = name;
+		thread->m_openStarts[thread->m_depth] = getTime();
+	}
+	thread->m_depth++;
+}
+
+void	btTraceProfiler::leaveZone()
+{
+	ThreadTrace* thread = getThreadTrace();
+	// zones entered before install aren't ours
+	if (!thread || thread->m_depth == 0)
+		return;
+
+	thread->m_depth--;
+	if (thread->m_depth < MAX_DEPTH)
+	{
+		record(*thread, thread->m_openNames[thread->m_depth], thread->m_openStarts[thread->m_depth], getTime());
+	}
+}
+
+void	btTraceProfiler::record(ThreadTrace& thread, const char* name, unsigned long long int startTime, unsigned long long int endTime)
+{
+	EventSlot* events = thread.m_events.load(std::memory_order_relaxed);
+	if (!events)
+	{
+		// only this thread writes its buffer, readers pick it up with the count
+		events = new (btAlignedAlloc(sizeof(EventSlot) * m_eventCapacity, 16)) EventSlot[m_eventCapacity];
+		thread.m_events.store(events, std::memory_order_release);
+	}
+
+	// a reader that sees any of the stores below also sees the count that already drops the entry they overwrite
+	const unsigned long long int index = thread.m_numEvents.load(std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	EventSlot& event = events[index % m_eventCapacity];
+	event.m_name.store(name, std::memory_order_relaxed);
+	event.m_startTime.store(startTime, std::memory_order_relaxed);
+	event.m_duration.store(endTime - startTime, std::memory_order_relaxed);
+	thread.m_numEvents.store(index + 1, std::memory_order_release);
+}
+
+void	btTraceProfiler::beginFrame()
+{
+	for (unsigned int i = 0; i < BT_QUICKPROF_MAX_THREAD_COUNT; i++)
+	{
+		memset(m_threads[i].m_counters, 0, sizeof(m_threads[i].m_counters));
+	}
+	memset(m_isSet, 0, sizeof(m_isSet));
+
+	m_currentFrame.m_index = m_numFrames.load(std::memory_order_relaxed);
+	m_currentFrame.m_startTime = getTime();
+	m_inFrame = true;
+
+	enterZone("stepSimulation");
+}
+
+void	btTraceProfiler::endFrame(int numTicks)
+{
+	if (!m_inFrame)
+		return;
+	leaveZone();
+	m_inFrame = false;
+
+	m_currentFrame.m_duration = getTime() - m_currentFrame.m_startTime;
+	m_currentFrame.m_numTicks = numTicks;
+	for (int c = 0; c < BT_TRACE_NUM_COUNTERS; c++)
+	{
+		long long int sum = 0;
+		for (unsigned int i = 0; i < BT_QUICKPROF_MAX_THREAD_COUNT; i++)
+		{
+			sum += m_threads[i].m_counters[c];
+		}
+		m_currentFrame.m_counters[c] = m_isSet[c] ? m_setCounters[c] : sum;
+	}
+
+	// same order as record: the count that drops the overwritten frame comes first
+	const unsigned long long int index = m_currentFrame.m_index;
+	std::atomic_thread_fence(std::memory_order_release);
+
+	FrameSlot& slot = m_frames[int(index % m_frameCapacity)];
+	slot.m_index.store(m_currentFrame.m_index, std::memory_order_relaxed);
+	slot.m_startTime.store(m_currentFrame.m_startTime, std::memory_order_relaxed);
+	slot.m_duration.store(m_currentFrame.m_duration, std::memory_order_relaxed);
+	slot.m_numTicks.store(m_currentFrame.m_numTicks, std::memory_order_relaxed);
+	for (int c = 0; c < BT_TRACE_NUM_COUNTERS; c++)
+	{
+		slot.m_counters[c].store(m_currentFrame.m_counters[c], std::memory_order_relaxed);
+	}
+	m_numFrames.store(index + 1, std::memory_order_release);
+}
+
+int	btTraceProfiler::getFrames(btTraceFrame* frames, int maxFrames) const
+{
+	const unsigned long long int numFrames = m_numFrames.load(std::memory_order_acquire);
+	unsigned long long int first = btTraceFirstValid(numFrames, m_frameCapacity);
+	if (numFrames - first > (unsigned long long int)maxFrames)
+	{
+		first = numFrames - maxFrames;
+	}
+
+	int numCopied = 0;
+	for (unsigned long long int index = first; index < numFrames; index++)
+	{
+		const FrameSlot& slot = m_frames[int(index % m_frameCapacity)];
+		btTraceFrame& frame = frames[numCopied++];
+		frame.m_index = slot.m_index.load(std::memory_order_relaxed);
+		frame.m_startTime = slot.m_startTime.load(std::memory_order_relaxed);
+		frame.m_duration = slot.m_duration.load(std::memory_order_relaxed);
+		frame.m_numTicks = slot.m_numTicks.load(std::memory_order_relaxed);
+		for (int c = 0; c < BT_TRACE_NUM_COUNTERS; c++)
+		{
+			frame.m_counters[c] = slot.m_counters[c].load(std::memory_order_relaxed);
+		}
+	}
+
+	// a step that finished meanwhile may have overwritten the oldest ones, the fence keeps the copies above this load
+	std::atomic_thread_fence(std::memory_order_acquire);
+	const unsigned long long int firstValid = btTraceFirstValid(m_numFrames.load(std::memory_order_relaxed), m_frameCapacity);
+	if (firstValid > first)
+	{
+		const int numLost = int(btMin(firstValid - first, (unsigned long long int)numCopied));
+		memmove(frames, frames + numLost, sizeof(btTraceFrame) * (numCopied - numLost));
+		numCopied -= numLost;
+	}
+	return numCopied;
+}
+
+void	btTraceProfiler::exportChromeTrace(btAlignedObjectArray<char>& json) const
+{
+	btTraceAppend(json, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	btTraceAppend(json, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Bullet\"}}");
+
+	btAlignedObjectArray<Event> events;
+	for (unsigned int i = 0; i < BT_QUICKPROF_MAX_THREAD_COUNT; i++)
+	{
+		const ThreadTrace& thread = m_threads[i];
+		const unsigned long long int numEvents = thread.m_numEvents.load(std::memory_order_acquire);
+		const EventSlot* ring = thread.m_events.load(std::memory_order_acquire);
+		if (!ring || !numEvents)
+			continue;
+
+		const unsigned long long int first = btTraceFirstValid(numEvents, m_eventCapacity);
+		events.resize(0);
+		for (unsigned long long int index = first; index < numEvents; index++)
+		{
+			const EventSlot& slot = ring[index % m_eventCapacity];
+			Event& event = events.expandNonInitializing();
+			event.m_name = slot.m_name.load(std::memory_order_relaxed);
+			event.m_startTime = slot.m_startTime.load(std::memory_order_relaxed);
+			event.m_duration = slot.m_duration.load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const unsigned long long int firstValid = btTraceFirstValid(thread.m_numEvents.load(std::memory_order_relaxed), m_eventCapacity);
+		const int numLost = firstValid > first ? int(btMin(firstValid - first, (unsigned long long int)events.size())) : 0;
+
+		btTraceAppend(json, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Bullet thread %u\"}}", i, i);
+		for (int e = numLost; e < events.size(); e++)
+		{
+			btTraceAppend(json, ",\n{\"name\":\"");
+			btTraceAppendName(json, events[e].m_name);
+			btTraceAppend(json, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", i, events[e].m_startTime * 1e-3, events[e].m_duration * 1e-3);
+		}
+	}
+
+	btAlignedObjectArray<btTraceFrame> frames;
+	frames.resize(getMaxFrames());
+	const int numFrames = frames.size() ? getFrames(&frames[0], frames.size()) : 0;
+	for (int f = 0; f < numFrames; f++)
+	{
+		const btTraceFrame& frame = frames[f];
+		for (int c = 0; c < BT_TRACE_NUM_COUNTERS; c++)
+		{
+			btTraceAppend(json, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"value\":%lld}}", gTraceCounterNames[c], frame.m_startTime * 1e-3, frame.m_counters[c]);
+		}
+	}
+
+	btTraceAppend(json, "\n]}\n");
+}
+
+void	btTraceProfiler::clear()
+{
+	for (unsigned int i = 0; i < BT_QUICKPROF_MAX_THREAD_COUNT; i++)
+	{
+		m_threads[i].m_numEvents.store(0, std::memory_order_release);
+	}
+	m_numFrames.store(0, std::memory_order_release);
+}
+
+#endif //BT_NO_PROFILE
+
+#pragma clang diagnostic pop
@@ -0,0 +1,208 @@
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdocumentation"
+#pragma clang diagnostic ignored "-Wcomma"
+#pragma clang diagnostic ignored "-Wunused-function"
+#pragma clang diagnostic ignored "-Wunused-variable"
+#pragma clang diagnostic ignored "-Wunreachable-code"
+#pragma clang diagnostic ignored "-Wconditional-uninitialized"
+
+
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2009 Erwin Coumans  http://bulletphysics.org
+
+Copyright (c) 2026 Fedor Artemenkov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose, 
+including commercial applications, and to alter it and redistribute it freely, 
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#ifndef BT_TRACE_PROFILER_H
+#define BT_TRACE_PROFILER_H
+
+#include "btQuickprof.h"
+#include "btAlignedObjectArray.h"
+
+#include <atomic>
+
+///Counters btTraceProfiler keeps for every frame
+enum btTraceCounter
+{
+	BT_TRACE_PAIRS,				///overlapping pairs after the last tick of the frame
+	BT_TRACE_MANIFOLDS,			///contact manifolds after the last tick
+	BT_TRACE_CONTACT_POINTS,	///contact points of those manifolds
+	BT_TRACE_ISLANDS,			///awake islands handed to the solver, summed over the ticks
+	BT_TRACE_SOLVER_ITERATIONS,	///solver iterations run, summed over solver groups and ticks
+	BT_TRACE_CCD_HITS,			///motions clamped by continuous collision detection, summed over the ticks
+	BT_TRACE_NUM_COUNTERS
+};
+
+///One stepSimulation call, times are in nanoseconds since the profiler was created
+struct btTraceFrame
+{
+	unsigned long long int	m_index;
+	unsigned long long int	m_startTime;
+	unsigned long long int	m_duration;
+	int						m_numTicks;
+	long long int			m_counters[BT_TRACE_NUM_COUNTERS];
+};
+
+#ifndef BT_NO_PROFILE
+
+///btTraceProfiler records every BT_PROFILE zone into a ring buffer of its thread instead of the CProfileManager tree.
+///Each thread only ever writes its own buffer and publishes it with an atomic count, so recording takes no lock.
+///Readers on other threads (exportChromeTrace, getFrames) copy the slots and check the count again afterwards, the way a
+///seqlock does: the slots are relaxed atomics and fences order them with the count, so a slot that was being overwritten
+///is dropped and only whole events are kept, even while a step is running.
+///btDiscreteDynamicsWorld::stepSimulation marks frames and fills the counters of the frame with BT_PROFILE_COUNT and
+///BT_PROFILE_SET_COUNTER; the last frames stay readable for graphs and go into the trace as counter tracks.
+///Install it between steps: it replaces the profile zone functions, so CProfileManager::dumpAll has nothing to show.
+class btTraceProfiler
+{
+public:
+
+	struct Event
+	{
+		const char*				m_name;
+		unsigned long long int	m_startTime;
+		unsigned long long int	m_duration;
+	};
+
+protected:
+
+	enum
+	{
+		MAX_DEPTH = 64
+	};
+
+	///ring buffer entries, written by one thread and copied by readers while it may be overwriting them
+	struct EventSlot
+	{
+		std::atomic<const char*>			m_name;
+		std::atomic<unsigned long long int>	m_startTime;
+		std::atomic<unsigned long long int>	m_duration;
+	};
+
+	struct FrameSlot
+	{
+		std::atomic<unsigned long long int>	m_index;
+		std::atomic<unsigned long long int>	m_startTime;
+		std::atomic<unsigned long long int>	m_duration;
+		std::atomic<int>					m_numTicks;
+		std::atomic<long long int>			m_counters[BT_TRACE_NUM_COUNTERS];
+	};
+
+	struct ThreadTrace
+	{
+		std::atomic<EventSlot*>				m_events;
+		std::atomic<unsigned long long int>	m_numEvents;
+		const char*							m_openNames[MAX_DEPTH];
+		unsigned long long int				m_openStarts[MAX_DEPTH];
+		int									m_depth;
+		long long int						m_counters[BT_TRACE_NUM_COUNTERS];
+	};
+
+	ThreadTrace		m_threads[BT_QUICKPROF_MAX_THREAD_COUNT];
+	int				m_eventCapacity;
+
+	FrameSlot*		m_frames;
+	int				m_frameCapacity;
+	std::atomic<unsigned long long int>	m_numFrames;
+	btTraceFrame	m_currentFrame;
+	long long int	m_setCounters[BT_TRACE_NUM_COUNTERS];
+	bool			m_isSet[BT_TRACE_NUM_COUNTERS];
+	bool			m_inFrame;
+
+	unsigned long long int	m_startTime;
+
+	btEnterProfileZoneFunc*	m_previousEnter;
+	btLeaveProfileZoneFunc*	m_previousLeave;
+
+	static btTraceProfiler*	s_installed;
+
+	ThreadTrace*	getThreadTrace();
+	void	record(ThreadTrace& thread, const char* name, unsigned long long int startTime, unsigned long long int endTime);
+
+	static void	enterZoneCallback(const char* name);
+	static void	leaveZoneCallback();
+
+public:
+
+	///eventsPerThread zones are kept for every thread that records any, maxFrames frames for getFrames
+	btTraceProfiler(int eventsPerThread = 65536, int maxFrames = 600);
+
+	virtual ~btTraceProfiler();
+
+	///Sends every BT_PROFILE zone to profiler from now on, 0 goes back to the zone functions set before
+	static void	install(btTraceProfiler* profiler);
+
+	static btTraceProfiler*	getInstalled()
+	{
+		return s_installed;
+	}
+
+	///nanoseconds since the profiler was created, the clock of every event and frame
+	unsigned long long int	getTime() const;
+
+	void	enterZone(const char* name);
+	void	leaveZone();
+
+	///frames of stepSimulation, beginFrame clears the counters
+	void	beginFrame();
+	void	endFrame(int numTicks);
+
+	///adds value to counter of the current frame from any thread
+	void	count(btTraceCounter counter, long long int value)
+	{
+		if (ThreadTrace* thread = getThreadTrace())
+		{
+			thread->m_counters[counter] += value;
+		}
+	}
+
+	///counter of the current frame becomes value, from the thread stepping the world
+	void	setCounter(btTraceCounter counter, long long int value)
+	{
+		m_setCounters[counter] = value;
+		m_isSet[counter] = true;
+	}
+
+	///Copies up to maxFrames of the last finished frames into frames, oldest first, and returns how many
+	int	getFrames(btTraceFrame* frames, int maxFrames) const;
+
+	int	getMaxFrames() const
+	{
+		return m_frameCapacity - 1;
+	}
+
+	///Appends the recorded zones as complete events, one track per thread, and the frame counters as counter tracks
+	///in the Chrome trace event format, which chrome://tracing and Perfetto open. Timestamps are in microseconds
+	void	exportChromeTrace(btAlignedObjectArray<char>& json) const;
+
+	///Forgets the recorded zones and frames
+	void	clear();
+};
+
+#define	BT_PROFILE_COUNT(counter, value) \
+	do { if (btTraceProfiler* traceProfiler_ = btTraceProfiler::getInstalled()) traceProfiler_->count(counter, value); } while (0)
+#define	BT_PROFILE_SET_COUNTER(counter, value) \
+	do { if (btTraceProfiler* traceProfiler_ = btTraceProfiler::getInstalled()) traceProfiler_->setCounter(counter, value); } while (0)
+
+#else
+
+#define	BT_PROFILE_COUNT(counter, value)
+#define	BT_PROFILE_SET_COUNTER(counter, value)
+
+#endif //BT_NO_PROFILE
+
+#endif //BT_TRACE_PROFILER_H
+
+#pragma clang diagnostic pop
@@ -9,7 +9,9 @@ let package = Package(
         .library(name: "RecastObjC", targets: ["RecastObjC"]),
         .library(name: "DetourPathfinder", targets: ["DetourPathfinder"])
     ],
-    dependencies: [],
+    dependencies: [
+        .package(path: "../BenchmarkSupport")
+    ],
     targets: [
         .target(
             name: "Recast",
@@ -52,6 +54,11 @@ let package = Package(
             dependencies: ["CDetour"],
             path: "Sources/DetourPathfinder"
         ),
+        .executableTarget(
+            name: "NavBenchmark",
+            dependencies: ["RecastObjC", "CDetour", "BenchmarkSupport"],
+            path: "Sources/NavBenchmark"
+        ),
     ],
     cxxLanguageStandard: .cxx11
 )
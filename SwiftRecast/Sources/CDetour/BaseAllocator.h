@@ -0,0 +1,21 @@
+//
+//  BaseAllocator.h
+//  
+//
+//  Created by Fedor Artemenkov on 18.10.2026.
+//
+
+#ifndef BaseAllocator_h
+#define BaseAllocator_h
+
+#include "DetourAlloc.h"
+
+// The allocator set with set_detour_allocator, or malloc, for allocators that wrap it
+void* detour_base_alloc(size_t size, dtAllocHint hint);
+void detour_base_free(void* ptr);
+
+// The base allocator with the counters of benchmark_queries on top, installed by enable_query_statistics
+void* detour_counting_alloc(size_t size, dtAllocHint hint);
+void detour_counting_free(void* ptr);
+
+#endif /* BaseAllocator_h */
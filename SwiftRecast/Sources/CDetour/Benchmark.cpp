@@ -0,0 +1,298 @@
+//
+//  Benchmark.cpp
+//  
+//
+//  Created by Fedor Artemenkov on 18.10.2026.
+//
+
+#include "CDetour.h"
+#include "BaseAllocator.h"
+#include "DetourAlloc.h"
+#include "DetourCommon.h"
+#include "DetourNavMesh.h"
+#include "DetourNavMeshQuery.h"
+#include "DetourNode.h"
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <vector>
+
+static const int MAX_POLYS = 256;
+
+// Paths shorter than this fraction of the navmesh diagonal are "short",
+// longer than the second one are "cross-map", everything between is "medium"
+static const float SHORT_PATH_FRACTION = 0.1f;
+static const float LONG_PATH_FRACTION = 0.4f;
+
+// Counting allocator on top of the one set with set_detour_allocator, every block is prefixed by its size.
+// A benchmark allocates and frees everything on the thread that runs it, so queries on other threads don't mix in
+
+static const size_t ALLOC_HEADER = 16;
+static thread_local size_t s_liveBytes = 0;
+static thread_local size_t s_peakBytes = 0;
+
+void* detour_counting_alloc(size_t size, dtAllocHint hint)
+{
+    unsigned char* block = (unsigned char*)detour_base_alloc(size + ALLOC_HEADER, hint);
+    if (!block) return 0;
+    
+    *(size_t*)block = size;
+    
+    s_liveBytes += size;
+    s_peakBytes = std::max(s_peakBytes, s_liveBytes);
+    
+    return block + ALLOC_HEADER;
+}
+
+void detour_counting_free(void* ptr)
+{
+    unsigned char* block = (unsigned char*)ptr - ALLOC_HEADER;
+    s_liveBytes -= *(size_t*)block;
+    detour_base_free(block);
+}
+
+// Seeded generator, so query sets are the same from run to run
+
+static unsigned int s_randomState = 1;
+
+static float seededRand()
+{
+    // xorshift32
+    s_randomState ^= s_randomState << 13;
+    s_randomState ^= s_randomState >> 17;
+    s_randomState ^= s_randomState << 5;
+    return (float)(s_randomState & 0xffffff) / (float)0xffffff;
+}
+
+struct Sample
+{
+    double us;
+    int nodes;
+};
+
+static QueryTimings makeTimings(std::vector<Sample>& samples, int failures)
+{
+    QueryTimings timings = {};
+    timings.count = int(samples.size());
+    timings.failures = failures;
+    
+    if (samples.empty()) return timings;
+    
+    const size_t p50 = (samples.size() - 1) / 2;
+    const size_t p99 = (samples.size() - 1) * 99 / 100;
+    
+    std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) { return a.us < b.us; });
+    timings.p50_us = samples[p50].us;
+    timings.p99_us = samples[p99].us;
+    
+    std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) { return a.nodes < b.nodes; });
+    timings.nodes_p50 = samples[p50].nodes;
+    timings.nodes_p99 = samples[p99].nodes;
+    
+    return timings;
+}
+
+static double elapsedMicroseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+static float navmeshDiagonal(const dtNavMesh* mesh)
+{
+    float bmin[3] = { 0, 0, 0 };
+    float bmax[3] = { 0, 0, 0 };
+    bool first = true;
+    
+    for (int i = 0; i < mesh->getMaxTiles(); ++i)
+    {
+        const dtMeshTile* tile = mesh->getTile(i);
+        if (!tile || !tile->header) continue;
+        
+        if (first)
+        {
+            dtVcopy(bmin, tile->header->bmin);
+            dtVcopy(bmax, tile->header->bmax);
+            first = false;
+        }
+        else
+        {
+            dtVmin(bmin, tile->header->bmin);
+            dtVmax(bmax, tile->header->bmax);
+        }
+    }
+    
+    return dtVdist(bmin, bmax);
+}
+
+static void runQueries(dtNavMesh* mesh, dtNavMeshQuery* query, int count, const float* ext, QueryBenchmark& result)
+{
+    dtQueryFilter filter;
+    filter.setIncludeFlags(1);
+    filter.setExcludeFlags(0);
+    
+    const float diagonal = navmeshDiagonal(mesh);
+    
+    std::vector<Sample> samples;
+    samples.reserve(count);
+    
+    // Random points
+    {
+        samples.clear();
+        int failures = 0;
+        
+        for (int i = 0; i < count; ++i)
+        {
+            dtPolyRef ref;
+            float pos[3];
+            
+            auto start = std::chrono::steady_clock::now();
+            dtStatus status = query->findRandomPoint(&filter, seededRand, &ref, pos);
+            double us = elapsedMicroseconds(start);
+            
+            if (dtStatusFailed(status)) { failures++; continue; }
+            samples.push_back({ us, 0 });
+        }
+        
+        result.random_points = makeTimings(samples, failures);
+    }
+    
+    // Nearest poly around random points
+    {
+        samples.clear();
+        int failures = 0;
+        
+        for (int i = 0; i < count; ++i)
+        {
+            dtPolyRef ref;
+            float pos[3];
+            if (dtStatusFailed(query->findRandomPoint(&filter, seededRand, &ref, pos))) { failures++; continue; }
+            
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                pos[axis] += (seededRand() * 2 - 1) * ext[axis];
+            }
+            
+            dtPolyRef nearestRef = 0;
+            float nearest[3];
+            
+            auto start = std::chrono::steady_clock::now();
+            dtStatus status = query->findNearestPoly(pos, ext, &filter, &nearestRef, nearest);
+            double us = elapsedMicroseconds(start);
+            
+            if (dtStatusFailed(status) || !nearestRef) { failures++; continue; }
+            samples.push_back({ us, 0 });
+        }
+        
+        result.nearest_poly = makeTimings(samples, failures);
+    }
+    
+    // Raycasts of a short length in a random direction, nodes are the visited polys
+    {
+        samples.clear();
+        int failures = 0;
+        
+        for (int i = 0; i < count; ++i)
+        {
+            dtPolyRef ref;
+            float spos[3];
+            if (dtStatusFailed(query->findRandomPoint(&filter, seededRand, &ref, spos))) { failures++; continue; }
+            
+            const float angle = seededRand() * 6.2831853f;
+            const float length = diagonal * SHORT_PATH_FRACTION;
+            const float epos[3] = { spos[0] + cosf(angle) * length, spos[1], spos[2] + sinf(angle) * length };
+            
+            float t;
+            float hitNormal[3];
+            dtPolyRef polys[MAX_POLYS];
+            int npolys = 0;
+            
+            auto start = std::chrono::steady_clock::now();
+            dtStatus status = query->raycast(ref, spos, epos, &filter, &t, hitNormal, polys, &npolys, MAX_POLYS);
+            double us = elapsedMicroseconds(start);
+            
+            if (dtStatusFailed(status)) { failures++; continue; }
+            samples.push_back({ us, npolys });
+        }
+        
+        result.raycasts = makeTimings(samples, failures);
+    }
+    
+    // Paths between random point pairs, bucketed by straight distance
+    {
+        std::vector<Sample> buckets[3];
+        int failures[3] = { 0, 0, 0 };
+        
+        for (int attempt = 0; attempt < count * 50; ++attempt)
+        {
+            if (int(buckets[0].size()) >= count && int(buckets[1].size()) >= count && int(buckets[2].size()) >= count)
+            {
+                break;
+            }
+            
+            dtPolyRef startRef, endRef;
+            float spos[3], epos[3];
+            if (dtStatusFailed(query->findRandomPoint(&filter, seededRand, &startRef, spos))) continue;
+            if (dtStatusFailed(query->findRandomPoint(&filter, seededRand, &endRef, epos))) continue;
+            
+            const float fraction = dtVdist(spos, epos) / diagonal;
+            const int bucket = fraction < SHORT_PATH_FRACTION ? 0 : (fraction < LONG_PATH_FRACTION ? 1 : 2);
+            
+            if (int(buckets[bucket].size()) >= count) continue;
+            
+            dtPolyRef polys[MAX_POLYS];
+            int npolys = 0;
+            
+            float straightPath[MAX_POLYS * 3];
+            unsigned char straightPathFlags[MAX_POLYS];
+            dtPolyRef straightPathPolys[MAX_POLYS];
+            int nstraightPath = 0;
+            
+            auto start = std::chrono::steady_clock::now();
+            dtStatus status = query->findPath(startRef, endRef, spos, epos, &filter, polys, &npolys, MAX_POLYS);
+            const int nodes = query->getNodePool()->getNodeCount();
+            
+            if (dtStatusSucceed(status) && npolys)
+            {
+                status = query->findStraightPath(spos, epos, polys, npolys,
+                                                 straightPath, straightPathFlags,
+                                                 straightPathPolys, &nstraightPath,
+                                                 MAX_POLYS, 0);
+            }
+            double us = elapsedMicroseconds(start);
+            
+            if (dtStatusFailed(status) || !npolys) { failures[bucket]++; continue; }
+            buckets[bucket].push_back({ us, nodes });
+        }
+        
+        result.short_paths = makeTimings(buckets[0], failures[0]);
+        result.medium_paths = makeTimings(buckets[1], failures[1]);
+        result.long_paths = makeTimings(buckets[2], failures[2]);
+    }
+}
+
+QueryBenchmark benchmark_queries(const void* data, size_t size, unsigned int seed, int count, simd_float3 half_extents)
+{
+    QueryBenchmark result = {};
+    
+    s_randomState = seed ? seed : 1;
+    s_liveBytes = 0;
+    s_peakBytes = 0;
+    
+    dtNavMesh* mesh = create_navmesh(data, size);
+    result.navmesh_bytes = s_liveBytes;
+    
+    if (mesh)
+    {
+        dtNavMeshQuery* query = create_query(mesh);
+        
+        const float ext[3] = { half_extents.x, half_extents.y, half_extents.z };
+        runQueries(mesh, query, count, ext, result);
+        
+        result.query_peak_bytes = s_peakBytes - result.navmesh_bytes;
+        
+        destroy_query(query);
+        destroy_navmesh(mesh);
+    }
+    
+    return result;
+}
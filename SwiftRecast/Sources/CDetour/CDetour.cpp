@@ -6,6 +6,7 @@
 //
 
 #include "CDetour.h"
+#include "BaseAllocator.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
 #include "string.h"
@@ -14,6 +15,46 @@ static const int MAX_POLYS = 256;
 
 float m_straightPath[MAX_POLYS*3];
 
+static detour_alloc_func s_allocFunc = NULL;
+static detour_free_func s_freeFunc = NULL;
+static int s_permanentTag = 0;
+static int s_temporaryTag = 0;
+static bool s_countQueries = false;
+
+void* detour_base_alloc(size_t size, dtAllocHint hint)
+{
+    if (!s_allocFunc) return malloc(size);
+    return s_allocFunc(size, hint == DT_ALLOC_PERM ? s_permanentTag : s_temporaryTag);
+}
+
+void detour_base_free(void* ptr)
+{
+    if (!s_freeFunc) free(ptr);
+    else s_freeFunc(ptr);
+}
+
+static void installAllocator()
+{
+    if (s_countQueries) dtAllocSetCustom(detour_counting_alloc, detour_counting_free);
+    else dtAllocSetCustom(detour_base_alloc, detour_base_free);
+}
+
+void set_detour_allocator(detour_alloc_func alloc_func, detour_free_func free_func, int permanent_tag, int temporary_tag)
+{
+    s_allocFunc = alloc_func;
+    s_freeFunc = free_func;
+    s_permanentTag = permanent_tag;
+    s_temporaryTag = temporary_tag;
+    installAllocator();
+}
+
+void enable_query_statistics(void)
+{
+    // the size prefix has to be there from the first block on
+    s_countQueries = true;
+    installAllocator();
+}
+
 dtNavMeshQuery* create_query(dtNavMesh* mesh)
 {
     dtNavMeshQuery* query = dtAllocNavMeshQuery();
@@ -30,6 +30,36 @@ typedef struct {
     int num_indices;
 } SimpleMesh;
 
+typedef struct {
+    int count;
+    int failures;
+    double p50_us;
+    double p99_us;
+    double nodes_p50;
+    double nodes_p99;
+} QueryTimings;
+
+typedef struct {
+    QueryTimings short_paths;
+    QueryTimings medium_paths;
+    QueryTimings long_paths;
+    QueryTimings nearest_poly;
+    QueryTimings raycasts;
+    QueryTimings random_points;
+    size_t navmesh_bytes;
+    size_t query_peak_bytes;
+} QueryBenchmark;
+
+typedef void* (*detour_alloc_func)(size_t size, int tag);
+typedef void (*detour_free_func)(void* ptr);
+
+// Every Detour allocation goes through alloc_func from now on, tagged by whether it is permanent or temporary.
+// A block has to be freed by the allocator that made it, so call it before the first navmesh is created
+void set_detour_allocator(detour_alloc_func alloc_func, detour_free_func free_func, int permanent_tag, int temporary_tag);
+
+// Counts the Detour memory of benchmark_queries from now on, still through the allocator above. Call before the first navmesh
+void enable_query_statistics(void);
+
 dtNavMesh* create_navmesh(const void* data, size_t size);
 dtNavMeshQuery* create_query(dtNavMesh* mesh);
 
@@ -38,6 +68,10 @@ Path random_path(dtNavMeshQuery* query, simd_float3 start, simd_float3 half_exte
 
 SimpleMesh get_simple_mesh(dtNavMesh* mesh);
 
+// Loads the navmesh and runs `count` queries of every kind, generated from `seed`.
+// The memory is 0 without enable_query_statistics
+QueryBenchmark benchmark_queries(const void* data, size_t size, unsigned int seed, int count, simd_float3 half_extents);
+
 void destroy_navmesh(dtNavMesh* mesh);
 void destroy_query(dtNavMeshQuery* query);
 
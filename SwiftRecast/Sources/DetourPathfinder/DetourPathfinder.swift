@@ -11,11 +11,21 @@ import simd
 
 public class DetourPathfinder
 {
+    public typealias AllocFunction = @convention(c) (Int, Int32) -> UnsafeMutableRawPointer?
+    public typealias FreeFunction = @convention(c) (UnsafeMutableRawPointer?) -> Void
+    
     private var m_navMesh: OpaquePointer?
     private var m_navQuery: OpaquePointer?
     
     public init() { }
     
+    /// Every Detour allocation goes through alloc from now on, tagged as permanent or temporary.
+    /// Call it before the first navmesh is loaded, blocks can't be freed by another allocator
+    public static func setAllocator(_ alloc: AllocFunction, free: FreeFunction, permanentTag: Int32, temporaryTag: Int32)
+    {
+        set_detour_allocator(alloc, free, permanentTag, temporaryTag)
+    }
+    
     public func load(from data: Data)
     {
         let bytes = [UInt8](data)
@@ -0,0 +1,200 @@
+//
+//  main.swift
+//  NavBenchmark
+//
+//  Created by Fedor Artemenkov on 18.10.2026.
+//
+//  Headless benchmark of navmesh builds and Detour queries over .wld maps.
+//  Usage: swift run -c release NavBenchmark [maps dir] [--seed N] [--queries N] [--builds N] [--out file.json]
+//
+
+import Foundation
+import BenchmarkSupport
+import RecastObjC
+import CDetour
+import simd
+
+struct Options
+{
+    var mapsDir = "../WorkingDir/Assets/maps"
+    var seed: UInt32 = 1337
+    var queries = 1000
+    var builds = 5
+    var output: String?
+
+    init(arguments: [String])
+    {
+        var args = arguments.makeIterator()
+
+        while let arg = args.next()
+        {
+            switch arg
+            {
+                case "--seed": seed = args.next().flatMap { UInt32($0) } ?? seed
+                case "--queries": queries = args.next().flatMap { Int($0) } ?? queries
+                case "--builds": builds = args.next().flatMap { Int($0) } ?? builds
+                case "--out": output = args.next()
+                default: mapsDir = arg
+            }
+        }
+    }
+}
+
+struct Timings: Encodable
+{
+    let count: Int
+    let failures: Int
+    let p50_us: Double
+    let p99_us: Double
+    let nodes_p50: Double
+    let nodes_p99: Double
+
+    init(_ timings: QueryTimings)
+    {
+        count = Int(timings.count)
+        failures = Int(timings.failures)
+        p50_us = timings.p50_us
+        p99_us = timings.p99_us
+        nodes_p50 = timings.nodes_p50
+        nodes_p99 = timings.nodes_p99
+    }
+}
+
+struct BuildReport: Encodable
+{
+    let runs: Int
+    let brushes: Int
+    let p50_ms: Double
+    let p99_ms: Double
+    let peak_bytes: Int
+    let detour_bytes: Int
+}
+
+struct QueryReport: Encodable
+{
+    let seed: UInt32
+    let short_paths: Timings
+    let medium_paths: Timings
+    let long_paths: Timings
+    let nearest_poly: Timings
+    let raycasts: Timings
+    let random_points: Timings
+    let navmesh_bytes: Int
+    let query_peak_bytes: Int
+}
+
+struct MapReport: Encodable
+{
+    let map: String
+    var build: BuildReport?
+    var queries: QueryReport?
+}
+
+func benchmarkBuild(_ asset: CollisionAsset, runs: Int) -> BuildReport
+{
+    // Same brushes and Y-up conversion as the Sandbox importer
+    let SOLID = 0x1
+    let PLAYERCLIP = 0x10000
+
+    var planes: [Float] = []
+    var planeCounts: [Int32] = []
+
+    for brush in asset.brushes
+    {
+        if brush.contentFlags & (SOLID | PLAYERCLIP) == 0 {
+            continue
+        }
+
+        for side in asset.brushSides[brush.brushside ..< brush.brushside + brush.numBrushsides]
+        {
+            let plane = asset.planes[side.plane]
+            planes.append(contentsOf: [plane.normal.x, plane.normal.z, -plane.normal.y, plane.distance])
+        }
+
+        planeCounts.append(Int32(brush.numBrushsides))
+    }
+
+    var times: [Double] = []
+    var peakBytes = 0
+    var detourBytes = 0
+
+    for _ in 0 ..< max(runs, 1)
+    {
+        let navmesh = NavmeshBulder()
+        navmesh.calculateBrushPlanes(&planes, planeCounts: &planeCounts, nbrushes: Int32(planeCounts.count))
+
+        times.append(navmesh.buildMilliseconds)
+        peakBytes = max(peakBytes, Int(navmesh.buildPeakBytes))
+        detourBytes = navmesh.getDetourData()?.count ?? 0
+    }
+
+    return BuildReport(runs: times.count,
+                       brushes: planeCounts.count,
+                       p50_ms: percentile(times, 50),
+                       p99_ms: percentile(times, 99),
+                       peak_bytes: peakBytes,
+                       detour_bytes: detourBytes)
+}
+
+func benchmarkQueries(_ detour: Data, seed: UInt32, count: Int) -> QueryReport
+{
+    let result = detour.withUnsafeBytes {
+        benchmark_queries($0.baseAddress, $0.count, seed, Int32(count), simd_float3(16, 56, 16))
+    }
+
+    return QueryReport(seed: seed,
+                       short_paths: Timings(result.short_paths),
+                       medium_paths: Timings(result.medium_paths),
+                       long_paths: Timings(result.long_paths),
+                       nearest_poly: Timings(result.nearest_poly),
+                       raycasts: Timings(result.raycasts),
+                       random_points: Timings(result.random_points),
+                       navmesh_bytes: result.navmesh_bytes,
+                       query_peak_bytes: result.query_peak_bytes)
+}
+
+let options = Options(arguments: Array(CommandLine.arguments.dropFirst()))
+NavmeshBulder.enableBuildStatistics()
+enable_query_statistics()
+
+let mapsURL = URL(fileURLWithPath: options.mapsDir)
+
+let maps = ((try? FileManager.default.contentsOfDirectory(at: mapsURL, includingPropertiesForKeys: nil)) ?? [])
+    .filter { $0.pathExtension == "wld" }
+    .sorted { $0.lastPathComponent < $1.lastPathComponent }
+
+var reports: [MapReport] = []
+
+for map in maps
+{
+    var report = MapReport(map: map.lastPathComponent)
+
+    if let data = readEntry("collision.json", from: map),
+       let asset = try? JSONDecoder().decode(CollisionAsset.self, from: data)
+    {
+        report.build = benchmarkBuild(asset, runs: options.builds)
+    }
+
+    if let detour = readEntry("detour.bin", from: map)
+    {
+        report.queries = benchmarkQueries(detour, seed: options.seed, count: options.queries)
+    }
+
+    reports.append(report)
+}
+
+let encoder = JSONEncoder()
+encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+
+if let json = try? encoder.encode(reports)
+{
+    if let output = options.output
+    {
+        try? json.write(to: URL(fileURLWithPath: output))
+    }
+    else
+    {
+        FileHandle.standardOutput.write(json)
+        print("")
+    }
+}
@@ -44,6 +44,8 @@ enum rcTimerLabel
 	RC_TIMER_TEMP,
 	/// The time to rasterize the triangles. (See: #rcRasterizeTriangle)
 	RC_TIMER_RASTERIZE_TRIANGLES,
+	/// The time to rasterize the convex volumes. (See: #rcRasterizeConvexVolumes)
+	RC_TIMER_RASTERIZE_CONVEX_VOLUMES,
 	/// The time to build the compact heightfield. (See: #rcBuildCompactHeightfield)
 	RC_TIMER_BUILD_COMPACTHEIGHTFIELD,
 	/// The total time to build the contours. (See: #rcBuildContours)
@@ -821,6 +823,22 @@ inline void rcVnormalize(float* v)
 /// @param[out]		maxBounds	The maximum bounds of the AABB. [(x, y, z)] [Units: wu]
 void rcCalcBounds(const float* verts, int numVerts, float* minBounds, float* maxBounds);
 
+/// Calculates the bounding box of a set of convex volumes described by their bounding planes.
+///
+/// The faces of each volume are found by clipping a large polygon on each of its planes by the
+/// other planes, and the bounds are those of the face vertices. Empty or open volumes are ignored.
+///
+/// @ingroup recast
+/// @param[in]		planes			The bounding planes of all volumes, volume after volume.
+/// 								A point is inside a plane if <tt>dot(n, p) <= d</tt>. [(nx, ny, nz, d) * sum(@p planeCounts)]
+/// @param[in]		planeCounts		The number of planes of each volume. [Size: @p numVolumes]
+/// @param[in]		numVolumes		The number of volumes.
+/// @param[out]		minBounds		The minimum bounds of the AABB. [(x, y, z)] [Units: wu]
+/// @param[out]		maxBounds		The maximum bounds of the AABB. [(x, y, z)] [Units: wu]
+/// @returns True if at least one volume is closed and not empty.
+bool rcCalcConvexVolumeBounds(const float* planes, const int* planeCounts, int numVolumes,
+                              float* minBounds, float* maxBounds);
+
 /// Calculates the grid size based on the bounding box and grid cell size.
 /// @ingroup recast
 /// @param[in]		minBounds	The minimum bounds of the AABB. [(x, y, z)] [Units: wu]
@@ -998,6 +1016,33 @@ bool rcRasterizeTriangles(rcContext* context,
                           const float* verts, const unsigned char* triAreaIDs, int numTris,
                           rcHeightfield& heightfield, int flagMergeThreshold = 1);
 
+/// Rasterizes convex volumes described by their bounding planes into the specified heightfield.
+///
+/// The faces of every volume are clipped against the columns they cross, so every column a volume
+/// covers, however little of it, receives one solid span from the exact bottom to the exact top of
+/// the volume in that column. The span is marked #RC_WALKABLE_AREA when the face bounding the volume
+/// from above is not steeper than @p walkableSlopeAngle, otherwise it is marked #RC_NULL_AREA.
+///
+/// This is an alternative to #rcRasterizeTriangles for solid brush geometry: brushes are filled
+/// instead of leaving their insides empty, and only the volumes that take part in the collision
+/// need to be provided.
+///
+/// @see rcCalcConvexVolumeBounds
+/// @ingroup recast
+/// @param[in,out]	context				The build context to use during the operation.
+/// @param[in]		planes				The bounding planes of all volumes, volume after volume.
+/// 									A point is inside a plane if <tt>dot(n, p) <= d</tt>. [(nx, ny, nz, d) * sum(@p planeCounts)]
+/// @param[in]		planeCounts			The number of planes of each volume. [Size: @p numVolumes]
+/// @param[in]		numVolumes			The number of volumes.
+/// @param[in]		walkableSlopeAngle	The maximum slope that is considered walkable. [Limits: 0 <= value < 90] [Units: Degrees]
+/// @param[in,out]	heightfield			An initialized heightfield.
+/// @param[in]		flagMergeThreshold	The distance where the walkable flag is favored over the non-walkable flag.
+/// 									[Limit: >= 0] [Units: vx]
+/// @returns True if the operation completed successfully.
+bool rcRasterizeConvexVolumes(rcContext* context,
+                              const float* planes, const int* planeCounts, int numVolumes,
+                              float walkableSlopeAngle, rcHeightfield& heightfield, int flagMergeThreshold = 1);
+
 /// Marks non-walkable spans as walkable if their maximum is within @p walkableClimb of a walkable neighbor.
 ///
 /// Allows the formation of walkable regions that will flow over low lying 
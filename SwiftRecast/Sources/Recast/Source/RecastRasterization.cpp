@@ -553,3 +553,456 @@ bool rcRasterizeTriangles(rcContext* context,
 
 	return true;
 }
+
+/// Half the size of the polygon a volume face starts from before it is clipped by the other planes. [Units: wu]
+static const double VOLUME_FACE_EXTENT = 262144.0;
+
+/// Distance within which a face vertex counts as lying on a clipping plane. [Units: wu]
+static const double VOLUME_FACE_EPSILON = 1e-3;
+
+/// Clips a convex polygon against a plane, keeping the part where <tt>dot(n, p) <= d</tt>.
+///
+/// @param[in]	inVerts			The polygon vertices [(x, y, z) * @p inVertsCount]
+/// @param[in]	inVertsCount	The number of polygon vertices
+/// @param[in]	plane			The clipping plane [(nx, ny, nz, d)]
+/// @param[out]	outVerts		The clipped polygon vertices, room for @p inVertsCount + 1 vertices
+/// @returns The number of clipped polygon vertices
+static int clipPolyToPlane(const double* inVerts, const int inVertsCount, const float* plane, double* outVerts)
+{
+	int outVertsCount = 0;
+	for (int inVertA = 0, inVertB = inVertsCount - 1; inVertA < inVertsCount; inVertB = inVertA, ++inVertA)
+	{
+		const double* a = &inVerts[inVertA * 3];
+		const double* b = &inVerts[inVertB * 3];
+		const double distanceA = plane[0] * a[0] + plane[1] * a[1] + plane[2] * a[2] - plane[3];
+		const double distanceB = plane[0] * b[0] + plane[1] * b[1] + plane[2] * b[2] - plane[3];
+		const bool insideA = distanceA <= VOLUME_FACE_EPSILON;
+		const bool insideB = distanceB <= VOLUME_FACE_EPSILON;
+
+		// The edge from B to A crosses the plane, keep the crossing point
+		if (insideA != insideB && rcAbs(distanceA) > VOLUME_FACE_EPSILON && rcAbs(distanceB) > VOLUME_FACE_EPSILON)
+		{
+			const double s = distanceB / (distanceB - distanceA);
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				outVerts[outVertsCount * 3 + axis] = b[axis] + (a[axis] - b[axis]) * s;
+			}
+			outVertsCount++;
+		}
+		if (insideA)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				outVerts[outVertsCount * 3 + axis] = a[axis];
+			}
+			outVertsCount++;
+		}
+	}
+	return outVertsCount;
+}
+
+/// Finds the faces of a convex volume, by clipping a large polygon on each bounding plane by all other planes.
+///
+/// @param[in]	planes			The bounding planes of the volume [(nx, ny, nz, d) * @p numPlanes]
+/// @param[in]	numPlanes		The number of planes
+/// @param[out]	faceVerts		The vertices of all faces, face after face [(x, y, z) * sum(@p faceVertCounts)]
+/// @param[out]	faceVertCounts	The number of vertices of each face, 0 for planes that don't touch the volume [Size: @p numPlanes]
+/// @returns false if the volume has no face, because it is empty or open
+static bool buildVolumeFaces(const float* planes, const int numPlanes,
+                             rcTempVector<float>& faceVerts, rcTempVector<int>& faceVertCounts)
+{
+	faceVerts.clear();
+	faceVertCounts.resize(numPlanes);
+
+	// Every plane adds at most one vertex to the starting quad
+	const int maxVerts = numPlanes + 4;
+	rcTempVector<double> buffer(maxVerts * 3 * 2);
+	double* in = &buffer[0];
+	double* out = &buffer[maxVerts * 3];
+
+	int numFaces = 0;
+	for (int faceIndex = 0; faceIndex < numPlanes; ++faceIndex)
+	{
+		faceVertCounts[faceIndex] = 0;
+
+		float plane[4];
+		rcVcopy(plane, &planes[faceIndex * 4]);
+		const float normalLength = rcSqrt(rcVdot(plane, plane));
+		if (normalLength < 1e-6f)
+		{
+			continue;
+		}
+		for (int component = 0; component < 4; ++component)
+		{
+			plane[component] = planes[faceIndex * 4 + component] / normalLength;
+		}
+
+		// Two directions in the plane, starting from the world axis closest to it
+		const float absNormal[3] = { rcAbs(plane[0]), rcAbs(plane[1]), rcAbs(plane[2]) };
+		const int majorAxis = absNormal[1] >= absNormal[0] && absNormal[1] >= absNormal[2] ? 1 : (absNormal[0] >= absNormal[2] ? 0 : 2);
+		float up[3] = { 0.0f, 0.0f, 0.0f };
+		up[majorAxis == 1 ? 2 : 1] = 1.0f;
+		const float upDot = rcVdot(up, plane);
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			up[axis] -= plane[axis] * upDot;
+		}
+		rcVnormalize(up);
+		float right[3];
+		rcVcross(right, up, plane);
+
+		// A quad larger than any map, wound so that it faces along the plane normal
+		double center[3];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			center[axis] = (double)plane[axis] * plane[3];
+		}
+		static const double corners[4][2] = { {-1, 1}, {1, 1}, {1, -1}, {-1, -1} };
+		for (int corner = 0; corner < 4; ++corner)
+		{
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				in[corner * 3 + axis] = center[axis] + (corners[corner][0] * right[axis] + corners[corner][1] * up[axis]) * VOLUME_FACE_EXTENT;
+			}
+		}
+		int inVertsCount = 4;
+
+		for (int clipIndex = 0; clipIndex < numPlanes && inVertsCount >= 3; ++clipIndex)
+		{
+			if (clipIndex == faceIndex)
+			{
+				continue;
+			}
+			inVertsCount = clipPolyToPlane(in, inVertsCount, &planes[clipIndex * 4], out);
+			rcSwap(in, out);
+		}
+
+		if (inVertsCount < 3)
+		{
+			continue;
+		}
+
+		// A face that still reaches the starting quad isn't closed by the other planes
+		for (int vert = 0; vert < inVertsCount * 3; ++vert)
+		{
+			if (rcAbs(in[vert]) >= VOLUME_FACE_EXTENT * 0.5)
+			{
+				return false;
+			}
+		}
+
+		for (int vert = 0; vert < inVertsCount * 3; ++vert)
+		{
+			faceVerts.push_back((float)in[vert]);
+		}
+		faceVertCounts[faceIndex] = inVertsCount;
+		numFaces++;
+	}
+
+	return numFaces > 0;
+}
+
+bool rcCalcConvexVolumeBounds(const float* planes, const int* planeCounts, const int numVolumes,
+                              float* minBounds, float* maxBounds)
+{
+	rcTempVector<float> faceVerts;
+	rcTempVector<int> faceVertCounts;
+
+	bool found = false;
+	const float* volumePlanes = planes;
+	for (int volumeIndex = 0; volumeIndex < numVolumes; ++volumeIndex)
+	{
+		const int numPlanes = planeCounts[volumeIndex];
+		const float* currentPlanes = volumePlanes;
+		volumePlanes += numPlanes * 4;
+
+		if (!buildVolumeFaces(currentPlanes, numPlanes, faceVerts, faceVertCounts))
+		{
+			continue;
+		}
+
+		// Every corner of the volume is a vertex of its faces
+		const int numVerts = (int)faceVerts.size() / 3;
+		for (int vert = 0; vert < numVerts; ++vert)
+		{
+			if (!found)
+			{
+				rcVcopy(minBounds, &faceVerts[vert * 3]);
+				rcVcopy(maxBounds, &faceVerts[vert * 3]);
+				found = true;
+			}
+			else
+			{
+				rcVmin(minBounds, &faceVerts[vert * 3]);
+				rcVmax(maxBounds, &faceVerts[vert * 3]);
+			}
+		}
+	}
+
+	return found;
+}
+
+/// The extent of one volume along one column of the heightfield, gathered from the faces of the volume.
+struct rcVolumeColumn
+{
+	float spanMin;
+	float spanMax;
+	unsigned char areaID;	///< The area of the face that is highest in the column
+	bool covered;
+};
+
+/// Adds the parts of a face triangle inside every column it crosses to the extents of the volume along those columns.
+///
+/// The triangle is cut into the columns the same way #rasterizeTri cuts it. Since a volume is convex, the lowest
+/// and highest points of its faces in a column are exactly its bottom and top there, and a face part without area
+/// in the xz-plane adds nothing the others don't.
+///
+/// @param[in] 	v0, v1, v2			Triangle vertices
+/// @param[in] 	areaID				The area of the face the triangle belongs to
+/// @param[in] 	heightfield			Heightfield the volume is rasterized into
+/// @param[in] 	inverseCellSize		1 / cellSize
+/// @param[in]	footprintMin		The first column of the volume footprint [(x, z)]
+/// @param[in]	footprintMax		The last column of the volume footprint [(x, z)]
+/// @param[in,out]	columns			The extents of the volume in the columns of its footprint
+static void accumulateVolumeTri(const float* v0, const float* v1, const float* v2, const unsigned char areaID,
+                                const rcHeightfield& heightfield, const float inverseCellSize,
+                                const int* footprintMin, const int* footprintMax, rcVolumeColumn* columns)
+{
+	const float* heightfieldBBMin = heightfield.bmin;
+	const float cellSize = heightfield.cs;
+	const int footprintWidth = footprintMax[0] - footprintMin[0] + 1;
+
+	// Faces meeting at an edge reach the same height there, the walkable one decides the area
+	const float tieEpsilon = heightfield.ch * 0.01f;
+	// Twice the area of a face part that counts as covering the column
+	const float minArea = cellSize * cellSize * 1e-6f;
+
+	float triBBMin[3];
+	rcVcopy(triBBMin, v0);
+	rcVmin(triBBMin, v1);
+	rcVmin(triBBMin, v2);
+
+	float triBBMax[3];
+	rcVcopy(triBBMax, v0);
+	rcVmax(triBBMax, v1);
+	rcVmax(triBBMax, v2);
+
+	int z0 = (int)floorf((triBBMin[2] - heightfieldBBMin[2]) * inverseCellSize);
+	int z1 = (int)floorf((triBBMax[2] - heightfieldBBMin[2]) * inverseCellSize);
+
+	// use one row before the footprint to cut the polygon properly at its start
+	z0 = rcClamp(z0, footprintMin[1] - 1, footprintMax[1]);
+	z1 = rcClamp(z1, footprintMin[1], footprintMax[1]);
+
+	float buf[7 * 3 * 4];
+	float* in = buf;
+	float* inRow = buf + 7 * 3;
+	float* p1 = inRow + 7 * 3;
+	float* p2 = p1 + 7 * 3;
+
+	rcVcopy(&in[0], v0);
+	rcVcopy(&in[1 * 3], v1);
+	rcVcopy(&in[2 * 3], v2);
+	int nvRow;
+	int nvIn = 3;
+
+	for (int z = z0; z <= z1; ++z)
+	{
+		const float cellZ = heightfieldBBMin[2] + (float)z * cellSize;
+		dividePoly(in, nvIn, inRow, &nvRow, p1, &nvIn, cellZ + cellSize, RC_AXIS_Z);
+		rcSwap(in, p1);
+
+		if (nvRow < 3 || z < footprintMin[1])
+		{
+			continue;
+		}
+
+		float minX = inRow[0];
+		float maxX = inRow[0];
+		for (int vert = 1; vert < nvRow; ++vert)
+		{
+			minX = rcMin(minX, inRow[vert * 3]);
+			maxX = rcMax(maxX, inRow[vert * 3]);
+		}
+		int x0 = (int)floorf((minX - heightfieldBBMin[0]) * inverseCellSize);
+		int x1 = (int)floorf((maxX - heightfieldBBMin[0]) * inverseCellSize);
+		if (x1 < footprintMin[0] || x0 > footprintMax[0])
+		{
+			continue;
+		}
+		x0 = rcClamp(x0, footprintMin[0] - 1, footprintMax[0]);
+		x1 = rcClamp(x1, footprintMin[0], footprintMax[0]);
+
+		int nv;
+		int nv2 = nvRow;
+
+		for (int x = x0; x <= x1; ++x)
+		{
+			const float cx = heightfieldBBMin[0] + (float)x * cellSize;
+			dividePoly(inRow, nv2, p1, &nv, p2, &nv2, cx + cellSize, RC_AXIS_X);
+			rcSwap(inRow, p2);
+
+			if (nv < 3 || x < footprintMin[0])
+			{
+				continue;
+			}
+
+			// Vertical faces and slivers along the column border don't cover the column, the faces above and below
+			// the volume do
+			float area = 0.0f;
+			for (int vertA = 0, vertB = nv - 1; vertA < nv; vertB = vertA, ++vertA)
+			{
+				area += p1[vertB * 3 + 0] * p1[vertA * 3 + 2] - p1[vertA * 3 + 0] * p1[vertB * 3 + 2];
+			}
+			if (rcAbs(area) <= minArea)
+			{
+				continue;
+			}
+
+			float spanMin = p1[1];
+			float spanMax = p1[1];
+			for (int vert = 1; vert < nv; ++vert)
+			{
+				spanMin = rcMin(spanMin, p1[vert * 3 + 1]);
+				spanMax = rcMax(spanMax, p1[vert * 3 + 1]);
+			}
+
+			rcVolumeColumn& column = columns[(x - footprintMin[0]) + (z - footprintMin[1]) * footprintWidth];
+			if (!column.covered)
+			{
+				column.spanMin = spanMin;
+				column.spanMax = spanMax;
+				column.areaID = areaID;
+				column.covered = true;
+				continue;
+			}
+
+			column.spanMin = rcMin(column.spanMin, spanMin);
+			if (spanMax > column.spanMax + tieEpsilon)
+			{
+				column.areaID = areaID;
+			}
+			else if (spanMax >= column.spanMax - tieEpsilon)
+			{
+				column.areaID = rcMax(column.areaID, areaID);
+			}
+			column.spanMax = rcMax(column.spanMax, spanMax);
+		}
+	}
+}
+
+bool rcRasterizeConvexVolumes(rcContext* context,
+                              const float* planes, const int* planeCounts, const int numVolumes,
+                              const float walkableSlopeAngle, rcHeightfield& heightfield, const int flagMergeThreshold)
+{
+	rcAssert(context != NULL);
+
+	rcScopedTimer timer(context, RC_TIMER_RASTERIZE_CONVEX_VOLUMES);
+
+	const float walkableThr = cosf(walkableSlopeAngle / 180.0f * RC_PI);
+	const float inverseCellSize = 1.0f / heightfield.cs;
+	const float inverseCellHeight = 1.0f / heightfield.ch;
+	const float by = heightfield.bmax[1] - heightfield.bmin[1];
+
+	rcTempVector<float> faceVerts;
+	rcTempVector<int> faceVertCounts;
+	rcTempVector<rcVolumeColumn> columns;
+
+	const float* volumePlanes = planes;
+	for (int volumeIndex = 0; volumeIndex < numVolumes; ++volumeIndex)
+	{
+		const int numPlanes = planeCounts[volumeIndex];
+		const float* currentPlanes = volumePlanes;
+		volumePlanes += numPlanes * 4;
+
+		if (!buildVolumeFaces(currentPlanes, numPlanes, faceVerts, faceVertCounts))
+		{
+			continue;
+		}
+
+		float volumeMin[3];
+		float volumeMax[3];
+		rcVcopy(volumeMin, &faceVerts[0]);
+		rcVcopy(volumeMax, &faceVerts[0]);
+		for (int vert = 1; vert < (int)faceVerts.size() / 3; ++vert)
+		{
+			rcVmin(volumeMin, &faceVerts[vert * 3]);
+			rcVmax(volumeMax, &faceVerts[vert * 3]);
+		}
+		if (!overlapBounds(heightfield.bmin, heightfield.bmax, volumeMin, volumeMax))
+		{
+			continue;
+		}
+
+		int footprintMin[2];
+		int footprintMax[2];
+		footprintMin[0] = rcClamp((int)floorf((volumeMin[0] - heightfield.bmin[0]) * inverseCellSize), 0, heightfield.width - 1);
+		footprintMax[0] = rcClamp((int)floorf((volumeMax[0] - heightfield.bmin[0]) * inverseCellSize), 0, heightfield.width - 1);
+		footprintMin[1] = rcClamp((int)floorf((volumeMin[2] - heightfield.bmin[2]) * inverseCellSize), 0, heightfield.height - 1);
+		footprintMax[1] = rcClamp((int)floorf((volumeMax[2] - heightfield.bmin[2]) * inverseCellSize), 0, heightfield.height - 1);
+		const int footprintWidth = footprintMax[0] - footprintMin[0] + 1;
+		const int footprintHeight = footprintMax[1] - footprintMin[1] + 1;
+
+		rcVolumeColumn uncovered;
+		uncovered.spanMin = 0.0f;
+		uncovered.spanMax = 0.0f;
+		uncovered.areaID = RC_NULL_AREA;
+		uncovered.covered = false;
+		columns.assign(footprintWidth * footprintHeight, uncovered);
+
+		// Cut every face into the columns it crosses, as a fan of triangles
+		const float* face = &faceVerts[0];
+		for (int faceIndex = 0; faceIndex < numPlanes; ++faceIndex)
+		{
+			const int numFaceVerts = faceVertCounts[faceIndex];
+			// The planes don't need unit normals, scale the threshold the way buildVolumeFaces divides them
+			const float* plane = &currentPlanes[faceIndex * 4];
+			const float normalLength = rcSqrt(rcVdot(plane, plane));
+			const unsigned char areaID = plane[1] >= walkableThr * normalLength ? RC_WALKABLE_AREA : RC_NULL_AREA;
+			for (int vert = 2; vert < numFaceVerts; ++vert)
+			{
+				accumulateVolumeTri(&face[0], &face[(vert - 1) * 3], &face[vert * 3], areaID,
+				                    heightfield, inverseCellSize, footprintMin, footprintMax, &columns[0]);
+			}
+			face += numFaceVerts * 3;
+		}
+
+		// One solid span per covered column, from the bottom to the top of the volume
+		for (int z = footprintMin[1]; z <= footprintMax[1]; ++z)
+		{
+			for (int x = footprintMin[0]; x <= footprintMax[0]; ++x)
+			{
+				const rcVolumeColumn& column = columns[(x - footprintMin[0]) + (z - footprintMin[1]) * footprintWidth];
+				if (!column.covered)
+				{
+					continue;
+				}
+
+				float spanMin = column.spanMin - heightfield.bmin[1];
+				float spanMax = column.spanMax - heightfield.bmin[1];
+
+				// Skip the span if it's completely outside the heightfield bounding box
+				if (spanMax < 0.0f || spanMin > by)
+				{
+					continue;
+				}
+
+				// Clamp the span to the heightfield bounding box.
+				spanMin = rcMax(spanMin, 0.0f);
+				spanMax = rcMin(spanMax, by);
+
+				// Snap the span to the heightfield height grid.
+				unsigned short spanMinCellIndex = (unsigned short)rcClamp((int)floorf(spanMin * inverseCellHeight), 0, RC_SPAN_MAX_HEIGHT);
+				unsigned short spanMaxCellIndex = (unsigned short)rcClamp((int)ceilf(spanMax * inverseCellHeight), (int)spanMinCellIndex + 1, RC_SPAN_MAX_HEIGHT);
+
+				if (!addSpan(heightfield, x, z, spanMinCellIndex, spanMaxCellIndex, column.areaID, flagMergeThreshold))
+				{
+					context->log(RC_LOG_ERROR, "rcRasterizeConvexVolumes: Out of memory.");
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
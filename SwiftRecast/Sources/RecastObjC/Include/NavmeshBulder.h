@@ -9,9 +9,27 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+// Allocation functions taking a tag, such as the ones of BulletMemoryTracker
+typedef void * _Nullable (*NavAllocFunction)(size_t size, int tag);
+typedef void (*NavFreeFunction)(void * _Nullable ptr);
+
 @interface NavmeshBulder: NSObject
+
+// Every Recast allocation goes through allocFunction from now on, tagged by whether it outlives the step that made it.
+// Build statistics are still counted on top of it
++ (void)setAllocFunction:(NavAllocFunction)allocFunction freeFunction:(NavFreeFunction)freeFunction
+            permanentTag:(int)permanentTag temporaryTag:(int)temporaryTag;
+
+// Counts the peak Recast memory of every build from now on, for benchmarks. Call before the first build
++ (void)enableBuildStatistics;
+
+// Wall time and peak Recast memory of the last calculate call, the memory is 0 without enableBuildStatistics
+@property (nonatomic, readonly) double buildMilliseconds;
+@property (nonatomic, readonly) size_t buildPeakBytes;
+
 - (instancetype)init;
 - (void)calculateVerts:(const float*)verts nverts:(int)nverts tris:(const int*)tris ntris:(int)ntris;
+- (void)calculateBrushPlanes:(const float*)planes planeCounts:(const int*)planeCounts nbrushes:(int)nbrushes;
 - (nullable NSData*)getDetourData;
 @end
 
@@ -9,9 +9,66 @@
 #import "Utils.h"
 
 #import "Recast.h"
+#import "RecastAlloc.h"
 #import "DetourNavMesh.h"
 #import "DetourNavMeshBuilder.h"
 
+#include <algorithm>
+#include <chrono>
+
+// Allocator every Recast block goes through, malloc until setAllocFunction is called
+
+static NavAllocFunction s_allocFunction = NULL;
+static NavFreeFunction s_freeFunction = NULL;
+static int s_permanentTag = 0;
+static int s_temporaryTag = 0;
+
+static void* baseAlloc(size_t size, rcAllocHint hint)
+{
+    if (!s_allocFunction) return malloc(size);
+    return s_allocFunction(size, hint == RC_ALLOC_PERM ? s_permanentTag : s_temporaryTag);
+}
+
+static void baseFree(void* ptr)
+{
+    if (!s_freeFunction) free(ptr);
+    else s_freeFunction(ptr);
+}
+
+// Counting allocator installed on top of it by enableBuildStatistics, every block is prefixed by its size.
+// A build allocates and frees everything on the thread that runs it, so builds on other threads don't mix in
+
+static const size_t ALLOC_HEADER = 16;
+static bool s_countBuilds = false;
+static thread_local size_t s_liveBytes = 0;
+static thread_local size_t s_peakBytes = 0;
+
+static void* countingAlloc(size_t size, rcAllocHint hint)
+{
+    unsigned char* block = (unsigned char*)baseAlloc(size + ALLOC_HEADER, hint);
+    if (!block) return 0;
+    
+    *(size_t*)block = size;
+    
+    s_liveBytes += size;
+    s_peakBytes = std::max(s_peakBytes, s_liveBytes);
+    
+    return block + ALLOC_HEADER;
+}
+
+static void countingFree(void* ptr)
+{
+    unsigned char* block = (unsigned char*)ptr - ALLOC_HEADER;
+    s_liveBytes -= *(size_t*)block;
+    baseFree(block);
+}
+
+static void installAllocator()
+{
+    if (s_countBuilds) rcAllocSetCustom(countingAlloc, countingFree);
+    else rcAllocSetCustom(baseAlloc, baseFree);
+}
+
 @implementation NavmeshBulder
 {
     float m_cellSize;
@@ -30,6 +87,26 @@
     
     rcContext* m_ctx;
     dtNavMesh* m_navMesh;
+    
+    std::chrono::steady_clock::time_point m_buildStart;
+}
+
++ (void)setAllocFunction:(NavAllocFunction)allocFunction freeFunction:(NavFreeFunction)freeFunction
+            permanentTag:(int)permanentTag temporaryTag:(int)temporaryTag
+{
+    // no Recast block outlives a build, so the allocator can change between two of them
+    s_allocFunction = allocFunction;
+    s_freeFunction = freeFunction;
+    s_permanentTag = permanentTag;
+    s_temporaryTag = temporaryTag;
+    installAllocator();
+}
+
++ (void)enableBuildStatistics
+{
+    // the size prefix has to be there from the first block on
+    s_countBuilds = true;
+    installAllocator();
 }
 
 - (instancetype)init
@@ -57,11 +134,108 @@
 }
 
 - (void)calculateVerts:(const float*)verts nverts:(int)nverts tris:(const int*)tris ntris:(int)ntris
+{
+    [self beginMeasure];
+    [self buildFromVerts:verts nverts:nverts tris:tris ntris:ntris];
+    [self endMeasure];
+}
+
+- (void)calculateBrushPlanes:(const float*)planes planeCounts:(const int*)planeCounts nbrushes:(int)nbrushes
+{
+    [self beginMeasure];
+    [self buildFromBrushPlanes:planes planeCounts:planeCounts nbrushes:nbrushes];
+    [self endMeasure];
+}
+
+- (void)beginMeasure
+{
+    // Every Recast allocation of a build is released before it returns
+    s_liveBytes = 0;
+    s_peakBytes = 0;
+    
+    m_buildStart = std::chrono::steady_clock::now();
+}
+
+- (void)endMeasure
+{
+    _buildMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_buildStart).count();
+    _buildPeakBytes = s_peakBytes;
+}
+
+- (void)buildFromVerts:(const float*)verts nverts:(int)nverts tris:(const int*)tris ntris:(int)ntris
 {
     float bmin[3];
     float bmax[3];
     rcCalcBounds(verts, nverts, bmin, bmax);
     
+    rcConfig m_cfg = [self makeConfigWithBmin:bmin bmax:bmax];
+    
+    rcHeightfield* m_solid = [self allocHeightfieldWithConfig:m_cfg];
+    
+    if (!m_solid)
+    {
+        return;
+    }
+    
+    //
+    // Step 2. Rasterize input polygon soup.
+    //
+    
+    // Allocate array that can hold triangle area types.
+    // If you have multiple meshes you need to process, allocate
+    // and array which can hold the max number of triangles you need to process.
+    unsigned char* m_triareas = new unsigned char[ntris];
+    memset(m_triareas, 0, ntris * sizeof(unsigned char));
+    
+    // Find triangles which are walkable based on their slope and rasterize them.
+    // If your input data is multiple meshes, you can transform them here, calculate
+    // the are type for each of the meshes and rasterize them.
+    rcMarkWalkableTriangles(m_ctx, m_cfg.walkableSlopeAngle, verts, nverts, tris, ntris, m_triareas);
+    rcRasterizeTriangles(m_ctx, verts, nverts, tris, m_triareas, ntris, *m_solid, m_cfg.walkableClimb);
+    
+    delete [] m_triareas;
+    
+    [self buildNavigationWithHeightfield:m_solid config:m_cfg];
+}
+
+- (void)buildFromBrushPlanes:(const float*)planes planeCounts:(const int*)planeCounts nbrushes:(int)nbrushes
+{
+    float bmin[3];
+    float bmax[3];
+    
+    if (!rcCalcConvexVolumeBounds(planes, planeCounts, nbrushes, bmin, bmax))
+    {
+        m_ctx->log(RC_LOG_ERROR, "buildNavigation: No closed brushes.");
+        return;
+    }
+    
+    rcConfig m_cfg = [self makeConfigWithBmin:bmin bmax:bmax];
+    
+    rcHeightfield* m_solid = [self allocHeightfieldWithConfig:m_cfg];
+    
+    if (!m_solid)
+    {
+        return;
+    }
+    
+    //
+    // Step 2. Rasterize brush volumes.
+    //
+    
+    // Every brush becomes solid spans from its bottom to its top,
+    // walkability is decided by the slope of the top plane of each column.
+    if (!rcRasterizeConvexVolumes(m_ctx, planes, planeCounts, nbrushes, m_cfg.walkableSlopeAngle, *m_solid, m_cfg.walkableClimb))
+    {
+        m_ctx->log(RC_LOG_ERROR, "buildNavigation: Could not rasterize brushes.");
+        rcFreeHeightField(m_solid);
+        return;
+    }
+    
+    [self buildNavigationWithHeightfield:m_solid config:m_cfg];
+}
+
+- (rcConfig)makeConfigWithBmin:(const float*)bmin bmax:(const float*)bmax
+{
     //
     // Step 1. Initialize build config.
     //
@@ -84,46 +258,37 @@
     m_cfg.detailSampleMaxError = m_cellHeight * m_detailSampleMaxError;
     
     // Set the area where the navigation will be built.
-    // Here the bounds of the input mesh are used, but the
+    // Here the bounds of the input geometry are used, but the
     // area could be specified by an user defined box, etc.
     rcVcopy(m_cfg.bmin, bmin);
     rcVcopy(m_cfg.bmax, bmax);
     rcCalcGridSize(m_cfg.bmin, m_cfg.bmax, m_cfg.cs, &m_cfg.width, &m_cfg.height);
     
-    
-    //
-    // Step 2. Rasterize input polygon soup.
-    //
-    
+    return m_cfg;
+}
+
+- (nullable rcHeightfield*)allocHeightfieldWithConfig:(const rcConfig&)m_cfg
+{
     // Allocate voxel heightfield where we rasterize our input data to.
     rcHeightfield* m_solid = rcAllocHeightfield();
     
     if (!m_solid)
     {
         m_ctx->log(RC_LOG_ERROR, "buildNavigation: Out of memory 'solid'.");
-        return;
+        return nullptr;
     }
     if (!rcCreateHeightfield(m_ctx, *m_solid, m_cfg.width, m_cfg.height, m_cfg.bmin, m_cfg.bmax, m_cfg.cs, m_cfg.ch))
     {
         m_ctx->log(RC_LOG_ERROR, "buildNavigation: Could not create solid heightfield.");
         rcFreeHeightField(m_solid);
-        return;
+        return nullptr;
     }
     
-    // Allocate array that can hold triangle area types.
-    // If you have multiple meshes you need to process, allocate
-    // and array which can hold the max number of triangles you need to process.
-    unsigned char* m_triareas = new unsigned char[ntris];
-    memset(m_triareas, 0, ntris * sizeof(unsigned char));
-    
-    // Find triangles which are walkable based on their slope and rasterize them.
-    // If your input data is multiple meshes, you can transform them here, calculate
-    // the are type for each of the meshes and rasterize them.
-    rcMarkWalkableTriangles(m_ctx, m_cfg.walkableSlopeAngle, verts, nverts, tris, ntris, m_triareas);
-    rcRasterizeTriangles(m_ctx, verts, nverts, tris, m_triareas, ntris, *m_solid, m_cfg.walkableClimb);
-    
-    delete [] m_triareas;
-    
+    return m_solid;
+}
+
+- (void)buildNavigationWithHeightfield:(rcHeightfield*)m_solid config:(const rcConfig&)m_cfg
+{
     //
     // Step 3. Filter walkable surfaces.
     //